@@ -51,10 +51,14 @@ MOCKABLE_FUNCTION(, void*, interlocked_exchange_pointer, void* volatile_atomic*,
 MOCKABLE_FUNCTION(, int32_t, interlocked_increment, volatile_atomic int32_t*, addend);
 MOCKABLE_FUNCTION(, int16_t, interlocked_increment_16, volatile_atomic int16_t*, addend);
 MOCKABLE_FUNCTION(, int64_t, interlocked_increment_64, volatile_atomic int64_t*, addend);
+MOCKABLE_FUNCTION(, int32_t, interlocked_load_acquire, volatile_atomic int32_t*, source);
+MOCKABLE_FUNCTION(, int64_t, interlocked_load_acquire_64, volatile_atomic int64_t*, source);
 MOCKABLE_FUNCTION(, int32_t, interlocked_or, volatile_atomic int32_t*, destination, int32_t, value);
 MOCKABLE_FUNCTION(, int16_t, interlocked_or_16, volatile_atomic int16_t*, destination, int16_t, value);
 MOCKABLE_FUNCTION(, int64_t, interlocked_or_64, volatile_atomic int64_t*, destination, int64_t, value);
 MOCKABLE_FUNCTION(, int8_t, interlocked_or_8, volatile_atomic int8_t*, destination, int8_t, value);
+MOCKABLE_FUNCTION(, void, interlocked_store_release, volatile_atomic int32_t*, destination, int32_t, value);
+MOCKABLE_FUNCTION(, void, interlocked_store_release_64, volatile_atomic int64_t*, destination, int64_t, value);
 MOCKABLE_FUNCTION(, int32_t, interlocked_xor, volatile_atomic int32_t*, destination, int32_t, value);
 MOCKABLE_FUNCTION(, int16_t, interlocked_xor_16, volatile_atomic int16_t*, destination, int16_t, value);
 MOCKABLE_FUNCTION(, int64_t, interlocked_xor_64, volatile_atomic int64_t*, destination, int64_t, value);
@@ -9,6 +9,8 @@
 #ifndef THREADAPI_H
 #define THREADAPI_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "macro_utils/macro_utils.h"
@@ -49,6 +51,39 @@ typedef void* THREAD_HANDLE;
  */
 MOCKABLE_FUNCTION(, THREADAPI_RESULT, ThreadAPI_Create, THREAD_HANDLE*, threadHandle, THREAD_START_FUNC, func, void*, arg);
 
+/** @brief Maximum length of a thread name (without the terminating zero). Longer names are truncated. */
+#define THREADAPI_MAX_THREAD_NAME_LENGTH 15
+
+/** @brief Options for ::ThreadAPI_CreateEx. A zero initialized structure selects the defaults used by ::ThreadAPI_Create. */
+typedef struct THREADAPI_CREATE_OPTIONS_TAG
+{
+    const char* name; /*name of the thread as shown by debuggers and profilers, NULL for no name*/
+    size_t stack_size; /*stack size of the thread in bytes, 0 for the platform default*/
+    const uint32_t* cpus; /*indices of the CPUs the thread is allowed to run on*/
+    uint32_t cpu_count; /*number of entries in cpus, 0 to not restrict the thread to a CPU set*/
+    bool use_numa_node; /*true to restrict the thread to the CPUs of numa_node (in addition to cpus)*/
+    uint32_t numa_node;
+} THREADAPI_CREATE_OPTIONS;
+
+/**
+ * @brief    Creates a thread with the entry point specified by the @p func
+ *             argument, applying the name, stack size and CPU affinity
+ *             given in @p options.
+ *
+ * @param   threadHandle    The handle to the new thread is returned in this
+ *                             pointer.
+ * @param   func            A function pointer that indicates the entry point
+ *                             to the new thread.
+ * @param   arg                A void pointer that must be passed to the function
+ *                             pointed to by @p func.
+ * @param   options         The creation options. @c NULL behaves like
+ *                             ::ThreadAPI_Create.
+ *
+ * @return    @c THREADAPI_OK if the API call is successful or an error
+ *             code in case it fails.
+ */
+MOCKABLE_FUNCTION(, THREADAPI_RESULT, ThreadAPI_CreateEx, THREAD_HANDLE*, threadHandle, THREAD_START_FUNC, func, void*, arg, const THREADAPI_CREATE_OPTIONS*, options);
+
 /**
  * @brief    Blocks the calling thread by waiting on the thread identified by
  *             the @p threadHandle argument to complete.
@@ -26,10 +26,14 @@
 #define interlocked_increment                  real_interlocked_increment
 #define interlocked_increment_16               real_interlocked_increment_16
 #define interlocked_increment_64               real_interlocked_increment_64
+#define interlocked_load_acquire               real_interlocked_load_acquire
+#define interlocked_load_acquire_64            real_interlocked_load_acquire_64
 #define interlocked_or                         real_interlocked_or
 #define interlocked_or_16                      real_interlocked_or_16
 #define interlocked_or_64                      real_interlocked_or_64
 #define interlocked_or_8                       real_interlocked_or_8
+#define interlocked_store_release              real_interlocked_store_release
+#define interlocked_store_release_64           real_interlocked_store_release_64
 #define interlocked_xor                        real_interlocked_xor
 #define interlocked_xor_16                     real_interlocked_xor_16
 #define interlocked_xor_64                     real_interlocked_xor_64
@@ -30,10 +30,14 @@
 #undef interlocked_increment
 #undef interlocked_increment_16
 #undef interlocked_increment_64
+#undef interlocked_load_acquire
+#undef interlocked_load_acquire_64
 #undef interlocked_or
 #undef interlocked_or_16
 #undef interlocked_or_64
 #undef interlocked_or_8
+#undef interlocked_store_release
+#undef interlocked_store_release_64
 #undef interlocked_xor
 #undef interlocked_xor_16
 #undef interlocked_xor_64
@@ -19,6 +19,7 @@
 #define REGISTER_THREADAPI_GLOBAL_MOCK_HOOK() \
     MU_FOR_EACH_1(R2, \
         ThreadAPI_Create, \
+        ThreadAPI_CreateEx, \
         ThreadAPI_Join, \
         ThreadAPI_Sleep, \
         ThreadAPI_GetCurrentThreadId \
@@ -30,6 +31,8 @@ extern "C" {
 
 THREADAPI_RESULT real_ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg);
 
+THREADAPI_RESULT real_ThreadAPI_CreateEx(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg, const THREADAPI_CREATE_OPTIONS* options);
+
 THREADAPI_RESULT real_ThreadAPI_Join(THREAD_HANDLE threadHandle, int* res);
 
 void real_ThreadAPI_Sleep(unsigned int milliseconds);
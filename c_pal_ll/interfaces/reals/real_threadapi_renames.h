@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #define ThreadAPI_Create                real_ThreadAPI_Create
+#define ThreadAPI_CreateEx              real_ThreadAPI_CreateEx
 #define ThreadAPI_Join                  real_ThreadAPI_Join
 #define ThreadAPI_Sleep                 real_ThreadAPI_Sleep
 #define ThreadAPI_GetCurrentThreadId    real_ThreadAPI_GetCurrentThreadId
@@ -895,6 +895,38 @@ TEST_FUNCTION(interlocked_increment_64_overflows_upper_bound)
     ASSERT_ARE_EQUAL(int64_t, INT64_MIN, return_val, "Return value is incorrect");
 }
 
+/*Tests_SRS_INTERLOCKED_12_001: [ interlocked_load_acquire shall atomically read the 32-bit variable *source with acquire semantics, so that no read or write of the calling thread that follows it is reordered before it. ]*/
+/*Tests_SRS_INTERLOCKED_12_002: [ interlocked_load_acquire shall return the value of *source. ]*/
+TEST_FUNCTION(interlocked_load_acquire_returns_the_value)
+{
+    ///arrange
+    volatile_atomic int32_t source;
+    interlocked_exchange(&source, INT32_MIN);
+
+    ///act
+    int32_t return_val = interlocked_load_acquire(&source);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int32_t, INT32_MIN, interlocked_add(&source, 0), "Value stored in *source is incorrect.");
+    ASSERT_ARE_EQUAL(int32_t, INT32_MIN, return_val, "Return value is incorrect");
+}
+
+/*Tests_SRS_INTERLOCKED_12_003: [ interlocked_load_acquire_64 shall atomically read the 64-bit variable *source with acquire semantics, so that no read or write of the calling thread that follows it is reordered before it. ]*/
+/*Tests_SRS_INTERLOCKED_12_004: [ interlocked_load_acquire_64 shall return the value of *source. ]*/
+TEST_FUNCTION(interlocked_load_acquire_64_returns_the_value)
+{
+    ///arrange
+    volatile_atomic int64_t source;
+    interlocked_exchange_64(&source, INT64_MIN);
+
+    ///act
+    int64_t return_val = interlocked_load_acquire_64(&source);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int64_t, INT64_MIN, interlocked_add_64(&source, 0), "Value stored in *source is incorrect.");
+    ASSERT_ARE_EQUAL(int64_t, INT64_MIN, return_val, "Return value is incorrect");
+}
+
 /*Tests_SRS_INTERLOCKED_43_024: [ interlocked_or shall perform an atomic bitwise OR operation on the 32-bit integers *destination and value and store the result in destination.]*/
 /*Tests_SRS_INTERLOCKED_43_055: [ interlocked_or shall return the initial value of *destination. ]*/
 TEST_FUNCTION(interlocked_or_does_bitwise_or)
@@ -964,6 +996,34 @@ TEST_FUNCTION(interlocked_or_8_does_bitwise_or)
     ASSERT_ARE_EQUAL(uint8_t, 0xF0, return_val, "Return value is incorrect");
 }
 
+/*Tests_SRS_INTERLOCKED_12_005: [ interlocked_store_release shall atomically store value in the 32-bit variable *destination with release semantics, so that no read or write of the calling thread that precedes it is reordered after it. ]*/
+TEST_FUNCTION(interlocked_store_release_sets_destination)
+{
+    ///arrange
+    volatile_atomic int32_t destination;
+    interlocked_exchange(&destination, 0);
+
+    ///act
+    interlocked_store_release(&destination, INT32_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int32_t, INT32_MAX, interlocked_add(&destination, 0), "Value stored in *destination is incorrect.");
+}
+
+/*Tests_SRS_INTERLOCKED_12_006: [ interlocked_store_release_64 shall atomically store value in the 64-bit variable *destination with release semantics, so that no read or write of the calling thread that precedes it is reordered after it. ]*/
+TEST_FUNCTION(interlocked_store_release_64_sets_destination)
+{
+    ///arrange
+    volatile_atomic int64_t destination;
+    interlocked_exchange_64(&destination, 0);
+
+    ///act
+    interlocked_store_release_64(&destination, INT64_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int64_t, INT64_MAX, interlocked_add_64(&destination, 0), "Value stored in *destination is incorrect.");
+}
+
 /*Tests_SRS_INTERLOCKED_43_028: [ interlocked_xor shall perform an atomic bitwise XOR operation on the 32-bit integers *destination and value and store the result in destination.]*/
 /*Tests_SRS_INTERLOCKED_43_059: [ interlocked_xor shall return the initial value of *destination. ]*/
 TEST_FUNCTION(interlocked_xor_does_bitwise_xor)
@@ -0,0 +1,212 @@
+//Copyright(c) Microsoft.All rights reserved.
+//Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef WIN32
+#define _GNU_SOURCE
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#ifdef WIN32
+#include "windows.h"
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+// IWYU pragma: no_include <wchar.h>
+#include "testrunnerswitcher.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/threadapi.h"
+
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES)
+
+typedef struct THREAD_PROPERTIES_TAG
+{
+    char name[THREADAPI_MAX_THREAD_NAME_LENGTH + 1];
+    bool name_read;
+    uint32_t cpu_count;
+    bool runs_on_cpu_0;
+    bool affinity_read;
+} THREAD_PROPERTIES;
+
+// the thread reads its own name and affinity, the test checks them after joining it
+static int read_thread_properties(void* context)
+{
+    THREAD_PROPERTIES* properties = context;
+
+#ifdef WIN32
+    PWSTR description;
+    if (SUCCEEDED(GetThreadDescription(GetCurrentThread(), &description)))
+    {
+        properties->name_read = (WideCharToMultiByte(CP_UTF8, 0, description, -1, properties->name, sizeof(properties->name), NULL, NULL) != 0);
+        (void)LocalFree(description);
+    }
+
+    GROUP_AFFINITY group_affinity;
+    if (GetThreadGroupAffinity(GetCurrentThread(), &group_affinity))
+    {
+        properties->cpu_count = 0;
+        for (uint32_t i = 0; i < sizeof(KAFFINITY) * 8; i++)
+        {
+            if ((group_affinity.Mask & ((KAFFINITY)1 << i)) != 0)
+            {
+                properties->cpu_count++;
+            }
+        }
+        properties->runs_on_cpu_0 = (group_affinity.Group == 0) && ((group_affinity.Mask & 1) != 0);
+        properties->affinity_read = true;
+    }
+#else
+    properties->name_read = (pthread_getname_np(pthread_self(), properties->name, sizeof(properties->name)) == 0);
+
+    cpu_set_t cpu_set;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0)
+    {
+        properties->cpu_count = (uint32_t)CPU_COUNT(&cpu_set);
+        properties->runs_on_cpu_0 = CPU_ISSET(0, &cpu_set);
+        properties->affinity_read = true;
+    }
+#endif
+
+    return 0;
+}
+
+static void create_and_join_thread(const THREADAPI_CREATE_OPTIONS* options, THREAD_PROPERTIES* properties)
+{
+    THREAD_HANDLE thread_handle;
+    (void)memset(properties, 0, sizeof(*properties));
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_CreateEx(&thread_handle, read_thread_properties, properties, options));
+
+    int thread_result;
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(thread_handle, &thread_result));
+    ASSERT_ARE_EQUAL(int, 0, thread_result);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(a)
+{
+}
+
+TEST_SUITE_CLEANUP(b)
+{
+}
+
+TEST_FUNCTION_INITIALIZE(c)
+{
+}
+
+TEST_FUNCTION_CLEANUP(d)
+{
+}
+
+/* Tests_NON_THREADAPI_30_033: [ If options is NULL ThreadAPI_CreateEx shall behave like ThreadAPI_Create. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_NULL_options_runs_the_thread)
+{
+    // arrange
+    THREAD_PROPERTIES properties;
+
+    // act
+    create_and_join_thread(NULL, &properties);
+
+    // assert
+    ASSERT_IS_TRUE(properties.affinity_read);
+    ASSERT_IS_TRUE(properties.cpu_count > 0);
+}
+
+/* Tests_NON_THREADAPI_30_037: [ If name is not NULL, ThreadAPI_CreateEx shall set the name of the thread to the first THREADAPI_MAX_THREAD_NAME_LENGTH characters of name. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_sets_the_name_of_the_thread)
+{
+    // arrange
+    THREAD_PROPERTIES properties;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.name = "threadapi_int";
+
+    // act
+    create_and_join_thread(&options, &properties);
+
+    // assert
+    ASSERT_IS_TRUE(properties.name_read);
+    ASSERT_ARE_EQUAL(char_ptr, "threadapi_int", properties.name);
+}
+
+/* Tests_NON_THREADAPI_30_037: [ If name is not NULL, ThreadAPI_CreateEx shall set the name of the thread to the first THREADAPI_MAX_THREAD_NAME_LENGTH characters of name. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_sets_the_first_characters_of_a_long_name)
+{
+    // arrange
+    THREAD_PROPERTIES properties;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.name = "threadapi_int_with_a_long_name";
+
+    // act
+    create_and_join_thread(&options, &properties);
+
+    // assert
+    ASSERT_IS_TRUE(properties.name_read);
+    ASSERT_ARE_EQUAL(char_ptr, "threadapi_int_w", properties.name);
+}
+
+/* Tests_NON_THREADAPI_30_035: [ If cpu_count is not 0 or use_numa_node is true, ThreadAPI_CreateEx shall restrict the thread to run only on the CPUs in cpus and, if use_numa_node is true, on the CPUs of the NUMA node numa_node. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_restricts_the_thread_to_the_cpus)
+{
+    // arrange
+    THREAD_PROPERTIES properties;
+    uint32_t cpus[] = { 0 };
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.cpus = cpus;
+    options.cpu_count = MU_COUNT_ARRAY_ITEMS(cpus);
+
+    // act
+    create_and_join_thread(&options, &properties);
+
+    // assert
+    ASSERT_IS_TRUE(properties.affinity_read);
+    ASSERT_ARE_EQUAL(uint32_t, 1, properties.cpu_count);
+    ASSERT_IS_TRUE(properties.runs_on_cpu_0);
+}
+
+/* Tests_NON_THREADAPI_30_035: [ If cpu_count is not 0 or use_numa_node is true, ThreadAPI_CreateEx shall restrict the thread to run only on the CPUs in cpus and, if use_numa_node is true, on the CPUs of the NUMA node numa_node. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_restricts_the_thread_to_the_cpus_of_numa_node_0)
+{
+    // arrange
+    THREAD_PROPERTIES properties;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.use_numa_node = true;
+    options.numa_node = 0;
+
+    // act
+    create_and_join_thread(&options, &properties);
+
+    // assert
+    ASSERT_IS_TRUE(properties.affinity_read);
+    ASSERT_IS_TRUE(properties.cpu_count > 0);
+}
+
+/* Tests_NON_THREADAPI_30_036: [ If the stack size or the CPU affinity cannot be applied (for example a CPU index or a NUMA node that does not exist), ThreadAPI_CreateEx shall not create the thread and return THREADAPI_INVALID_ARG. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_a_numa_node_that_does_not_exist_fails)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    THREAD_PROPERTIES properties;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.use_numa_node = true;
+    // 65536 would be node 0 if it were narrowed to 16 bits before being checked
+    options.numa_node = 65536;
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, read_thread_properties, &properties, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_INVALID_ARG, result);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -41,10 +41,14 @@
         interlocked_increment                       ,\
         interlocked_increment_16                    ,\
         interlocked_increment_64                    ,\
+        interlocked_load_acquire                    ,\
+        interlocked_load_acquire_64                 ,\
         interlocked_or                              ,\
         interlocked_or_16                           ,\
         interlocked_or_64                           ,\
         interlocked_or_8                            ,\
+        interlocked_store_release                   ,\
+        interlocked_store_release_64                ,\
         interlocked_xor                             ,\
         interlocked_xor_16                          ,\
         interlocked_xor_64                          ,\
@@ -80,10 +84,14 @@ void* real_interlocked_exchange_pointer(void* volatile_atomic* target, void* val
 int32_t real_interlocked_increment(volatile_atomic int32_t* addend);
 int16_t real_interlocked_increment_16(volatile_atomic int16_t* addend);
 int64_t real_interlocked_increment_64(volatile_atomic int64_t* addend);
+int32_t real_interlocked_load_acquire(volatile_atomic int32_t* source);
+int64_t real_interlocked_load_acquire_64(volatile_atomic int64_t* source);
 int32_t real_interlocked_or(volatile_atomic int32_t* destination, int32_t value);
 int16_t real_interlocked_or_16(volatile_atomic int16_t* destination, int16_t value);
 int64_t real_interlocked_or_64(volatile_atomic int64_t* destination, int64_t value);
 int8_t real_interlocked_or_8(volatile_atomic int8_t* destination, int8_t value);
+void real_interlocked_store_release(volatile_atomic int32_t* destination, int32_t value);
+void real_interlocked_store_release_64(volatile_atomic int64_t* destination, int64_t value);
 int32_t real_interlocked_xor(volatile_atomic int32_t* destination, int32_t value);
 int16_t real_interlocked_xor_16(volatile_atomic int16_t* destination, int16_t value);
 int64_t real_interlocked_xor_64(volatile_atomic int64_t* destination, int64_t value);
@@ -336,6 +336,28 @@ int64_t interlocked_increment_64(volatile_atomic int64_t* addend)
     return result + 1;
 }
 
+int32_t interlocked_load_acquire(volatile_atomic int32_t* source)
+{
+    /*Codes_SRS_INTERLOCKED_LINUX_12_001: [ interlocked_load_acquire shall call atomic_load_explicit with source as object and memory_order_acquire as order. ]*/
+    /*Codes_SRS_INTERLOCKED_LINUX_12_002: [ interlocked_load_acquire shall return the value returned by atomic_load_explicit. ]*/
+    int32_t result = atomic_load_explicit(source, memory_order_acquire);
+#ifdef USE_VALGRIND
+    ANNOTATE_HAPPENS_AFTER(source);
+#endif
+    return result;
+}
+
+int64_t interlocked_load_acquire_64(volatile_atomic int64_t* source)
+{
+    /*Codes_SRS_INTERLOCKED_LINUX_12_003: [ interlocked_load_acquire_64 shall call atomic_load_explicit with source as object and memory_order_acquire as order. ]*/
+    /*Codes_SRS_INTERLOCKED_LINUX_12_004: [ interlocked_load_acquire_64 shall return the value returned by atomic_load_explicit. ]*/
+    int64_t result = atomic_load_explicit(source, memory_order_acquire);
+#ifdef USE_VALGRIND
+    ANNOTATE_HAPPENS_AFTER(source);
+#endif
+    return result;
+}
+
 int32_t interlocked_or(volatile_atomic int32_t* destination, int32_t value)
 {
     /*Codes_SRS_INTERLOCKED_LINUX_43_047: [ interlocked_or shall call atomic_fetch_and with destination as object and value as operand. ]*/
@@ -392,6 +414,24 @@ int8_t interlocked_or_8(volatile_atomic int8_t* destination, int8_t value)
     return result;
 }
 
+void interlocked_store_release(volatile_atomic int32_t* destination, int32_t value)
+{
+    /*Codes_SRS_INTERLOCKED_LINUX_12_005: [ interlocked_store_release shall call atomic_store_explicit with destination as object, value as desired and memory_order_release as order. ]*/
+#ifdef USE_VALGRIND
+    ANNOTATE_HAPPENS_BEFORE(destination);
+#endif
+    atomic_store_explicit(destination, value, memory_order_release);
+}
+
+void interlocked_store_release_64(volatile_atomic int64_t* destination, int64_t value)
+{
+    /*Codes_SRS_INTERLOCKED_LINUX_12_006: [ interlocked_store_release_64 shall call atomic_store_explicit with destination as object, value as desired and memory_order_release as order. ]*/
+#ifdef USE_VALGRIND
+    ANNOTATE_HAPPENS_BEFORE(destination);
+#endif
+    atomic_store_explicit(destination, value, memory_order_release);
+}
+
 int32_t interlocked_xor(volatile_atomic int32_t* destination, int32_t value)
 {
     /*Codes_SRS_INTERLOCKED_LINUX_43_055: [ interlocked_xor shall call atomic_fetch_and with destination as object and value as operand. ]*/
@@ -1,15 +1,19 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
-#define _DEFAULT_SOURCE
+#define _GNU_SOURCE
 
 #include "macro_utils/macro_utils.h"
 
+#include <inttypes.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include <pthread.h>
+#include <sched.h>
 #include <time.h>
 #include "c_logging/logger.h"
 
@@ -23,65 +27,227 @@ typedef struct THREAD_INSTANCE_TAG
     pthread_t Pthread_handle;
     THREAD_START_FUNC ThreadStartFunc;
     void* Arg;
+    char Name[THREADAPI_MAX_THREAD_NAME_LENGTH + 1]; /*the kernel limits thread names to 16 bytes including the terminating zero*/
 } THREAD_INSTANCE;
 
 static void* ThreadWrapper(void* threadInstanceArg)
 {
     THREAD_INSTANCE* threadInstance = (THREAD_INSTANCE*)threadInstanceArg;
+    if (threadInstance->Name[0] != '\0')
+    {
+        /*the name is only a diagnostic aid, so failing to set it does not stop the thread*/
+        int setNameResult = pthread_setname_np(pthread_self(), threadInstance->Name);
+        if (setNameResult != 0)
+        {
+            LogWarning("pthread_setname_np(%s) failed with %d", threadInstance->Name, setNameResult);
+        }
+    }
     int result = threadInstance->ThreadStartFunc(threadInstance->Arg);
     return (void*)(intptr_t)result;
 }
 
-THREADAPI_RESULT ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg)
+/*adds to cpu_set the CPUs listed in /sys/devices/system/node/node<numa_node>/cpulist (for example "0-7,16-23")*/
+static int add_numa_node_cpus(uint32_t numa_node, cpu_set_t* cpu_set)
+{
+    int result;
+    char path[64];
+    (void)snprintf(path, sizeof(path), "/sys/devices/system/node/node%" PRIu32 "/cpulist", numa_node);
+
+    FILE* cpulist_file = fopen(path, "r");
+    if (cpulist_file == NULL)
+    {
+        LogError("fopen(%s) failed, errno=%d", path, errno);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        char cpulist[1024];
+        if (fgets(cpulist, sizeof(cpulist), cpulist_file) == NULL)
+        {
+            LogError("fgets failed for %s", path);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            uint32_t cpu_count = 0;
+            const char* current = cpulist;
+            while (*current != '\0')
+            {
+                char* end;
+                unsigned long first_cpu = strtoul(current, &end, 10);
+                if (end == current)
+                {
+                    break;
+                }
+                unsigned long last_cpu = first_cpu;
+                if (*end == '-')
+                {
+                    current = end + 1;
+                    last_cpu = strtoul(current, &end, 10);
+                    if (end == current)
+                    {
+                        break;
+                    }
+                }
+                for (unsigned long cpu = first_cpu; (cpu <= last_cpu) && (cpu < CPU_SETSIZE); cpu++)
+                {
+                    CPU_SET(cpu, cpu_set);
+                    cpu_count++;
+                }
+                current = (*end == ',') ? end + 1 : end;
+            }
+
+            if (cpu_count == 0)
+            {
+                LogError("NUMA node %" PRIu32 " has no CPUs (cpulist=%s)", numa_node, cpulist);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                result = 0;
+            }
+        }
+        (void)fclose(cpulist_file);
+    }
+
+    return result;
+}
+
+static int apply_create_options(pthread_attr_t* attr, const THREADAPI_CREATE_OPTIONS* options)
+{
+    int result;
+
+    if ((options->stack_size != 0) &&
+        (pthread_attr_setstacksize(attr, options->stack_size) != 0))
+    {
+        LogError("pthread_attr_setstacksize failed, stack_size=%zu", options->stack_size);
+        result = MU_FAILURE;
+    }
+    else if ((options->cpu_count == 0) && !options->use_numa_node)
+    {
+        result = 0;
+    }
+    else
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+
+        uint32_t i;
+        for (i = 0; i < options->cpu_count; i++)
+        {
+            if (options->cpus[i] >= CPU_SETSIZE)
+            {
+                LogError("Invalid CPU index %" PRIu32 ", must be less than %d", options->cpus[i], CPU_SETSIZE);
+                break;
+            }
+            CPU_SET(options->cpus[i], &cpu_set);
+        }
+
+        if (i < options->cpu_count)
+        {
+            result = MU_FAILURE;
+        }
+        else if (options->use_numa_node && (add_numa_node_cpus(options->numa_node, &cpu_set) != 0))
+        {
+            LogError("add_numa_node_cpus failed, numa_node=%" PRIu32, options->numa_node);
+            result = MU_FAILURE;
+        }
+        else if (pthread_attr_setaffinity_np(attr, sizeof(cpu_set), &cpu_set) != 0)
+        {
+            LogError("pthread_attr_setaffinity_np failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+THREADAPI_RESULT ThreadAPI_CreateEx(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg, const THREADAPI_CREATE_OPTIONS* options)
 {
     THREADAPI_RESULT result;
 
     if ((threadHandle == NULL) ||
-        (func == NULL))
+        (func == NULL) ||
+        ((options != NULL) && (options->cpu_count != 0) && (options->cpus == NULL)))
     {
         result = THREADAPI_INVALID_ARG;
         LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
     }
     else
     {
-        THREAD_INSTANCE* threadInstance = malloc(sizeof(THREAD_INSTANCE));
-        if (threadInstance == NULL)
+        pthread_attr_t attr;
+        if (pthread_attr_init(&attr) != 0)
         {
-            result = THREADAPI_NO_MEMORY;
-            LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
+            result = THREADAPI_ERROR;
+            LogError("pthread_attr_init failed (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
         }
         else
         {
-            threadInstance->ThreadStartFunc = func;
-            threadInstance->Arg = arg;
-            int createResult = pthread_create(&threadInstance->Pthread_handle, NULL, ThreadWrapper, threadInstance);
-            switch (createResult)
+            if ((options != NULL) && (apply_create_options(&attr, options) != 0))
+            {
+                result = THREADAPI_INVALID_ARG;
+                LogError("apply_create_options failed (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
+            }
+            else
             {
-            default:
-                free(threadInstance);
+                THREAD_INSTANCE* threadInstance = malloc(sizeof(THREAD_INSTANCE));
+                if (threadInstance == NULL)
+                {
+                    result = THREADAPI_NO_MEMORY;
+                    LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
+                }
+                else
+                {
+                    threadInstance->ThreadStartFunc = func;
+                    threadInstance->Arg = arg;
+                    threadInstance->Name[0] = '\0';
+                    if ((options != NULL) && (options->name != NULL))
+                    {
+                        (void)strncpy(threadInstance->Name, options->name, THREADAPI_MAX_THREAD_NAME_LENGTH);
+                        threadInstance->Name[THREADAPI_MAX_THREAD_NAME_LENGTH] = '\0';
+                    }
 
-                result = THREADAPI_ERROR;
-                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
-                break;
+                    int createResult = pthread_create(&threadInstance->Pthread_handle, &attr, ThreadWrapper, threadInstance);
+                    switch (createResult)
+                    {
+                    default:
+                        free(threadInstance);
 
-            case 0:
-                *threadHandle = threadInstance;
-                result = THREADAPI_OK;
-                break;
+                        result = THREADAPI_ERROR;
+                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
+                        break;
 
-            case EAGAIN:
-                free(threadInstance);
+                    case 0:
+                        *threadHandle = threadInstance;
+                        result = THREADAPI_OK;
+                        break;
 
-                result = THREADAPI_NO_MEMORY;
-                LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
-                break;
+                    case EAGAIN:
+                        free(threadInstance);
+
+                        result = THREADAPI_NO_MEMORY;
+                        LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
+                        break;
+                    }
+                }
             }
+
+            (void)pthread_attr_destroy(&attr);
         }
     }
 
     return result;
 }
 
+THREADAPI_RESULT ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg)
+{
+    return ThreadAPI_CreateEx(threadHandle, func, arg, NULL);
+}
+
 THREADAPI_RESULT ThreadAPI_Join(THREAD_HANDLE threadHandle, int* res)
 {
     THREADAPI_RESULT result;
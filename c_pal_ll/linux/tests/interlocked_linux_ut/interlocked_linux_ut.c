@@ -592,6 +592,42 @@ TEST_FUNCTION(interlocked_increment_64_calls_atomic_fetch_add)
     ASSERT_ARE_EQUAL(int64_t, INT64_MAX, return_val, "Return value is incorrect.");
 }
 
+/*Tests_SRS_INTERLOCKED_LINUX_12_001: [ interlocked_load_acquire shall call atomic_load_explicit with source as object and memory_order_acquire as order. ]*/
+/*Tests_SRS_INTERLOCKED_LINUX_12_002: [ interlocked_load_acquire shall return the value returned by atomic_load_explicit. ]*/
+TEST_FUNCTION(interlocked_load_acquire_calls_atomic_load_explicit)
+{
+    ///arrange
+    volatile_atomic int32_t source;
+    atomic_exchange(&source, INT32_MAX);
+    STRICT_EXPECTED_CALL(mock_atomic_load_explicit_32(&source, memory_order_acquire))
+        .SetReturn(INT32_MAX);
+
+    ///act
+    int32_t return_val = interlocked_load_acquire(&source);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls(), "Actual calls differ from expected calls");
+    ASSERT_ARE_EQUAL(int32_t, INT32_MAX, return_val, "Return value is incorrect.");
+}
+
+/*Tests_SRS_INTERLOCKED_LINUX_12_003: [ interlocked_load_acquire_64 shall call atomic_load_explicit with source as object and memory_order_acquire as order. ]*/
+/*Tests_SRS_INTERLOCKED_LINUX_12_004: [ interlocked_load_acquire_64 shall return the value returned by atomic_load_explicit. ]*/
+TEST_FUNCTION(interlocked_load_acquire_64_calls_atomic_load_explicit)
+{
+    ///arrange
+    volatile_atomic int64_t source;
+    atomic_exchange(&source, INT64_MAX);
+    STRICT_EXPECTED_CALL(mock_atomic_load_explicit_64(&source, memory_order_acquire))
+        .SetReturn(INT64_MAX);
+
+    ///act
+    int64_t return_val = interlocked_load_acquire_64(&source);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls(), "Actual calls differ from expected calls");
+    ASSERT_ARE_EQUAL(int64_t, INT64_MAX, return_val, "Return value is incorrect.");
+}
+
 
 /*Tests_SRS_INTERLOCKED_LINUX_43_047: [ interlocked_or shall call atomic_fetch_and with destination as object and value as operand. ]*/
 /*Tests_SRS_INTERLOCKED_LINUX_43_048: [ interlocked_or shall return the initial value of *destination. ]*/
@@ -669,6 +705,36 @@ TEST_FUNCTION(interlocked_or_8_calls_atomic_fetch_or)
     ASSERT_ARE_EQUAL(uint8_t, 0xF0, return_val, "Return value is incorrect.");
 }
 
+/*Tests_SRS_INTERLOCKED_LINUX_12_005: [ interlocked_store_release shall call atomic_store_explicit with destination as object, value as desired and memory_order_release as order. ]*/
+TEST_FUNCTION(interlocked_store_release_calls_atomic_store_explicit)
+{
+    ///arrange
+    volatile_atomic int32_t destination;
+    atomic_exchange(&destination, 0);
+    STRICT_EXPECTED_CALL(mock_atomic_store_explicit_32(&destination, INT32_MAX, memory_order_release));
+
+    ///act
+    interlocked_store_release(&destination, INT32_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls(), "Actual calls differ from expected calls");
+}
+
+/*Tests_SRS_INTERLOCKED_LINUX_12_006: [ interlocked_store_release_64 shall call atomic_store_explicit with destination as object, value as desired and memory_order_release as order. ]*/
+TEST_FUNCTION(interlocked_store_release_64_calls_atomic_store_explicit)
+{
+    ///arrange
+    volatile_atomic int64_t destination;
+    atomic_exchange(&destination, 0);
+    STRICT_EXPECTED_CALL(mock_atomic_store_explicit_64(&destination, INT64_MAX, memory_order_release));
+
+    ///act
+    interlocked_store_release_64(&destination, INT64_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls(), "Actual calls differ from expected calls");
+}
+
 /*Tests_SRS_INTERLOCKED_LINUX_43_055: [ interlocked_xor shall call atomic_fetch_and with destination as object and value as operand. ]*/
 /*Tests_SRS_INTERLOCKED_LINUX_43_056: [ interlocked_xor shall return the initial value of *destination. ]*/
 TEST_FUNCTION(interlocked_xor_calls_atomic_fetch_xor)
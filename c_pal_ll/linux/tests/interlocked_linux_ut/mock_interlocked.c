@@ -76,4 +76,18 @@
     void* volatile_atomic*: mock_atomic_load_pointer \
 )(X)
 
+#undef atomic_load_explicit
+#define atomic_load_explicit mock_atomic_load_explicit
+#define mock_atomic_load_explicit(X, Y) _Generic((X), \
+    volatile_atomic int32_t*: mock_atomic_load_explicit_32, \
+    volatile_atomic int64_t*: mock_atomic_load_explicit_64 \
+)(X, Y)
+
+#undef atomic_store_explicit
+#define atomic_store_explicit mock_atomic_store_explicit
+#define mock_atomic_store_explicit(X, Y, Z) _Generic((X), \
+    volatile_atomic int32_t*: mock_atomic_store_explicit_32, \
+    volatile_atomic int64_t*: mock_atomic_store_explicit_64 \
+)(X, Y, Z)
+
 #include "../../src/interlocked_linux.c"
@@ -41,5 +41,9 @@ MOCKABLE_FUNCTION(, int16_t, mock_atomic_load_16, volatile_atomic int16_t*, obje
 MOCKABLE_FUNCTION(, int32_t, mock_atomic_load_32, volatile_atomic int32_t*, object);
 MOCKABLE_FUNCTION(, int64_t, mock_atomic_load_64, volatile_atomic int64_t*, object);
 MOCKABLE_FUNCTION(, void*, mock_atomic_load_pointer, void* volatile_atomic*, object);
+MOCKABLE_FUNCTION(, int32_t, mock_atomic_load_explicit_32, volatile_atomic int32_t*, object, int32_t, order);
+MOCKABLE_FUNCTION(, int64_t, mock_atomic_load_explicit_64, volatile_atomic int64_t*, object, int32_t, order);
+MOCKABLE_FUNCTION(, void, mock_atomic_store_explicit_32, volatile_atomic int32_t*, object, int32_t, desired, int32_t, order);
+MOCKABLE_FUNCTION(, void, mock_atomic_store_explicit_64, volatile_atomic int64_t*, object, int64_t, desired, int32_t, order);
 
 #endif
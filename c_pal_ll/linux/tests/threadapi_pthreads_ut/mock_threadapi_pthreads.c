@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "mock_threadapi_pthreads.h"
+
+#define fopen mock_fopen
+#define fgets mock_fgets
+#define fclose mock_fclose
+#define pthread_attr_setaffinity_np mock_pthread_attr_setaffinity_np
+#define pthread_create mock_pthread_create
+#define pthread_join mock_pthread_join
+#define pthread_setname_np mock_pthread_setname_np
+
+#include "../../src/threadapi_pthreads.c"
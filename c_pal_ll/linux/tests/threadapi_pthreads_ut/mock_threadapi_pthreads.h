@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MOCK_THREADAPI_PTHREADS_H
+#define MOCK_THREADAPI_PTHREADS_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "umock_c/umock_c_prod.h"
+
+typedef void* (*PTHREAD_START_ROUTINE)(void*);
+
+MOCKABLE_FUNCTION(, FILE*, mock_fopen, const char*, pathname, const char*, mode);
+MOCKABLE_FUNCTION(, char*, mock_fgets, char*, s, int, size, FILE*, stream);
+MOCKABLE_FUNCTION(, int, mock_fclose, FILE*, stream);
+MOCKABLE_FUNCTION(, int, mock_pthread_attr_setaffinity_np, pthread_attr_t*, attr, size_t, cpusetsize, const cpu_set_t*, cpuset);
+MOCKABLE_FUNCTION(, int, mock_pthread_create, pthread_t*, thread, const pthread_attr_t*, attr, PTHREAD_START_ROUTINE, start_routine, void*, arg);
+MOCKABLE_FUNCTION(, int, mock_pthread_join, pthread_t, thread, void**, retval);
+MOCKABLE_FUNCTION(, int, mock_pthread_setname_np, pthread_t, thread, const char*, name);
+
+#endif
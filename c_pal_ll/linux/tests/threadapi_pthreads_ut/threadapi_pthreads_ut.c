@@ -0,0 +1,468 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "threadapi_pthreads_ut_pch.h"
+#undef ENABLE_MOCKS_DECL
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+#include "umock_c/umock_c_ENABLE_MOCKS.h" // ============================== ENABLE_MOCKS
+#include "mock_threadapi_pthreads.h"
+#include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
+
+#define TEST_CPULIST_FILE ((FILE*)0x4242)
+#define TEST_PTHREAD ((pthread_t)0x4243)
+
+static const char* test_cpulist;
+static cpu_set_t test_affinity;
+static bool test_affinity_set;
+static PTHREAD_START_ROUTINE test_start_routine;
+static void* test_start_routine_arg;
+
+static FILE* hook_mock_fopen(const char* pathname, const char* mode)
+{
+    (void)pathname;
+    (void)mode;
+    return TEST_CPULIST_FILE;
+}
+
+static char* hook_mock_fgets(char* s, int size, FILE* stream)
+{
+    (void)stream;
+    (void)snprintf(s, size, "%s", test_cpulist);
+    return s;
+}
+
+static int hook_mock_pthread_attr_setaffinity_np(pthread_attr_t* attr, size_t cpusetsize, const cpu_set_t* cpuset)
+{
+    (void)attr;
+    ASSERT_ARE_EQUAL(size_t, sizeof(cpu_set_t), cpusetsize);
+    test_affinity = *cpuset;
+    test_affinity_set = true;
+    return 0;
+}
+
+static int hook_mock_pthread_create(pthread_t* thread, const pthread_attr_t* attr, PTHREAD_START_ROUTINE start_routine, void* arg)
+{
+    (void)attr;
+    *thread = TEST_PTHREAD;
+    // the thread does not run, the test runs the start routine when it needs to
+    test_start_routine = start_routine;
+    test_start_routine_arg = arg;
+    return 0;
+}
+
+static int hook_mock_pthread_join(pthread_t thread, void** retval)
+{
+    (void)thread;
+    *retval = (void*)(intptr_t)42;
+    return 0;
+}
+
+static int test_thread_func(void* arg)
+{
+    ASSERT_ARE_EQUAL(void_ptr, (void*)0x4244, arg);
+    return 42;
+}
+
+static void join_test_thread(THREAD_HANDLE thread_handle)
+{
+    int thread_result;
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(thread_handle, &thread_result));
+    ASSERT_ARE_EQUAL(int, 42, thread_result);
+}
+
+static void assert_affinity_is(const uint32_t* cpus, uint32_t cpu_count)
+{
+    ASSERT_IS_TRUE(test_affinity_set);
+    ASSERT_ARE_EQUAL(int, (int)cpu_count, CPU_COUNT(&test_affinity));
+    for (uint32_t i = 0; i < cpu_count; i++)
+    {
+        ASSERT_IS_TRUE(CPU_ISSET(cpus[i], &test_affinity), "CPU %" PRIu32 " is not in the affinity", cpus[i]);
+    }
+}
+
+static void ThreadAPI_CreateEx_read_cpulist_expectations(const char* path)
+{
+    STRICT_EXPECTED_CALL(mock_fopen(path, "r"));
+    STRICT_EXPECTED_CALL(mock_fgets(IGNORED_ARG, IGNORED_ARG, TEST_CPULIST_FILE));
+    STRICT_EXPECTED_CALL(mock_fclose(TEST_CPULIST_FILE));
+}
+
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_charptr_register_types(), "umocktypes_charptr_register_types failed");
+
+    REGISTER_UMOCK_ALIAS_TYPE(FILE*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(pthread_t, unsigned long);
+    REGISTER_UMOCK_ALIAS_TYPE(pthread_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(pthread_attr_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const pthread_attr_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const cpu_set_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PTHREAD_START_ROUTINE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(void**, void*);
+
+    REGISTER_GLOBAL_MOCK_HOOK(mock_fopen, hook_mock_fopen);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_fgets, hook_mock_fgets);
+    REGISTER_GLOBAL_MOCK_RETURN(mock_fclose, 0);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_pthread_attr_setaffinity_np, hook_mock_pthread_attr_setaffinity_np);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_pthread_create, hook_mock_pthread_create);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_pthread_join, hook_mock_pthread_join);
+    REGISTER_GLOBAL_MOCK_RETURN(mock_pthread_setname_np, 0);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    test_cpulist = "0\n";
+    CPU_ZERO(&test_affinity);
+    test_affinity_set = false;
+    test_start_routine = NULL;
+    test_start_routine_arg = NULL;
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+/* ThreadAPI_CreateEx */
+
+/* Tests_NON_THREADAPI_30_032: [ If options is not NULL, cpu_count is not 0 and cpus is NULL ThreadAPI_CreateEx shall return THREADAPI_INVALID_ARG. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_cpu_count_and_NULL_cpus_fails)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.cpu_count = 1;
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_INVALID_ARG, result);
+}
+
+/* Tests_NON_THREADAPI_30_033: [ If options is NULL ThreadAPI_CreateEx shall behave like ThreadAPI_Create. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_NULL_options_does_not_set_the_affinity_nor_the_name)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, result);
+    ASSERT_IS_NOT_NULL(test_start_routine);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)(intptr_t)42, test_start_routine(test_start_routine_arg));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    join_test_thread(thread_handle);
+}
+
+/* Tests_NON_THREADAPI_30_035: [ If cpu_count is not 0 or use_numa_node is true, ThreadAPI_CreateEx shall restrict the thread to run only on the CPUs in cpus and, if use_numa_node is true, on the CPUs of the NUMA node numa_node. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_cpus_sets_the_affinity_to_the_cpus)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    uint32_t cpus[] = { 1, 3 };
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.cpus = cpus;
+    options.cpu_count = MU_COUNT_ARRAY_ITEMS(cpus);
+
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setaffinity_np(IGNORED_ARG, sizeof(cpu_set_t), IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, result);
+    assert_affinity_is(cpus, MU_COUNT_ARRAY_ITEMS(cpus));
+
+    // cleanup
+    join_test_thread(thread_handle);
+}
+
+/* Tests_NON_THREADAPI_30_035: [ If cpu_count is not 0 or use_numa_node is true, ThreadAPI_CreateEx shall restrict the thread to run only on the CPUs in cpus and, if use_numa_node is true, on the CPUs of the NUMA node numa_node. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_numa_node_sets_the_affinity_to_a_single_cpu_of_the_node)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    uint32_t expected_cpus[] = { 5 };
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.use_numa_node = true;
+    options.numa_node = 0;
+    test_cpulist = "5\n";
+
+    ThreadAPI_CreateEx_read_cpulist_expectations("/sys/devices/system/node/node0/cpulist");
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setaffinity_np(IGNORED_ARG, sizeof(cpu_set_t), IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, result);
+    assert_affinity_is(expected_cpus, MU_COUNT_ARRAY_ITEMS(expected_cpus));
+
+    // cleanup
+    join_test_thread(thread_handle);
+}
+
+/* Tests_NON_THREADAPI_30_035: [ If cpu_count is not 0 or use_numa_node is true, ThreadAPI_CreateEx shall restrict the thread to run only on the CPUs in cpus and, if use_numa_node is true, on the CPUs of the NUMA node numa_node. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_numa_node_sets_the_affinity_to_the_ranges_and_the_cpus_listed_for_the_node)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    uint32_t expected_cpus[] = { 0, 1, 2, 3, 8, 10, 11 };
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.use_numa_node = true;
+    options.numa_node = 1;
+    test_cpulist = "0-3,8,10-11\n";
+
+    ThreadAPI_CreateEx_read_cpulist_expectations("/sys/devices/system/node/node1/cpulist");
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setaffinity_np(IGNORED_ARG, sizeof(cpu_set_t), IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, result);
+    assert_affinity_is(expected_cpus, MU_COUNT_ARRAY_ITEMS(expected_cpus));
+
+    // cleanup
+    join_test_thread(thread_handle);
+}
+
+/* Tests_NON_THREADAPI_30_035: [ If cpu_count is not 0 or use_numa_node is true, ThreadAPI_CreateEx shall restrict the thread to run only on the CPUs in cpus and, if use_numa_node is true, on the CPUs of the NUMA node numa_node. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_cpus_and_numa_node_sets_the_affinity_to_the_cpus_and_the_cpus_of_the_node)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    uint32_t cpus[] = { 20 };
+    uint32_t expected_cpus[] = { 4, 5, 20 };
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.cpus = cpus;
+    options.cpu_count = MU_COUNT_ARRAY_ITEMS(cpus);
+    options.use_numa_node = true;
+    options.numa_node = 2;
+    test_cpulist = "4-5\n";
+
+    ThreadAPI_CreateEx_read_cpulist_expectations("/sys/devices/system/node/node2/cpulist");
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setaffinity_np(IGNORED_ARG, sizeof(cpu_set_t), IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, result);
+    assert_affinity_is(expected_cpus, MU_COUNT_ARRAY_ITEMS(expected_cpus));
+
+    // cleanup
+    join_test_thread(thread_handle);
+}
+
+/* Tests_NON_THREADAPI_30_036: [ If the stack size or the CPU affinity cannot be applied (for example a CPU index or a NUMA node that does not exist), ThreadAPI_CreateEx shall not create the thread and return THREADAPI_INVALID_ARG. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_a_numa_node_that_does_not_exist_fails)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.use_numa_node = true;
+    options.numa_node = 4242;
+
+    STRICT_EXPECTED_CALL(mock_fopen("/sys/devices/system/node/node4242/cpulist", "r"))
+        .SetReturn(NULL);
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_INVALID_ARG, result);
+}
+
+/* Tests_NON_THREADAPI_30_036: [ If the stack size or the CPU affinity cannot be applied (for example a CPU index or a NUMA node that does not exist), ThreadAPI_CreateEx shall not create the thread and return THREADAPI_INVALID_ARG. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_fails_when_reading_the_cpulist_of_the_numa_node_fails)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.use_numa_node = true;
+    options.numa_node = 0;
+
+    STRICT_EXPECTED_CALL(mock_fopen("/sys/devices/system/node/node0/cpulist", "r"));
+    STRICT_EXPECTED_CALL(mock_fgets(IGNORED_ARG, IGNORED_ARG, TEST_CPULIST_FILE))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mock_fclose(TEST_CPULIST_FILE));
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_INVALID_ARG, result);
+}
+
+/* Tests_NON_THREADAPI_30_036: [ If the stack size or the CPU affinity cannot be applied (for example a CPU index or a NUMA node that does not exist), ThreadAPI_CreateEx shall not create the thread and return THREADAPI_INVALID_ARG. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_a_numa_node_without_cpus_fails)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.use_numa_node = true;
+    options.numa_node = 3;
+    test_cpulist = "\n";
+
+    ThreadAPI_CreateEx_read_cpulist_expectations("/sys/devices/system/node/node3/cpulist");
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_INVALID_ARG, result);
+}
+
+/* Tests_NON_THREADAPI_30_036: [ If the stack size or the CPU affinity cannot be applied (for example a CPU index or a NUMA node that does not exist), ThreadAPI_CreateEx shall not create the thread and return THREADAPI_INVALID_ARG. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_a_cpu_index_that_does_not_fit_in_a_cpu_set_fails)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    uint32_t cpus[] = { 0, CPU_SETSIZE };
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.cpus = cpus;
+    options.cpu_count = MU_COUNT_ARRAY_ITEMS(cpus);
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_INVALID_ARG, result);
+}
+
+/* Tests_NON_THREADAPI_30_036: [ If the stack size or the CPU affinity cannot be applied (for example a CPU index or a NUMA node that does not exist), ThreadAPI_CreateEx shall not create the thread and return THREADAPI_INVALID_ARG. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_fails_when_setting_the_affinity_fails)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    uint32_t cpus[] = { 1 };
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.cpus = cpus;
+    options.cpu_count = MU_COUNT_ARRAY_ITEMS(cpus);
+
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setaffinity_np(IGNORED_ARG, sizeof(cpu_set_t), IGNORED_ARG))
+        .SetReturn(EINVAL);
+
+    // act
+    THREADAPI_RESULT result = ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_INVALID_ARG, result);
+}
+
+/* Tests_NON_THREADAPI_30_037: [ If name is not NULL, ThreadAPI_CreateEx shall set the name of the thread to the first THREADAPI_MAX_THREAD_NAME_LENGTH characters of name. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_name_sets_the_name_of_the_thread_when_it_starts)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.name = "tp_worker_1";
+
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_pthread_setname_np(IGNORED_ARG, "tp_worker_1"));
+
+    // act
+    void* thread_result = test_start_routine(test_start_routine_arg);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, (void*)(intptr_t)42, thread_result);
+
+    // cleanup
+    join_test_thread(thread_handle);
+}
+
+/* Tests_NON_THREADAPI_30_037: [ If name is not NULL, ThreadAPI_CreateEx shall set the name of the thread to the first THREADAPI_MAX_THREAD_NAME_LENGTH characters of name. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_with_a_long_name_sets_the_first_characters_of_the_name)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.name = "a_thread_name_longer_than_the_limit";
+
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_pthread_setname_np(IGNORED_ARG, "a_thread_name_l"));
+
+    // act
+    (void)test_start_routine(test_start_routine_arg);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    join_test_thread(thread_handle);
+}
+
+/* Tests_NON_THREADAPI_30_038: [ If setting the name of the thread fails, ThreadAPI_CreateEx shall log a warning and still succeed. ]*/
+TEST_FUNCTION(ThreadAPI_CreateEx_runs_the_thread_when_setting_the_name_fails)
+{
+    // arrange
+    THREAD_HANDLE thread_handle;
+    THREADAPI_CREATE_OPTIONS options = { 0 };
+    options.name = "tp_timer";
+
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_CreateEx(&thread_handle, test_thread_func, (void*)0x4244, &options));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_pthread_setname_np(IGNORED_ARG, "tp_timer"))
+        .SetReturn(ERANGE);
+
+    // act
+    void* thread_result = test_start_routine(test_start_routine_arg);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, (void*)(intptr_t)42, thread_result);
+
+    // cleanup
+    join_test_thread(thread_handle);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Precompiled header for threadapi_pthreads_ut
+
+#ifndef THREADAPI_PTHREADS_UT_PCH_H
+#define THREADAPI_PTHREADS_UT_PCH_H
+
+#define _GNU_SOURCE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_charptr.h"
+
+#include "c_pal/threadapi.h"
+
+#endif // THREADAPI_PTHREADS_UT_PCH_H
@@ -254,6 +254,26 @@ int64_t interlocked_increment_64(volatile int64_t* addend)
     return InterlockedIncrement64((volatile LONG64*)addend);
 }
 
+int32_t interlocked_load_acquire(volatile int32_t* source)
+{
+    /* Codes_SRS_INTERLOCKED_12_001: [ interlocked_load_acquire shall atomically read the 32-bit variable *source with acquire semantics, so that no read or write of the calling thread that follows it is reordered before it. ] */
+    /* Codes_SRS_INTERLOCKED_12_002: [ interlocked_load_acquire shall return the value of *source. ] */
+    /* Codes_SRS_INTERLOCKED_WIN32_12_001: [ interlocked_load_acquire shall call ReadAcquire from windows.h. ] */
+    /* Codes_SRS_INTERLOCKED_WIN32_12_002: [ interlocked_load_acquire shall return the value returned by ReadAcquire. ] */
+
+    return ReadAcquire((volatile LONG*)source);
+}
+
+int64_t interlocked_load_acquire_64(volatile int64_t* source)
+{
+    /* Codes_SRS_INTERLOCKED_12_003: [ interlocked_load_acquire_64 shall atomically read the 64-bit variable *source with acquire semantics, so that no read or write of the calling thread that follows it is reordered before it. ] */
+    /* Codes_SRS_INTERLOCKED_12_004: [ interlocked_load_acquire_64 shall return the value of *source. ] */
+    /* Codes_SRS_INTERLOCKED_WIN32_12_003: [ interlocked_load_acquire_64 shall call ReadAcquire64 from windows.h. ] */
+    /* Codes_SRS_INTERLOCKED_WIN32_12_004: [ interlocked_load_acquire_64 shall return the value returned by ReadAcquire64. ] */
+
+    return ReadAcquire64((volatile LONG64*)source);
+}
+
 int32_t interlocked_or(volatile int32_t* destination, int32_t value)
 {
     /* Codes_SRS_INTERLOCKED_43_024 [ interlocked_or shall perform an atomic bitwise OR operation on the 32-bit integers *destination and value and store the result in destination.] */
@@ -294,6 +314,22 @@ int8_t interlocked_or_8(volatile int8_t* destination, int8_t value)
     return InterlockedOr8((volatile char*)destination, value);
 }
 
+void interlocked_store_release(volatile int32_t* destination, int32_t value)
+{
+    /* Codes_SRS_INTERLOCKED_12_005: [ interlocked_store_release shall atomically store value in the 32-bit variable *destination with release semantics, so that no read or write of the calling thread that precedes it is reordered after it. ] */
+    /* Codes_SRS_INTERLOCKED_WIN32_12_005: [ interlocked_store_release shall call WriteRelease from windows.h. ] */
+
+    WriteRelease((volatile LONG*)destination, value);
+}
+
+void interlocked_store_release_64(volatile int64_t* destination, int64_t value)
+{
+    /* Codes_SRS_INTERLOCKED_12_006: [ interlocked_store_release_64 shall atomically store value in the 64-bit variable *destination with release semantics, so that no read or write of the calling thread that precedes it is reordered after it. ] */
+    /* Codes_SRS_INTERLOCKED_WIN32_12_006: [ interlocked_store_release_64 shall call WriteRelease64 from windows.h. ] */
+
+    WriteRelease64((volatile LONG64*)destination, value);
+}
+
 int32_t interlocked_xor(volatile int32_t* destination, int32_t value)
 {
     /* Codes_SRS_INTERLOCKED_43_028 [ interlocked_xor shall perform an atomic bitwise XOR operation on the 32-bit integers *destination and value and store the result in destination.] */
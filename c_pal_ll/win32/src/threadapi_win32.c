@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+#include <inttypes.h>
 #include <stddef.h>
+#include <wchar.h>
+
 #include "windows.h"
 
 #include "macro_utils/macro_utils.h"
@@ -12,19 +15,80 @@
 
 MU_DEFINE_ENUM_STRINGS(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
 
-THREADAPI_RESULT ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg)
+static int apply_thread_affinity(HANDLE thread_handle, const THREADAPI_CREATE_OPTIONS* options)
+{
+    int result;
+    GROUP_AFFINITY group_affinity = { 0 };
+
+    if (options->use_numa_node)
+    {
+        ULONG highest_numa_node;
+        if (!GetNumaHighestNodeNumber(&highest_numa_node))
+        {
+            LogLastError("GetNumaHighestNodeNumber failed");
+            result = MU_FAILURE;
+            goto all_ok;
+        }
+
+        /*checked before the node number is narrowed to USHORT, so that a node above 65535 does not wrap to an existing node*/
+        if (options->numa_node > highest_numa_node)
+        {
+            LogError("Invalid NUMA node %" PRIu32 ", the highest NUMA node is %lu", options->numa_node, highest_numa_node);
+            result = MU_FAILURE;
+            goto all_ok;
+        }
+
+        if (!GetNumaNodeProcessorMaskEx((USHORT)options->numa_node, &group_affinity))
+        {
+            LogLastError("GetNumaNodeProcessorMaskEx failed, numa_node=%" PRIu32, options->numa_node);
+            result = MU_FAILURE;
+            goto all_ok;
+        }
+    }
+
+    for (uint32_t i = 0; i < options->cpu_count; i++)
+    {
+        /*CPU indices are relative to the processor group of the NUMA node, or to group 0*/
+        if (options->cpus[i] >= sizeof(KAFFINITY) * 8)
+        {
+            LogError("Invalid CPU index %" PRIu32 ", must be less than %zu", options->cpus[i], sizeof(KAFFINITY) * 8);
+            result = MU_FAILURE;
+            goto all_ok;
+        }
+        group_affinity.Mask |= (KAFFINITY)1 << options->cpus[i];
+    }
+
+    if (!SetThreadGroupAffinity(thread_handle, &group_affinity, NULL))
+    {
+        LogLastError("SetThreadGroupAffinity failed");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = 0;
+    }
+
+all_ok:
+    return result;
+}
+
+THREADAPI_RESULT ThreadAPI_CreateEx(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg, const THREADAPI_CREATE_OPTIONS* options)
 {
     THREADAPI_RESULT result;
     if ((threadHandle == NULL) ||
-        (func == NULL))
+        (func == NULL) ||
+        ((options != NULL) && (options->cpu_count != 0) && (options->cpus == NULL)))
     {
         result = THREADAPI_INVALID_ARG;
         LogError("(result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
     }
     else
     {
-        *threadHandle = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)func, arg, 0, NULL);
-        if(*threadHandle == NULL)
+        SIZE_T stack_size = (options == NULL) ? 0 : options->stack_size;
+
+        /*the thread is created suspended so that its affinity and name are set before it runs*/
+        HANDLE thread_handle = CreateThread(NULL, stack_size, (LPTHREAD_START_ROUTINE)func, arg, CREATE_SUSPENDED | ((stack_size != 0) ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0), NULL);
+        if (thread_handle == NULL)
         {
             result = (GetLastError() == ERROR_OUTOFMEMORY) ? THREADAPI_NO_MEMORY : THREADAPI_ERROR;
 
@@ -32,13 +96,62 @@ THREADAPI_RESULT ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC
         }
         else
         {
-            result = THREADAPI_OK;
+            if ((options != NULL) &&
+                ((options->cpu_count != 0) || options->use_numa_node) &&
+                (apply_thread_affinity(thread_handle, options) != 0))
+            {
+                result = THREADAPI_INVALID_ARG;
+                LogError("apply_thread_affinity failed (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
+            }
+            else
+            {
+                if ((options != NULL) && (options->name != NULL))
+                {
+                    wchar_t name[THREADAPI_MAX_THREAD_NAME_LENGTH + 1];
+                    int name_length = MultiByteToWideChar(CP_UTF8, 0, options->name, -1, name, THREADAPI_MAX_THREAD_NAME_LENGTH + 1);
+                    if (name_length == 0)
+                    {
+                        /*the name does not fit, keep the first THREADAPI_MAX_THREAD_NAME_LENGTH characters like on Linux*/
+                        (void)MultiByteToWideChar(CP_UTF8, 0, options->name, THREADAPI_MAX_THREAD_NAME_LENGTH, name, THREADAPI_MAX_THREAD_NAME_LENGTH);
+                        name[THREADAPI_MAX_THREAD_NAME_LENGTH] = L'\0';
+                    }
+
+                    /*the name is only a diagnostic aid, so failing to set it does not fail the thread creation*/
+                    HRESULT hr = SetThreadDescription(thread_handle, name);
+                    if (FAILED(hr))
+                    {
+                        LogWarning("SetThreadDescription failed, hr=0x%08lx", (unsigned long)hr);
+                    }
+                }
+
+                if (ResumeThread(thread_handle) == (DWORD)-1)
+                {
+                    result = THREADAPI_ERROR;
+                    LogLastError("ResumeThread failed (result = %" PRI_MU_ENUM ")", MU_ENUM_VALUE(THREADAPI_RESULT, result));
+                }
+                else
+                {
+                    *threadHandle = thread_handle;
+                    result = THREADAPI_OK;
+                    goto all_ok;
+                }
+            }
+
+            /*the thread never ran, so it can be terminated without leaking anything it owns*/
+            (void)TerminateThread(thread_handle, 0);
+            (void)CloseHandle(thread_handle);
         }
     }
 
+all_ok:
     return result;
 }
 
+THREADAPI_RESULT ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg)
+{
+    return ThreadAPI_CreateEx(threadHandle, func, arg, NULL);
+}
+
 THREADAPI_RESULT ThreadAPI_Join(THREAD_HANDLE threadHandle, int *res)
 {
     THREADAPI_RESULT result = THREADAPI_OK;
@@ -550,6 +550,42 @@ TEST_FUNCTION(interlocked_increment_64_calls_InterlockedIncrement64)
     ASSERT_ARE_EQUAL(int64_t, INT64_MAX, return_val, "Return value is incorrect.");
 }
 
+/*Tests_SRS_INTERLOCKED_WIN32_12_001: [ interlocked_load_acquire shall call ReadAcquire from windows.h. ]*/
+/*Tests_SRS_INTERLOCKED_WIN32_12_002: [ interlocked_load_acquire shall return the value returned by ReadAcquire. ]*/
+TEST_FUNCTION(interlocked_load_acquire_calls_ReadAcquire)
+{
+    ///arrange
+    volatile int32_t source;
+    InterlockedExchange((volatile LONG*)&source, INT32_MAX);
+    STRICT_EXPECTED_CALL(mock_ReadAcquire((volatile LONG*)&source))
+        .SetReturn(INT32_MAX);
+
+    ///act
+    int32_t return_val = interlocked_load_acquire(&source);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls(), "Actual calls differ from expected calls");
+    ASSERT_ARE_EQUAL(int32_t, INT32_MAX, return_val, "Return value is incorrect.");
+}
+
+/*Tests_SRS_INTERLOCKED_WIN32_12_003: [ interlocked_load_acquire_64 shall call ReadAcquire64 from windows.h. ]*/
+/*Tests_SRS_INTERLOCKED_WIN32_12_004: [ interlocked_load_acquire_64 shall return the value returned by ReadAcquire64. ]*/
+TEST_FUNCTION(interlocked_load_acquire_64_calls_ReadAcquire64)
+{
+    ///arrange
+    volatile int64_t source;
+    InterlockedExchange64(&source, INT64_MAX);
+    STRICT_EXPECTED_CALL(mock_ReadAcquire64((volatile LONG64*)&source))
+        .SetReturn(INT64_MAX);
+
+    ///act
+    int64_t return_val = interlocked_load_acquire_64(&source);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls(), "Actual calls differ from expected calls");
+    ASSERT_ARE_EQUAL(int64_t, INT64_MAX, return_val, "Return value is incorrect.");
+}
+
 /*Tests_SRS_INTERLOCKED_WIN32_43_047: [interlocked_or shall call InterlockedOr from windows.h.]*/
 /*Tests_SRS_INTERLOCKED_WIN32_43_048 : [interlocked_or shall return the initial value of *destination.]*/
 TEST_FUNCTION(interlocked_or_calls_InterlockedOr)
@@ -626,6 +662,36 @@ TEST_FUNCTION(interlocked_or_8_calls_InterlockedOr8)
     ASSERT_ARE_EQUAL(uint8_t, 0xF0, return_val, "Return value is incorrect.");
 }
 
+/*Tests_SRS_INTERLOCKED_WIN32_12_005: [ interlocked_store_release shall call WriteRelease from windows.h. ]*/
+TEST_FUNCTION(interlocked_store_release_calls_WriteRelease)
+{
+    ///arrange
+    volatile int32_t destination;
+    InterlockedExchange((volatile LONG*)&destination, 0);
+    STRICT_EXPECTED_CALL(mock_WriteRelease((volatile LONG*)&destination, INT32_MAX));
+
+    ///act
+    interlocked_store_release(&destination, INT32_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls(), "Actual calls differ from expected calls");
+}
+
+/*Tests_SRS_INTERLOCKED_WIN32_12_006: [ interlocked_store_release_64 shall call WriteRelease64 from windows.h. ]*/
+TEST_FUNCTION(interlocked_store_release_64_calls_WriteRelease64)
+{
+    ///arrange
+    volatile int64_t destination;
+    InterlockedExchange64(&destination, 0);
+    STRICT_EXPECTED_CALL(mock_WriteRelease64((volatile LONG64*)&destination, INT64_MAX));
+
+    ///act
+    interlocked_store_release_64(&destination, INT64_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls(), "Actual calls differ from expected calls");
+}
+
 /*Tests_SRS_INTERLOCKED_WIN32_43_055: [interlocked_xor shall call InterlockedXor from windows.h.]*/
 /*Tests_SRS_INTERLOCKED_WIN32_43_056 : [interlocked_xor shall return the initial value of *destination.]*/
 TEST_FUNCTION(interlocked_xor_calls_InterlockedXor)
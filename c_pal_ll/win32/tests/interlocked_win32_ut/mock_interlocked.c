@@ -67,5 +67,13 @@
 #define InterlockedXor64 mock_InterlockedXor64
 #undef InterlockedXor8 
 #define InterlockedXor8 mock_InterlockedXor8
+#undef ReadAcquire
+#define ReadAcquire mock_ReadAcquire
+#undef ReadAcquire64
+#define ReadAcquire64 mock_ReadAcquire64
+#undef WriteRelease
+#define WriteRelease mock_WriteRelease
+#undef WriteRelease64
+#define WriteRelease64 mock_WriteRelease64
 
 #include "../../src/interlocked_win32.c"
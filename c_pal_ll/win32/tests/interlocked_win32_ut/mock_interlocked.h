@@ -30,6 +30,10 @@ MOCKABLE_FUNCTION(, void*, mock_InterlockedExchangePointer, void* volatile*, tar
 MOCKABLE_FUNCTION(, LONG, mock_InterlockedIncrement, volatile LONG*, addend);
 MOCKABLE_FUNCTION(, SHORT, mock_InterlockedIncrement16, volatile SHORT*, addend);
 MOCKABLE_FUNCTION(, LONG64, mock_InterlockedIncrement64, volatile LONG64*, addend);
+MOCKABLE_FUNCTION(, LONG, mock_ReadAcquire, volatile LONG*, source);
+MOCKABLE_FUNCTION(, LONG64, mock_ReadAcquire64, volatile LONG64*, source);
+MOCKABLE_FUNCTION(, void, mock_WriteRelease, volatile LONG*, destination, LONG, value);
+MOCKABLE_FUNCTION(, void, mock_WriteRelease64, volatile LONG64*, destination, LONG64, value);
 MOCKABLE_FUNCTION(, LONG, mock_InterlockedOr, volatile LONG*, destination, LONG, value);
 MOCKABLE_FUNCTION(, SHORT, mock_InterlockedOr16, volatile SHORT*, destination, SHORT, value);
 MOCKABLE_FUNCTION(, LONG64, mock_InterlockedOr64, volatile LONG64*, destination, LONG64, value);
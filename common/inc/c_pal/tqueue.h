@@ -15,22 +15,57 @@
 #define TQUEUE(T) TQUEUE_LL(T)
 
 #define TQUEUE_CREATE_DECLARE(T) TQUEUE_LL_CREATE_DECLARE(T, T)
+#define TQUEUE_CREATE_WITH_SHRINK_DECLARE(T) TQUEUE_LL_CREATE_WITH_SHRINK_DECLARE(T, T)
 #define TQUEUE_PUSH_DECLARE(T) TQUEUE_LL_PUSH_DECLARE(T, T)
 #define TQUEUE_POP_DECLARE(T) TQUEUE_LL_POP_DECLARE(T, T)
+#define TQUEUE_PUSH_BATCH_DECLARE(T) TQUEUE_LL_PUSH_BATCH_DECLARE(T, T)
+#define TQUEUE_POP_BATCH_DECLARE(T) TQUEUE_LL_POP_BATCH_DECLARE(T, T)
+#define TQUEUE_PUSH_WAIT_DECLARE(T) TQUEUE_LL_PUSH_WAIT_DECLARE(T, T)
+#define TQUEUE_POP_WAIT_DECLARE(T) TQUEUE_LL_POP_WAIT_DECLARE(T, T)
+#define TQUEUE_PUSH_MOVE_DECLARE(T) TQUEUE_LL_PUSH_MOVE_DECLARE(T, T)
+#define TQUEUE_POP_MOVE_DECLARE(T) TQUEUE_LL_POP_MOVE_DECLARE(T, T)
 #define TQUEUE_GET_VOLATILE_COUNT_DECLARE(T) TQUEUE_LL_GET_VOLATILE_COUNT_DECLARE(T, T)
+#define TQUEUE_GET_CAPACITY_DECLARE(T) TQUEUE_LL_GET_CAPACITY_DECLARE(T, T)
+#define TQUEUE_GET_HIGH_WATER_MARK_DECLARE(T) TQUEUE_LL_GET_HIGH_WATER_MARK_DECLARE(T, T)
 
 #define TQUEUE_CREATE_DEFINE(T) TQUEUE_LL_CREATE_DEFINE(T, T)
+#define TQUEUE_CREATE_WITH_SHRINK_DEFINE(T) TQUEUE_LL_CREATE_WITH_SHRINK_DEFINE(T, T)
 #define TQUEUE_PUSH_DEFINE(T) TQUEUE_LL_PUSH_DEFINE(T, T)
 #define TQUEUE_POP_DEFINE(T) TQUEUE_LL_POP_DEFINE(T, T)
+#define TQUEUE_PUSH_BATCH_DEFINE(T) TQUEUE_LL_PUSH_BATCH_DEFINE(T, T)
+#define TQUEUE_POP_BATCH_DEFINE(T) TQUEUE_LL_POP_BATCH_DEFINE(T, T)
+#define TQUEUE_PUSH_WAIT_DEFINE(T) TQUEUE_LL_PUSH_WAIT_DEFINE(T, T)
+#define TQUEUE_POP_WAIT_DEFINE(T) TQUEUE_LL_POP_WAIT_DEFINE(T, T)
+#define TQUEUE_PUSH_MOVE_DEFINE(T) TQUEUE_LL_PUSH_MOVE_DEFINE(T, T)
+#define TQUEUE_POP_MOVE_DEFINE(T) TQUEUE_LL_POP_MOVE_DEFINE(T, T)
 #define TQUEUE_GET_VOLATILE_COUNT_DEFINE(T) TQUEUE_LL_GET_VOLATILE_COUNT_DEFINE(T, T)
+#define TQUEUE_GET_CAPACITY_DEFINE(T) TQUEUE_LL_GET_CAPACITY_DEFINE(T, T)
+#define TQUEUE_GET_HIGH_WATER_MARK_DEFINE(T) TQUEUE_LL_GET_HIGH_WATER_MARK_DEFINE(T, T)
+
+#define TQUEUE_PUSH_SINGLE_PRODUCER_DEFINE(T) TQUEUE_LL_PUSH_SINGLE_PRODUCER_DEFINE(T, T)
+#define TQUEUE_POP_SINGLE_CONSUMER_DEFINE(T) TQUEUE_LL_POP_SINGLE_CONSUMER_DEFINE(T, T)
+#define TQUEUE_PUSH_BATCH_SINGLE_PRODUCER_DEFINE(T) TQUEUE_LL_PUSH_BATCH_SINGLE_PRODUCER_DEFINE(T, T)
+#define TQUEUE_POP_BATCH_SINGLE_CONSUMER_DEFINE(T) TQUEUE_LL_POP_BATCH_SINGLE_CONSUMER_DEFINE(T, T)
 
 #define TQUEUE_FREE_DEFINE(T) TQUEUE_LL_FREE_DEFINE(T, T)
+#define TQUEUE_GROW_DEFINE(T) TQUEUE_LL_GROW_DEFINE(T, T)
+#define TQUEUE_SHRINK_DEFINE(T) TQUEUE_LL_SHRINK_DEFINE(T, T)
+#define TQUEUE_PROTECT_SEGMENTS_DEFINE(T) TQUEUE_LL_PROTECT_SEGMENTS_DEFINE(T, T)
 
 #define TQUEUE_CREATE(C) TQUEUE_LL_CREATE(C)
+#define TQUEUE_CREATE_WITH_SHRINK(C) TQUEUE_LL_CREATE_WITH_SHRINK(C)
 
 #define TQUEUE_PUSH(C) TQUEUE_LL_PUSH(C)
 #define TQUEUE_POP(C) TQUEUE_LL_POP(C)
+#define TQUEUE_PUSH_BATCH(C) TQUEUE_LL_PUSH_BATCH(C)
+#define TQUEUE_POP_BATCH(C) TQUEUE_LL_POP_BATCH(C)
+#define TQUEUE_PUSH_WAIT(C) TQUEUE_LL_PUSH_WAIT(C)
+#define TQUEUE_POP_WAIT(C) TQUEUE_LL_POP_WAIT(C)
+#define TQUEUE_PUSH_MOVE(C) TQUEUE_LL_PUSH_MOVE(C)
+#define TQUEUE_POP_MOVE(C) TQUEUE_LL_POP_MOVE(C)
 #define TQUEUE_GET_VOLATILE_COUNT(C) TQUEUE_LL_GET_VOLATILE_COUNT(C)
+#define TQUEUE_GET_CAPACITY(C) TQUEUE_LL_GET_CAPACITY(C)
+#define TQUEUE_GET_HIGH_WATER_MARK(C) TQUEUE_LL_GET_HIGH_WATER_MARK(C)
 
 #define TQUEUE_INITIALIZE(T) TQUEUE_LL_INITIALIZE(T)
 #define TQUEUE_ASSIGN(T) TQUEUE_LL_ASSIGN(T)
@@ -45,16 +80,78 @@
     /*hint: have TQUEUE_DEFINE_TYPE(T) before TQUEUE_TYPE_DECLARE                               */                  \
     /*hint: have THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(T)) before TQUEUE_TYPE_DECLARE               */           \
     TQUEUE_CREATE_DECLARE(T)                                                                                        \
+    TQUEUE_CREATE_WITH_SHRINK_DECLARE(T)                                                                            \
     TQUEUE_PUSH_DECLARE(T)                                                                                          \
     TQUEUE_POP_DECLARE(T)                                                                                           \
+    TQUEUE_PUSH_BATCH_DECLARE(T)                                                                                    \
+    TQUEUE_POP_BATCH_DECLARE(T)                                                                                     \
+    TQUEUE_PUSH_WAIT_DECLARE(T)                                                                                     \
+    TQUEUE_POP_WAIT_DECLARE(T)                                                                                      \
+    TQUEUE_PUSH_MOVE_DECLARE(T)                                                                                     \
+    TQUEUE_POP_MOVE_DECLARE(T)                                                                                      \
     TQUEUE_GET_VOLATILE_COUNT_DECLARE(T)                                                                            \
+    TQUEUE_GET_CAPACITY_DECLARE(T)                                                                                  \
+    TQUEUE_GET_HIGH_WATER_MARK_DECLARE(T)                                                                           \
 
 #define TQUEUE_TYPE_DEFINE(T, ...)                                                                                  \
     /*hint: have THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(T)) before  TQUEUE_TYPE_DEFINE                */           \
     TQUEUE_FREE_DEFINE(T)                                                                                           \
+    TQUEUE_GROW_DEFINE(T)                                                                                           \
+    TQUEUE_SHRINK_DEFINE(T)                                                                                         \
+    TQUEUE_PROTECT_SEGMENTS_DEFINE(T)                                                                               \
     TQUEUE_CREATE_DEFINE(T)                                                                                         \
+    TQUEUE_CREATE_WITH_SHRINK_DEFINE(T)                                                                             \
     TQUEUE_PUSH_DEFINE(T)                                                                                           \
     TQUEUE_POP_DEFINE(T)                                                                                            \
+    TQUEUE_PUSH_BATCH_DEFINE(T)                                                                                     \
+    TQUEUE_POP_BATCH_DEFINE(T)                                                                                      \
+    TQUEUE_PUSH_WAIT_DEFINE(T)                                                                                      \
+    TQUEUE_POP_WAIT_DEFINE(T)                                                                                       \
+    TQUEUE_PUSH_MOVE_DEFINE(T)                                                                                      \
+    TQUEUE_POP_MOVE_DEFINE(T)                                                                                       \
+    TQUEUE_GET_VOLATILE_COUNT_DEFINE(T)                                                                             \
+    TQUEUE_GET_CAPACITY_DEFINE(T)                                                                                   \
+    TQUEUE_GET_HIGH_WATER_MARK_DEFINE(T)                                                                            \
+
+/*to be used in .c instead of TQUEUE_TYPE_DEFINE when at most one thread pops at a time*/
+#define TQUEUE_MPSC_TYPE_DEFINE(T, ...)                                                                             \
+    /*hint: have THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(T)) before  TQUEUE_MPSC_TYPE_DEFINE           */           \
+    TQUEUE_FREE_DEFINE(T)                                                                                           \
+    TQUEUE_GROW_DEFINE(T)                                                                                           \
+    TQUEUE_SHRINK_DEFINE(T)                                                                                         \
+    TQUEUE_PROTECT_SEGMENTS_DEFINE(T)                                                                               \
+    TQUEUE_CREATE_DEFINE(T)                                                                                         \
+    TQUEUE_CREATE_WITH_SHRINK_DEFINE(T)                                                                             \
+    TQUEUE_PUSH_DEFINE(T)                                                                                           \
+    TQUEUE_POP_SINGLE_CONSUMER_DEFINE(T)                                                                            \
+    TQUEUE_PUSH_BATCH_DEFINE(T)                                                                                     \
+    TQUEUE_POP_BATCH_SINGLE_CONSUMER_DEFINE(T)                                                                      \
+    TQUEUE_PUSH_WAIT_DEFINE(T)                                                                                      \
+    TQUEUE_POP_WAIT_DEFINE(T)                                                                                       \
+    TQUEUE_PUSH_MOVE_DEFINE(T)                                                                                      \
+    TQUEUE_POP_MOVE_DEFINE(T)                                                                                       \
+    TQUEUE_GET_VOLATILE_COUNT_DEFINE(T)                                                                             \
+    TQUEUE_GET_CAPACITY_DEFINE(T)                                                                                   \
+    TQUEUE_GET_HIGH_WATER_MARK_DEFINE(T)                                                                            \
+
+/*to be used in .c instead of TQUEUE_TYPE_DEFINE when at most one thread pushes and at most one thread pops at a time*/
+#define TQUEUE_SPSC_TYPE_DEFINE(T, ...)                                                                             \
+    /*hint: have THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(T)) before  TQUEUE_SPSC_TYPE_DEFINE           */           \
+    TQUEUE_FREE_DEFINE(T)                                                                                           \
+    TQUEUE_GROW_DEFINE(T)                                                                                           \
+    TQUEUE_SHRINK_DEFINE(T)                                                                                         \
+    TQUEUE_CREATE_DEFINE(T)                                                                                         \
+    TQUEUE_CREATE_WITH_SHRINK_DEFINE(T)                                                                             \
+    TQUEUE_PUSH_SINGLE_PRODUCER_DEFINE(T)                                                                           \
+    TQUEUE_POP_SINGLE_CONSUMER_DEFINE(T)                                                                            \
+    TQUEUE_PUSH_BATCH_SINGLE_PRODUCER_DEFINE(T)                                                                     \
+    TQUEUE_POP_BATCH_SINGLE_CONSUMER_DEFINE(T)                                                                      \
+    TQUEUE_PUSH_WAIT_DEFINE(T)                                                                                      \
+    TQUEUE_POP_WAIT_DEFINE(T)                                                                                       \
+    TQUEUE_PUSH_MOVE_DEFINE(T)                                                                                      \
+    TQUEUE_POP_MOVE_DEFINE(T)                                                                                       \
     TQUEUE_GET_VOLATILE_COUNT_DEFINE(T)                                                                             \
+    TQUEUE_GET_CAPACITY_DEFINE(T)                                                                                   \
+    TQUEUE_GET_HIGH_WATER_MARK_DEFINE(T)                                                                            \
 
 #endif // TQUEUE_H
@@ -6,13 +6,16 @@
 
 #ifdef __cplusplus
 #include <cinttypes>
+#include <cstddef>
 #else // __cplusplus
 #include <stdbool.h>
 #include <inttypes.h>
+#include <stddef.h>
 #endif // __cplusplus
 
 #include "c_pal/interlocked.h"
-#include "c_pal/srw_lock_ll.h"
+#include "c_pal/sync.h"
+#include "c_pal/timer.h"
 
 #include "c_pal/thandle_ll.h"
 
@@ -30,7 +33,8 @@ MU_DEFINE_ENUM(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_RESULT_VALUES);
     TQUEUE_POP_OK, \
     TQUEUE_POP_INVALID_ARG, \
     TQUEUE_POP_QUEUE_EMPTY, \
-    TQUEUE_POP_REJECTED
+    TQUEUE_POP_REJECTED, \
+    TQUEUE_POP_ERROR
 
 MU_DEFINE_ENUM(TQUEUE_POP_RESULT, TQUEUE_POP_RESULT_VALUES);
 
@@ -42,6 +46,47 @@ MU_DEFINE_ENUM(TQUEUE_POP_RESULT, TQUEUE_POP_RESULT_VALUES);
 
 MU_DEFINE_ENUM(QUEUE_ENTRY_STATE, QUEUE_ENTRY_STATE_VALUES);
 
+/*the fields that are written by producers and consumers are placed on separate cache lines of this size*/
+#define TQUEUE_CACHE_LINE_SIZE 64
+
+/*rounds up a size to a multiple of the cache line size*/
+#define TQUEUE_CACHE_LINE_ALIGNED_SIZE(size) ((((size) + TQUEUE_CACHE_LINE_SIZE - 1) / TQUEUE_CACHE_LINE_SIZE) * TQUEUE_CACHE_LINE_SIZE)
+
+/*the queue size is always a power of 2 so that indexing into the array is a mask, this is the largest power of 2 that fits the queue size*/
+#define TQUEUE_MAX_QUEUE_SIZE ((uint32_t)1 << 31)
+
+/*the queue grows by adding segments, each segment being twice the size of the previous one. The segment count is enough to reach TQUEUE_MAX_QUEUE_SIZE from a first segment of size 1*/
+#define TQUEUE_MAX_SEGMENT_COUNT 32
+
+/*head and tail keep the index of their segment in the upper bits and the position in the queue in the lower bits. This limits the number of items that can ever be pushed in a queue to 2^57*/
+#define TQUEUE_SEGMENT_INDEX_SHIFT 57
+#define TQUEUE_POSITION_MASK ((((int64_t)1) << TQUEUE_SEGMENT_INDEX_SHIFT) - 1)
+#define TQUEUE_GET_SEGMENT_INDEX(head_or_tail) ((uint32_t)((head_or_tail) >> TQUEUE_SEGMENT_INDEX_SHIFT))
+#define TQUEUE_GET_POSITION(head_or_tail) ((head_or_tail) & TQUEUE_POSITION_MASK)
+#define TQUEUE_MAKE_HEAD_OR_TAIL(segment_index, position) ((((int64_t)(segment_index)) << TQUEUE_SEGMENT_INDEX_SHIFT) | (position))
+
+/*the segments are kept in 2 banks of TQUEUE_MAX_SEGMENT_COUNT segments that share the first segment. A shrink moves the head to the first segment of the other bank, so the segments of the previous bank can be freed once no push/pop uses them anymore*/
+/*the segment index kept in head and tail includes the bank*/
+#define TQUEUE_SEGMENT_BANK_FLAG TQUEUE_MAX_SEGMENT_COUNT
+#define TQUEUE_GET_SEGMENT_BANK(segment_index) ((segment_index) & TQUEUE_SEGMENT_BANK_FLAG)
+#define TQUEUE_GET_SEGMENT_INDEX_IN_BANK(segment_index) ((segment_index) & (TQUEUE_SEGMENT_BANK_FLAG - 1))
+#define TQUEUE_GET_OTHER_BANK_FIRST_SEGMENT_INDEX(segment_index) (TQUEUE_GET_SEGMENT_BANK(segment_index) ^ TQUEUE_SEGMENT_BANK_FLAG)
+
+/*segment i of a bank has queue_size << i entries*/
+#define TQUEUE_GET_SEGMENT_SIZE(queue_size, segment_index) (((int64_t)(queue_size)) << TQUEUE_GET_SEGMENT_INDEX_IN_BANK(segment_index))
+
+/*segment sizes are powers of 2, so the index of a position in a segment is a mask*/
+#define TQUEUE_GET_SEGMENT_ENTRY_INDEX(queue_size, segment_index, position) ((uint32_t)((position) & (TQUEUE_GET_SEGMENT_SIZE(queue_size, segment_index) - 1)))
+
+/*push/pop calls that use the segments while the head is not in the first segment protect them in one of 2 reclaim epochs, this is the value of an epoch parity when the segments are not protected*/
+#define TQUEUE_SEGMENTS_NOT_PROTECTED (-1)
+
+/*value of the retired segment count while a push/pop frees the retired segments*/
+#define TQUEUE_FREEING_RETIRED_SEGMENTS (-1)
+
+/*the occupancy of a queue is low when it holds at most 1/TQUEUE_LOW_OCCUPANCY_RATIO of the head segment size items*/
+#define TQUEUE_LOW_OCCUPANCY_RATIO 4
+
 /*TQUEUE is backed by a THANDLE build on the structure below*/
 #define TQUEUE_STRUCT_TYPE_NAME_TAG(T) MU_C2(TQUEUE_TYPEDEF_NAME(T), _TAG)
 #define TQUEUE_TYPEDEF_NAME(T) MU_C2(TQUEUE_STRUCT_, T)
@@ -49,6 +94,9 @@ MU_DEFINE_ENUM(QUEUE_ENTRY_STATE, QUEUE_ENTRY_STATE_VALUES);
 #define TQUEUE_ENTRY_STRUCT_TYPE_NAME_TAG(T) MU_C2(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T), _TAG)
 #define TQUEUE_ENTRY_STRUCT_TYPE_NAME(T) MU_C2(TQUEUE_ENTRY_STRUCT_, T)
 
+/*used only to compute the padding of the array entries of TQUEUE_DEFINE_PADDED_STRUCT_TYPE(T)*/
+#define TQUEUE_UNPADDED_ENTRY_STRUCT_TYPE_NAME(T) MU_C2(TQUEUE_UNPADDED_ENTRY_STRUCT_, T)
+
 /* This introduces the name for the copy item function */
 #define TQUEUE_DEFINE_COPY_ITEM_FUNCTION_TYPE_NAME(T) MU_C2(TQUEUE_COPY_ITEM_FUNC_TYPE_, T)
 #define TQUEUE_COPY_ITEM_FUNC(T) TQUEUE_DEFINE_COPY_ITEM_FUNCTION_TYPE_NAME(T)
@@ -61,11 +109,69 @@ MU_DEFINE_ENUM(QUEUE_ENTRY_STATE, QUEUE_ENTRY_STATE_VALUES);
 #define TQUEUE_DEFINE_CONDITION_FUNCTION_TYPE_NAME(T) MU_C2(TQUEUE_CONDITION_FUNC_TYPE_, T)
 #define TQUEUE_CONDITION_FUNC(T) TQUEUE_DEFINE_CONDITION_FUNCTION_TYPE_NAME(T)
 
-/*TQUEUE_DEFINE_STRUCT_TYPE(T) introduces the base type that holds the queue typed as T*/
-#define TQUEUE_DEFINE_STRUCT_TYPE(T)                                                                            \
+/*TQUEUE_DEFINE_CALLBACK_TYPES(T) introduces the types of the callbacks of a queue typed as T*/
+#define TQUEUE_DEFINE_CALLBACK_TYPES(T)                                                                         \
 typedef void (*TQUEUE_DEFINE_COPY_ITEM_FUNCTION_TYPE_NAME(T))(void* context, T* dst, T* src);                   \
 typedef void (*TQUEUE_DEFINE_DISPOSE_ITEM_FUNCTION_TYPE_NAME(T))(void* context, T* item);                       \
 typedef bool (*TQUEUE_DEFINE_CONDITION_FUNCTION_TYPE_NAME(T))(void* context, T* item);                          \
+
+/*TQUEUE_DEFINE_QUEUE_STRUCT_TYPE(T) introduces the structure that holds the queue typed as T, the entry type has to be defined before*/
+#define TQUEUE_DEFINE_QUEUE_STRUCT_TYPE(T)                                                                      \
+typedef struct TQUEUE_STRUCT_TYPE_NAME_TAG(T)                                                                   \
+{                                                                                                               \
+    /*head and tail are each on their own cache line so that producers and consumers do not false share*/       \
+    /*besides the position in the queue, head and tail encode the index of the segment where the position is*/  \
+    union                                                                                                       \
+    {                                                                                                           \
+        volatile_atomic int64_t head;                                                                           \
+        uint8_t head_cache_line[TQUEUE_CACHE_LINE_SIZE];                                                        \
+    };                                                                                                          \
+    union                                                                                                       \
+    {                                                                                                           \
+        volatile_atomic int64_t tail;                                                                           \
+        uint8_t tail_cache_line[TQUEUE_CACHE_LINE_SIZE];                                                        \
+    };                                                                                                          \
+    /*waiters of TQUEUE_POP_WAIT/TQUEUE_PUSH_WAIT register here, pushes and pops only wake when the counts are not 0*/ \
+    union                                                                                                       \
+    {                                                                                                           \
+        struct                                                                                                  \
+        {                                                                                                       \
+            volatile_atomic int32_t pop_waiter_count;                                                           \
+            volatile_atomic int32_t pop_wait_sequence;                                                          \
+            volatile_atomic int32_t push_waiter_count;                                                          \
+            volatile_atomic int32_t push_wait_sequence;                                                         \
+        };                                                                                                      \
+        uint8_t waiters_cache_line[TQUEUE_CACHE_LINE_SIZE];                                                     \
+    };                                                                                                          \
+    /*only used by queues created with TQUEUE_CREATE_WITH_SHRINK: the pops that found the queue almost empty in a row and the reclaim of the segments retired by a shrink*/ \
+    union                                                                                                       \
+    {                                                                                                           \
+        struct                                                                                                  \
+        {                                                                                                       \
+            volatile_atomic int32_t low_occupancy_pop_count;                                                    \
+            volatile_atomic int32_t reclaim_epoch;                                                              \
+            volatile_atomic int32_t epoch_operation_counts[2]; /*push/pop calls protecting the segments in each epoch parity*/ \
+            volatile_atomic int32_t retired_segment_count;                                                      \
+        };                                                                                                      \
+        uint8_t shrink_cache_line[TQUEUE_CACHE_LINE_SIZE];                                                      \
+    };                                                                                                          \
+    TQUEUE_COPY_ITEM_FUNC(T) copy_item_function;                                                                \
+    TQUEUE_DISPOSE_ITEM_FUNC(T) dispose_item_function;                                                          \
+    void* dispose_item_function_context;                                                                        \
+    uint32_t queue_size; /*size of the first segment, always a power of 2. Segment i of a bank has queue_size << i entries*/ \
+    uint32_t max_size;                                                                                          \
+    uint32_t shrink_after_pop_count; /*0 when the queue does not shrink*/                                       \
+    /*the largest number of items seen in the queue by a push, only written when it increases*/                 \
+    volatile_atomic int64_t high_water_mark;                                                                    \
+    /*segments are allocated as the queue grows and are only freed when the queue shrinks or is disposed, segments[TQUEUE_SEGMENT_BANK_FLAG] is segments[0]*/ \
+    TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* volatile_atomic segments[2 * TQUEUE_MAX_SEGMENT_COUNT];                   \
+    /*the segments retired by the last shrink, freed by a push/pop once no push/pop of the previous epoch uses them*/ \
+    TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* retired_segments[TQUEUE_MAX_SEGMENT_COUNT - 1];                           \
+} TQUEUE_TYPEDEF_NAME(T);                                                                                       \
+
+/*TQUEUE_DEFINE_STRUCT_TYPE(T) introduces the base type that holds the queue typed as T*/
+#define TQUEUE_DEFINE_STRUCT_TYPE(T)                                                                            \
+TQUEUE_DEFINE_CALLBACK_TYPES(T)                                                                                 \
 typedef struct TQUEUE_ENTRY_STRUCT_TYPE_NAME_TAG(T)                                                             \
 {                                                                                                               \
     union                                                                                                       \
@@ -75,18 +181,35 @@ typedef struct TQUEUE_ENTRY_STRUCT_TYPE_NAME_TAG(T)
     };                                                                                                          \
     T value;                                                                                                    \
 } TQUEUE_ENTRY_STRUCT_TYPE_NAME(T);                                                                             \
-typedef struct TQUEUE_STRUCT_TYPE_NAME_TAG(T)                                                                   \
+TQUEUE_DEFINE_QUEUE_STRUCT_TYPE(T)                                                                              \
+
+/*TQUEUE_DEFINE_PADDED_STRUCT_TYPE(T) introduces the same type as TQUEUE_DEFINE_STRUCT_TYPE(T), but each array entry is padded to a multiple of the cache line size*/
+/*this avoids contention between producers and consumers working on neighboring entries at the cost of memory*/
+#define TQUEUE_DEFINE_PADDED_STRUCT_TYPE(T)                                                                     \
+TQUEUE_DEFINE_CALLBACK_TYPES(T)                                                                                 \
+typedef struct MU_C2(TQUEUE_UNPADDED_ENTRY_STRUCT_TYPE_NAME(T), _TAG)                                           \
 {                                                                                                               \
-    volatile_atomic int64_t head;                                                                               \
-    volatile_atomic int64_t tail;                                                                               \
-    TQUEUE_COPY_ITEM_FUNC(T) copy_item_function;                                                                \
-    TQUEUE_DISPOSE_ITEM_FUNC(T) dispose_item_function;                                                          \
-    void* dispose_item_function_context;                                                                        \
-    uint32_t queue_size;                                                                                        \
-    uint32_t max_size;                                                                                          \
-    SRW_LOCK_LL resize_lock;                                                                                    \
-    TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* queue;                                                                    \
-} TQUEUE_TYPEDEF_NAME(T);                                                                                       \
+    union                                                                                                       \
+    {                                                                                                           \
+        volatile_atomic int32_t state;                                                                          \
+        volatile_atomic QUEUE_ENTRY_STATE state_as_enum;                                                        \
+    };                                                                                                          \
+    T value;                                                                                                    \
+} TQUEUE_UNPADDED_ENTRY_STRUCT_TYPE_NAME(T);                                                                    \
+typedef struct TQUEUE_ENTRY_STRUCT_TYPE_NAME_TAG(T)                                                             \
+{                                                                                                               \
+    union                                                                                                       \
+    {                                                                                                           \
+        volatile_atomic int32_t state;                                                                          \
+        volatile_atomic QUEUE_ENTRY_STATE state_as_enum;                                                        \
+    };                                                                                                          \
+    union                                                                                                       \
+    {                                                                                                           \
+        T value;                                                                                                \
+        uint8_t cache_line_padding[TQUEUE_CACHE_LINE_ALIGNED_SIZE(sizeof(TQUEUE_UNPADDED_ENTRY_STRUCT_TYPE_NAME(T))) - offsetof(TQUEUE_UNPADDED_ENTRY_STRUCT_TYPE_NAME(T), value)]; \
+    };                                                                                                          \
+} TQUEUE_ENTRY_STRUCT_TYPE_NAME(T);                                                                             \
+TQUEUE_DEFINE_QUEUE_STRUCT_TYPE(T)                                                                              \
 
 /*TQUEUE is-a THANDLE*/
 /*given a type "T" TQUEUE_LL(T) expands to the name of the type. */
@@ -103,6 +226,10 @@ typedef struct TQUEUE_STRUCT_TYPE_NAME_TAG(T)
 #define TQUEUE_LL_CREATE_NAME(C) MU_C2(TQUEUE_LL_CREATE_, C)
 #define TQUEUE_LL_CREATE(C) TQUEUE_LL_CREATE_NAME(C)
 
+/*introduces a new name for a function that returns a TQUEUE_LL(T) which shrinks after bursts*/
+#define TQUEUE_LL_CREATE_WITH_SHRINK_NAME(C) MU_C2(TQUEUE_LL_CREATE_WITH_SHRINK_, C)
+#define TQUEUE_LL_CREATE_WITH_SHRINK(C) TQUEUE_LL_CREATE_WITH_SHRINK_NAME(C)
+
 /*introduces a new name for the push function */
 #define TQUEUE_LL_PUSH_NAME(C) MU_C2(TQUEUE_LL_PUSH_, C)
 #define TQUEUE_LL_PUSH(C) TQUEUE_LL_PUSH_NAME(C)
@@ -111,27 +238,86 @@ typedef struct TQUEUE_STRUCT_TYPE_NAME_TAG(T)
 #define TQUEUE_LL_POP_NAME(C) MU_C2(TQUEUE_LL_POP_, C)
 #define TQUEUE_LL_POP(C) TQUEUE_LL_POP_NAME(C)
 
+/*introduces a new name for the push_batch function */
+#define TQUEUE_LL_PUSH_BATCH_NAME(C) MU_C2(TQUEUE_LL_PUSH_BATCH_, C)
+#define TQUEUE_LL_PUSH_BATCH(C) TQUEUE_LL_PUSH_BATCH_NAME(C)
+
+/*introduces a new name for the pop_batch function */
+#define TQUEUE_LL_POP_BATCH_NAME(C) MU_C2(TQUEUE_LL_POP_BATCH_, C)
+#define TQUEUE_LL_POP_BATCH(C) TQUEUE_LL_POP_BATCH_NAME(C)
+
+/*introduces a new name for the push_wait function */
+#define TQUEUE_LL_PUSH_WAIT_NAME(C) MU_C2(TQUEUE_LL_PUSH_WAIT_, C)
+#define TQUEUE_LL_PUSH_WAIT(C) TQUEUE_LL_PUSH_WAIT_NAME(C)
+
+/*introduces a new name for the pop_wait function */
+#define TQUEUE_LL_POP_WAIT_NAME(C) MU_C2(TQUEUE_LL_POP_WAIT_, C)
+#define TQUEUE_LL_POP_WAIT(C) TQUEUE_LL_POP_WAIT_NAME(C)
+
+/*introduces a new name for the push_move function */
+#define TQUEUE_LL_PUSH_MOVE_NAME(C) MU_C2(TQUEUE_LL_PUSH_MOVE_, C)
+#define TQUEUE_LL_PUSH_MOVE(C) TQUEUE_LL_PUSH_MOVE_NAME(C)
+
+/*introduces a new name for the pop_move function */
+#define TQUEUE_LL_POP_MOVE_NAME(C) MU_C2(TQUEUE_LL_POP_MOVE_, C)
+#define TQUEUE_LL_POP_MOVE(C) TQUEUE_LL_POP_MOVE_NAME(C)
+
 /*introduces a new name for the get_volatile_count function */
 #define TQUEUE_LL_GET_VOLATILE_COUNT_NAME(C) MU_C2(TQUEUE_LL_GET_VOLATILE_COUNT_, C)
 #define TQUEUE_LL_GET_VOLATILE_COUNT(C) TQUEUE_LL_GET_VOLATILE_COUNT_NAME(C)
 
+/*introduces a new name for the get_capacity function */
+#define TQUEUE_LL_GET_CAPACITY_NAME(C) MU_C2(TQUEUE_LL_GET_CAPACITY_, C)
+#define TQUEUE_LL_GET_CAPACITY(C) TQUEUE_LL_GET_CAPACITY_NAME(C)
+
+/*introduces a new name for the get_high_water_mark function */
+#define TQUEUE_LL_GET_HIGH_WATER_MARK_NAME(C) MU_C2(TQUEUE_LL_GET_HIGH_WATER_MARK_, C)
+#define TQUEUE_LL_GET_HIGH_WATER_MARK(C) TQUEUE_LL_GET_HIGH_WATER_MARK_NAME(C)
+
 /*introduces a function declaration for tqueue_create*/
 #define TQUEUE_LL_CREATE_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_LL(T), TQUEUE_LL_CREATE(C), uint32_t, initial_queue_size, uint32_t, max_queue_size, TQUEUE_COPY_ITEM_FUNC(T), copy_item_function, TQUEUE_DISPOSE_ITEM_FUNC(T), dispose_item_function, void*, dispose_item_function_context);
 
+/*introduces a function declaration for tqueue_create_with_shrink*/
+#define TQUEUE_LL_CREATE_WITH_SHRINK_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_LL(T), TQUEUE_LL_CREATE_WITH_SHRINK(C), uint32_t, initial_queue_size, uint32_t, max_queue_size, TQUEUE_COPY_ITEM_FUNC(T), copy_item_function, TQUEUE_DISPOSE_ITEM_FUNC(T), dispose_item_function, void*, dispose_item_function_context, uint32_t, shrink_after_pop_count);
+
 /*introduces a function declaration for tqueue_push*/
 #define TQUEUE_LL_PUSH_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_PUSH_RESULT, TQUEUE_LL_PUSH(C), TQUEUE_LL(T), tqueue, T*, item, void*, copy_item_function_context);
 
 /*introduces a function declaration for tqueue_pop*/
 #define TQUEUE_LL_POP_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_POP_RESULT, TQUEUE_LL_POP(C), TQUEUE_LL(T), tqueue, T*, item, void*, copy_item_function_context, TQUEUE_CONDITION_FUNC(T), condition_function, void*, condition_function_context);
 
+/*introduces a function declaration for tqueue_push_batch*/
+#define TQUEUE_LL_PUSH_BATCH_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_PUSH_RESULT, TQUEUE_LL_PUSH_BATCH(C), TQUEUE_LL(T), tqueue, T*, items, uint32_t, item_count, void*, copy_item_function_context, uint32_t*, pushed_item_count);
+
+/*introduces a function declaration for tqueue_pop_batch*/
+#define TQUEUE_LL_POP_BATCH_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_POP_RESULT, TQUEUE_LL_POP_BATCH(C), TQUEUE_LL(T), tqueue, T*, items, uint32_t, item_count, void*, copy_item_function_context, TQUEUE_CONDITION_FUNC(T), condition_function, void*, condition_function_context, uint32_t*, popped_item_count);
+
+/*introduces a function declaration for tqueue_push_wait*/
+#define TQUEUE_LL_PUSH_WAIT_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_PUSH_RESULT, TQUEUE_LL_PUSH_WAIT(C), TQUEUE_LL(T), tqueue, T*, item, void*, copy_item_function_context, uint32_t, timeout_ms);
+
+/*introduces a function declaration for tqueue_pop_wait*/
+#define TQUEUE_LL_POP_WAIT_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_POP_RESULT, TQUEUE_LL_POP_WAIT(C), TQUEUE_LL(T), tqueue, T*, item, void*, copy_item_function_context, TQUEUE_CONDITION_FUNC(T), condition_function, void*, condition_function_context, uint32_t, timeout_ms);
+
+/*introduces a function declaration for tqueue_push_move*/
+#define TQUEUE_LL_PUSH_MOVE_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_PUSH_RESULT, TQUEUE_LL_PUSH_MOVE(C), TQUEUE_LL(T), tqueue, T*, item);
+
+/*introduces a function declaration for tqueue_pop_move*/
+#define TQUEUE_LL_POP_MOVE_DECLARE(C, T) MOCKABLE_FUNCTION(, TQUEUE_POP_RESULT, TQUEUE_LL_POP_MOVE(C), TQUEUE_LL(T), tqueue, T*, item, TQUEUE_CONDITION_FUNC(T), condition_function, void*, condition_function_context);
+
 /*introduces a function declaration for tqueue_get_volatile_count*/
 #define TQUEUE_LL_GET_VOLATILE_COUNT_DECLARE(C, T) MOCKABLE_FUNCTION(, int64_t, TQUEUE_LL_GET_VOLATILE_COUNT(C), TQUEUE_LL(T), tqueue);
 
+/*introduces a function declaration for tqueue_get_capacity*/
+#define TQUEUE_LL_GET_CAPACITY_DECLARE(C, T) MOCKABLE_FUNCTION(, int64_t, TQUEUE_LL_GET_CAPACITY(C), TQUEUE_LL(T), tqueue);
+
+/*introduces a function declaration for tqueue_get_high_water_mark*/
+#define TQUEUE_LL_GET_HIGH_WATER_MARK_DECLARE(C, T) MOCKABLE_FUNCTION(, int64_t, TQUEUE_LL_GET_HIGH_WATER_MARK(C), TQUEUE_LL(T), tqueue);
+
 /*introduces a name for the function that free's a TQUEUE when it's ref count got to 0*/
 #define TQUEUE_LL_FREE_NAME(C) MU_C2(TQUEUE_LL_FREE_, C)
 
 /*introduces a function definition for freeing the allocated resources for a TQUEUE*/
-#define TQUEUE_LL_FREE_DEFINE(C, T) \
+#define TQUEUE_LL_FREE_DEFINE(C, T)                                                                                                                                 \
 static void TQUEUE_LL_FREE_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue)                                                                                                  \
 {                                                                                                                                                                   \
     if (tqueue == NULL)                                                                                                                                             \
@@ -151,22 +337,372 @@ static void TQUEUE_LL_FREE_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue)
             int64_t current_head = interlocked_add_64((volatile_atomic int64_t*)&tqueue->head, 0);                                                                  \
             /* Codes_SRS_TQUEUE_01_010: [ TQUEUE_DISPOSE_FUNC(T) shall obtain the current queue tail by calling interlocked_add_64. ]*/                             \
             int64_t current_tail = interlocked_add_64((volatile_atomic int64_t*)&tqueue->tail, 0);                                                                  \
-            for (int64_t pos = current_tail; pos < current_head; pos++)                                                                                             \
+            /*no other thread uses the queue anymore, so the entry states can be accessed directly*/                                                                \
+            uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_tail);                                                                                        \
+            if (TQUEUE_GET_SEGMENT_BANK(segment_index) != TQUEUE_GET_SEGMENT_BANK(TQUEUE_GET_SEGMENT_INDEX(current_head)))                                          \
+            {                                                                                                                                                       \
+                /*a shrink moved the head to the other bank and no pop moved the tail there yet, the items are all in the bank of the head*/                        \
+                segment_index = TQUEUE_GET_SEGMENT_BANK(TQUEUE_GET_SEGMENT_INDEX(current_head));                                                                    \
+            }                                                                                                                                                       \
+            for (int64_t pos = TQUEUE_GET_POSITION(current_tail); pos < TQUEUE_GET_POSITION(current_head); pos++)                                                   \
+            {                                                                                                                                                       \
+                uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue->queue_size, segment_index, pos);                                                            \
+                if (tqueue->segments[segment_index][index].state != QUEUE_ENTRY_STATE_USED)                                                                         \
+                {                                                                                                                                                   \
+                    /*the rest of the items are in the next segment*/                                                                                               \
+                    segment_index++;                                                                                                                                \
+                    index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue->queue_size, segment_index, pos);                                                                 \
+                }                                                                                                                                                   \
+                /* Codes_SRS_TQUEUE_01_011: [ For each item in the queue, dispose_item_function shall be called with dispose_item_function_context and a pointer to the array entry value (T*). ]*/ \
+                tqueue->dispose_item_function(tqueue->dispose_item_function_context, &tqueue->segments[segment_index][index].value);                                \
+                tqueue->segments[segment_index][index].state = QUEUE_ENTRY_STATE_NOT_USED;                                                                          \
+            }                                                                                                                                                       \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_01_057: [ All the segments backing the queue shall be freed. ] */                                                                       \
+        for (uint32_t i = 0; i < 2 * TQUEUE_MAX_SEGMENT_COUNT; i++)                                                                                                 \
+        {                                                                                                                                                           \
+            /*segments[TQUEUE_SEGMENT_BANK_FLAG] is the first segment, a segment of a bank can follow one that is not allocated when a push grew the bank while it was retired*/ \
+            if ((i != TQUEUE_SEGMENT_BANK_FLAG) && (tqueue->segments[i] != NULL))                                                                                   \
+            {                                                                                                                                                       \
+                free(tqueue->segments[i]);                                                                                                                          \
+            }                                                                                                                                                       \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_218: [ The segments retired by a shrink and not freed yet shall be freed. ]*/                                                        \
+        for (int32_t i = 0; i < tqueue->retired_segment_count; i++)                                                                                                 \
+        {                                                                                                                                                           \
+            free(tqueue->retired_segments[i]);                                                                                                                      \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+}                                                                                                                                                                   \
+
+/*introduces a name for the function that adds the segment following the head segment when the head segment is full*/
+#define TQUEUE_LL_GROW_NAME(C) MU_C2(TQUEUE_LL_GROW_, C)
+
+/*introduces names for the functions that push/pop an item after the arguments were validated, shared by tqueue_push/tqueue_pop and tqueue_push_move/tqueue_pop_move*/
+#define TQUEUE_LL_PUSH_ITEM_NAME(C) MU_C2(TQUEUE_LL_PUSH_ITEM_, C)
+#define TQUEUE_LL_POP_ITEM_NAME(C) MU_C2(TQUEUE_LL_POP_ITEM_, C)
+
+/*introduces a function definition for growing the queue, shared by the push functions*/
+#define TQUEUE_LL_GROW_DEFINE(C, T)                                                                                                                                 \
+static int TQUEUE_LL_GROW_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, int64_t current_head)                                                                         \
+{                                                                                                                                                                   \
+    int result;                                                                                                                                                     \
+    uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_head);                                                                                                \
+    /* the queue holds less than max queue size items here, so the next segment size cannot exceed TQUEUE_MAX_QUEUE_SIZE */                                         \
+    uint32_t new_segment_size = (uint32_t)TQUEUE_GET_SEGMENT_SIZE(tqueue_ptr->queue_size, segment_index + 1);                                                       \
+    TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* next_segment = interlocked_compare_exchange_pointer((void* volatile_atomic*)&tqueue_ptr->segments[segment_index + 1], NULL, NULL); \
+    if (next_segment == NULL)                                                                                                                                       \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_007: [ If the segment following the head segment is not allocated, TQUEUE_PUSH(T) shall allocate an array of twice the size of the head segment. ]*/ \
+        TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* new_segment = malloc_2(new_segment_size, sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)));                                       \
+        if (new_segment == NULL)                                                                                                                                    \
+        {                                                                                                                                                           \
+            LogError("malloc_2(new_segment_size=%" PRIu32 ", sizeof(" MU_TOSTRING(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)) ")=%zu) failed",                                \
+                new_segment_size, sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)));                                                                                        \
+            result = MU_FAILURE;                                                                                                                                    \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            for (uint32_t i = 0; i < new_segment_size; i++)                                                                                                         \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_009: [ TQUEUE_PUSH(T) shall initialize the state for each entry in the new segment with NOT_USED by using interlocked_exchange. ]*/ \
+                (void)interlocked_exchange(&new_segment[i].state, QUEUE_ENTRY_STATE_NOT_USED);                                                                      \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_010: [ TQUEUE_PUSH(T) shall set the new segment as the segment following the head segment by using interlocked_compare_exchange_pointer. ]*/ \
+            if (interlocked_compare_exchange_pointer((void* volatile_atomic*)&tqueue_ptr->segments[segment_index + 1], new_segment, NULL) != NULL)                  \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_011: [ If another thread already set the segment following the head segment, TQUEUE_PUSH(T) shall free the new segment. ]*/  \
+                free(new_segment);                                                                                                                                  \
+            }                                                                                                                                                       \
+            result = 0;                                                                                                                                             \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        result = 0;                                                                                                                                                 \
+    }                                                                                                                                                               \
+                                                                                                                                                                    \
+    if (result == 0)                                                                                                                                                \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_012: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH(T) shall move the head to the segment following the head segment, without changing the head position, and retry the push. ]*/ \
+        (void)interlocked_compare_exchange_64(&tqueue_ptr->head, TQUEUE_MAKE_HEAD_OR_TAIL(segment_index + 1, TQUEUE_GET_POSITION(current_head)), current_head);     \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces names for the functions that protect the segments from being freed while a push/pop uses them, that shrink the queue and that free the segments retired by a shrink, for a queue created with TQUEUE_CREATE_WITH_SHRINK*/
+#define TQUEUE_LL_PROTECT_SEGMENTS_NAME(C) MU_C2(TQUEUE_LL_PROTECT_SEGMENTS_, C)
+#define TQUEUE_LL_UNPROTECT_SEGMENTS_NAME(C) MU_C2(TQUEUE_LL_UNPROTECT_SEGMENTS_, C)
+#define TQUEUE_LL_FREE_RETIRED_SEGMENTS_NAME(C) MU_C2(TQUEUE_LL_FREE_RETIRED_SEGMENTS_, C)
+#define TQUEUE_LL_SHRINK_NAME(C) MU_C2(TQUEUE_LL_SHRINK_, C)
+#define TQUEUE_LL_FOLLOW_HEAD_BANK_NAME(C) MU_C2(TQUEUE_LL_FOLLOW_HEAD_BANK_, C)
+#define TQUEUE_LL_COUNT_LOW_OCCUPANCY_POP_NAME(C) MU_C2(TQUEUE_LL_COUNT_LOW_OCCUPANCY_POP_, C)
+
+/*introduces a name for the function that updates the high water mark after a push*/
+#define TQUEUE_LL_UPDATE_HIGH_WATER_MARK_NAME(C) MU_C2(TQUEUE_LL_UPDATE_HIGH_WATER_MARK_, C)
+
+/*introduces the function definitions that keep track of the occupancy of the queue, shrink it and free the segments it no longer uses, shared by the push and pop functions*/
+/*a shrink never waits: it moves the head to the first segment of the other bank and retires the segments of the previous bank, which are freed once the push/pop calls that could still use them are done*/
+#define TQUEUE_LL_SHRINK_DEFINE(C, T)                                                                                                                               \
+static void TQUEUE_LL_UPDATE_HIGH_WATER_MARK_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, int64_t item_count)                                                        \
+{                                                                                                                                                                   \
+    /* the high water mark is only written when it increases, so most pushes only read it */                                                                        \
+    int64_t high_water_mark = tqueue_ptr->high_water_mark;                                                                                                          \
+    while (item_count > high_water_mark)                                                                                                                            \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_179: [ While the number of items in the queue is greater than the high water mark, the push functions shall replace the high water mark with it by using interlocked_compare_exchange_64. ]*/ \
+        int64_t previous_high_water_mark = interlocked_compare_exchange_64(&tqueue_ptr->high_water_mark, item_count, high_water_mark);                              \
+        if (previous_high_water_mark == high_water_mark)                                                                                                            \
+        {                                                                                                                                                           \
+            break;                                                                                                                                                  \
+        }                                                                                                                                                           \
+        high_water_mark = previous_high_water_mark;                                                                                                                 \
+    }                                                                                                                                                               \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+/*returns true when there are no retired segments left to free*/                                                                                                    \
+static bool TQUEUE_LL_FREE_RETIRED_SEGMENTS_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr)                                                                             \
+{                                                                                                                                                                   \
+    bool result;                                                                                                                                                    \
+    /* Codes_SRS_TQUEUE_12_251: [ The push and pop functions shall obtain the retired segment count by calling interlocked_load_acquire. ]*/                        \
+    int32_t retired_segment_count = interlocked_load_acquire(&tqueue_ptr->retired_segment_count);                                                                   \
+    if (retired_segment_count == 0)                                                                                                                                 \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_252: [ If there are no retired segments, the push and pop functions shall not free any segment. ]*/                                  \
+        result = true;                                                                                                                                              \
+    }                                                                                                                                                               \
+    else if (retired_segment_count == TQUEUE_FREEING_RETIRED_SEGMENTS)                                                                                              \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_253: [ If another thread is freeing the retired segments, the push and pop functions shall not free any segment. ]*/                 \
+        result = false;                                                                                                                                             \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_254: [ Otherwise, the push and pop functions shall obtain the reclaim epoch by calling interlocked_add. ]*/                          \
+        int32_t reclaim_epoch = interlocked_add(&tqueue_ptr->reclaim_epoch, 0);                                                                                     \
+        /* Codes_SRS_TQUEUE_12_255: [ The push and pop functions shall obtain the operation count of the parity of the previous epoch by calling interlocked_add. ]*/ \
+        if (interlocked_add(&tqueue_ptr->epoch_operation_counts[(reclaim_epoch - 1) & 1], 0) != 0)                                                                  \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_256: [ If the operation count of the parity of the previous epoch is not 0, the push and pop functions shall not free any segment. ]*/ \
+            /* a push/pop that protected the segments before they were retired can still use them */                                                                \
+            result = false;                                                                                                                                         \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_257: [ Otherwise, the push and pop functions shall claim the retired segments by setting the retired segment count to TQUEUE_FREEING_RETIRED_SEGMENTS with interlocked_compare_exchange. ]*/ \
+        else if (interlocked_compare_exchange(&tqueue_ptr->retired_segment_count, TQUEUE_FREEING_RETIRED_SEGMENTS, retired_segment_count) != retired_segment_count) \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_258: [ If the retired segment count changed, the push and pop functions shall not free any segment. ]*/                          \
+            result = false;                                                                                                                                         \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_259: [ The push and pop functions shall obtain the reclaim epoch again by calling interlocked_add. ]*/                               \
+        else if (interlocked_add(&tqueue_ptr->reclaim_epoch, 0) != reclaim_epoch)                                                                                   \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_260: [ If the reclaim epoch changed, the push and pop functions shall set the retired segment count back by calling interlocked_exchange and shall not free any segment. ]*/ \
+            /* the segments were freed and others were retired since the epoch was read, the operation count of their epoch was not checked */                      \
+            (void)interlocked_exchange(&tqueue_ptr->retired_segment_count, retired_segment_count);                                                                  \
+            result = false;                                                                                                                                         \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            for (int32_t i = 0; i < retired_segment_count; i++)                                                                                                     \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_261: [ The push and pop functions shall free the retired segments. ]*/                                                       \
+                free(tqueue_ptr->retired_segments[i]);                                                                                                              \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_262: [ The push and pop functions shall set the retired segment count to 0 by calling interlocked_exchange. ]*/                  \
+            (void)interlocked_exchange(&tqueue_ptr->retired_segment_count, 0);                                                                                      \
+            result = true;                                                                                                                                          \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+/*returns true when the push has to be retried because the head was moved to the other bank*/                                                                       \
+static bool TQUEUE_LL_SHRINK_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, int64_t current_head, int64_t current_tail, bool is_single_producer)                       \
+{                                                                                                                                                                   \
+    bool result;                                                                                                                                                    \
+    uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_head);                                                                                                \
+    if (                                                                                                                                                            \
+        (tqueue_ptr->shrink_after_pop_count == 0) ||                                                                                                                \
+        (TQUEUE_GET_SEGMENT_INDEX_IN_BANK(segment_index) == 0) ||                                                                                                   \
+        (TQUEUE_GET_POSITION(current_head) != TQUEUE_GET_POSITION(current_tail)) ||                                                                                 \
+        (TQUEUE_GET_SEGMENT_BANK(TQUEUE_GET_SEGMENT_INDEX(current_tail)) != TQUEUE_GET_SEGMENT_BANK(segment_index))                                                 \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_228: [ If the queue was not created by TQUEUE_CREATE_WITH_SHRINK(T), if the head is in the first segment of its bank or if the queue is not empty, the push functions shall not shrink the queue. ]*/ \
+        result = false;                                                                                                                                             \
+    }                                                                                                                                                               \
+    /* Codes_SRS_TQUEUE_12_229: [ Otherwise, the push functions shall obtain the low occupancy pop count by calling interlocked_load_acquire. ]*/                   \
+    else if ((uint32_t)interlocked_load_acquire(&tqueue_ptr->low_occupancy_pop_count) < tqueue_ptr->shrink_after_pop_count)                                         \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_230: [ If the low occupancy pop count is less than shrink_after_pop_count, the push functions shall not shrink the queue. ]*/        \
+        result = false;                                                                                                                                             \
+    }                                                                                                                                                               \
+    /* Codes_SRS_TQUEUE_12_231: [ The push functions shall free the segments retired by the previous shrink. ]*/                                                    \
+    else if (!TQUEUE_LL_FREE_RETIRED_SEGMENTS_NAME(C)(tqueue_ptr))                                                                                                  \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_232: [ If the segments retired by the previous shrink cannot be freed yet, the push functions shall not shrink the queue. ]*/        \
+        result = false;                                                                                                                                             \
+    }                                                                                                                                                               \
+    /* Codes_SRS_TQUEUE_12_233: [ The push functions shall claim the retired segments by setting the retired segment count from 0 to TQUEUE_FREEING_RETIRED_SEGMENTS with interlocked_compare_exchange. ]*/ \
+    else if (interlocked_compare_exchange(&tqueue_ptr->retired_segment_count, TQUEUE_FREEING_RETIRED_SEGMENTS, 0) != 0)                                             \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_234: [ If the retired segment count was not 0, the push functions shall not shrink the queue. ]*/                                    \
+        /* another push is shrinking the queue */                                                                                                                   \
+        result = false;                                                                                                                                             \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* the queue is empty, so all the entries are NOT_USED and the first segment can be used again as is */                                                     \
+        int64_t new_head = TQUEUE_MAKE_HEAD_OR_TAIL(TQUEUE_GET_OTHER_BANK_FIRST_SEGMENT_INDEX(segment_index), TQUEUE_GET_POSITION(current_head));                   \
+        bool is_head_moved;                                                                                                                                         \
+        if (is_single_producer)                                                                                                                                     \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_235: [ The single producer push functions shall move the head to the first segment of the other bank, without changing the head position, by calling interlocked_store_release_64. ]*/ \
+            interlocked_store_release_64(&tqueue_ptr->head, new_head);                                                                                              \
+            is_head_moved = true;                                                                                                                                   \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_236: [ The other push functions shall move the head to the first segment of the other bank, without changing the head position, by using interlocked_compare_exchange_64. ]*/ \
+            is_head_moved = (interlocked_compare_exchange_64(&tqueue_ptr->head, new_head, current_head) == current_head);                                           \
+        }                                                                                                                                                           \
+        if (!is_head_moved)                                                                                                                                         \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_237: [ If the head was not moved, the push functions shall set the retired segment count back to 0 by calling interlocked_exchange. ]*/ \
+            (void)interlocked_exchange(&tqueue_ptr->retired_segment_count, 0);                                                                                      \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            int32_t retired_segment_count = 0;                                                                                                                      \
+            for (uint32_t i = 1; i < TQUEUE_MAX_SEGMENT_COUNT; i++)                                                                                                 \
             {                                                                                                                                                       \
-                uint32_t index = (uint32_t)(pos % tqueue->queue_size);                                                                                              \
-                /* Codes_SRS_TQUEUE_01_011: [ For each item in the queue, dispose_item_function shall be called with dispose_function_context and a pointer to the array entry value (T*). ]*/ \
-                tqueue->dispose_item_function(tqueue->dispose_item_function_context, &tqueue->queue[index].value);                                                  \
+                /* Codes_SRS_TQUEUE_12_238: [ If the head was moved, the push functions shall retire the segments following the first segment of the previous bank, stopping at the first segment that is not allocated, by setting them as not allocated with interlocked_exchange_pointer. ]*/ \
+                TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = interlocked_exchange_pointer((void* volatile_atomic*)&tqueue_ptr->segments[TQUEUE_GET_SEGMENT_BANK(segment_index) + i], NULL); \
+                if (segment == NULL)                                                                                                                                \
+                {                                                                                                                                                   \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+                tqueue_ptr->retired_segments[retired_segment_count] = segment;                                                                                      \
+                retired_segment_count++;                                                                                                                            \
             }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_239: [ The push functions shall start a new reclaim epoch by calling interlocked_increment. ]*/                                  \
+            /* the push/pop calls that protect the segments from now on cannot obtain the retired segments anymore */                                               \
+            (void)interlocked_increment(&tqueue_ptr->reclaim_epoch);                                                                                                \
+            /* Codes_SRS_TQUEUE_12_240: [ The push functions shall set the retired segment count to the number of retired segments by calling interlocked_exchange. ]*/ \
+            (void)interlocked_exchange(&tqueue_ptr->retired_segment_count, retired_segment_count);                                                                  \
+            /* Codes_SRS_TQUEUE_12_241: [ The push functions shall set the low occupancy pop count to 0 by calling interlocked_exchange. ]*/                        \
+            (void)interlocked_exchange(&tqueue_ptr->low_occupancy_pop_count, 0);                                                                                    \
+            /* Codes_SRS_TQUEUE_12_242: [ The push functions shall free the retired segments, which succeeds right away when no other push/pop protects the segments. ]*/ \
+            (void)TQUEUE_LL_FREE_RETIRED_SEGMENTS_NAME(C)(tqueue_ptr);                                                                                              \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_243: [ The push functions shall retry the push. ]*/                                                                                  \
+        result = true;                                                                                                                                              \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+/*returns true when the pop has to be retried because the tail was moved to the bank of the head*/                                                                  \
+static bool TQUEUE_LL_FOLLOW_HEAD_BANK_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, int64_t current_head, int64_t current_tail, bool is_single_consumer)             \
+{                                                                                                                                                                   \
+    bool result;                                                                                                                                                    \
+    uint32_t head_bank = TQUEUE_GET_SEGMENT_BANK(TQUEUE_GET_SEGMENT_INDEX(current_head));                                                                           \
+    if (TQUEUE_GET_SEGMENT_BANK(TQUEUE_GET_SEGMENT_INDEX(current_tail)) == head_bank)                                                                               \
+    {                                                                                                                                                               \
+        result = false;                                                                                                                                             \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* the queue was empty when a shrink moved the head, so the items pushed since then start in the first segment of the bank of the head */                   \
+        int64_t new_tail = TQUEUE_MAKE_HEAD_OR_TAIL(head_bank, TQUEUE_GET_POSITION(current_tail));                                                                  \
+        if (is_single_consumer)                                                                                                                                     \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_244: [ If the queue is not empty and the tail is not in the bank of the head, the single consumer pop functions shall move the tail to the first segment of the bank of the head, without changing the tail position, by calling interlocked_store_release_64 and try again. ]*/ \
+            interlocked_store_release_64(&tqueue_ptr->tail, new_tail);                                                                                              \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_245: [ If the queue is not empty and the tail is not in the bank of the head, the other pop functions shall move the tail to the first segment of the bank of the head, without changing the tail position, by using interlocked_compare_exchange_64 and try again. ]*/ \
+            (void)interlocked_compare_exchange_64(&tqueue_ptr->tail, new_tail, current_tail);                                                                       \
+        }                                                                                                                                                           \
+        result = true;                                                                                                                                              \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+static void TQUEUE_LL_COUNT_LOW_OCCUPANCY_POP_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr)                                                                           \
+{                                                                                                                                                                   \
+    if (tqueue_ptr->shrink_after_pop_count == 0)                                                                                                                    \
+    {                                                                                                                                                               \
+        /* the queue was created by TQUEUE_CREATE(T), it does not shrink */                                                                                         \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_246: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T), after popping the pop functions shall free the segments retired by a shrink. ]*/ \
+        (void)TQUEUE_LL_FREE_RETIRED_SEGMENTS_NAME(C)(tqueue_ptr);                                                                                                  \
+        /* Codes_SRS_TQUEUE_12_247: [ The pop functions shall obtain the current head and the current tail by calling interlocked_load_acquire_64. ]*/              \
+        int64_t current_head = interlocked_load_acquire_64(&tqueue_ptr->head);                                                                                      \
+        int64_t current_tail = interlocked_load_acquire_64(&tqueue_ptr->tail);                                                                                      \
+        uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_head);                                                                                            \
+        int64_t queue_item_count = TQUEUE_GET_POSITION(current_head) - TQUEUE_GET_POSITION(current_tail);                                                           \
+        if (TQUEUE_GET_SEGMENT_INDEX_IN_BANK(segment_index) == 0)                                                                                                   \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_248: [ If the head is in the first segment of its bank, the pop functions shall not count the pop. ]*/                           \
+        }                                                                                                                                                           \
+        else if (queue_item_count > (TQUEUE_GET_SEGMENT_SIZE(tqueue_ptr->queue_size, segment_index) / TQUEUE_LOW_OCCUPANCY_RATIO))                                  \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_185: [ If the queue holds more than a quarter of the head segment size items, the pop functions shall set the low occupancy pop count to 0 by calling interlocked_exchange. ]*/ \
+            (void)interlocked_exchange(&tqueue_ptr->low_occupancy_pop_count, 0);                                                                                    \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_249: [ Otherwise, the pop functions shall obtain the low occupancy pop count by calling interlocked_load_acquire. ]*/                \
+        else if ((uint32_t)interlocked_load_acquire(&tqueue_ptr->low_occupancy_pop_count) >= tqueue_ptr->shrink_after_pop_count)                                    \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_250: [ If the low occupancy pop count is already shrink_after_pop_count, the pop functions shall not change it. ]*/              \
+            /* the next push that finds the queue empty shrinks it */                                                                                               \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_186: [ Otherwise, the pop functions shall increment the low occupancy pop count by calling interlocked_increment. ]*/            \
+            (void)interlocked_increment(&tqueue_ptr->low_occupancy_pop_count);                                                                                      \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+}                                                                                                                                                                   \
+
+/*introduces the function definitions that protect the segments from being freed while they are used, shared by the push and pop functions that do not have a single producer or a single consumer*/
+#define TQUEUE_LL_PROTECT_SEGMENTS_DEFINE(C, T)                                                                                                                     \
+/*returns the parity of the reclaim epoch in which the segments are protected*/                                                                                     \
+static int32_t TQUEUE_LL_PROTECT_SEGMENTS_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr)                                                                               \
+{                                                                                                                                                                   \
+    int32_t epoch_parity;                                                                                                                                           \
+    do                                                                                                                                                              \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_223: [ The push and pop functions shall obtain the reclaim epoch by calling interlocked_load_acquire. ]*/                            \
+        int32_t reclaim_epoch = interlocked_load_acquire(&tqueue_ptr->reclaim_epoch);                                                                               \
+        epoch_parity = reclaim_epoch & 1;                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_224: [ The push and pop functions shall increment the operation count of the epoch parity by calling interlocked_increment. ]*/      \
+        (void)interlocked_increment(&tqueue_ptr->epoch_operation_counts[epoch_parity]);                                                                             \
+        /* Codes_SRS_TQUEUE_12_225: [ If the reclaim epoch obtained again by calling interlocked_add did not change, the segments are protected. ]*/                \
+        if (interlocked_add(&tqueue_ptr->reclaim_epoch, 0) == reclaim_epoch)                                                                                        \
+        {                                                                                                                                                           \
+            break;                                                                                                                                                  \
         }                                                                                                                                                           \
-        /* Codes_SRS_TQUEUE_01_056: [ The lock initialized in TQUEUE_CREATE(T) shall be de-initialized. ] */                                                        \
-        srw_lock_ll_deinit(&tqueue->resize_lock);                                                                                                                   \
-        /* Codes_SRS_TQUEUE_01_057: [ The array backing the queue shall be freed. ] */                                                                              \
-        free(tqueue->queue);                                                                                                                                        \
+        /* Codes_SRS_TQUEUE_12_226: [ Otherwise, the push and pop functions shall decrement the operation count of the epoch parity by calling interlocked_decrement and try again. ]*/ \
+        /* a shrink started a new epoch in between and may not have seen the increment, so the segments it retired must not be counted as protected */              \
+        (void)interlocked_decrement(&tqueue_ptr->epoch_operation_counts[epoch_parity]);                                                                             \
+    } while (1);                                                                                                                                                    \
+    return epoch_parity;                                                                                                                                            \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+static void TQUEUE_LL_UNPROTECT_SEGMENTS_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, int32_t epoch_parity)                                                          \
+{                                                                                                                                                                   \
+    if (epoch_parity != TQUEUE_SEGMENTS_NOT_PROTECTED)                                                                                                              \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_227: [ When they are done using the segments, the push and pop functions that protected the segments shall decrement the operation count of the epoch parity by calling interlocked_decrement. ]*/ \
+        (void)interlocked_decrement(&tqueue_ptr->epoch_operation_counts[epoch_parity]);                                                                             \
     }                                                                                                                                                               \
 }                                                                                                                                                                   \
 
 /*introduces a function definition for tqueue_create*/
-#define TQUEUE_LL_CREATE_DEFINE(C, T)                                                                                                                      \
+#define TQUEUE_LL_CREATE_DEFINE(C, T)                                                                                                                               \
 TQUEUE_LL(T) TQUEUE_LL_CREATE(C)(uint32_t initial_queue_size, uint32_t max_queue_size, TQUEUE_COPY_ITEM_FUNC(T) copy_item_function, TQUEUE_DISPOSE_ITEM_FUNC(T) dispose_item_function, void* dispose_item_function_context) \
 {                                                                                                                                                                   \
     TQUEUE_TYPEDEF_NAME(T)* result;                                                                                                                                 \
@@ -175,6 +711,8 @@ TQUEUE_LL(T) TQUEUE_LL_CREATE(C)(uint32_t initial_queue_size, uint32_t max_queue
     if (                                                                                                                                                            \
         /* Codes_SRS_TQUEUE_01_046: [ If initial_queue_size is 0, TQUEUE_CREATE(T) shall fail and return NULL. ]*/                                                  \
         (initial_queue_size == 0) ||                                                                                                                                \
+        /* Codes_SRS_TQUEUE_12_001: [ If initial_queue_size is greater than TQUEUE_MAX_QUEUE_SIZE, TQUEUE_CREATE(T) shall fail and return NULL. ]*/                 \
+        (initial_queue_size > TQUEUE_MAX_QUEUE_SIZE) ||                                                                                                             \
         /* Codes_SRS_TQUEUE_01_047: [ If initial_queue_size is greater than max_queue_size, TQUEUE_CREATE(T) shall fail and return NULL. ]*/                        \
         (initial_queue_size > max_queue_size) ||                                                                                                                    \
         /* Codes_SRS_TQUEUE_01_048: [ If any of copy_item_function and dispose_item_function are NULL and at least one of them is not NULL, TQUEUE_CREATE(T) shall fail and return NULL. ]*/ \
@@ -198,31 +736,56 @@ TQUEUE_LL(T) TQUEUE_LL_CREATE(C)(uint32_t initial_queue_size, uint32_t max_queue
         }                                                                                                                                                           \
         else                                                                                                                                                        \
         {                                                                                                                                                           \
-            /* Codes_SRS_TQUEUE_01_050: [ TQUEUE_CREATE(T) shall allocate memory for an array of size size containing elements of type T. ] */                      \
-            result->queue = malloc_2(initial_queue_size, sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)));                                                                 \
-            if (result->queue == NULL)                                                                                                                              \
+            /* Codes_SRS_TQUEUE_12_002: [ TQUEUE_CREATE(T) shall use as queue size the smallest power of 2 that is greater or equal to initial_queue_size. ]*/      \
+            uint32_t queue_size = 1;                                                                                                                                \
+            while (queue_size < initial_queue_size)                                                                                                                 \
+            {                                                                                                                                                       \
+                queue_size *= 2;                                                                                                                                    \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_01_050: [ TQUEUE_CREATE(T) shall allocate memory for the first segment of the queue, an array of queue size entries containing elements of type T. ] */ \
+            result->segments[0] = malloc_2(queue_size, sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)));                                                                   \
+            if (result->segments[0] == NULL)                                                                                                                        \
             {                                                                                                                                                       \
                 /* Codes_SRS_TQUEUE_01_071: [ If there are any failures then TQUEUE_CREATE(T) shall fail and return NULL. ]*/                                       \
                 LogError("failure in malloc_2(%" PRIu32 ", sizeof(" MU_TOSTRING(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)) ")=%zu)",                                         \
-                    initial_queue_size, sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)));                                                                                  \
+                    queue_size, sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)));                                                                                          \
             }                                                                                                                                                       \
             else                                                                                                                                                    \
             {                                                                                                                                                       \
-                result->queue_size = initial_queue_size;                                                                                                            \
-                result->max_size = max_queue_size;                                                                                                                  \
+                /* Codes_SRS_TQUEUE_12_216: [ TQUEUE_CREATE(T) shall use the first segment as the first segment of both banks and mark all the other segments as not allocated. ]*/ \
+                for (uint32_t i = 1; i < 2 * TQUEUE_MAX_SEGMENT_COUNT; i++)                                                                                         \
+                {                                                                                                                                                   \
+                    result->segments[i] = NULL;                                                                                                                     \
+                }                                                                                                                                                   \
+                result->segments[TQUEUE_SEGMENT_BANK_FLAG] = result->segments[0];                                                                                   \
+                result->queue_size = queue_size;                                                                                                                    \
+                /* Codes_SRS_TQUEUE_12_003: [ If max_queue_size is greater than TQUEUE_MAX_QUEUE_SIZE, TQUEUE_CREATE(T) shall use TQUEUE_MAX_QUEUE_SIZE as the max queue size. ]*/ \
+                result->max_size = (max_queue_size > TQUEUE_MAX_QUEUE_SIZE) ? TQUEUE_MAX_QUEUE_SIZE : max_queue_size;                                               \
+                result->shrink_after_pop_count = 0;                                                                                                                 \
                 result->copy_item_function = copy_item_function;                                                                                                    \
                 result->dispose_item_function = dispose_item_function;                                                                                              \
                 result->dispose_item_function_context = dispose_item_function_context;                                                                              \
                 /* Codes_SRS_TQUEUE_01_051: [ TQUEUE_CREATE(T) shall initialize the head and tail of the list with 0 by using interlocked_exchange_64. ] */         \
                 (void)interlocked_exchange_64(&result->head, 0);                                                                                                    \
                 (void)interlocked_exchange_64(&result->tail, 0);                                                                                                    \
-                for (uint32_t i = 0; i < initial_queue_size; i++)                                                                                                   \
+                /* Codes_SRS_TQUEUE_12_054: [ TQUEUE_CREATE(T) shall initialize the pop waiter count, the pop wait sequence, the push waiter count and the push wait sequence with 0 by using interlocked_exchange. ]*/ \
+                (void)interlocked_exchange(&result->pop_waiter_count, 0);                                                                                           \
+                (void)interlocked_exchange(&result->pop_wait_sequence, 0);                                                                                          \
+                (void)interlocked_exchange(&result->push_waiter_count, 0);                                                                                          \
+                (void)interlocked_exchange(&result->push_wait_sequence, 0);                                                                                         \
+                /* Codes_SRS_TQUEUE_12_172: [ TQUEUE_CREATE(T) shall initialize the high water mark with 0 by using interlocked_exchange_64. ]*/                    \
+                (void)interlocked_exchange_64(&result->high_water_mark, 0);                                                                                         \
+                /* Codes_SRS_TQUEUE_12_217: [ TQUEUE_CREATE(T) shall initialize the low occupancy pop count, the reclaim epoch, the operation counts of both epoch parities and the retired segment count with 0 by using interlocked_exchange. ]*/ \
+                (void)interlocked_exchange(&result->low_occupancy_pop_count, 0);                                                                                    \
+                (void)interlocked_exchange(&result->reclaim_epoch, 0);                                                                                              \
+                (void)interlocked_exchange(&result->epoch_operation_counts[0], 0);                                                                                  \
+                (void)interlocked_exchange(&result->epoch_operation_counts[1], 0);                                                                                  \
+                (void)interlocked_exchange(&result->retired_segment_count, 0);                                                                                      \
+                for (uint32_t i = 0; i < queue_size; i++)                                                                                                           \
                 {                                                                                                                                                   \
                     /* Codes_SRS_TQUEUE_01_052: [ TQUEUE_CREATE(T) shall initialize the state for each entry in the array used for the queue with NOT_USED by using interlocked_exchange. ] */ \
-                    (void)interlocked_exchange(&result->queue[i].state, QUEUE_ENTRY_STATE_NOT_USED);                                                                \
+                    (void)interlocked_exchange(&result->segments[0][i].state, QUEUE_ENTRY_STATE_NOT_USED);                                                          \
                 }                                                                                                                                                   \
-                /* Codes_SRS_TQUEUE_01_053: [ TQUEUE_CREATE(T) shall initialize a SRW_LOCK_LL to be used for locking the queue when it needs to grow in size. ] */  \
-                (void)srw_lock_ll_init(&result->resize_lock);                                                                                                       \
                 /* Codes_SRS_TQUEUE_01_054: [ TQUEUE_CREATE(T) shall succeed and return a non-NULL value. ] */                                                      \
                 /*return as is*/                                                                                                                                    \
                 goto all_ok;                                                                                                                                        \
@@ -233,271 +796,1368 @@ TQUEUE_LL(T) TQUEUE_LL_CREATE(C)(uint32_t initial_queue_size, uint32_t max_queue
     }                                                                                                                                                               \
 all_ok:                                                                                                                                                             \
     return result;                                                                                                                                                  \
-}
+}                                                                                                                                                                   \
 
-/*introduces a function definition for tqueue_push*/
-#define TQUEUE_LL_PUSH_DEFINE(C, T)                                                                                                                                 \
-TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH(C)(TQUEUE_LL(T) tqueue, T* item, void* copy_item_function_context)                                                                \
+/*introduces a function definition for tqueue_create_with_shrink*/
+#define TQUEUE_LL_CREATE_WITH_SHRINK_DEFINE(C, T)                                                                                                                   \
+TQUEUE_LL(T) TQUEUE_LL_CREATE_WITH_SHRINK(C)(uint32_t initial_queue_size, uint32_t max_queue_size, TQUEUE_COPY_ITEM_FUNC(T) copy_item_function, TQUEUE_DISPOSE_ITEM_FUNC(T) dispose_item_function, void* dispose_item_function_context, uint32_t shrink_after_pop_count) \
 {                                                                                                                                                                   \
-    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
-    if (                                                                                                                                                            \
-        /* Codes_SRS_TQUEUE_01_012: [ If tqueue is NULL then TQUEUE_PUSH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                      \
-        (tqueue == NULL) ||                                                                                                                                         \
-        /* Codes_SRS_TQUEUE_01_013: [ If item is NULL then TQUEUE_PUSH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                        \
-        (item == NULL)                                                                                                                                              \
-       )                                                                                                                                                            \
+    TQUEUE_TYPEDEF_NAME(T)* result;                                                                                                                                 \
+    if (shrink_after_pop_count == 0)                                                                                                                                \
     {                                                                                                                                                               \
-        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, const " MU_TOSTRING(T) "* item=%p, void* copy_item_function_context=%p",              \
-            tqueue, item, copy_item_function_context);                                                                                                              \
-        result = TQUEUE_PUSH_INVALID_ARG;                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_174: [ If shrink_after_pop_count is 0, TQUEUE_CREATE_WITH_SHRINK(T) shall fail and return NULL. ]*/                                  \
+        LogError("Invalid arguments: uint32_t initial_queue_size=%" PRIu32 ", uint32_t max_queue_size=%" PRIu32 ", " MU_TOSTRING(TQUEUE_COPY_ITEM_FUNC(T)) " copy_item_function=%p, " MU_TOSTRING(TQUEUE_DISPOSE_ITEM_FUNC(T)) " dispose_item_function=%p, void* dispose_item_function_context=%p, uint32_t shrink_after_pop_count=%" PRIu32 "", \
+            initial_queue_size, max_queue_size, copy_item_function, dispose_item_function, dispose_item_function_context, shrink_after_pop_count);                  \
+        result = NULL;                                                                                                                                              \
     }                                                                                                                                                               \
     else                                                                                                                                                            \
     {                                                                                                                                                               \
-        TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                         \
-        bool unlock_needed = true;                                                                                                                                  \
-        /* Codes_SRS_TQUEUE_01_058: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */                             \
-        srw_lock_ll_acquire_shared(&tqueue_ptr->resize_lock);                                                                                                       \
-        /* Codes_SRS_TQUEUE_01_014: [ TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/ \
-        do                                                                                                                                                          \
+        /* Codes_SRS_TQUEUE_12_175: [ TQUEUE_CREATE_WITH_SHRINK(T) shall create the queue by calling TQUEUE_CREATE(T) with initial_queue_size, max_queue_size, copy_item_function, dispose_item_function and dispose_item_function_context. ]*/ \
+        TQUEUE_LL(T) queue = TQUEUE_LL_CREATE(C)(initial_queue_size, max_queue_size, copy_item_function, dispose_item_function, dispose_item_function_context);     \
+        if (queue == NULL)                                                                                                                                          \
         {                                                                                                                                                           \
-            /* Codes_SRS_TQUEUE_01_015: [ TQUEUE_PUSH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/                                     \
-            int64_t current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                        \
-            /* Codes_SRS_TQUEUE_01_016: [ TQUEUE_PUSH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/                                     \
-            int64_t current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                        \
-            /* Codes_SRS_TQUEUE_01_060: [ If the queue is full (current head >= current tail + queue size): ]*/                                                     \
-            if (current_head >= current_tail + tqueue_ptr->queue_size)                                                                                              \
-            {                                                                                                                                                       \
-                /* greater cannot really happen */                                                                                                                  \
-                if (tqueue_ptr->queue_size >= tqueue_ptr->max_size)                                                                                                 \
-                {                                                                                                                                                   \
-                    /* Codes_SRS_TQUEUE_01_061: [ If the current queue size is equal to the max queue size, TQUEUE_PUSH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/ \
-                    result = TQUEUE_PUSH_QUEUE_FULL;                                                                                                                \
-                    break;                                                                                                                                          \
-                }                                                                                                                                                   \
-                else                                                                                                                                                \
-                {                                                                                                                                                   \
-                    /* Codes_SRS_TQUEUE_01_062: [ If the current queue size is less than the max queue size: ] */                                                   \
-                    /* Codes_SRS_TQUEUE_01_063: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ] */                 \
-                    srw_lock_ll_release_shared(&tqueue_ptr->resize_lock);                                                                                           \
-                    /* Codes_SRS_TQUEUE_01_064: [ TQUEUE_PUSH(T) shall acquire in exclusive mode the lock used to guard the growing of the queue. ] */              \
-                    srw_lock_ll_acquire_exclusive(&tqueue_ptr->resize_lock);                                                                                        \
-                    /* Codes_SRS_TQUEUE_01_075: [ TQUEUE_PUSH(T) shall obtain again the current head or the queue. ]*/                                              \
-                    current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                        \
-                    /* Codes_SRS_TQUEUE_01_076: [ TQUEUE_PUSH(T) shall obtain again the current tail or the queue. ]*/                                              \
-                    current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                        \
-                    /* Codes_SRS_TQUEUE_01_074: [ If the size of the queue did not change after acquiring the lock in shared mode: ]*/                              \
-                    if (current_head < current_tail + tqueue_ptr->queue_size)                                                                                       \
-                    {                                                                                                                                               \
-                        /* queue was resized by another thread or now there's space, do nothing */                                                                  \
-                    }                                                                                                                                               \
-                    else                                                                                                                                            \
-                    {                                                                                                                                               \
-                        /* Codes_SRS_TQUEUE_01_067: [ TQUEUE_PUSH(T) shall double the size of the queue. ]*/                                                        \
-                        uint32_t new_queue_size = tqueue_ptr->queue_size * 2;                                                                                       \
-                        if (new_queue_size > tqueue_ptr->max_size)                                                                                                  \
-                        {                                                                                                                                           \
-                            /* Codes_SRS_TQUEUE_01_070: [ If the newly computed queue size is higher than the max_queue_size value passed to TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall use max_queue_size as the new queue size. ]*/ \
-                            new_queue_size = tqueue_ptr->max_size;                                                                                                  \
-                        }                                                                                                                                           \
-                        /* Codes_SRS_TQUEUE_01_068: [ TQUEUE_PUSH(T) shall reallocate the array used to store the queue items based on the newly computed size. ]*/ \
-                        TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* temp_queue = realloc_2(tqueue_ptr->queue, new_queue_size, sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)));      \
-                        if (temp_queue == NULL)                                                                                                                     \
-                        {                                                                                                                                           \
-                            /* Codes_SRS_TQUEUE_01_069: [ If reallocation fails, TQUEUE_PUSH(T) shall return TQUEUE_PUSH_ERROR. ]*/                                 \
-                            LogError("realloc_2(tqueue_ptr->queue=%p, new_queue_size=%" PRIu32 ", sizeof(" MU_TOSTRING(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)) ")=%zu) failed", \
-                                tqueue_ptr->queue, new_queue_size, sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)));                                                       \
-                            result = TQUEUE_PUSH_ERROR;                                                                                                             \
-                            /* Codes_SRS_TQUEUE_01_065: [ TQUEUE_PUSH(T) shall release in exclusive mode the lock used to guard the growing of the queue. ] */      \
-                            srw_lock_ll_release_exclusive(&tqueue_ptr->resize_lock);                                                                                \
-                            /* No need to take the lock again, we are going to return anyway */                                                                     \
-                            unlock_needed = false;                                                                                                                  \
-                            break;                                                                                                                                  \
-                        }                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_176: [ If TQUEUE_CREATE(T) fails, TQUEUE_CREATE_WITH_SHRINK(T) shall fail and return NULL. ]*/                                   \
+            LogError("failure in " MU_TOSTRING(TQUEUE_LL_CREATE(C)) "(initial_queue_size=%" PRIu32 ", max_queue_size=%" PRIu32 ", ...)",                            \
+                initial_queue_size, max_queue_size);                                                                                                                \
+            result = NULL;                                                                                                                                          \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_177: [ TQUEUE_CREATE_WITH_SHRINK(T) shall store shrink_after_pop_count in the queue, succeed and return the queue. ]*/           \
+            /* no other thread has the queue yet */                                                                                                                 \
+            result = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(queue);                                                                                                  \
+            result->shrink_after_pop_count = shrink_after_pop_count;                                                                                                \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_push*/
+#define TQUEUE_LL_PUSH_DEFINE(C, T)                                                                                                                                 \
+/*pushes item in the queue, move_item skips the copy_item_function (used by tqueue_push_move)*/                                                                     \
+static TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH_ITEM_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, T* item, void* copy_item_function_context, bool move_item)                \
+{                                                                                                                                                                   \
+    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
+    int32_t epoch_parity = TQUEUE_SEGMENTS_NOT_PROTECTED;                                                                                                           \
+    /* Codes_SRS_TQUEUE_01_014: [ TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/ \
+    do                                                                                                                                                              \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_01_015: [ TQUEUE_PUSH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/                                         \
+        int64_t current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                            \
+        /* Codes_SRS_TQUEUE_01_016: [ TQUEUE_PUSH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/                                         \
+        int64_t current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                            \
+        int64_t head_position = TQUEUE_GET_POSITION(current_head);                                                                                                  \
+        uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_head);                                                                                            \
+        /* Codes_SRS_TQUEUE_12_004: [ If the queue holds max queue size items (current head position >= current tail position + max queue size), TQUEUE_PUSH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/ \
+        if (head_position >= TQUEUE_GET_POSITION(current_tail) + tqueue_ptr->max_size)                                                                              \
+        {                                                                                                                                                           \
+            result = TQUEUE_PUSH_QUEUE_FULL;                                                                                                                        \
+            break;                                                                                                                                                  \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_006: [ If the queue holds at least as many items as the size of the head segment (current head position >= current tail position + head segment size): ]*/ \
+        /* the items can be in previous segments too, in which case the head segment is not really full, but growing is harmless */                                 \
+        else if (head_position >= TQUEUE_GET_POSITION(current_tail) + TQUEUE_GET_SEGMENT_SIZE(tqueue_ptr->queue_size, segment_index))                               \
+        {                                                                                                                                                           \
+            if (TQUEUE_LL_GROW_NAME(C)(tqueue_ptr, current_head) != 0)                                                                                              \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_008: [ If allocating the segment fails, TQUEUE_PUSH(T) shall return TQUEUE_PUSH_ERROR. ]*/                                   \
+                LogError(MU_TOSTRING(TQUEUE_LL_GROW_NAME(C)) "(tqueue_ptr=%p, current_head=%" PRId64 ") failed", tqueue_ptr, current_head);                         \
+                result = TQUEUE_PUSH_ERROR;                                                                                                                         \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+            continue;                                                                                                                                               \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_219: [ TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T) and the single producer TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall shrink the queue as described below and retry if the head was moved. ]*/ \
+        else if (TQUEUE_LL_SHRINK_NAME(C)(tqueue_ptr, current_head, current_tail, false))                                                                           \
+        {                                                                                                                                                           \
+            continue;                                                                                                                                               \
+        }                                                                                                                                                           \
+        else if (                                                                                                                                                   \
+            (tqueue_ptr->shrink_after_pop_count != 0) &&                                                                                                            \
+            (epoch_parity == TQUEUE_SEGMENTS_NOT_PROTECTED) &&                                                                                                      \
+            (TQUEUE_GET_SEGMENT_INDEX_IN_BANK(segment_index) != 0)                                                                                                  \
+           )                                                                                                                                                        \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_221: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T) and the head is not in the first segment of its bank, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall protect the segments as described below before using them and retry. ]*/ \
+            epoch_parity = TQUEUE_LL_PROTECT_SEGMENTS_NAME(C)(tqueue_ptr);                                                                                          \
+            continue;                                                                                                                                               \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = tqueue_ptr->segments[segment_index];                                                                        \
+            if (segment == NULL)                                                                                                                                    \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_222: [ If the segment of the head or of the tail is not allocated because a shrink retired it, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall retry. ]*/ \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, head_position);                                                  \
+            /* Codes_SRS_TQUEUE_01_017: [ Using interlocked_compare_exchange, TQUEUE_PUSH(T) shall change the head array entry state to PUSHING (from NOT_USED). ]*/ \
+            if (interlocked_compare_exchange(&segment[index].state, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED) != QUEUE_ENTRY_STATE_NOT_USED)           \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_01_023: [ If the state of the array entry corresponding to the head is not NOT_USED, TQUEUE_PUSH(T) shall retry the whole push. ]*/ \
+                /* likely queue full */                                                                                                                             \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            else                                                                                                                                                    \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_01_018: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH(T) shall replace the head value with the head value obtained earlier + 1. ]*/ \
+                if (interlocked_compare_exchange_64(&tqueue_ptr->head, current_head + 1, current_head) != current_head)                                             \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_01_043: [ If the queue head has changed, TQUEUE_PUSH(T) shall set the state back to NOT_USED and retry the push. ]*/        \
+                    (void)interlocked_exchange(&segment[index].state, QUEUE_ENTRY_STATE_NOT_USED);                                                                  \
+                    continue;                                                                                                                                       \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    if (move_item || (tqueue_ptr->copy_item_function == NULL))                                                                                      \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_165: [ TQUEUE_PUSH_MOVE(T) shall push item the same way TQUEUE_PUSH(T) does, except that it shall always copy the value of item into the array entry value and it shall not call copy_item_function. ]*/ \
+                        /* Codes_SRS_TQUEUE_01_019: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall copy the value of item into the array entry value whose state was changed to PUSHING. ]*/ \
+                        (void)memcpy((void*)&segment[index].value, (void*)item, sizeof(T));                                                                         \
+                    }                                                                                                                                               \
+                    else                                                                                                                                            \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_01_024: [ If a copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall call the copy_item_function with copy_item_function_context as context, a pointer to the array entry value whose state was changed to PUSHING as push_dst and item as push_src. ]*/ \
+                        tqueue_ptr->copy_item_function(copy_item_function_context, &segment[index].value, item);                                                    \
+                    }                                                                                                                                               \
+                    /* Codes_SRS_TQUEUE_01_020: [ TQUEUE_PUSH(T) shall set the state to USED by using interlocked_exchange. ]*/                                     \
+                    (void)interlocked_exchange(&segment[index].state, QUEUE_ENTRY_STATE_USED);                                                                      \
+                    /* Codes_SRS_TQUEUE_12_055: [ TQUEUE_PUSH(T) shall obtain the number of threads waiting in TQUEUE_POP_WAIT(T) by calling interlocked_add. ]*/   \
+                    if (interlocked_add(&tqueue_ptr->pop_waiter_count, 0) > 0)                                                                                      \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_056: [ If there are threads waiting in TQUEUE_POP_WAIT(T), TQUEUE_PUSH(T) shall increment the pop wait sequence by calling interlocked_increment and wake one of the threads by calling wake_by_address_single. ]*/ \
+                        (void)interlocked_increment(&tqueue_ptr->pop_wait_sequence);                                                                                \
+                        wake_by_address_single(&tqueue_ptr->pop_wait_sequence);                                                                                     \
+                    }                                                                                                                                               \
+                    /* Codes_SRS_TQUEUE_12_178: [ After pushing, TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall update the high water mark with the number of items in the queue (the new head position - the tail position obtained earlier). ]*/ \
+                    TQUEUE_LL_UPDATE_HIGH_WATER_MARK_NAME(C)(tqueue_ptr, head_position + 1 - TQUEUE_GET_POSITION(current_tail));                                    \
+                    /* Codes_SRS_TQUEUE_01_021: [ TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/                                                       \
+                    result = TQUEUE_PUSH_OK;                                                                                                                        \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+            }                                                                                                                                                       \
+        }                                                                                                                                                           \
+    } while (1);                                                                                                                                                    \
+    TQUEUE_LL_UNPROTECT_SEGMENTS_NAME(C)(tqueue_ptr, epoch_parity);                                                                                                 \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH(C)(TQUEUE_LL(T) tqueue, T* item, void* copy_item_function_context)                                                                \
+{                                                                                                                                                                   \
+    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_01_012: [ If tqueue is NULL then TQUEUE_PUSH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                      \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_01_013: [ If item is NULL then TQUEUE_PUSH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                        \
+        (item == NULL)                                                                                                                                              \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, const " MU_TOSTRING(T) "* item=%p, void* copy_item_function_context=%p",              \
+            tqueue, item, copy_item_function_context);                                                                                                              \
+        result = TQUEUE_PUSH_INVALID_ARG;                                                                                                                           \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        result = TQUEUE_LL_PUSH_ITEM_NAME(C)(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue), item, copy_item_function_context, false);                               \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_pop*/
+#define TQUEUE_LL_POP_DEFINE(C, T)                                                                                                                                  \
+/*pops an item from the queue, move_item skips the copy_item_function and the dispose_item_function (used by tqueue_pop_move)*/                                     \
+static TQUEUE_POP_RESULT TQUEUE_LL_POP_ITEM_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, T* item, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context, bool move_item) \
+{                                                                                                                                                                   \
+    TQUEUE_POP_RESULT result;                                                                                                                                       \
+    int32_t epoch_parity = TQUEUE_SEGMENTS_NOT_PROTECTED;                                                                                                           \
+    /* Codes_SRS_TQUEUE_01_026: [ TQUEUE_POP(T) shall execute the following actions until it is either able to pop the item from the queue or the queue is empty: ] */ \
+    do                                                                                                                                                              \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_01_028: [ TQUEUE_POP(T) shall obtain the current head queue by calling interlocked_add_64. ]*/                                          \
+        int64_t current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                            \
+        /* Codes_SRS_TQUEUE_01_029: [ TQUEUE_POP(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/                                          \
+        int64_t current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                            \
+        int64_t tail_position = TQUEUE_GET_POSITION(current_tail);                                                                                                  \
+        if (tail_position >= TQUEUE_GET_POSITION(current_head))                                                                                                     \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_01_035: [ If the queue is empty (current tail position >= current head position), TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/ \
+            result = TQUEUE_POP_QUEUE_EMPTY;                                                                                                                        \
+            break;                                                                                                                                                  \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_220: [ TQUEUE_POP(T), TQUEUE_POP_BATCH(T) and the single consumer TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall move the tail to the bank of the head as described below and try again if the tail was moved. ]*/ \
+        else if (TQUEUE_LL_FOLLOW_HEAD_BANK_NAME(C)(tqueue_ptr, current_head, current_tail, false))                                                                 \
+        {                                                                                                                                                           \
+            continue;                                                                                                                                               \
+        }                                                                                                                                                           \
+        else if (                                                                                                                                                   \
+            (tqueue_ptr->shrink_after_pop_count != 0) &&                                                                                                            \
+            (epoch_parity == TQUEUE_SEGMENTS_NOT_PROTECTED) &&                                                                                                      \
+            (TQUEUE_GET_SEGMENT_INDEX_IN_BANK(TQUEUE_GET_SEGMENT_INDEX(current_head)) != 0)                                                                         \
+           )                                                                                                                                                        \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_221: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T) and the head is not in the first segment of its bank, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall protect the segments as described below before using them and retry. ]*/ \
+            epoch_parity = TQUEUE_LL_PROTECT_SEGMENTS_NAME(C)(tqueue_ptr);                                                                                          \
+            continue;                                                                                                                                               \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_tail);                                                                                        \
+            TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = tqueue_ptr->segments[segment_index];                                                                        \
+            if (segment == NULL)                                                                                                                                    \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_222: [ If the segment of the head or of the tail is not allocated because a shrink retired it, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall retry. ]*/ \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position);                                                  \
+            /* Codes_SRS_TQUEUE_01_030: [ Using interlocked_compare_exchange, TQUEUE_PUSH(T) shall set the tail array entry state to POPPING (from USED). ]*/       \
+            bool is_popping = (interlocked_compare_exchange(&segment[index].state, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED) == QUEUE_ENTRY_STATE_USED);   \
+            if (                                                                                                                                                    \
+                (!is_popping) &&                                                                                                                                    \
+                (segment_index < TQUEUE_GET_SEGMENT_INDEX(current_head))                                                                                            \
+               )                                                                                                                                                    \
+            {                                                                                                                                                       \
+                /* the item at the tail position was pushed after the head moved to the next segment */                                                             \
+                segment_index++;                                                                                                                                    \
+                segment = tqueue_ptr->segments[segment_index];                                                                                                      \
+                if (segment == NULL)                                                                                                                                \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_222: [ If the segment of the head or of the tail is not allocated because a shrink retired it, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall retry. ]*/ \
+                    continue;                                                                                                                                       \
+                }                                                                                                                                                   \
+                index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position);                                                       \
+                /* Codes_SRS_TQUEUE_12_013: [ If the state of the array entry corresponding to the tail is not USED and the head is in a later segment than the tail, TQUEUE_POP(T) shall set the state of the array entry corresponding to the tail position in the segment following the tail segment to POPPING (from USED) by using interlocked_compare_exchange. ]*/ \
+                is_popping = (interlocked_compare_exchange(&segment[index].state, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED) == QUEUE_ENTRY_STATE_USED);    \
+            }                                                                                                                                                       \
+                                                                                                                                                                    \
+            if (!is_popping)                                                                                                                                        \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_01_036: [ If the state of the array entry corresponding to the tail is not USED, TQUEUE_POP(T) shall try again. ]*/             \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            else                                                                                                                                                    \
+            {                                                                                                                                                       \
+                bool should_pop;                                                                                                                                    \
+                /* Codes_SRS_TQUEUE_01_039: [ If condition_function is not NULL: ]*/                                                                                \
+                if (condition_function != NULL)                                                                                                                     \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_01_040: [ TQUEUE_POP(T) shall call condition_function with condition_function_context and a pointer to the array entry value whose state was changed to POPPING. ] */ \
+                    should_pop = condition_function(condition_function_context, (T*)&segment[index].value);                                                         \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_01_042: [ Otherwise, shall proceed with the pop. ]*/                                                                        \
+                    should_pop = true;                                                                                                                              \
+                }                                                                                                                                                   \
+                if (!should_pop)                                                                                                                                    \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_01_041: [ If condition_function returns false, TQUEUE_POP(T) shall set the state to USED by using interlocked_exchange and return TQUEUE_POP_REJECTED. ]*/ \
+                    (void)interlocked_exchange(&segment[index].state, QUEUE_ENTRY_STATE_USED);                                                                      \
+                    result = TQUEUE_POP_REJECTED;                                                                                                                   \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_01_031: [ TQUEUE_POP(T) shall replace the tail value with the tail value obtained earlier + 1 by using interlocked_compare_exchange_64. ]*/ \
+                    /* Codes_SRS_TQUEUE_12_014: [ If the item was found in the segment following the tail segment, TQUEUE_POP(T) shall also move the tail to that segment. ]*/ \
+                    if (interlocked_compare_exchange_64(&tqueue_ptr->tail, TQUEUE_MAKE_HEAD_OR_TAIL(segment_index, tail_position + 1), current_tail) != current_tail) \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_01_044: [ If incrementing the tail by using interlocked_compare_exchange_64 does not succeed, TQUEUE_POP(T) shall revert the state of the array entry to USED and retry. ]*/ \
+                        (void)interlocked_exchange(&segment[index].state, QUEUE_ENTRY_STATE_USED);                                                                  \
+                        continue;                                                                                                                                   \
+                    }                                                                                                                                               \
+                    else                                                                                                                                            \
+                    {                                                                                                                                               \
+                        if (move_item || (tqueue_ptr->copy_item_function == NULL))                                                                                  \
+                        {                                                                                                                                           \
+                            /* Codes_SRS_TQUEUE_12_170: [ TQUEUE_POP_MOVE(T) shall pop an item the same way TQUEUE_POP(T) does, except that it shall always copy the array entry value to item and it shall call neither copy_item_function nor dispose_item_function. ]*/ \
+                            /* Codes_SRS_TQUEUE_01_032: [ If a copy_item_function was not specified in TQUEUE_CREATE(T): ]*/                                        \
+                            /* Codes_SRS_TQUEUE_01_033: [ TQUEUE_POP(T) shall copy array entry value whose state was changed to POPPING to item. ]*/                \
+                            (void)memcpy((void*)item, (void*)&segment[index].value, sizeof(T));                                                                     \
+                        }                                                                                                                                           \
                         else                                                                                                                                        \
                         {                                                                                                                                           \
-                            tqueue_ptr->queue = temp_queue;                                                                                                         \
-                            /* Codes_SRS_TQUEUE_01_077: [ TQUEUE_PUSH(T) shall move the entries between the tail index and the array end like below: ]*/            \
-                            uint32_t elements_in_queue = (uint32_t)(current_head - current_tail);                                                                   \
-                            uint32_t tail_index = current_tail % tqueue_ptr->queue_size;                                                                            \
-                            uint32_t copy_item_count = tqueue_ptr->queue_size - tail_index;                                                                         \
-                            uint32_t new_tail_index = new_queue_size - copy_item_count;                                                                             \
-                            /* Codes_SRS_TQUEUE_01_078: [ Entries at the tail shall be moved to the end of the resized array ]*/                                    \
-                            /* Please see diagram in the spec */                                                                                                    \
-                            if (copy_item_count > 0)                                                                                                                \
+                            /* Codes_SRS_TQUEUE_01_037: [ If copy_item_function and sispose_item_function were specified in TQUEUE_CREATE(T): ]*/                   \
+                            /* Codes_SRS_TQUEUE_01_038: [ TQUEUE_POP(T) shall call copy_item_function with copy_item_function_context as context, the array entry value whose state was changed to POPPING to item as pop_src and item as pop_dst. ]*/ \
+                            tqueue_ptr->copy_item_function(copy_item_function_context, item, (T*)&segment[index].value);                                            \
+                        }                                                                                                                                           \
+                        if (!move_item && (tqueue_ptr->dispose_item_function != NULL))                                                                              \
+                        {                                                                                                                                           \
+                            /* Codes_SRS_TQUEUE_01_045: [ TQUEUE_POP(T) shall call dispose_item_function with dispose_item_function_context as context and the array entry value whose state was changed to POPPING as item. ]*/ \
+                            tqueue_ptr->dispose_item_function(tqueue_ptr->dispose_item_function_context, (T*)&segment[index].value);                                \
+                        }                                                                                                                                           \
+                        /* Codes_SRS_TQUEUE_01_034: [ TQUEUE_POP(T) shall set the state to NOT_USED by using interlocked_exchange, succeed and return TQUEUE_POP_OK. ]*/ \
+                        (void)interlocked_exchange(&segment[index].state, QUEUE_ENTRY_STATE_NOT_USED);                                                              \
+                        /* Codes_SRS_TQUEUE_12_057: [ TQUEUE_POP(T) shall obtain the number of threads waiting in TQUEUE_PUSH_WAIT(T) by calling interlocked_add. ]*/ \
+                        if (interlocked_add(&tqueue_ptr->push_waiter_count, 0) > 0)                                                                                 \
+                        {                                                                                                                                           \
+                            /* Codes_SRS_TQUEUE_12_058: [ If there are threads waiting in TQUEUE_PUSH_WAIT(T), TQUEUE_POP(T) shall increment the push wait sequence by calling interlocked_increment and wake one of the threads by calling wake_by_address_single. ]*/ \
+                            (void)interlocked_increment(&tqueue_ptr->push_wait_sequence);                                                                           \
+                            wake_by_address_single(&tqueue_ptr->push_wait_sequence);                                                                                \
+                        }                                                                                                                                           \
+                        result = TQUEUE_POP_OK;                                                                                                                     \
+                    }                                                                                                                                               \
+                }                                                                                                                                                   \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+        }                                                                                                                                                           \
+    } while (1);                                                                                                                                                    \
+    TQUEUE_LL_UNPROTECT_SEGMENTS_NAME(C)(tqueue_ptr, epoch_parity);                                                                                                 \
+    if (result == TQUEUE_POP_OK)                                                                                                                                    \
+    {                                                                                                                                                               \
+        TQUEUE_LL_COUNT_LOW_OCCUPANCY_POP_NAME(C)(tqueue_ptr);                                                                                                      \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+TQUEUE_POP_RESULT TQUEUE_LL_POP(C)(TQUEUE_LL(T) tqueue, T* item, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context) \
+{                                                                                                                                                                   \
+    TQUEUE_POP_RESULT result;                                                                                                                                       \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_01_025: [ If tqueue is NULL then TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                        \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_01_027: [ If item is NULL then TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                          \
+        (item == NULL)                                                                                                                                              \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "*=%p, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context", \
+            tqueue, item);                                                                                                                                          \
+        result = TQUEUE_POP_INVALID_ARG;                                                                                                                            \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        result = TQUEUE_LL_POP_ITEM_NAME(C)(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue), item, copy_item_function_context, condition_function, condition_function_context, false); \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_push_batch*/
+#define TQUEUE_LL_PUSH_BATCH_DEFINE(C, T)                                                                                                                           \
+TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH_BATCH(C)(TQUEUE_LL(T) tqueue, T* items, uint32_t item_count, void* copy_item_function_context, uint32_t* pushed_item_count)       \
+{                                                                                                                                                                   \
+    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_015: [ If tqueue is NULL then TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_016: [ If items is NULL then TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                 \
+        (items == NULL) ||                                                                                                                                          \
+        /* Codes_SRS_TQUEUE_12_017: [ If item_count is 0 then TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                               \
+        (item_count == 0) ||                                                                                                                                        \
+        /* Codes_SRS_TQUEUE_12_018: [ If pushed_item_count is NULL then TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                     \
+        (pushed_item_count == NULL)                                                                                                                                 \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* items=%p, uint32_t item_count=%" PRIu32 ", void* copy_item_function_context=%p, uint32_t* pushed_item_count=%p", \
+            tqueue, items, item_count, copy_item_function_context, pushed_item_count);                                                                              \
+        result = TQUEUE_PUSH_INVALID_ARG;                                                                                                                           \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                         \
+        int32_t epoch_parity = TQUEUE_SEGMENTS_NOT_PROTECTED;                                                                                                       \
+        /* Codes_SRS_TQUEUE_12_019: [ TQUEUE_PUSH_BATCH(T) shall execute the following actions until it is either able to push at least one item in the queue or the queue is full: ]*/ \
+        do                                                                                                                                                          \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_020: [ TQUEUE_PUSH_BATCH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/                               \
+            int64_t current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                        \
+            /* Codes_SRS_TQUEUE_12_021: [ TQUEUE_PUSH_BATCH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/                               \
+            int64_t current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                        \
+            int64_t head_position = TQUEUE_GET_POSITION(current_head);                                                                                              \
+            uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_head);                                                                                        \
+            int64_t queue_item_count = head_position - TQUEUE_GET_POSITION(current_tail);                                                                           \
+            int64_t segment_size = TQUEUE_GET_SEGMENT_SIZE(tqueue_ptr->queue_size, segment_index);                                                                  \
+            if (queue_item_count >= tqueue_ptr->max_size)                                                                                                           \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_022: [ If the queue holds max queue size items, TQUEUE_PUSH_BATCH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/                \
+                result = TQUEUE_PUSH_QUEUE_FULL;                                                                                                                    \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+            else if (queue_item_count >= segment_size)                                                                                                              \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_023: [ If the queue holds at least as many items as the size of the head segment, TQUEUE_PUSH_BATCH(T) shall grow the queue the same way TQUEUE_PUSH(T) does and retry. ]*/ \
+                if (TQUEUE_LL_GROW_NAME(C)(tqueue_ptr, current_head) != 0)                                                                                          \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_024: [ If growing the queue fails, TQUEUE_PUSH_BATCH(T) shall return TQUEUE_PUSH_ERROR. ]*/                              \
+                    LogError(MU_TOSTRING(TQUEUE_LL_GROW_NAME(C)) "(tqueue_ptr=%p, current_head=%" PRId64 ") failed", tqueue_ptr, current_head);                     \
+                    result = TQUEUE_PUSH_ERROR;                                                                                                                     \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_219: [ TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T) and the single producer TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall shrink the queue as described below and retry if the head was moved. ]*/ \
+            else if (TQUEUE_LL_SHRINK_NAME(C)(tqueue_ptr, current_head, current_tail, false))                                                                       \
+            {                                                                                                                                                       \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            else if (                                                                                                                                               \
+                (tqueue_ptr->shrink_after_pop_count != 0) &&                                                                                                        \
+                (epoch_parity == TQUEUE_SEGMENTS_NOT_PROTECTED) &&                                                                                                  \
+                (TQUEUE_GET_SEGMENT_INDEX_IN_BANK(segment_index) != 0)                                                                                              \
+               )                                                                                                                                                    \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_221: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T) and the head is not in the first segment of its bank, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall protect the segments as described below before using them and retry. ]*/ \
+                epoch_parity = TQUEUE_LL_PROTECT_SEGMENTS_NAME(C)(tqueue_ptr);                                                                                      \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            else                                                                                                                                                    \
+            {                                                                                                                                                       \
+                TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = tqueue_ptr->segments[segment_index];                                                                    \
+                if (segment == NULL)                                                                                                                                \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_222: [ If the segment of the head or of the tail is not allocated because a shrink retired it, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall retry. ]*/ \
+                    continue;                                                                                                                                       \
+                }                                                                                                                                                   \
+                /* Codes_SRS_TQUEUE_12_025: [ TQUEUE_PUSH_BATCH(T) shall push at most item_count items, without exceeding the max queue size and the size of the head segment. ]*/ \
+                int64_t free_entry_count = ((tqueue_ptr->max_size < segment_size) ? tqueue_ptr->max_size : segment_size) - queue_item_count;                        \
+                uint32_t max_push_count = (free_entry_count < item_count) ? (uint32_t)free_entry_count : item_count;                                                \
+                uint32_t pushing_count;                                                                                                                             \
+                for (pushing_count = 0; pushing_count < max_push_count; pushing_count++)                                                                            \
+                {                                                                                                                                                   \
+                    uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, head_position + pushing_count);                          \
+                    /* Codes_SRS_TQUEUE_12_026: [ Using interlocked_compare_exchange, TQUEUE_PUSH_BATCH(T) shall change the state of the array entries following the head to PUSHING (from NOT_USED), stopping at the first entry whose state is not NOT_USED. ]*/ \
+                    if (interlocked_compare_exchange(&segment[index].state, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED) != QUEUE_ENTRY_STATE_NOT_USED)   \
+                    {                                                                                                                                               \
+                        break;                                                                                                                                      \
+                    }                                                                                                                                               \
+                }                                                                                                                                                   \
+                                                                                                                                                                    \
+                if (pushing_count == 0)                                                                                                                             \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_027: [ If the state of the array entry corresponding to the head is not NOT_USED, TQUEUE_PUSH_BATCH(T) shall retry the whole push. ]*/ \
+                    continue;                                                                                                                                       \
+                }                                                                                                                                                   \
+                /* Codes_SRS_TQUEUE_12_028: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH_BATCH(T) shall replace the head value with the head value obtained earlier + the number of array entries whose state was changed to PUSHING. ]*/ \
+                else if (interlocked_compare_exchange_64(&tqueue_ptr->head, current_head + pushing_count, current_head) != current_head)                            \
+                {                                                                                                                                                   \
+                    for (uint32_t i = 0; i < pushing_count; i++)                                                                                                    \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_029: [ If the queue head has changed, TQUEUE_PUSH_BATCH(T) shall set the state of all the array entries whose state was changed to PUSHING back to NOT_USED and retry the push. ]*/ \
+                        (void)interlocked_exchange(&segment[TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, head_position + i)].state, QUEUE_ENTRY_STATE_NOT_USED); \
+                    }                                                                                                                                               \
+                    continue;                                                                                                                                       \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    for (uint32_t i = 0; i < pushing_count; i++)                                                                                                    \
+                    {                                                                                                                                               \
+                        uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, head_position + i);                                  \
+                        if (tqueue_ptr->copy_item_function == NULL)                                                                                                 \
+                        {                                                                                                                                           \
+                            /* Codes_SRS_TQUEUE_12_030: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH_BATCH(T) shall copy the value of each pushed item into its array entry value. ]*/ \
+                            (void)memcpy((void*)&segment[index].value, (void*)&items[i], sizeof(T));                                                                \
+                        }                                                                                                                                           \
+                        else                                                                                                                                        \
+                        {                                                                                                                                           \
+                            /* Codes_SRS_TQUEUE_12_031: [ If a copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH_BATCH(T) shall call the copy_item_function for each pushed item with copy_item_function_context as context, a pointer to its array entry value as push_dst and a pointer to the item as push_src. ]*/ \
+                            tqueue_ptr->copy_item_function(copy_item_function_context, &segment[index].value, &items[i]);                                           \
+                        }                                                                                                                                           \
+                        /* Codes_SRS_TQUEUE_12_032: [ TQUEUE_PUSH_BATCH(T) shall set the state of each array entry to USED by using interlocked_exchange. ]*/       \
+                        (void)interlocked_exchange(&segment[index].state, QUEUE_ENTRY_STATE_USED);                                                                  \
+                    }                                                                                                                                               \
+                    /* Codes_SRS_TQUEUE_12_059: [ TQUEUE_PUSH_BATCH(T) shall obtain the number of threads waiting in TQUEUE_POP_WAIT(T) by calling interlocked_add. ]*/ \
+                    if (interlocked_add(&tqueue_ptr->pop_waiter_count, 0) > 0)                                                                                      \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_060: [ If there are threads waiting in TQUEUE_POP_WAIT(T), TQUEUE_PUSH_BATCH(T) shall increment the pop wait sequence by calling interlocked_increment and wake all the threads by calling wake_by_address_all. ]*/ \
+                        (void)interlocked_increment(&tqueue_ptr->pop_wait_sequence);                                                                                \
+                        wake_by_address_all(&tqueue_ptr->pop_wait_sequence);                                                                                        \
+                    }                                                                                                                                               \
+                    /* Codes_SRS_TQUEUE_12_178: [ After pushing, TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall update the high water mark with the number of items in the queue (the new head position - the tail position obtained earlier). ]*/ \
+                    TQUEUE_LL_UPDATE_HIGH_WATER_MARK_NAME(C)(tqueue_ptr, queue_item_count + pushing_count);                                                         \
+                    /* Codes_SRS_TQUEUE_12_033: [ TQUEUE_PUSH_BATCH(T) shall set pushed_item_count to the number of pushed items, succeed and return TQUEUE_PUSH_OK. ]*/ \
+                    *pushed_item_count = pushing_count;                                                                                                             \
+                    result = TQUEUE_PUSH_OK;                                                                                                                        \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+            }                                                                                                                                                       \
+        } while (1);                                                                                                                                                \
+        TQUEUE_LL_UNPROTECT_SEGMENTS_NAME(C)(tqueue_ptr, epoch_parity);                                                                                             \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_pop_batch*/
+#define TQUEUE_LL_POP_BATCH_DEFINE(C, T)                                                                                                                            \
+TQUEUE_POP_RESULT TQUEUE_LL_POP_BATCH(C)(TQUEUE_LL(T) tqueue, T* items, uint32_t item_count, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context, uint32_t* popped_item_count) \
+{                                                                                                                                                                   \
+    TQUEUE_POP_RESULT result;                                                                                                                                       \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_034: [ If tqueue is NULL then TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                  \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_035: [ If items is NULL then TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                   \
+        (items == NULL) ||                                                                                                                                          \
+        /* Codes_SRS_TQUEUE_12_036: [ If item_count is 0 then TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                 \
+        (item_count == 0) ||                                                                                                                                        \
+        /* Codes_SRS_TQUEUE_12_037: [ If popped_item_count is NULL then TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                       \
+        (popped_item_count == NULL)                                                                                                                                 \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* items=%p, uint32_t item_count=%" PRIu32 ", void* copy_item_function_context=%p, TQUEUE_CONDITION_FUNC(T) condition_function=%p, void* condition_function_context=%p, uint32_t* popped_item_count=%p", \
+            tqueue, items, item_count, copy_item_function_context, condition_function, condition_function_context, popped_item_count);                              \
+        result = TQUEUE_POP_INVALID_ARG;                                                                                                                            \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                         \
+        int32_t epoch_parity = TQUEUE_SEGMENTS_NOT_PROTECTED;                                                                                                       \
+        /* Codes_SRS_TQUEUE_12_038: [ TQUEUE_POP_BATCH(T) shall execute the following actions until it is either able to pop at least one item from the queue or the queue is empty: ]*/ \
+        do                                                                                                                                                          \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_039: [ TQUEUE_POP_BATCH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/                                \
+            int64_t current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                        \
+            /* Codes_SRS_TQUEUE_12_040: [ TQUEUE_POP_BATCH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/                                \
+            int64_t current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                        \
+            int64_t tail_position = TQUEUE_GET_POSITION(current_tail);                                                                                              \
+            if (tail_position >= TQUEUE_GET_POSITION(current_head))                                                                                                 \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_041: [ If the queue is empty (current tail position >= current head position), TQUEUE_POP_BATCH(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/ \
+                result = TQUEUE_POP_QUEUE_EMPTY;                                                                                                                    \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_220: [ TQUEUE_POP(T), TQUEUE_POP_BATCH(T) and the single consumer TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall move the tail to the bank of the head as described below and try again if the tail was moved. ]*/ \
+            else if (TQUEUE_LL_FOLLOW_HEAD_BANK_NAME(C)(tqueue_ptr, current_head, current_tail, false))                                                             \
+            {                                                                                                                                                       \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            else if (                                                                                                                                               \
+                (tqueue_ptr->shrink_after_pop_count != 0) &&                                                                                                        \
+                (epoch_parity == TQUEUE_SEGMENTS_NOT_PROTECTED) &&                                                                                                  \
+                (TQUEUE_GET_SEGMENT_INDEX_IN_BANK(TQUEUE_GET_SEGMENT_INDEX(current_head)) != 0)                                                                     \
+               )                                                                                                                                                    \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_221: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T) and the head is not in the first segment of its bank, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall protect the segments as described below before using them and retry. ]*/ \
+                epoch_parity = TQUEUE_LL_PROTECT_SEGMENTS_NAME(C)(tqueue_ptr);                                                                                      \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            else                                                                                                                                                    \
+            {                                                                                                                                                       \
+                uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_tail);                                                                                    \
+                TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = tqueue_ptr->segments[segment_index];                                                                    \
+                if (segment == NULL)                                                                                                                                \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_222: [ If the segment of the head or of the tail is not allocated because a shrink retired it, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall retry. ]*/ \
+                    continue;                                                                                                                                       \
+                }                                                                                                                                                   \
+                uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position);                                              \
+                /* Codes_SRS_TQUEUE_12_042: [ Using interlocked_compare_exchange, TQUEUE_POP_BATCH(T) shall set the tail array entry state to POPPING (from USED), looking in the segment following the tail segment like TQUEUE_POP(T) does when the head is in a later segment than the tail. ]*/ \
+                bool is_popping = (interlocked_compare_exchange(&segment[index].state, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED) == QUEUE_ENTRY_STATE_USED); \
+                if (                                                                                                                                                \
+                    (!is_popping) &&                                                                                                                                \
+                    (segment_index < TQUEUE_GET_SEGMENT_INDEX(current_head))                                                                                        \
+                   )                                                                                                                                                \
+                {                                                                                                                                                   \
+                    segment_index++;                                                                                                                                \
+                    segment = tqueue_ptr->segments[segment_index];                                                                                                  \
+                    if (segment == NULL)                                                                                                                            \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_222: [ If the segment of the head or of the tail is not allocated because a shrink retired it, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall retry. ]*/ \
+                        continue;                                                                                                                                   \
+                    }                                                                                                                                               \
+                    index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position);                                                   \
+                    is_popping = (interlocked_compare_exchange(&segment[index].state, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED) == QUEUE_ENTRY_STATE_USED); \
+                }                                                                                                                                                   \
+                                                                                                                                                                    \
+                if (!is_popping)                                                                                                                                    \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_043: [ If the state of the array entry corresponding to the tail is not USED, TQUEUE_POP_BATCH(T) shall try again. ]*/   \
+                    continue;                                                                                                                                       \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    bool should_pop;                                                                                                                                \
+                    if (condition_function != NULL)                                                                                                                 \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_044: [ If condition_function is not NULL, TQUEUE_POP_BATCH(T) shall call condition_function with condition_function_context and a pointer to the array entry value of the first item only. ]*/ \
+                        should_pop = condition_function(condition_function_context, (T*)&segment[index].value);                                                     \
+                    }                                                                                                                                               \
+                    else                                                                                                                                            \
+                    {                                                                                                                                               \
+                        should_pop = true;                                                                                                                          \
+                    }                                                                                                                                               \
+                    if (!should_pop)                                                                                                                                \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_045: [ If condition_function returns false, TQUEUE_POP_BATCH(T) shall set the state to USED by using interlocked_exchange and return TQUEUE_POP_REJECTED. ]*/ \
+                        (void)interlocked_exchange(&segment[index].state, QUEUE_ENTRY_STATE_USED);                                                                  \
+                        result = TQUEUE_POP_REJECTED;                                                                                                               \
+                    }                                                                                                                                               \
+                    else                                                                                                                                            \
+                    {                                                                                                                                               \
+                        int64_t queue_item_count = TQUEUE_GET_POSITION(current_head) - tail_position;                                                               \
+                        uint32_t max_pop_count = (queue_item_count < item_count) ? (uint32_t)queue_item_count : item_count;                                         \
+                        uint32_t popping_count;                                                                                                                     \
+                        for (popping_count = 1; popping_count < max_pop_count; popping_count++)                                                                     \
+                        {                                                                                                                                           \
+                            uint32_t next_index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position + popping_count);             \
+                            /* Codes_SRS_TQUEUE_12_046: [ Using interlocked_compare_exchange, TQUEUE_POP_BATCH(T) shall set the state of the array entries following the tail in the same segment to POPPING (from USED), stopping at item_count items, at the head or at the first entry whose state is not USED. ]*/ \
+                            if (interlocked_compare_exchange(&segment[next_index].state, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED) != QUEUE_ENTRY_STATE_USED) \
                             {                                                                                                                                       \
-                                (void)memmove(&tqueue_ptr->queue[new_tail_index], &tqueue_ptr->queue[tail_index], sizeof(TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)) * copy_item_count); \
+                                break;                                                                                                                              \
                             }                                                                                                                                       \
-                            for (uint32_t i = tail_index; i < new_tail_index; i++)                                                                                  \
+                        }                                                                                                                                           \
+                                                                                                                                                                    \
+                        /* Codes_SRS_TQUEUE_12_047: [ TQUEUE_POP_BATCH(T) shall replace the tail value with the tail value obtained earlier + the number of array entries whose state was changed to POPPING, in the segment of these array entries, by using interlocked_compare_exchange_64. ]*/ \
+                        if (interlocked_compare_exchange_64(&tqueue_ptr->tail, TQUEUE_MAKE_HEAD_OR_TAIL(segment_index, tail_position + popping_count), current_tail) != current_tail) \
+                        {                                                                                                                                           \
+                            for (uint32_t i = 0; i < popping_count; i++)                                                                                            \
                             {                                                                                                                                       \
-                                (void)interlocked_exchange(&tqueue_ptr->queue[i].state, QUEUE_ENTRY_STATE_NOT_USED);                                                \
+                                /* Codes_SRS_TQUEUE_12_048: [ If changing the tail by using interlocked_compare_exchange_64 does not succeed, TQUEUE_POP_BATCH(T) shall revert the state of all the array entries whose state was changed to POPPING to USED and retry. ]*/ \
+                                (void)interlocked_exchange(&segment[TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position + i)].state, QUEUE_ENTRY_STATE_USED); \
                             }                                                                                                                                       \
-                            (void)interlocked_exchange_64(&tqueue_ptr->tail, new_tail_index);                                                                       \
-                            (void)interlocked_exchange_64(&tqueue_ptr->head, new_tail_index + elements_in_queue);                                                   \
-                            tqueue_ptr->queue_size = new_queue_size;                                                                                                \
+                            continue;                                                                                                                               \
                         }                                                                                                                                           \
+                        else                                                                                                                                        \
+                        {                                                                                                                                           \
+                            for (uint32_t i = 0; i < popping_count; i++)                                                                                            \
+                            {                                                                                                                                       \
+                                index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position + i);                                   \
+                                if (tqueue_ptr->copy_item_function == NULL)                                                                                         \
+                                {                                                                                                                                   \
+                                    /* Codes_SRS_TQUEUE_12_049: [ If a copy_item_function was not specified in TQUEUE_CREATE(T), TQUEUE_POP_BATCH(T) shall copy each array entry value whose state was changed to POPPING to the corresponding item in items. ]*/ \
+                                    (void)memcpy((void*)&items[i], (void*)&segment[index].value, sizeof(T));                                                        \
+                                }                                                                                                                                   \
+                                else                                                                                                                                \
+                                {                                                                                                                                   \
+                                    /* Codes_SRS_TQUEUE_12_050: [ If a copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_POP_BATCH(T) shall call copy_item_function for each array entry whose state was changed to POPPING with copy_item_function_context as context, a pointer to the corresponding item in items as pop_dst and a pointer to the array entry value as pop_src. ]*/ \
+                                    tqueue_ptr->copy_item_function(copy_item_function_context, &items[i], (T*)&segment[index].value);                               \
+                                }                                                                                                                                   \
+                                if (tqueue_ptr->dispose_item_function != NULL)                                                                                      \
+                                {                                                                                                                                   \
+                                    /* Codes_SRS_TQUEUE_12_051: [ If a dispose_item_function was specified in TQUEUE_CREATE(T), TQUEUE_POP_BATCH(T) shall call dispose_item_function for each array entry whose state was changed to POPPING with dispose_item_function_context as context and a pointer to the array entry value as item. ]*/ \
+                                    tqueue_ptr->dispose_item_function(tqueue_ptr->dispose_item_function_context, (T*)&segment[index].value);                        \
+                                }                                                                                                                                   \
+                                /* Codes_SRS_TQUEUE_12_052: [ TQUEUE_POP_BATCH(T) shall set the state of each array entry to NOT_USED by using interlocked_exchange. ]*/ \
+                                (void)interlocked_exchange(&segment[index].state, QUEUE_ENTRY_STATE_NOT_USED);                                                      \
+                            }                                                                                                                                       \
+                            /* Codes_SRS_TQUEUE_12_061: [ TQUEUE_POP_BATCH(T) shall obtain the number of threads waiting in TQUEUE_PUSH_WAIT(T) by calling interlocked_add. ]*/ \
+                            if (interlocked_add(&tqueue_ptr->push_waiter_count, 0) > 0)                                                                             \
+                            {                                                                                                                                       \
+                                /* Codes_SRS_TQUEUE_12_062: [ If there are threads waiting in TQUEUE_PUSH_WAIT(T), TQUEUE_POP_BATCH(T) shall increment the push wait sequence by calling interlocked_increment and wake all the threads by calling wake_by_address_all. ]*/ \
+                                (void)interlocked_increment(&tqueue_ptr->push_wait_sequence);                                                                       \
+                                wake_by_address_all(&tqueue_ptr->push_wait_sequence);                                                                               \
+                            }                                                                                                                                       \
+                            /* Codes_SRS_TQUEUE_12_053: [ TQUEUE_POP_BATCH(T) shall set popped_item_count to the number of popped items, succeed and return TQUEUE_POP_OK. ]*/ \
+                            *popped_item_count = popping_count;                                                                                                     \
+                            result = TQUEUE_POP_OK;                                                                                                                 \
+                        }                                                                                                                                           \
+                    }                                                                                                                                               \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+            }                                                                                                                                                       \
+        } while (1);                                                                                                                                                \
+        TQUEUE_LL_UNPROTECT_SEGMENTS_NAME(C)(tqueue_ptr, epoch_parity);                                                                                             \
+        if (result == TQUEUE_POP_OK)                                                                                                                                \
+        {                                                                                                                                                           \
+            TQUEUE_LL_COUNT_LOW_OCCUPANCY_POP_NAME(C)(tqueue_ptr);                                                                                                  \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_push when there is only one producer*/
+#define TQUEUE_LL_PUSH_SINGLE_PRODUCER_DEFINE(C, T)                                                                                                                 \
+/*pushes item in the queue, move_item skips the copy_item_function (used by tqueue_push_move)*/                                                                     \
+static TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH_ITEM_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, T* item, void* copy_item_function_context, bool move_item)                \
+{                                                                                                                                                                   \
+    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
+    /* Codes_SRS_TQUEUE_12_097: [ The single producer TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/ \
+    do                                                                                                                                                              \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_202: [ The single producer TQUEUE_PUSH(T) shall read the current head of the queue without interlocked operations (only the single producer changes it) and the current tail of the queue by calling interlocked_load_acquire_64. ]*/ \
+        /* only this thread changes the head, the acquire read of the tail pairs with the release of the tail by the consumer, so the entries it released can be reused */ \
+        int64_t current_head = tqueue_ptr->head;                                                                                                                    \
+        int64_t current_tail = interlocked_load_acquire_64(&tqueue_ptr->tail);                                                                                      \
+        int64_t head_position = TQUEUE_GET_POSITION(current_head);                                                                                                  \
+        uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_head);                                                                                            \
+        if (head_position >= TQUEUE_GET_POSITION(current_tail) + tqueue_ptr->max_size)                                                                              \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_099: [ If the queue holds max queue size items, the single producer TQUEUE_PUSH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/      \
+            result = TQUEUE_PUSH_QUEUE_FULL;                                                                                                                        \
+            break;                                                                                                                                                  \
+        }                                                                                                                                                           \
+        else if (head_position >= TQUEUE_GET_POSITION(current_tail) + TQUEUE_GET_SEGMENT_SIZE(tqueue_ptr->queue_size, segment_index))                               \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_100: [ If the queue holds at least as many items as the size of the head segment, the single producer TQUEUE_PUSH(T) shall grow the queue the same way TQUEUE_PUSH(T) does and retry. ]*/ \
+            if (TQUEUE_LL_GROW_NAME(C)(tqueue_ptr, current_head) != 0)                                                                                              \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_101: [ If growing the queue fails, the single producer TQUEUE_PUSH(T) shall return TQUEUE_PUSH_ERROR. ]*/                    \
+                LogError(MU_TOSTRING(TQUEUE_LL_GROW_NAME(C)) "(tqueue_ptr=%p, current_head=%" PRId64 ") failed", tqueue_ptr, current_head);                         \
+                result = TQUEUE_PUSH_ERROR;                                                                                                                         \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+            continue;                                                                                                                                               \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_219: [ TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T) and the single producer TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall shrink the queue as described below and retry if the head was moved. ]*/ \
+        /* only this thread moves the head, the consumer cannot use the segments of the bank it leaves because the queue is empty */                                \
+        else if (TQUEUE_LL_SHRINK_NAME(C)(tqueue_ptr, current_head, current_tail, true))                                                                            \
+        {                                                                                                                                                           \
+            continue;                                                                                                                                               \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            /* the consumer is done with an entry and has set it to NOT_USED before it publishes the tail past it, so once that tail is read the entry at the head can be written */ \
+            TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = tqueue_ptr->segments[segment_index];                                                                        \
+            uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, head_position);                                                  \
+            if (move_item || (tqueue_ptr->copy_item_function == NULL))                                                                                              \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_165: [ TQUEUE_PUSH_MOVE(T) shall push item the same way TQUEUE_PUSH(T) does, except that it shall always copy the value of item into the array entry value and it shall not call copy_item_function. ]*/ \
+                /* Codes_SRS_TQUEUE_12_102: [ If no copy_item_function was specified in TQUEUE_CREATE(T), the single producer TQUEUE_PUSH(T) shall copy the value of item into the array entry value corresponding to the head. ]*/ \
+                (void)memcpy((void*)&segment[index].value, (void*)item, sizeof(T));                                                                                 \
+            }                                                                                                                                                       \
+            else                                                                                                                                                    \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_103: [ If a copy_item_function was specified in TQUEUE_CREATE(T), the single producer TQUEUE_PUSH(T) shall call the copy_item_function with copy_item_function_context as context, a pointer to the array entry value corresponding to the head as push_dst and item as push_src. ]*/ \
+                tqueue_ptr->copy_item_function(copy_item_function_context, &segment[index].value, item);                                                            \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_203: [ The single producer TQUEUE_PUSH(T) shall set the state of the array entry to USED by calling interlocked_store_release. ]*/ \
+            interlocked_store_release(&segment[index].state, QUEUE_ENTRY_STATE_USED);                                                                               \
+            /* Codes_SRS_TQUEUE_12_204: [ The single producer TQUEUE_PUSH(T) shall publish the item by setting the head to the head value obtained earlier + 1 with interlocked_store_release_64. ]*/ \
+            interlocked_store_release_64(&tqueue_ptr->head, current_head + 1);                                                                                      \
+            /* the waiter count is still read with interlocked_add: it is a full barrier, so it cannot be read before the head is published and miss a waiter */    \
+            /* Codes_SRS_TQUEUE_12_106: [ The single producer TQUEUE_PUSH(T) shall obtain the number of threads waiting in TQUEUE_POP_WAIT(T) by calling interlocked_add. ]*/ \
+            if (interlocked_add(&tqueue_ptr->pop_waiter_count, 0) > 0)                                                                                              \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_107: [ If there are threads waiting in TQUEUE_POP_WAIT(T), the single producer TQUEUE_PUSH(T) shall increment the pop wait sequence by calling interlocked_increment and wake one of the threads by calling wake_by_address_single. ]*/ \
+                (void)interlocked_increment(&tqueue_ptr->pop_wait_sequence);                                                                                        \
+                wake_by_address_single(&tqueue_ptr->pop_wait_sequence);                                                                                             \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_178: [ After pushing, TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall update the high water mark with the number of items in the queue (the new head position - the tail position obtained earlier). ]*/ \
+            TQUEUE_LL_UPDATE_HIGH_WATER_MARK_NAME(C)(tqueue_ptr, head_position + 1 - TQUEUE_GET_POSITION(current_tail));                                            \
+            /* Codes_SRS_TQUEUE_12_108: [ The single producer TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/                                           \
+            result = TQUEUE_PUSH_OK;                                                                                                                                \
+            break;                                                                                                                                                  \
+        }                                                                                                                                                           \
+    } while (1);                                                                                                                                                    \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH(C)(TQUEUE_LL(T) tqueue, T* item, void* copy_item_function_context)                                                                \
+{                                                                                                                                                                   \
+    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_095: [ If tqueue is NULL then the single producer TQUEUE_PUSH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                  \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_096: [ If item is NULL then the single producer TQUEUE_PUSH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                    \
+        (item == NULL)                                                                                                                                              \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, const " MU_TOSTRING(T) "* item=%p, void* copy_item_function_context=%p",              \
+            tqueue, item, copy_item_function_context);                                                                                                              \
+        result = TQUEUE_PUSH_INVALID_ARG;                                                                                                                           \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        result = TQUEUE_LL_PUSH_ITEM_NAME(C)(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue), item, copy_item_function_context, false);                               \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_pop when there is only one consumer*/
+#define TQUEUE_LL_POP_SINGLE_CONSUMER_DEFINE(C, T)                                                                                                                  \
+/*pops an item from the queue, move_item skips the copy_item_function and the dispose_item_function (used by tqueue_pop_move)*/                                     \
+static TQUEUE_POP_RESULT TQUEUE_LL_POP_ITEM_NAME(C)(TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr, T* item, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context, bool move_item) \
+{                                                                                                                                                                   \
+    TQUEUE_POP_RESULT result;                                                                                                                                       \
+    /* Codes_SRS_TQUEUE_12_111: [ The single consumer TQUEUE_POP(T) shall execute the following actions until it is either able to pop the item from the queue or the queue is empty: ]*/ \
+    do                                                                                                                                                              \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_205: [ The single consumer TQUEUE_POP(T) shall read the current tail of the queue without interlocked operations (only the single consumer changes it) and the current head of the queue by calling interlocked_load_acquire_64. ]*/ \
+        /* only this thread changes the tail, the acquire reads of the head and of the entry states pair with the release of the head or of the entry state by the producers */ \
+        int64_t current_tail = tqueue_ptr->tail;                                                                                                                    \
+        int64_t current_head = interlocked_load_acquire_64(&tqueue_ptr->head);                                                                                      \
+        int64_t tail_position = TQUEUE_GET_POSITION(current_tail);                                                                                                  \
+        if (tail_position >= TQUEUE_GET_POSITION(current_head))                                                                                                     \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_113: [ If the queue is empty (current tail position >= current head position), the single consumer TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/ \
+            result = TQUEUE_POP_QUEUE_EMPTY;                                                                                                                        \
+            break;                                                                                                                                                  \
+        }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_220: [ TQUEUE_POP(T), TQUEUE_POP_BATCH(T) and the single consumer TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall move the tail to the bank of the head as described below and try again if the tail was moved. ]*/ \
+        else if (TQUEUE_LL_FOLLOW_HEAD_BANK_NAME(C)(tqueue_ptr, current_head, current_tail, true))                                                                  \
+        {                                                                                                                                                           \
+            continue;                                                                                                                                               \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_tail);                                                                                        \
+            TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = tqueue_ptr->segments[segment_index];                                                                        \
+            uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position);                                                  \
+            if (                                                                                                                                                    \
+                (interlocked_load_acquire(&segment[index].state) != QUEUE_ENTRY_STATE_USED) &&                                                                      \
+                (segment_index < TQUEUE_GET_SEGMENT_INDEX(current_head))                                                                                            \
+               )                                                                                                                                                    \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_114: [ If the state of the array entry corresponding to the tail is not USED and the head is in a later segment than the tail, the single consumer TQUEUE_POP(T) shall use the array entry corresponding to the tail position in the segment following the tail segment. ]*/ \
+                segment_index++;                                                                                                                                    \
+                segment = tqueue_ptr->segments[segment_index];                                                                                                      \
+                index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position);                                                       \
+            }                                                                                                                                                       \
+                                                                                                                                                                    \
+            if (interlocked_load_acquire(&segment[index].state) != QUEUE_ENTRY_STATE_USED)                                                                          \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_206: [ If the state of the array entry, obtained by calling interlocked_load_acquire, is not USED, the single consumer TQUEUE_POP(T) shall try again. ]*/ \
+                /* a producer moved the head, but it did not finish writing the item yet */                                                                         \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            else                                                                                                                                                    \
+            {                                                                                                                                                       \
+                bool should_pop;                                                                                                                                    \
+                if (condition_function != NULL)                                                                                                                     \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_116: [ If condition_function is not NULL, the single consumer TQUEUE_POP(T) shall call condition_function with condition_function_context and a pointer to the array entry value. ]*/ \
+                    should_pop = condition_function(condition_function_context, (T*)&segment[index].value);                                                         \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    should_pop = true;                                                                                                                              \
+                }                                                                                                                                                   \
+                if (!should_pop)                                                                                                                                    \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_117: [ If condition_function returns false, the single consumer TQUEUE_POP(T) shall return TQUEUE_POP_REJECTED. ]*/      \
+                    result = TQUEUE_POP_REJECTED;                                                                                                                   \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    if (move_item || (tqueue_ptr->copy_item_function == NULL))                                                                                      \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_170: [ TQUEUE_POP_MOVE(T) shall pop an item the same way TQUEUE_POP(T) does, except that it shall always copy the array entry value to item and it shall call neither copy_item_function nor dispose_item_function. ]*/ \
+                        /* Codes_SRS_TQUEUE_12_118: [ If no copy_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP(T) shall copy the array entry value to item. ]*/ \
+                        (void)memcpy((void*)item, (void*)&segment[index].value, sizeof(T));                                                                         \
+                    }                                                                                                                                               \
+                    else                                                                                                                                            \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_119: [ If a copy_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP(T) shall call copy_item_function with copy_item_function_context as context, item as pop_dst and a pointer to the array entry value as pop_src. ]*/ \
+                        tqueue_ptr->copy_item_function(copy_item_function_context, item, (T*)&segment[index].value);                                                \
+                    }                                                                                                                                               \
+                    if (!move_item && (tqueue_ptr->dispose_item_function != NULL))                                                                                  \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_120: [ If a dispose_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP(T) shall call dispose_item_function with dispose_item_function_context as context and a pointer to the array entry value as item. ]*/ \
+                        tqueue_ptr->dispose_item_function(tqueue_ptr->dispose_item_function_context, (T*)&segment[index].value);                                    \
+                    }                                                                                                                                               \
+                    /* Codes_SRS_TQUEUE_12_207: [ The single consumer TQUEUE_POP(T) shall set the state of the array entry to NOT_USED by calling interlocked_store_release. ]*/ \
+                    interlocked_store_release(&segment[index].state, QUEUE_ENTRY_STATE_NOT_USED);                                                                   \
+                    /* Codes_SRS_TQUEUE_12_208: [ The single consumer TQUEUE_POP(T) shall release the array entry by setting the tail to the tail position obtained earlier + 1, in the segment of the array entry, with interlocked_store_release_64. ]*/ \
+                    interlocked_store_release_64(&tqueue_ptr->tail, TQUEUE_MAKE_HEAD_OR_TAIL(segment_index, tail_position + 1));                                    \
+                    /* like in the single producer push, the full barrier of interlocked_add keeps this read after the tail store */                                \
+                    /* Codes_SRS_TQUEUE_12_123: [ The single consumer TQUEUE_POP(T) shall obtain the number of threads waiting in TQUEUE_PUSH_WAIT(T) by calling interlocked_add. ]*/ \
+                    if (interlocked_add(&tqueue_ptr->push_waiter_count, 0) > 0)                                                                                     \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_124: [ If there are threads waiting in TQUEUE_PUSH_WAIT(T), the single consumer TQUEUE_POP(T) shall increment the push wait sequence by calling interlocked_increment and wake one of the threads by calling wake_by_address_single. ]*/ \
+                        (void)interlocked_increment(&tqueue_ptr->push_wait_sequence);                                                                               \
+                        wake_by_address_single(&tqueue_ptr->push_wait_sequence);                                                                                    \
+                    }                                                                                                                                               \
+                    /* Codes_SRS_TQUEUE_12_125: [ The single consumer TQUEUE_POP(T) shall succeed and return TQUEUE_POP_OK. ]*/                                     \
+                    result = TQUEUE_POP_OK;                                                                                                                         \
+                }                                                                                                                                                   \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+        }                                                                                                                                                           \
+    } while (1);                                                                                                                                                    \
+    if (result == TQUEUE_POP_OK)                                                                                                                                    \
+    {                                                                                                                                                               \
+        TQUEUE_LL_COUNT_LOW_OCCUPANCY_POP_NAME(C)(tqueue_ptr);                                                                                                      \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+                                                                                                                                                                    \
+TQUEUE_POP_RESULT TQUEUE_LL_POP(C)(TQUEUE_LL(T) tqueue, T* item, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context) \
+{                                                                                                                                                                   \
+    TQUEUE_POP_RESULT result;                                                                                                                                       \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_109: [ If tqueue is NULL then the single consumer TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                    \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_110: [ If item is NULL then the single consumer TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                      \
+        (item == NULL)                                                                                                                                              \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* item=%p, void* copy_item_function_context=%p, TQUEUE_CONDITION_FUNC(" MU_TOSTRING(T) ") condition_function=%p, void* condition_function_context=%p", \
+            tqueue, item, copy_item_function_context, condition_function, condition_function_context);                                                              \
+        result = TQUEUE_POP_INVALID_ARG;                                                                                                                            \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        result = TQUEUE_LL_POP_ITEM_NAME(C)(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue), item, copy_item_function_context, condition_function, condition_function_context, false); \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_push_batch when there is only one producer*/
+#define TQUEUE_LL_PUSH_BATCH_SINGLE_PRODUCER_DEFINE(C, T)                                                                                                           \
+TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH_BATCH(C)(TQUEUE_LL(T) tqueue, T* items, uint32_t item_count, void* copy_item_function_context, uint32_t* pushed_item_count)       \
+{                                                                                                                                                                   \
+    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_126: [ If tqueue is NULL then the single producer TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/            \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_127: [ If items is NULL then the single producer TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/             \
+        (items == NULL) ||                                                                                                                                          \
+        /* Codes_SRS_TQUEUE_12_128: [ If item_count is 0 then the single producer TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/           \
+        (item_count == 0) ||                                                                                                                                        \
+        /* Codes_SRS_TQUEUE_12_129: [ If pushed_item_count is NULL then the single producer TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/ \
+        (pushed_item_count == NULL)                                                                                                                                 \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* items=%p, uint32_t item_count=%" PRIu32 ", void* copy_item_function_context=%p, uint32_t* pushed_item_count=%p", \
+            tqueue, items, item_count, copy_item_function_context, pushed_item_count);                                                                              \
+        result = TQUEUE_PUSH_INVALID_ARG;                                                                                                                           \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                         \
+        /* Codes_SRS_TQUEUE_12_130: [ The single producer TQUEUE_PUSH_BATCH(T) shall execute the following actions until it is either able to push at least one item in the queue or the queue is full: ]*/ \
+        do                                                                                                                                                          \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_209: [ The single producer TQUEUE_PUSH_BATCH(T) shall read the current head of the queue without interlocked operations (only the single producer changes it) and the current tail of the queue by calling interlocked_load_acquire_64. ]*/ \
+            int64_t current_head = tqueue_ptr->head;                                                                                                                \
+            int64_t current_tail = interlocked_load_acquire_64(&tqueue_ptr->tail);                                                                                  \
+            int64_t head_position = TQUEUE_GET_POSITION(current_head);                                                                                              \
+            uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_head);                                                                                        \
+            int64_t queue_item_count = head_position - TQUEUE_GET_POSITION(current_tail);                                                                           \
+            int64_t segment_size = TQUEUE_GET_SEGMENT_SIZE(tqueue_ptr->queue_size, segment_index);                                                                  \
+            if (queue_item_count >= tqueue_ptr->max_size)                                                                                                           \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_132: [ If the queue holds max queue size items, the single producer TQUEUE_PUSH_BATCH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/ \
+                result = TQUEUE_PUSH_QUEUE_FULL;                                                                                                                    \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+            else if (queue_item_count >= segment_size)                                                                                                              \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_133: [ If the queue holds at least as many items as the size of the head segment, the single producer TQUEUE_PUSH_BATCH(T) shall grow the queue the same way TQUEUE_PUSH(T) does and retry. ]*/ \
+                if (TQUEUE_LL_GROW_NAME(C)(tqueue_ptr, current_head) != 0)                                                                                          \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_134: [ If growing the queue fails, the single producer TQUEUE_PUSH_BATCH(T) shall return TQUEUE_PUSH_ERROR. ]*/          \
+                    LogError(MU_TOSTRING(TQUEUE_LL_GROW_NAME(C)) "(tqueue_ptr=%p, current_head=%" PRId64 ") failed", tqueue_ptr, current_head);                     \
+                    result = TQUEUE_PUSH_ERROR;                                                                                                                     \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_219: [ TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T) and the single producer TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall shrink the queue as described below and retry if the head was moved. ]*/ \
+            else if (TQUEUE_LL_SHRINK_NAME(C)(tqueue_ptr, current_head, current_tail, true))                                                                        \
+            {                                                                                                                                                       \
+                continue;                                                                                                                                           \
+            }                                                                                                                                                       \
+            else                                                                                                                                                    \
+            {                                                                                                                                                       \
+                TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = tqueue_ptr->segments[segment_index];                                                                    \
+                /* Codes_SRS_TQUEUE_12_135: [ The single producer TQUEUE_PUSH_BATCH(T) shall push at most item_count items, without exceeding the max queue size and the size of the head segment. ]*/ \
+                int64_t free_entry_count = ((tqueue_ptr->max_size < segment_size) ? tqueue_ptr->max_size : segment_size) - queue_item_count;                        \
+                uint32_t push_count = (free_entry_count < item_count) ? (uint32_t)free_entry_count : item_count;                                                    \
+                for (uint32_t i = 0; i < push_count; i++)                                                                                                           \
+                {                                                                                                                                                   \
+                    uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, head_position + i);                                      \
+                    if (tqueue_ptr->copy_item_function == NULL)                                                                                                     \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_136: [ If no copy_item_function was specified in TQUEUE_CREATE(T), the single producer TQUEUE_PUSH_BATCH(T) shall copy the value of each pushed item into its array entry value. ]*/ \
+                        (void)memcpy((void*)&segment[index].value, (void*)&items[i], sizeof(T));                                                                    \
                     }                                                                                                                                               \
-                                                                                                                                                                    \
-                    /* Codes_SRS_TQUEUE_01_065: [ TQUEUE_PUSH(T) shall release in exclusive mode the lock used to guard the growing of the queue. ] */              \
-                    srw_lock_ll_release_exclusive(&tqueue_ptr->resize_lock);                                                                                        \
-                    /* Codes_SRS_TQUEUE_01_066: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */                 \
-                    srw_lock_ll_acquire_shared(&tqueue_ptr->resize_lock);                                                                                           \
-                    continue;                                                                                                                                       \
+                    else                                                                                                                                            \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_137: [ If a copy_item_function was specified in TQUEUE_CREATE(T), the single producer TQUEUE_PUSH_BATCH(T) shall call the copy_item_function for each pushed item with copy_item_function_context as context, a pointer to its array entry value as push_dst and a pointer to the item as push_src. ]*/ \
+                        tqueue_ptr->copy_item_function(copy_item_function_context, &segment[index].value, &items[i]);                                               \
+                    }                                                                                                                                               \
+                    /* Codes_SRS_TQUEUE_12_210: [ The single producer TQUEUE_PUSH_BATCH(T) shall set the state of each array entry to USED by calling interlocked_store_release. ]*/ \
+                    interlocked_store_release(&segment[index].state, QUEUE_ENTRY_STATE_USED);                                                                       \
                 }                                                                                                                                                   \
+                /* Codes_SRS_TQUEUE_12_211: [ The single producer TQUEUE_PUSH_BATCH(T) shall publish the items by setting the head to the head value obtained earlier + the number of pushed items with interlocked_store_release_64. ]*/ \
+                interlocked_store_release_64(&tqueue_ptr->head, current_head + push_count);                                                                         \
+                /* Codes_SRS_TQUEUE_12_140: [ The single producer TQUEUE_PUSH_BATCH(T) shall obtain the number of threads waiting in TQUEUE_POP_WAIT(T) by calling interlocked_add. ]*/ \
+                if (interlocked_add(&tqueue_ptr->pop_waiter_count, 0) > 0)                                                                                          \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_141: [ If there are threads waiting in TQUEUE_POP_WAIT(T), the single producer TQUEUE_PUSH_BATCH(T) shall increment the pop wait sequence by calling interlocked_increment and wake all the threads by calling wake_by_address_all. ]*/ \
+                    (void)interlocked_increment(&tqueue_ptr->pop_wait_sequence);                                                                                    \
+                    wake_by_address_all(&tqueue_ptr->pop_wait_sequence);                                                                                            \
+                }                                                                                                                                                   \
+                /* Codes_SRS_TQUEUE_12_178: [ After pushing, TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall update the high water mark with the number of items in the queue (the new head position - the tail position obtained earlier). ]*/ \
+                TQUEUE_LL_UPDATE_HIGH_WATER_MARK_NAME(C)(tqueue_ptr, queue_item_count + push_count);                                                                \
+                /* Codes_SRS_TQUEUE_12_142: [ The single producer TQUEUE_PUSH_BATCH(T) shall set pushed_item_count to the number of pushed items, succeed and return TQUEUE_PUSH_OK. ]*/ \
+                *pushed_item_count = push_count;                                                                                                                    \
+                result = TQUEUE_PUSH_OK;                                                                                                                            \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+        } while (1);                                                                                                                                                \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_pop_batch when there is only one consumer*/
+#define TQUEUE_LL_POP_BATCH_SINGLE_CONSUMER_DEFINE(C, T)                                                                                                            \
+TQUEUE_POP_RESULT TQUEUE_LL_POP_BATCH(C)(TQUEUE_LL(T) tqueue, T* items, uint32_t item_count, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context, uint32_t* popped_item_count) \
+{                                                                                                                                                                   \
+    TQUEUE_POP_RESULT result;                                                                                                                                       \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_143: [ If tqueue is NULL then the single consumer TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/              \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_144: [ If items is NULL then the single consumer TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/               \
+        (items == NULL) ||                                                                                                                                          \
+        /* Codes_SRS_TQUEUE_12_145: [ If item_count is 0 then the single consumer TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/             \
+        (item_count == 0) ||                                                                                                                                        \
+        /* Codes_SRS_TQUEUE_12_146: [ If popped_item_count is NULL then the single consumer TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/   \
+        (popped_item_count == NULL)                                                                                                                                 \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* items=%p, uint32_t item_count=%" PRIu32 ", void* copy_item_function_context=%p, TQUEUE_CONDITION_FUNC(T) condition_function=%p, void* condition_function_context=%p, uint32_t* popped_item_count=%p", \
+            tqueue, items, item_count, copy_item_function_context, condition_function, condition_function_context, popped_item_count);                              \
+        result = TQUEUE_POP_INVALID_ARG;                                                                                                                            \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                         \
+        /* Codes_SRS_TQUEUE_12_147: [ The single consumer TQUEUE_POP_BATCH(T) shall execute the following actions until it is either able to pop at least one item from the queue or the queue is empty: ]*/ \
+        do                                                                                                                                                          \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_212: [ The single consumer TQUEUE_POP_BATCH(T) shall read the current tail of the queue without interlocked operations (only the single consumer changes it) and the current head of the queue by calling interlocked_load_acquire_64. ]*/ \
+            int64_t current_tail = tqueue_ptr->tail;                                                                                                                \
+            int64_t current_head = interlocked_load_acquire_64(&tqueue_ptr->head);                                                                                  \
+            int64_t tail_position = TQUEUE_GET_POSITION(current_tail);                                                                                              \
+            if (tail_position >= TQUEUE_GET_POSITION(current_head))                                                                                                 \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_149: [ If the queue is empty (current tail position >= current head position), the single consumer TQUEUE_POP_BATCH(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/ \
+                result = TQUEUE_POP_QUEUE_EMPTY;                                                                                                                    \
+                break;                                                                                                                                              \
+            }                                                                                                                                                       \
+            /* Codes_SRS_TQUEUE_12_220: [ TQUEUE_POP(T), TQUEUE_POP_BATCH(T) and the single consumer TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall move the tail to the bank of the head as described below and try again if the tail was moved. ]*/ \
+            else if (TQUEUE_LL_FOLLOW_HEAD_BANK_NAME(C)(tqueue_ptr, current_head, current_tail, true))                                                              \
+            {                                                                                                                                                       \
+                continue;                                                                                                                                           \
             }                                                                                                                                                       \
             else                                                                                                                                                    \
             {                                                                                                                                                       \
-                uint32_t index = (uint32_t)(current_head % tqueue_ptr->queue_size);                                                                                 \
-                /* Codes_SRS_TQUEUE_01_017: [ Using interlocked_compare_exchange, TQUEUE_PUSH(T) shall change the head array entry state to PUSHING (from NOT_USED). ]*/ \
-                if (interlocked_compare_exchange(&tqueue_ptr->queue[index].state, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED) != QUEUE_ENTRY_STATE_NOT_USED) \
+                /* Codes_SRS_TQUEUE_12_150: [ The single consumer TQUEUE_POP_BATCH(T) shall use the array entry corresponding to the tail, looking in the segment following the tail segment like the single consumer TQUEUE_POP(T) does when the head is in a later segment than the tail. ]*/ \
+                uint32_t segment_index = TQUEUE_GET_SEGMENT_INDEX(current_tail);                                                                                    \
+                TQUEUE_ENTRY_STRUCT_TYPE_NAME(T)* segment = tqueue_ptr->segments[segment_index];                                                                    \
+                uint32_t index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position);                                              \
+                if (                                                                                                                                                \
+                    (interlocked_load_acquire(&segment[index].state) != QUEUE_ENTRY_STATE_USED) &&                                                                  \
+                    (segment_index < TQUEUE_GET_SEGMENT_INDEX(current_head))                                                                                        \
+                   )                                                                                                                                                \
                 {                                                                                                                                                   \
-                    /* Codes_SRS_TQUEUE_01_023: [ If the state of the array entry corresponding to the head is not NOT_USED, TQUEUE_PUSH(T) shall retry the whole push. ]*/ \
-                    /* likely queue full */                                                                                                                         \
+                    segment_index++;                                                                                                                                \
+                    segment = tqueue_ptr->segments[segment_index];                                                                                                  \
+                    index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position);                                                   \
+                }                                                                                                                                                   \
+                                                                                                                                                                    \
+                if (interlocked_load_acquire(&segment[index].state) != QUEUE_ENTRY_STATE_USED)                                                                      \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_213: [ If the state of the array entry, obtained by calling interlocked_load_acquire, is not USED, the single consumer TQUEUE_POP_BATCH(T) shall try again. ]*/ \
                     continue;                                                                                                                                       \
                 }                                                                                                                                                   \
                 else                                                                                                                                                \
                 {                                                                                                                                                   \
-                    /* Codes_SRS_TQUEUE_01_018: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH(T) shall replace the head value with the head value obtained earlier + 1. ]*/ \
-                    if (interlocked_compare_exchange_64(&tqueue_ptr->head, current_head + 1, current_head) != current_head)                                         \
+                    bool should_pop;                                                                                                                                \
+                    if (condition_function != NULL)                                                                                                                 \
                     {                                                                                                                                               \
-                        /* Codes_SRS_TQUEUE_01_043: [ If the queue head has changed, TQUEUE_PUSH(T) shall set the state back to NOT_USED and retry the push. ]*/    \
-                        (void)interlocked_exchange(&tqueue_ptr->queue[index].state, QUEUE_ENTRY_STATE_NOT_USED);                                                    \
-                        continue;                                                                                                                                   \
+                        /* Codes_SRS_TQUEUE_12_152: [ If condition_function is not NULL, the single consumer TQUEUE_POP_BATCH(T) shall call condition_function with condition_function_context and a pointer to the array entry value of the first item only. ]*/ \
+                        should_pop = condition_function(condition_function_context, (T*)&segment[index].value);                                                     \
                     }                                                                                                                                               \
                     else                                                                                                                                            \
                     {                                                                                                                                               \
-                        if (tqueue_ptr->copy_item_function == NULL)                                                                                                 \
+                        should_pop = true;                                                                                                                          \
+                    }                                                                                                                                               \
+                    if (!should_pop)                                                                                                                                \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_153: [ If condition_function returns false, the single consumer TQUEUE_POP_BATCH(T) shall return TQUEUE_POP_REJECTED. ]*/ \
+                        result = TQUEUE_POP_REJECTED;                                                                                                               \
+                    }                                                                                                                                               \
+                    else                                                                                                                                            \
+                    {                                                                                                                                               \
+                        /* Codes_SRS_TQUEUE_12_154: [ The single consumer TQUEUE_POP_BATCH(T) shall pop the array entries following the tail in the same segment, stopping at item_count items, at the head, at the size of the segment or at the first entry whose state is not USED. ]*/ \
+                        /* the entries are not claimed with POPPING, so going around the segment would find the first item again */                                 \
+                        int64_t queue_item_count = TQUEUE_GET_POSITION(current_head) - tail_position;                                                               \
+                        int64_t segment_size = TQUEUE_GET_SEGMENT_SIZE(tqueue_ptr->queue_size, segment_index);                                                      \
+                        int64_t max_pop_count = (queue_item_count < segment_size) ? queue_item_count : segment_size;                                                \
+                        if (max_pop_count > item_count)                                                                                                             \
                         {                                                                                                                                           \
-                            /* Codes_SRS_TQUEUE_01_019: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall copy the value of item into the array entry value whose state was changed to PUSHING. ]*/ \
-                            (void)memcpy((void*)&tqueue_ptr->queue[index].value, (void*)item, sizeof(T));                                                           \
+                            max_pop_count = item_count;                                                                                                             \
                         }                                                                                                                                           \
-                        else                                                                                                                                        \
+                        uint32_t pop_count;                                                                                                                         \
+                        for (pop_count = 0; pop_count < max_pop_count; pop_count++)                                                                                 \
+                        {                                                                                                                                           \
+                            index = TQUEUE_GET_SEGMENT_ENTRY_INDEX(tqueue_ptr->queue_size, segment_index, tail_position + pop_count);                               \
+                            if (interlocked_load_acquire(&segment[index].state) != QUEUE_ENTRY_STATE_USED)                                                          \
+                            {                                                                                                                                       \
+                                break;                                                                                                                              \
+                            }                                                                                                                                       \
+                            if (tqueue_ptr->copy_item_function == NULL)                                                                                             \
+                            {                                                                                                                                       \
+                                /* Codes_SRS_TQUEUE_12_155: [ If a copy_item_function was not specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP_BATCH(T) shall copy each popped array entry value to the corresponding item in items. ]*/ \
+                                (void)memcpy((void*)&items[pop_count], (void*)&segment[index].value, sizeof(T));                                                    \
+                            }                                                                                                                                       \
+                            else                                                                                                                                    \
+                            {                                                                                                                                       \
+                                /* Codes_SRS_TQUEUE_12_156: [ If a copy_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP_BATCH(T) shall call copy_item_function for each popped array entry with copy_item_function_context as context, a pointer to the corresponding item in items as pop_dst and a pointer to the array entry value as pop_src. ]*/ \
+                                tqueue_ptr->copy_item_function(copy_item_function_context, &items[pop_count], (T*)&segment[index].value);                           \
+                            }                                                                                                                                       \
+                            if (tqueue_ptr->dispose_item_function != NULL)                                                                                          \
+                            {                                                                                                                                       \
+                                /* Codes_SRS_TQUEUE_12_157: [ If a dispose_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP_BATCH(T) shall call dispose_item_function for each popped array entry with dispose_item_function_context as context and a pointer to the array entry value as item. ]*/ \
+                                tqueue_ptr->dispose_item_function(tqueue_ptr->dispose_item_function_context, (T*)&segment[index].value);                            \
+                            }                                                                                                                                       \
+                            /* Codes_SRS_TQUEUE_12_214: [ The single consumer TQUEUE_POP_BATCH(T) shall set the state of each popped array entry to NOT_USED by calling interlocked_store_release. ]*/ \
+                            interlocked_store_release(&segment[index].state, QUEUE_ENTRY_STATE_NOT_USED);                                                           \
+                        }                                                                                                                                           \
+                        /* Codes_SRS_TQUEUE_12_215: [ The single consumer TQUEUE_POP_BATCH(T) shall release the popped array entries by setting the tail to the tail position obtained earlier + the number of popped items, in the segment of the popped array entries, with interlocked_store_release_64. ]*/ \
+                        interlocked_store_release_64(&tqueue_ptr->tail, TQUEUE_MAKE_HEAD_OR_TAIL(segment_index, tail_position + pop_count));                        \
+                        /* Codes_SRS_TQUEUE_12_160: [ The single consumer TQUEUE_POP_BATCH(T) shall obtain the number of threads waiting in TQUEUE_PUSH_WAIT(T) by calling interlocked_add. ]*/ \
+                        if (interlocked_add(&tqueue_ptr->push_waiter_count, 0) > 0)                                                                                 \
                         {                                                                                                                                           \
-                            /* Codes_SRS_TQUEUE_01_024: [ If a copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall call the copy_item_function with copy_item_function_context as context, a pointer to the array entry value whose state was changed to PUSHING as push_dst and item as push_src. ] */ \
-                            tqueue_ptr->copy_item_function(copy_item_function_context, &tqueue_ptr->queue[index].value, item);                                      \
+                            /* Codes_SRS_TQUEUE_12_161: [ If there are threads waiting in TQUEUE_PUSH_WAIT(T), the single consumer TQUEUE_POP_BATCH(T) shall increment the push wait sequence by calling interlocked_increment and wake all the threads by calling wake_by_address_all. ]*/ \
+                            (void)interlocked_increment(&tqueue_ptr->push_wait_sequence);                                                                           \
+                            wake_by_address_all(&tqueue_ptr->push_wait_sequence);                                                                                   \
                         }                                                                                                                                           \
-                        /* Codes_SRS_TQUEUE_01_020: [ TQUEUE_PUSH(T) shall set the state to USED by using interlocked_exchange. ]*/                                 \
-                        (void)interlocked_exchange(&tqueue_ptr->queue[index].state, QUEUE_ENTRY_STATE_USED);                                                        \
-                        /* Codes_SRS_TQUEUE_01_021: [ TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/                                                   \
-                        result = TQUEUE_PUSH_OK;                                                                                                                    \
-                        break;                                                                                                                                      \
+                        /* Codes_SRS_TQUEUE_12_162: [ The single consumer TQUEUE_POP_BATCH(T) shall set popped_item_count to the number of popped items, succeed and return TQUEUE_POP_OK. ]*/ \
+                        *popped_item_count = pop_count;                                                                                                             \
+                        result = TQUEUE_POP_OK;                                                                                                                     \
                     }                                                                                                                                               \
+                    break;                                                                                                                                          \
                 }                                                                                                                                                   \
             }                                                                                                                                                       \
         } while (1);                                                                                                                                                \
-                                                                                                                                                                    \
-        /* Codes_SRS_TQUEUE_01_059: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ] */                             \
-        if (unlock_needed)                                                                                                                                          \
+        if (result == TQUEUE_POP_OK)                                                                                                                                \
         {                                                                                                                                                           \
-            srw_lock_ll_release_shared(&tqueue_ptr->resize_lock);                                                                                                   \
+            TQUEUE_LL_COUNT_LOW_OCCUPANCY_POP_NAME(C)(tqueue_ptr);                                                                                                  \
         }                                                                                                                                                           \
     }                                                                                                                                                               \
     return result;                                                                                                                                                  \
 }                                                                                                                                                                   \
 
-/*introduces a function definition for tqueue_pop*/
-#define TQUEUE_LL_POP_DEFINE(C, T)                                                                                                                                  \
-TQUEUE_POP_RESULT TQUEUE_LL_POP(C)(TQUEUE_LL(T) tqueue, T* item, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context) \
+/*introduces a function definition for tqueue_push_wait*/
+#define TQUEUE_LL_PUSH_WAIT_DEFINE(C, T)                                                                                                                            \
+TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH_WAIT(C)(TQUEUE_LL(T) tqueue, T* item, void* copy_item_function_context, uint32_t timeout_ms)                                      \
+{                                                                                                                                                                   \
+    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_063: [ If tqueue is NULL then TQUEUE_PUSH_WAIT(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                 \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_064: [ If item is NULL then TQUEUE_PUSH_WAIT(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                   \
+        (item == NULL)                                                                                                                                              \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* item=%p, void* copy_item_function_context=%p, uint32_t timeout_ms=%" PRIu32 "", \
+            tqueue, item, copy_item_function_context, timeout_ms);                                                                                                  \
+        result = TQUEUE_PUSH_INVALID_ARG;                                                                                                                           \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_065: [ TQUEUE_PUSH_WAIT(T) shall push the item by calling TQUEUE_PUSH(T). ]*/                                                        \
+        result = TQUEUE_LL_PUSH(C)(tqueue, item, copy_item_function_context);                                                                                       \
+        if (result != TQUEUE_PUSH_QUEUE_FULL)                                                                                                                       \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_066: [ If TQUEUE_PUSH(T) does not return TQUEUE_PUSH_QUEUE_FULL, TQUEUE_PUSH_WAIT(T) shall return the result of TQUEUE_PUSH(T). ]*/ \
+        }                                                                                                                                                           \
+        else if (timeout_ms == 0)                                                                                                                                   \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_067: [ If timeout_ms is 0, TQUEUE_PUSH_WAIT(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/                                          \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                     \
+            /* Codes_SRS_TQUEUE_12_068: [ TQUEUE_PUSH_WAIT(T) shall call timer_global_get_elapsed_ms to determine the start time of the wait. ]*/                   \
+            double start_time_ms = timer_global_get_elapsed_ms();                                                                                                   \
+            /* Codes_SRS_TQUEUE_12_069: [ TQUEUE_PUSH_WAIT(T) shall increment the push waiter count by calling interlocked_increment. ]*/                           \
+            (void)interlocked_increment(&tqueue_ptr->push_waiter_count);                                                                                            \
+            /* Codes_SRS_TQUEUE_12_070: [ TQUEUE_PUSH_WAIT(T) shall execute the following actions until the item is pushed, the queue stays full for timeout_ms or waiting fails: ]*/ \
+            do                                                                                                                                                      \
+            {                                                                                                                                                       \
+                /* Codes_SRS_TQUEUE_12_071: [ TQUEUE_PUSH_WAIT(T) shall obtain the push wait sequence by calling interlocked_add. ]*/                               \
+                int32_t current_wait_sequence = interlocked_add(&tqueue_ptr->push_wait_sequence, 0);                                                                \
+                /* Codes_SRS_TQUEUE_12_072: [ TQUEUE_PUSH_WAIT(T) shall push the item by calling TQUEUE_PUSH(T). ]*/                                                \
+                result = TQUEUE_LL_PUSH(C)(tqueue, item, copy_item_function_context);                                                                               \
+                if (result != TQUEUE_PUSH_QUEUE_FULL)                                                                                                               \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_073: [ If TQUEUE_PUSH(T) does not return TQUEUE_PUSH_QUEUE_FULL, TQUEUE_PUSH_WAIT(T) shall return the result of TQUEUE_PUSH(T). ]*/ \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+                                                                                                                                                                    \
+                uint32_t remaining_ms;                                                                                                                              \
+                if (timeout_ms == UINT32_MAX)                                                                                                                       \
+                {                                                                                                                                                   \
+                    remaining_ms = UINT32_MAX;                                                                                                                      \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_074: [ If timeout_ms is not UINT32_MAX, TQUEUE_PUSH_WAIT(T) shall call timer_global_get_elapsed_ms to compute the elapsed time since the start and if the elapsed time is greater than or equal to timeout_ms it shall return TQUEUE_PUSH_QUEUE_FULL. ]*/ \
+                    double elapsed_ms = timer_global_get_elapsed_ms() - start_time_ms;                                                                              \
+                    if (elapsed_ms < 0.0)                                                                                                                           \
+                    {                                                                                                                                               \
+                        elapsed_ms = 0.0;                                                                                                                           \
+                    }                                                                                                                                               \
+                    if (elapsed_ms >= (double)timeout_ms)                                                                                                           \
+                    {                                                                                                                                               \
+                        break;                                                                                                                                      \
+                    }                                                                                                                                               \
+                    remaining_ms = timeout_ms - (uint32_t)elapsed_ms;                                                                                               \
+                }                                                                                                                                                   \
+                                                                                                                                                                    \
+                /* Codes_SRS_TQUEUE_12_075: [ TQUEUE_PUSH_WAIT(T) shall wait for the push wait sequence to change by calling wait_on_address with timeout_ms minus the elapsed time as timeout (UINT32_MAX if timeout_ms is UINT32_MAX). ]*/ \
+                WAIT_ON_ADDRESS_RESULT wait_result = wait_on_address(&tqueue_ptr->push_wait_sequence, current_wait_sequence, remaining_ms);                         \
+                if (wait_result == WAIT_ON_ADDRESS_OK)                                                                                                              \
+                {                                                                                                                                                   \
+                    /* a pop made room or the value changed before waiting, retry */                                                                                \
+                }                                                                                                                                                   \
+                else if (wait_result == WAIT_ON_ADDRESS_TIMEOUT)                                                                                                    \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_076: [ If wait_on_address returns WAIT_ON_ADDRESS_TIMEOUT, TQUEUE_PUSH_WAIT(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/  \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_077: [ If wait_on_address returns WAIT_ON_ADDRESS_ERROR, TQUEUE_PUSH_WAIT(T) shall fail and return TQUEUE_PUSH_ERROR. ]*/ \
+                    LogError("failure in wait_on_address(&tqueue_ptr->push_wait_sequence=%p, current_wait_sequence=%" PRId32 ", remaining_ms=%" PRIu32 ") result: %" PRI_MU_ENUM "", \
+                        &tqueue_ptr->push_wait_sequence, current_wait_sequence, remaining_ms, MU_ENUM_VALUE(WAIT_ON_ADDRESS_RESULT, wait_result));                  \
+                    result = TQUEUE_PUSH_ERROR;                                                                                                                     \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+            } while (1);                                                                                                                                            \
+            /* Codes_SRS_TQUEUE_12_078: [ TQUEUE_PUSH_WAIT(T) shall decrement the push waiter count by calling interlocked_decrement. ]*/                           \
+            (void)interlocked_decrement(&tqueue_ptr->push_waiter_count);                                                                                            \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_pop_wait*/
+#define TQUEUE_LL_POP_WAIT_DEFINE(C, T)                                                                                                                             \
+TQUEUE_POP_RESULT TQUEUE_LL_POP_WAIT(C)(TQUEUE_LL(T) tqueue, T* item, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context, uint32_t timeout_ms) \
 {                                                                                                                                                                   \
     TQUEUE_POP_RESULT result;                                                                                                                                       \
     if (                                                                                                                                                            \
-        /* Codes_SRS_TQUEUE_01_025: [ If tqueue is NULL then TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                        \
+        /* Codes_SRS_TQUEUE_12_079: [ If tqueue is NULL then TQUEUE_POP_WAIT(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                   \
         (tqueue == NULL) ||                                                                                                                                         \
-        /* Codes_SRS_TQUEUE_01_027: [ If item is NULL then TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                          \
+        /* Codes_SRS_TQUEUE_12_080: [ If item is NULL then TQUEUE_POP_WAIT(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                     \
         (item == NULL)                                                                                                                                              \
        )                                                                                                                                                            \
     {                                                                                                                                                               \
-        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "*=%p, void* copy_item_function_context, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context", \
-            tqueue, item);                                                                                                                                          \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* item=%p, void* copy_item_function_context=%p, TQUEUE_CONDITION_FUNC(" MU_TOSTRING(T) ") condition_function=%p, void* condition_function_context=%p, uint32_t timeout_ms=%" PRIu32 "", \
+            tqueue, item, copy_item_function_context, condition_function, condition_function_context, timeout_ms);                                                  \
         result = TQUEUE_POP_INVALID_ARG;                                                                                                                            \
     }                                                                                                                                                               \
     else                                                                                                                                                            \
     {                                                                                                                                                               \
-        /* Codes_SRS_TQUEUE_01_072: [ TQUEUE_POP(T) shall acquire in shared mode the lock used to guard the growing of the queue. ]*/                               \
-        TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                         \
-        srw_lock_ll_acquire_shared(&tqueue_ptr->resize_lock);                                                                                                       \
+        /* Codes_SRS_TQUEUE_12_081: [ TQUEUE_POP_WAIT(T) shall pop an item by calling TQUEUE_POP(T) with item, copy_item_function_context, condition_function and condition_function_context. ]*/ \
+        result = TQUEUE_LL_POP(C)(tqueue, item, copy_item_function_context, condition_function, condition_function_context);                                        \
+        if (result != TQUEUE_POP_QUEUE_EMPTY)                                                                                                                       \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_082: [ If TQUEUE_POP(T) does not return TQUEUE_POP_QUEUE_EMPTY, TQUEUE_POP_WAIT(T) shall return the result of TQUEUE_POP(T). ]*/ \
+        }                                                                                                                                                           \
+        else if (timeout_ms == 0)                                                                                                                                   \
         {                                                                                                                                                           \
-            /* Codes_SRS_TQUEUE_01_026: [ TQUEUE_POP(T) shall execute the following actions until it is either able to pop the item from the queue or the queue is empty: ] */ \
+            /* Codes_SRS_TQUEUE_12_083: [ If timeout_ms is 0, TQUEUE_POP_WAIT(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/                                           \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                     \
+            /* Codes_SRS_TQUEUE_12_084: [ TQUEUE_POP_WAIT(T) shall call timer_global_get_elapsed_ms to determine the start time of the wait. ]*/                    \
+            double start_time_ms = timer_global_get_elapsed_ms();                                                                                                   \
+            /* Codes_SRS_TQUEUE_12_085: [ TQUEUE_POP_WAIT(T) shall increment the pop waiter count by calling interlocked_increment. ]*/                             \
+            (void)interlocked_increment(&tqueue_ptr->pop_waiter_count);                                                                                             \
+            /* Codes_SRS_TQUEUE_12_086: [ TQUEUE_POP_WAIT(T) shall execute the following actions until an item is popped or rejected, the queue stays empty for timeout_ms or waiting fails: ]*/ \
             do                                                                                                                                                      \
             {                                                                                                                                                       \
-                /* Codes_SRS_TQUEUE_01_028: [ TQUEUE_POP(T) shall obtain the current head queue by calling interlocked_add_64. ]*/                                  \
-                int64_t current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                    \
-                /* Codes_SRS_TQUEUE_01_029: [ TQUEUE_POP(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/                                  \
-                int64_t current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                    \
-                if (current_tail >= current_head)                                                                                                                   \
+                /* Codes_SRS_TQUEUE_12_087: [ TQUEUE_POP_WAIT(T) shall obtain the pop wait sequence by calling interlocked_add. ]*/                                 \
+                int32_t current_wait_sequence = interlocked_add(&tqueue_ptr->pop_wait_sequence, 0);                                                                 \
+                /* Codes_SRS_TQUEUE_12_088: [ TQUEUE_POP_WAIT(T) shall pop an item by calling TQUEUE_POP(T). ]*/                                                    \
+                result = TQUEUE_LL_POP(C)(tqueue, item, copy_item_function_context, condition_function, condition_function_context);                                \
+                if (result != TQUEUE_POP_QUEUE_EMPTY)                                                                                                               \
                 {                                                                                                                                                   \
-                    /* Codes_SRS_TQUEUE_01_035: [ If the queue is empty (current tail >= current head), TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/      \
-                    result = TQUEUE_POP_QUEUE_EMPTY;                                                                                                                \
+                    /* Codes_SRS_TQUEUE_12_089: [ If TQUEUE_POP(T) does not return TQUEUE_POP_QUEUE_EMPTY, TQUEUE_POP_WAIT(T) shall return the result of TQUEUE_POP(T). ]*/ \
                     break;                                                                                                                                          \
+                }                                                                                                                                                   \
+                                                                                                                                                                    \
+                uint32_t remaining_ms;                                                                                                                              \
+                if (timeout_ms == UINT32_MAX)                                                                                                                       \
+                {                                                                                                                                                   \
+                    remaining_ms = UINT32_MAX;                                                                                                                      \
                 }                                                                                                                                                   \
                 else                                                                                                                                                \
                 {                                                                                                                                                   \
-                    /* Codes_SRS_TQUEUE_01_030: [ Using interlocked_compare_exchange, TQUEUE_PUSH(T) shall set the tail array entry state to POPPING (from USED). ]*/ \
-                    uint32_t index = (uint32_t)(current_tail % tqueue_ptr->queue_size);                                                                             \
-                    if (interlocked_compare_exchange(&tqueue_ptr->queue[index].state, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED) != QUEUE_ENTRY_STATE_USED) \
+                    /* Codes_SRS_TQUEUE_12_090: [ If timeout_ms is not UINT32_MAX, TQUEUE_POP_WAIT(T) shall call timer_global_get_elapsed_ms to compute the elapsed time since the start and if the elapsed time is greater than or equal to timeout_ms it shall return TQUEUE_POP_QUEUE_EMPTY. ]*/ \
+                    double elapsed_ms = timer_global_get_elapsed_ms() - start_time_ms;                                                                              \
+                    if (elapsed_ms < 0.0)                                                                                                                           \
                     {                                                                                                                                               \
-                        /* Codes_SRS_TQUEUE_01_036: [ If the state of the array entry corresponding to the tail is not USED, TQUEUE_POP(T) shall try again. ]*/     \
-                        continue;                                                                                                                                   \
+                        elapsed_ms = 0.0;                                                                                                                           \
                     }                                                                                                                                               \
-                    else                                                                                                                                            \
+                    if (elapsed_ms >= (double)timeout_ms)                                                                                                           \
                     {                                                                                                                                               \
-                        bool should_pop;                                                                                                                            \
-                        /* Codes_SRS_TQUEUE_01_039: [ If condition_function is not NULL: ]*/                                                                        \
-                        if (condition_function != NULL)                                                                                                             \
-                        {                                                                                                                                           \
-                            /* Codes_SRS_TQUEUE_01_040: [ TQUEUE_POP(T) shall call condition_function with condition_function_context and a pointer to the array entry value whose state was changed to POPPING. ] */ \
-                            should_pop = condition_function(condition_function_context, (T*)&tqueue_ptr->queue[index].value);                                       \
-                        }                                                                                                                                           \
-                        else                                                                                                                                        \
-                        {                                                                                                                                           \
-                            /* Codes_SRS_TQUEUE_01_042: [ Otherwise, shall proceed with the pop. ]*/                                                                \
-                            should_pop = true;                                                                                                                      \
-                        }                                                                                                                                           \
-                        if (!should_pop)                                                                                                                            \
-                        {                                                                                                                                           \
-                            /* Codes_SRS_TQUEUE_01_041: [ If condition_function returns false, TQUEUE_POP(T) shall set the state to USED by using interlocked_exchange and return TQUEUE_POP_REJECTED. ]*/ \
-                            (void)interlocked_exchange(&tqueue_ptr->queue[index].state, QUEUE_ENTRY_STATE_USED);                                                    \
-                            result = TQUEUE_POP_REJECTED;                                                                                                           \
-                        }                                                                                                                                           \
-                        else                                                                                                                                        \
-                        {                                                                                                                                           \
-                            /* Codes_SRS_TQUEUE_01_031: [ TQUEUE_POP(T) shall replace the tail value with the tail value obtained earlier + 1 by using interlocked_exchange_64. ]*/ \
-                            if (interlocked_compare_exchange_64(&tqueue_ptr->tail, current_tail + 1, current_tail) != current_tail)                                 \
-                            {                                                                                                                                       \
-                                /* Codes_SRS_TQUEUE_01_044: [ If incrementing the tail by using interlocked_compare_exchange_64 does not succeed, TQUEUE_POP(T) shall revert the state of the array entry to USED and retry. ]*/ \
-                                (void)interlocked_exchange(&tqueue_ptr->queue[index].state, QUEUE_ENTRY_STATE_USED);                                                \
-                                continue;                                                                                                                           \
-                            }                                                                                                                                       \
-                            else                                                                                                                                    \
-                            {                                                                                                                                       \
-                                if (tqueue_ptr->copy_item_function == NULL)                                                                                         \
-                                {                                                                                                                                   \
-                                    /* Codes_SRS_TQUEUE_01_032: [ If a copy_item_function was not specified in TQUEUE_CREATE(T): ]*/                                \
-                                    /* Codes_SRS_TQUEUE_01_033: [ TQUEUE_POP(T) shall copy array entry value whose state was changed to POPPING to item. ]*/        \
-                                    (void)memcpy((void*)item, (void*)&tqueue_ptr->queue[index].value, sizeof(T));                                                   \
-                                }                                                                                                                                   \
-                                else                                                                                                                                \
-                                {                                                                                                                                   \
-                                    /* Codes_SRS_TQUEUE_01_037: [ If copy_item_function and sispose_item_function were specified in TQUEUE_CREATE(T): ]*/           \
-                                    /* Codes_SRS_TQUEUE_01_038: [ TQUEUE_POP(T) shall call copy_item_function with copy_item_function_context as context, the array entry value whose state was changed to POPPING to item as pop_src and item as pop_dst. ]*/ \
-                                    tqueue_ptr->copy_item_function(copy_item_function_context, item, (T*)&tqueue_ptr->queue[index].value);                          \
-                                }                                                                                                                                   \
-                                if (tqueue_ptr->dispose_item_function != NULL)                                                                                      \
-                                {                                                                                                                                   \
-                                    /* Codes_SRS_TQUEUE_01_045: [ TQUEUE_POP(T) shall call dispose_item_function with dispose_item_function_context as context and the array entry value whose state was changed to POPPING as item. ]*/ \
-                                    tqueue_ptr->dispose_item_function(tqueue_ptr->dispose_item_function_context, (T*)&tqueue_ptr->queue[index].value);              \
-                                }                                                                                                                                   \
-                                /* Codes_SRS_TQUEUE_01_034: [ TQUEUE_POP(T) shall set the state to NOT_USED by using interlocked_exchange, succeed and return TQUEUE_POP_OK. ]*/ \
-                                (void)interlocked_exchange(&tqueue_ptr->queue[index].state, QUEUE_ENTRY_STATE_NOT_USED);                      \
-                                result = TQUEUE_POP_OK;                                                                                                             \
-                            }                                                                                                                                       \
-                        }                                                                                                                                           \
                         break;                                                                                                                                      \
                     }                                                                                                                                               \
+                    remaining_ms = timeout_ms - (uint32_t)elapsed_ms;                                                                                               \
+                }                                                                                                                                                   \
+                                                                                                                                                                    \
+                /* Codes_SRS_TQUEUE_12_091: [ TQUEUE_POP_WAIT(T) shall wait for the pop wait sequence to change by calling wait_on_address with timeout_ms minus the elapsed time as timeout (UINT32_MAX if timeout_ms is UINT32_MAX). ]*/ \
+                WAIT_ON_ADDRESS_RESULT wait_result = wait_on_address(&tqueue_ptr->pop_wait_sequence, current_wait_sequence, remaining_ms);                          \
+                if (wait_result == WAIT_ON_ADDRESS_OK)                                                                                                              \
+                {                                                                                                                                                   \
+                    /* a push added an item or the value changed before waiting, retry */                                                                           \
+                }                                                                                                                                                   \
+                else if (wait_result == WAIT_ON_ADDRESS_TIMEOUT)                                                                                                    \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_092: [ If wait_on_address returns WAIT_ON_ADDRESS_TIMEOUT, TQUEUE_POP_WAIT(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/   \
+                    break;                                                                                                                                          \
+                }                                                                                                                                                   \
+                else                                                                                                                                                \
+                {                                                                                                                                                   \
+                    /* Codes_SRS_TQUEUE_12_093: [ If wait_on_address returns WAIT_ON_ADDRESS_ERROR, TQUEUE_POP_WAIT(T) shall fail and return TQUEUE_POP_ERROR. ]*/  \
+                    LogError("failure in wait_on_address(&tqueue_ptr->pop_wait_sequence=%p, current_wait_sequence=%" PRId32 ", remaining_ms=%" PRIu32 ") result: %" PRI_MU_ENUM "", \
+                        &tqueue_ptr->pop_wait_sequence, current_wait_sequence, remaining_ms, MU_ENUM_VALUE(WAIT_ON_ADDRESS_RESULT, wait_result));                   \
+                    result = TQUEUE_POP_ERROR;                                                                                                                      \
+                    break;                                                                                                                                          \
                 }                                                                                                                                                   \
             } while (1);                                                                                                                                            \
-            /* Codes_SRS_TQUEUE_01_073: [ TQUEUE_POP(T) shall release in shared mode the lock used to guard the growing of the queue. ] */                          \
-            srw_lock_ll_release_shared(&tqueue_ptr->resize_lock);                                                                                                   \
+            /* Codes_SRS_TQUEUE_12_094: [ TQUEUE_POP_WAIT(T) shall decrement the pop waiter count by calling interlocked_decrement. ]*/                             \
+            (void)interlocked_decrement(&tqueue_ptr->pop_waiter_count);                                                                                             \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_push_move*/
+#define TQUEUE_LL_PUSH_MOVE_DEFINE(C, T)                                                                                                                            \
+TQUEUE_PUSH_RESULT TQUEUE_LL_PUSH_MOVE(C)(TQUEUE_LL(T) tqueue, T* item)                                                                                             \
+{                                                                                                                                                                   \
+    TQUEUE_PUSH_RESULT result;                                                                                                                                      \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_163: [ If tqueue is NULL then TQUEUE_PUSH_MOVE(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                 \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_164: [ If item is NULL then TQUEUE_PUSH_MOVE(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/                                   \
+        (item == NULL)                                                                                                                                              \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* item=%p",                                                         \
+            tqueue, item);                                                                                                                                          \
+        result = TQUEUE_PUSH_INVALID_ARG;                                                                                                                           \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_165: [ TQUEUE_PUSH_MOVE(T) shall push item the same way TQUEUE_PUSH(T) does, except that it shall always copy the value of item into the array entry value and it shall not call copy_item_function. ]*/ \
+        result = TQUEUE_LL_PUSH_ITEM_NAME(C)(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue), item, NULL, true);                                                      \
+        if (result == TQUEUE_PUSH_OK)                                                                                                                               \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_166: [ If the item was pushed, TQUEUE_PUSH_MOVE(T) shall set all the bytes of item to 0, the queue owning the item from now on. ]*/ \
+            (void)memset((void*)item, 0, sizeof(T));                                                                                                                \
         }                                                                                                                                                           \
+        /* Codes_SRS_TQUEUE_12_167: [ TQUEUE_PUSH_MOVE(T) shall return the result of the push. ]*/                                                                  \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_pop_move*/
+#define TQUEUE_LL_POP_MOVE_DEFINE(C, T)                                                                                                                             \
+TQUEUE_POP_RESULT TQUEUE_LL_POP_MOVE(C)(TQUEUE_LL(T) tqueue, T* item, TQUEUE_CONDITION_FUNC(T) condition_function, void* condition_function_context)                \
+{                                                                                                                                                                   \
+    TQUEUE_POP_RESULT result;                                                                                                                                       \
+    if (                                                                                                                                                            \
+        /* Codes_SRS_TQUEUE_12_168: [ If tqueue is NULL then TQUEUE_POP_MOVE(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                   \
+        (tqueue == NULL) ||                                                                                                                                         \
+        /* Codes_SRS_TQUEUE_12_169: [ If item is NULL then TQUEUE_POP_MOVE(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/                                     \
+        (item == NULL)                                                                                                                                              \
+       )                                                                                                                                                            \
+    {                                                                                                                                                               \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p, " MU_TOSTRING(T) "* item=%p, TQUEUE_CONDITION_FUNC(" MU_TOSTRING(T) ") condition_function=%p, void* condition_function_context=%p", \
+            tqueue, item, condition_function, condition_function_context);                                                                                          \
+        result = TQUEUE_POP_INVALID_ARG;                                                                                                                            \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_170: [ TQUEUE_POP_MOVE(T) shall pop an item the same way TQUEUE_POP(T) does, except that it shall always copy the array entry value to item and it shall call neither copy_item_function nor dispose_item_function. ]*/ \
+        /* Codes_SRS_TQUEUE_12_171: [ TQUEUE_POP_MOVE(T) shall return the result of the pop. ]*/                                                                    \
+        result = TQUEUE_LL_POP_ITEM_NAME(C)(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue), item, NULL, condition_function, condition_function_context, true);       \
     }                                                                                                                                                               \
     return result;                                                                                                                                                  \
 }                                                                                                                                                                   \
@@ -516,53 +2176,160 @@ int64_t TQUEUE_LL_GET_VOLATILE_COUNT(C)(TQUEUE_LL(T) tqueue)
     else                                                                                                                                                            \
     {                                                                                                                                                               \
         TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                         \
-        /* Codes_SRS_TQUEUE_01_080: [ TQUEUE_GET_VOLATILE_COUNT(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */               \
-        srw_lock_ll_acquire_shared(&tqueue_ptr->resize_lock);                                                                                                       \
+        int64_t current_tail = 0;                                                                                                                                   \
+        int64_t current_head = 0;                                                                                                                                   \
+        do                                                                                                                                                          \
         {                                                                                                                                                           \
-            int64_t current_tail = 0;                                                                                                                               \
-            int64_t current_head = 0;                                                                                                                               \
-            do                                                                                                                                                      \
-            {                                                                                                                                                       \
-                /* Codes_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/                   \
-                current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                            \
-                /* Codes_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/                   \
-                current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                            \
-                /* Codes_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/   \
-            } while (current_tail != interlocked_add_64(&tqueue_ptr->tail, 0));                                                                                     \
+            /* Codes_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/                       \
+            current_tail = interlocked_add_64(&tqueue_ptr->tail, 0);                                                                                                \
+            /* Codes_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/                       \
+            current_head = interlocked_add_64(&tqueue_ptr->head, 0);                                                                                                \
+            /* Codes_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/ \
+        } while (current_tail != interlocked_add_64(&tqueue_ptr->tail, 0));                                                                                         \
                                                                                                                                                                     \
-            if (current_tail >= current_head)                                                                                                                       \
-            {                                                                                                                                                       \
-                /* Codes_SRS_TQUEUE_22_004: [ If the queue is empty (current tail >= current head), TQUEUE_GET_VOLATILE_COUNT(T) shall return zero. ]*/             \
-                result = 0;                                                                                                                                         \
-            }                                                                                                                                                       \
-            else                                                                                                                                                    \
+        if (TQUEUE_GET_POSITION(current_tail) >= TQUEUE_GET_POSITION(current_head))                                                                                 \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_22_004: [ If the queue is empty (current tail position >= current head position), TQUEUE_GET_VOLATILE_COUNT(T) shall return zero. ]*/ \
+            result = 0;                                                                                                                                             \
+        }                                                                                                                                                           \
+        else                                                                                                                                                        \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/                                                \
+            result = TQUEUE_GET_POSITION(current_head) - TQUEUE_GET_POSITION(current_tail);                                                                         \
+        }                                                                                                                                                           \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
+/*introduces a function definition for tqueue_get_capacity*/
+#define TQUEUE_LL_GET_CAPACITY_DEFINE(C, T)                                                                                                                         \
+int64_t TQUEUE_LL_GET_CAPACITY(C)(TQUEUE_LL(T) tqueue)                                                                                                              \
+{                                                                                                                                                                   \
+    int64_t result;                                                                                                                                                 \
+    if (tqueue == NULL)                                                                                                                                             \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_196: [ If tqueue is NULL then TQUEUE_GET_CAPACITY(T) shall return zero. ]*/                                                          \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p.", tqueue);                                                                            \
+        result = 0;                                                                                                                                                 \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        TQUEUE_TYPEDEF_NAME(T)* tqueue_ptr = THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue);                                                                         \
+        /* Codes_SRS_TQUEUE_12_263: [ TQUEUE_GET_CAPACITY(T) shall obtain the current head by calling interlocked_add_64. ]*/                                       \
+        uint32_t bank = TQUEUE_GET_SEGMENT_BANK(TQUEUE_GET_SEGMENT_INDEX(interlocked_add_64(&tqueue_ptr->head, 0)));                                                \
+        result = 0;                                                                                                                                                 \
+        for (uint32_t i = 0; i < TQUEUE_MAX_SEGMENT_COUNT; i++)                                                                                                     \
+        {                                                                                                                                                           \
+            /* Codes_SRS_TQUEUE_12_264: [ TQUEUE_GET_CAPACITY(T) shall obtain the segments of the bank of the head by calling interlocked_compare_exchange_pointer, stopping at the first segment that is not allocated. ]*/ \
+            /* the segments retired by a shrink are not in the bank of the head anymore */                                                                          \
+            if (interlocked_compare_exchange_pointer((void* volatile_atomic*)&tqueue_ptr->segments[bank + i], NULL, NULL) == NULL)                                  \
             {                                                                                                                                                       \
-                /* Codes_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/                                            \
-                result = current_head - current_tail;                                                                                                               \
+                break;                                                                                                                                              \
             }                                                                                                                                                       \
-            /* Codes_SRS_TQUEUE_01_081: [ TQUEUE_GET_VOLATILE_COUNT(T) shall release in shared mode the lock used to guard the growing of the queue. ] */           \
-            srw_lock_ll_release_shared(&tqueue_ptr->resize_lock);                                                                                                   \
+            /* Codes_SRS_TQUEUE_12_198: [ TQUEUE_GET_CAPACITY(T) shall return the sum of the sizes of the allocated segments. ]*/                                   \
+            result += (int64_t)tqueue_ptr->queue_size << i;                                                                                                         \
         }                                                                                                                                                           \
     }                                                                                                                                                               \
     return result;                                                                                                                                                  \
 }                                                                                                                                                                   \
 
+/*introduces a function definition for tqueue_get_high_water_mark*/
+#define TQUEUE_LL_GET_HIGH_WATER_MARK_DEFINE(C, T)                                                                                                                  \
+int64_t TQUEUE_LL_GET_HIGH_WATER_MARK(C)(TQUEUE_LL(T) tqueue)                                                                                                       \
+{                                                                                                                                                                   \
+    int64_t result;                                                                                                                                                 \
+    if (tqueue == NULL)                                                                                                                                             \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_199: [ If tqueue is NULL then TQUEUE_GET_HIGH_WATER_MARK(T) shall return zero. ]*/                                                   \
+        LogError("Invalid arguments: TQUEUE_LL(" MU_TOSTRING(T) ") tqueue=%p.", tqueue);                                                                            \
+        result = 0;                                                                                                                                                 \
+    }                                                                                                                                                               \
+    else                                                                                                                                                            \
+    {                                                                                                                                                               \
+        /* Codes_SRS_TQUEUE_12_200: [ TQUEUE_GET_HIGH_WATER_MARK(T) shall return the high water mark obtained by calling interlocked_add_64. ]*/                    \
+        result = interlocked_add_64(&THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(T))(tqueue)->high_water_mark, 0);                                                            \
+    }                                                                                                                                                               \
+    return result;                                                                                                                                                  \
+}                                                                                                                                                                   \
+
 /*macro to be used in headers*/                                                                                                     \
 #define TQUEUE_LL_TYPE_DECLARE(C, T, ...)                                                                                           \
     /*hint: have TQUEUE_DEFINE_STRUCT_TYPE(T) before TQUEUE_LL_TYPE_DECLARE*/                                                       \
     THANDLE_LL_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(C), TQUEUE_TYPEDEF_NAME(T))                                                         \
     TQUEUE_LL_CREATE_DECLARE(C, T)                                                                                                  \
+    TQUEUE_LL_CREATE_WITH_SHRINK_DECLARE(C, T)                                                                                      \
     TQUEUE_LL_PUSH_DECLARE(C, T)                                                                                                    \
     TQUEUE_LL_POP_DECLARE(C, T)                                                                                                     \
+    TQUEUE_LL_PUSH_BATCH_DECLARE(C, T)                                                                                              \
+    TQUEUE_LL_POP_BATCH_DECLARE(C, T)                                                                                               \
+    TQUEUE_LL_PUSH_WAIT_DECLARE(C, T)                                                                                               \
+    TQUEUE_LL_POP_WAIT_DECLARE(C, T)                                                                                                \
+    TQUEUE_LL_PUSH_MOVE_DECLARE(C, T)                                                                                               \
+    TQUEUE_LL_POP_MOVE_DECLARE(C, T)                                                                                                \
     TQUEUE_LL_GET_VOLATILE_COUNT_DECLARE(C, T)                                                                                      \
+    TQUEUE_LL_GET_CAPACITY_DECLARE(C, T)                                                                                            \
+    TQUEUE_LL_GET_HIGH_WATER_MARK_DECLARE(C, T)                                                                                     \
 
 /*macro to be used in .c*/                                                                                                          \
 #define TQUEUE_LL_TYPE_DEFINE(C, T, ...)                                                                                            \
     /*hint: have THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(T)) before TQUEUE_LL_TYPE_DEFINE*/                                         \
     TQUEUE_LL_FREE_DEFINE(C, T)                                                                                                     \
+    TQUEUE_LL_GROW_DEFINE(C, T)                                                                                                     \
+    TQUEUE_LL_SHRINK_DEFINE(C, T)                                                                                                   \
+    TQUEUE_LL_PROTECT_SEGMENTS_DEFINE(C, T)                                                                                         \
     TQUEUE_LL_CREATE_DEFINE(C, T)                                                                                                   \
+    TQUEUE_LL_CREATE_WITH_SHRINK_DEFINE(C, T)                                                                                       \
     TQUEUE_LL_PUSH_DEFINE(C, T)                                                                                                     \
     TQUEUE_LL_POP_DEFINE(C, T)                                                                                                      \
+    TQUEUE_LL_PUSH_BATCH_DEFINE(C, T)                                                                                               \
+    TQUEUE_LL_POP_BATCH_DEFINE(C, T)                                                                                                \
+    TQUEUE_LL_PUSH_WAIT_DEFINE(C, T)                                                                                                \
+    TQUEUE_LL_POP_WAIT_DEFINE(C, T)                                                                                                 \
+    TQUEUE_LL_PUSH_MOVE_DEFINE(C, T)                                                                                                \
+    TQUEUE_LL_POP_MOVE_DEFINE(C, T)                                                                                                 \
+    TQUEUE_LL_GET_VOLATILE_COUNT_DEFINE(C, T)                                                                                       \
+    TQUEUE_LL_GET_CAPACITY_DEFINE(C, T)                                                                                             \
+    TQUEUE_LL_GET_HIGH_WATER_MARK_DEFINE(C, T)                                                                                      \
+
+/*macro to be used in .c instead of TQUEUE_LL_TYPE_DEFINE when the queue has a single consumer*/
+#define TQUEUE_LL_MPSC_TYPE_DEFINE(C, T, ...)                                                                                       \
+    /*hint: have THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(T)) before TQUEUE_LL_MPSC_TYPE_DEFINE*/                                    \
+    TQUEUE_LL_FREE_DEFINE(C, T)                                                                                                     \
+    TQUEUE_LL_GROW_DEFINE(C, T)                                                                                                     \
+    TQUEUE_LL_SHRINK_DEFINE(C, T)                                                                                                   \
+    TQUEUE_LL_PROTECT_SEGMENTS_DEFINE(C, T)                                                                                         \
+    TQUEUE_LL_CREATE_DEFINE(C, T)                                                                                                   \
+    TQUEUE_LL_CREATE_WITH_SHRINK_DEFINE(C, T)                                                                                       \
+    TQUEUE_LL_PUSH_DEFINE(C, T)                                                                                                     \
+    TQUEUE_LL_POP_SINGLE_CONSUMER_DEFINE(C, T)                                                                                      \
+    TQUEUE_LL_PUSH_BATCH_DEFINE(C, T)                                                                                               \
+    TQUEUE_LL_POP_BATCH_SINGLE_CONSUMER_DEFINE(C, T)                                                                                \
+    TQUEUE_LL_PUSH_WAIT_DEFINE(C, T)                                                                                                \
+    TQUEUE_LL_POP_WAIT_DEFINE(C, T)                                                                                                 \
+    TQUEUE_LL_PUSH_MOVE_DEFINE(C, T)                                                                                                \
+    TQUEUE_LL_POP_MOVE_DEFINE(C, T)                                                                                                 \
+    TQUEUE_LL_GET_VOLATILE_COUNT_DEFINE(C, T)                                                                                       \
+    TQUEUE_LL_GET_CAPACITY_DEFINE(C, T)                                                                                             \
+    TQUEUE_LL_GET_HIGH_WATER_MARK_DEFINE(C, T)                                                                                      \
+
+/*macro to be used in .c instead of TQUEUE_LL_TYPE_DEFINE when the queue has a single producer and a single consumer*/
+#define TQUEUE_LL_SPSC_TYPE_DEFINE(C, T, ...)                                                                                       \
+    /*hint: have THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(T)) before TQUEUE_LL_SPSC_TYPE_DEFINE*/                                    \
+    TQUEUE_LL_FREE_DEFINE(C, T)                                                                                                     \
+    TQUEUE_LL_GROW_DEFINE(C, T)                                                                                                     \
+    TQUEUE_LL_SHRINK_DEFINE(C, T)                                                                                                   \
+    TQUEUE_LL_CREATE_DEFINE(C, T)                                                                                                   \
+    TQUEUE_LL_CREATE_WITH_SHRINK_DEFINE(C, T)                                                                                       \
+    TQUEUE_LL_PUSH_SINGLE_PRODUCER_DEFINE(C, T)                                                                                     \
+    TQUEUE_LL_POP_SINGLE_CONSUMER_DEFINE(C, T)                                                                                      \
+    TQUEUE_LL_PUSH_BATCH_SINGLE_PRODUCER_DEFINE(C, T)                                                                               \
+    TQUEUE_LL_POP_BATCH_SINGLE_CONSUMER_DEFINE(C, T)                                                                                \
+    TQUEUE_LL_PUSH_WAIT_DEFINE(C, T)                                                                                                \
+    TQUEUE_LL_POP_WAIT_DEFINE(C, T)                                                                                                 \
+    TQUEUE_LL_PUSH_MOVE_DEFINE(C, T)                                                                                                \
+    TQUEUE_LL_POP_MOVE_DEFINE(C, T)                                                                                                 \
     TQUEUE_LL_GET_VOLATILE_COUNT_DEFINE(C, T)                                                                                       \
+    TQUEUE_LL_GET_CAPACITY_DEFINE(C, T)                                                                                             \
+    TQUEUE_LL_GET_HIGH_WATER_MARK_DEFINE(C, T)                                                                                      \
 
 #endif  /*TQUEUE_LL_H*/
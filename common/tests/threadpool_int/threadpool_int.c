@@ -338,6 +338,62 @@ TEST_FUNCTION(MU_C3(scheduling_, N_WORK_ITEMS, _work))
     execution_engine_dec_ref(execution_engine);
 }
 
+#define N_FAN_OUT_ROOT_ITEMS 8
+#define N_FAN_OUT_CHILD_ITEMS 1000
+
+typedef struct FAN_OUT_CONTEXT_TAG
+{
+    THANDLE(THREADPOOL) threadpool;
+    volatile_atomic int32_t execution_counter;
+} FAN_OUT_CONTEXT;
+
+static void fan_out_child_work_function(void* context)
+{
+    FAN_OUT_CONTEXT* fan_out_context = context;
+    (void)interlocked_increment(&fan_out_context->execution_counter);
+    wake_by_address_single(&fan_out_context->execution_counter);
+}
+
+static void fan_out_root_work_function(void* context)
+{
+    FAN_OUT_CONTEXT* fan_out_context = context;
+    for (uint32_t i = 0; i < N_FAN_OUT_CHILD_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(fan_out_context->threadpool, fan_out_child_work_function, fan_out_context));
+    }
+}
+
+TEST_FUNCTION(work_scheduled_from_work_items_is_executed)
+{
+    // assert
+    EXECUTION_ENGINE_PARAMETERS params;
+    params.min_thread_count = 4;
+    params.max_thread_count = 16;
+
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&params);
+    ASSERT_IS_NOT_NULL(execution_engine);
+
+    FAN_OUT_CONTEXT fan_out_context;
+    THANDLE(THREADPOOL) threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+    THANDLE_INITIALIZE_MOVE(THREADPOOL)(&fan_out_context.threadpool, &threadpool);
+    (void)interlocked_exchange(&fan_out_context.execution_counter, 0);
+
+    // act
+    // every root item schedules more items than fit in the queue of a worker
+    for (uint32_t i = 0; i < N_FAN_OUT_ROOT_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(fan_out_context.threadpool, fan_out_root_work_function, &fan_out_context));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(int, INTERLOCKED_HL_OK, InterlockedHL_WaitForValue(&fan_out_context.execution_counter, N_FAN_OUT_ROOT_ITEMS * N_FAN_OUT_CHILD_ITEMS, UINT32_MAX));
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&fan_out_context.threadpool, NULL);
+    execution_engine_dec_ref(execution_engine);
+}
+
 TEST_FUNCTION(MU_C3(scheduling_, N_WORK_ITEMS, _work_items_with_pool_threads))
 {
     // assert
@@ -482,6 +538,52 @@ TEST_FUNCTION(MU_C3(starting_, N_THREADPOOL_TIMERS, _start_timers_work_and_run_p
     execution_engine_dec_ref(execution_engine);
 }
 
+#define N_ONE_SHOT_THREADPOOL_TIMERS 10000
+
+TEST_FUNCTION(MU_C3(starting_, N_ONE_SHOT_THREADPOOL_TIMERS, _one_shot_timers_with_different_delays_runs_each_once))
+{
+    // assert
+    // create an execution engine
+    EXECUTION_ENGINE_PARAMETERS execution_engine_parameters = { 4, 0 };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+
+    // create the threadpool
+    THANDLE(THREADPOOL) threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    // act (start one shot timers with delays spread between 0 and 2 seconds)
+    LogInfo("Starting " MU_TOSTRING(N_ONE_SHOT_THREADPOOL_TIMERS) " one shot timers");
+    THANDLE(THREADPOOL_TIMER)* timers = malloc(N_ONE_SHOT_THREADPOOL_TIMERS * sizeof(THANDLE(THREADPOOL_TIMER)));
+    ASSERT_IS_NOT_NULL(timers);
+    for (uint32_t i = 0; i < N_ONE_SHOT_THREADPOOL_TIMERS; i++)
+    {
+        THANDLE(THREADPOOL_TIMER) timer_temp = threadpool_timer_start(threadpool, (i * 7919) % 2000, 0, work_function, (void*)&g_call_count);
+
+        THANDLE_INITIALIZE_MOVE(THREADPOOL_TIMER)((void*)&timers[i], &timer_temp);
+        ASSERT_IS_NOT_NULL(timers[i]);
+    }
+
+    // assert
+    LogInfo("Waiting for " MU_TOSTRING(N_ONE_SHOT_THREADPOOL_TIMERS) " timers to run");
+    wait_for_greater_or_equal(&g_call_count, N_ONE_SHOT_THREADPOOL_TIMERS, 10000);
+
+    // no timer runs more than once
+    ThreadAPI_Sleep(500);
+    ASSERT_ARE_EQUAL(int64_t, N_ONE_SHOT_THREADPOOL_TIMERS, interlocked_add_64(&g_call_count, 0));
+
+    for (uint32_t i = 0; i < N_ONE_SHOT_THREADPOOL_TIMERS; i++)
+    {
+        THANDLE_ASSIGN(THREADPOOL_TIMER)((void*)&timers[i], NULL);
+    }
+
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+
+    // cleanup
+    free((void*)timers);
+    execution_engine_dec_ref(execution_engine);
+}
+
 TEST_FUNCTION(close_while_items_are_scheduled_still_executes_all_items)
 {
     // assert
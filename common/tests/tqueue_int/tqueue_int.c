@@ -41,6 +41,23 @@ TQUEUE_TYPE_DECLARE(THANDLE(TEST_THANDLE));
 THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(THANDLE(TEST_THANDLE)))
 TQUEUE_TYPE_DEFINE(THANDLE(TEST_THANDLE));
 
+// Queues with a single consumer and with a single producer and a single consumer
+typedef int64_t MPSC_ITEM;
+
+TQUEUE_DEFINE_STRUCT_TYPE(MPSC_ITEM);
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(MPSC_ITEM))
+TQUEUE_TYPE_DECLARE(MPSC_ITEM);
+THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(MPSC_ITEM))
+TQUEUE_MPSC_TYPE_DEFINE(MPSC_ITEM);
+
+typedef int64_t SPSC_ITEM;
+
+TQUEUE_DEFINE_STRUCT_TYPE(SPSC_ITEM);
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(SPSC_ITEM))
+TQUEUE_TYPE_DECLARE(SPSC_ITEM);
+THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(SPSC_ITEM))
+TQUEUE_SPSC_TYPE_DEFINE(SPSC_ITEM);
+
 TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
 TEST_DEFINE_ENUM_TYPE(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_RESULT_VALUES);
 TEST_DEFINE_ENUM_TYPE(TQUEUE_POP_RESULT, TQUEUE_POP_RESULT_VALUES);
@@ -543,6 +560,307 @@ TEST_FUNCTION(TQUEUE_test_with_1_pusher_and_1_popper_queue_size_1)
     TQUEUE_test_with_N_pushers_and_N_poppers_with_queue_size(1, 1, 1, 1);
 }
 
+#define WAIT_TEST_ITEMS_PER_PUSHER 10000
+#define WAIT_TEST_POP_TIMEOUT 10 // ms
+
+typedef struct TQUEUE_WAIT_TEST_CONTEXT_TAG
+{
+    TQUEUE(FOO) queue;
+    int64_t total_item_count;
+    volatile_atomic int64_t popped_count;
+    volatile_atomic int64_t popped_sum;
+} TQUEUE_WAIT_TEST_CONTEXT;
+
+static int wait_pusher_thread_func(void* arg)
+{
+    TQUEUE_WAIT_TEST_CONTEXT* test_context = arg;
+
+    for (int64_t i = 0; i < WAIT_TEST_ITEMS_PER_PUSHER; i++)
+    {
+        FOO item = { i };
+        // blocks while the queue is full, poppers wake it up
+        ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, TQUEUE_PUSH_WAIT(FOO)(test_context->queue, &item, NULL, UINT32_MAX));
+    }
+
+    return 0;
+}
+
+static int wait_popper_thread_func(void* arg)
+{
+    TQUEUE_WAIT_TEST_CONTEXT* test_context = arg;
+    int64_t sum = 0;
+
+    while (interlocked_add_64(&test_context->popped_count, 0) < test_context->total_item_count)
+    {
+        FOO item;
+        // a short timeout so that poppers notice when everything has been popped
+        TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(FOO)(test_context->queue, &item, NULL, NULL, NULL, WAIT_TEST_POP_TIMEOUT);
+        if (result == TQUEUE_POP_OK)
+        {
+            sum += item.x;
+            (void)interlocked_increment_64(&test_context->popped_count);
+        }
+        else
+        {
+            ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+        }
+    }
+
+    (void)interlocked_add_64(&test_context->popped_sum, sum);
+    return 0;
+}
+
+// This test has N pushers and N poppers that block on a small queue instead of spinning and validates that no item is lost or duplicated
+TEST_FUNCTION(MU_C5(TQUEUE_PUSH_WAIT_and_TQUEUE_POP_WAIT_with_, N_THREADS, _pushers_and_, N_THREADS, _poppers_queue_size_4))
+{
+    // arrange
+    TQUEUE_WAIT_TEST_CONTEXT test_context;
+    TQUEUE(FOO) queue = TQUEUE_CREATE(FOO)(4, 4, NULL, NULL, NULL);
+    ASSERT_IS_NOT_NULL(queue);
+    TQUEUE_INITIALIZE_MOVE(FOO)(&test_context.queue, &queue);
+    test_context.total_item_count = (int64_t)N_THREADS * WAIT_TEST_ITEMS_PER_PUSHER;
+    (void)interlocked_exchange_64(&test_context.popped_count, 0);
+    (void)interlocked_exchange_64(&test_context.popped_sum, 0);
+
+    THREAD_HANDLE pusher_threads[N_THREADS];
+    THREAD_HANDLE popper_threads[N_THREADS];
+
+    // act
+    for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&popper_threads[i], wait_popper_thread_func, &test_context));
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&pusher_threads[i], wait_pusher_thread_func, &test_context));
+    }
+
+    for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+        int dont_care;
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(pusher_threads[i], &dont_care));
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(popper_threads[i], &dont_care));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, test_context.total_item_count, interlocked_add_64(&test_context.popped_count, 0));
+    ASSERT_ARE_EQUAL(int64_t, (int64_t)N_THREADS * WAIT_TEST_ITEMS_PER_PUSHER * (WAIT_TEST_ITEMS_PER_PUSHER - 1) / 2, interlocked_add_64(&test_context.popped_sum, 0));
+    ASSERT_ARE_EQUAL(int64_t, 0, TQUEUE_GET_VOLATILE_COUNT(FOO)(test_context.queue));
+
+    // clean
+    TQUEUE_ASSIGN(FOO)(&test_context.queue, NULL);
+}
+
+#define SINGLE_CONSUMER_TEST_ITEMS_PER_PUSHER 100000
+#define SINGLE_CONSUMER_TEST_BATCH_SIZE 8
+
+typedef struct TQUEUE_SPSC_TEST_CONTEXT_TAG
+{
+    TQUEUE(SPSC_ITEM) queue;
+} TQUEUE_SPSC_TEST_CONTEXT;
+
+static int spsc_pusher_thread_func(void* arg)
+{
+    TQUEUE_SPSC_TEST_CONTEXT* test_context = arg;
+    int64_t i = 0;
+
+    while (i < SINGLE_CONSUMER_TEST_ITEMS_PER_PUSHER)
+    {
+        if ((i % 3) == 0)
+        {
+            // push a batch every now and then
+            SPSC_ITEM items[SINGLE_CONSUMER_TEST_BATCH_SIZE];
+            uint32_t item_count = 0;
+            while ((item_count < SINGLE_CONSUMER_TEST_BATCH_SIZE) && (i + item_count < SINGLE_CONSUMER_TEST_ITEMS_PER_PUSHER))
+            {
+                items[item_count] = i + item_count;
+                item_count++;
+            }
+            uint32_t pushed_item_count;
+            TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_ITEM)(test_context->queue, items, item_count, NULL, &pushed_item_count);
+            if (result == TQUEUE_PUSH_OK)
+            {
+                i += pushed_item_count;
+            }
+            else
+            {
+                ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+            }
+        }
+        else
+        {
+            SPSC_ITEM item = i;
+            ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, TQUEUE_PUSH_WAIT(SPSC_ITEM)(test_context->queue, &item, NULL, UINT32_MAX));
+            i++;
+        }
+    }
+
+    return 0;
+}
+
+// This test has one pusher and one popper on a queue that grows from 1 to 64 entries and validates that order is preserved
+TEST_FUNCTION(TQUEUE_SPSC_test_with_1_pusher_and_1_popper_preserves_order)
+{
+    // arrange
+    TQUEUE_SPSC_TEST_CONTEXT test_context;
+    TQUEUE(SPSC_ITEM) queue = TQUEUE_CREATE(SPSC_ITEM)(1, 64, NULL, NULL, NULL);
+    ASSERT_IS_NOT_NULL(queue);
+    TQUEUE_INITIALIZE_MOVE(SPSC_ITEM)(&test_context.queue, &queue);
+
+    THREAD_HANDLE pusher_thread;
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&pusher_thread, spsc_pusher_thread_func, &test_context));
+
+    // act
+    int64_t expected_item = 0;
+    while (expected_item < SINGLE_CONSUMER_TEST_ITEMS_PER_PUSHER)
+    {
+        if ((expected_item % 2) == 0)
+        {
+            SPSC_ITEM items[SINGLE_CONSUMER_TEST_BATCH_SIZE];
+            uint32_t popped_item_count;
+            TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_ITEM)(test_context.queue, items, SINGLE_CONSUMER_TEST_BATCH_SIZE, NULL, NULL, NULL, &popped_item_count);
+            if (result == TQUEUE_POP_OK)
+            {
+                for (uint32_t i = 0; i < popped_item_count; i++)
+                {
+                    ASSERT_ARE_EQUAL(int64_t, expected_item, items[i]);
+                    expected_item++;
+                }
+            }
+            else
+            {
+                ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+            }
+        }
+        else
+        {
+            SPSC_ITEM item;
+            ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, TQUEUE_POP_WAIT(SPSC_ITEM)(test_context.queue, &item, NULL, NULL, NULL, UINT32_MAX));
+            ASSERT_ARE_EQUAL(int64_t, expected_item, item);
+            expected_item++;
+        }
+    }
+
+    int dont_care;
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(pusher_thread, &dont_care));
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 0, TQUEUE_GET_VOLATILE_COUNT(SPSC_ITEM)(test_context.queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_ITEM)(&test_context.queue, NULL);
+}
+
+typedef struct TQUEUE_MPSC_TEST_CONTEXT_TAG
+{
+    TQUEUE(MPSC_ITEM) queue;
+} TQUEUE_MPSC_TEST_CONTEXT;
+
+static int mpsc_pusher_thread_func(void* arg)
+{
+    TQUEUE_MPSC_TEST_CONTEXT* test_context = arg;
+
+    for (int64_t i = 0; i < SINGLE_CONSUMER_TEST_ITEMS_PER_PUSHER; i++)
+    {
+        MPSC_ITEM item = i;
+        ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, TQUEUE_PUSH_WAIT(MPSC_ITEM)(test_context->queue, &item, NULL, UINT32_MAX));
+    }
+
+    return 0;
+}
+
+// This test has N pushers and one popper on a queue that grows from 1 to 64 entries and validates that no item is lost or duplicated
+TEST_FUNCTION(MU_C3(TQUEUE_MPSC_test_with_, N_THREADS, _pushers_and_1_popper))
+{
+    // arrange
+    TQUEUE_MPSC_TEST_CONTEXT test_context;
+    TQUEUE(MPSC_ITEM) queue = TQUEUE_CREATE(MPSC_ITEM)(1, 64, NULL, NULL, NULL);
+    ASSERT_IS_NOT_NULL(queue);
+    TQUEUE_INITIALIZE_MOVE(MPSC_ITEM)(&test_context.queue, &queue);
+
+    THREAD_HANDLE pusher_threads[N_THREADS];
+    for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&pusher_threads[i], mpsc_pusher_thread_func, &test_context));
+    }
+
+    // act
+    int64_t popped_count = 0;
+    int64_t popped_sum = 0;
+    while (popped_count < (int64_t)N_THREADS * SINGLE_CONSUMER_TEST_ITEMS_PER_PUSHER)
+    {
+        MPSC_ITEM items[SINGLE_CONSUMER_TEST_BATCH_SIZE];
+        uint32_t popped_item_count;
+        TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(MPSC_ITEM)(test_context.queue, items, SINGLE_CONSUMER_TEST_BATCH_SIZE, NULL, NULL, NULL, &popped_item_count);
+        if (result == TQUEUE_POP_OK)
+        {
+            for (uint32_t i = 0; i < popped_item_count; i++)
+            {
+                popped_sum += items[i];
+            }
+            popped_count += popped_item_count;
+        }
+        else
+        {
+            ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+            MPSC_ITEM item;
+            result = TQUEUE_POP_WAIT(MPSC_ITEM)(test_context.queue, &item, NULL, NULL, NULL, UINT32_MAX);
+            ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+            popped_sum += item;
+            popped_count++;
+        }
+    }
+
+    for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+        int dont_care;
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(pusher_threads[i], &dont_care));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, (int64_t)N_THREADS * SINGLE_CONSUMER_TEST_ITEMS_PER_PUSHER * (SINGLE_CONSUMER_TEST_ITEMS_PER_PUSHER - 1) / 2, popped_sum);
+    ASSERT_ARE_EQUAL(int64_t, 0, TQUEUE_GET_VOLATILE_COUNT(MPSC_ITEM)(test_context.queue));
+
+    // clean
+    TQUEUE_ASSIGN(MPSC_ITEM)(&test_context.queue, NULL);
+}
+
+static volatile_atomic int32_t test_thandle_dispose_count;
+
+static void TEST_THANDLE_count_dispose(TEST_THANDLE* test_thandle)
+{
+    (void)test_thandle;
+    (void)interlocked_increment(&test_thandle_dispose_count);
+}
+
+// This test checks that TQUEUE_PUSH_MOVE/TQUEUE_POP_MOVE hand over the reference held by the caller instead of taking new ones
+TEST_FUNCTION(TQUEUE_PUSH_MOVE_and_TQUEUE_POP_MOVE_transfer_the_THANDLE_reference)
+{
+    // arrange
+    (void)interlocked_exchange(&test_thandle_dispose_count, 0);
+    TQUEUE(THANDLE(TEST_THANDLE)) queue = TQUEUE_CREATE(THANDLE(TEST_THANDLE))(16, 1024, TEST_THANDLE_copy_item, TEST_THANDLE_dispose, NULL);
+    ASSERT_IS_NOT_NULL(queue);
+    TEST_THANDLE test_thandle = { .a_value = 42 };
+    THANDLE(TEST_THANDLE) item = THANDLE_CREATE_FROM_CONTENT(TEST_THANDLE)(&test_thandle, TEST_THANDLE_count_dispose, NULL);
+    ASSERT_IS_NOT_NULL(item);
+    THANDLE(TEST_THANDLE) popped_item = NULL;
+
+    // act
+    TQUEUE_PUSH_RESULT push_result = TQUEUE_PUSH_MOVE(THANDLE(TEST_THANDLE))(queue, &item);
+    TQUEUE_POP_RESULT pop_result = TQUEUE_POP_MOVE(THANDLE(TEST_THANDLE))(queue, &popped_item, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, push_result);
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, pop_result);
+    ASSERT_IS_NULL(item);
+    ASSERT_IS_NOT_NULL(popped_item);
+    ASSERT_ARE_EQUAL(int64_t, 42, popped_item->a_value);
+
+    // the popped reference is the only one left
+    THANDLE_ASSIGN(TEST_THANDLE)(&popped_item, NULL);
+    ASSERT_ARE_EQUAL(int32_t, 1, interlocked_add(&test_thandle_dispose_count, 0));
+
+    // clean
+    TQUEUE_ASSIGN(THANDLE(TEST_THANDLE))(&queue, NULL);
+}
+
 static bool TEST_THANDLE_should_pop(void* context, THANDLE(TEST_THANDLE)* item)
 {
     (void)context;
@@ -555,8 +873,12 @@ static bool TEST_THANDLE_should_pop(void* context, THANDLE(TEST_THANDLE)* item)
     TQUEUE_ACTION_TYPE_THANDLE_TEST_PUSH, \
     TQUEUE_ACTION_TYPE_THANDLE_TEST_POP, \
     TQUEUE_ACTION_TYPE_THANDLE_TEST_POP_WITH_CONDITION_FUNCTION, \
+    TQUEUE_ACTION_TYPE_THANDLE_TEST_PUSH_BATCH, \
+    TQUEUE_ACTION_TYPE_THANDLE_TEST_POP_BATCH, \
     TQUEUE_ACTION_TYPE_THANDLE_TEST_GET_VOLATILE_COUNT
 
+#define TEST_BATCH_SIZE 4
+
 MU_DEFINE_ENUM_WITHOUT_INVALID(TQUEUE_ACTION_TYPE_THANDLE_TEST, TQUEUE_ACTION_TYPE_THANDLE_TEST_VALUES);
 MU_DEFINE_ENUM_STRINGS_WITHOUT_INVALID(TQUEUE_ACTION_TYPE_THANDLE_TEST, TQUEUE_ACTION_TYPE_THANDLE_TEST_VALUES);
 
@@ -624,6 +946,49 @@ static int tqueue_chaos_thread_THANDLE_func(void* arg)
             }
             break;
         }
+        case TQUEUE_ACTION_TYPE_THANDLE_TEST_PUSH_BATCH:
+        {
+            THANDLE(TEST_THANDLE) items[TEST_BATCH_SIZE];
+            for (uint32_t i = 0; i < TEST_BATCH_SIZE; i++)
+            {
+                TEST_THANDLE test_thandle = { .a_value = interlocked_increment_64(&test_context->next_push_number) };
+                THANDLE(TEST_THANDLE) item = THANDLE_CREATE_FROM_CONTENT(TEST_THANDLE)(&test_thandle, NULL, NULL);
+                THANDLE_INITIALIZE_MOVE(TEST_THANDLE)(&items[i], &item);
+            }
+            uint32_t pushed_item_count = 0;
+            TQUEUE_PUSH_RESULT push_result = TQUEUE_PUSH_BATCH(THANDLE(TEST_THANDLE))(test_context->queue, items, TEST_BATCH_SIZE, NULL, &pushed_item_count);
+            ASSERT_IS_TRUE((push_result == TQUEUE_PUSH_OK) || (push_result == TQUEUE_PUSH_QUEUE_FULL), "TQUEUE_PUSH_BATCH(THANDLE(TEST_THANDLE)) failed with %" PRI_MU_ENUM "", MU_ENUM_VALUE(TQUEUE_PUSH_RESULT, push_result));
+            if (push_result == TQUEUE_PUSH_OK)
+            {
+                ASSERT_IS_TRUE((pushed_item_count >= 1) && (pushed_item_count <= TEST_BATCH_SIZE));
+                (void)interlocked_add_64(&test_context->successful_push_count, pushed_item_count);
+                wake_by_address_single_64(&test_context->successful_push_count);
+            }
+            for (uint32_t i = 0; i < TEST_BATCH_SIZE; i++)
+            {
+                THANDLE_ASSIGN(TEST_THANDLE)(&items[i], NULL);
+            }
+            break;
+        }
+        case TQUEUE_ACTION_TYPE_THANDLE_TEST_POP_BATCH:
+        {
+            THANDLE(TEST_THANDLE) items[TEST_BATCH_SIZE] = { NULL };
+            uint32_t popped_item_count = 0;
+            TQUEUE_POP_RESULT pop_result = TQUEUE_POP_BATCH(THANDLE(TEST_THANDLE))(test_context->queue, items, TEST_BATCH_SIZE, NULL, TEST_THANDLE_should_pop, NULL, &popped_item_count);
+            ASSERT_IS_TRUE((pop_result == TQUEUE_POP_OK) || (pop_result == TQUEUE_POP_QUEUE_EMPTY) || (pop_result == TQUEUE_POP_REJECTED), "TQUEUE_POP_BATCH(THANDLE(TEST_THANDLE)) failed with %" PRI_MU_ENUM "", MU_ENUM_VALUE(TQUEUE_POP_RESULT, pop_result));
+            if (pop_result == TQUEUE_POP_OK)
+            {
+                ASSERT_IS_TRUE((popped_item_count >= 1) && (popped_item_count <= TEST_BATCH_SIZE));
+                for (uint32_t i = 0; i < popped_item_count; i++)
+                {
+                    ASSERT_ARE_NOT_EQUAL(int64_t, -1, items[i]->a_value);
+                    THANDLE_ASSIGN(TEST_THANDLE)(&items[i], NULL);
+                }
+                (void)interlocked_add_64(&test_context->successful_pop_count, popped_item_count);
+                wake_by_address_single_64(&test_context->successful_pop_count);
+            }
+            break;
+        }
         case TQUEUE_ACTION_TYPE_THANDLE_TEST_GET_VOLATILE_COUNT:
         {
             int64_t current_count = TQUEUE_GET_VOLATILE_COUNT(THANDLE(TEST_THANDLE))(test_context->queue);
@@ -0,0 +1,291 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "c_logging/logger.h"
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "testrunnerswitcher.h"
+
+#include "c_pal/timer.h"
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/thandle.h"
+#include "c_pal/tqueue.h"
+
+#define MAX_THREAD_PAIR_COUNT           8
+#define ITEMS_PER_PRODUCER              (1024 * 1024)
+#define QUEUE_SIZE                      1024
+
+typedef struct PERF_ITEM_TAG
+{
+    int64_t value;
+} PERF_ITEM;
+
+// same item, but in a queue with cache line padded entries
+typedef PERF_ITEM PADDED_PERF_ITEM;
+
+// same item, but in a queue with a single consumer
+typedef PERF_ITEM MPSC_PERF_ITEM;
+
+// same item, but in a queue with a single producer and a single consumer
+typedef PERF_ITEM SPSC_PERF_ITEM;
+
+TQUEUE_DEFINE_STRUCT_TYPE(PERF_ITEM);
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(PERF_ITEM))
+TQUEUE_TYPE_DECLARE(PERF_ITEM);
+THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(PERF_ITEM))
+TQUEUE_TYPE_DEFINE(PERF_ITEM);
+
+TQUEUE_DEFINE_PADDED_STRUCT_TYPE(PADDED_PERF_ITEM);
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(PADDED_PERF_ITEM))
+TQUEUE_TYPE_DECLARE(PADDED_PERF_ITEM);
+THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(PADDED_PERF_ITEM))
+TQUEUE_TYPE_DEFINE(PADDED_PERF_ITEM);
+
+TQUEUE_DEFINE_STRUCT_TYPE(MPSC_PERF_ITEM);
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(MPSC_PERF_ITEM))
+TQUEUE_TYPE_DECLARE(MPSC_PERF_ITEM);
+THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(MPSC_PERF_ITEM))
+TQUEUE_MPSC_TYPE_DEFINE(MPSC_PERF_ITEM);
+
+TQUEUE_DEFINE_STRUCT_TYPE(SPSC_PERF_ITEM);
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(SPSC_PERF_ITEM))
+TQUEUE_TYPE_DECLARE(SPSC_PERF_ITEM);
+THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(SPSC_PERF_ITEM))
+TQUEUE_SPSC_TYPE_DEFINE(SPSC_PERF_ITEM);
+
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
+
+/*TQUEUE_PERF_DEFINE_RUN(T) introduces a function that measures the push/pop throughput of a TQUEUE(T) with a number of producers and consumers*/
+#define TQUEUE_PERF_DEFINE_RUN(T)                                                                               \
+typedef struct MU_C2(T, _PERF_CONTEXT_TAG)                                                                      \
+{                                                                                                               \
+    TQUEUE(T) queue;                                                                                            \
+    volatile_atomic int64_t popped_count;                                                                       \
+    volatile_atomic int64_t popped_sum;                                                                         \
+    int64_t total_item_count;                                                                                   \
+} MU_C2(T, _PERF_CONTEXT);                                                                                      \
+                                                                                                                \
+static int MU_C2(T, _producer_thread)(void* arg)                                                                \
+{                                                                                                               \
+    MU_C2(T, _PERF_CONTEXT)* perf_context = arg;                                                                \
+    for (int64_t i = 0; i < ITEMS_PER_PRODUCER; i++)                                                            \
+    {                                                                                                           \
+        T item = { i };                                                                                         \
+        while (TQUEUE_PUSH(T)(perf_context->queue, &item, NULL) == TQUEUE_PUSH_QUEUE_FULL)                      \
+        {                                                                                                       \
+            /* spin, consumers will make room */                                                                \
+        }                                                                                                       \
+    }                                                                                                           \
+    return 0;                                                                                                   \
+}                                                                                                               \
+                                                                                                                \
+static int MU_C2(T, _consumer_thread)(void* arg)                                                                \
+{                                                                                                               \
+    MU_C2(T, _PERF_CONTEXT)* perf_context = arg;                                                                \
+    int64_t sum = 0;                                                                                            \
+    /* the popped items are only added to the shared count when the queue looks empty, so that the count */     \
+    /* does not put a full barrier on every pop and hide the cost of the queue itself */                        \
+    int64_t local_popped_count = 0;                                                                             \
+    while (interlocked_load_acquire_64(&perf_context->popped_count) + local_popped_count < perf_context->total_item_count) \
+    {                                                                                                           \
+        T item;                                                                                                 \
+        if (TQUEUE_POP(T)(perf_context->queue, &item, NULL, NULL, NULL) == TQUEUE_POP_OK)                       \
+        {                                                                                                       \
+            sum += item.value;                                                                                  \
+            local_popped_count++;                                                                               \
+        }                                                                                                       \
+        else if (local_popped_count > 0)                                                                        \
+        {                                                                                                       \
+            (void)interlocked_add_64(&perf_context->popped_count, local_popped_count);                          \
+            local_popped_count = 0;                                                                             \
+        }                                                                                                       \
+        else                                                                                                    \
+        {                                                                                                       \
+            /* nothing to pop */                                                                                \
+        }                                                                                                       \
+    }                                                                                                           \
+    (void)interlocked_add_64(&perf_context->popped_count, local_popped_count);                                  \
+    (void)interlocked_add_64(&perf_context->popped_sum, sum);                                                   \
+    return 0;                                                                                                   \
+}                                                                                                               \
+                                                                                                                \
+static double MU_C2(run_, T)(uint32_t producer_count, uint32_t consumer_count)                                  \
+{                                                                                                               \
+    MU_C2(T, _PERF_CONTEXT) perf_context;                                                                       \
+    TQUEUE(T) queue = TQUEUE_CREATE(T)(QUEUE_SIZE, QUEUE_SIZE, NULL, NULL, NULL);                               \
+    ASSERT_IS_NOT_NULL(queue);                                                                                  \
+    TQUEUE_INITIALIZE_MOVE(T)(&perf_context.queue, &queue);                                                     \
+    (void)interlocked_exchange_64(&perf_context.popped_count, 0);                                               \
+    (void)interlocked_exchange_64(&perf_context.popped_sum, 0);                                                 \
+    perf_context.total_item_count = (int64_t)producer_count * ITEMS_PER_PRODUCER;                               \
+                                                                                                                \
+    THREAD_HANDLE producers[MAX_THREAD_PAIR_COUNT];                                                             \
+    THREAD_HANDLE consumers[MAX_THREAD_PAIR_COUNT];                                                             \
+                                                                                                                \
+    double start_time = timer_global_get_elapsed_ms();                                                          \
+                                                                                                                \
+    for (uint32_t i = 0; i < consumer_count; i++)                                                               \
+    {                                                                                                           \
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&consumers[i], MU_C2(T, _consumer_thread), &perf_context)); \
+    }                                                                                                           \
+    for (uint32_t i = 0; i < producer_count; i++)                                                               \
+    {                                                                                                           \
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&producers[i], MU_C2(T, _producer_thread), &perf_context)); \
+    }                                                                                                           \
+    for (uint32_t i = 0; i < producer_count; i++)                                                               \
+    {                                                                                                           \
+        int dont_care;                                                                                          \
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(producers[i], &dont_care));             \
+    }                                                                                                           \
+    for (uint32_t i = 0; i < consumer_count; i++)                                                               \
+    {                                                                                                           \
+        int dont_care;                                                                                          \
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(consumers[i], &dont_care));             \
+    }                                                                                                           \
+                                                                                                                \
+    double elapsed_ms = timer_global_get_elapsed_ms() - start_time;                                             \
+                                                                                                                \
+    /* every producer pushed 0..ITEMS_PER_PRODUCER-1, nothing was lost or duplicated */                         \
+    ASSERT_ARE_EQUAL(int64_t, (int64_t)producer_count * ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER - 1) / 2, interlocked_add_64(&perf_context.popped_sum, 0)); \
+    ASSERT_ARE_EQUAL(int64_t, 0, TQUEUE_GET_VOLATILE_COUNT(T)(perf_context.queue));                             \
+                                                                                                                \
+    TQUEUE_ASSIGN(T)(&perf_context.queue, NULL);                                                                \
+                                                                                                                \
+    return (double)perf_context.total_item_count * 1000.0 / elapsed_ms;                                         \
+}                                                                                                               \
+                                                                                                                \
+/* pushes and pops QUEUE_SIZE items at a time on the calling thread, so that there is no contention */          \
+/* and the measurement is the cost of the barriers of the push and pop themselves */                            \
+static double MU_C2(run_uncontended_, T)(void)                                                                  \
+{                                                                                                               \
+    TQUEUE(T) queue = TQUEUE_CREATE(T)(QUEUE_SIZE, QUEUE_SIZE, NULL, NULL, NULL);                               \
+    ASSERT_IS_NOT_NULL(queue);                                                                                  \
+                                                                                                                \
+    int64_t sum = 0;                                                                                            \
+    double start_time = timer_global_get_elapsed_ms();                                                          \
+                                                                                                                \
+    for (int64_t round = 0; round < ITEMS_PER_PRODUCER / QUEUE_SIZE; round++)                                   \
+    {                                                                                                           \
+        for (int64_t i = 0; i < QUEUE_SIZE; i++)                                                                \
+        {                                                                                                       \
+            T item = { i };                                                                                     \
+            ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, TQUEUE_PUSH(T)(queue, &item, NULL));           \
+        }                                                                                                       \
+        for (int64_t i = 0; i < QUEUE_SIZE; i++)                                                                \
+        {                                                                                                       \
+            T item;                                                                                             \
+            ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, TQUEUE_POP(T)(queue, &item, NULL, NULL, NULL));  \
+            sum += item.value;                                                                                  \
+        }                                                                                                       \
+    }                                                                                                           \
+                                                                                                                \
+    double elapsed_ms = timer_global_get_elapsed_ms() - start_time;                                             \
+                                                                                                                \
+    ASSERT_ARE_EQUAL(int64_t, (int64_t)(ITEMS_PER_PRODUCER / QUEUE_SIZE) * QUEUE_SIZE * (QUEUE_SIZE - 1) / 2, sum); \
+                                                                                                                \
+    TQUEUE_ASSIGN(T)(&queue, NULL);                                                                             \
+                                                                                                                \
+    return (double)ITEMS_PER_PRODUCER * 1000.0 / elapsed_ms;                                                    \
+}                                                                                                               \
+
+TQUEUE_PERF_DEFINE_RUN(PERF_ITEM)
+TQUEUE_PERF_DEFINE_RUN(PADDED_PERF_ITEM)
+TQUEUE_PERF_DEFINE_RUN(MPSC_PERF_ITEM)
+TQUEUE_PERF_DEFINE_RUN(SPSC_PERF_ITEM)
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+/* MPMC throughput */
+
+TEST_FUNCTION(tqueue_mpmc_push_pop_throughput)
+{
+    // arrange
+
+    // act
+    for (uint32_t thread_pair_count = 1; thread_pair_count <= MAX_THREAD_PAIR_COUNT; thread_pair_count *= 2)
+    {
+        double items_per_second = run_PERF_ITEM(thread_pair_count, thread_pair_count);
+        double padded_items_per_second = run_PADDED_PERF_ITEM(thread_pair_count, thread_pair_count);
+
+        // assert
+        LogInfo("TQUEUE with %" PRIu32 " producers and %" PRIu32 " consumers: %.02f items/s, with padded entries %.02f items/s (%.02fx)",
+            thread_pair_count, thread_pair_count, items_per_second, padded_items_per_second, padded_items_per_second / items_per_second);
+    }
+}
+
+/* MPSC throughput */
+
+TEST_FUNCTION(tqueue_mpsc_push_pop_throughput)
+{
+    // arrange
+
+    // act
+    for (uint32_t producer_count = 1; producer_count <= MAX_THREAD_PAIR_COUNT; producer_count *= 2)
+    {
+        double mpmc_items_per_second = run_PERF_ITEM(producer_count, 1);
+        double mpsc_items_per_second = run_MPSC_PERF_ITEM(producer_count, 1);
+
+        // assert
+        LogInfo("TQUEUE with %" PRIu32 " producers and 1 consumer: MPMC %.02f items/s, MPSC %.02f items/s (%.02fx)",
+            producer_count, mpmc_items_per_second, mpsc_items_per_second, mpsc_items_per_second / mpmc_items_per_second);
+    }
+}
+
+/* SPSC throughput */
+
+TEST_FUNCTION(tqueue_spsc_push_pop_throughput)
+{
+    // arrange
+
+    // act
+    double mpmc_items_per_second = run_PERF_ITEM(1, 1);
+    double mpsc_items_per_second = run_MPSC_PERF_ITEM(1, 1);
+    double spsc_items_per_second = run_SPSC_PERF_ITEM(1, 1);
+
+    // assert
+    LogInfo("TQUEUE with 1 producer and 1 consumer: MPMC %.02f items/s, MPSC %.02f items/s (%.02fx), SPSC %.02f items/s (%.02fx)",
+        mpmc_items_per_second, mpsc_items_per_second, mpsc_items_per_second / mpmc_items_per_second, spsc_items_per_second, spsc_items_per_second / mpmc_items_per_second);
+}
+
+/* uncontended push/pop cost, the SPSC queue does not have a full barrier on its push/pop */
+
+TEST_FUNCTION(tqueue_spsc_uncontended_push_pop_throughput)
+{
+    // arrange
+
+    // act
+    double mpmc_items_per_second = run_uncontended_PERF_ITEM();
+    double mpsc_items_per_second = run_uncontended_MPSC_PERF_ITEM();
+    double spsc_items_per_second = run_uncontended_SPSC_PERF_ITEM();
+
+    // assert
+    LogInfo("TQUEUE push/pop on a single thread: MPMC %.02f items/s, MPSC %.02f items/s (%.02fx), SPSC %.02f items/s (%.02fx)",
+        mpmc_items_per_second, mpsc_items_per_second, mpsc_items_per_second / mpmc_items_per_second, spsc_items_per_second, spsc_items_per_second / mpmc_items_per_second);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
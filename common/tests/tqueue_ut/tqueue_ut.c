@@ -4,9 +4,12 @@
 #include "tqueue_ut_pch.h"
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+MU_DEFINE_ENUM_STRINGS(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT_VALUES)
 
 TEST_DEFINE_ENUM_TYPE(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_RESULT_VALUES)
 TEST_DEFINE_ENUM_TYPE(TQUEUE_POP_RESULT, TQUEUE_POP_RESULT_VALUES)
+TEST_DEFINE_ENUM_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT_VALUES)
 
 // This is the call dispatcher used for most tests
 TQUEUE_DEFINE_STRUCT_TYPE(int32_t);
@@ -15,6 +18,15 @@ TQUEUE_TYPE_DECLARE(int32_t);
 THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(int32_t))
 TQUEUE_TYPE_DEFINE(int32_t);
 
+// This is the call dispatcher used for the single producer/single consumer tests
+typedef int32_t SPSC_INT32;
+
+TQUEUE_DEFINE_STRUCT_TYPE(SPSC_INT32);
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(SPSC_INT32))
+TQUEUE_TYPE_DECLARE(SPSC_INT32);
+THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(SPSC_INT32))
+TQUEUE_SPSC_TYPE_DEFINE(SPSC_INT32);
+
 MOCK_FUNCTION_WITH_CODE(, void, test_copy_item, void*, context, int32_t*, dst, int32_t*, src)
     *dst = *src;
 MOCK_FUNCTION_END();
@@ -45,7 +57,8 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
     REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
-    REGISTER_SRW_LOCK_LL_GLOBAL_MOCK_HOOK();
+
+    REGISTER_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_flex, NULL);
 
@@ -97,6 +110,19 @@ TEST_FUNCTION(TQUEUE_CREATE_with_2_initial_queue_size_and_1_max_queue_size_fails
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/* Tests_SRS_TQUEUE_12_001: [ If initial_queue_size is greater than TQUEUE_MAX_QUEUE_SIZE, TQUEUE_CREATE(T) shall fail and return NULL. ]*/
+TEST_FUNCTION(TQUEUE_CREATE_with_initial_queue_size_greater_than_TQUEUE_MAX_QUEUE_SIZE_fails)
+{
+    // arrange
+
+    // act
+    TQUEUE(int32_t) queue = TQUEUE_CREATE(int32_t)(TQUEUE_MAX_QUEUE_SIZE + 1, UINT32_MAX, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    // assert
+    ASSERT_IS_NULL(queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 /* Tests_SRS_TQUEUE_01_048: [ If any of copy_item_function and dispose_item_function are NULL and at least one of them is not NULL, TQUEUE_CREATE(T) shall fail and return NULL. ]*/
 TEST_FUNCTION(TQUEUE_CREATE_with_only_copy_item_function_being_NULL_fails)
 {
@@ -124,10 +150,13 @@ TEST_FUNCTION(TQUEUE_CREATE_with_only_dispose_item_function_being_NULL_fails)
 }
 
 /* Tests_SRS_TQUEUE_01_049: [ TQUEUE_CREATE(T) shall call THANDLE_MALLOC with TQUEUE_DISPOSE_FUNC(T) as dispose function. ] */
-/* Tests_SRS_TQUEUE_01_050: [ TQUEUE_CREATE(T) shall allocate memory for an array of size size containing elements of type T. ] */
+/* Tests_SRS_TQUEUE_01_050: [ TQUEUE_CREATE(T) shall allocate memory for the first segment of the queue, an array of queue size entries containing elements of type T. ] */
+/* Tests_SRS_TQUEUE_12_216: [ TQUEUE_CREATE(T) shall use the first segment as the first segment of both banks and mark all the other segments as not allocated. ]*/
 /* Tests_SRS_TQUEUE_01_051: [ TQUEUE_CREATE(T) shall initialize the head and tail of the list with 0 by using interlocked_exchange_64. ] */
+/* Tests_SRS_TQUEUE_12_054: [ TQUEUE_CREATE(T) shall initialize the pop waiter count, the pop wait sequence, the push waiter count and the push wait sequence with 0 by using interlocked_exchange. ] */
+/* Tests_SRS_TQUEUE_12_172: [ TQUEUE_CREATE(T) shall initialize the high water mark with 0 by using interlocked_exchange_64. ]*/
+/* Tests_SRS_TQUEUE_12_217: [ TQUEUE_CREATE(T) shall initialize the low occupancy pop count, the reclaim epoch, the operation counts of both epoch parities and the retired segment count with 0 by using interlocked_exchange. ]*/
 /* Tests_SRS_TQUEUE_01_052: [ TQUEUE_CREATE(T) shall initialize the state for each entry in the array used for the queue with NOT_USED by using interlocked_exchange. ] */
-/* Tests_SRS_TQUEUE_01_053: [ TQUEUE_CREATE(T) shall initialize a SRW_LOCK_LL to be used for locking the queue when it needs to grow in size. ] */
 /* Tests_SRS_TQUEUE_01_054: [ TQUEUE_CREATE(T) shall succeed and return a non-NULL value. ] */
 TEST_FUNCTION(TQUEUE_CREATE_with_all_functions_non_NULL_succeeds)
 {
@@ -137,11 +166,20 @@ TEST_FUNCTION(TQUEUE_CREATE_with_all_functions_non_NULL_succeeds)
     STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG)); // array
     STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
     STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0)); // high water mark
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 0
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 1
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
     for (uint32_t i = 0; i < 1; i++)
     {
         STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED));
     }
-    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
 
     // act
     TQUEUE(int32_t) queue = TQUEUE_CREATE(int32_t)(1, 2, test_copy_item, test_dispose_item, (void*)0x4242);
@@ -155,10 +193,13 @@ TEST_FUNCTION(TQUEUE_CREATE_with_all_functions_non_NULL_succeeds)
 }
 
 /* Tests_SRS_TQUEUE_01_049: [ TQUEUE_CREATE(T) shall call THANDLE_MALLOC with TQUEUE_DISPOSE_FUNC(T) as dispose function. ] */
-/* Tests_SRS_TQUEUE_01_050: [ TQUEUE_CREATE(T) shall allocate memory for an array of size size containing elements of type T. ] */
+/* Tests_SRS_TQUEUE_01_050: [ TQUEUE_CREATE(T) shall allocate memory for the first segment of the queue, an array of queue size entries containing elements of type T. ] */
+/* Tests_SRS_TQUEUE_12_216: [ TQUEUE_CREATE(T) shall use the first segment as the first segment of both banks and mark all the other segments as not allocated. ]*/
 /* Tests_SRS_TQUEUE_01_051: [ TQUEUE_CREATE(T) shall initialize the head and tail of the list with 0 by using interlocked_exchange_64. ] */
+/* Tests_SRS_TQUEUE_12_054: [ TQUEUE_CREATE(T) shall initialize the pop waiter count, the pop wait sequence, the push waiter count and the push wait sequence with 0 by using interlocked_exchange. ] */
+/* Tests_SRS_TQUEUE_12_172: [ TQUEUE_CREATE(T) shall initialize the high water mark with 0 by using interlocked_exchange_64. ]*/
+/* Tests_SRS_TQUEUE_12_217: [ TQUEUE_CREATE(T) shall initialize the low occupancy pop count, the reclaim epoch, the operation counts of both epoch parities and the retired segment count with 0 by using interlocked_exchange. ]*/
 /* Tests_SRS_TQUEUE_01_052: [ TQUEUE_CREATE(T) shall initialize the state for each entry in the array used for the queue with NOT_USED by using interlocked_exchange. ] */
-/* Tests_SRS_TQUEUE_01_053: [ TQUEUE_CREATE(T) shall initialize a SRW_LOCK_LL to be used for locking the queue when it needs to grow in size. ] */
 /* Tests_SRS_TQUEUE_01_054: [ TQUEUE_CREATE(T) shall succeed and return a non-NULL value. ] */
 TEST_FUNCTION(TQUEUE_CREATE_with_all_functions_NULL_succeeds)
 {
@@ -168,11 +209,20 @@ TEST_FUNCTION(TQUEUE_CREATE_with_all_functions_NULL_succeeds)
     STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG)); // array
     STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
     STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0)); // high water mark
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 0
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 1
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
     for (uint32_t i = 0; i < 1; i++)
     {
         STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED));
     }
-    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
 
     // act
     TQUEUE(int32_t) queue = TQUEUE_CREATE(int32_t)(1, 2, NULL, NULL, (void*)0x4242);
@@ -185,6 +235,76 @@ TEST_FUNCTION(TQUEUE_CREATE_with_all_functions_NULL_succeeds)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
+/* Tests_SRS_TQUEUE_12_002: [ TQUEUE_CREATE(T) shall use as queue size the smallest power of 2 that is greater or equal to initial_queue_size. ]*/
+/* Tests_SRS_TQUEUE_01_050: [ TQUEUE_CREATE(T) shall allocate memory for the first segment of the queue, an array of queue size entries containing elements of type T. ] */
+/* Tests_SRS_TQUEUE_01_052: [ TQUEUE_CREATE(T) shall initialize the state for each entry in the array used for the queue with NOT_USED by using interlocked_exchange. ] */
+TEST_FUNCTION(TQUEUE_CREATE_with_initial_queue_size_not_a_power_of_2_rounds_up_the_queue_size)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); // THANDLE
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(malloc_2(4, IGNORED_ARG)); // array
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0)); // high water mark
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 0
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 1
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED));
+    }
+
+    // act
+    TQUEUE(int32_t) queue = TQUEUE_CREATE(int32_t)(3, 3, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    // assert
+    ASSERT_IS_NOT_NULL(queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_003: [ If max_queue_size is greater than TQUEUE_MAX_QUEUE_SIZE, TQUEUE_CREATE(T) shall use TQUEUE_MAX_QUEUE_SIZE as the max queue size. ]*/
+TEST_FUNCTION(TQUEUE_CREATE_with_max_queue_size_greater_than_TQUEUE_MAX_QUEUE_SIZE_uses_TQUEUE_MAX_QUEUE_SIZE)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); // THANDLE
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG)); // array
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0)); // high water mark
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 0
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 1
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED));
+
+    // act
+    TQUEUE(int32_t) queue = TQUEUE_CREATE(int32_t)(1, UINT32_MAX, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    // assert
+    ASSERT_IS_NOT_NULL(queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, TQUEUE_MAX_QUEUE_SIZE, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->max_size);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
 /* Tests_SRS_TQUEUE_01_071: [ If there are any failures then TQUEUE_CREATE(T) shall fail and return NULL. ]*/
 TEST_FUNCTION(when_underlying_calls_fail_TQUEUE_CREATE_also_fails)
 {
@@ -197,13 +317,31 @@ TEST_FUNCTION(when_underlying_calls_fail_TQUEUE_CREATE_also_fails)
         .CallCannotFail();
     STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // pop waiter count
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // pop wait sequence
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // push waiter count
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // push wait sequence
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0)) // high water mark
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // low occupancy pop count
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // reclaim epoch
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // operation count of epoch parity 0
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // operation count of epoch parity 1
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // retired segment count
+        .CallCannotFail();
     for (uint32_t i = 0; i < 1024; i++)
     {
         STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED))
             .CallCannotFail();
     }
-    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG))
-        .CallCannotFail();
 
     umock_c_negative_tests_snapshot();
 
@@ -232,11 +370,20 @@ static TQUEUE(int32_t) test_queue_create(uint32_t initial_queue_size, uint32_t m
     STRICT_EXPECTED_CALL(malloc_2(initial_queue_size, IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
     STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0)); // high water mark
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 0
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 1
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
     for (uint32_t i = 0; i < initial_queue_size; i++)
     {
         STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED));
     }
-    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
 
     TQUEUE(int32_t) result = TQUEUE_CREATE(int32_t)(initial_queue_size, max_queue_size, copy_item_function, dispose_item_function, dispose_function_context);
     ASSERT_IS_NOT_NULL(result);
@@ -252,7 +399,6 @@ TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_NULL_dispose_item_returns)
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, (void*)0x4242);
 
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
@@ -266,8 +412,7 @@ TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_NULL_dispose_item_returns)
 /* Tests_SRS_TQUEUE_01_009: [ Otherwise, TQUEUE_DISPOSE_FUNC(T) shall obtain the current queue head by calling interlocked_add_64. ]*/
 /* Tests_SRS_TQUEUE_01_010: [ TQUEUE_DISPOSE_FUNC(T) shall obtain the current queue tail by calling interlocked_add_64. ]*/
 /* Tests_SRS_TQUEUE_01_011: [ For each item in the queue, dispose_item_function shall be called with dispose_item_function_context and a pointer to the array entry value (T*). ]*/
-/* Tests_SRS_TQUEUE_01_056: [ The lock initialized in TQUEUE_CREATE(T) shall be de-initialized. ] */
-/* Tests_SRS_TQUEUE_01_057: [ The array backing the queue shall be freed. ] */
+/* Tests_SRS_TQUEUE_01_057: [ All the segments backing the queue shall be freed. ] */
 TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_non_NULL_dispose_item_with_empty_queue_does_not_call_dispose_item)
 {
     // arrange
@@ -276,7 +421,6 @@ TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_non_NULL_dispose_item_with_empty_queue_do
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
@@ -316,11 +460,53 @@ static int32_t test_queue_pop_rejected(TQUEUE(int32_t) queue)
     return result;
 }
 
+static TQUEUE(SPSC_INT32) test_spsc_queue_create(uint32_t initial_queue_size, uint32_t max_queue_size, TQUEUE_COPY_ITEM_FUNC(SPSC_INT32) copy_item_function, TQUEUE_DISPOSE_ITEM_FUNC(SPSC_INT32) dispose_item_function, void* dispose_function_context)
+{
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, initial_queue_size, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(malloc_2(initial_queue_size, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0)); // high water mark
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 0
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 1
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    for (uint32_t i = 0; i < initial_queue_size; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED));
+    }
+
+    TQUEUE(SPSC_INT32) result = TQUEUE_CREATE(SPSC_INT32)(initial_queue_size, max_queue_size, copy_item_function, dispose_item_function, dispose_function_context);
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+
+    return result;
+}
+
+static void test_spsc_queue_push(TQUEUE(SPSC_INT32) queue, int32_t item)
+{
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, TQUEUE_PUSH(SPSC_INT32)(queue, &item, NULL));
+    umock_c_reset_all_calls();
+}
+
+static int32_t test_spsc_queue_pop(TQUEUE(SPSC_INT32) queue)
+{
+    int32_t result;
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, TQUEUE_POP(SPSC_INT32)(queue, &result, NULL, NULL, NULL));
+    umock_c_reset_all_calls();
+    return result;
+}
+
 /* Tests_SRS_TQUEUE_01_009: [ Otherwise, TQUEUE_DISPOSE_FUNC(T) shall obtain the current queue head by calling interlocked_add_64. ]*/
 /* Tests_SRS_TQUEUE_01_010: [ TQUEUE_DISPOSE_FUNC(T) shall obtain the current queue tail by calling interlocked_add_64. ]*/
 /* Tests_SRS_TQUEUE_01_011: [ For each item in the queue, dispose_item_function shall be called with dispose_item_function_context and a pointer to the array entry value (T*). ]*/
-/* Tests_SRS_TQUEUE_01_056: [ The lock initialized in TQUEUE_CREATE(T) shall be de-initialized. ] */
-/* Tests_SRS_TQUEUE_01_057: [ The array backing the queue shall be freed. ] */
+/* Tests_SRS_TQUEUE_01_057: [ All the segments backing the queue shall be freed. ] */
 TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_non_NULL_dispose_item_with_1_item_calls_dispose_item_once)
 {
     // arrange
@@ -331,7 +517,6 @@ TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_non_NULL_dispose_item_with_1_item_calls_d
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
@@ -345,13 +530,12 @@ TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_non_NULL_dispose_item_with_1_item_calls_d
 /* Tests_SRS_TQUEUE_01_009: [ Otherwise, TQUEUE_DISPOSE_FUNC(T) shall obtain the current queue head by calling interlocked_add_64. ]*/
 /* Tests_SRS_TQUEUE_01_010: [ TQUEUE_DISPOSE_FUNC(T) shall obtain the current queue tail by calling interlocked_add_64. ]*/
 /* Tests_SRS_TQUEUE_01_011: [ For each item in the queue, dispose_item_function shall be called with dispose_item_function_context and a pointer to the array entry value (T*). ]*/
-/* Tests_SRS_TQUEUE_01_056: [ The lock initialized in TQUEUE_CREATE(T) shall be de-initialized. ] */
-/* Tests_SRS_TQUEUE_01_057: [ The array backing the queue shall be freed. ] */
+/* Tests_SRS_TQUEUE_01_057: [ All the segments backing the queue shall be freed. ] */
 PARAMETERIZED_TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_non_NULL_dispose_item_with_2_items_calls_dispose_item_2_times,
-    ARGS(uint32_t, initial_queue_size, uint32_t, max_queue_size),
-    CASE((1024, 1024), same_initial_and_max_size),
-    CASE((1024, 2048), max_size_bigger_than_initial_size),
-    CASE((1, 2048), queue_that_was_grown))
+    ARGS(uint32_t, initial_queue_size, uint32_t, max_queue_size, uint32_t, segment_count),
+    CASE((1024, 1024, 1), same_initial_and_max_size),
+    CASE((1024, 2048, 1), max_size_bigger_than_initial_size),
+    CASE((1, 2048, 2), queue_that_was_grown))
 {
     // arrange
     TQUEUE(int32_t) queue = test_queue_create(initial_queue_size, max_queue_size, test_copy_item, test_dispose_item, (void*)0x4242);
@@ -363,8 +547,10 @@ PARAMETERIZED_TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_non_NULL_dispose_item_with_
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    for (uint32_t i = 0; i < segment_count; i++)
+    {
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // segment
+    }
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
@@ -374,21 +560,25 @@ PARAMETERIZED_TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_non_NULL_dispose_item_with_
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_TQUEUE_01_056: [ The lock initialized in TQUEUE_CREATE(T) shall be de-initialized. ] */
-/* Tests_SRS_TQUEUE_01_057: [ The array backing the queue shall be freed. ] */
+/* Tests_SRS_TQUEUE_01_057: [ All the segments backing the queue shall be freed. ] */
 PARAMETERIZED_TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_with_NULL_copy_and_dispose_function_frees_resources,
-    ARGS(uint32_t, initial_queue_size, uint32_t, max_queue_size),
-    CASE((1024, 2048), max_size_bigger_than_initial_size),
-    CASE((1, 2048), queue_that_was_grown))
+    ARGS(uint32_t, initial_queue_size, uint32_t, max_queue_size, uint32_t, segment_count),
+    CASE((1024, 2048, 1), max_size_bigger_than_initial_size),
+    CASE((1, 2048, 2), queue_that_was_grown),
+    CASE((1, 2048, 3), queue_that_was_grown_twice))
 {
     // arrange
     TQUEUE(int32_t) queue = test_queue_create(initial_queue_size, max_queue_size, NULL, NULL, (void*)0x4242);
-    test_queue_push(queue, 42);
-    test_queue_push(queue, 42);
+    for (uint32_t i = 0; i < segment_count; i++)
+    {
+        test_queue_push(queue, 42);
+    }
 
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    for (uint32_t i = 0; i < segment_count; i++)
+    {
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // segment
+    }
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
@@ -431,7 +621,6 @@ TEST_FUNCTION(TQUEUE_PUSH_with_NULL_item_fails)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_058: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue. ]*/
 /* Tests_SRS_TQUEUE_01_014: [ TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/
     /* Tests_SRS_TQUEUE_01_015: [ TQUEUE_PUSH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
     /* Tests_SRS_TQUEUE_01_016: [ TQUEUE_PUSH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
@@ -440,20 +629,49 @@ TEST_FUNCTION(TQUEUE_PUSH_with_NULL_item_fails)
     /* Tests_SRS_TQUEUE_01_019: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall copy the value of item into the array entry value whose state was changed to PUSHING. ]*/
     /* Tests_SRS_TQUEUE_01_020: [ TQUEUE_PUSH(T) shall set the state to USED by using interlocked_exchange. ]*/
     /* Tests_SRS_TQUEUE_01_021: [ TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/
-/* Tests_SRS_TQUEUE_01_059: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ]*/
+    /* Tests_SRS_TQUEUE_12_055: [ TQUEUE_PUSH(T) shall obtain the number of threads waiting in TQUEUE_POP_WAIT(T) by calling interlocked_add. ]*/
 TEST_FUNCTION(TQUEUE_PUSH_with_valid_args_without_push_cb_func_copies_the_data_in)
 {
     // arrange
     int32_t item = 42;
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_056: [ If there are threads waiting in TQUEUE_POP_WAIT(T), TQUEUE_PUSH(T) shall increment the pop wait sequence by calling interlocked_increment and wake one of the threads by calling wake_by_address_single. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_with_pop_waiters_wakes_one_waiter)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // pop waiter count
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop wait sequence
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -466,7 +684,6 @@ TEST_FUNCTION(TQUEUE_PUSH_with_valid_args_without_push_cb_func_copies_the_data_i
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_058: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue. ]*/
 /* Tests_SRS_TQUEUE_01_014: [ TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/
     /* Tests_SRS_TQUEUE_01_015: [ TQUEUE_PUSH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
     /* Tests_SRS_TQUEUE_01_016: [ TQUEUE_PUSH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
@@ -475,7 +692,6 @@ TEST_FUNCTION(TQUEUE_PUSH_with_valid_args_without_push_cb_func_copies_the_data_i
     /* Tests_SRS_TQUEUE_01_019: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall copy the value of item into the array entry value whose state was changed to PUSHING. ]*/
     /* Tests_SRS_TQUEUE_01_020: [ TQUEUE_PUSH(T) shall set the state to USED by using interlocked_exchange. ]*/
     /* Tests_SRS_TQUEUE_01_021: [ TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/
-/* Tests_SRS_TQUEUE_01_059: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ]*/
 TEST_FUNCTION(TQUEUE_PUSH_twice_copies_the_data_in)
 {
     // arrange
@@ -483,21 +699,21 @@ TEST_FUNCTION(TQUEUE_PUSH_twice_copies_the_data_in)
     int32_t item_2 = 43;
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result_1 = TQUEUE_PUSH(int32_t)(queue, &item_1, NULL);
@@ -512,8 +728,7 @@ TEST_FUNCTION(TQUEUE_PUSH_twice_copies_the_data_in)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_060: [ If the queue is full (current head >= current tail + queue size): ]*/
-    /* Tests_SRS_TQUEUE_01_061: [ If the current queue size is equal to the max queue size, TQUEUE_PUSH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+/* Tests_SRS_TQUEUE_12_004: [ If the queue holds max queue size items (current head position >= current tail position + max queue size), TQUEUE_PUSH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
 TEST_FUNCTION(TQUEUE_PUSH_twice_for_queue_size_1_returns_QUEUE_FULL)
 {
     // arrange
@@ -521,10 +736,8 @@ TEST_FUNCTION(TQUEUE_PUSH_twice_for_queue_size_1_returns_QUEUE_FULL)
     TQUEUE(int32_t) queue = test_queue_create(1, 1, NULL, NULL, NULL);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -548,7 +761,6 @@ PARAMETERIZED_TEST_FUNCTION(TQUEUE_PUSH_when_entry_state_is_different_than_NOT_U
     int32_t item = 42;
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED))
@@ -566,7 +778,7 @@ PARAMETERIZED_TEST_FUNCTION(TQUEUE_PUSH_when_entry_state_is_different_than_NOT_U
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED));
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -586,7 +798,6 @@ TEST_FUNCTION(when_head_changes_TQUEUE_PUSH_tries_again)
     int32_t item = 42;
     TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
@@ -599,7 +810,8 @@ TEST_FUNCTION(when_head_changes_TQUEUE_PUSH_tries_again)
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -619,14 +831,14 @@ TEST_FUNCTION(TQUEUE_PUSH_with_copy_item_function_calls_the_cb_function)
     int32_t item = 42;
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
     STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, IGNORED_ARG, &item)); // entry state
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, (void*)0x4243);
@@ -647,23 +859,23 @@ TEST_FUNCTION(TQUEUE_PUSH_with_copy_item_function_calls_the_cb_function_2_items)
     int32_t item_2 = 43;
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
     STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, IGNORED_ARG, &item_1)); // entry state
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // head change
     STRICT_EXPECTED_CALL(test_copy_item((void*)0x4244, IGNORED_ARG, &item_2)); // entry state
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result_1 = TQUEUE_PUSH(int32_t)(queue, &item_1, (void*)0x4243);
@@ -678,7 +890,6 @@ TEST_FUNCTION(TQUEUE_PUSH_with_copy_item_function_calls_the_cb_function_2_items)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_058: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */
 /* Tests_SRS_TQUEUE_01_014: [ TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/
     /* Tests_SRS_TQUEUE_01_015: [ TQUEUE_PUSH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
     /* Tests_SRS_TQUEUE_01_016: [ TQUEUE_PUSH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
@@ -687,20 +898,19 @@ TEST_FUNCTION(TQUEUE_PUSH_with_copy_item_function_calls_the_cb_function_2_items)
     /* Tests_SRS_TQUEUE_01_019: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall copy the value of item into the array entry value whose state was changed to PUSHING. ]*/
     /* Tests_SRS_TQUEUE_01_020: [ TQUEUE_PUSH(T) shall set the state to USED by using interlocked_exchange. ]*/
     /* Tests_SRS_TQUEUE_01_021: [ TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/
-/* Tests_SRS_TQUEUE_01_059: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
 TEST_FUNCTION(TQUEUE_PUSH_for_a_queue_with_max_higher_than_initial_size_succeeds)
 {
     // arrange
     int32_t item = 42;
     TQUEUE(int32_t) queue = test_queue_create(1024, 2048, NULL, NULL, NULL);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -713,62 +923,47 @@ TEST_FUNCTION(TQUEUE_PUSH_for_a_queue_with_max_higher_than_initial_size_succeeds
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_058: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */
 /* Tests_SRS_TQUEUE_01_014: [ TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/
     /* Tests_SRS_TQUEUE_01_015: [ TQUEUE_PUSH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
     /* Tests_SRS_TQUEUE_01_016: [ TQUEUE_PUSH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
-    /* Tests_SRS_TQUEUE_01_060: [ If the queue is full (current head >= current tail + queue size): ]*/
-        /* Tests_SRS_TQUEUE_01_062: [ If the current queue size is less than the max queue size: ] */
-            /* Tests_SRS_TQUEUE_01_063: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-            /* Tests_SRS_TQUEUE_01_064: [ TQUEUE_PUSH(T) shall acquire in exclusive mode the lock used to guard the growing of the queue. ] */
-            /* Tests_SRS_TQUEUE_01_074: [ If the size of the queue did not change after acquiring the lock in shared mode: ]*/
-                /* Tests_SRS_TQUEUE_01_075: [ TQUEUE_PUSH(T) shall obtain again the current head or the queue. ]*/
-                /* Tests_SRS_TQUEUE_01_076: [ TQUEUE_PUSH(T) shall obtain again the current tail or the queue. ]*/
-                /* Tests_SRS_TQUEUE_01_067: [ TQUEUE_PUSH(T) shall double the size of the queue. ]*/
-                /* Tests_SRS_TQUEUE_01_068: [ TQUEUE_PUSH(T) shall reallocate the array used to store the queue items based on the newly computed size. ]*/
-                /* Tests_SRS_TQUEUE_01_077: [ TQUEUE_PUSH(T) shall move the entries between the tail index and the array end like below: ]*/            \
-                /* Tests_SRS_TQUEUE_01_078: [ Entries at the tail shall be moved to the end of the resized array ] */
-            /* Tests_SRS_TQUEUE_01_065: [ TQUEUE_PUSH(T) shall release in exclusive mode the lock used to guard the growing of the queue. ] */
-            /* Tests_SRS_TQUEUE_01_066: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue and retry the TQUEUE_PUSH(T). ] */
+    /* Tests_SRS_TQUEUE_12_006: [ If the queue holds at least as many items as the size of the head segment (current head position >= current tail position + head segment size): ]*/
+        /* Tests_SRS_TQUEUE_12_007: [ If the segment following the head segment is not allocated, TQUEUE_PUSH(T) shall allocate an array of twice the size of the head segment. ]*/
+        /* Tests_SRS_TQUEUE_12_009: [ TQUEUE_PUSH(T) shall initialize the state for each entry in the new segment with NOT_USED by using interlocked_exchange. ]*/
+        /* Tests_SRS_TQUEUE_12_010: [ TQUEUE_PUSH(T) shall set the new segment as the segment following the head segment by using interlocked_compare_exchange_pointer. ]*/
+        /* Tests_SRS_TQUEUE_12_012: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH(T) shall move the head to the segment following the head segment, without changing the head position, and retry the push. ]*/
     /* Tests_SRS_TQUEUE_01_017: [ Using interlocked_compare_exchange, TQUEUE_PUSH(T) shall change the head array entry state to PUSHING (from NOT_USED). ]*/
     /* Tests_SRS_TQUEUE_01_018: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH(T) shall replace the head value with the head value obtained earlier + 1. ]*/
     /* Tests_SRS_TQUEUE_01_019: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall copy the value of item into the array entry value whose state was changed to PUSHING. ]*/
     /* Tests_SRS_TQUEUE_01_020: [ TQUEUE_PUSH(T) shall set the state to USED by using interlocked_exchange. ]*/
     /* Tests_SRS_TQUEUE_01_021: [ TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/
-/* Tests_SRS_TQUEUE_01_059: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-TEST_FUNCTION(TQUEUE_PUSH_twice_for_queue_size_1_resizes_the_queue_case_1)
+TEST_FUNCTION(TQUEUE_PUSH_twice_for_queue_size_1_allocates_the_next_segment)
 {
     // arrange
     int32_t item = 42;
     TQUEUE(int32_t) queue = test_queue_create(1, 2, NULL, NULL, NULL);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
 
-    // resize
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // read again head
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // read again tail
-    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, IGNORED_ARG));
-    for (uint32_t i = 1; i < 2; i++)
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    for (uint32_t i = 0; i < 2; i++)
     {
         STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     }
-    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // set tail
-    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 2)); // set head
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL)); // set next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 1), 1)); // move head to next segment
 
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
 
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 2)); // head change
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2), TQUEUE_MAKE_HEAD_OR_TAIL(1, 1))); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -776,35 +971,18 @@ TEST_FUNCTION(TQUEUE_PUSH_twice_for_queue_size_1_resizes_the_queue_case_1)
     // assert
     ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->segments[1]);
 
     // clean
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_058: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */
-/* Tests_SRS_TQUEUE_01_014: [ TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/
-    /* Tests_SRS_TQUEUE_01_015: [ TQUEUE_PUSH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
-    /* Tests_SRS_TQUEUE_01_016: [ TQUEUE_PUSH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
-    /* Tests_SRS_TQUEUE_01_060: [ If the queue is full (current head >= current tail + queue size): ]*/
-        /* Tests_SRS_TQUEUE_01_062: [ If the current queue size is less than the max queue size: ] */
-            /* Tests_SRS_TQUEUE_01_063: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-            /* Tests_SRS_TQUEUE_01_064: [ TQUEUE_PUSH(T) shall acquire in exclusive mode the lock used to guard the growing of the queue. ] */
-            /* Tests_SRS_TQUEUE_01_074: [ If the size of the queue did not change after acquiring the lock in shared mode: ]*/
-                /* Tests_SRS_TQUEUE_01_075: [ TQUEUE_PUSH(T) shall obtain again the current head or the queue. ]*/
-                /* Tests_SRS_TQUEUE_01_076: [ TQUEUE_PUSH(T) shall obtain again the current tail or the queue. ]*/
-                /* Tests_SRS_TQUEUE_01_067: [ TQUEUE_PUSH(T) shall double the size of the queue. ]*/
-                /* Tests_SRS_TQUEUE_01_068: [ TQUEUE_PUSH(T) shall reallocate the array used to store the queue items based on the newly computed size. ]*/
-                /* Tests_SRS_TQUEUE_01_077: [ TQUEUE_PUSH(T) shall move the entries between the tail index and the array end like below: ]*/            \
-                /* Tests_SRS_TQUEUE_01_078: [ Entries at the tail shall be moved to the end of the resized array ] */
-            /* Tests_SRS_TQUEUE_01_065: [ TQUEUE_PUSH(T) shall release in exclusive mode the lock used to guard the growing of the queue. ] */
-            /* Tests_SRS_TQUEUE_01_066: [ TQUEUE_PUSH(T) shall acquire in shared mode the lock used to guard the growing of the queue and retry the TQUEUE_PUSH(T). ] */
-    /* Tests_SRS_TQUEUE_01_017: [ Using interlocked_compare_exchange, TQUEUE_PUSH(T) shall change the head array entry state to PUSHING (from NOT_USED). ]*/
-    /* Tests_SRS_TQUEUE_01_018: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH(T) shall replace the head value with the head value obtained earlier + 1. ]*/
-    /* Tests_SRS_TQUEUE_01_019: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall copy the value of item into the array entry value whose state was changed to PUSHING. ]*/
-    /* Tests_SRS_TQUEUE_01_020: [ TQUEUE_PUSH(T) shall set the state to USED by using interlocked_exchange. ]*/
-    /* Tests_SRS_TQUEUE_01_021: [ TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/
-/* Tests_SRS_TQUEUE_01_059: [ TQUEUE_PUSH(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-TEST_FUNCTION(TQUEUE_PUSH_twice_for_queue_size_4_resizes_the_queue_case_1)
+/* Tests_SRS_TQUEUE_12_006: [ If the queue holds at least as many items as the size of the head segment (current head position >= current tail position + head segment size): ]*/
+    /* Tests_SRS_TQUEUE_12_007: [ If the segment following the head segment is not allocated, TQUEUE_PUSH(T) shall allocate an array of twice the size of the head segment. ]*/
+    /* Tests_SRS_TQUEUE_12_009: [ TQUEUE_PUSH(T) shall initialize the state for each entry in the new segment with NOT_USED by using interlocked_exchange. ]*/
+    /* Tests_SRS_TQUEUE_12_010: [ TQUEUE_PUSH(T) shall set the new segment as the segment following the head segment by using interlocked_compare_exchange_pointer. ]*/
+    /* Tests_SRS_TQUEUE_12_012: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH(T) shall move the head to the segment following the head segment, without changing the head position, and retry the push. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_for_queue_size_4_with_wrapped_items_allocates_the_next_segment)
 {
     // arrange
     int32_t item = 42;
@@ -818,33 +996,27 @@ TEST_FUNCTION(TQUEUE_PUSH_twice_for_queue_size_4_resizes_the_queue_case_1)
     test_queue_push(queue, 42);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
 
-    // resize
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // read again head
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // read again tail
-    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 8, IGNORED_ARG));
-    // 4 new entries
-    for (uint32_t i = 0; i < 4; i++)
+    // grow, the 4 items in the first segment stay where they are
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(8, IGNORED_ARG));
+    for (uint32_t i = 0; i < 8; i++)
     {
         STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     }
-    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 6)); // set tail
-    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 10)); // set head
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL)); // set next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 6), 6)); // move head to next segment
 
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
 
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 11, 10)); // head change
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 7), TQUEUE_MAKE_HEAD_OR_TAIL(1, 6))); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 5, 4)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -852,31 +1024,27 @@ TEST_FUNCTION(TQUEUE_PUSH_twice_for_queue_size_4_resizes_the_queue_case_1)
     // assert
     ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 5, TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue));
 
     // clean
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_069: [ If reallocation fails, TQUEUE_PUSH(T) shall return TQUEUE_PUSH_ERROR. ]*/
-TEST_FUNCTION(when_realloc_for_resize_fails_TQUEUE_PUSH_returns_ERROR)
+/* Tests_SRS_TQUEUE_12_008: [ If allocating the segment fails, TQUEUE_PUSH(T) shall return TQUEUE_PUSH_ERROR. ]*/
+TEST_FUNCTION(when_allocating_the_next_segment_fails_TQUEUE_PUSH_returns_ERROR)
 {
     // arrange
     int32_t item = 42;
     TQUEUE(int32_t) queue = test_queue_create(1, 2, NULL, NULL, NULL);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
 
-    // resize
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // read again head
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // read again tail
-    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, IGNORED_ARG))
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG))
         .SetReturn(NULL);
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -889,42 +1057,90 @@ TEST_FUNCTION(when_realloc_for_resize_fails_TQUEUE_PUSH_returns_ERROR)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
+/* Tests_SRS_TQUEUE_12_011: [ If another thread already set the segment following the head segment, TQUEUE_PUSH(T) shall free the new segment. ]*/
+TEST_FUNCTION(when_another_thread_sets_the_next_segment_first_TQUEUE_PUSH_frees_the_new_segment)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(int32_t) queue = test_queue_create(1, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL))
+        .SetReturn((void*)0x4242); // another thread was faster
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 1), 1))
+        .SetReturn(TQUEUE_MAKE_HEAD_OR_TAIL(1, 1)); // and it also moved the head, pretend it is not visible yet
+
+    // retry
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL)); // set next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 1), 1)); // move head to next segment
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2), TQUEUE_MAKE_HEAD_OR_TAIL(1, 1))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
 
-/* Tests_SRS_TQUEUE_01_070: [ If the newly computed queue size is higher than the max_queue_size value passed to TQUEUE_CREATE(T), TQUEUE_PUSH(T) shall use max_queue_size as the new queue size. ]*/
-TEST_FUNCTION(TQUEUE_PUSH_resizes_but_obeys_max_size)
+/* Tests_SRS_TQUEUE_12_007: [ If the segment following the head segment is not allocated, TQUEUE_PUSH(T) shall allocate an array of twice the size of the head segment. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_allocates_segments_with_a_power_of_2_size_higher_than_max_size)
 {
     // arrange
     int32_t item = 42;
     TQUEUE(int32_t) queue = test_queue_create(1, 3, NULL, NULL, NULL);
     test_queue_push(queue, 42); // 1st item
-    test_queue_push(queue, 42); // 2ndst item => triggers a resize to size 2
+    test_queue_push(queue, 42); // 2nd item => allocates a segment of size 2
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
 
-    // resize (to 3)
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // read again head
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // read again tail
-    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 3, IGNORED_ARG));
-    for (uint32_t i = 2; i < 3; i++)
+    // grow (to a segment of size 4, the max size of 3 only limits the number of items in the queue)
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(4, IGNORED_ARG));
+    for (uint32_t i = 0; i < 4; i++)
     {
         STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     }
-    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 2)); // set tail
-    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 4)); // set head
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
-    
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL)); // set next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(2, 2), TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // move head to next segment
+
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    
+
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 5, 4)); // head change
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(2, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 2))); // head change
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 2)); // high water mark
 
     // act
     TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
@@ -937,6 +1153,30 @@ TEST_FUNCTION(TQUEUE_PUSH_resizes_but_obeys_max_size)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
+/* Tests_SRS_TQUEUE_12_004: [ If the queue holds max queue size items (current head position >= current tail position + max queue size), TQUEUE_PUSH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_with_max_size_items_in_the_queue_returns_QUEUE_FULL_even_if_the_array_has_free_entries)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(int32_t) queue = test_queue_create(1, 3, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 42); // the head segment has 4 entries now
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
 /* TQUEUE_POP(T) */
 
 /* Tests_SRS_TQUEUE_01_025: [ If tqueue is NULL then TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
@@ -970,7 +1210,6 @@ TEST_FUNCTION(TQUEUE_POP_with_NULL_item_fails)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_072: [ TQUEUE_POP(T) shall acquire in shared mode the lock used to guard the growing of the queue. ]*/
 /* Tests_SRS_TQUEUE_01_026: [ TQUEUE_POP(T) shall execute the following actions until it is either able to pop the item from the queue or the queue is empty: ] */
     /* Tests_SRS_TQUEUE_01_028: [ TQUEUE_POP(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
     /* Tests_SRS_TQUEUE_01_029: [ TQUEUE_POP(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
@@ -979,7 +1218,7 @@ TEST_FUNCTION(TQUEUE_POP_with_NULL_item_fails)
     /* Tests_SRS_TQUEUE_01_032: [ If a copy_item_function was not specified in TQUEUE_CREATE(T): ]*/
     /* Tests_SRS_TQUEUE_01_033: [ TQUEUE_POP(T) shall copy array entry value whose state was changed to POPPING to item. ]*/
     /* Tests_SRS_TQUEUE_01_034: [ TQUEUE_POP(T) shall set the state to NOT_USED by using interlocked_exchange, succeed and return TQUEUE_POP_OK. ]*/
-/* Tests_SRS_TQUEUE_01_073: [ TQUEUE_POP(T) shall release in shared mode the lock used to guard the growing of the queue. ]*/
+    /* Tests_SRS_TQUEUE_12_057: [ TQUEUE_POP(T) shall obtain the number of threads waiting in TQUEUE_PUSH_WAIT(T) by calling interlocked_add. ]*/
 TEST_FUNCTION(TQUEUE_POP_with_NULL_copy_item_function_and_NULL_condition_function_succeeds)
 {
     // arrange
@@ -987,13 +1226,42 @@ TEST_FUNCTION(TQUEUE_POP_with_NULL_copy_item_function_and_NULL_condition_functio
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_058: [ If there are threads waiting in TQUEUE_PUSH_WAIT(T), TQUEUE_POP(T) shall increment the push wait sequence by calling interlocked_increment and wake one of the threads by calling wake_by_address_single. ]*/
+TEST_FUNCTION(TQUEUE_POP_with_push_waiters_wakes_one_waiter)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // push waiter count
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push wait sequence
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
@@ -1007,7 +1275,6 @@ TEST_FUNCTION(TQUEUE_POP_with_NULL_copy_item_function_and_NULL_condition_functio
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_072: [ TQUEUE_POP(T) shall acquire in shared mode the lock used to guard the growing of the queue. ]*/
 /* Tests_SRS_TQUEUE_01_026: [ TQUEUE_POP(T) shall execute the following actions until it is either able to pop the item from the queue or the queue is empty: ] */
     /* Tests_SRS_TQUEUE_01_028: [ TQUEUE_POP(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
     /* Tests_SRS_TQUEUE_01_029: [ TQUEUE_POP(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
@@ -1016,7 +1283,6 @@ TEST_FUNCTION(TQUEUE_POP_with_NULL_copy_item_function_and_NULL_condition_functio
     /* Tests_SRS_TQUEUE_01_032: [ If a copy_item_function was not specified in TQUEUE_CREATE(T): ]*/
     /* Tests_SRS_TQUEUE_01_033: [ TQUEUE_POP(T) shall copy array entry value whose state was changed to POPPING to item. ]*/
     /* Tests_SRS_TQUEUE_01_034: [ TQUEUE_POP(T) shall set the state to NOT_USED by using interlocked_exchange, succeed and return TQUEUE_POP_OK. ]*/
-/* Tests_SRS_TQUEUE_01_073: [ TQUEUE_POP(T) shall release in shared mode the lock used to guard the growing of the queue. ]*/
 TEST_FUNCTION(TQUEUE_POP_twice_with_NULL_copy_item_function_and_NULL_condition_function_succeeds)
 {
     // arrange
@@ -1026,21 +1292,19 @@ TEST_FUNCTION(TQUEUE_POP_twice_with_NULL_copy_item_function_and_NULL_condition_f
     test_queue_push(queue, 42);
     test_queue_push(queue, 43);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // tail
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
     // act
     TQUEUE_POP_RESULT result_1 = TQUEUE_POP(int32_t)(queue, &item_1, NULL, NULL, NULL);
@@ -1057,17 +1321,15 @@ TEST_FUNCTION(TQUEUE_POP_twice_with_NULL_copy_item_function_and_NULL_condition_f
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_035: [ If the queue is empty (current tail >= current head), TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+/* Tests_SRS_TQUEUE_01_035: [ If the queue is empty (current tail position >= current head position), TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
 TEST_FUNCTION(TQUEUE_POP_when_queue_is_empty_returns_QUEUE_EMPTY)
 {
     // arrange
     int32_t item = 45;
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
@@ -1081,17 +1343,15 @@ TEST_FUNCTION(TQUEUE_POP_when_queue_is_empty_returns_QUEUE_EMPTY)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_035: [ If the queue is empty (current tail >= current head), TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+/* Tests_SRS_TQUEUE_01_035: [ If the queue is empty (current tail position >= current head position), TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
 TEST_FUNCTION(TQUEUE_POP_when_queue_is_empty_and_queue_size_1_returns_QUEUE_EMPTY)
 {
     // arrange
     int32_t item = 45;
     TQUEUE(int32_t) queue = test_queue_create(1, 1, NULL, NULL, NULL);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
@@ -1105,7 +1365,7 @@ TEST_FUNCTION(TQUEUE_POP_when_queue_is_empty_and_queue_size_1_returns_QUEUE_EMPT
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_035: [ If the queue is empty (current tail >= current head), TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+/* Tests_SRS_TQUEUE_01_035: [ If the queue is empty (current tail position >= current head position), TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
 TEST_FUNCTION(TQUEUE_POP_when_queue_is_empty_after_a_push_and_a_pop_and_queue_size_1_returns_QUEUE_EMPTY)
 {
     // arrange
@@ -1113,10 +1373,8 @@ TEST_FUNCTION(TQUEUE_POP_when_queue_is_empty_after_a_push_and_a_pop_and_queue_si
     test_queue_push(queue, 42);
     ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
 
     // act
     int32_t item = 45;
@@ -1143,7 +1401,6 @@ PARAMETERIZED_TEST_FUNCTION(TQUEUE_POP_when_entry_state_is_different_than_USED_t
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED))
@@ -1154,7 +1411,7 @@ PARAMETERIZED_TEST_FUNCTION(TQUEUE_POP_when_entry_state_is_different_than_USED_t
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // retry for entry_state
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
@@ -1178,7 +1435,6 @@ TEST_FUNCTION(TQUEUE_POP_with_copy_item_function_succeeds)
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
@@ -1186,7 +1442,7 @@ TEST_FUNCTION(TQUEUE_POP_with_copy_item_function_succeeds)
     STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, &item, IGNORED_ARG)); // copy
     STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG)); // dispose
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, (void*)0x4243, NULL, NULL);
@@ -1211,7 +1467,6 @@ TEST_FUNCTION(TQUEUE_POP_with_copy_item_function_twice_succeeds)
     test_queue_push(queue, 42);
     test_queue_push(queue, 43);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
@@ -1219,9 +1474,8 @@ TEST_FUNCTION(TQUEUE_POP_with_copy_item_function_twice_succeeds)
     STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, &item_1, IGNORED_ARG)); // copy
     STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG)); // dispose
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
@@ -1229,7 +1483,7 @@ TEST_FUNCTION(TQUEUE_POP_with_copy_item_function_twice_succeeds)
     STRICT_EXPECTED_CALL(test_copy_item((void*)0x4244, &item_2, IGNORED_ARG)); //copy
     STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG)); // dispose
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
     // act
     TQUEUE_POP_RESULT result_1 = TQUEUE_POP(int32_t)(queue, &item_1, (void*)0x4243, NULL, NULL);
@@ -1256,14 +1510,13 @@ TEST_FUNCTION(TQUEUE_POP_with_NULL_copy_item_function_and_non_NULL_condition_fun
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
     STRICT_EXPECTED_CALL(test_condition_function_true((void*)0x4247, IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, test_condition_function_true, (void*)0x4247);
@@ -1285,13 +1538,11 @@ TEST_FUNCTION(TQUEUE_POP_with_NULL_copy_item_function_and_non_NULL_condition_fun
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
     STRICT_EXPECTED_CALL(test_condition_function_false((void*)0x4247, IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // revert entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, test_condition_function_false, (void*)0x4247);
@@ -1316,14 +1567,13 @@ TEST_FUNCTION(TQUEUE_POP_after_a_POP_that_was_rejected_succeeds)
     test_queue_push(queue, 42);
     test_queue_pop_rejected(queue);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
     STRICT_EXPECTED_CALL(test_condition_function_true((void*)0x4248, IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, test_condition_function_true, (void*)0x4248);
@@ -1337,6 +1587,37 @@ TEST_FUNCTION(TQUEUE_POP_after_a_POP_that_was_rejected_succeeds)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
+/* Tests_SRS_TQUEUE_12_013: [ If the state of the array entry corresponding to the tail is not USED and the head is in a later segment than the tail, TQUEUE_POP(T) shall set the state of the array entry corresponding to the tail position in the segment following the tail segment to POPPING (from USED) by using interlocked_compare_exchange. ]*/
+/* Tests_SRS_TQUEUE_12_014: [ If the item was found in the segment following the tail segment, TQUEUE_POP(T) shall also move the tail to that segment. ]*/
+TEST_FUNCTION(TQUEUE_POP_pops_the_item_from_the_next_segment_and_moves_the_tail_to_it)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1, 4, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state in the tail segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state in the next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2), 1)); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 43, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
 /* Tests_SRS_TQUEUE_01_044: [ If incrementing the tail by using interlocked_compare_exchange_64 does not succeed, TQUEUE_POP(T) shall revert the state of the array entry to USED and retry. ]*/
 TEST_FUNCTION(when_switching_the_tail_does_not_succeed_TQUEUE_POP_retries)
 {
@@ -1345,7 +1626,6 @@ TEST_FUNCTION(when_switching_the_tail_does_not_succeed_TQUEUE_POP_retries)
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
     test_queue_push(queue, 42);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
@@ -1361,7 +1641,7 @@ TEST_FUNCTION(when_switching_the_tail_does_not_succeed_TQUEUE_POP_retries)
     STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, &item, IGNORED_ARG)); // copy
     STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG)); // dispose
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
 
     // act
     TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, (void*)0x4243, NULL, NULL);
@@ -1375,187 +1655,4387 @@ TEST_FUNCTION(when_switching_the_tail_does_not_succeed_TQUEUE_POP_retries)
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* TQUEUE_GET_VOLATILE_COUNT(T) */
+/* TQUEUE_PUSH_BATCH(T) */
 
-/* Tests_SRS_TQUEUE_22_001: [ If tqueue is NULL then TQUEUE_GET_VOLATILE_COUNT(T) shall return zero. ]*/
-TEST_FUNCTION(TQUEUE_GET_COUNT_with_NULL_tqueue_fails)
+/* Tests_SRS_TQUEUE_12_015: [ If tqueue is NULL then TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_with_NULL_tqueue_fails)
 {
     // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count;
 
     // act
-    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(NULL);
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(NULL, items, 2, (void*)0x4243, &pushed_item_count);
 
     // assert
-    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_TQUEUE_01_080: [ TQUEUE_GET_VOLATILE_COUNT(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */
-/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
-/* Tests_SRS_TQUEUE_22_004: [ If the queue is empty (current tail >= current head), TQUEUE_GET_VOLATILE_COUNT(T) shall return zero. ]*/
-/* Tests_SRS_TQUEUE_01_081: [ TQUEUE_GET_VOLATILE_COUNT(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_empty_tqueue_returns_zero)
+/* Tests_SRS_TQUEUE_12_016: [ If items is NULL then TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_with_NULL_items_fails)
 {
     // arrange
-    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
-
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    uint32_t pushed_item_count;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
 
     // act
-    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, NULL, 2, (void*)0x4243, &pushed_item_count);
 
     // assert
-    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // clean
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_080: [ TQUEUE_GET_VOLATILE_COUNT(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */
-/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
-/* Tests_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/
-/* Tests_SRS_TQUEUE_01_081: [ TQUEUE_GET_VOLATILE_COUNT(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_push_1_returns_1)
+/* Tests_SRS_TQUEUE_12_017: [ If item_count is 0 then TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_with_0_item_count_fails)
 {
     // arrange
-    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
-    test_queue_push(queue, 42);
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 0, (void*)0x4243, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_018: [ If pushed_item_count is NULL then TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_with_NULL_pushed_item_count_fails)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, (void*)0x4243, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
+/* Tests_SRS_TQUEUE_12_019: [ TQUEUE_PUSH_BATCH(T) shall execute the following actions until it is either able to push at least one item in the queue or the queue is full: ]*/
+    /* Tests_SRS_TQUEUE_12_020: [ TQUEUE_PUSH_BATCH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
+    /* Tests_SRS_TQUEUE_12_021: [ TQUEUE_PUSH_BATCH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
+    /* Tests_SRS_TQUEUE_12_025: [ TQUEUE_PUSH_BATCH(T) shall push at most item_count items, without exceeding the max queue size and the size of the head segment. ]*/
+    /* Tests_SRS_TQUEUE_12_026: [ Using interlocked_compare_exchange, TQUEUE_PUSH_BATCH(T) shall change the state of the array entries following the head to PUSHING (from NOT_USED), stopping at the first entry whose state is not NOT_USED. ]*/
+    /* Tests_SRS_TQUEUE_12_028: [ Using interlocked_compare_exchange_64, TQUEUE_PUSH_BATCH(T) shall replace the head value with the head value obtained earlier + the number of array entries whose state was changed to PUSHING. ]*/
+    /* Tests_SRS_TQUEUE_12_030: [ If no copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH_BATCH(T) shall copy the value of each pushed item into its array entry value. ]*/
+    /* Tests_SRS_TQUEUE_12_032: [ TQUEUE_PUSH_BATCH(T) shall set the state of each array entry to USED by using interlocked_exchange. ]*/
+    /* Tests_SRS_TQUEUE_12_033: [ TQUEUE_PUSH_BATCH(T) shall set pushed_item_count to the number of pushed items, succeed and return TQUEUE_PUSH_OK. ]*/
+    /* Tests_SRS_TQUEUE_12_059: [ TQUEUE_PUSH_BATCH(T) shall obtain the number of threads waiting in TQUEUE_POP_WAIT(T) by calling interlocked_add. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_with_3_items_without_copy_item_function_copies_the_data_in)
+{
+    // arrange
+    int32_t items[3] = { 42, 43, 44 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 0)); // head change
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 3, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 44, test_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_060: [ If there are threads waiting in TQUEUE_POP_WAIT(T), TQUEUE_PUSH_BATCH(T) shall increment the pop wait sequence by calling interlocked_increment and wake all the threads by calling wake_by_address_all. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_with_pop_waiters_wakes_all_waiters)
+{
+    // arrange
+    int32_t items[3] = { 42, 43, 44 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 0)); // head change
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // pop waiter count
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop wait sequence
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 0)); // high water mark
 
     // act
-    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 3, NULL, &pushed_item_count);
 
     // assert
-    ASSERT_ARE_EQUAL(int64_t, 1, result);
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, pushed_item_count);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // clean
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_080: [ TQUEUE_GET_VOLATILE_COUNT(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */
-/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
-/* Tests_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/
-/* Tests_SRS_TQUEUE_01_081: [ TQUEUE_GET_VOLATILE_COUNT(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_push_2_pop_1_returns_1)
+/* Tests_SRS_TQUEUE_12_031: [ If a copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_PUSH_BATCH(T) shall call the copy_item_function for each pushed item with copy_item_function_context as context, a pointer to its array entry value as push_dst and a pointer to the item as push_src. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_with_copy_item_function_calls_the_cb_function_for_each_item)
 {
     // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count = 0;
     TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
-    test_queue_push(queue, 42);
-    test_queue_push(queue, 43);
-    test_queue_pop(queue);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // head change
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, IGNORED_ARG, &items[0]));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, IGNORED_ARG, &items[1]));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, (void*)0x4243, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_025: [ TQUEUE_PUSH_BATCH(T) shall push at most item_count items, without exceeding the max queue size and the size of the head segment. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_pushes_no_more_items_than_fit_in_max_queue_size)
+{
+    // arrange
+    int32_t items[3] = { 42, 43, 44 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(4, 4, NULL, NULL, NULL);
+    test_queue_push(queue, 40);
+    test_queue_push(queue, 41);
+
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 4, 2)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 4, 2)); // high water mark
 
     // act
-    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 3, NULL, &pushed_item_count);
 
     // assert
-    ASSERT_ARE_EQUAL(int64_t, 1, result);
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, pushed_item_count);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 4, TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue));
 
     // clean
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_080: [ TQUEUE_GET_VOLATILE_COUNT(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */
-/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
-/* Tests_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/
-/* Tests_SRS_TQUEUE_01_081: [ TQUEUE_GET_VOLATILE_COUNT(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_full_queue_returns_queue_size)
+/* Tests_SRS_TQUEUE_12_025: [ TQUEUE_PUSH_BATCH(T) shall push at most item_count items, without exceeding the max queue size and the size of the head segment. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_pushes_no_more_items_than_fit_in_the_head_segment)
 {
-    uint32_t queue_size = 512;
+    // arrange
+    int32_t items[3] = { 42, 43, 44 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(2, 8, NULL, NULL, NULL);
+    test_queue_push(queue, 41);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 3, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
 
+/* Tests_SRS_TQUEUE_12_026: [ Using interlocked_compare_exchange, TQUEUE_PUSH_BATCH(T) shall change the state of the array entries following the head to PUSHING (from NOT_USED), stopping at the first entry whose state is not NOT_USED. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_stops_at_the_first_entry_that_is_not_NOT_USED)
+{
     // arrange
-    TQUEUE(int32_t) queue = test_queue_create(queue_size, queue_size, test_copy_item, test_dispose_item, (void*)0x4242);
-    for (uint32_t i = 0; i < queue_size; i++)
-    {
-        test_queue_push(queue, (int32_t)i);
-    }
-    int32_t item = 123;
-    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, TQUEUE_PUSH(int32_t)(queue, &item, NULL));
-    umock_c_reset_all_calls();
+    int32_t items[3] = { 42, 43, 44 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED))
+        .SetReturn(QUEUE_ENTRY_STATE_PUSHING); // another thread is pushing there
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 3, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_027: [ If the state of the array entry corresponding to the head is not NOT_USED, TQUEUE_PUSH_BATCH(T) shall retry the whole push. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_when_the_head_entry_state_is_not_NOT_USED_tries_again)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED))
+        .SetReturn(QUEUE_ENTRY_STATE_PUSHING); // fail change one time
+
+    // retry
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // high water mark
 
     // act
-    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, NULL, &pushed_item_count);
 
     // assert
-    ASSERT_ARE_EQUAL(int64_t, queue_size, result);
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, pushed_item_count);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // clean
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
-/* Tests_SRS_TQUEUE_01_080: [ TQUEUE_GET_VOLATILE_COUNT(T) shall acquire in shared mode the lock used to guard the growing of the queue. ] */
-/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
-/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
-/* Tests_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/
-/* Tests_SRS_TQUEUE_01_081: [ TQUEUE_GET_VOLATILE_COUNT(T) shall release in shared mode the lock used to guard the growing of the queue. ] */
-TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_full_queue_pop_all_push_1_returns_1)
+/* Tests_SRS_TQUEUE_12_029: [ If the queue head has changed, TQUEUE_PUSH_BATCH(T) shall set the state of all the array entries whose state was changed to PUSHING back to NOT_USED and retry the push. ]*/
+TEST_FUNCTION(when_head_changes_TQUEUE_PUSH_BATCH_reverts_the_entry_states_and_tries_again)
 {
-    uint32_t queue_size = 512;
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0))
+        .SetReturn(1); // head changed!
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // reset entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // reset entry state
+
+    // retry
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
 
+/* Tests_SRS_TQUEUE_12_022: [ If the queue holds max queue size items, TQUEUE_PUSH_BATCH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_when_the_queue_holds_max_queue_size_items_returns_QUEUE_FULL)
+{
     // arrange
-    TQUEUE(int32_t) queue = test_queue_create(queue_size, queue_size, test_copy_item, test_dispose_item, (void*)0x4242);
-    for (uint32_t i = 0; i < queue_size; i++)
-    {
-        test_queue_push(queue, (int32_t)i);
-    }
-    int32_t item = 123;
-    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, TQUEUE_PUSH(int32_t)(queue, &item, NULL));
-    umock_c_reset_all_calls();
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1, 1, NULL, NULL, NULL);
+    test_queue_push(queue, 41);
 
-    for (uint32_t i = 0; i < queue_size; i++)
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_023: [ If the queue holds at least as many items as the size of the head segment, TQUEUE_PUSH_BATCH(T) shall grow the queue the same way TQUEUE_PUSH(T) does and retry. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_when_the_head_segment_is_full_allocates_the_next_segment)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1, 4, NULL, NULL, NULL);
+    test_queue_push(queue, 41);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    for (uint32_t i = 0; i < 2; i++)
     {
-        test_queue_pop(queue);
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
     }
-    test_queue_push(queue, item);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL)); // set next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 1), 1)); // move head to next segment
 
-    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_shared(IGNORED_ARG));
+    // the item in the first segment is still in the queue, so only 1 entry of the new segment is free
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2), TQUEUE_MAKE_HEAD_OR_TAIL(1, 1))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->segments[1]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_024: [ If growing the queue fails, TQUEUE_PUSH_BATCH(T) shall return TQUEUE_PUSH_ERROR. ]*/
+TEST_FUNCTION(when_allocating_the_next_segment_fails_TQUEUE_PUSH_BATCH_returns_ERROR)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1, 4, NULL, NULL, NULL);
+    test_queue_push(queue, 41);
+
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
     STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
-    STRICT_EXPECTED_CALL(srw_lock_ll_release_shared(IGNORED_ARG));
+
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG))
+        .SetReturn(NULL);
 
     // act
-    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, NULL, &pushed_item_count);
 
     // assert
-    ASSERT_ARE_EQUAL(int64_t, 1, result);
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_ERROR, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // clean
     TQUEUE_ASSIGN(int32_t)(&queue, NULL);
 }
 
+/* TQUEUE_POP_BATCH(T) */
+
+/* Tests_SRS_TQUEUE_12_034: [ If tqueue is NULL then TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_with_NULL_tqueue_fails)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count;
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(NULL, items, 2, (void*)0x4243, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_035: [ If items is NULL then TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_with_NULL_items_fails)
+{
+    // arrange
+    uint32_t popped_item_count;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, NULL, 2, (void*)0x4243, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_036: [ If item_count is 0 then TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_with_0_item_count_fails)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 0, (void*)0x4243, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_037: [ If popped_item_count is NULL then TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_with_NULL_popped_item_count_fails)
+{
+    // arrange
+    int32_t items[2];
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, (void*)0x4243, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_041: [ If the queue is empty (current tail position >= current head position), TQUEUE_POP_BATCH(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_when_the_queue_is_empty_returns_QUEUE_EMPTY)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_038: [ TQUEUE_POP_BATCH(T) shall execute the following actions until it is either able to pop at least one item from the queue or the queue is empty: ]*/
+    /* Tests_SRS_TQUEUE_12_039: [ TQUEUE_POP_BATCH(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
+    /* Tests_SRS_TQUEUE_12_040: [ TQUEUE_POP_BATCH(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
+    /* Tests_SRS_TQUEUE_12_042: [ Using interlocked_compare_exchange, TQUEUE_POP_BATCH(T) shall set the tail array entry state to POPPING (from USED), looking in the segment following the tail segment like TQUEUE_POP(T) does when the head is in a later segment than the tail. ]*/
+    /* Tests_SRS_TQUEUE_12_046: [ Using interlocked_compare_exchange, TQUEUE_POP_BATCH(T) shall set the state of the array entries following the tail in the same segment to POPPING (from USED), stopping at item_count items, at the head or at the first entry whose state is not USED. ]*/
+    /* Tests_SRS_TQUEUE_12_047: [ TQUEUE_POP_BATCH(T) shall replace the tail value with the tail value obtained earlier + the number of array entries whose state was changed to POPPING, in the segment of these array entries, by using interlocked_compare_exchange_64. ]*/
+    /* Tests_SRS_TQUEUE_12_049: [ If a copy_item_function was not specified in TQUEUE_CREATE(T), TQUEUE_POP_BATCH(T) shall copy each array entry value whose state was changed to POPPING to the corresponding item in items. ]*/
+    /* Tests_SRS_TQUEUE_12_052: [ TQUEUE_POP_BATCH(T) shall set the state of each array entry to NOT_USED by using interlocked_exchange. ]*/
+    /* Tests_SRS_TQUEUE_12_053: [ TQUEUE_POP_BATCH(T) shall set popped_item_count to the number of popped items, succeed and return TQUEUE_POP_OK. ]*/
+    /* Tests_SRS_TQUEUE_12_061: [ TQUEUE_POP_BATCH(T) shall obtain the number of threads waiting in TQUEUE_PUSH_WAIT(T) by calling interlocked_add. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_without_copy_item_function_pops_all_the_items)
+{
+    // arrange
+    int32_t items[5];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+    test_queue_push(queue, 44);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 0)); // tail change
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 5, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+    ASSERT_ARE_EQUAL(int32_t, 44, items[2]);
+    ASSERT_ARE_EQUAL(int64_t, 0, TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_062: [ If there are threads waiting in TQUEUE_PUSH_WAIT(T), TQUEUE_POP_BATCH(T) shall increment the push wait sequence by calling interlocked_increment and wake all the threads by calling wake_by_address_all. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_with_push_waiters_wakes_all_waiters)
+{
+    // arrange
+    int32_t items[5];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // tail change
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // push waiter count
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push wait sequence
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 5, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_050: [ If a copy_item_function was specified in TQUEUE_CREATE(T), TQUEUE_POP_BATCH(T) shall call copy_item_function for each array entry whose state was changed to POPPING with copy_item_function_context as context, a pointer to the corresponding item in items as pop_dst and a pointer to the array entry value as pop_src. ]*/
+/* Tests_SRS_TQUEUE_12_051: [ If a dispose_item_function was specified in TQUEUE_CREATE(T), TQUEUE_POP_BATCH(T) shall call dispose_item_function for each array entry whose state was changed to POPPING with dispose_item_function_context as context and a pointer to the array entry value as item. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_with_copy_item_function_calls_copy_and_dispose_for_each_item)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // tail change
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, &items[0], IGNORED_ARG)); // copy
+    STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG)); // dispose
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, &items[1], IGNORED_ARG)); // copy
+    STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG)); // dispose
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, (void*)0x4243, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_046: [ Using interlocked_compare_exchange, TQUEUE_POP_BATCH(T) shall set the state of the array entries following the tail in the same segment to POPPING (from USED), stopping at item_count items, at the head or at the first entry whose state is not USED. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_pops_no_more_than_item_count_items)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+    test_queue_push(queue, 44);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+    ASSERT_ARE_EQUAL(int32_t, 44, test_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_046: [ Using interlocked_compare_exchange, TQUEUE_POP_BATCH(T) shall set the state of the array entries following the tail in the same segment to POPPING (from USED), stopping at item_count items, at the head or at the first entry whose state is not USED. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_stops_at_the_first_entry_that_is_not_USED)
+{
+    // arrange
+    int32_t items[3];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+    test_queue_push(queue, 44);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED))
+        .SetReturn(QUEUE_ENTRY_STATE_PUSHING); // still being pushed
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 3, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_043: [ If the state of the array entry corresponding to the tail is not USED, TQUEUE_POP_BATCH(T) shall try again. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_when_the_tail_entry_state_is_not_USED_tries_again)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED))
+        .SetReturn(QUEUE_ENTRY_STATE_PUSHING); // fail change one time
+
+    // retry
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_044: [ If condition_function is not NULL, TQUEUE_POP_BATCH(T) shall call condition_function with condition_function_context and a pointer to the array entry value of the first item only. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_with_condition_function_calls_it_only_for_the_first_item)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(test_condition_function_true((void*)0x4247, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, NULL, test_condition_function_true, (void*)0x4247, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_045: [ If condition_function returns false, TQUEUE_POP_BATCH(T) shall set the state to USED by using interlocked_exchange and return TQUEUE_POP_REJECTED. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_when_condition_function_returns_false_returns_REJECTED)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(test_condition_function_false((void*)0x4247, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, NULL, test_condition_function_false, (void*)0x4247, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_REJECTED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 2, TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_048: [ If changing the tail by using interlocked_compare_exchange_64 does not succeed, TQUEUE_POP_BATCH(T) shall revert the state of all the array entries whose state was changed to POPPING to USED and retry. ]*/
+TEST_FUNCTION(when_tail_changes_TQUEUE_POP_BATCH_reverts_the_entry_states_and_tries_again)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0))
+        .SetReturn(1); // tail changed!
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // reset entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // reset entry state
+
+    // retry
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_042: [ Using interlocked_compare_exchange, TQUEUE_POP_BATCH(T) shall set the tail array entry state to POPPING (from USED), looking in the segment following the tail segment like TQUEUE_POP(T) does when the head is in a later segment than the tail. ]*/
+/* Tests_SRS_TQUEUE_12_047: [ TQUEUE_POP_BATCH(T) shall replace the tail value with the tail value obtained earlier + the number of array entries whose state was changed to POPPING, in the segment of these array entries, by using interlocked_compare_exchange_64. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_pops_the_items_from_the_next_segment)
+{
+    // arrange
+    int32_t items[3];
+    uint32_t popped_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(1, 4, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // grows the queue
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    test_queue_push(queue, 44);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state in the tail segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state in the next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 3), 1)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 3, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 43, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 44, items[1]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* TQUEUE_PUSH_WAIT(T) */
+
+/* the PUSH_WAIT tests use a queue with max size 2 holding 1 item, the head is reported as 2 to make a push see the queue full */
+static void test_expect_push_returns_QUEUE_FULL(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // head
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+}
+
+static void test_expect_push_succeeds(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // high water mark
+}
+
+/* Tests_SRS_TQUEUE_12_063: [ If tqueue is NULL then TQUEUE_PUSH_WAIT(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_with_NULL_tqueue_fails)
+{
+    // arrange
+    int32_t item = 42;
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(NULL, &item, NULL, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_064: [ If item is NULL then TQUEUE_PUSH_WAIT(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_with_NULL_item_fails)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, NULL, NULL, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_065: [ TQUEUE_PUSH_WAIT(T) shall push the item by calling TQUEUE_PUSH(T). ]*/
+/* Tests_SRS_TQUEUE_12_066: [ If TQUEUE_PUSH(T) does not return TQUEUE_PUSH_QUEUE_FULL, TQUEUE_PUSH_WAIT(T) shall return the result of TQUEUE_PUSH(T). ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_when_the_queue_is_not_full_pushes_without_waiting)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_succeeds();
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_067: [ If timeout_ms is 0, TQUEUE_PUSH_WAIT(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_with_0_timeout_when_the_queue_is_full_returns_QUEUE_FULL)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_returns_QUEUE_FULL();
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_068: [ TQUEUE_PUSH_WAIT(T) shall call timer_global_get_elapsed_ms to determine the start time of the wait. ]*/
+/* Tests_SRS_TQUEUE_12_069: [ TQUEUE_PUSH_WAIT(T) shall increment the push waiter count by calling interlocked_increment. ]*/
+/* Tests_SRS_TQUEUE_12_070: [ TQUEUE_PUSH_WAIT(T) shall execute the following actions until the item is pushed, the queue stays full for timeout_ms or waiting fails: ]*/
+    /* Tests_SRS_TQUEUE_12_071: [ TQUEUE_PUSH_WAIT(T) shall obtain the push wait sequence by calling interlocked_add. ]*/
+    /* Tests_SRS_TQUEUE_12_072: [ TQUEUE_PUSH_WAIT(T) shall push the item by calling TQUEUE_PUSH(T). ]*/
+    /* Tests_SRS_TQUEUE_12_073: [ If TQUEUE_PUSH(T) does not return TQUEUE_PUSH_QUEUE_FULL, TQUEUE_PUSH_WAIT(T) shall return the result of TQUEUE_PUSH(T). ]*/
+/* Tests_SRS_TQUEUE_12_078: [ TQUEUE_PUSH_WAIT(T) shall decrement the push waiter count by calling interlocked_decrement. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_when_the_queue_has_room_after_registering_the_waiter_pushes_without_waiting)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_succeeds();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // push waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_074: [ If timeout_ms is not UINT32_MAX, TQUEUE_PUSH_WAIT(T) shall call timer_global_get_elapsed_ms to compute the elapsed time since the start and if the elapsed time is greater than or equal to timeout_ms it shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+/* Tests_SRS_TQUEUE_12_075: [ TQUEUE_PUSH_WAIT(T) shall wait for the push wait sequence to change by calling wait_on_address with timeout_ms minus the elapsed time as timeout (UINT32_MAX if timeout_ms is UINT32_MAX). ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_waits_for_the_push_wait_sequence_and_pushes_when_the_queue_has_room)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1100.0);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 400));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_succeeds();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // push waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_075: [ TQUEUE_PUSH_WAIT(T) shall wait for the push wait sequence to change by calling wait_on_address with timeout_ms minus the elapsed time as timeout (UINT32_MAX if timeout_ms is UINT32_MAX). ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_with_UINT32_MAX_timeout_waits_indefinitely)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, UINT32_MAX));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_succeeds();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // push waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, UINT32_MAX);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_074: [ If timeout_ms is not UINT32_MAX, TQUEUE_PUSH_WAIT(T) shall call timer_global_get_elapsed_ms to compute the elapsed time since the start and if the elapsed time is greater than or equal to timeout_ms it shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_when_the_timeout_elapses_returns_QUEUE_FULL)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1500.0);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // push waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_075: [ TQUEUE_PUSH_WAIT(T) shall wait for the push wait sequence to change by calling wait_on_address with timeout_ms minus the elapsed time as timeout (UINT32_MAX if timeout_ms is UINT32_MAX). ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_when_the_timer_goes_backwards_waits_for_the_whole_timeout)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(900.0);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 500))
+        .SetReturn(WAIT_ON_ADDRESS_TIMEOUT);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // push waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_076: [ If wait_on_address returns WAIT_ON_ADDRESS_TIMEOUT, TQUEUE_PUSH_WAIT(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_when_wait_on_address_times_out_returns_QUEUE_FULL)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 500))
+        .SetReturn(WAIT_ON_ADDRESS_TIMEOUT);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // push waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_077: [ If wait_on_address returns WAIT_ON_ADDRESS_ERROR, TQUEUE_PUSH_WAIT(T) shall fail and return TQUEUE_PUSH_ERROR. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_WAIT_when_wait_on_address_fails_returns_ERROR)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(2, 2, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push wait sequence
+    test_expect_push_returns_QUEUE_FULL();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 500))
+        .SetReturn(WAIT_ON_ADDRESS_ERROR);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // push waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_WAIT(int32_t)(queue, &item, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* TQUEUE_POP_WAIT(T) */
+
+/* the POP_WAIT tests use a queue holding 1 item, the head is reported as 0 to make a pop see the queue empty */
+static void test_expect_pop_returns_QUEUE_EMPTY(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // head
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+}
+
+static void test_expect_pop_succeeds(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+}
+
+/* Tests_SRS_TQUEUE_12_079: [ If tqueue is NULL then TQUEUE_POP_WAIT(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_with_NULL_tqueue_fails)
+{
+    // arrange
+    int32_t item = 45;
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(NULL, &item, NULL, NULL, NULL, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_080: [ If item is NULL then TQUEUE_POP_WAIT(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_with_NULL_item_fails)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, NULL, NULL, NULL, NULL, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_081: [ TQUEUE_POP_WAIT(T) shall pop an item by calling TQUEUE_POP(T) with item, copy_item_function_context, condition_function and condition_function_context. ]*/
+/* Tests_SRS_TQUEUE_12_082: [ If TQUEUE_POP(T) does not return TQUEUE_POP_QUEUE_EMPTY, TQUEUE_POP_WAIT(T) shall return the result of TQUEUE_POP(T). ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_when_the_queue_is_not_empty_pops_without_waiting)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_pop_succeeds();
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, NULL, NULL, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_081: [ TQUEUE_POP_WAIT(T) shall pop an item by calling TQUEUE_POP(T) with item, copy_item_function_context, condition_function and condition_function_context. ]*/
+/* Tests_SRS_TQUEUE_12_082: [ If TQUEUE_POP(T) does not return TQUEUE_POP_QUEUE_EMPTY, TQUEUE_POP_WAIT(T) shall return the result of TQUEUE_POP(T). ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_when_the_condition_function_rejects_the_item_returns_REJECTED_without_waiting)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(test_condition_function_false((void*)0x4247, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // revert entry_state
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, test_condition_function_false, (void*)0x4247, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_REJECTED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_083: [ If timeout_ms is 0, TQUEUE_POP_WAIT(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_with_0_timeout_when_the_queue_is_empty_returns_QUEUE_EMPTY)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_pop_returns_QUEUE_EMPTY();
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, NULL, NULL, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(int32_t, 45, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_084: [ TQUEUE_POP_WAIT(T) shall call timer_global_get_elapsed_ms to determine the start time of the wait. ]*/
+/* Tests_SRS_TQUEUE_12_085: [ TQUEUE_POP_WAIT(T) shall increment the pop waiter count by calling interlocked_increment. ]*/
+/* Tests_SRS_TQUEUE_12_086: [ TQUEUE_POP_WAIT(T) shall execute the following actions until an item is popped or rejected, the queue stays empty for timeout_ms or waiting fails: ]*/
+    /* Tests_SRS_TQUEUE_12_087: [ TQUEUE_POP_WAIT(T) shall obtain the pop wait sequence by calling interlocked_add. ]*/
+    /* Tests_SRS_TQUEUE_12_088: [ TQUEUE_POP_WAIT(T) shall pop an item by calling TQUEUE_POP(T). ]*/
+    /* Tests_SRS_TQUEUE_12_089: [ If TQUEUE_POP(T) does not return TQUEUE_POP_QUEUE_EMPTY, TQUEUE_POP_WAIT(T) shall return the result of TQUEUE_POP(T). ]*/
+/* Tests_SRS_TQUEUE_12_094: [ TQUEUE_POP_WAIT(T) shall decrement the pop waiter count by calling interlocked_decrement. ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_when_an_item_is_pushed_after_registering_the_waiter_pops_without_waiting)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop wait sequence
+    test_expect_pop_succeeds();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // pop waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, NULL, NULL, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_090: [ If timeout_ms is not UINT32_MAX, TQUEUE_POP_WAIT(T) shall call timer_global_get_elapsed_ms to compute the elapsed time since the start and if the elapsed time is greater than or equal to timeout_ms it shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+/* Tests_SRS_TQUEUE_12_091: [ TQUEUE_POP_WAIT(T) shall wait for the pop wait sequence to change by calling wait_on_address with timeout_ms minus the elapsed time as timeout (UINT32_MAX if timeout_ms is UINT32_MAX). ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_waits_for_the_pop_wait_sequence_and_pops_when_an_item_is_pushed)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop wait sequence
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1100.0);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 400));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop wait sequence
+    test_expect_pop_succeeds();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // pop waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, NULL, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_091: [ TQUEUE_POP_WAIT(T) shall wait for the pop wait sequence to change by calling wait_on_address with timeout_ms minus the elapsed time as timeout (UINT32_MAX if timeout_ms is UINT32_MAX). ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_with_UINT32_MAX_timeout_waits_indefinitely)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop wait sequence
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, UINT32_MAX));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop wait sequence
+    test_expect_pop_succeeds();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // pop waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, NULL, NULL, UINT32_MAX);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_090: [ If timeout_ms is not UINT32_MAX, TQUEUE_POP_WAIT(T) shall call timer_global_get_elapsed_ms to compute the elapsed time since the start and if the elapsed time is greater than or equal to timeout_ms it shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_when_the_timeout_elapses_returns_QUEUE_EMPTY)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop wait sequence
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1500.0);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // pop waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, NULL, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(int32_t, 45, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_092: [ If wait_on_address returns WAIT_ON_ADDRESS_TIMEOUT, TQUEUE_POP_WAIT(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_when_wait_on_address_times_out_returns_QUEUE_EMPTY)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop wait sequence
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 500))
+        .SetReturn(WAIT_ON_ADDRESS_TIMEOUT);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // pop waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, NULL, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_093: [ If wait_on_address returns WAIT_ON_ADDRESS_ERROR, TQUEUE_POP_WAIT(T) shall fail and return TQUEUE_POP_ERROR. ]*/
+TEST_FUNCTION(TQUEUE_POP_WAIT_when_wait_on_address_fails_returns_ERROR)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop wait sequence
+    test_expect_pop_returns_QUEUE_EMPTY();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 500))
+        .SetReturn(WAIT_ON_ADDRESS_ERROR);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // pop waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_WAIT(int32_t)(queue, &item, NULL, NULL, NULL, 500);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* TQUEUE_PUSH_MOVE(T) */
+
+/* Tests_SRS_TQUEUE_12_163: [ If tqueue is NULL then TQUEUE_PUSH_MOVE(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_MOVE_with_NULL_tqueue_fails)
+{
+    // arrange
+    int32_t item = 42;
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_MOVE(int32_t)(NULL, &item);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_164: [ If item is NULL then TQUEUE_PUSH_MOVE(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_MOVE_with_NULL_item_fails)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_MOVE(int32_t)(queue, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_165: [ TQUEUE_PUSH_MOVE(T) shall push item the same way TQUEUE_PUSH(T) does, except that it shall always copy the value of item into the array entry value and it shall not call copy_item_function. ]*/
+/* Tests_SRS_TQUEUE_12_166: [ If the item was pushed, TQUEUE_PUSH_MOVE(T) shall set all the bytes of item to 0, the queue owning the item from now on. ]*/
+/* Tests_SRS_TQUEUE_12_167: [ TQUEUE_PUSH_MOVE(T) shall return the result of the push. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_MOVE_with_copy_item_function_does_not_call_the_cb_function_and_clears_the_item)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_MOVE(int32_t)(queue, &item);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 0, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_167: [ TQUEUE_PUSH_MOVE(T) shall return the result of the push. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_MOVE_on_a_full_queue_returns_QUEUE_FULL_and_does_not_clear_the_item)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(1, 1, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_MOVE(int32_t)(queue, &item);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(int32_t, 43, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_165: [ TQUEUE_PUSH_MOVE(T) shall push item the same way TQUEUE_PUSH(T) does, except that it shall always copy the value of item into the array entry value and it shall not call copy_item_function. ]*/
+/* Tests_SRS_TQUEUE_12_166: [ If the item was pushed, TQUEUE_PUSH_MOVE(T) shall set all the bytes of item to 0, the queue owning the item from now on. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_MOVE_with_copy_item_function_does_not_call_the_cb_function_and_clears_the_item)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_MOVE(SPSC_INT32)(queue, &item);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 0, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* TQUEUE_POP_MOVE(T) */
+
+/* Tests_SRS_TQUEUE_12_168: [ If tqueue is NULL then TQUEUE_POP_MOVE(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_POP_MOVE_with_NULL_tqueue_fails)
+{
+    // arrange
+    int32_t item = 45;
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_MOVE(int32_t)(NULL, &item, test_condition_function_true, (void*)0x4244);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_169: [ If item is NULL then TQUEUE_POP_MOVE(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(TQUEUE_POP_MOVE_with_NULL_item_fails)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_MOVE(int32_t)(queue, NULL, test_condition_function_true, (void*)0x4244);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_170: [ TQUEUE_POP_MOVE(T) shall pop an item the same way TQUEUE_POP(T) does, except that it shall always copy the array entry value to item and it shall call neither copy_item_function nor dispose_item_function. ]*/
+/* Tests_SRS_TQUEUE_12_171: [ TQUEUE_POP_MOVE(T) shall return the result of the pop. ]*/
+TEST_FUNCTION(TQUEUE_POP_MOVE_with_copy_item_function_does_not_call_the_cb_functions)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_MOVE(int32_t)(queue, &item, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_171: [ TQUEUE_POP_MOVE(T) shall return the result of the pop. ]*/
+TEST_FUNCTION(TQUEUE_POP_MOVE_when_queue_is_empty_returns_QUEUE_EMPTY)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_MOVE(int32_t)(queue, &item, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(int32_t, 45, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_170: [ TQUEUE_POP_MOVE(T) shall pop an item the same way TQUEUE_POP(T) does, except that it shall always copy the array entry value to item and it shall call neither copy_item_function nor dispose_item_function. ]*/
+/* Tests_SRS_TQUEUE_12_171: [ TQUEUE_POP_MOVE(T) shall return the result of the pop. ]*/
+TEST_FUNCTION(TQUEUE_POP_MOVE_with_condition_function_returning_false_does_not_pop)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(test_condition_function_false((void*)0x4247, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // revert entry_state
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_MOVE(int32_t)(queue, &item, test_condition_function_false, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_REJECTED, result);
+    ASSERT_ARE_EQUAL(int32_t, 45, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_170: [ TQUEUE_POP_MOVE(T) shall pop an item the same way TQUEUE_POP(T) does, except that it shall always copy the array entry value to item and it shall call neither copy_item_function nor dispose_item_function. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_MOVE_with_copy_item_function_does_not_call_the_cb_functions)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_MOVE(SPSC_INT32)(queue, &item, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* TQUEUE_GET_VOLATILE_COUNT(T) */
+
+/* Tests_SRS_TQUEUE_22_001: [ If tqueue is NULL then TQUEUE_GET_VOLATILE_COUNT(T) shall return zero. ]*/
+TEST_FUNCTION(TQUEUE_GET_COUNT_with_NULL_tqueue_fails)
+{
+    // arrange
+
+    // act
+    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
+/* Tests_SRS_TQUEUE_22_004: [ If the queue is empty (current tail position >= current head position), TQUEUE_GET_VOLATILE_COUNT(T) shall return zero. ]*/
+TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_empty_tqueue_returns_zero)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
+/* Tests_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/
+TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_push_1_returns_1)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 1, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
+/* Tests_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/
+TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_push_2_pop_1_returns_1)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+    test_queue_pop(queue);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 1, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
+/* Tests_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/
+TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_full_queue_returns_queue_size)
+{
+    uint32_t queue_size = 512;
+
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(queue_size, queue_size, test_copy_item, test_dispose_item, (void*)0x4242);
+    for (uint32_t i = 0; i < queue_size; i++)
+    {
+        test_queue_push(queue, (int32_t)i);
+    }
+    int32_t item = 123;
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, TQUEUE_PUSH(int32_t)(queue, &item, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, queue_size, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_22_002: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current head queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_003: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_22_006: [ TQUEUE_GET_VOLATILE_COUNT(T) shall obtain the current tail queue again by calling interlocked_add_64 and compare with the previosuly obtained tail value.  The tail value is valid only if it has not changed. ]*/
+/* Tests_SRS_TQUEUE_22_005: [ TQUEUE_GET_VOLATILE_COUNT(T) shall return the item count of the queue. ]*/
+TEST_FUNCTION(TQUEUE_GET_VOLATILE_COUNT_with_full_queue_pop_all_push_1_returns_1)
+{
+    uint32_t queue_size = 512;
+
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(queue_size, queue_size, test_copy_item, test_dispose_item, (void*)0x4242);
+    for (uint32_t i = 0; i < queue_size; i++)
+    {
+        test_queue_push(queue, (int32_t)i);
+    }
+    int32_t item = 123;
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, TQUEUE_PUSH(int32_t)(queue, &item, NULL));
+    umock_c_reset_all_calls();
+
+    for (uint32_t i = 0; i < queue_size; i++)
+    {
+        test_queue_pop(queue);
+    }
+    test_queue_push(queue, item);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+
+    // act
+    int64_t result = TQUEUE_GET_VOLATILE_COUNT(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 1, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* TQUEUE_CREATE_WITH_SHRINK(T) */
+
+static TQUEUE(int32_t) test_queue_create_with_shrink(uint32_t initial_queue_size, uint32_t max_queue_size, uint32_t shrink_after_pop_count)
+{
+    TQUEUE(int32_t) result = TQUEUE_CREATE_WITH_SHRINK(int32_t)(initial_queue_size, max_queue_size, NULL, NULL, NULL, shrink_after_pop_count);
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+
+    return result;
+}
+
+/* Tests_SRS_TQUEUE_12_174: [ If shrink_after_pop_count is 0, TQUEUE_CREATE_WITH_SHRINK(T) shall fail and return NULL. ]*/
+TEST_FUNCTION(TQUEUE_CREATE_WITH_SHRINK_with_shrink_after_pop_count_0_fails)
+{
+    // arrange
+
+    // act
+    TQUEUE(int32_t) queue = TQUEUE_CREATE_WITH_SHRINK(int32_t)(1, 2, NULL, NULL, NULL, 0);
+
+    // assert
+    ASSERT_IS_NULL(queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_175: [ TQUEUE_CREATE_WITH_SHRINK(T) shall create the queue by calling TQUEUE_CREATE(T) with initial_queue_size, max_queue_size, copy_item_function, dispose_item_function and dispose_item_function_context. ]*/
+/* Tests_SRS_TQUEUE_12_177: [ TQUEUE_CREATE_WITH_SHRINK(T) shall store shrink_after_pop_count in the queue, succeed and return the queue. ]*/
+TEST_FUNCTION(TQUEUE_CREATE_WITH_SHRINK_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); // THANDLE
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG)); // array
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // pop wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // push wait sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0)); // high water mark
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 0
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // operation count of epoch parity 1
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED));
+    }
+
+    // act
+    TQUEUE(int32_t) queue = TQUEUE_CREATE_WITH_SHRINK(int32_t)(2, 8, test_copy_item, test_dispose_item, (void*)0x4242, 3);
+
+    // assert
+    ASSERT_IS_NOT_NULL(queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->shrink_after_pop_count);
+    ASSERT_ARE_EQUAL(uint32_t, 8, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->max_size);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_176: [ If TQUEUE_CREATE(T) fails, TQUEUE_CREATE_WITH_SHRINK(T) shall fail and return NULL. ]*/
+TEST_FUNCTION(when_TQUEUE_CREATE_fails_TQUEUE_CREATE_WITH_SHRINK_also_fails)
+{
+    // arrange
+
+    // act
+    TQUEUE(int32_t) queue = TQUEUE_CREATE_WITH_SHRINK(int32_t)(0, 2, NULL, NULL, NULL, 3);
+
+    // assert
+    ASSERT_IS_NULL(queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* TQUEUE_PUSH(T)/TQUEUE_POP(T) with shrinking */
+
+/* pushes and pops 3 items in a queue created with an initial size of 1 and shrink_after_pop_count 1, so that the last pop leaves the queue empty with the head in the third segment */
+static TQUEUE(int32_t) test_queue_create_grown_and_emptied(void)
+{
+    TQUEUE(int32_t) result = test_queue_create_with_shrink(1, 8, 1);
+    test_queue_push(result, 42);
+    test_queue_push(result, 43); // in the second segment
+    test_queue_push(result, 44); // in the third segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(result));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(result));
+    ASSERT_ARE_EQUAL(int32_t, 44, test_queue_pop(result));
+
+    return result;
+}
+
+/* Tests_SRS_TQUEUE_12_221: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T) and the head is not in the first segment of its bank, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall protect the segments as described below before using them and retry. ]*/
+/* Tests_SRS_TQUEUE_12_228: [ If the queue was not created by TQUEUE_CREATE_WITH_SHRINK(T), if the head is in the first segment of its bank or if the queue is not empty, the push functions shall not shrink the queue. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_on_a_shrinking_queue_with_the_head_in_the_first_segment_does_not_protect_the_segments)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(2, 8, 1);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->epoch_operation_counts[0]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_246: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T), after popping the pop functions shall free the segments retired by a shrink. ]*/
+/* Tests_SRS_TQUEUE_12_247: [ The pop functions shall obtain the current head and the current tail by calling interlocked_load_acquire_64. ]*/
+/* Tests_SRS_TQUEUE_12_248: [ If the head is in the first segment of its bank, the pop functions shall not count the pop. ]*/
+/* Tests_SRS_TQUEUE_12_251: [ The push and pop functions shall obtain the retired segment count by calling interlocked_load_acquire. ]*/
+/* Tests_SRS_TQUEUE_12_252: [ If there are no retired segments, the push and pop functions shall not free any segment. ]*/
+TEST_FUNCTION(TQUEUE_POP_on_a_shrinking_queue_with_the_head_in_the_first_segment_does_not_count_the_pop)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(2, 8, 1);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->low_occupancy_pop_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_221: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T) and the head is not in the first segment of its bank, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall protect the segments as described below before using them and retry. ]*/
+/* Tests_SRS_TQUEUE_12_223: [ The push and pop functions shall obtain the reclaim epoch by calling interlocked_load_acquire. ]*/
+/* Tests_SRS_TQUEUE_12_224: [ The push and pop functions shall increment the operation count of the epoch parity by calling interlocked_increment. ]*/
+/* Tests_SRS_TQUEUE_12_225: [ If the reclaim epoch obtained again by calling interlocked_add did not change, the segments are protected. ]*/
+/* Tests_SRS_TQUEUE_12_227: [ When they are done using the segments, the push and pop functions that protected the segments shall decrement the operation count of the epoch parity by calling interlocked_decrement. ]*/
+/* Tests_SRS_TQUEUE_12_228: [ If the queue was not created by TQUEUE_CREATE_WITH_SHRINK(T), if the head is in the first segment of its bank or if the queue is not empty, the push functions shall not shrink the queue. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_on_a_shrinking_queue_with_the_head_in_a_later_segment_protects_the_segments)
+{
+    // arrange
+    int32_t item = 44;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(1, 8, 4);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 3), TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->epoch_operation_counts[0]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_226: [ Otherwise, the push and pop functions shall decrement the operation count of the epoch parity by calling interlocked_decrement and try again. ]*/
+TEST_FUNCTION(when_the_reclaim_epoch_changes_while_protecting_the_segments_TQUEUE_PUSH_protects_them_again)
+{
+    // arrange
+    int32_t item = 44;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(1, 8, 4);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // reclaim epoch
+        .SetReturn(1); // a shrink started a new epoch
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 3), TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->epoch_operation_counts[0]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_221: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T) and the head is not in the first segment of its bank, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall protect the segments as described below before using them and retry. ]*/
+/* Tests_SRS_TQUEUE_12_246: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T), after popping the pop functions shall free the segments retired by a shrink. ]*/
+/* Tests_SRS_TQUEUE_12_247: [ The pop functions shall obtain the current head and the current tail by calling interlocked_load_acquire_64. ]*/
+/* Tests_SRS_TQUEUE_12_185: [ If the queue holds more than a quarter of the head segment size items, the pop functions shall set the low occupancy pop count to 0 by calling interlocked_exchange. ]*/
+TEST_FUNCTION(TQUEUE_POP_on_a_shrinking_queue_holding_more_than_a_quarter_of_the_head_segment_size_resets_the_low_occupancy_pop_count)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(1, 8, 4);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    test_queue_push(queue, 44);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state in the tail segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state in the next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2), 1)); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 43, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->low_occupancy_pop_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_249: [ Otherwise, the pop functions shall obtain the low occupancy pop count by calling interlocked_load_acquire. ]*/
+/* Tests_SRS_TQUEUE_12_186: [ Otherwise, the pop functions shall increment the low occupancy pop count by calling interlocked_increment. ]*/
+TEST_FUNCTION(TQUEUE_POP_on_a_shrinking_queue_that_empties_the_queue_increments_the_low_occupancy_pop_count)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(1, 8, 4);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    test_queue_push(queue, 44);
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 3), TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // low occupancy pop count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 44, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 1, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->low_occupancy_pop_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_250: [ If the low occupancy pop count is already shrink_after_pop_count, the pop functions shall not change it. ]*/
+TEST_FUNCTION(TQUEUE_POP_on_a_shrinking_queue_with_shrink_after_pop_count_low_occupancy_pops_does_not_change_the_low_occupancy_pop_count)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(1, 8, 1);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    test_queue_push(queue, 44); // in the third segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(queue)); // low occupancy pop count reaches 1
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state in the tail segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state in the next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(2, 3), TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 44, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 1, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->low_occupancy_pop_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_229: [ Otherwise, the push functions shall obtain the low occupancy pop count by calling interlocked_load_acquire. ]*/
+/* Tests_SRS_TQUEUE_12_230: [ If the low occupancy pop count is less than shrink_after_pop_count, the push functions shall not shrink the queue. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_on_an_empty_shrinking_queue_before_shrink_after_pop_count_low_occupancy_pops_does_not_shrink)
+{
+    // arrange
+    int32_t item = 44;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(1, 8, 2);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(queue)); // low occupancy pop count reaches 1
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 3), TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->segments[1]);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_219: [ TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T) and the single producer TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall shrink the queue as described below and retry if the head was moved. ]*/
+/* Tests_SRS_TQUEUE_12_229: [ Otherwise, the push functions shall obtain the low occupancy pop count by calling interlocked_load_acquire. ]*/
+/* Tests_SRS_TQUEUE_12_231: [ The push functions shall free the segments retired by the previous shrink. ]*/
+/* Tests_SRS_TQUEUE_12_233: [ The push functions shall claim the retired segments by setting the retired segment count from 0 to TQUEUE_FREEING_RETIRED_SEGMENTS with interlocked_compare_exchange. ]*/
+/* Tests_SRS_TQUEUE_12_236: [ The other push functions shall move the head to the first segment of the other bank, without changing the head position, by using interlocked_compare_exchange_64. ]*/
+/* Tests_SRS_TQUEUE_12_238: [ If the head was moved, the push functions shall retire the segments following the first segment of the previous bank, stopping at the first segment that is not allocated, by setting them as not allocated with interlocked_exchange_pointer. ]*/
+/* Tests_SRS_TQUEUE_12_239: [ The push functions shall start a new reclaim epoch by calling interlocked_increment. ]*/
+/* Tests_SRS_TQUEUE_12_240: [ The push functions shall set the retired segment count to the number of retired segments by calling interlocked_exchange. ]*/
+/* Tests_SRS_TQUEUE_12_241: [ The push functions shall set the low occupancy pop count to 0 by calling interlocked_exchange. ]*/
+/* Tests_SRS_TQUEUE_12_242: [ The push functions shall free the retired segments, which succeeds right away when no other push/pop protects the segments. ]*/
+/* Tests_SRS_TQUEUE_12_243: [ The push functions shall retry the push. ]*/
+/* Tests_SRS_TQUEUE_12_254: [ Otherwise, the push and pop functions shall obtain the reclaim epoch by calling interlocked_add. ]*/
+/* Tests_SRS_TQUEUE_12_255: [ The push and pop functions shall obtain the operation count of the parity of the previous epoch by calling interlocked_add. ]*/
+/* Tests_SRS_TQUEUE_12_257: [ Otherwise, the push and pop functions shall claim the retired segments by setting the retired segment count to TQUEUE_FREEING_RETIRED_SEGMENTS with interlocked_compare_exchange. ]*/
+/* Tests_SRS_TQUEUE_12_259: [ The push and pop functions shall obtain the reclaim epoch again by calling interlocked_add. ]*/
+/* Tests_SRS_TQUEUE_12_261: [ The push and pop functions shall free the retired segments. ]*/
+/* Tests_SRS_TQUEUE_12_262: [ The push and pop functions shall set the retired segment count to 0 by calling interlocked_exchange. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_on_an_empty_shrinking_queue_after_shrink_after_pop_count_low_occupancy_pops_shrinks)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // head, to the first segment of the second bank
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // fourth segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // second segment
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->segments[1]);
+    ASSERT_IS_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->segments[2]);
+    ASSERT_IS_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->segments[33]);
+    ASSERT_ARE_EQUAL(uint32_t, 32, TQUEUE_GET_SEGMENT_INDEX(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->head));
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->retired_segment_count);
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->low_occupancy_pop_count);
+
+    // the item is popped from the first segment
+    ASSERT_ARE_EQUAL(int32_t, 45, test_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_232: [ If the segments retired by the previous shrink cannot be freed yet, the push functions shall not shrink the queue. ]*/
+/* Tests_SRS_TQUEUE_12_253: [ If another thread is freeing the retired segments, the push and pop functions shall not free any segment. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_on_an_empty_shrinking_queue_while_another_thread_frees_the_retired_segments_does_not_shrink)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)) // retired segment count
+        .SetReturn(TQUEUE_FREEING_RETIRED_SEGMENTS); // another thread is freeing the retired segments
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    // the retry shrinks, the segments retired by it are protected by this push so they are not freed yet
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // head
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // fourth segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 2, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->retired_segment_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_234: [ If the retired segment count was not 0, the push functions shall not shrink the queue. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_on_an_empty_shrinking_queue_while_another_push_shrinks_it_does_not_shrink)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)) // retired segment count
+        .SetReturn(TQUEUE_FREEING_RETIRED_SEGMENTS); // another push is shrinking the queue
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    // the retry shrinks, the segments retired by it are protected by this push so they are not freed yet
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // head
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // fourth segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_237: [ If the head was not moved, the push functions shall set the retired segment count back to 0 by calling interlocked_exchange. ]*/
+TEST_FUNCTION(when_the_head_changes_while_shrinking_TQUEUE_PUSH_releases_the_retired_segments_and_retries)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))) // head
+        .SetReturn(TQUEUE_MAKE_HEAD_OR_TAIL(2, 4)); // another push changed the head
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // head
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // fourth segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // second segment
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->retired_segment_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_256: [ If the operation count of the parity of the previous epoch is not 0, the push and pop functions shall not free any segment. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_that_shrinks_while_a_pop_protects_the_segments_does_not_free_the_retired_segments)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // head
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // fourth segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // operation count of the parity of the previous epoch
+        .SetReturn(1); // a pop protects the segments
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 2, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->retired_segment_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_258: [ If the retired segment count changed, the push and pop functions shall not free any segment. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_that_shrinks_while_another_thread_frees_the_retired_segments_does_not_free_them)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // head
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // fourth segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 2)) // retired segment count
+        .SetReturn(0); // a pop freed them
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_260: [ If the reclaim epoch changed, the push and pop functions shall set the retired segment count back by calling interlocked_exchange and shall not free any segment. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_that_shrinks_when_the_reclaim_epoch_changes_while_freeing_does_not_free_the_retired_segments)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // head
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // fourth segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // reclaim epoch
+        .SetReturn(2); // another shrink started a new epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 2, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->retired_segment_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_220: [ TQUEUE_POP(T), TQUEUE_POP_BATCH(T) and the single consumer TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall move the tail to the bank of the head as described below and try again if the tail was moved. ]*/
+/* Tests_SRS_TQUEUE_12_245: [ If the queue is not empty and the tail is not in the bank of the head, the other pop functions shall move the tail to the first segment of the bank of the head, without changing the tail position, by using interlocked_compare_exchange_64 and try again. ]*/
+TEST_FUNCTION(TQUEUE_POP_after_a_shrink_moves_the_tail_to_the_bank_of_the_head)
+{
+    // arrange
+    int32_t item = 46;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+    test_queue_push(queue, 45); // shrinks
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // tail, to the bank of the head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 45, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 32, TQUEUE_GET_SEGMENT_INDEX(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->tail));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_246: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T), after popping the pop functions shall free the segments retired by a shrink. ]*/
+/* Tests_SRS_TQUEUE_12_261: [ The push and pop functions shall free the retired segments. ]*/
+/* Tests_SRS_TQUEUE_12_262: [ The push and pop functions shall set the retired segment count to 0 by calling interlocked_exchange. ]*/
+TEST_FUNCTION(TQUEUE_POP_frees_the_segments_retired_by_a_shrink_once_they_are_no_longer_protected)
+{
+    // arrange
+    int32_t item = 46;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+    THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->epoch_operation_counts[0] = 1; // a pop protects the segments
+    test_queue_push(queue, 45); // shrinks
+    ASSERT_ARE_EQUAL(int32_t, 2, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->retired_segment_count);
+    THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->epoch_operation_counts[0] = 0; // the pop is done
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(2, 3))); // tail, to the bank of the head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 4), TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 2)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // second segment
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(int32_t)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 45, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 0, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->retired_segment_count);
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_222: [ If the segment of the head or of the tail is not allocated because a shrink retired it, TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T), TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall retry. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_with_a_head_in_a_retired_segment_retries)
+{
+    // arrange
+    int32_t item = 46;
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+    test_queue_push(queue, 45); // shrinks
+    ASSERT_ARE_EQUAL(int32_t, 45, test_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // head
+        .SetReturn(TQUEUE_MAKE_HEAD_OR_TAIL(1, 4)); // the head was obtained before the shrink
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // operation count of the epoch parity
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // head
+        .SetReturn(TQUEUE_MAKE_HEAD_OR_TAIL(1, 4)); // the head was obtained before the shrink
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 5), TQUEUE_MAKE_HEAD_OR_TAIL(32, 4))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // operation count of the epoch parity
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 46, test_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_219: [ TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T) and the single producer TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall shrink the queue as described below and retry if the head was moved. ]*/
+TEST_FUNCTION(TQUEUE_PUSH_BATCH_on_an_empty_shrinking_queue_after_shrink_after_pop_count_low_occupancy_pops_shrinks)
+{
+    // arrange
+    int32_t items[2] = { 45, 46 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(1, 8, 1);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 2), TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // head
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 1)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(32, 2))); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, pushed_item_count); // the first segment holds 1 item
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->segments[1]);
+    ASSERT_ARE_EQUAL(uint32_t, 32, TQUEUE_GET_SEGMENT_INDEX(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->head));
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_220: [ TQUEUE_POP(T), TQUEUE_POP_BATCH(T) and the single consumer TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall move the tail to the bank of the head as described below and try again if the tail was moved. ]*/
+/* Tests_SRS_TQUEUE_12_245: [ If the queue is not empty and the tail is not in the bank of the head, the other pop functions shall move the tail to the first segment of the bank of the head, without changing the tail position, by using interlocked_compare_exchange_64 and try again. ]*/
+TEST_FUNCTION(TQUEUE_POP_BATCH_after_a_shrink_moves_the_tail_to_the_bank_of_the_head)
+{
+    // arrange
+    int32_t items[2] = { 0, 0 };
+    uint32_t popped_item_count = 0;
+    uint32_t pushed_item_count = 0;
+    int32_t pushed_items[2] = { 45, 46 };
+    TQUEUE(int32_t) queue = test_queue_create_with_shrink(1, 8, 1);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, TQUEUE_PUSH_BATCH(int32_t)(queue, pushed_items, 2, NULL, &pushed_item_count)); // shrinks
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 2), TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // tail, to the bank of the head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_POPPING, QUEUE_ENTRY_STATE_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3), TQUEUE_MAKE_HEAD_OR_TAIL(32, 2))); // tail
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry_state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(int32_t)(queue, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, popped_item_count);
+    ASSERT_ARE_EQUAL(int32_t, 45, items[0]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_218: [ The segments retired by a shrink and not freed yet shall be freed. ]*/
+TEST_FUNCTION(TQUEUE_DISPOSE_FUNC_frees_the_segments_retired_by_a_shrink)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+    THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->epoch_operation_counts[0] = 1; // a pop protects the segments
+    test_queue_push(queue, 45); // shrinks
+    ASSERT_ARE_EQUAL(int32_t, 2, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->retired_segment_count);
+    THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(int32_t))(queue)->epoch_operation_counts[0] = 0; // the pop is done
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // first segment
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // retired second segment
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // retired third segment
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* TQUEUE_GET_CAPACITY(T) */
+
+/* Tests_SRS_TQUEUE_12_196: [ If tqueue is NULL then TQUEUE_GET_CAPACITY(T) shall return zero. ]*/
+TEST_FUNCTION(TQUEUE_GET_CAPACITY_with_NULL_tqueue_returns_zero)
+{
+    // arrange
+
+    // act
+    int64_t result = TQUEUE_GET_CAPACITY(int32_t)(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_263: [ TQUEUE_GET_CAPACITY(T) shall obtain the current head by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_12_264: [ TQUEUE_GET_CAPACITY(T) shall obtain the segments of the bank of the head by calling interlocked_compare_exchange_pointer, stopping at the first segment that is not allocated. ]*/
+/* Tests_SRS_TQUEUE_12_198: [ TQUEUE_GET_CAPACITY(T) shall return the sum of the sizes of the allocated segments. ]*/
+TEST_FUNCTION(TQUEUE_GET_CAPACITY_returns_the_size_of_the_first_segment)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(1000, 4096, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // first segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // second segment
+
+    // act
+    int64_t result = TQUEUE_GET_CAPACITY(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 1024, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_263: [ TQUEUE_GET_CAPACITY(T) shall obtain the current head by calling interlocked_add_64. ]*/
+/* Tests_SRS_TQUEUE_12_264: [ TQUEUE_GET_CAPACITY(T) shall obtain the segments of the bank of the head by calling interlocked_compare_exchange_pointer, stopping at the first segment that is not allocated. ]*/
+/* Tests_SRS_TQUEUE_12_198: [ TQUEUE_GET_CAPACITY(T) shall return the sum of the sizes of the allocated segments. ]*/
+TEST_FUNCTION(TQUEUE_GET_CAPACITY_after_growing_returns_the_sum_of_the_segment_sizes)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(1, 8, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43); // in the second segment
+    test_queue_push(queue, 44); // in the third segment
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // first segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // fourth segment
+
+    // act
+    int64_t result = TQUEUE_GET_CAPACITY(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 1 + 2 + 4, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_264: [ TQUEUE_GET_CAPACITY(T) shall obtain the segments of the bank of the head by calling interlocked_compare_exchange_pointer, stopping at the first segment that is not allocated. ]*/
+/* Tests_SRS_TQUEUE_12_198: [ TQUEUE_GET_CAPACITY(T) shall return the sum of the sizes of the allocated segments. ]*/
+TEST_FUNCTION(TQUEUE_GET_CAPACITY_after_shrinking_returns_the_size_of_the_first_segment)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create_grown_and_emptied();
+    test_queue_push(queue, 45); // shrinks
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // first segment of the second bank
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // second segment of the second bank
+
+    // act
+    int64_t result = TQUEUE_GET_CAPACITY(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 1, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* TQUEUE_GET_HIGH_WATER_MARK(T) */
+
+/* Tests_SRS_TQUEUE_12_199: [ If tqueue is NULL then TQUEUE_GET_HIGH_WATER_MARK(T) shall return zero. ]*/
+TEST_FUNCTION(TQUEUE_GET_HIGH_WATER_MARK_with_NULL_tqueue_returns_zero)
+{
+    // arrange
+
+    // act
+    int64_t result = TQUEUE_GET_HIGH_WATER_MARK(int32_t)(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_200: [ TQUEUE_GET_HIGH_WATER_MARK(T) shall return the high water mark obtained by calling interlocked_add_64. ]*/
+TEST_FUNCTION(TQUEUE_GET_HIGH_WATER_MARK_for_a_new_queue_returns_zero)
+{
+    // arrange
+    TQUEUE(int32_t) queue = test_queue_create(16, 16, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // high water mark
+
+    // act
+    int64_t result = TQUEUE_GET_HIGH_WATER_MARK(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_178: [ After pushing, TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall update the high water mark with the number of items in the queue (the new head position - the tail position obtained earlier). ]*/
+/* Tests_SRS_TQUEUE_12_179: [ While the number of items in the queue is greater than the high water mark, the push functions shall replace the high water mark with it by using interlocked_compare_exchange_64. ]*/
+/* Tests_SRS_TQUEUE_12_200: [ TQUEUE_GET_HIGH_WATER_MARK(T) shall return the high water mark obtained by calling interlocked_add_64. ]*/
+TEST_FUNCTION(TQUEUE_GET_HIGH_WATER_MARK_returns_the_highest_item_count)
+{
+    // arrange
+    int32_t items[2] = { 44, 45 };
+    uint32_t pushed_item_count = 0;
+    TQUEUE(int32_t) queue = test_queue_create(16, 16, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+    test_queue_push(queue, 43);
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, TQUEUE_PUSH_BATCH(int32_t)(queue, items, 2, NULL, &pushed_item_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, pushed_item_count);
+    ASSERT_ARE_EQUAL(int32_t, 42, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 44, test_queue_pop(queue));
+    test_queue_push(queue, 46); // the queue holds 2 items, less than before
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // high water mark
+
+    // act
+    int64_t result = TQUEUE_GET_HIGH_WATER_MARK(int32_t)(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 4, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_179: [ While the number of items in the queue is greater than the high water mark, the push functions shall replace the high water mark with it by using interlocked_compare_exchange_64. ]*/
+TEST_FUNCTION(when_another_thread_raises_the_high_water_mark_TQUEUE_PUSH_does_not_lower_it)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(int32_t) queue = test_queue_create(16, 16, NULL, NULL, NULL);
+    test_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // head
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // tail
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_PUSHING, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // head change
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)) // high water mark
+        .SetReturn(3); // another thread raised it
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(int32_t)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(int32_t)(&queue, NULL);
+}
+
+/* TQUEUE_PUSH(T) (single producer) */
+
+/* Tests_SRS_TQUEUE_12_095: [ If tqueue is NULL then the single producer TQUEUE_PUSH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_with_NULL_queue_fails)
+{
+    // arrange
+    int32_t item = 42;
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(NULL, &item, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_096: [ If item is NULL then the single producer TQUEUE_PUSH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_with_NULL_item_fails)
+{
+    // arrange
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, NULL, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_097: [ The single producer TQUEUE_PUSH(T) shall execute the following actions until it is either able to push the item in the queue or the queue is full: ]*/
+    /* Tests_SRS_TQUEUE_12_202: [ The single producer TQUEUE_PUSH(T) shall read the current head of the queue without interlocked operations (only the single producer changes it) and the current tail of the queue by calling interlocked_load_acquire_64. ]*/
+    /* Tests_SRS_TQUEUE_12_102: [ If no copy_item_function was specified in TQUEUE_CREATE(T), the single producer TQUEUE_PUSH(T) shall copy the value of item into the array entry value corresponding to the head. ]*/
+    /* Tests_SRS_TQUEUE_12_203: [ The single producer TQUEUE_PUSH(T) shall set the state of the array entry to USED by calling interlocked_store_release. ]*/
+    /* Tests_SRS_TQUEUE_12_204: [ The single producer TQUEUE_PUSH(T) shall publish the item by setting the head to the head value obtained earlier + 1 with interlocked_store_release_64. ]*/
+    /* Tests_SRS_TQUEUE_12_106: [ The single producer TQUEUE_PUSH(T) shall obtain the number of threads waiting in TQUEUE_POP_WAIT(T) by calling interlocked_add. ]*/
+    /* Tests_SRS_TQUEUE_12_108: [ The single producer TQUEUE_PUSH(T) shall succeed and return TQUEUE_PUSH_OK. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_with_valid_args_without_copy_item_function_copies_the_data_in)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, QUEUE_ENTRY_STATE_USED, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->segments[0][0].state);
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_103: [ If a copy_item_function was specified in TQUEUE_CREATE(T), the single producer TQUEUE_PUSH(T) shall call the copy_item_function with copy_item_function_context as context, a pointer to the array entry value corresponding to the head as push_dst and item as push_src. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_with_copy_item_function_calls_the_cb_function)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, IGNORED_ARG, &item));
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, &item, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_107: [ If there are threads waiting in TQUEUE_POP_WAIT(T), the single producer TQUEUE_PUSH(T) shall increment the pop wait sequence by calling interlocked_increment and wake one of the threads by calling wake_by_address_single. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_with_pop_waiters_wakes_one_waiter)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+    THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->pop_waiter_count = 1;
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop wait sequence
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_099: [ If the queue holds max queue size items, the single producer TQUEUE_PUSH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_twice_for_queue_size_1_returns_QUEUE_FULL)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 1, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 1, TQUEUE_GET_VOLATILE_COUNT(SPSC_INT32)(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_100: [ If the queue holds at least as many items as the size of the head segment, the single producer TQUEUE_PUSH(T) shall grow the queue the same way TQUEUE_PUSH(T) does and retry. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_twice_for_queue_size_1_allocates_the_next_segment)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 2, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL)); // set next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 1), 1)); // move head to next segment
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->segments[1]);
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_101: [ If growing the queue fails, the single producer TQUEUE_PUSH(T) shall return TQUEUE_PUSH_ERROR. ]*/
+TEST_FUNCTION(when_allocating_the_next_segment_fails_single_producer_TQUEUE_PUSH_returns_ERROR)
+{
+    // arrange
+    int32_t item = 43;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 2, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* TQUEUE_POP(T) (single consumer) */
+
+/* Tests_SRS_TQUEUE_12_109: [ If tqueue is NULL then the single consumer TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_with_NULL_tqueue_fails)
+{
+    // arrange
+    int32_t item;
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(NULL, &item, (void*)0x4243, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_110: [ If item is NULL then the single consumer TQUEUE_POP(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_with_NULL_item_fails)
+{
+    // arrange
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, NULL, (void*)0x4243, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_113: [ If the queue is empty (current tail position >= current head position), the single consumer TQUEUE_POP(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_when_queue_is_empty_returns_QUEUE_EMPTY)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 1, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(int32_t, 45, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_111: [ The single consumer TQUEUE_POP(T) shall execute the following actions until it is either able to pop the item from the queue or the queue is empty: ]*/
+    /* Tests_SRS_TQUEUE_12_205: [ The single consumer TQUEUE_POP(T) shall read the current tail of the queue without interlocked operations (only the single consumer changes it) and the current head of the queue by calling interlocked_load_acquire_64. ]*/
+    /* Tests_SRS_TQUEUE_12_118: [ If no copy_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP(T) shall copy the array entry value to item. ]*/
+    /* Tests_SRS_TQUEUE_12_207: [ The single consumer TQUEUE_POP(T) shall set the state of the array entry to NOT_USED by calling interlocked_store_release. ]*/
+    /* Tests_SRS_TQUEUE_12_208: [ The single consumer TQUEUE_POP(T) shall release the array entry by setting the tail to the tail position obtained earlier + 1, in the segment of the array entry, with interlocked_store_release_64. ]*/
+    /* Tests_SRS_TQUEUE_12_123: [ The single consumer TQUEUE_POP(T) shall obtain the number of threads waiting in TQUEUE_PUSH_WAIT(T) by calling interlocked_add. ]*/
+    /* Tests_SRS_TQUEUE_12_125: [ The single consumer TQUEUE_POP(T) shall succeed and return TQUEUE_POP_OK. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_with_NULL_copy_item_function_and_NULL_condition_function_succeeds)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, QUEUE_ENTRY_STATE_NOT_USED, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->segments[0][0].state);
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_119: [ If a copy_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP(T) shall call copy_item_function with copy_item_function_context as context, item as pop_dst and a pointer to the array entry value as pop_src. ]*/
+/* Tests_SRS_TQUEUE_12_120: [ If a dispose_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP(T) shall call dispose_item_function with dispose_item_function_context as context and a pointer to the array entry value as item. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_with_copy_item_function_succeeds)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, test_copy_item, test_dispose_item, (void*)0x4242);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, &item, IGNORED_ARG)); // copy
+    STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG)); // dispose
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, (void*)0x4243, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_116: [ If condition_function is not NULL, the single consumer TQUEUE_POP(T) shall call condition_function with condition_function_context and a pointer to the array entry value. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_with_condition_function_returning_true_succeeds)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(test_condition_function_true((void*)0x4247, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, NULL, test_condition_function_true, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_117: [ If condition_function returns false, the single consumer TQUEUE_POP(T) shall return TQUEUE_POP_REJECTED. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_with_condition_function_returning_false_does_not_pop)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(test_condition_function_false((void*)0x4247, IGNORED_ARG));
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, NULL, test_condition_function_false, (void*)0x4247);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_REJECTED, result);
+    ASSERT_ARE_EQUAL(int32_t, 45, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_114: [ If the state of the array entry corresponding to the tail is not USED and the head is in a later segment than the tail, the single consumer TQUEUE_POP(T) shall use the array entry corresponding to the tail position in the segment following the tail segment. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_pops_the_item_from_the_next_segment_and_moves_the_tail_to_it)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 43, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_124: [ If there are threads waiting in TQUEUE_PUSH_WAIT(T), the single consumer TQUEUE_POP(T) shall increment the push wait sequence by calling interlocked_increment and wake one of the threads by calling wake_by_address_single. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_with_push_waiters_wakes_one_waiter)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+    THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->push_waiter_count = 1;
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push wait sequence
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 42, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* TQUEUE_PUSH_BATCH(T) (single producer) */
+
+/* Tests_SRS_TQUEUE_12_126: [ If tqueue is NULL then the single producer TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_with_NULL_tqueue_fails)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count;
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(NULL, items, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_127: [ If items is NULL then the single producer TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_with_NULL_items_fails)
+{
+    // arrange
+    uint32_t pushed_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, NULL, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_128: [ If item_count is 0 then the single producer TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_with_0_item_count_fails)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 0, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_129: [ If pushed_item_count is NULL then the single producer TQUEUE_PUSH_BATCH(T) shall fail and return TQUEUE_PUSH_INVALID_ARG. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_with_NULL_pushed_item_count_fails)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 2, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_130: [ The single producer TQUEUE_PUSH_BATCH(T) shall execute the following actions until it is either able to push at least one item in the queue or the queue is full: ]*/
+    /* Tests_SRS_TQUEUE_12_209: [ The single producer TQUEUE_PUSH_BATCH(T) shall read the current head of the queue without interlocked operations (only the single producer changes it) and the current tail of the queue by calling interlocked_load_acquire_64. ]*/
+    /* Tests_SRS_TQUEUE_12_135: [ The single producer TQUEUE_PUSH_BATCH(T) shall push at most item_count items, without exceeding the max queue size and the size of the head segment. ]*/
+    /* Tests_SRS_TQUEUE_12_136: [ If no copy_item_function was specified in TQUEUE_CREATE(T), the single producer TQUEUE_PUSH_BATCH(T) shall copy the value of each pushed item into its array entry value. ]*/
+    /* Tests_SRS_TQUEUE_12_210: [ The single producer TQUEUE_PUSH_BATCH(T) shall set the state of each array entry to USED by calling interlocked_store_release. ]*/
+    /* Tests_SRS_TQUEUE_12_211: [ The single producer TQUEUE_PUSH_BATCH(T) shall publish the items by setting the head to the head value obtained earlier + the number of pushed items with interlocked_store_release_64. ]*/
+    /* Tests_SRS_TQUEUE_12_140: [ The single producer TQUEUE_PUSH_BATCH(T) shall obtain the number of threads waiting in TQUEUE_POP_WAIT(T) by calling interlocked_add. ]*/
+    /* Tests_SRS_TQUEUE_12_142: [ The single producer TQUEUE_PUSH_BATCH(T) shall set pushed_item_count to the number of pushed items, succeed and return TQUEUE_PUSH_OK. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_pushes_all_items)
+{
+    // arrange
+    int32_t items[3] = { 42, 43, 44 };
+    uint32_t pushed_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 3)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 3, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_spsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 44, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_135: [ The single producer TQUEUE_PUSH_BATCH(T) shall push at most item_count items, without exceeding the max queue size and the size of the head segment. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_pushes_only_the_items_that_fit_in_the_max_queue_size)
+{
+    // arrange
+    int32_t items[3] = { 42, 43, 44 };
+    uint32_t pushed_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 41);
+    test_spsc_queue_push(queue, 41);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 4)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 4, 2)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 3, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 4, TQUEUE_GET_VOLATILE_COUNT(SPSC_INT32)(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_137: [ If a copy_item_function was specified in TQUEUE_CREATE(T), the single producer TQUEUE_PUSH_BATCH(T) shall call the copy_item_function for each pushed item with copy_item_function_context as context, a pointer to its array entry value as push_dst and a pointer to the item as push_src. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_with_copy_item_function_calls_the_cb_function_for_each_item)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, test_copy_item, test_dispose_item, (void*)0x4242);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, IGNORED_ARG, &items[0]));
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, IGNORED_ARG, &items[1]));
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 2)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 2, (void*)0x4243, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_132: [ If the queue holds max queue size items, the single producer TQUEUE_PUSH_BATCH(T) shall return TQUEUE_PUSH_QUEUE_FULL. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_on_a_full_queue_returns_QUEUE_FULL)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count = 0x42;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 1, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 41);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_QUEUE_FULL, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0x42, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_133: [ If the queue holds at least as many items as the size of the head segment, the single producer TQUEUE_PUSH_BATCH(T) shall grow the queue the same way TQUEUE_PUSH(T) does and retry. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_grows_the_queue_and_pushes_in_the_next_segment)
+{
+    // arrange
+    int32_t items[3] = { 42, 43, 44 };
+    uint32_t pushed_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 41);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL)); // set next segment
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 1), 1)); // move head to next segment
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // the second segment has room for 1 more item
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 1)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 3, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 41, test_spsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_134: [ If growing the queue fails, the single producer TQUEUE_PUSH_BATCH(T) shall return TQUEUE_PUSH_ERROR. ]*/
+TEST_FUNCTION(when_allocating_the_next_segment_fails_single_producer_TQUEUE_PUSH_BATCH_returns_ERROR)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 41);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // grow
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL)); // read next segment
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_141: [ If there are threads waiting in TQUEUE_POP_WAIT(T), the single producer TQUEUE_PUSH_BATCH(T) shall increment the pop wait sequence by calling interlocked_increment and wake all the threads by calling wake_by_address_all. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_BATCH_with_pop_waiters_wakes_all_waiters)
+{
+    // arrange
+    int32_t items[2] = { 42, 43 };
+    uint32_t pushed_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, NULL, NULL, NULL);
+    THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->pop_waiter_count = 1;
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 2)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // pop wait sequence
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 2, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH_BATCH(SPSC_INT32)(queue, items, 2, NULL, &pushed_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, pushed_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* TQUEUE_POP_BATCH(T) (single consumer) */
+
+/* Tests_SRS_TQUEUE_12_143: [ If tqueue is NULL then the single consumer TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_with_NULL_tqueue_fails)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count;
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(NULL, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TQUEUE_12_144: [ If items is NULL then the single consumer TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_with_NULL_items_fails)
+{
+    // arrange
+    uint32_t popped_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, NULL, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_145: [ If item_count is 0 then the single consumer TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_with_0_item_count_fails)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 0, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_146: [ If popped_item_count is NULL then the single consumer TQUEUE_POP_BATCH(T) shall fail and return TQUEUE_POP_INVALID_ARG. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_with_NULL_popped_item_count_fails)
+{
+    // arrange
+    int32_t items[2];
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 2, NULL, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_149: [ If the queue is empty (current tail position >= current head position), the single consumer TQUEUE_POP_BATCH(T) shall return TQUEUE_POP_QUEUE_EMPTY. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_when_queue_is_empty_returns_QUEUE_EMPTY)
+{
+    // arrange
+    int32_t items[2];
+    uint32_t popped_item_count = 0x42;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1024, 1024, NULL, NULL, NULL);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_QUEUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0x42, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_147: [ The single consumer TQUEUE_POP_BATCH(T) shall execute the following actions until it is either able to pop at least one item from the queue or the queue is empty: ]*/
+    /* Tests_SRS_TQUEUE_12_212: [ The single consumer TQUEUE_POP_BATCH(T) shall read the current tail of the queue without interlocked operations (only the single consumer changes it) and the current head of the queue by calling interlocked_load_acquire_64. ]*/
+    /* Tests_SRS_TQUEUE_12_150: [ The single consumer TQUEUE_POP_BATCH(T) shall use the array entry corresponding to the tail, looking in the segment following the tail segment like the single consumer TQUEUE_POP(T) does when the head is in a later segment than the tail. ]*/
+    /* Tests_SRS_TQUEUE_12_154: [ The single consumer TQUEUE_POP_BATCH(T) shall pop the array entries following the tail in the same segment, stopping at item_count items, at the head, at the size of the segment or at the first entry whose state is not USED. ]*/
+    /* Tests_SRS_TQUEUE_12_155: [ If a copy_item_function was not specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP_BATCH(T) shall copy each popped array entry value to the corresponding item in items. ]*/
+    /* Tests_SRS_TQUEUE_12_214: [ The single consumer TQUEUE_POP_BATCH(T) shall set the state of each popped array entry to NOT_USED by calling interlocked_store_release. ]*/
+    /* Tests_SRS_TQUEUE_12_215: [ The single consumer TQUEUE_POP_BATCH(T) shall release the popped array entries by setting the tail to the tail position obtained earlier + the number of popped items, in the segment of the popped array entries, with interlocked_store_release_64. ]*/
+    /* Tests_SRS_TQUEUE_12_160: [ The single consumer TQUEUE_POP_BATCH(T) shall obtain the number of threads waiting in TQUEUE_PUSH_WAIT(T) by calling interlocked_add. ]*/
+    /* Tests_SRS_TQUEUE_12_162: [ The single consumer TQUEUE_POP_BATCH(T) shall set popped_item_count to the number of popped items, succeed and return TQUEUE_POP_OK. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_pops_up_to_the_head)
+{
+    // arrange
+    int32_t items[4] = { 0 };
+    uint32_t popped_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43);
+    test_spsc_queue_push(queue, 44);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+        STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 3)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 4, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, popped_item_count);
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+    ASSERT_ARE_EQUAL(int32_t, 44, items[2]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 0, TQUEUE_GET_VOLATILE_COUNT(SPSC_INT32)(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_154: [ The single consumer TQUEUE_POP_BATCH(T) shall pop the array entries following the tail in the same segment, stopping at item_count items, at the head, at the size of the segment or at the first entry whose state is not USED. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_pops_at_most_item_count_items)
+{
+    // arrange
+    int32_t items[2] = { 0 };
+    uint32_t popped_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43);
+    test_spsc_queue_push(queue, 44);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+        STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 2)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 44, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_154: [ The single consumer TQUEUE_POP_BATCH(T) shall pop the array entries following the tail in the same segment, stopping at item_count items, at the head, at the size of the segment or at the first entry whose state is not USED. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_stops_at_the_end_of_the_tail_segment)
+{
+    // arrange
+    int32_t items[4] = { 0 };
+    uint32_t popped_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(2, 8, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43);
+    test_spsc_queue_push(queue, 44); // in the second segment
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+        STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 2)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 4, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 44, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_150: [ The single consumer TQUEUE_POP_BATCH(T) shall use the array entry corresponding to the tail, looking in the segment following the tail segment like the single consumer TQUEUE_POP(T) does when the head is in a later segment than the tail. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_pops_the_items_from_the_next_segment_and_moves_the_tail_to_it)
+{
+    // arrange
+    int32_t items[4] = { 0 };
+    uint32_t popped_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(1, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+    test_spsc_queue_push(queue, 44); // in the second segment
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+        STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 3))); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 4, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 44, items[1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_152: [ If condition_function is not NULL, the single consumer TQUEUE_POP_BATCH(T) shall call condition_function with condition_function_context and a pointer to the array entry value of the first item only. ]*/
+/* Tests_SRS_TQUEUE_12_156: [ If a copy_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP_BATCH(T) shall call copy_item_function for each popped array entry with copy_item_function_context as context, a pointer to the corresponding item in items as pop_dst and a pointer to the array entry value as pop_src. ]*/
+/* Tests_SRS_TQUEUE_12_157: [ If a dispose_item_function was specified in TQUEUE_CREATE(T), the single consumer TQUEUE_POP_BATCH(T) shall call dispose_item_function for each popped array entry with dispose_item_function_context as context and a pointer to the array entry value as item. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_with_copy_item_function_and_condition_function_succeeds)
+{
+    // arrange
+    int32_t items[2] = { 0 };
+    uint32_t popped_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, test_copy_item, test_dispose_item, (void*)0x4242);
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(test_condition_function_true((void*)0x4247, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, &items[0], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(test_copy_item((void*)0x4243, &items[1], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_dispose_item((void*)0x4242, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 2)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 2, (void*)0x4243, test_condition_function_true, (void*)0x4247, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(int32_t, 42, items[0]);
+    ASSERT_ARE_EQUAL(int32_t, 43, items[1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_153: [ If condition_function returns false, the single consumer TQUEUE_POP_BATCH(T) shall return TQUEUE_POP_REJECTED. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_with_condition_function_returning_false_does_not_pop)
+{
+    // arrange
+    int32_t items[2] = { 0 };
+    uint32_t popped_item_count = 0x42;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(test_condition_function_false((void*)0x4247, IGNORED_ARG));
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 2, NULL, test_condition_function_false, (void*)0x4247, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_REJECTED, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0x42, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 1, TQUEUE_GET_VOLATILE_COUNT(SPSC_INT32)(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_161: [ If there are threads waiting in TQUEUE_PUSH_WAIT(T), the single consumer TQUEUE_POP_BATCH(T) shall increment the push wait sequence by calling interlocked_increment and wake all the threads by calling wake_by_address_all. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_BATCH_with_push_waiters_wakes_all_waiters)
+{
+    // arrange
+    int32_t items[2] = { 0 };
+    uint32_t popped_item_count;
+    TQUEUE(SPSC_INT32) queue = test_spsc_queue_create(4, 4, NULL, NULL, NULL);
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43);
+    THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->push_waiter_count = 1;
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+        STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    }
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 2)); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // push wait sequence
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP_BATCH(SPSC_INT32)(queue, items, 2, NULL, NULL, NULL, &popped_item_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, popped_item_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* TQUEUE_PUSH(T)/TQUEUE_POP(T) (single producer/single consumer) with shrinking */
+
+/* Tests_SRS_TQUEUE_12_228: [ If the queue was not created by TQUEUE_CREATE_WITH_SHRINK(T), if the head is in the first segment of its bank or if the queue is not empty, the push functions shall not shrink the queue. ]*/
+/* Tests_SRS_TQUEUE_12_178: [ After pushing, TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall update the high water mark with the number of items in the queue (the new head position - the tail position obtained earlier). ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_on_a_shrinking_queue_with_the_head_in_the_first_segment_does_not_shrink)
+{
+    // arrange
+    int32_t item = 42;
+    TQUEUE(SPSC_INT32) queue = TQUEUE_CREATE_WITH_SHRINK(SPSC_INT32)(2, 8, NULL, NULL, NULL, 1);
+    ASSERT_IS_NOT_NULL(queue);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, 1)); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0)); // high water mark
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_246: [ If the queue was created by TQUEUE_CREATE_WITH_SHRINK(T), after popping the pop functions shall free the segments retired by a shrink. ]*/
+/* Tests_SRS_TQUEUE_12_247: [ The pop functions shall obtain the current head and the current tail by calling interlocked_load_acquire_64. ]*/
+/* Tests_SRS_TQUEUE_12_249: [ Otherwise, the pop functions shall obtain the low occupancy pop count by calling interlocked_load_acquire. ]*/
+/* Tests_SRS_TQUEUE_12_186: [ Otherwise, the pop functions shall increment the low occupancy pop count by calling interlocked_increment. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_on_a_shrinking_queue_that_empties_the_queue_increments_the_low_occupancy_pop_count)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = TQUEUE_CREATE_WITH_SHRINK(SPSC_INT32)(1, 4, NULL, NULL, NULL, 1);
+    ASSERT_IS_NOT_NULL(queue);
+    umock_c_reset_all_calls();
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(1, 2))); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // low occupancy pop count
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 43, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, 1, THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->low_occupancy_pop_count);
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_219: [ TQUEUE_PUSH(T), TQUEUE_PUSH_BATCH(T) and the single producer TQUEUE_PUSH(T) and TQUEUE_PUSH_BATCH(T) shall shrink the queue as described below and retry if the head was moved. ]*/
+/* Tests_SRS_TQUEUE_12_235: [ The single producer push functions shall move the head to the first segment of the other bank, without changing the head position, by calling interlocked_store_release_64. ]*/
+TEST_FUNCTION(single_producer_TQUEUE_PUSH_on_an_empty_shrinking_queue_after_low_occupancy_pops_shrinks)
+{
+    // arrange
+    int32_t item = 44;
+    TQUEUE(SPSC_INT32) queue = TQUEUE_CREATE_WITH_SHRINK(SPSC_INT32)(1, 4, NULL, NULL, NULL, 1);
+    ASSERT_IS_NOT_NULL(queue);
+    umock_c_reset_all_calls();
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_spsc_queue_pop(queue));
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 2))); // head, to the first segment of the second bank
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL)); // third segment
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // low occupancy pop count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // operation count of the parity of the previous epoch
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TQUEUE_FREEING_RETIRED_SEGMENTS, 1)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // reclaim epoch
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // second segment
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // head change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // pop waiter count
+
+    // act
+    TQUEUE_PUSH_RESULT result = TQUEUE_PUSH(SPSC_INT32)(queue, &item, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->segments[1]);
+    ASSERT_ARE_EQUAL(uint32_t, 32, TQUEUE_GET_SEGMENT_INDEX(THANDLE_GET_T(TQUEUE_TYPEDEF_NAME(SPSC_INT32))(queue)->head));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
+/* Tests_SRS_TQUEUE_12_220: [ TQUEUE_POP(T), TQUEUE_POP_BATCH(T) and the single consumer TQUEUE_POP(T) and TQUEUE_POP_BATCH(T) shall move the tail to the bank of the head as described below and try again if the tail was moved. ]*/
+/* Tests_SRS_TQUEUE_12_244: [ If the queue is not empty and the tail is not in the bank of the head, the single consumer pop functions shall move the tail to the first segment of the bank of the head, without changing the tail position, by calling interlocked_store_release_64 and try again. ]*/
+TEST_FUNCTION(single_consumer_TQUEUE_POP_after_a_shrink_moves_the_tail_to_the_bank_of_the_head)
+{
+    // arrange
+    int32_t item = 45;
+    TQUEUE(SPSC_INT32) queue = TQUEUE_CREATE_WITH_SHRINK(SPSC_INT32)(1, 4, NULL, NULL, NULL, 1);
+    ASSERT_IS_NOT_NULL(queue);
+    umock_c_reset_all_calls();
+    test_spsc_queue_push(queue, 42);
+    test_spsc_queue_push(queue, 43); // in the second segment
+    ASSERT_ARE_EQUAL(int32_t, 42, test_spsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(int32_t, 43, test_spsc_queue_pop(queue));
+    test_spsc_queue_push(queue, 44); // shrinks
+
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 2))); // tail, to the bank of the head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release(IGNORED_ARG, QUEUE_ENTRY_STATE_NOT_USED)); // entry state
+    STRICT_EXPECTED_CALL(interlocked_store_release_64(IGNORED_ARG, TQUEUE_MAKE_HEAD_OR_TAIL(32, 3))); // tail change
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // push waiter count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire(IGNORED_ARG)); // retired segment count
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // head
+    STRICT_EXPECTED_CALL(interlocked_load_acquire_64(IGNORED_ARG)); // tail
+
+    // act
+    TQUEUE_POP_RESULT result = TQUEUE_POP(SPSC_INT32)(queue, &item, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(TQUEUE_POP_RESULT, TQUEUE_POP_OK, result);
+    ASSERT_ARE_EQUAL(int32_t, 44, item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the queue is usable again from the first segment
+    test_spsc_queue_push(queue, 46);
+    ASSERT_ARE_EQUAL(int32_t, 46, test_spsc_queue_pop(queue));
+
+    // clean
+    TQUEUE_ASSIGN(SPSC_INT32)(&queue, NULL);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
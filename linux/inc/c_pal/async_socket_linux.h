@@ -0,0 +1,52 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef ASYNC_SOCKET_LINUX_H
+#define ASYNC_SOCKET_LINUX_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "c_pal/execution_engine.h"
+#include "c_pal/async_socket.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*vectored transport, the callbacks behave like writev/readv and send/receive all the iovecs with one call*/
+typedef ssize_t (*ON_ASYNC_SOCKET_SENDV)(void* context, ASYNC_SOCKET_HANDLE async_socket, const struct iovec* iov, int iovcnt);
+typedef ssize_t (*ON_ASYNC_SOCKET_RECVV)(void* context, ASYNC_SOCKET_HANDLE async_socket, const struct iovec* iov, int iovcnt);
+
+MOCKABLE_FUNCTION(, ASYNC_SOCKET_HANDLE, async_socket_create_with_vectored_transport, EXECUTION_ENGINE_HANDLE, execution_engine, ON_ASYNC_SOCKET_SENDV, on_sendv, void*, on_sendv_context, ON_ASYNC_SOCKET_RECVV, on_recvv, void*, on_recvv_context);
+
+/*sends of at least zero_copy_send_threshold bytes are sent with MSG_ZEROCOPY and complete once the kernel released their pages, 0 turns zero copy off.
+Only for sockets created with async_socket_create, before async_socket_open_async. The sends abandoned by async_socket_close can still be referenced by the kernel.*/
+MOCKABLE_FUNCTION(, int, async_socket_set_zero_copy_send_threshold, ASYNC_SOCKET_HANDLE, async_socket, uint32_t, zero_copy_send_threshold);
+
+/*a pool of receive buffers of buffer_size bytes shared by sockets, keeping up to buffer_count free buffers.
+The buffers handed to the receive callbacks have to be returned with async_socket_buffer_pool_return before the pool is destroyed.*/
+typedef struct ASYNC_SOCKET_BUFFER_POOL_TAG* ASYNC_SOCKET_BUFFER_POOL_HANDLE;
+
+/*buffer is taken from the pool only when data arrives and is NULL unless receive_result is ASYNC_SOCKET_RECEIVE_OK*/
+typedef void (*ON_ASYNC_SOCKET_RECEIVE_POOLED_COMPLETE)(void* context, ASYNC_SOCKET_RECEIVE_RESULT receive_result, void* buffer, uint32_t bytes_received);
+
+MOCKABLE_FUNCTION(, ASYNC_SOCKET_BUFFER_POOL_HANDLE, async_socket_buffer_pool_create, uint32_t, buffer_size, uint32_t, buffer_count);
+MOCKABLE_FUNCTION(, void, async_socket_buffer_pool_destroy, ASYNC_SOCKET_BUFFER_POOL_HANDLE, buffer_pool);
+MOCKABLE_FUNCTION(, void, async_socket_buffer_pool_return, ASYNC_SOCKET_BUFFER_POOL_HANDLE, buffer_pool, void*, buffer);
+
+/*Only for sockets that are CLOSED, NULL turns the pooled receives off. The pool has to outlive the socket.*/
+MOCKABLE_FUNCTION(, int, async_socket_set_receive_buffer_pool, ASYNC_SOCKET_HANDLE, async_socket, ASYNC_SOCKET_BUFFER_POOL_HANDLE, buffer_pool);
+MOCKABLE_FUNCTION(, int, async_socket_receive_pooled_async, ASYNC_SOCKET_HANDLE, async_socket, ON_ASYNC_SOCKET_RECEIVE_POOLED_COMPLETE, on_receive_complete, void*, on_receive_complete_context);
+
+/*the receive stays started after on_receive_complete returns with ASYNC_SOCKET_RECEIVE_OK and receives the next data in the same buffers.
+It ends with one call of on_receive_complete with another result, once cancelled, closed or the connection ends. One continuous receive per socket.*/
+MOCKABLE_FUNCTION(, int, async_socket_receive_continuous_async, ASYNC_SOCKET_HANDLE, async_socket, ASYNC_SOCKET_BUFFER*, payload, uint32_t, buffer_count, ON_ASYNC_SOCKET_RECEIVE_COMPLETE, on_receive_complete, void*, on_receive_complete_context);
+MOCKABLE_FUNCTION(, int, async_socket_cancel_continuous_receive, ASYNC_SOCKET_HANDLE, async_socket);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASYNC_SOCKET_LINUX_H
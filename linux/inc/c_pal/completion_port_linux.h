@@ -6,15 +6,19 @@
 #ifdef __cplusplus
 #include <cstdint>
 #else
+#include <stdbool.h>
 #include <stdint.h>
 #endif
 
+#include <sys/socket.h>
+
 #include "macro_utils/macro_utils.h"
 #include "umock_c/umock_c_prod.h"
 
 #include "c_pal/socket_handle.h"
 
 typedef struct COMPLETION_PORT_TAG* COMPLETION_PORT_HANDLE;
+typedef struct COMPLETION_PORT_BUFFER_RING_TAG* COMPLETION_PORT_BUFFER_RING_HANDLE;
 
 #define COMPLETION_PORT_EPOLL_ACTION_VALUES \
     COMPLETION_PORT_EPOLL_EPOLLRDHUP, \
@@ -27,16 +31,61 @@ MU_DEFINE_ENUM(COMPLETION_PORT_EPOLL_ACTION, COMPLETION_PORT_EPOLL_ACTION_VALUES
 
 typedef void (*ON_COMPLETION_PORT_EVENT_COMPLETE)(void* context, COMPLETION_PORT_EPOLL_ACTION action);
 
+#define COMPLETION_PORT_ENGINE_VALUES \
+    COMPLETION_PORT_ENGINE_EPOLL, \
+    COMPLETION_PORT_ENGINE_IO_URING
+
+MU_DEFINE_ENUM(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_VALUES)
+
+#define COMPLETION_PORT_IO_TYPE_VALUES \
+    COMPLETION_PORT_IO_TYPE_SEND, \
+    COMPLETION_PORT_IO_TYPE_RECEIVE, \
+    COMPLETION_PORT_IO_TYPE_POLL, \
+    COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING
+
+MU_DEFINE_ENUM(COMPLETION_PORT_IO_TYPE, COMPLETION_PORT_IO_TYPE_VALUES)
+
+// result is the number of bytes transferred (send, receive) or the signaled poll events (poll) on success and a negative errno value on failure
+typedef void (*ON_COMPLETION_PORT_IO_COMPLETE)(void* context, int32_t result);
+
+// An operation submitted to the io_uring engine, owned by the caller until on_io_complete is called (with has_more false for a multishot receive)
+typedef struct COMPLETION_PORT_IO_TAG
+{
+    COMPLETION_PORT_IO_TYPE io_type;
+    // the message to send or receive into (COMPLETION_PORT_IO_TYPE_SEND, COMPLETION_PORT_IO_TYPE_RECEIVE)
+    struct msghdr* message;
+    // the poll events to wait for (COMPLETION_PORT_IO_TYPE_POLL)
+    uint32_t poll_events;
+    // the ring the kernel picks the buffer to receive into from, and whether the receive completes once per buffer until it ends (COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING)
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring;
+    bool is_multishot;
+    // set by the completion port before on_io_complete is called (COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING):
+    // the id of the buffer that holds the received data when has_buffer is true, and whether the multishot receive goes on
+    bool has_buffer;
+    uint16_t buffer_id;
+    bool has_more;
+    ON_COMPLETION_PORT_IO_COMPLETE on_io_complete;
+    void* on_io_complete_context;
+} COMPLETION_PORT_IO;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 MOCKABLE_FUNCTION(, COMPLETION_PORT_HANDLE, completion_port_create);
+MOCKABLE_FUNCTION(, COMPLETION_PORT_HANDLE, completion_port_create_with_thread_count, uint32_t, thread_count);
+MOCKABLE_FUNCTION(, COMPLETION_PORT_HANDLE, completion_port_create_with_engine, uint32_t, thread_count, COMPLETION_PORT_ENGINE, engine);
+MOCKABLE_FUNCTION(, COMPLETION_PORT_ENGINE, completion_port_get_engine, COMPLETION_PORT_HANDLE, completion_port);
 MOCKABLE_FUNCTION(, void, completion_port_inc_ref, COMPLETION_PORT_HANDLE, completion_port);
 MOCKABLE_FUNCTION(, void, completion_port_dec_ref, COMPLETION_PORT_HANDLE, completion_port);
 MOCKABLE_FUNCTION(, int, completion_port_add, COMPLETION_PORT_HANDLE, completion_port, int, epoll_op, SOCKET_HANDLE, socket,
     ON_COMPLETION_PORT_EVENT_COMPLETE, event_callback, void*, event_callback_ctx);
 MOCKABLE_FUNCTION(, void, completion_port_remove, COMPLETION_PORT_HANDLE, completion_port, SOCKET_HANDLE, socket);
+MOCKABLE_FUNCTION(, int, completion_port_submit_io, COMPLETION_PORT_HANDLE, completion_port, SOCKET_HANDLE, socket, COMPLETION_PORT_IO*, io);
+MOCKABLE_FUNCTION(, int, completion_port_cancel_io, COMPLETION_PORT_HANDLE, completion_port, SOCKET_HANDLE, socket, COMPLETION_PORT_IO*, io);
+MOCKABLE_FUNCTION(, COMPLETION_PORT_BUFFER_RING_HANDLE, completion_port_buffer_ring_create, COMPLETION_PORT_HANDLE, completion_port, SOCKET_HANDLE, socket, uint32_t, buffer_count);
+MOCKABLE_FUNCTION(, void, completion_port_buffer_ring_destroy, COMPLETION_PORT_BUFFER_RING_HANDLE, buffer_ring);
+MOCKABLE_FUNCTION(, int, completion_port_buffer_ring_add, COMPLETION_PORT_BUFFER_RING_HANDLE, buffer_ring, void*, buffer, uint32_t, buffer_size, uint16_t, buffer_id);
 
 #ifdef __cplusplus
 }
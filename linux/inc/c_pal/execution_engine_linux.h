@@ -4,8 +4,11 @@
 #define EXECUTION_ENGINE_LINUX_H
 
 #ifdef __cplusplus
+#include <cstddef>
 #include <cstdint>
 #else
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #endif
 
@@ -17,7 +20,16 @@
 extern "C" {
 #endif
 
+typedef struct EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS_TAG
+{
+    bool pin_to_numa_node; /*true to run the threads of the threadpool only on the CPUs of numa_node*/
+    uint32_t numa_node;
+    size_t thread_stack_size; /*stack size of the threadpool threads in bytes, 0 for the default*/
+} EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS;
+
+MOCKABLE_FUNCTION(, EXECUTION_ENGINE_HANDLE, execution_engine_linux_create, const EXECUTION_ENGINE_PARAMETERS*, execution_engine_parameters, const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS*, thread_parameters);
 MOCKABLE_FUNCTION(, const EXECUTION_ENGINE_PARAMETERS*, execution_engine_linux_get_parameters, EXECUTION_ENGINE_HANDLE, execution_engine);
+MOCKABLE_FUNCTION(, const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS*, execution_engine_linux_get_thread_parameters, EXECUTION_ENGINE_HANDLE, execution_engine);
 
 #ifdef __cplusplus
 }
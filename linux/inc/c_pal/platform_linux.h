@@ -4,6 +4,12 @@
 #ifndef PLATFORM_LINUX_H
 #define PLATFORM_LINUX_H
 
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
 #include "c_pal/completion_port_linux.h"
 
 #include "umock_c/umock_c_prod.h"
@@ -11,6 +17,8 @@
 extern "C" {
 #endif /* __cplusplus */
 
+    MOCKABLE_FUNCTION(, int, platform_linux_init, uint32_t, completion_port_thread_count);
+    MOCKABLE_FUNCTION(, int, platform_linux_init_with_engine, uint32_t, completion_port_thread_count, COMPLETION_PORT_ENGINE, engine);
     MOCKABLE_FUNCTION(, COMPLETION_PORT_HANDLE, platform_get_completion_port);
 
 #ifdef __cplusplus
@@ -0,0 +1,84 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef THREADPOOL_LINUX_H
+#define THREADPOOL_LINUX_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/thandle.h"
+#include "c_pal/threadpool.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct THREADPOOL_WORK_BATCH_ENTRY_TAG
+{
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+} THREADPOOL_WORK_BATCH_ENTRY;
+
+/*each priority has its own lane of task queues, workers drain the higher priority lanes first*/
+#define THREADPOOL_PRIORITY_VALUES \
+    THREADPOOL_PRIORITY_HIGH, \
+    THREADPOOL_PRIORITY_NORMAL, \
+    THREADPOOL_PRIORITY_LOW
+
+MU_DEFINE_ENUM_WITHOUT_INVALID(THREADPOOL_PRIORITY, THREADPOOL_PRIORITY_VALUES)
+
+#define THREADPOOL_PRIORITY_COUNT MU_COUNT_ARG(THREADPOOL_PRIORITY_VALUES)
+
+typedef struct THREADPOOL_LANE_STATISTICS_TAG
+{
+    uint64_t queue_depth; /*number of tasks waiting in the lane*/
+    uint64_t executed_count; /*number of tasks taken out of the lane by the workers*/
+    uint64_t total_wait_time_us; /*sum of the time the executed tasks spent waiting in the lane*/
+} THREADPOOL_LANE_STATISTICS;
+
+/*latencies are in microseconds, bucket 0 counts the latencies of 0 us and bucket n counts the latencies in [2^(n-1), 2^n - 1] us, the last bucket also counts all the larger latencies*/
+#define THREADPOOL_LATENCY_BUCKET_COUNT 32
+
+typedef struct THREADPOOL_LATENCY_HISTOGRAM_TAG
+{
+    uint64_t buckets[THREADPOOL_LATENCY_BUCKET_COUNT]; /*number of latencies that fell in each bucket*/
+    uint64_t total_latency_us; /*sum of all the latencies, for computing the average*/
+} THREADPOOL_LATENCY_HISTOGRAM;
+
+typedef struct THREADPOOL_STATISTICS_TAG
+{
+    uint64_t queue_depth; /*number of tasks waiting in all the lanes*/
+    uint32_t thread_count; /*number of live worker threads*/
+    uint32_t active_thread_count; /*number of worker threads draining the task queues*/
+    uint32_t idle_thread_count; /*number of worker threads waiting for work*/
+    uint64_t executed_count; /*number of tasks taken out of the task queues by the workers*/
+    THREADPOOL_LATENCY_HISTOGRAM wait_time; /*time from scheduling a task until it starts executing*/
+    THREADPOOL_LATENCY_HISTOGRAM execution_time; /*time spent executing the work functions*/
+} THREADPOOL_STATISTICS;
+
+MOCKABLE_FUNCTION(, uint32_t, threadpool_linux_get_thread_count, THANDLE(THREADPOOL), threadpool);
+
+MOCKABLE_FUNCTION(, int, threadpool_linux_schedule_work_batch, THANDLE(THREADPOOL), threadpool, const THREADPOOL_WORK_BATCH_ENTRY*, work_batch, uint32_t, work_batch_count);
+
+MOCKABLE_FUNCTION(, int, threadpool_linux_schedule_work_item_batch, THANDLE(THREADPOOL), threadpool, THANDLE(THREADPOOL_WORK_ITEM)*, threadpool_work_items, uint32_t, work_item_count);
+
+MOCKABLE_FUNCTION(, THANDLE(THREADPOOL_WORK_ITEM), threadpool_linux_create_work_item_with_priority, THANDLE(THREADPOOL), threadpool, THREADPOOL_PRIORITY, priority, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context);
+
+MOCKABLE_FUNCTION(, int, threadpool_linux_schedule_work_with_priority, THANDLE(THREADPOOL), threadpool, THREADPOOL_PRIORITY, priority, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context);
+
+MOCKABLE_FUNCTION(, int, threadpool_linux_get_lane_statistics, THANDLE(THREADPOOL), threadpool, THREADPOOL_PRIORITY, priority, THREADPOOL_LANE_STATISTICS*, lane_statistics);
+
+MOCKABLE_FUNCTION(, int, threadpool_linux_get_statistics, THANDLE(THREADPOOL), threadpool, THREADPOOL_STATISTICS*, statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THREADPOOL_LINUX_H
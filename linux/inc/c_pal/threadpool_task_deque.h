@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef THREADPOOL_TASK_DEQUE_H
+#define THREADPOOL_TASK_DEQUE_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/interlocked.h"
+#include "c_pal/tqueue_threadpool_task.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define THREADPOOL_TASK_DEQUE_RESULT_VALUES \
+    THREADPOOL_TASK_DEQUE_OK, \
+    THREADPOOL_TASK_DEQUE_EMPTY, \
+    THREADPOOL_TASK_DEQUE_FULL, \
+    THREADPOOL_TASK_DEQUE_ABORT, \
+    THREADPOOL_TASK_DEQUE_INVALID_ARGS
+
+MU_DEFINE_ENUM(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_RESULT_VALUES);
+
+/*bounded work stealing deque of threadpool tasks: only the thread owning the deque pushes and pops, at the bottom (LIFO), any other thread steals from the top (FIFO)*/
+typedef struct THREADPOOL_TASK_DEQUE_TAG
+{
+    volatile_atomic int64_t top; /*index of the oldest task, only ever incremented (by a steal or by the pop of the last task)*/
+    volatile_atomic int64_t bottom; /*index after the newest task, only written by the owner*/
+    uint32_t capacity_mask;
+    THREADPOOL_TASK* tasks;
+} THREADPOOL_TASK_DEQUE;
+
+MOCKABLE_FUNCTION(, int, threadpool_task_deque_init, THREADPOOL_TASK_DEQUE*, deque, uint32_t, capacity);
+MOCKABLE_FUNCTION(, void, threadpool_task_deque_deinit, THREADPOOL_TASK_DEQUE*, deque);
+
+/*owner APIs*/
+MOCKABLE_FUNCTION(, THREADPOOL_TASK_DEQUE_RESULT, threadpool_task_deque_push, THREADPOOL_TASK_DEQUE*, deque, const THREADPOOL_TASK*, task);
+MOCKABLE_FUNCTION(, THREADPOOL_TASK_DEQUE_RESULT, threadpool_task_deque_pop, THREADPOOL_TASK_DEQUE*, deque, THREADPOOL_TASK*, task);
+
+/*thief APIs*/
+MOCKABLE_FUNCTION(, THREADPOOL_TASK_DEQUE_RESULT, threadpool_task_deque_steal, THREADPOOL_TASK_DEQUE*, deque, THREADPOOL_TASK*, task);
+MOCKABLE_FUNCTION(, int64_t, threadpool_task_deque_get_volatile_count, THREADPOOL_TASK_DEQUE*, deque);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THREADPOOL_TASK_DEQUE_H */
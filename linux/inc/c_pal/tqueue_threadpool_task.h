@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef TQUEUE_THREADPOOL_TASK_H
+#define TQUEUE_THREADPOOL_TASK_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "c_pal/thandle.h"
+#include "c_pal/tqueue.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*a task queued in the threadpool, the work function and its context are stored by value in the queue so that scheduling work does not allocate memory*/
+typedef struct THREADPOOL_TASK_TAG
+{
+    void (*work_function)(void* context);
+    void* work_function_ctx;
+    int64_t enqueue_time_us; /*time when the task was queued, used for the wait time statistics of the priority lanes*/
+} THREADPOOL_TASK;
+
+TQUEUE_DEFINE_STRUCT_TYPE(THREADPOOL_TASK);
+
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(THREADPOOL_TASK));
+TQUEUE_TYPE_DECLARE(THREADPOOL_TASK);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TQUEUE_THREADPOOL_TASK_H */
@@ -17,11 +17,20 @@
     MU_FOR_EACH_1(R2,                                       \
         async_socket_create,                                \
         async_socket_create_with_transport,                 \
+        async_socket_create_with_vectored_transport,        \
+        async_socket_set_zero_copy_send_threshold,          \
+        async_socket_buffer_pool_create,                    \
+        async_socket_buffer_pool_destroy,                   \
+        async_socket_buffer_pool_return,                    \
+        async_socket_set_receive_buffer_pool,               \
         async_socket_destroy,                               \
         async_socket_open_async,                            \
         async_socket_close,                                 \
         async_socket_send_async,                            \
         async_socket_receive_async,                         \
+        async_socket_receive_pooled_async,                  \
+        async_socket_receive_continuous_async,              \
+        async_socket_cancel_continuous_receive,             \
         async_socket_notify_io_async                        \
     )
 
@@ -31,12 +40,21 @@ extern "C" {
 
     ASYNC_SOCKET_HANDLE real_async_socket_create(EXECUTION_ENGINE_HANDLE execution_engine);
     ASYNC_SOCKET_HANDLE real_async_socket_create_with_transport(EXECUTION_ENGINE_HANDLE execution_engine, ON_ASYNC_SOCKET_SEND on_send, void* on_send_context, ON_ASYNC_SOCKET_RECV on_recv, void* on_recv_context);
+    ASYNC_SOCKET_HANDLE real_async_socket_create_with_vectored_transport(EXECUTION_ENGINE_HANDLE execution_engine, ON_ASYNC_SOCKET_SENDV on_sendv, void* on_sendv_context, ON_ASYNC_SOCKET_RECVV on_recvv, void* on_recvv_context);
+    int real_async_socket_set_zero_copy_send_threshold(ASYNC_SOCKET_HANDLE async_socket, uint32_t zero_copy_send_threshold);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE real_async_socket_buffer_pool_create(uint32_t buffer_size, uint32_t buffer_count);
+    void real_async_socket_buffer_pool_destroy(ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool);
+    void real_async_socket_buffer_pool_return(ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool, void* buffer);
+    int real_async_socket_set_receive_buffer_pool(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool);
     void real_async_socket_destroy(ASYNC_SOCKET_HANDLE async_socket);
 
     int real_async_socket_open_async(ASYNC_SOCKET_HANDLE async_socket, SOCKET_HANDLE socket_handle, ON_ASYNC_SOCKET_OPEN_COMPLETE on_open_complete, void* on_open_complete_context);
     void real_async_socket_close(ASYNC_SOCKET_HANDLE async_socket);
     ASYNC_SOCKET_SEND_SYNC_RESULT real_async_socket_send_async(ASYNC_SOCKET_HANDLE async_socket, const ASYNC_SOCKET_BUFFER* payload, uint32_t buffer_count, ON_ASYNC_SOCKET_SEND_COMPLETE on_send_complete, void* on_send_complete_context);
     int real_async_socket_receive_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER* payload, uint32_t buffer_count, ON_ASYNC_SOCKET_RECEIVE_COMPLETE on_receive_complete, void* on_receive_complete_context);
+    int real_async_socket_receive_pooled_async(ASYNC_SOCKET_HANDLE async_socket, ON_ASYNC_SOCKET_RECEIVE_POOLED_COMPLETE on_receive_complete, void* on_receive_complete_context);
+    int real_async_socket_receive_continuous_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER* payload, uint32_t buffer_count, ON_ASYNC_SOCKET_RECEIVE_COMPLETE on_receive_complete, void* on_receive_complete_context);
+    int real_async_socket_cancel_continuous_receive(ASYNC_SOCKET_HANDLE async_socket);
     int real_async_socket_notify_io_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE io_type, ON_ASYNC_SOCKET_NOTIFY_IO_COMPLETE on_notify_io_complete, void* on_notify_io_complete_context);
 #ifdef __cplusplus
 }
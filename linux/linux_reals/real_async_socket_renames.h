@@ -2,11 +2,20 @@
 
 #define async_socket_create                   real_async_socket_create
 #define async_socket_create_with_transport    real_async_socket_create_with_transport
+#define async_socket_create_with_vectored_transport real_async_socket_create_with_vectored_transport
+#define async_socket_set_zero_copy_send_threshold real_async_socket_set_zero_copy_send_threshold
+#define async_socket_buffer_pool_create       real_async_socket_buffer_pool_create
+#define async_socket_buffer_pool_destroy      real_async_socket_buffer_pool_destroy
+#define async_socket_buffer_pool_return       real_async_socket_buffer_pool_return
+#define async_socket_set_receive_buffer_pool  real_async_socket_set_receive_buffer_pool
 #define async_socket_destroy                  real_async_socket_destroy
 #define async_socket_open_async               real_async_socket_open_async
 #define async_socket_close                    real_async_socket_close
 #define async_socket_send_async               real_async_socket_send_async
 #define async_socket_receive_async            real_async_socket_receive_async
+#define async_socket_receive_pooled_async     real_async_socket_receive_pooled_async
+#define async_socket_receive_continuous_async real_async_socket_receive_continuous_async
+#define async_socket_cancel_continuous_receive real_async_socket_cancel_continuous_receive
 #define async_socket_notify_io_async          real_async_socket_notify_io_async
 
 #define ASYNC_SOCKET_SEND_SYNC_RESULT         real_ASYNC_SOCKET_SEND_SYNC_RESULT
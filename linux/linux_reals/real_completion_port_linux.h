@@ -10,6 +10,7 @@
 #define REGISTER_COMPLETION_PORT_LINUX_GLOBAL_MOCK_HOOK()   \
     MU_FOR_EACH_1(R2,                                       \
         completion_port_create,                             \
+        completion_port_create_with_thread_count,           \
         completion_port_inc_ref,                            \
         completion_port_dec_ref,                            \
         completion_port_add,                                \
@@ -21,6 +22,7 @@ extern "C" {
 #endif
 
     COMPLETION_PORT_HANDLE real_completion_port_create(void);
+    COMPLETION_PORT_HANDLE real_completion_port_create_with_thread_count(uint32_t thread_count);
     void real_completion_port_inc_ref(COMPLETION_PORT_HANDLE completion_port);
     void real_completion_port_dec_ref(COMPLETION_PORT_HANDLE completion_port);
     int real_completion_port_add(COMPLETION_PORT_HANDLE completion_port, int epoll_op, SOCKET_HANDLE socket, ON_COMPLETION_PORT_EVENT_COMPLETE event_callback, void* event_callback_ctx);
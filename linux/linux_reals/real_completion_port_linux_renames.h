@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft. All rights reserved.
 
 #define completion_port_create                 real_completion_port_create
+#define completion_port_create_with_thread_count real_completion_port_create_with_thread_count
 #define completion_port_inc_ref                real_completion_port_inc_ref
 #define completion_port_dec_ref                real_completion_port_dec_ref
 #define completion_port_add                    real_completion_port_add
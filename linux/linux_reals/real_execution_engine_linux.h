@@ -15,7 +15,9 @@
 
 #define REGISTER_EXECUTION_ENGINE_LINUX_GLOBAL_MOCK_HOOK()          \
     MU_FOR_EACH_1(R2,                                   \
-        execution_engine_linux_get_parameters \
+        execution_engine_linux_get_parameters, \
+        execution_engine_linux_create, \
+        execution_engine_linux_get_thread_parameters \
     )
 
 #ifdef __cplusplus
@@ -23,6 +25,8 @@ extern "C" {
 #endif
 
     const EXECUTION_ENGINE_PARAMETERS* real_execution_engine_linux_get_parameters(EXECUTION_ENGINE_HANDLE execution_engine);
+    EXECUTION_ENGINE_HANDLE real_execution_engine_linux_create(const EXECUTION_ENGINE_PARAMETERS* execution_engine_parameters, const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* thread_parameters);
+    const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* real_execution_engine_linux_get_thread_parameters(EXECUTION_ENGINE_HANDLE execution_engine);
 
 #ifdef __cplusplus
 }
@@ -1,3 +1,5 @@
 // Copyright (c) Microsoft. All rights reserved.
 
 #define execution_engine_linux_get_parameters     real_execution_engine_linux_get_parameters
+#define execution_engine_linux_create             real_execution_engine_linux_create
+#define execution_engine_linux_get_thread_parameters real_execution_engine_linux_get_thread_parameters
@@ -23,4 +23,6 @@
 
 #include "real_lazy_init_renames.h"
 
+#include "real_timer_renames.h"
+
 #include "../src/threadpool_linux.c"
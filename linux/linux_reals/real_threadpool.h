@@ -9,6 +9,7 @@
 #include "macro_utils/macro_utils.h"
 
 #include "c_pal/thandle.h"
+#include "c_pal/threadpool_linux.h"
 
 #define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
 
@@ -55,6 +56,14 @@ extern "C" {
     int real_threadpool_timer_restart(THANDLE(THREADPOOL_TIMER) timer, uint32_t start_delay_ms, uint32_t timer_period_ms);
     void real_threadpool_timer_cancel(THANDLE(THREADPOOL_TIMER) timer);
 
+    uint32_t real_threadpool_linux_get_thread_count(THANDLE(THREADPOOL) threadpool);
+    int real_threadpool_linux_schedule_work_batch(THANDLE(THREADPOOL) threadpool, const THREADPOOL_WORK_BATCH_ENTRY* work_batch, uint32_t work_batch_count);
+    int real_threadpool_linux_schedule_work_item_batch(THANDLE(THREADPOOL) threadpool, THANDLE(THREADPOOL_WORK_ITEM)* threadpool_work_items, uint32_t work_item_count);
+    THANDLE(THREADPOOL_WORK_ITEM) real_threadpool_linux_create_work_item_with_priority(THANDLE(THREADPOOL) threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context);
+    int real_threadpool_linux_schedule_work_with_priority(THANDLE(THREADPOOL) threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context);
+    int real_threadpool_linux_get_lane_statistics(THANDLE(THREADPOOL) threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_LANE_STATISTICS* lane_statistics);
+    int real_threadpool_linux_get_statistics(THANDLE(THREADPOOL) threadpool, THREADPOOL_STATISTICS* statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,6 +3,7 @@
 
 #define THREADPOOL                      real_THREADPOOL
 #define THREADPOOL_WORK_ITEM            real_THREADPOOL_WORK_ITEM
+#define THREADPOOL_TASK                 real_THREADPOOL_TASK
 #define THREADPOOL_TIMER                real_THREADPOOL_TIMER
 
 #define threadpool_create               real_threadpool_create
@@ -13,7 +14,15 @@
 #define threadpool_timer_start          real_threadpool_timer_start
 #define threadpool_timer_restart        real_threadpool_timer_restart
 #define threadpool_timer_cancel         real_threadpool_timer_cancel
+#define threadpool_linux_get_thread_count real_threadpool_linux_get_thread_count
+#define threadpool_linux_schedule_work_batch real_threadpool_linux_schedule_work_batch
+#define threadpool_linux_schedule_work_item_batch real_threadpool_linux_schedule_work_item_batch
+#define threadpool_linux_create_work_item_with_priority real_threadpool_linux_create_work_item_with_priority
+#define threadpool_linux_schedule_work_with_priority real_threadpool_linux_schedule_work_with_priority
+#define threadpool_linux_get_lane_statistics real_threadpool_linux_get_lane_statistics
+#define threadpool_linux_get_statistics real_threadpool_linux_get_statistics
 
 #define TASK_RESULT                     real_TASK_RESULT
 #define THREADPOOL_STATE                real_THREADPOOL_STATE
 #define TIMER_STATE                     real_TIMER_STATE
+#define THREADPOOL_THREAD_STATE         real_THREADPOOL_THREAD_STATE
@@ -0,0 +1,9 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "real_gballoc_hl_renames.h" // IWYU pragma: keep
+#include "real_interlocked_renames.h" // IWYU pragma: keep
+
+#include "real_threadpool_task_deque_renames.h" // IWYU pragma: keep
+
+#include "../src/threadpool_task_deque.c"
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_THREADPOOL_TASK_DEQUE_H
+#define REAL_THREADPOOL_TASK_DEQUE_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/threadpool_task_deque.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_THREADPOOL_TASK_DEQUE_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        threadpool_task_deque_init, \
+        threadpool_task_deque_deinit, \
+        threadpool_task_deque_push, \
+        threadpool_task_deque_pop, \
+        threadpool_task_deque_steal, \
+        threadpool_task_deque_get_volatile_count \
+)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int real_threadpool_task_deque_init(THREADPOOL_TASK_DEQUE* deque, uint32_t capacity);
+void real_threadpool_task_deque_deinit(THREADPOOL_TASK_DEQUE* deque);
+THREADPOOL_TASK_DEQUE_RESULT real_threadpool_task_deque_push(THREADPOOL_TASK_DEQUE* deque, const THREADPOOL_TASK* task);
+THREADPOOL_TASK_DEQUE_RESULT real_threadpool_task_deque_pop(THREADPOOL_TASK_DEQUE* deque, THREADPOOL_TASK* task);
+THREADPOOL_TASK_DEQUE_RESULT real_threadpool_task_deque_steal(THREADPOOL_TASK_DEQUE* deque, THREADPOOL_TASK* task);
+int64_t real_threadpool_task_deque_get_volatile_count(THREADPOOL_TASK_DEQUE* deque);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REAL_THREADPOOL_TASK_DEQUE_H
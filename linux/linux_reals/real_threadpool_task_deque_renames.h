@@ -0,0 +1,9 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define threadpool_task_deque_init                  real_threadpool_task_deque_init
+#define threadpool_task_deque_deinit                real_threadpool_task_deque_deinit
+#define threadpool_task_deque_push                  real_threadpool_task_deque_push
+#define threadpool_task_deque_pop                   real_threadpool_task_deque_pop
+#define threadpool_task_deque_steal                 real_threadpool_task_deque_steal
+#define threadpool_task_deque_get_volatile_count    real_threadpool_task_deque_get_volatile_count
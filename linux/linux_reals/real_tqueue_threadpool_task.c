@@ -5,10 +5,9 @@
 #include "real_gballoc_hl_renames.h"
 #include "c_pal/gballoc_hl_redirect.h"
 
-#include "real_srw_lock_ll_renames.h"
-#include "real_tqueue_threadpool_work_item_renames.h"
+#include "real_tqueue_threadpool_task_renames.h"
 
 #include "c_pal/thandle_ll.h"
 #include "c_pal/tqueue_ll.h"
 
-#include "../src/tqueue_threadpool_work_item.c"
+#include "../src/tqueue_threadpool_task.c"
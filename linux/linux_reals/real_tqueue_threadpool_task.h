@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_TQUEUE_THREADPOOL_TASK_H
+#define REAL_TQUEUE_THREADPOOL_TASK_H
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/tqueue_ll.h"
+#include "c_pal/tqueue.h"
+
+#include "../inc/c_pal/tqueue_threadpool_task.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_TQUEUE_THREADPOOL_TASK_GLOBAL_MOCK_HOOK() \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_PUSH(THREADPOOL_TASK), (void*)TQUEUE_PUSH(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_POP(THREADPOOL_TASK), (void*)TQUEUE_POP(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_PUSH_BATCH(THREADPOOL_TASK), (void*)TQUEUE_PUSH_BATCH(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_POP_BATCH(THREADPOOL_TASK), (void*)TQUEUE_POP_BATCH(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK), (void*)TQUEUE_GET_VOLATILE_COUNT(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_CREATE(THREADPOOL_TASK), (void*)TQUEUE_CREATE(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_MOVE(THREADPOOL_TASK), (void*)TQUEUE_MOVE(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_INITIALIZE(THREADPOOL_TASK), (void*)TQUEUE_INITIALIZE(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_INITIALIZE_MOVE(THREADPOOL_TASK), (void*)TQUEUE_INITIALIZE_MOVE(real_THREADPOOL_TASK)) \
+    REGISTER_GLOBAL_MOCK_HOOK(TQUEUE_ASSIGN(THREADPOOL_TASK), (void*)TQUEUE_ASSIGN(real_THREADPOOL_TASK)) \
+
+#include "umock_c/umock_c_prod.h"
+
+typedef THREADPOOL_TASK real_THREADPOOL_TASK;
+
+TQUEUE_DEFINE_STRUCT_TYPE(real_THREADPOOL_TASK);
+
+THANDLE_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(real_THREADPOOL_TASK));
+TQUEUE_TYPE_DECLARE(real_THREADPOOL_TASK);
+
+//TQUEUE_LL_TYPE_DECLARE(TQUEUE_TYPEDEF_NAME(THREADPOOL_TASK), TQUEUE_TYPEDEF_NAME(real_THREADPOOL_TASK));
+
+#endif // REAL_TQUEUE_THREADPOOL_TASK_H
@@ -2,5 +2,7 @@
 // Licensed under the MIT license.See LICENSE file in the project root for full license information.
 
 #include "real_interlocked_renames.h"
+#include "real_sync_renames.h"
+#include "real_timer_renames.h"
 
-#define THREADPOOL_WORK_ITEM real_THREADPOOL_WORK_ITEM
+#define THREADPOOL_TASK real_THREADPOOL_TASK
@@ -2,12 +2,17 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 #include <unistd.h>
 #include <errno.h>
+#include <poll.h>
 
 #include <sys/epoll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <linux/errqueue.h>
 
 #include "macro_utils/macro_utils.h"
 
@@ -18,11 +23,13 @@
 #include "c_logging/log_level.h"
 
 #include "c_pal/completion_port_linux.h"
+#include "c_pal/containing_record.h"
 #include "c_pal/execution_engine.h"
 #include "c_pal/gballoc_hl.h"        // IWYU pragma: keep
 #include "c_pal/gballoc_hl_redirect.h"
 #include "c_pal/interlocked.h"
 #include "c_pal/platform_linux.h"
+#include "c_pal/srw_lock_ll.h"
 #include "c_pal/sync.h"
 #include "c_pal/socket_handle.h"
 
@@ -31,6 +38,23 @@
 #endif
 
 #include "c_pal/async_socket.h"
+#include "c_pal/async_socket_linux.h"
+
+// sends of up to this many buffers are tried on the calling thread with iovecs on the stack, larger ones go through the send queue
+#define ASYNC_SOCKET_INLINE_SEND_IOVEC_COUNT 16
+
+// queued sends are coalesced into one on_sendv call for as long as all their iovecs fit in this many iovecs on the stack
+#define ASYNC_SOCKET_COALESCED_SEND_IOVEC_COUNT 64
+
+// a socket that is abandoned or fails polls at most this many times, for this long each, for the kernel to release the pages of its zero copy sends
+#define ASYNC_SOCKET_ZERO_COPY_RELEASE_POLL_COUNT 10
+#define ASYNC_SOCKET_ZERO_COPY_RELEASE_POLL_TIMEOUT_MS 100
+
+// the pool buffers a socket with a receive buffer pool lends to the kernel to receive in when it uses io_uring (a power of 2)
+#define ASYNC_SOCKET_RING_BUFFER_COUNT 8
+
+// room for the sock_extended_err of one error queue message and the address that follows it
+#define ASYNC_SOCKET_ERROR_QUEUE_CONTROL_SIZE CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))
 
 #define ASYNC_SOCKET_LINUX_STATE_VALUES \
     ASYNC_SOCKET_LINUX_STATE_CLOSED, \
@@ -55,109 +79,376 @@ MU_DEFINE_ENUM_STRINGS(ASYNC_SOCKET_SEND_RESULT, ASYNC_SOCKET_SEND_RESULT_VALUES
 MU_DEFINE_ENUM_STRINGS(ASYNC_SOCKET_NOTIFY_IO_TYPE, ASYNC_SOCKET_NOTIFY_IO_TYPE_VALUES)
 MU_DEFINE_ENUM_STRINGS(ASYNC_SOCKET_NOTIFY_IO_RESULT, ASYNC_SOCKET_NOTIFY_IO_RESULT_VALUES)
 
+// The socket is registered once with the completion port (edge triggered), so the operations that cannot complete
+// right away wait in a queue per direction until the completion port signals that the socket became ready
+typedef struct ASYNC_SOCKET_IO_QUEUE_TAG
+{
+    struct ASYNC_SOCKET_IO_CONTEXT_TAG* head;
+    struct ASYNC_SOCKET_IO_CONTEXT_TAG* tail;
+    // the socket can be read (receive queue) or written (send queue) without blocking
+    bool is_ready;
+    // a thread is completing the operations in the queue, any other thread only adds to the queue
+    bool is_completing;
+    // the peer closed the connection, no more readiness events are coming so the socket stays ready
+    bool is_shut_down;
+} ASYNC_SOCKET_IO_QUEUE;
+
+// a receive buffer of a pool, linked in the free buffers of the pool while nobody uses it
+// and in the received buffers of the socket once the kernel received in it from the buffer ring
+typedef struct ASYNC_SOCKET_POOLED_BUFFER_TAG
+{
+    struct ASYNC_SOCKET_POOLED_BUFFER_TAG* next;
+    // buffer ring only: the buffer id the buffer is lent to the kernel with, and the received bytes the receives did not take yet
+    uint16_t buffer_id;
+    uint32_t received_offset;
+    uint32_t received_size;
+    unsigned char data[];
+} ASYNC_SOCKET_POOLED_BUFFER;
+
+typedef struct ASYNC_SOCKET_BUFFER_POOL_TAG
+{
+    uint32_t buffer_size;
+    // the pool allocates more buffers when it has no free buffer and keeps at most this many free buffers
+    uint32_t max_free_buffer_count;
+    // protects the free buffers
+    SRW_LOCK_LL lock;
+    ASYNC_SOCKET_POOLED_BUFFER* free_buffers;
+    uint32_t free_buffer_count;
+} ASYNC_SOCKET_BUFFER_POOL;
+
 typedef struct ASYNC_SOCKET_TAG
 {
     int socket_handle;
     volatile_atomic int32_t state;
     volatile_atomic int32_t pending_api_calls;
     COMPLETION_PORT_HANDLE completion_port;
-    volatile_atomic int32_t added_to_completion_port;
+    ON_ASYNC_SOCKET_SENDV on_sendv;
+    void* on_sendv_context;
+    ON_ASYNC_SOCKET_RECVV on_recvv;
+    void* on_recvv_context;
+    // the transport that is not vectored, called for each iovec by on_transport_sendv and on_transport_recvv
     ON_ASYNC_SOCKET_SEND on_send;
     void* on_send_context;
     ON_ASYNC_SOCKET_RECV on_recv;
     void* on_recv_context;
+    // protects the queues
+    SRW_LOCK_LL lock;
+    // receives and IN notifications
+    ASYNC_SOCKET_IO_QUEUE receive_queue;
+    // sends and OUT notifications
+    ASYNC_SOCKET_IO_QUEUE send_queue;
+    // the operations are submitted to the io_uring of the completion port instead of being performed when the socket is ready
+    bool is_io_uring;
+    // io_uring only: the notifications that are submitted, the receives and sends are submitted one at a time from the head of their queue
+    ASYNC_SOCKET_IO_QUEUE notify_queue;
+    // io_uring only: the operations submitted to the completion port that did not complete yet
+    volatile_atomic int32_t pending_io_count;
+    // sends of at least this many bytes are sent with MSG_ZEROCOPY, 0 when zero copy is off
+    uint32_t zero_copy_send_threshold;
+    // the sequence number the kernel gives to the next successful MSG_ZEROCOPY sendmsg
+    uint32_t zero_copy_next_sequence;
+    // the zero copy send that is partially sent, its pages can be released before it is sent entirely
+    struct ASYNC_SOCKET_IO_CONTEXT_TAG* zero_copy_sending_io_context;
+    // the sends that were sent and wait for the kernel to release the pages of the zero copy sends, completed in order
+    ASYNC_SOCKET_IO_QUEUE zero_copy_queue;
+    // the pool the pooled receives take their buffer from once data arrives, NULL when pooled receives are off
+    ASYNC_SOCKET_BUFFER_POOL* receive_buffer_pool;
+    // the receive started by async_socket_receive_continuous_async, NULL when there is none or it was cancelled
+    struct ASYNC_SOCKET_IO_CONTEXT_TAG* continuous_receive_io_context;
+    // io_uring with a receive buffer pool only: the kernel receives in pool buffers it picks from this ring, NULL otherwise;
+    // the receives then wait in the receive queue and take the data of the received buffers, the same way they call recvmsg with epoll
+    COMPLETION_PORT_BUFFER_RING_HANDLE receive_buffer_ring;
+    // the pool buffer lent to the kernel under each buffer id, NULL when a pooled receive took it and no buffer could replace it
+    ASYNC_SOCKET_POOLED_BUFFER* ring_buffers[ASYNC_SOCKET_RING_BUFFER_COUNT];
+    // how many buffers the kernel can receive in
+    uint32_t ring_buffer_count;
+    // the buffers the kernel received in, in the order of the stream, until the receives take their data
+    ASYNC_SOCKET_POOLED_BUFFER* received_buffers_head;
+    ASYNC_SOCKET_POOLED_BUFFER* received_buffers_tail;
+    // the receive that picks its buffers from the ring, multishot unless the kernel rejects it (before 6.0)
+    COMPLETION_PORT_IO ring_receive_io;
+    bool is_ring_receive_submitted;
+    bool is_ring_receive_multishot;
+    // the stream ended with ring_receive_result (0 when the peer closed the connection, a negative errno otherwise)
+    bool is_ring_receive_ended;
+    int32_t ring_receive_result;
 } ASYNC_SOCKET;
 
-typedef struct ASYNC_SOCKET_RECV_CONTEXT_TAG
-{
-    uint32_t total_buffer_count;
-    ASYNC_SOCKET_BUFFER recv_buffers[];
-} ASYNC_SOCKET_RECV_CONTEXT;
-
-typedef struct ASYNC_SOCKET_SEND_CONTEXT_TAG
+// the buffers of a send or a receive as one message
+typedef struct ASYNC_SOCKET_MESSAGE_CONTEXT_TAG
 {
+    // what is left to send, the iovecs before message.msg_iov have been sent
     uint32_t total_buffer_bytes;
-    ASYNC_SOCKET_BUFFER socket_buffer;
-} ASYNC_SOCKET_SEND_CONTEXT;
+    struct msghdr message;
+    struct iovec iovecs[];
+} ASYNC_SOCKET_MESSAGE_CONTEXT;
 
 typedef struct ASYNC_SOCKET_IO_CONTEXT_TAG
 {
     ASYNC_SOCKET_IO_TYPE io_type;
     ON_ASYNC_SOCKET_RECEIVE_COMPLETE on_receive_complete;
+    // receives only: the receive has no buffers and takes one from the receive buffer pool of the socket once data arrives
+    bool is_pooled;
+    ON_ASYNC_SOCKET_RECEIVE_POOLED_COMPLETE on_receive_pooled_complete;
+    // receives only: the receive is not freed when it receives data but receives again in the same buffers
+    bool is_continuous;
     ON_ASYNC_SOCKET_SEND_COMPLETE on_send_complete;
     ON_ASYNC_SOCKET_NOTIFY_IO_COMPLETE on_notify_io_complete;
     void* callback_context;
     ASYNC_SOCKET* async_socket;
-    union
-    {
-        ASYNC_SOCKET_SEND_CONTEXT send_ctx;
-        ASYNC_SOCKET_RECV_CONTEXT recv_ctx;
-    } data;
+    struct ASYNC_SOCKET_IO_CONTEXT_TAG* next;
+    // io_uring only: the operation submitted to the completion port
+    COMPLETION_PORT_IO completion_port_io;
+    // sends only: the payload is sent with MSG_ZEROCOPY and the send completes once the kernel released all its pages
+    bool is_zero_copy;
+    // the sequence numbers of the MSG_ZEROCOPY sendmsg calls of the send and how many of them the kernel released
+    uint32_t zero_copy_first_sequence;
+    uint32_t zero_copy_sequence_count;
+    uint32_t zero_copy_released_count;
+    // the result the send completes with once it leaves the zero copy queue
+    ASYNC_SOCKET_SEND_RESULT send_result;
+    // sends and receives only
+    ASYNC_SOCKET_MESSAGE_CONTEXT message_ctx;
 } ASYNC_SOCKET_IO_CONTEXT;
 
-static int on_socket_send(void* context, ASYNC_SOCKET_HANDLE async_socket, const void* buf, size_t len)
+static ssize_t on_socket_sendv(void* context, ASYNC_SOCKET_HANDLE async_socket, const struct iovec* iov, int iovcnt)
 {
-    int result;
+    ssize_t result;
 
     (void)context;
 
     if (async_socket == NULL)
     {
-        LogCritical("Invalid argument on_send void* context, ASYNC_SOCKET_HANDLE async_socket, const void* buf, size_t len");
+        LogCritical("Invalid argument on_sendv void* context, ASYNC_SOCKET_HANDLE async_socket, const struct iovec* iov, int iovcnt");
         result = -1;
     }
     else
     {
-        // Codes_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_send shall attempt to send the data by calling send with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
-        result = send(async_socket->socket_handle, buf, len, MSG_NOSIGNAL);
+        struct msghdr message;
+        (void)memset(&message, 0, sizeof(message));
+        message.msg_iov = (struct iovec*)iov;
+        message.msg_iovlen = iovcnt;
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_sendv shall send all the iovecs by calling sendmsg with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
+        result = sendmsg(async_socket->socket_handle, &message, MSG_NOSIGNAL);
     }
 
     return result;
 }
 
-static int on_socket_recv(void* context, ASYNC_SOCKET_HANDLE async_socket, void* buf, size_t len)
+static ssize_t on_socket_recvv(void* context, ASYNC_SOCKET_HANDLE async_socket, const struct iovec* iov, int iovcnt)
 {
-    int result;
+    ssize_t result;
 
     (void)context;
 
     if (async_socket == NULL)
     {
-        LogCritical("Invalid argument on_recv void* context, ASYNC_SOCKET_HANDLE async_socket, const void* buf, size_t len");
+        LogCritical("Invalid argument on_recvv void* context, ASYNC_SOCKET_HANDLE async_socket, const struct iovec* iov, int iovcnt");
         result = -1;
     }
     else
     {
-        // Codes_SRS_ASYNC_SOCKET_LINUX_04_007: [ on_socket_recv shall attempt to receive data by calling the system recv socket API. ]
-        result = recv(async_socket->socket_handle, buf, len, 0);
+        struct msghdr message;
+        (void)memset(&message, 0, sizeof(message));
+        message.msg_iov = (struct iovec*)iov;
+        message.msg_iovlen = iovcnt;
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_04_007: [ on_socket_recvv shall receive in all the iovecs by calling the system recvmsg socket API. ]
+        result = recvmsg(async_socket->socket_handle, &message, 0);
+    }
+
+    return result;
+}
+
+// the on_sendv callback of a socket created with async_socket_create_with_transport
+static ssize_t on_transport_sendv(void* context, ASYNC_SOCKET_HANDLE async_socket, const struct iovec* iov, int iovcnt)
+{
+    ssize_t result = 0;
+
+    (void)context;
+
+    for (int index = 0; index < iovcnt; index++)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_052: [ on_transport_sendv shall call on_send for each iovec, for as long as on_send sends the whole iovec. ]
+        int send_size = async_socket->on_send(async_socket->on_send_context, async_socket, iov[index].iov_base, iov[index].iov_len);
+        if (send_size < 0)
+        {
+            if (result == 0)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_053: [ If on_send fails before any byte was sent, on_transport_sendv shall return -1. ]
+                result = -1;
+            }
+            // otherwise the error is reported by the next send
+            break;
+        }
+
+        result += send_size;
+        if ((size_t)send_size < iov[index].iov_len)
+        {
+            break;
+        }
+    }
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_054: [ Otherwise on_transport_sendv shall return the number of bytes sent. ]
+    return result;
+}
+
+// the on_recvv callback of a socket created with async_socket_create_with_transport
+static ssize_t on_transport_recvv(void* context, ASYNC_SOCKET_HANDLE async_socket, const struct iovec* iov, int iovcnt)
+{
+    ssize_t result = 0;
+
+    (void)context;
+
+    for (int index = 0; index < iovcnt; index++)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_055: [ on_transport_recvv shall call on_recv for each iovec, for as long as on_recv fills the whole iovec. ]
+        int recv_size = async_socket->on_recv(async_socket->on_recv_context, async_socket, iov[index].iov_base, iov[index].iov_len);
+        if (recv_size <= 0)
+        {
+            if (result == 0)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_056: [ If on_recv fails or returns 0 before any byte was received, on_transport_recvv shall return the value returned by on_recv. ]
+                result = recv_size;
+            }
+            // otherwise the error or the end of the stream is reported by the next receive
+            break;
+        }
+
+        result += recv_size;
+        if ((size_t)recv_size < iov[index].iov_len)
+        {
+            break;
+        }
     }
 
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_057: [ Otherwise on_transport_recvv shall return the number of bytes received. ]
     return result;
 }
 
 #ifdef TEST_SUITE_NAME_FROM_CMAKE
 
-ON_ASYNC_SOCKET_SEND get_async_socket_send_callback(void)
+ON_ASYNC_SOCKET_SENDV get_async_socket_sendv_callback(void)
 {
-    return on_socket_send;
+    return on_socket_sendv;
 }
 
-ON_ASYNC_SOCKET_RECV get_async_socket_recv_callback(void)
+ON_ASYNC_SOCKET_RECVV get_async_socket_recvv_callback(void)
 {
-    return on_socket_recv;
+    return on_socket_recvv;
 }
 
 #endif
 
-static int send_data(ASYNC_SOCKET* async_socket, const ASYNC_SOCKET_BUFFER* buff_data, ssize_t* total_data_sent, int* error_no)
+static void io_queue_init(ASYNC_SOCKET_IO_QUEUE* io_queue, bool is_ready)
 {
-    int result;
+    io_queue->head = NULL;
+    io_queue->tail = NULL;
+    io_queue->is_ready = is_ready;
+    io_queue->is_completing = false;
+    io_queue->is_shut_down = false;
+}
+
+static void io_queue_push_back(ASYNC_SOCKET_IO_QUEUE* io_queue, ASYNC_SOCKET_IO_CONTEXT* io_context)
+{
+    io_context->next = NULL;
+    if (io_queue->tail == NULL)
+    {
+        io_queue->head = io_context;
+    }
+    else
+    {
+        io_queue->tail->next = io_context;
+    }
+    io_queue->tail = io_context;
+}
+
+// io_context is the first of a list of contexts linked by next, the list keeps its order at the head of the queue
+static void io_queue_push_front(ASYNC_SOCKET_IO_QUEUE* io_queue, ASYNC_SOCKET_IO_CONTEXT* io_context)
+{
+    ASYNC_SOCKET_IO_CONTEXT* last = io_context;
+    while (last->next != NULL)
+    {
+        last = last->next;
+    }
+
+    last->next = io_queue->head;
+    io_queue->head = io_context;
+    if (io_queue->tail == NULL)
+    {
+        io_queue->tail = last;
+    }
+}
+
+static ASYNC_SOCKET_IO_CONTEXT* io_queue_pop_front(ASYNC_SOCKET_IO_QUEUE* io_queue)
+{
+    ASYNC_SOCKET_IO_CONTEXT* result = io_queue->head;
+    if (result != NULL)
+    {
+        io_queue->head = result->next;
+        if (io_queue->head == NULL)
+        {
+            io_queue->tail = NULL;
+        }
+    }
+    return result;
+}
+
+static ASYNC_SOCKET_IO_CONTEXT* io_queue_pop_all(ASYNC_SOCKET_IO_QUEUE* io_queue)
+{
+    ASYNC_SOCKET_IO_CONTEXT* result = io_queue->head;
+    io_queue->head = NULL;
+    io_queue->tail = NULL;
+    return result;
+}
+
+static void io_queue_remove(ASYNC_SOCKET_IO_QUEUE* io_queue, ASYNC_SOCKET_IO_CONTEXT* io_context)
+{
+    ASYNC_SOCKET_IO_CONTEXT* previous = NULL;
+    ASYNC_SOCKET_IO_CONTEXT* current = io_queue->head;
+    while (current != io_context)
+    {
+        previous = current;
+        current = current->next;
+    }
+
+    if (previous == NULL)
+    {
+        io_queue->head = io_context->next;
+    }
+    else
+    {
+        previous->next = io_context->next;
+    }
+    if (io_queue->tail == io_context)
+    {
+        io_queue->tail = previous;
+    }
+}
+
+// moves the start of the message past bytes_sent, which must be less than the bytes in the message
+static void skip_sent_bytes(struct msghdr* message, uint32_t bytes_sent)
+{
+    while (bytes_sent >= message->msg_iov[0].iov_len)
+    {
+        bytes_sent -= (uint32_t)message->msg_iov[0].iov_len;
+        message->msg_iov++;
+        message->msg_iovlen--;
+    }
+    message->msg_iov[0].iov_base = (unsigned char*)message->msg_iov[0].iov_base + bytes_sent;
+    message->msg_iov[0].iov_len -= bytes_sent;
+}
+
+// on failure the message and bytes_left are left with the data that was not sent
+static int send_message(ASYNC_SOCKET* async_socket, struct msghdr* message, uint32_t* bytes_left, int* error_no)
+{
+    int result = 0;
 
-    ssize_t data_sent = 0;
     do
     {
-        // Codes_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_send callback to send the buffer. ]
-        ssize_t send_size = async_socket->on_send(async_socket->on_send_context, async_socket, buff_data->buffer+data_sent, buff_data->length-data_sent);
+        // Codes_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_sendv callback with an iovec for each of the buffers to send the whole payload with one call. ]
+        ssize_t send_size = async_socket->on_sendv(async_socket->on_sendv_context, async_socket, message->msg_iov, (int)message->msg_iovlen);
         if (send_size < 0)
         {
             *error_no = errno;
@@ -165,220 +456,1595 @@ static int send_data(ASYNC_SOCKET* async_socket, const ASYNC_SOCKET_BUFFER* buff
             result = MU_FAILURE;
             break;
         }
-        else
+
+        *bytes_left -= (uint32_t)send_size;
+        if (*bytes_left > 0)
         {
-            result = 0;
-            data_sent += send_size;
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_053: [ async_socket_send_async shall continue to send the data until the payload length has been sent. ]
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_101: [ If on_sendv returns a value > 0 but less than the amount to be sent, complete_queued_io shall skip the bytes that were sent, across as many buffers as needed, and call on_sendv again until the payload length has been sent. ]
+            skip_sent_bytes(message, (uint32_t)send_size);
         }
-        // Codes_SRS_ASYNC_SOCKET_LINUX_11_053: [ async_socket_send_async shall continue to send the data until the payload length has been sent. ]
-        // Codes_SRS_ASYNC_SOCKET_LINUX_11_101: [ If socket_transport_send returns a value > 0 but less than the amount to be sent, event_complete_callback shall continue to socket_transport_send the data until the payload length has been sent. ]
-    } while(data_sent < buff_data->length);
-    *total_data_sent = data_sent;
+    } while (*bytes_left > 0);
+
     return result;
 }
 
-static void event_complete_callback(void* context, COMPLETION_PORT_EPOLL_ACTION action)
+static ASYNC_SOCKET_POOLED_BUFFER* buffer_pool_get(ASYNC_SOCKET_BUFFER_POOL* buffer_pool)
 {
-    // Codes_SRS_ASYNC_SOCKET_LINUX_11_079: [ If context is NULL, event_complete_callback shall do nothing. ]
-    if (context == NULL)
+    ASYNC_SOCKET_POOLED_BUFFER* result;
+
+    srw_lock_ll_acquire_exclusive(&buffer_pool->lock);
+    result = buffer_pool->free_buffers;
+    if (result != NULL)
     {
-        LogCritical("Invalid arguement event_complete_callback void* context, COMPLETION_PORT_EPOLL_EPOLL_ACTION epoll_action, COMPLETION_PORT_EPOLL_EPOLL_RESULT result, int32_t amount_transfered");
+        buffer_pool->free_buffers = result->next;
+        buffer_pool->free_buffer_count--;
+    }
+    srw_lock_ll_release_exclusive(&buffer_pool->lock);
+
+    if (result == NULL)
+    {
+        result = malloc_flex(sizeof(ASYNC_SOCKET_POOLED_BUFFER), buffer_pool->buffer_size, sizeof(unsigned char));
+        if (result == NULL)
+        {
+            LogError("failure in malloc_flex(sizeof(ASYNC_SOCKET_POOLED_BUFFER)=%zu, buffer_size=%" PRIu32 ", sizeof(unsigned char)=%zu)",
+                sizeof(ASYNC_SOCKET_POOLED_BUFFER), buffer_pool->buffer_size, sizeof(unsigned char));
+        }
+    }
+
+    return result;
+}
+
+static void buffer_pool_put(ASYNC_SOCKET_BUFFER_POOL* buffer_pool, ASYNC_SOCKET_POOLED_BUFFER* pooled_buffer)
+{
+    srw_lock_ll_acquire_exclusive(&buffer_pool->lock);
+    if (buffer_pool->free_buffer_count < buffer_pool->max_free_buffer_count)
+    {
+        pooled_buffer->next = buffer_pool->free_buffers;
+        buffer_pool->free_buffers = pooled_buffer;
+        buffer_pool->free_buffer_count++;
+        pooled_buffer = NULL;
+    }
+    srw_lock_ll_release_exclusive(&buffer_pool->lock);
+
+    if (pooled_buffer != NULL)
+    {
+        free(pooled_buffer);
+    }
+}
+
+static void on_io_uring_ring_receive_complete(void* context, int32_t io_result);
+
+// must be called with the lock held, lends the buffer of buffer_id to the kernel
+static void add_ring_buffer(ASYNC_SOCKET* async_socket, uint16_t buffer_id)
+{
+    ASYNC_SOCKET_POOLED_BUFFER* ring_buffer = async_socket->ring_buffers[buffer_id];
+
+    if (completion_port_buffer_ring_add(async_socket->receive_buffer_ring, ring_buffer->data, async_socket->receive_buffer_pool->buffer_size, buffer_id) != 0)
+    {
+        LogError("failure in completion_port_buffer_ring_add(buffer_ring=%p, buffer_id=%" PRIu16 ")", async_socket->receive_buffer_ring, buffer_id);
     }
     else
     {
-        ASYNC_SOCKET_IO_CONTEXT* io_context = (ASYNC_SOCKET_IO_CONTEXT*)context;
-        switch (action)
+        async_socket->ring_buffer_count++;
+    }
+}
+
+// must be called with the lock held, lends a new pool buffer to the kernel under buffer_id, the slot stays empty if the pool has no buffer
+static void replace_ring_buffer(ASYNC_SOCKET* async_socket, uint16_t buffer_id)
+{
+    ASYNC_SOCKET_POOLED_BUFFER* ring_buffer = buffer_pool_get(async_socket->receive_buffer_pool);
+
+    async_socket->ring_buffers[buffer_id] = ring_buffer;
+    if (ring_buffer != NULL)
+    {
+        ring_buffer->buffer_id = buffer_id;
+        add_ring_buffer(async_socket, buffer_id);
+    }
+}
+
+// must be called with the lock held, submits the receive of the buffer ring unless it is submitted, the stream ended or the kernel has no buffer to receive in
+static void submit_ring_receive(ASYNC_SOCKET* async_socket)
+{
+    if (
+        !async_socket->is_ring_receive_submitted &&
+        !async_socket->is_ring_receive_ended &&
+        interlocked_add(&async_socket->state, 0) == ASYNC_SOCKET_LINUX_STATE_OPEN
+        )
+    {
+        if (async_socket->ring_buffer_count == 0)
         {
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_080: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLRDHUP or COMPLETION_PORT_EPOLL_ABANDONED, event_complete_callback shall do the following: ]
-            case COMPLETION_PORT_EPOLL_ABANDONED:
-            case COMPLETION_PORT_EPOLL_EPOLLRDHUP:
+            // the buffers taken by pooled receives could not all be replaced, try again
+            for (uint16_t buffer_id = 0; buffer_id < ASYNC_SOCKET_RING_BUFFER_COUNT; buffer_id++)
             {
-                // Codes_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
-                if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_RECEIVE)
-                {
-                    LogError("Receive socket has encountered %" PRI_MU_ENUM "", MU_ENUM_VALUE(COMPLETION_PORT_EPOLL_ACTION, action));
-                    io_context->on_receive_complete(io_context->callback_context, ASYNC_SOCKET_RECEIVE_ABANDONED, 0);
-                }
-                else if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_SEND)
+                if (async_socket->ring_buffers[buffer_id] == NULL)
                 {
-                    LogError("Send socket has encountered %" PRI_MU_ENUM "", MU_ENUM_VALUE(COMPLETION_PORT_EPOLL_ACTION, action));
-                    io_context->on_send_complete(io_context->callback_context, ASYNC_SOCKET_SEND_ABANDONED);
-                }
-                else
-                {
-                    LogError("Notify socket has encountered %" PRI_MU_ENUM "", MU_ENUM_VALUE(COMPLETION_PORT_EPOLL_ACTION, action));
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_04_008: [ event_complete_callback shall call the notify complete callback with an ABANDONED flag when the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY. ]
-                    io_context->on_notify_io_complete(io_context->callback_context, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED);
+                    replace_ring_buffer(async_socket, buffer_id);
                 }
+            }
+        }
 
-                // Codes_SRS_ASYNC_SOCKET_LINUX_11_084: [ Then event_complete_callback shall free the context memory. ]
-                free(io_context);
-                break;
+        // with few buffers in the ring the receive would soon end with ENOBUFS again, so while the receives have data to take
+        // it waits for them to lend back half the buffers of the ring
+        if (
+            (async_socket->ring_buffer_count >= ASYNC_SOCKET_RING_BUFFER_COUNT / 2) ||
+            (async_socket->ring_buffer_count > 0 && async_socket->received_buffers_head == NULL)
+            )
+        {
+            async_socket->ring_receive_io.is_multishot = async_socket->is_ring_receive_multishot;
+
+            (void)interlocked_increment(&async_socket->pending_io_count);
+            if (completion_port_submit_io(async_socket->completion_port, async_socket->socket_handle, &async_socket->ring_receive_io) != 0)
+            {
+                LogError("failure in completion_port_submit_io(completion_port=%p, socket_handle=%" PRI_SOCKET ") for the receive of the buffer ring",
+                    async_socket->completion_port, async_socket->socket_handle);
+                (void)interlocked_decrement(&async_socket->pending_io_count);
+
+                // the receives that wait for data complete with an error
+                async_socket->is_ring_receive_ended = true;
+                async_socket->ring_receive_result = -EIO;
+                async_socket->receive_queue.is_shut_down = true;
+                async_socket->receive_queue.is_ready = true;
             }
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_082: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLIN, event_complete_callback shall do the following: ]
-            case COMPLETION_PORT_EPOLL_EPOLLIN:
+            else
             {
-                if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_NOTIFY)
-                {
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_04_009: [ If the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY then event_complete_callback shall call the notify complete callback with an IN flag. ]
-                    io_context->on_notify_io_complete(io_context->callback_context, ASYNC_SOCKET_NOTIFY_IO_RESULT_IN);
-                }
-                else
-                {
-                    ASYNC_SOCKET_RECEIVE_RESULT receive_result;
-                    uint32_t index = 0;
-                    uint32_t total_recv_size = 0;
+                async_socket->is_ring_receive_submitted = true;
+            }
+        }
+    }
+}
 
-                    do
-                    {
-                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_083: [ Otherwise event_complete_callback shall call the on_recv callback with the recv_buffer buffer and length and do the following: ]
-                        ssize_t recv_size = io_context->async_socket->on_recv(io_context->async_socket->on_recv_context, io_context->async_socket, io_context->data.recv_ctx.recv_buffers[index].buffer, io_context->data.recv_ctx.recv_buffers[index].length);
-                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_088: [ If the socket_transport_receive size < 0, then: ]
-                        if (recv_size < 0)
-                        {
-                            if (errno == EAGAIN || errno == EWOULDBLOCK)
-                            {
-                                // Codes_SRS_ASYNC_SOCKET_LINUX_11_089: [ If errno is EAGAIN or EWOULDBLOCK, then no data is available and event_complete_callback will break out of the function. ]
-                                receive_result = ASYNC_SOCKET_RECEIVE_OK;
-                                break;
-                            }
-                            else
-                            {
-                                total_recv_size = 0;
-                                recv_size = 0;
-                                if (errno == ECONNRESET)
-                                {
-                                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_090: [ If errno is ECONNRESET, then event_complete_callback shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
-                                    receive_result = ASYNC_SOCKET_RECEIVE_ABANDONED;
-                                    LogError("A reset on the recv socket has been encountered");
-                                }
-                                else
-                                {
-                                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_095: [ If errno is any other error, then event_complete_callback shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ERROR. ]
-                                    receive_result = ASYNC_SOCKET_RECEIVE_ERROR;
-                                    LogErrorNo("failure recv data");
-                                }
-                                break;
-                            }
-                        }
-                        else if (recv_size == 0)
-                        {
-                            // Codes_SRS_ASYNC_SOCKET_LINUX_11_091: [ If the socket_transport_receive size equals 0, then event_complete_callback shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
-                            LogError("Socket received 0 bytes, assuming socket is closed");
-                            receive_result = ASYNC_SOCKET_RECEIVE_ABANDONED;
-                            break;
-                        }
-                        else
-                        {
-                            if (recv_size > UINT32_MAX ||
-                                UINT32_MAX - total_recv_size < recv_size)
-                            {
-                                // Handle unlikely overflow
-                                LogError("Overflow in computing receive size (total_recv_size=%" PRIu32 " + recv_size=%zi > UINT32_MAX=%" PRIu32 ")",
-                                    total_recv_size, recv_size, UINT32_MAX);
-                                receive_result = ASYNC_SOCKET_RECEIVE_ERROR;
-                            }
-                            else
-                            {
-                                // Codes_SRS_ASYNC_SOCKET_LINUX_11_092: [ If the socket_transport_receive size > 0, if we have another buffer to fill then we will attempt another read, otherwise we shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_OK. ]
-                                total_recv_size += recv_size;
-                                if (index + 1 >= io_context->data.recv_ctx.total_buffer_count || recv_size <= io_context->data.recv_ctx.recv_buffers[index].length)
-                                {
-#ifdef ENABLE_SOCKET_LOGGING
-                                    LogVerbose("Asynchronous receive of %" PRIu32 " bytes completed at %lf", bytes_received, timer_global_get_elapsed_us());
-#endif
-                                    receive_result = ASYNC_SOCKET_RECEIVE_OK;
-                                    break;
-                                }
-                                else
-                                {
-                                    index++;
-                                }
-                            }
-                        }
-                    } while (true);
+// must be called with the lock held, returns what a receive gets when no received buffer is left: the end of the stream, an error or EAGAIN
+static ssize_t get_ring_receive_end_result(ASYNC_SOCKET* async_socket, int* error_no)
+{
+    ssize_t result;
 
-                    // Call the callback
-                    io_context->on_receive_complete(io_context->callback_context, receive_result, total_recv_size);
-                }
+    // the receive might not be submitted because no pool buffer could be allocated for the kernel, try again
+    submit_ring_receive(async_socket);
 
-                // Codes_SRS_ASYNC_SOCKET_LINUX_11_093: [ event_complete_callback shall then free the io_context memory. ]
-                free(io_context);
-                break;
+    if (async_socket->is_ring_receive_ended)
+    {
+        *error_no = -async_socket->ring_receive_result;
+        result = (async_socket->ring_receive_result == 0) ? 0 : -1;
+    }
+    else if (
+        !async_socket->is_ring_receive_submitted &&
+        async_socket->ring_buffer_count == 0 &&
+        interlocked_add(&async_socket->state, 0) == ASYNC_SOCKET_LINUX_STATE_OPEN
+        )
+    {
+        // no pool buffer could be allocated for the kernel to receive in
+        *error_no = ENOMEM;
+        result = -1;
+    }
+    else
+    {
+        *error_no = EAGAIN;
+        result = -1;
+    }
+
+    return result;
+}
+
+// receives from the buffers the kernel received in the same way recvmsg receives from the socket, copying as much data as fits in the iovecs
+static ssize_t receive_from_buffer_ring(ASYNC_SOCKET* async_socket, const struct iovec* iov, int iovcnt)
+{
+    ssize_t result;
+    int error_no = 0;
+    ASYNC_SOCKET_POOLED_BUFFER* received_buffers;
+
+    // only the thread completing the receive queue takes data while the epoll thread appends the buffers it receives in,
+    // so the data is copied without holding the lock once the buffers are taken from the socket
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    received_buffers = async_socket->received_buffers_head;
+    async_socket->received_buffers_head = NULL;
+    async_socket->received_buffers_tail = NULL;
+    if (received_buffers == NULL)
+    {
+        result = get_ring_receive_end_result(async_socket, &error_no);
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    if (received_buffers != NULL)
+    {
+        ASYNC_SOCKET_POOLED_BUFFER* received_buffer = received_buffers;
+        size_t bytes_copied = 0;
+        int iov_index = 0;
+        size_t iov_offset = 0;
+
+        while (received_buffer != NULL && iov_index < iovcnt)
+        {
+            size_t copy_size = iov[iov_index].iov_len - iov_offset;
+            if (copy_size > received_buffer->received_size - received_buffer->received_offset)
+            {
+                copy_size = received_buffer->received_size - received_buffer->received_offset;
             }
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_094: [ If the events value contains COMPLETION_PORT_EPOLL_EPOLLOUT, event_complete_callback shall the following: ]
-            case COMPLETION_PORT_EPOLL_EPOLLOUT:
+
+            (void)memcpy((unsigned char*)iov[iov_index].iov_base + iov_offset, received_buffer->data + received_buffer->received_offset, copy_size);
+            bytes_copied += copy_size;
+            iov_offset += copy_size;
+            received_buffer->received_offset += (uint32_t)copy_size;
+
+            if (iov_offset == iov[iov_index].iov_len)
             {
-                if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_NOTIFY)
+                iov_index++;
+                iov_offset = 0;
+            }
+            if (received_buffer->received_offset == received_buffer->received_size)
+            {
+                received_buffer = received_buffer->next;
+            }
+        }
+
+        srw_lock_ll_acquire_exclusive(&async_socket->lock);
+        {
+            // the buffers whose data was taken go back to the kernel
+            while (received_buffers != received_buffer)
+            {
+                ASYNC_SOCKET_POOLED_BUFFER* next_received_buffer = received_buffers->next;
+                add_ring_buffer(async_socket, received_buffers->buffer_id);
+                received_buffers = next_received_buffer;
+            }
+
+            // the others go back in front of the buffers received meanwhile
+            if (received_buffers != NULL)
+            {
+                ASYNC_SOCKET_POOLED_BUFFER* last_received_buffer = received_buffers;
+                while (last_received_buffer->next != NULL)
                 {
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_04_010: [ If the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY then event_complete_callback shall call the notify complete callback with an OUT flag. ]
-                    io_context->on_notify_io_complete(io_context->callback_context, ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT);
+                    last_received_buffer = last_received_buffer->next;
                 }
-                else
+
+                last_received_buffer->next = async_socket->received_buffers_head;
+                if (async_socket->received_buffers_head == NULL)
                 {
-                    ASYNC_SOCKET_SEND_RESULT send_result;
+                    async_socket->received_buffers_tail = last_received_buffer;
+                }
+                async_socket->received_buffers_head = received_buffers;
+            }
 
-                    int error_no;
-                    ssize_t total_data_sent;
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_096: [ event_complete_callback shall call socket_transport_send on the data in the ASYNC_SOCKET_SEND_CONTEXT buffer. ]
-                    if (send_data(io_context->async_socket, &io_context->data.send_ctx.socket_buffer, &total_data_sent, &error_no) != 0)
-                    {
-                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_097: [ If socket_transport_send returns value is < 0 event_complete_callback shall do the following: ]
-                        if (error_no == ECONNRESET)
-                        {
-                            // Codes_SRS_ASYNC_SOCKET_LINUX_11_098: [ if errno is ECONNRESET, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ABANDONED. ]
-                            send_result = ASYNC_SOCKET_SEND_ABANDONED;
-                            LogError("A reset on the send socket has been encountered");
-                        }
-                        else
+            submit_ring_receive(async_socket);
+        }
+        srw_lock_ll_release_exclusive(&async_socket->lock);
+
+        result = (ssize_t)bytes_copied;
+    }
+    else
+    {
+        errno = error_no;
+    }
+
+    return result;
+}
+
+// hands the first buffer the kernel received in to a pooled receive and lends a new pool buffer to the kernel in its place,
+// has_received_data tells whether a receive that follows gets data or the end of the stream right away
+static ssize_t receive_pooled_from_buffer_ring(ASYNC_SOCKET* async_socket, ASYNC_SOCKET_POOLED_BUFFER** pooled_buffer, bool* has_received_data)
+{
+    ssize_t result;
+    int error_no = 0;
+
+    *pooled_buffer = NULL;
+
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        ASYNC_SOCKET_POOLED_BUFFER* received_buffer = async_socket->received_buffers_head;
+        if (received_buffer == NULL)
+        {
+            result = get_ring_receive_end_result(async_socket, &error_no);
+        }
+        else if (received_buffer->received_offset == 0)
+        {
+            async_socket->received_buffers_head = received_buffer->next;
+            if (async_socket->received_buffers_head == NULL)
+            {
+                async_socket->received_buffers_tail = NULL;
+            }
+
+            replace_ring_buffer(async_socket, received_buffer->buffer_id);
+            submit_ring_receive(async_socket);
+
+            *pooled_buffer = received_buffer;
+            result = (ssize_t)received_buffer->received_size;
+        }
+        else
+        {
+            // a receive with its own buffers took the start of the data, the rest is copied so that the buffer goes back to the kernel
+            ASYNC_SOCKET_POOLED_BUFFER* copied_buffer = buffer_pool_get(async_socket->receive_buffer_pool);
+            if (copied_buffer == NULL)
+            {
+                error_no = ENOMEM;
+                result = -1;
+            }
+            else
+            {
+                result = (ssize_t)(received_buffer->received_size - received_buffer->received_offset);
+                (void)memcpy(copied_buffer->data, received_buffer->data + received_buffer->received_offset, (size_t)result);
+
+                async_socket->received_buffers_head = received_buffer->next;
+                if (async_socket->received_buffers_head == NULL)
+                {
+                    async_socket->received_buffers_tail = NULL;
+                }
+
+                add_ring_buffer(async_socket, received_buffer->buffer_id);
+                submit_ring_receive(async_socket);
+
+                *pooled_buffer = copied_buffer;
+            }
+        }
+
+        *has_received_data = (async_socket->received_buffers_head != NULL) || async_socket->is_ring_receive_ended;
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    if (result < 0)
+    {
+        errno = error_no;
+    }
+
+    return result;
+}
+
+// Returns false if the socket has no data yet, in which case the receive stays queued, is_received tells whether the receive completed with data
+static bool receive_io_context(ASYNC_SOCKET_IO_CONTEXT* io_context, bool* is_readable, bool* is_received)
+{
+    bool result = true;
+    ASYNC_SOCKET_RECEIVE_RESULT receive_result = ASYNC_SOCKET_RECEIVE_OK;
+    uint32_t bytes_received = 0;
+    ASYNC_SOCKET* async_socket = io_context->async_socket;
+    ASYNC_SOCKET_MESSAGE_CONTEXT* message_ctx = &io_context->message_ctx;
+    uint32_t total_buffer_bytes = message_ctx->total_buffer_bytes;
+    ASYNC_SOCKET_POOLED_BUFFER* pooled_buffer = NULL;
+    bool has_received_data = false;
+    ssize_t recv_size;
+
+    *is_readable = false;
+    *is_received = false;
+
+    if (io_context->is_pooled && async_socket->receive_buffer_ring != NULL)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_160: [ For a pooled receive of a socket that receives with a buffer ring, complete_queued_io shall take the first buffer the kernel received in, without copying its data, and lend a buffer taken from the receive buffer pool to the kernel in its place. ]
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_161: [ If a receive with buffers already took the start of the data of that buffer, complete_queued_io shall instead copy the rest of the data in a buffer taken from the receive buffer pool and lend the received buffer back to the kernel. ]
+        recv_size = receive_pooled_from_buffer_ring(async_socket, &pooled_buffer, &has_received_data);
+    }
+    else if (io_context->is_pooled)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_116: [ For a pooled receive, complete_queued_io shall take a buffer from the receive buffer pool of the socket, allocating a new one if the pool has no free buffer, and call the on_recvv callback with an iovec for the buffer. ]
+        pooled_buffer = buffer_pool_get(async_socket->receive_buffer_pool);
+        if (pooled_buffer == NULL)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_117: [ If no buffer can be allocated, complete_queued_io shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ERROR. ]
+            errno = ENOMEM;
+            recv_size = -1;
+        }
+        else
+        {
+            struct iovec pooled_iovec = { .iov_base = pooled_buffer->data, .iov_len = async_socket->receive_buffer_pool->buffer_size };
+
+            total_buffer_bytes = async_socket->receive_buffer_pool->buffer_size;
+            recv_size = async_socket->on_recvv(async_socket->on_recvv_context, async_socket, &pooled_iovec, 1);
+            if (recv_size <= 0)
+            {
+                int recv_errno = errno;
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_118: [ If the on_recvv size is not > 0, complete_queued_io shall give the buffer back to the pool. ]
+                buffer_pool_put(async_socket->receive_buffer_pool, pooled_buffer);
+                pooled_buffer = NULL;
+                errno = recv_errno;
+            }
+        }
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_11_083: [ For ASYNC_SOCKET_IO_TYPE_RECEIVE, complete_queued_io shall call the on_recvv callback with an iovec for each of the buffers to receive in all of them with one call and do the following: ]
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_162: [ If the socket receives with a buffer ring, complete_queued_io shall instead copy the data of the buffers the kernel received in, in the order of the stream, in the buffers of the receive and lend each buffer whose data was all taken back to the kernel. ]
+        recv_size = (async_socket->receive_buffer_ring != NULL) ?
+            receive_from_buffer_ring(async_socket, message_ctx->message.msg_iov, (int)message_ctx->message.msg_iovlen) :
+            async_socket->on_recvv(async_socket->on_recvv_context, async_socket, message_ctx->message.msg_iov, (int)message_ctx->message.msg_iovlen);
+    }
+    // Codes_SRS_ASYNC_SOCKET_LINUX_11_088: [ If the on_recvv size < 0, then: ]
+    if (recv_size < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_089: [ If errno is EAGAIN or EWOULDBLOCK, then complete_queued_io shall put the context back at the head of the receive queue. ]
+            result = false;
+        }
+        else
+        {
+            if (errno == ECONNRESET)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_090: [ If errno is ECONNRESET, then complete_queued_io shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+                receive_result = ASYNC_SOCKET_RECEIVE_ABANDONED;
+                LogError("A reset on the recv socket has been encountered");
+            }
+            else
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_095: [ If errno is any other error, then complete_queued_io shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ERROR. ]
+                receive_result = ASYNC_SOCKET_RECEIVE_ERROR;
+                LogErrorNo("failure recv data");
+            }
+            // the error is reported again by the next recv
+            *is_readable = true;
+        }
+    }
+    else if (recv_size == 0)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_11_091: [ If the on_recvv size equals 0, then complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+        LogError("Socket received 0 bytes, assuming socket is closed");
+        receive_result = ASYNC_SOCKET_RECEIVE_ABANDONED;
+        // the end of the stream is reported again by the next recv
+        *is_readable = true;
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_11_092: [ If the on_recvv size > 0, complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context, ASYNC_SOCKET_RECEIVE_OK and the on_recvv size. ]
+        bytes_received = (uint32_t)recv_size;
+        *is_received = true;
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_016: [ If the on_recvv filled all the buffers, complete_queued_io shall keep the socket marked as readable, since more data may be available. ]
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_163: [ After a pooled receive of a socket that receives with a buffer ring, complete_queued_io shall keep the socket marked as readable if the kernel received in more buffers or the stream ended. ]
+        *is_readable = (io_context->is_pooled && async_socket->receive_buffer_ring != NULL) ? has_received_data : (bytes_received == total_buffer_bytes);
+#ifdef ENABLE_SOCKET_LOGGING
+        LogVerbose("Asynchronous receive of %" PRIu32 " bytes completed at %lf", bytes_received, timer_global_get_elapsed_us());
+#endif
+    }
+
+    if (result)
+    {
+        if (io_context->is_continuous && !*is_received)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_135: [ When the continuous receive of the socket completes with any other result, complete_queued_io shall remove it from the socket before calling on_receive_complete, so that a new continuous receive can be started from the callback, and then free the context. ]
+            srw_lock_ll_acquire_exclusive(&async_socket->lock);
+            if (async_socket->continuous_receive_io_context == io_context)
+            {
+                async_socket->continuous_receive_io_context = NULL;
+            }
+            srw_lock_ll_release_exclusive(&async_socket->lock);
+        }
+
+        // Call the callback
+        if (io_context->is_pooled)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_119: [ complete_queued_io shall call the on_receive_complete callback of a pooled receive with the buffer taken from the pool when the on_recvv size > 0, the caller then owning the buffer, and with NULL otherwise. ]
+            io_context->on_receive_pooled_complete(io_context->callback_context, receive_result, (pooled_buffer == NULL) ? NULL : pooled_buffer->data, bytes_received);
+        }
+        else
+        {
+            io_context->on_receive_complete(io_context->callback_context, receive_result, bytes_received);
+        }
+    }
+
+    return result;
+}
+
+// sends the message of a zero copy send and records the sequence number the kernel gives to the sendmsg call
+static ssize_t send_zero_copy(ASYNC_SOCKET_IO_CONTEXT* io_context, struct msghdr* message)
+{
+    ssize_t result;
+    ASYNC_SOCKET* async_socket = io_context->async_socket;
+
+    // the lock is held so that the notification of this sendmsg cannot be handled before its sequence number is recorded
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_078: [ For a zero copy send, complete_queued_io shall call sendmsg with MSG_NOSIGNAL and MSG_ZEROCOPY instead of on_sendv, while holding the lock. ]
+        result = sendmsg(async_socket->socket_handle, message, MSG_NOSIGNAL | MSG_ZEROCOPY);
+        if (result < 0)
+        {
+            if (errno == ENOBUFS)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_079: [ If sendmsg fails with ENOBUFS, complete_queued_io shall call sendmsg again with MSG_NOSIGNAL only, so that the data is copied. ]
+                // the memory the socket can pin is exhausted
+                result = sendmsg(async_socket->socket_handle, message, MSG_NOSIGNAL);
+            }
+        }
+        else
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_080: [ If sendmsg with MSG_ZEROCOPY succeeds, complete_queued_io shall record that the send waits for one more zero copy notification, with the next sequence number of the socket. ]
+            if (io_context->zero_copy_sequence_count == 0)
+            {
+                io_context->zero_copy_first_sequence = async_socket->zero_copy_next_sequence;
+            }
+            io_context->zero_copy_sequence_count++;
+            async_socket->zero_copy_next_sequence++;
+            async_socket->zero_copy_sending_io_context = io_context;
+        }
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    return result;
+}
+
+static void complete_zero_copy_sends(ASYNC_SOCKET* async_socket)
+{
+    ASYNC_SOCKET_IO_QUEUE* io_queue = &async_socket->zero_copy_queue;
+
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_082: [ If another thread is completing the sends of the zero copy queue, complete_zero_copy_sends shall return. ]
+        if (!io_queue->is_completing)
+        {
+            io_queue->is_completing = true;
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_083: [ While the kernel released all the pages of the send at the head of the zero copy queue, complete_zero_copy_sends shall remove it from the queue, call its on_send_complete without holding the lock with the result the send completed with and free it. ]
+            while (io_queue->head != NULL && io_queue->head->zero_copy_released_count == io_queue->head->zero_copy_sequence_count)
+            {
+                ASYNC_SOCKET_IO_CONTEXT* io_context = io_queue_pop_front(io_queue);
+                srw_lock_ll_release_exclusive(&async_socket->lock);
+
+#ifdef ENABLE_SOCKET_LOGGING
+                LogVerbose("Zero copy send completed at %lf", timer_global_get_elapsed_us());
+#endif
+                io_context->on_send_complete(io_context->callback_context, io_context->send_result);
+                free(io_context);
+
+                srw_lock_ll_acquire_exclusive(&async_socket->lock);
+            }
+
+            io_queue->is_completing = false;
+        }
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+}
+
+// completes a send that was sent or that failed
+static void complete_send(ASYNC_SOCKET_IO_CONTEXT* io_context, ASYNC_SOCKET_SEND_RESULT send_result)
+{
+    ASYNC_SOCKET* async_socket = io_context->async_socket;
+
+    if (async_socket->zero_copy_send_threshold == 0)
+    {
+        io_context->on_send_complete(io_context->callback_context, send_result);
+        // Codes_SRS_ASYNC_SOCKET_LINUX_11_093: [ complete_queued_io shall then free the io_context memory. ]
+        free(io_context);
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_081: [ If zero copy is on, complete_queued_io shall add the send with its result at the tail of the zero copy queue instead of completing it, so that the sends complete in order once the kernel released the pages of the zero copy sends, and then call complete_zero_copy_sends. ]
+        io_context->send_result = send_result;
+
+        srw_lock_ll_acquire_exclusive(&async_socket->lock);
+        {
+            if (async_socket->zero_copy_sending_io_context == io_context)
+            {
+                async_socket->zero_copy_sending_io_context = NULL;
+            }
+            io_queue_push_back(&async_socket->zero_copy_queue, io_context);
+        }
+        srw_lock_ll_release_exclusive(&async_socket->lock);
+
+        complete_zero_copy_sends(async_socket);
+    }
+}
+
+// adds the sequence numbers from first_released to last_released that belong to the send to its released count
+static void release_zero_copy_sequences(ASYNC_SOCKET_IO_CONTEXT* io_context, uint32_t first_released, uint32_t last_released)
+{
+    // relative to first_released, so that the sequence numbers can wrap around
+    int64_t first = (int32_t)(io_context->zero_copy_first_sequence - first_released);
+    int64_t last = first + (int64_t)io_context->zero_copy_sequence_count - 1;
+    int64_t released_last = (uint32_t)(last_released - first_released);
+
+    if (first < 0)
+    {
+        first = 0;
+    }
+    if (last > released_last)
+    {
+        last = released_last;
+    }
+    if (last >= first)
+    {
+        io_context->zero_copy_released_count += (uint32_t)(last - first + 1);
+    }
+}
+
+static void receive_zero_copy_notifications(ASYNC_SOCKET* async_socket)
+{
+    do
+    {
+        uint8_t control[ASYNC_SOCKET_ERROR_QUEUE_CONTROL_SIZE];
+        struct msghdr message;
+        (void)memset(&message, 0, sizeof(message));
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_085: [ event_complete_callback shall receive the messages of the error queue of the socket by calling recvmsg with MSG_ERRQUEUE until it fails. ]
+        if (recvmsg(async_socket->socket_handle, &message, MSG_ERRQUEUE) < 0)
+        {
+            // EAGAIN once the error queue is empty
+            break;
+        }
+
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != NULL; cmsg = CMSG_NXTHDR(&message, cmsg))
+        {
+            if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+            {
+                struct sock_extended_err extended_error;
+                (void)memcpy(&extended_error, CMSG_DATA(cmsg), sizeof(extended_error));
+                if (extended_error.ee_errno == 0 && extended_error.ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_086: [ For each zero copy notification, event_complete_callback shall add the released sequence numbers, from ee_info to ee_data, to the send that is partially sent and to the sends in the zero copy queue they belong to. ]
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                    {
+                        if (async_socket->zero_copy_sending_io_context != NULL)
                         {
-                            // Codes_SRS_ASYNC_SOCKET_LINUX_11_099: [ if errno is anything else, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ERROR. ]
-                            send_result = ASYNC_SOCKET_SEND_ERROR;
-                            LogErrorNo("failure sending data length: %" PRIu32 "", io_context->data.send_ctx.socket_buffer.length);
+                            release_zero_copy_sequences(async_socket->zero_copy_sending_io_context, extended_error.ee_info, extended_error.ee_data);
+                        }
+                        for (ASYNC_SOCKET_IO_CONTEXT* io_context = async_socket->zero_copy_queue.head; io_context != NULL; io_context = io_context->next)
+                        {
+                            release_zero_copy_sequences(io_context, extended_error.ee_info, extended_error.ee_data);
                         }
                     }
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
+                }
+            }
+        }
+    } while (1);
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_087: [ event_complete_callback shall then call complete_zero_copy_sends. ]
+    complete_zero_copy_sends(async_socket);
+}
+
+static bool is_waiting_for_zero_copy_release(ASYNC_SOCKET* async_socket)
+{
+    bool result;
+
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        ASYNC_SOCKET_IO_CONTEXT* sending_io_context = async_socket->zero_copy_sending_io_context;
+        result =
+            (async_socket->zero_copy_queue.head != NULL) ||
+            ((sending_io_context != NULL) && (sending_io_context->zero_copy_released_count != sending_io_context->zero_copy_sequence_count));
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    return result;
+}
+
+// the kernel keeps the pages of the zero copy sends pinned until the data is acknowledged or dropped, so the sends are only abandoned once it released them or the wait times out
+// called by async_socket_close before removing the socket from the completion port, never from event_complete_callback which would block the epoll thread of the socket
+static void wait_for_zero_copy_release(ASYNC_SOCKET* async_socket)
+{
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_148: [ async_socket_close shall receive the zero copy notifications of the socket, which completes the sends whose pages the kernel released. ]
+    receive_zero_copy_notifications(async_socket);
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_149: [ While the zero copy queue is not empty or the send that is partially sent waits for zero copy notifications, async_socket_close shall call poll for the socket with a timeout of 100 ms and receive the zero copy notifications again, at most 10 times. ]
+    for (uint32_t poll_count = 0; (poll_count < ASYNC_SOCKET_ZERO_COPY_RELEASE_POLL_COUNT) && is_waiting_for_zero_copy_release(async_socket); poll_count++)
+    {
+        // no events are requested, poll returns when the error queue gets a notification (POLLERR) or the connection is gone
+        struct pollfd poll_fd = { .fd = async_socket->socket_handle, .events = 0, .revents = 0 };
+        if (poll(&poll_fd, 1, ASYNC_SOCKET_ZERO_COPY_RELEASE_POLL_TIMEOUT_MS) < 0)
+        {
+            LogErrorNo("failure in poll(socket_handle=%" PRI_SOCKET ")", async_socket->socket_handle);
+        }
+
+        receive_zero_copy_notifications(async_socket);
+    }
+}
+
+// io_contexts is a list of sends, which are sent with one on_sendv call and completed in the order they were queued
+// Returns the sends that are left to send, the first one without the bytes that were sent
+static ASYNC_SOCKET_IO_CONTEXT* send_io_contexts(ASYNC_SOCKET_IO_CONTEXT* io_contexts, bool* is_writable)
+{
+    ASYNC_SOCKET_IO_CONTEXT* result = io_contexts;
+    ASYNC_SOCKET* async_socket = io_contexts->async_socket;
+    struct iovec iovecs[ASYNC_SOCKET_COALESCED_SEND_IOVEC_COUNT];
+    struct msghdr coalesced_message;
+    struct msghdr* message;
+    uint32_t bytes_left;
+    int error_no = 0;
+    bool is_failed = false;
+    // a zero copy send is never coalesced, so it is alone in the list
+    bool is_zero_copy = io_contexts->is_zero_copy;
+
+    *is_writable = true;
+
+    if (io_contexts->next == NULL)
+    {
+        // a single send is sent from its own iovecs, which can be more than fit on the stack
+        message = &io_contexts->message_ctx.message;
+        bytes_left = io_contexts->message_ctx.total_buffer_bytes;
+    }
+    else
+    {
+        size_t iovec_count = 0;
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_062: [ complete_queued_io shall call on_sendv once with the iovecs of the data that is left to send of all the sends taken from the queue. ]
+        bytes_left = 0;
+        for (ASYNC_SOCKET_IO_CONTEXT* io_context = io_contexts; io_context != NULL; io_context = io_context->next)
+        {
+            (void)memcpy(&iovecs[iovec_count], io_context->message_ctx.message.msg_iov, io_context->message_ctx.message.msg_iovlen * sizeof(struct iovec));
+            iovec_count += io_context->message_ctx.message.msg_iovlen;
+            bytes_left += io_context->message_ctx.total_buffer_bytes;
+        }
+
+        (void)memset(&coalesced_message, 0, sizeof(coalesced_message));
+        coalesced_message.msg_iov = iovecs;
+        coalesced_message.msg_iovlen = iovec_count;
+        message = &coalesced_message;
+    }
+
+    do
+    {
+        ssize_t send_size;
+        if (is_zero_copy)
+        {
+            send_size = send_zero_copy(result, message);
+        }
+        else
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_096: [ For ASYNC_SOCKET_IO_TYPE_SEND, complete_queued_io shall call on_sendv with the iovecs of the data that is left to send. ]
+            send_size = async_socket->on_sendv(async_socket->on_sendv_context, async_socket, message->msg_iov, (int)message->msg_iovlen);
+        }
+        if (send_size < 0)
+        {
+            error_no = errno;
+            is_failed = true;
+            break;
+        }
+
+        uint32_t bytes_sent = (uint32_t)send_size;
+        bytes_left -= bytes_sent;
+        if (bytes_left > 0)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_101: [ If on_sendv returns a value > 0 but less than the amount to be sent, complete_queued_io shall skip the bytes that were sent, across as many buffers as needed, and call on_sendv again until the payload length has been sent. ]
+            skip_sent_bytes(message, bytes_sent);
+        }
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_063: [ complete_queued_io shall call on_send_complete with ASYNC_SOCKET_SEND_OK for each send that was sent entirely, in the order the sends were queued. ]
+        while (result != NULL && bytes_sent >= result->message_ctx.total_buffer_bytes)
+        {
+            ASYNC_SOCKET_IO_CONTEXT* next_io_context = result->next;
+            bytes_sent -= result->message_ctx.total_buffer_bytes;
+#ifdef ENABLE_SOCKET_LOGGING
+            LogVerbose("Asynchronous send completed at %lf", timer_global_get_elapsed_us());
+#endif
+            complete_send(result, ASYNC_SOCKET_SEND_OK);
+            result = next_io_context;
+        }
+
+        if (bytes_sent > 0)
+        {
+            result->message_ctx.total_buffer_bytes -= bytes_sent;
+            if (message != &result->message_ctx.message)
+            {
+                skip_sent_bytes(&result->message_ctx.message, bytes_sent);
+            }
+        }
+    } while (bytes_left > 0);
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_11_097: [ If on_sendv returns value is < 0 complete_queued_io shall do the following: ]
+    if (is_failed)
+    {
+        if (error_no == EAGAIN || error_no == EWOULDBLOCK)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_017: [ If errno is EAGAIN or EWOULDBLOCK, complete_queued_io shall put the contexts with the data that is left to send back at the head of the send queue, in the order they were queued. ]
+            *is_writable = false;
+        }
+        else
+        {
+            ASYNC_SOCKET_IO_CONTEXT* failed_io_context = result;
+            ASYNC_SOCKET_SEND_RESULT send_result;
+
+            if (error_no == ECONNRESET)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_098: [ if errno is ECONNRESET, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ABANDONED. ]
+                send_result = ASYNC_SOCKET_SEND_ABANDONED;
+                LogError("A reset on the send socket has been encountered");
+            }
+            else
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_099: [ if errno is anything else, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ERROR. ]
+                send_result = ASYNC_SOCKET_SEND_ERROR;
+                LogErrorNo("failure sending data length: %" PRIu32 "", failed_io_context->message_ctx.total_buffer_bytes);
+            }
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_064: [ Only the first send that is left to send shall be completed with the error, the sends after it shall be put back at the head of the send queue. ]
+            result = failed_io_context->next;
+            complete_send(failed_io_context, send_result);
+        }
+    }
+
+    return result;
+}
+
+static void complete_io_contexts_with_failure(ASYNC_SOCKET_IO_CONTEXT* io_context, COMPLETION_PORT_EPOLL_ACTION action);
+
+static void complete_queued_io(ASYNC_SOCKET* async_socket, ASYNC_SOCKET_IO_QUEUE* io_queue)
+{
+    // the continuous receives that were cancelled, completed once the lock is released
+    ASYNC_SOCKET_IO_CONTEXT* abandoned_io_contexts = NULL;
+
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_011: [ If another thread is completing the operations of the queue, complete_queued_io shall return. ]
+        if (!io_queue->is_completing)
+        {
+            io_queue->is_completing = true;
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_012: [ While the queue is not empty and the socket is ready for the direction of the queue, complete_queued_io shall remove the first context from the queue and complete it without holding the lock: ]
+            while (io_queue->is_ready && io_queue->head != NULL)
+            {
+                ASYNC_SOCKET_IO_CONTEXT* io_context = io_queue_pop_front(io_queue);
+                // the contexts that did not complete and go back at the head of the queue
+                ASYNC_SOCKET_IO_CONTEXT* io_contexts_left = NULL;
+                // whether the continuous receive stays queued depends on it being cancelled meanwhile, which is checked with the lock held
+                ASYNC_SOCKET_IO_CONTEXT* continuous_io_context = NULL;
+                bool is_ready;
+
+                io_context->next = NULL;
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_077: [ A zero copy send shall not be coalesced with other sends. ]
+                if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_SEND && !io_context->is_zero_copy)
+                {
+                    ASYNC_SOCKET_IO_CONTEXT* last_io_context = io_context;
+                    size_t iovec_count = io_context->message_ctx.message.msg_iovlen;
+
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_061: [ For ASYNC_SOCKET_IO_TYPE_SEND, complete_queued_io shall also remove from the queue the sends that follow the first one, for as long as the iovecs of all of them fit in 64 iovecs. ]
+                    while (
+                        io_queue->head != NULL &&
+                        io_queue->head->io_type == ASYNC_SOCKET_IO_TYPE_SEND &&
+                        !io_queue->head->is_zero_copy &&
+                        iovec_count + io_queue->head->message_ctx.message.msg_iovlen <= ASYNC_SOCKET_COALESCED_SEND_IOVEC_COUNT
+                        )
+                    {
+                        last_io_context->next = io_queue_pop_front(io_queue);
+                        last_io_context = last_io_context->next;
+                        iovec_count += last_io_context->message_ctx.message.msg_iovlen;
+                    }
+                    last_io_context->next = NULL;
+                }
+
+                if (io_context->io_type != ASYNC_SOCKET_IO_TYPE_NOTIFY)
+                {
+                    // a readiness event that arrives while the I/O is performed marks the socket ready again
+                    io_queue->is_ready = false;
+                }
+                srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_NOTIFY)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_013: [ For ASYNC_SOCKET_IO_TYPE_NOTIFY, complete_queued_io shall call the notify complete callback with an IN flag for the receive queue and with an OUT flag for the send queue. ]
+                    io_context->on_notify_io_complete(io_context->callback_context, (io_queue == &async_socket->receive_queue) ? ASYNC_SOCKET_NOTIFY_IO_RESULT_IN : ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT);
+                    is_ready = false;
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_093: [ complete_queued_io shall then free the io_context memory. ]
+                    free(io_context);
+                }
+                else if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_RECEIVE)
+                {
+                    bool is_received;
+
+                    if (receive_io_context(io_context, &is_ready, &is_received) && !(io_context->is_continuous && is_received))
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_093: [ complete_queued_io shall then free the io_context memory. ]
+                        free(io_context);
+                    }
+                    else if (io_context->is_continuous)
+                    {
+                        continuous_io_context = io_context;
+                    }
                     else
                     {
-#ifdef ENABLE_SOCKET_LOGGING
-                        LogVerbose("Asynchronous send of %" PRIu32 " bytes completed at %lf", bytes_sent, timer_global_get_elapsed_us());
-#endif
-                        send_result = ASYNC_SOCKET_SEND_OK;
+                        io_contexts_left = io_context;
+                    }
+                }
+                else
+                {
+                    io_contexts_left = send_io_contexts(io_context, &is_ready);
+                }
+
+                srw_lock_ll_acquire_exclusive(&async_socket->lock);
+
+                if (continuous_io_context != NULL)
+                {
+                    if (async_socket->continuous_receive_io_context == continuous_io_context)
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_133: [ After calling on_receive_complete with ASYNC_SOCKET_RECEIVE_OK for the continuous receive of the socket, complete_queued_io shall put the context back at the head of the receive queue instead of freeing it, so that it receives the next data in the same buffers. ]
+                        io_contexts_left = continuous_io_context;
+                    }
+                    else
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_134: [ If the continuous receive was cancelled, complete_queued_io shall instead call on_receive_complete with ASYNC_SOCKET_RECEIVE_ABANDONED once the lock is released and free the context. ]
+                        continuous_io_context->next = abandoned_io_contexts;
+                        abandoned_io_contexts = continuous_io_context;
                     }
+                }
+
+                if (io_contexts_left != NULL)
+                {
+                    io_queue_push_front(io_queue, io_contexts_left);
+                }
+
+                if (is_ready || io_queue->is_shut_down)
+                {
+                    io_queue->is_ready = true;
+                }
+            }
+
+            io_queue->is_completing = false;
+        }
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    complete_io_contexts_with_failure(abandoned_io_contexts, COMPLETION_PORT_EPOLL_ABANDONED);
+}
+
+static void complete_io_contexts_with_failure(ASYNC_SOCKET_IO_CONTEXT* io_context, COMPLETION_PORT_EPOLL_ACTION action)
+{
+    while (io_context != NULL)
+    {
+        ASYNC_SOCKET_IO_CONTEXT* next_io_context = io_context->next;
+
+        if (action == COMPLETION_PORT_EPOLL_ABANDONED)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
+            if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_RECEIVE)
+            {
+                LogError("Receive socket has encountered %" PRI_MU_ENUM "", MU_ENUM_VALUE(COMPLETION_PORT_EPOLL_ACTION, action));
+                if (io_context->is_pooled)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_120: [ event_complete_callback shall call the complete callback of a pooled receive with a NULL buffer. ]
+                    io_context->on_receive_pooled_complete(io_context->callback_context, ASYNC_SOCKET_RECEIVE_ABANDONED, NULL, 0);
+                }
+                else
+                {
+                    io_context->on_receive_complete(io_context->callback_context, ASYNC_SOCKET_RECEIVE_ABANDONED, 0);
+                }
+            }
+            else if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_SEND)
+            {
+                LogError("Send socket has encountered %" PRI_MU_ENUM "", MU_ENUM_VALUE(COMPLETION_PORT_EPOLL_ACTION, action));
+                io_context->on_send_complete(io_context->callback_context, ASYNC_SOCKET_SEND_ABANDONED);
+            }
+            else
+            {
+                LogError("Notify socket has encountered %" PRI_MU_ENUM "", MU_ENUM_VALUE(COMPLETION_PORT_EPOLL_ACTION, action));
+                // Codes_SRS_ASYNC_SOCKET_LINUX_04_008: [ event_complete_callback shall call the notify complete callback with an ABANDONED flag when the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY. ]
+                io_context->on_notify_io_complete(io_context->callback_context, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED);
+            }
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_084: [ Then event_complete_callback shall free the context memory. ]
+        }
+        else
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_086: [ Otherwise event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ERROR flag. ]
+            if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_RECEIVE)
+            {
+                LogError("Receive socket has encountered COMPLETION_PORT_EPOLL_ERROR");
+                if (io_context->is_pooled)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_120: [ event_complete_callback shall call the complete callback of a pooled receive with a NULL buffer. ]
+                    io_context->on_receive_pooled_complete(io_context->callback_context, ASYNC_SOCKET_RECEIVE_ERROR, NULL, 0);
+                }
+                else
+                {
+                    io_context->on_receive_complete(io_context->callback_context, ASYNC_SOCKET_RECEIVE_ERROR, 0);
+                }
+            }
+            else if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_SEND)
+            {
+                LogError("Send socket has encountered COMPLETION_PORT_EPOLL_ERROR");
+                io_context->on_send_complete(io_context->callback_context, ASYNC_SOCKET_SEND_ERROR);
+            }
+            else
+            {
+                LogError("Notify socket has encountered COMPLETION_PORT_EPOLL_ERROR");
+                // Codes_SRS_ASYNC_SOCKET_LINUX_04_011: [ If the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY then event_complete_callback shall call the notify complete callback with an ERROR flag. ]
+                io_context->on_notify_io_complete(io_context->callback_context, ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR);
+            }
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_087: [ Then event_complete_callback shall and free the io_context memory. ]
+        }
+
+        free(io_context);
+        io_context = next_io_context;
+    }
+}
+
+static void event_complete_callback(void* context, COMPLETION_PORT_EPOLL_ACTION action)
+{
+    // Codes_SRS_ASYNC_SOCKET_LINUX_11_079: [ If context is NULL, event_complete_callback shall do nothing. ]
+    if (context == NULL)
+    {
+        LogCritical("Invalid arguement event_complete_callback void* context, COMPLETION_PORT_EPOLL_EPOLL_ACTION epoll_action, COMPLETION_PORT_EPOLL_EPOLL_RESULT result, int32_t amount_transfered");
+    }
+    else
+    {
+        ASYNC_SOCKET* async_socket = (ASYNC_SOCKET*)context;
+        switch (action)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_082: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLIN or COMPLETION_PORT_EPOLL_EPOLLRDHUP, event_complete_callback shall mark the socket as readable and complete the operations in the receive queue. ]
+            case COMPLETION_PORT_EPOLL_EPOLLIN:
+            case COMPLETION_PORT_EPOLL_EPOLLRDHUP:
+            {
+                srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                async_socket->receive_queue.is_ready = true;
+                if (action == COMPLETION_PORT_EPOLL_EPOLLRDHUP)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_018: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLRDHUP, event_complete_callback shall also keep the socket marked as readable from then on, so that the receives get the data sent before the peer closed the connection and then complete with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+                    async_socket->receive_queue.is_shut_down = true;
+                }
+                srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                complete_queued_io(async_socket, &async_socket->receive_queue);
+                break;
+            }
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_094: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLOUT, event_complete_callback shall mark the socket as writable and complete the operations in the send queue. ]
+            case COMPLETION_PORT_EPOLL_EPOLLOUT:
+            {
+                // the notifications of the error queue come with EPOLLERR, which is reported as EPOLLOUT
+                if (async_socket->zero_copy_send_threshold != 0)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_084: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLOUT and zero copy is on, event_complete_callback shall first receive the zero copy notifications of the socket: ]
+                    receive_zero_copy_notifications(async_socket);
+                }
+
+                srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                async_socket->send_queue.is_ready = true;
+                srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                complete_queued_io(async_socket, &async_socket->send_queue);
+                break;
+            }
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_080: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_ABANDONED, event_complete_callback shall remove all the contexts from the receive and send queues and for each of them do the following: ]
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_085: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_ERROR, event_complete_callback shall remove all the contexts from the receive and send queues and for each of them do the following: ]
+            case COMPLETION_PORT_EPOLL_ABANDONED:
+            case COMPLETION_PORT_EPOLL_ERROR:
+            default:
+            {
+                srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                ASYNC_SOCKET_IO_CONTEXT* receive_io_contexts = io_queue_pop_all(&async_socket->receive_queue);
+                ASYNC_SOCKET_IO_CONTEXT* send_io_contexts = io_queue_pop_all(&async_socket->send_queue);
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_089: [ event_complete_callback shall also remove all the sends that are left in the zero copy queue, whose pages the kernel did not release in time, and complete them the same way. ]
+                ASYNC_SOCKET_IO_CONTEXT* zero_copy_io_contexts = io_queue_pop_all(&async_socket->zero_copy_queue);
+                async_socket->zero_copy_sending_io_context = NULL;
+                srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                complete_io_contexts_with_failure(receive_io_contexts, action);
+                complete_io_contexts_with_failure(send_io_contexts, action);
+                complete_io_contexts_with_failure(zero_copy_io_contexts, action);
+                break;
+            }
+        }
+    }
+}
+
+static void on_io_uring_send_complete(void* context, int32_t io_result);
+static void on_io_uring_receive_complete(void* context, int32_t io_result);
+static void on_io_uring_notify_complete(void* context, int32_t io_result);
+
+static ASYNC_SOCKET_IO_CONTEXT* create_message_context(ASYNC_SOCKET* async_socket, ASYNC_SOCKET_IO_TYPE io_type, const ASYNC_SOCKET_BUFFER* buffers, uint32_t buffer_count, uint32_t total_buffer_bytes)
+{
+    ASYNC_SOCKET_IO_CONTEXT* result = malloc_flex(sizeof(ASYNC_SOCKET_IO_CONTEXT), buffer_count, sizeof(struct iovec));
+    if (result == NULL)
+    {
+        LogError("failure in malloc_flex(sizeof(ASYNC_SOCKET_IO_CONTEXT)=%zu, buffer_count=%" PRIu32 ", sizeof(struct iovec)=%zu) failed",
+            sizeof(ASYNC_SOCKET_IO_CONTEXT), buffer_count, sizeof(struct iovec));
+    }
+    else
+    {
+        ASYNC_SOCKET_MESSAGE_CONTEXT* message_ctx = &result->message_ctx;
+
+        result->io_type = io_type;
+        result->async_socket = async_socket;
+        result->next = NULL;
+        result->is_pooled = false;
+        result->is_continuous = false;
+        result->is_zero_copy = false;
+        result->zero_copy_first_sequence = 0;
+        result->zero_copy_sequence_count = 0;
+        result->zero_copy_released_count = 0;
+        result->send_result = ASYNC_SOCKET_SEND_OK;
+        message_ctx->total_buffer_bytes = total_buffer_bytes;
+        for (uint32_t index = 0; index < buffer_count; index++)
+        {
+            message_ctx->iovecs[index].iov_base = buffers[index].buffer;
+            message_ctx->iovecs[index].iov_len = buffers[index].length;
+        }
+        (void)memset(&message_ctx->message, 0, sizeof(message_ctx->message));
+        message_ctx->message.msg_iov = message_ctx->iovecs;
+        message_ctx->message.msg_iovlen = buffer_count;
+
+        result->completion_port_io.io_type = (io_type == ASYNC_SOCKET_IO_TYPE_SEND) ? COMPLETION_PORT_IO_TYPE_SEND : COMPLETION_PORT_IO_TYPE_RECEIVE;
+        result->completion_port_io.message = &message_ctx->message;
+        result->completion_port_io.poll_events = 0;
+        result->completion_port_io.on_io_complete = (io_type == ASYNC_SOCKET_IO_TYPE_SEND) ? on_io_uring_send_complete : on_io_uring_receive_complete;
+        result->completion_port_io.on_io_complete_context = result;
+    }
+    return result;
+}
+
+// must be called with the lock held, so that async_socket_close cancels every operation that is submitted
+static int submit_io_context(ASYNC_SOCKET* async_socket, ASYNC_SOCKET_IO_CONTEXT* io_context)
+{
+    int result;
+
+    (void)interlocked_increment(&async_socket->pending_io_count);
+    if (completion_port_submit_io(async_socket->completion_port, async_socket->socket_handle, &io_context->completion_port_io) != 0)
+    {
+        LogError("failure in completion_port_submit_io(completion_port=%p, socket_handle=%" PRI_SOCKET ", io_type=%" PRI_MU_ENUM ")",
+            async_socket->completion_port, async_socket->socket_handle, MU_ENUM_VALUE(ASYNC_SOCKET_IO_TYPE, io_context->io_type));
+        (void)interlocked_decrement(&async_socket->pending_io_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+// must be called with the lock held, removes the completed head of the queue and submits the next context
+// returns the contexts that could not be submitted
+static ASYNC_SOCKET_IO_CONTEXT* submit_next_io_context(ASYNC_SOCKET* async_socket, ASYNC_SOCKET_IO_QUEUE* io_queue)
+{
+    ASYNC_SOCKET_IO_CONTEXT* failed_io_contexts = NULL;
+    ASYNC_SOCKET_IO_CONTEXT* failed_io_contexts_tail = NULL;
+
+    (void)io_queue_pop_front(io_queue);
+    io_queue->is_completing = false;
 
-                    io_context->on_send_complete(io_context->callback_context, send_result);
+    // the contexts left in the queue of a socket that is closing are abandoned by async_socket_close
+    if (interlocked_add(&async_socket->state, 0) == ASYNC_SOCKET_LINUX_STATE_OPEN)
+    {
+        while (io_queue->head != NULL)
+        {
+            if (submit_io_context(async_socket, io_queue->head) == 0)
+            {
+                io_queue->is_completing = true;
+                break;
+            }
+            else
+            {
+                ASYNC_SOCKET_IO_CONTEXT* io_context = io_queue_pop_front(io_queue);
+                io_context->next = NULL;
+                if (failed_io_contexts_tail == NULL)
+                {
+                    failed_io_contexts = io_context;
                 }
+                else
+                {
+                    failed_io_contexts_tail->next = io_context;
+                }
+                failed_io_contexts_tail = io_context;
+            }
+        }
+    }
+
+    return failed_io_contexts;
+}
+
+static void end_submitted_io(ASYNC_SOCKET* async_socket)
+{
+    if (interlocked_decrement(&async_socket->pending_io_count) == 0)
+    {
+        wake_by_address_single(&async_socket->pending_io_count);
+    }
+}
+
+static void on_io_uring_send_complete(void* context, int32_t io_result)
+{
+    ASYNC_SOCKET_IO_CONTEXT* io_context = context;
+    ASYNC_SOCKET* async_socket = io_context->async_socket;
+    ASYNC_SOCKET_SEND_RESULT send_result = ASYNC_SOCKET_SEND_OK;
+    ASYNC_SOCKET_IO_CONTEXT* failed_io_contexts = NULL;
+    bool is_completed = true;
+
+    if (io_result < 0)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_032: [ If result is -ECANCELED or -ECONNRESET, on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_ABANDONED. ]
+        if (io_result == -ECANCELED || io_result == -ECONNRESET)
+        {
+            LogError("Send socket has encountered error %" PRId32 "", io_result);
+            send_result = ASYNC_SOCKET_SEND_ABANDONED;
+        }
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_033: [ If result is any other negative value, on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_ERROR. ]
+        else
+        {
+            LogError("failure sending data, error %" PRId32 "", io_result);
+            send_result = ASYNC_SOCKET_SEND_ERROR;
+        }
+    }
+    else if ((uint32_t)io_result < io_context->message_ctx.total_buffer_bytes)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_034: [ If result is less than the number of bytes left to send, on_io_uring_send_complete shall skip the bytes that were sent and submit the rest of the send again by calling completion_port_submit_io. ]
+        io_context->message_ctx.total_buffer_bytes -= (uint32_t)io_result;
+        skip_sent_bytes(&io_context->message_ctx.message, (uint32_t)io_result);
+        is_completed = false;
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_035: [ Otherwise on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_OK. ]
+    }
+
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        if (!is_completed)
+        {
+            is_completed = true;
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_036: [ If the socket is not OPEN, on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_ABANDONED. ]
+            if (interlocked_add(&async_socket->state, 0) != ASYNC_SOCKET_LINUX_STATE_OPEN)
+            {
+                send_result = ASYNC_SOCKET_SEND_ABANDONED;
+            }
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_037: [ If completion_port_submit_io fails, on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_ERROR. ]
+            else if (submit_io_context(async_socket, io_context) != 0)
+            {
+                send_result = ASYNC_SOCKET_SEND_ERROR;
+            }
+            else
+            {
+                is_completed = false;
+            }
+        }
+
+        if (is_completed)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_038: [ When a send or a receive completes, its context shall be removed from the head of its queue and, if the socket is OPEN, the next context of the queue shall be submitted by calling completion_port_submit_io. ]
+            failed_io_contexts = submit_next_io_context(async_socket, &async_socket->send_queue);
+        }
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    if (is_completed)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_039: [ The complete callback of the operation shall then be called and its context shall be freed. ]
+        io_context->on_send_complete(io_context->callback_context, send_result);
+        free(io_context);
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_040: [ The contexts that cannot be submitted shall be completed with an ERROR result. ]
+        complete_io_contexts_with_failure(failed_io_contexts, COMPLETION_PORT_EPOLL_ERROR);
+    }
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+    end_submitted_io(async_socket);
+}
+
+static void on_io_uring_receive_complete(void* context, int32_t io_result)
+{
+    ASYNC_SOCKET_IO_CONTEXT* io_context = context;
+    ASYNC_SOCKET* async_socket = io_context->async_socket;
+    ASYNC_SOCKET_RECEIVE_RESULT receive_result;
+    uint32_t bytes_received = 0;
+    ASYNC_SOCKET_IO_CONTEXT* failed_io_contexts = NULL;
+    bool is_continued;
+
+    if (io_result > 0)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_042: [ If result is greater than 0, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_OK and result as the number of bytes received. ]
+        receive_result = ASYNC_SOCKET_RECEIVE_OK;
+        bytes_received = (uint32_t)io_result;
+#ifdef ENABLE_SOCKET_LOGGING
+        LogVerbose("Asynchronous receive of %" PRIu32 " bytes completed at %lf", bytes_received, timer_global_get_elapsed_us());
+#endif
+    }
+    else if (io_result == 0)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_043: [ If result is 0, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+        LogError("Socket received 0 bytes, assuming socket is closed");
+        receive_result = ASYNC_SOCKET_RECEIVE_ABANDONED;
+    }
+    else if (io_result == -ECANCELED || io_result == -ECONNRESET)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_044: [ If result is -ECANCELED or -ECONNRESET, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+        LogError("Receive socket has encountered error %" PRId32 "", io_result);
+        receive_result = ASYNC_SOCKET_RECEIVE_ABANDONED;
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_045: [ If result is any other negative value, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_ERROR. ]
+        LogError("failure receiving data, error %" PRId32 "", io_result);
+        receive_result = ASYNC_SOCKET_RECEIVE_ERROR;
+    }
+
+    is_continued = io_context->is_continuous && (receive_result == ASYNC_SOCKET_RECEIVE_OK);
+    if (is_continued)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_136: [ If the continuous receive of the socket completes with ASYNC_SOCKET_RECEIVE_OK, on_io_uring_receive_complete shall keep it at the head of the receive queue, call on_receive_complete and then submit it again by calling completion_port_submit_io, so that it receives the next data in the same buffers. ]
+        // the buffers are only received in again once the callback consumed the data
+        io_context->on_receive_complete(io_context->callback_context, receive_result, bytes_received);
+        receive_result = ASYNC_SOCKET_RECEIVE_ABANDONED;
+        bytes_received = 0;
+    }
+
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        if (is_continued)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_137: [ If the continuous receive was cancelled or the socket is not OPEN, on_io_uring_receive_complete shall instead complete it with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+            if (async_socket->continuous_receive_io_context != io_context ||
+                interlocked_add(&async_socket->state, 0) != ASYNC_SOCKET_LINUX_STATE_OPEN)
+            {
+                is_continued = false;
+            }
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_138: [ If completion_port_submit_io fails, on_io_uring_receive_complete shall complete the continuous receive with ASYNC_SOCKET_RECEIVE_ERROR. ]
+            else if (submit_io_context(async_socket, io_context) != 0)
+            {
+                receive_result = ASYNC_SOCKET_RECEIVE_ERROR;
+                is_continued = false;
+            }
+            else
+            {
+                // submitted again, still at the head of the receive queue
+            }
+        }
+
+        if (!is_continued)
+        {
+            if (async_socket->continuous_receive_io_context == io_context)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_139: [ When the continuous receive of the socket completes, on_io_uring_receive_complete shall remove it from the socket before calling on_receive_complete, so that a new continuous receive can be started from the callback. ]
+                async_socket->continuous_receive_io_context = NULL;
+            }
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_038: [ When a send or a receive completes, its context shall be removed from the head of its queue and, if the socket is OPEN, the next context of the queue shall be submitted by calling completion_port_submit_io. ]
+            failed_io_contexts = submit_next_io_context(async_socket, &async_socket->receive_queue);
+        }
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    if (!is_continued)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_039: [ The complete callback of the operation shall then be called and its context shall be freed. ]
+        io_context->on_receive_complete(io_context->callback_context, receive_result, bytes_received);
+        free(io_context);
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_040: [ The contexts that cannot be submitted shall be completed with an ERROR result. ]
+        complete_io_contexts_with_failure(failed_io_contexts, COMPLETION_PORT_EPOLL_ERROR);
+    }
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+    end_submitted_io(async_socket);
+}
+
+static void on_io_uring_notify_complete(void* context, int32_t io_result)
+{
+    ASYNC_SOCKET_IO_CONTEXT* io_context = context;
+    ASYNC_SOCKET* async_socket = io_context->async_socket;
+    ASYNC_SOCKET_NOTIFY_IO_RESULT notify_result;
+
+    if (io_result >= 0)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_046: [ If result is not negative, on_io_uring_notify_complete shall call the notify complete callback with ASYNC_SOCKET_NOTIFY_IO_RESULT_IN if POLLIN was requested and with ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT otherwise. ]
+        notify_result = (io_context->completion_port_io.poll_events == POLLIN) ? ASYNC_SOCKET_NOTIFY_IO_RESULT_IN : ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT;
+    }
+    else if (io_result == -ECANCELED)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_047: [ If result is -ECANCELED, on_io_uring_notify_complete shall call the notify complete callback with ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED. ]
+        notify_result = ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED;
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_048: [ If result is any other negative value, on_io_uring_notify_complete shall call the notify complete callback with ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR. ]
+        LogError("failure polling the socket, error %" PRId32 "", io_result);
+        notify_result = ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR;
+    }
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_049: [ on_io_uring_notify_complete shall remove the context from the notification queue. ]
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    io_queue_remove(&async_socket->notify_queue, io_context);
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_039: [ The complete callback of the operation shall then be called and its context shall be freed. ]
+    io_context->on_notify_io_complete(io_context->callback_context, notify_result);
+    free(io_context);
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+    end_submitted_io(async_socket);
+}
+
+static void on_io_uring_ring_receive_complete(void* context, int32_t io_result)
+{
+    ASYNC_SOCKET* async_socket = context;
+    COMPLETION_PORT_IO* ring_receive_io = &async_socket->ring_receive_io;
+    // once the receive ended it can be submitted again, which changes ring_receive_io
+    bool has_more = ring_receive_io->has_more;
+    bool is_open;
+
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        if (ring_receive_io->has_buffer)
+        {
+            ASYNC_SOCKET_POOLED_BUFFER* received_buffer = async_socket->ring_buffers[ring_receive_io->buffer_id];
 
-                // Codes_SRS_ASYNC_SOCKET_LINUX_11_100: [ Then event_complete_callback shall free the io_context memory ]
-                free(io_context);
-                break;
-            }
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_085: [ If the events value contains COMPLETION_PORT_EPOLL_ERROR, event_complete_callback shall the following: ]
-            case COMPLETION_PORT_EPOLL_ERROR:
-            default:
+            async_socket->ring_buffer_count--;
+            if (io_result > 0)
             {
-                // Codes_SRS_ASYNC_SOCKET_LINUX_11_086: [ Otherwise event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ERROR flag. ]
-                if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_RECEIVE)
-                {
-                    LogError("Receive socket has encountered COMPLETION_PORT_EPOLL_ERROR");
-                    io_context->on_receive_complete(io_context->callback_context, ASYNC_SOCKET_RECEIVE_ERROR, 0);
-                }
-                else if (io_context->io_type == ASYNC_SOCKET_IO_TYPE_SEND)
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_154: [ If the kernel received data in a buffer of the ring, on_io_uring_ring_receive_complete shall add the buffer at the tail of the received buffers of the socket. ]
+                received_buffer->received_offset = 0;
+                received_buffer->received_size = (uint32_t)io_result;
+                received_buffer->next = NULL;
+                if (async_socket->received_buffers_tail == NULL)
                 {
-                    LogError("Send socket has encountered COMPLETION_PORT_EPOLL_ERROR");
-                    io_context->on_send_complete(io_context->callback_context, ASYNC_SOCKET_SEND_ERROR);
+                    async_socket->received_buffers_head = received_buffer;
                 }
                 else
                 {
-                    LogError("Notify socket has encountered COMPLETION_PORT_EPOLL_ERROR");
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_04_011: [ If the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY then event_complete_callback shall call the notify complete callback with an ERROR flag. ]
-                    io_context->on_notify_io_complete(io_context->callback_context, ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR);
+                    async_socket->received_buffers_tail->next = received_buffer;
                 }
-                // Codes_SRS_ASYNC_SOCKET_LINUX_11_087: [ Then event_complete_callback shall and free the io_context memory. ]
-                free(io_context);
-                break;
+                async_socket->received_buffers_tail = received_buffer;
+            }
+            else
+            {
+                add_ring_buffer(async_socket, ring_receive_io->buffer_id);
+            }
+        }
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_155: [ If the receive of the buffer ring ended, on_io_uring_ring_receive_complete shall do the following: ]
+        if (!has_more)
+        {
+            async_socket->is_ring_receive_submitted = false;
+            if (io_result == -EINVAL && async_socket->is_ring_receive_multishot)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_156: [ If the receive was multishot and io_result is -EINVAL, on_io_uring_ring_receive_complete shall submit a receive that completes once from then on, since the kernel does not support multishot receives. ]
+                LogWarning("The kernel rejected the multishot receive of socket %" PRI_SOCKET ", receiving with one receive per buffer", async_socket->socket_handle);
+                async_socket->is_ring_receive_multishot = false;
+            }
+            else if (io_result <= 0 && io_result != -ENOBUFS)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_157: [ If io_result is 0 or a negative errno other than -ENOBUFS, on_io_uring_ring_receive_complete shall end the stream of the socket with io_result and keep the socket marked as readable, so that the receives get the received data and then the end of the stream. ]
+                async_socket->is_ring_receive_ended = true;
+                async_socket->ring_receive_result = io_result;
+                async_socket->receive_queue.is_shut_down = true;
+            }
+            else
+            {
+                // the receive ran out of buffers (-ENOBUFS) or received once
+            }
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_158: [ on_io_uring_ring_receive_complete shall submit the receive of the buffer ring again if the stream did not end and the kernel has buffers to receive in, otherwise it is submitted again once the receives lend buffers back to the kernel. ]
+            submit_ring_receive(async_socket);
+        }
+
+        is_open = (interlocked_add(&async_socket->state, 0) == ASYNC_SOCKET_LINUX_STATE_OPEN);
+        if (is_open)
+        {
+            async_socket->receive_queue.is_ready = true;
+        }
+    }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    if (is_open)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_159: [ If the socket is OPEN, on_io_uring_ring_receive_complete shall mark the socket as readable and complete the operations in the receive queue. ]
+        complete_queued_io(async_socket, &async_socket->receive_queue);
+    }
+
+    if (!has_more)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+        end_submitted_io(async_socket);
+    }
+}
+
+// creates the buffer ring of a socket with a receive buffer pool and lends it pool buffers
+static int create_receive_buffer_ring(ASYNC_SOCKET* async_socket)
+{
+    int result;
+
+    async_socket->receive_buffer_ring = completion_port_buffer_ring_create(async_socket->completion_port, async_socket->socket_handle, ASYNC_SOCKET_RING_BUFFER_COUNT);
+    if (async_socket->receive_buffer_ring == NULL)
+    {
+        LogWarning("failure in completion_port_buffer_ring_create(completion_port=%p, socket_handle=%" PRI_SOCKET ", buffer_count=%" PRIu32 ")",
+            async_socket->completion_port, async_socket->socket_handle, (uint32_t)ASYNC_SOCKET_RING_BUFFER_COUNT);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        async_socket->ring_buffer_count = 0;
+        async_socket->received_buffers_head = NULL;
+        async_socket->received_buffers_tail = NULL;
+        async_socket->is_ring_receive_submitted = false;
+        async_socket->is_ring_receive_multishot = true;
+        async_socket->is_ring_receive_ended = false;
+        async_socket->ring_receive_result = 0;
+        async_socket->receive_queue.is_ready = false;
+        async_socket->receive_queue.is_shut_down = false;
+
+        async_socket->ring_receive_io.io_type = COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING;
+        async_socket->ring_receive_io.message = NULL;
+        async_socket->ring_receive_io.poll_events = 0;
+        async_socket->ring_receive_io.buffer_ring = async_socket->receive_buffer_ring;
+        async_socket->ring_receive_io.is_multishot = true;
+        async_socket->ring_receive_io.on_io_complete = on_io_uring_ring_receive_complete;
+        async_socket->ring_receive_io.on_io_complete_context = async_socket;
+
+        // the buffers that cannot be allocated now are allocated when the receive is submitted
+        for (uint16_t buffer_id = 0; buffer_id < ASYNC_SOCKET_RING_BUFFER_COUNT; buffer_id++)
+        {
+            replace_ring_buffer(async_socket, buffer_id);
+        }
+
+        result = 0;
+    }
+
+    return result;
+}
+
+static void destroy_receive_buffer_ring(ASYNC_SOCKET* async_socket)
+{
+    completion_port_buffer_ring_destroy(async_socket->receive_buffer_ring);
+    async_socket->receive_buffer_ring = NULL;
+
+    // the received buffers are still lent under their buffer id
+    for (uint16_t buffer_id = 0; buffer_id < ASYNC_SOCKET_RING_BUFFER_COUNT; buffer_id++)
+    {
+        if (async_socket->ring_buffers[buffer_id] != NULL)
+        {
+            buffer_pool_put(async_socket->receive_buffer_pool, async_socket->ring_buffers[buffer_id]);
+            async_socket->ring_buffers[buffer_id] = NULL;
+        }
+    }
+    async_socket->received_buffers_head = NULL;
+    async_socket->received_buffers_tail = NULL;
+}
+
+static void cancel_submitted_io(ASYNC_SOCKET* async_socket)
+{
+    bool is_cancel_failed = false;
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_020: [ If the socket uses the io_uring engine, async_socket_close shall cancel the submitted receive, the submitted send and all the submitted notifications by calling completion_port_cancel_io. ]
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    {
+        if (async_socket->receive_buffer_ring != NULL)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_164: [ If the socket receives with a buffer ring, async_socket_close shall cancel the receive of the buffer ring if it is submitted, instead of the submitted receive. ]
+            if (async_socket->is_ring_receive_submitted &&
+                completion_port_cancel_io(async_socket->completion_port, async_socket->socket_handle, &async_socket->ring_receive_io) != 0)
+            {
+                is_cancel_failed = true;
+            }
+        }
+        else if (async_socket->receive_queue.is_completing &&
+            completion_port_cancel_io(async_socket->completion_port, async_socket->socket_handle, &async_socket->receive_queue.head->completion_port_io) != 0)
+        {
+            is_cancel_failed = true;
+        }
+        if (async_socket->send_queue.is_completing &&
+            completion_port_cancel_io(async_socket->completion_port, async_socket->socket_handle, &async_socket->send_queue.head->completion_port_io) != 0)
+        {
+            is_cancel_failed = true;
+        }
+        for (ASYNC_SOCKET_IO_CONTEXT* io_context = async_socket->notify_queue.head; io_context != NULL; io_context = io_context->next)
+        {
+            if (completion_port_cancel_io(async_socket->completion_port, async_socket->socket_handle, &io_context->completion_port_io) != 0)
+            {
+                is_cancel_failed = true;
             }
         }
     }
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    if (is_cancel_failed)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_021: [ If any completion_port_cancel_io fails, async_socket_close shall call shutdown with SHUT_RDWR so that the submitted operations complete. ]
+        LogError("failure cancelling the submitted operations, shutting down the socket %" PRI_SOCKET "", async_socket->socket_handle);
+        if (shutdown(async_socket->socket_handle, SHUT_RDWR) != 0)
+        {
+            LogErrorNo("failure in shutdown(socket_handle=%" PRI_SOCKET ", SHUT_RDWR)", async_socket->socket_handle);
+        }
+    }
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_022: [ async_socket_close shall wait for all the submitted operations to complete. ]
+    int32_t value;
+    while ((value = interlocked_add(&async_socket->pending_io_count, 0)) != 0)
+    {
+        (void)wait_on_address(&async_socket->pending_io_count, value, UINT32_MAX);
+    }
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_023: [ async_socket_close shall then complete the contexts left in the receive and send queues with ABANDONED. ]
+    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+    ASYNC_SOCKET_IO_CONTEXT* receive_io_contexts = io_queue_pop_all(&async_socket->receive_queue);
+    ASYNC_SOCKET_IO_CONTEXT* send_io_contexts = io_queue_pop_all(&async_socket->send_queue);
+    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+    complete_io_contexts_with_failure(receive_io_contexts, COMPLETION_PORT_EPOLL_ABANDONED);
+    complete_io_contexts_with_failure(send_io_contexts, COMPLETION_PORT_EPOLL_ABANDONED);
+
+    if (async_socket->receive_buffer_ring != NULL)
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_165: [ If the socket receives with a buffer ring, async_socket_close shall then give the buffers lent to the kernel and the received buffers back to the receive buffer pool and destroy the buffer ring by calling completion_port_buffer_ring_destroy. ]
+        destroy_receive_buffer_ring(async_socket);
+    }
 }
 
 static void internal_close(ASYNC_SOCKET_HANDLE async_socket)
@@ -390,8 +2056,20 @@ static void internal_close(ASYNC_SOCKET_HANDLE async_socket)
         (void)wait_on_address(&async_socket->pending_api_calls, value, UINT32_MAX);
     }
 
-    if (interlocked_add(&async_socket->added_to_completion_port, 0) > 0)
+    if (async_socket->is_io_uring)
+    {
+        cancel_submitted_io(async_socket);
+    }
+    else
     {
+        if (async_socket->zero_copy_send_threshold != 0)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_147: [ If zero copy is on, async_socket_close shall first wait for the kernel to release the pages of the zero copy sends: ]
+            // completion_port_remove calls event_complete_callback with the lock of the epoll thread held, so the wait must happen before it
+            wait_for_zero_copy_release(async_socket);
+        }
+
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_005: [ async_socket_close shall remove the socket from the completion port by calling completion_port_remove, which completes all the queued operations with ABANDONED. ]
         completion_port_remove(async_socket->completion_port, async_socket->socket_handle);
     }
 
@@ -399,21 +2077,30 @@ static void internal_close(ASYNC_SOCKET_HANDLE async_socket)
     (void)close(async_socket->socket_handle);
     async_socket->socket_handle = INVALID_SOCKET;
 
-    // Codes_SRS_ASYNC_SOCKET_LINUX_11_041: [ async_socket_close shall set the state to closed. ]
+    // Codes_SRS_ASYNC_SOCKET_LINUX_11_041: [ async_socket_close shall set the state to CLOSED. ]
     (void)interlocked_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_CLOSED);
     wake_by_address_single(&async_socket->state);
 }
 
+// zero copy sends wait for the socket to be ready and are not submitted to io_uring
+static bool can_use_io_uring(ASYNC_SOCKET* async_socket)
+{
+    return
+        (async_socket->zero_copy_send_threshold == 0) &&
+        (completion_port_get_engine(async_socket->completion_port) == COMPLETION_PORT_ENGINE_IO_URING) &&
+        (async_socket->on_sendv == on_socket_sendv) &&
+        (async_socket->on_recvv == on_socket_recvv);
+}
+
 ASYNC_SOCKET_HANDLE async_socket_create(EXECUTION_ENGINE_HANDLE execution_engine)
 {
-    // Codes_SRS_ASYNC_SOCKET_LINUX_04_001: [ async_socket_create shall delegate to async_socket_create_with_transport passing in callbacks for on_send and on_recv that implement socket read and write by calling send and recv respectively from system socket API. ]
-    return async_socket_create_with_transport(execution_engine, on_socket_send, NULL, on_socket_recv, NULL);
+    // Codes_SRS_ASYNC_SOCKET_LINUX_04_001: [ async_socket_create shall delegate to async_socket_create_with_vectored_transport passing in callbacks for on_sendv and on_recvv that send and receive all the buffers with one call to sendmsg and recvmsg respectively from system socket API. ]
+    return async_socket_create_with_vectored_transport(execution_engine, on_socket_sendv, NULL, on_socket_recvv, NULL);
 }
 
 ASYNC_SOCKET_HANDLE async_socket_create_with_transport(EXECUTION_ENGINE_HANDLE execution_engine, ON_ASYNC_SOCKET_SEND on_send, void* on_send_context, ON_ASYNC_SOCKET_RECV on_recv, void* on_recv_context)
 {
     ASYNC_SOCKET_HANDLE result;
-    // Codes_SRS_ASYNC_SOCKET_LINUX_11_002: [ execution_engine shall be allowed to be NULL. ]
 
     // Codes_SRS_ASYNC_SOCKET_LINUX_04_002: [ If on_send is NULL , async_socket_create_with_transport shall fail and return NULL. ]
     // Codes_SRS_ASYNC_SOCKET_LINUX_04_003: [ If on_recv is NULL , async_socket_create_with_transport shall fail and return NULL. ]
@@ -422,10 +2109,46 @@ ASYNC_SOCKET_HANDLE async_socket_create_with_transport(EXECUTION_ENGINE_HANDLE e
         on_recv == NULL)
     {
         LogError("EXECUTION_ENGINE_HANDLE execution_engine:%p, ON_ASYNC_SOCKET_SEND on_send: %p, void* on_send_context: %p, ON_ASYNC_SOCKET_RECV on_recv: %p, void* on_recv_context: %p", execution_engine, on_send, on_send_context, on_recv, on_recv_context);
+        result = NULL;
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_050: [ async_socket_create_with_transport shall delegate to async_socket_create_with_vectored_transport passing in callbacks for on_sendv and on_recvv that call on_send and on_recv for each buffer. ]
+        result = async_socket_create_with_vectored_transport(execution_engine, on_transport_sendv, NULL, on_transport_recvv, NULL);
+        if (result == NULL)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_006: [ If any error occurs, async_socket_create_with_transport shall fail and return NULL. ]
+            LogError("failure in async_socket_create_with_vectored_transport(execution_engine=%p, on_transport_sendv, NULL, on_transport_recvv, NULL)", execution_engine);
+        }
+        else
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_051: [ async_socket_create_with_transport shall store on_send, on_send_context, on_recv and on_recv_context in the socket. ]
+            result->on_send = on_send;
+            result->on_send_context = on_send_context;
+            result->on_recv = on_recv;
+            result->on_recv_context = on_recv_context;
+        }
+    }
+
+    return result;
+}
+
+ASYNC_SOCKET_HANDLE async_socket_create_with_vectored_transport(EXECUTION_ENGINE_HANDLE execution_engine, ON_ASYNC_SOCKET_SENDV on_sendv, void* on_sendv_context, ON_ASYNC_SOCKET_RECVV on_recvv, void* on_recvv_context)
+{
+    ASYNC_SOCKET_HANDLE result;
+    // Codes_SRS_ASYNC_SOCKET_LINUX_11_002: [ execution_engine shall be allowed to be NULL. ]
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_058: [ If on_sendv is NULL , async_socket_create_with_vectored_transport shall fail and return NULL. ]
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_059: [ If on_recvv is NULL , async_socket_create_with_vectored_transport shall fail and return NULL. ]
+    if (
+        on_sendv == NULL ||
+        on_recvv == NULL)
+    {
+        LogError("EXECUTION_ENGINE_HANDLE execution_engine:%p, ON_ASYNC_SOCKET_SENDV on_sendv: %p, void* on_sendv_context: %p, ON_ASYNC_SOCKET_RECVV on_recvv: %p, void* on_recvv_context: %p", execution_engine, on_sendv, on_sendv_context, on_recvv, on_recvv_context);
     }
     else
     {
-        // Codes_SRS_ASYNC_SOCKET_LINUX_11_001: [ async_socket_create_with_transport shall allocate a new async socket and on success shall return a non-NULL handle. ]
+        // Codes_SRS_ASYNC_SOCKET_LINUX_11_001: [ async_socket_create_with_vectored_transport shall allocate a new async socket and on success shall return a non-NULL handle. ]
         result = malloc(sizeof(ASYNC_SOCKET));
         if (result == NULL)
         {
@@ -433,27 +2156,61 @@ ASYNC_SOCKET_HANDLE async_socket_create_with_transport(EXECUTION_ENGINE_HANDLE e
         }
         else
         {
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_005: [ async_socket_create_with_transport shall retrieve an COMPLETION_PORT_HANDLE object by calling platform_get_completion_port. ]
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_005: [ async_socket_create_with_vectored_transport shall retrieve an COMPLETION_PORT_HANDLE object by calling platform_get_completion_port. ]
             if ((result->completion_port = platform_get_completion_port()) == NULL)
             {
                 LogError("failure platform_get_completion_port");
             }
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_001: [ async_socket_create_with_vectored_transport shall initialize the lock protecting the operation queues by calling srw_lock_ll_init. ]
+            else if (srw_lock_ll_init(&result->lock) != 0)
+            {
+                LogError("failure srw_lock_ll_init(&result->lock=%p)", &result->lock);
+                completion_port_dec_ref(result->completion_port);
+            }
             else
             {
-                result->on_send = on_send;
-                result->on_send_context = on_send_context;
-                result->on_recv = on_recv;
-                result->on_recv_context = on_recv_context;
+                result->on_sendv = on_sendv;
+                result->on_sendv_context = on_sendv_context;
+                result->on_recvv = on_recvv;
+                result->on_recvv_context = on_recvv_context;
+                result->on_send = NULL;
+                result->on_send_context = NULL;
+                result->on_recv = NULL;
+                result->on_recv_context = NULL;
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_002: [ async_socket_create_with_vectored_transport shall initialize an empty receive queue for a socket that is not readable and an empty send queue for a socket that is writable. ]
+                io_queue_init(&result->receive_queue, false);
+                io_queue_init(&result->send_queue, true);
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_088: [ async_socket_create_with_vectored_transport shall turn zero copy off and initialize an empty zero copy queue. ]
+                result->zero_copy_send_threshold = 0;
+                result->zero_copy_next_sequence = 0;
+                result->zero_copy_sending_io_context = NULL;
+                io_queue_init(&result->zero_copy_queue, false);
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_105: [ async_socket_create_with_vectored_transport shall not set a receive buffer pool. ]
+                result->receive_buffer_pool = NULL;
+                result->receive_buffer_ring = NULL;
+                for (uint32_t buffer_id = 0; buffer_id < ASYNC_SOCKET_RING_BUFFER_COUNT; buffer_id++)
+                {
+                    result->ring_buffers[buffer_id] = NULL;
+                }
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_014: [ If on_sendv and on_recvv are the callbacks that call sendmsg and recvmsg and completion_port_get_engine returns COMPLETION_PORT_ENGINE_IO_URING, async_socket_create_with_vectored_transport shall submit the operations of the socket to the io_uring of the completion port. ]
+                result->is_io_uring = can_use_io_uring(result);
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_015: [ async_socket_create_with_vectored_transport shall initialize an empty queue of submitted notifications and set the count of submitted operations to 0. ]
+                io_queue_init(&result->notify_queue, false);
+                (void)interlocked_exchange(&result->pending_io_count, 0);
 
                 (void)interlocked_exchange(&result->pending_api_calls, 0);
-                (void)interlocked_exchange(&result->added_to_completion_port, 0);
                 (void)interlocked_exchange(&result->state, ASYNC_SOCKET_LINUX_STATE_CLOSED);
                 goto all_ok;
             }
             free(result);
         }
     }
-    // Codes_SRS_ASYNC_SOCKET_LINUX_11_006: [ If any error occurs, async_socket_create_with_transport shall fail and return NULL. ]
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_060: [ If any error occurs, async_socket_create_with_vectored_transport shall fail and return NULL. ]
     result = NULL;
 
 all_ok:
@@ -486,6 +2243,8 @@ void async_socket_destroy(ASYNC_SOCKET_HANDLE async_socket)
             (void)wait_on_address(&async_socket->state, current_state, UINT32_MAX);
         } while (1);
 
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_003: [ async_socket_destroy shall deinitialize the lock by calling srw_lock_ll_deinit. ]
+        srw_lock_ll_deinit(&async_socket->lock);
         // Codes_SRS_ASYNC_SOCKET_LINUX_11_022: [ async_socket_destroy shall decrement the reference count on the completion port. ]
         completion_port_dec_ref(async_socket->completion_port);
         // Codes_SRS_ASYNC_SOCKET_LINUX_11_023: [ async_socket_destroy shall free all resources associated with async_socket. ]
@@ -525,17 +2284,69 @@ int async_socket_open_async(ASYNC_SOCKET_HANDLE async_socket, SOCKET_HANDLE sock
         {
             async_socket->socket_handle = socket_handle;
 
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_031: [ async_socket_open_async shall add the socket to the epoll system by calling epoll_ctl with EPOLL_CTL_ADD. ]
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_032: [ async_socket_open_async shall set the state to OPEN. ]
-            (void)interlocked_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_OPEN);
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_033: [ On success async_socket_open_async shall call on_open_complete_context with ASYNC_SOCKET_OPEN_OK. ]
-            on_open_complete(on_open_complete_context, ASYNC_SOCKET_OPEN_OK);
+            if (async_socket->zero_copy_send_threshold != 0)
+            {
+                int enable = 1;
 
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_028: [ On success, async_socket_open_async shall return 0. ]
-            result = 0;
-            goto all_ok;
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_072: [ If zero copy is on, async_socket_open_async shall enable zero copy on the socket by calling setsockopt with SOL_SOCKET and SO_ZEROCOPY. ]
+                if (setsockopt(socket_handle, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) != 0)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_073: [ If setsockopt fails, async_socket_open_async shall turn zero copy off and continue opening the socket. ]
+                    LogWarning("setsockopt(socket_handle=%" PRI_SOCKET ", SOL_SOCKET, SO_ZEROCOPY) failed with errno=%d, sending without zero copy", socket_handle, errno);
+                    async_socket->zero_copy_send_threshold = 0;
+                }
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_074: [ async_socket_open_async shall start the zero copy sequence numbers of the socket at 0. ]
+                async_socket->zero_copy_next_sequence = 0;
+                async_socket->zero_copy_sending_io_context = NULL;
+            }
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_124: [ async_socket_open_async shall start the socket without a continuous receive. ]
+            async_socket->continuous_receive_io_context = NULL;
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_150: [ If the socket submits its operations to the io_uring of the completion port and has a receive buffer pool, async_socket_open_async shall create a buffer ring of 8 buffers for the socket by calling completion_port_buffer_ring_create and lend it 8 buffers taken from the receive buffer pool by calling completion_port_buffer_ring_add. ]
+            if (async_socket->is_io_uring && async_socket->receive_buffer_pool != NULL &&
+                create_receive_buffer_ring(async_socket) != 0)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_151: [ If completion_port_buffer_ring_create fails, the socket shall wait for readiness with completion_port_add instead of submitting its operations to the io_uring of the completion port, since the kernel does not support buffer rings (before 5.19). ]
+                LogWarning("No buffer ring for socket %" PRI_SOCKET ", waiting for readiness with epoll instead of io_uring", socket_handle);
+                async_socket->is_io_uring = false;
+            }
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_019: [ If the socket submits its operations to the io_uring of the completion port, async_socket_open_async shall not call completion_port_add. ]
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_031: [ async_socket_open_async shall register the socket once with the completion port by calling completion_port_add with EPOLLIN, EPOLLOUT, EPOLLRDHUP and EPOLLET, event_complete_callback as the callback and async_socket as the context. ]
+            if (!async_socket->is_io_uring &&
+                completion_port_add(async_socket->completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, socket_handle, event_complete_callback, async_socket) != 0)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_034: [ If any error occurs, async_socket_open_async shall fail and return a non-zero value. ]
+                LogError("failure with completion_port_add");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_032: [ async_socket_open_async shall set the state to OPEN. ]
+                (void)interlocked_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_OPEN);
+
+                if (async_socket->receive_buffer_ring != NULL)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_152: [ If the socket has a buffer ring, async_socket_open_async shall then submit a multishot receive that picks its buffers from the buffer ring by calling completion_port_submit_io, so that the kernel receives the data as it arrives. ]
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_153: [ If completion_port_submit_io fails, the receives of the socket shall complete with ASYNC_SOCKET_RECEIVE_ERROR. ]
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                    submit_ring_receive(async_socket);
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
+                }
 
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_033: [ On success async_socket_open_async shall call on_open_complete_context with ASYNC_SOCKET_OPEN_OK. ]
+                on_open_complete(on_open_complete_context, ASYNC_SOCKET_OPEN_OK);
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_028: [ On success, async_socket_open_async shall return 0. ]
+                result = 0;
+                goto all_ok;
+            }
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_004: [ If completion_port_add fails, async_socket_open_async shall set the state back to CLOSED. ]
             (void)interlocked_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_CLOSED);
+            wake_by_address_single(&async_socket->state);
         }
     }
 
@@ -556,14 +2367,205 @@ void async_socket_close(ASYNC_SOCKET_HANDLE async_socket)
         // Codes_SRS_ASYNC_SOCKET_LINUX_11_036: [ Otherwise, async_socket_close shall switch the state to CLOSING. ]
         if ( (current_state = interlocked_compare_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_CLOSING, ASYNC_SOCKET_LINUX_STATE_OPEN)) != ASYNC_SOCKET_LINUX_STATE_OPEN)
         {
-            // Codes_SRS_ASYNC_SOCKET_LINUX_11_042: [ If async_socket is not OPEN, async_socket_close shall return. ]
-            LogWarning("Not open, current_state=%" PRI_MU_ENUM "", MU_ENUM_VALUE(ASYNC_SOCKET_LINUX_STATE, current_state));
+            // Codes_SRS_ASYNC_SOCKET_LINUX_11_042: [ If async_socket is not OPEN, async_socket_close shall return. ]
+            LogWarning("Not open, current_state=%" PRI_MU_ENUM "", MU_ENUM_VALUE(ASYNC_SOCKET_LINUX_STATE, current_state));
+        }
+        else
+        {
+            internal_close(async_socket);
+        }
+    }
+}
+
+int async_socket_set_zero_copy_send_threshold(ASYNC_SOCKET_HANDLE async_socket, uint32_t zero_copy_send_threshold)
+{
+    int result;
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_065: [ If async_socket is NULL, async_socket_set_zero_copy_send_threshold shall fail and return a non-zero value. ]
+    if (async_socket == NULL)
+    {
+        LogError("Invalid arguments: ASYNC_SOCKET_HANDLE async_socket=%p, uint32_t zero_copy_send_threshold=%" PRIu32 "", async_socket, zero_copy_send_threshold);
+        result = MU_FAILURE;
+    }
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_066: [ If zero_copy_send_threshold is not 0 and the socket does not send with sendmsg, async_socket_set_zero_copy_send_threshold shall fail and return a non-zero value. ]
+    else if (zero_copy_send_threshold != 0 && async_socket->on_sendv != on_socket_sendv)
+    {
+        LogError("Zero copy needs the sendmsg transport, ASYNC_SOCKET_HANDLE async_socket=%p, uint32_t zero_copy_send_threshold=%" PRIu32 "", async_socket, zero_copy_send_threshold);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_067: [ Otherwise, async_socket_set_zero_copy_send_threshold shall switch the state from CLOSED to OPENING. ]
+        int32_t current_state = interlocked_compare_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_OPENING, ASYNC_SOCKET_LINUX_STATE_CLOSED);
+        if (current_state != ASYNC_SOCKET_LINUX_STATE_CLOSED)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_068: [ If async_socket is not CLOSED, async_socket_set_zero_copy_send_threshold shall fail and return a non-zero value. ]
+            LogError("Zero copy can only be set before open, current state is %" PRI_MU_ENUM "", MU_ENUM_VALUE(ASYNC_SOCKET_LINUX_STATE, current_state));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_069: [ async_socket_set_zero_copy_send_threshold shall store zero_copy_send_threshold, 0 turning zero copy off. ]
+            async_socket->zero_copy_send_threshold = zero_copy_send_threshold;
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_070: [ If zero_copy_send_threshold is not 0, the socket shall not submit its operations to the io_uring of the completion port, otherwise it shall submit them if no receive buffer pool is set and async_socket_create_with_vectored_transport would. ]
+            async_socket->is_io_uring = can_use_io_uring(async_socket);
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_071: [ async_socket_set_zero_copy_send_threshold shall set the state back to CLOSED and return 0. ]
+            (void)interlocked_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_CLOSED);
+            wake_by_address_single(&async_socket->state);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+ASYNC_SOCKET_BUFFER_POOL_HANDLE async_socket_buffer_pool_create(uint32_t buffer_size, uint32_t buffer_count)
+{
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE result;
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_090: [ If buffer_size is 0, async_socket_buffer_pool_create shall fail and return NULL. ]
+    if (buffer_size == 0)
+    {
+        LogError("Invalid arguments: uint32_t buffer_size=%" PRIu32 ", uint32_t buffer_count=%" PRIu32 "", buffer_size, buffer_count);
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_091: [ async_socket_buffer_pool_create shall allocate a new buffer pool and initialize the lock protecting its free buffers by calling srw_lock_ll_init. ]
+        result = malloc(sizeof(ASYNC_SOCKET_BUFFER_POOL));
+        if (result == NULL)
+        {
+            LogError("failure allocating buffer pool %zu", sizeof(ASYNC_SOCKET_BUFFER_POOL));
+        }
+        else
+        {
+            if (srw_lock_ll_init(&result->lock) != 0)
+            {
+                LogError("failure srw_lock_ll_init(&result->lock=%p)", &result->lock);
+            }
+            else
+            {
+                uint32_t index;
+
+                result->buffer_size = buffer_size;
+                result->max_free_buffer_count = buffer_count;
+                result->free_buffers = NULL;
+                result->free_buffer_count = 0;
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_092: [ async_socket_buffer_pool_create shall allocate buffer_count buffers of buffer_size bytes and keep them as the free buffers of the pool. ]
+                for (index = 0; index < buffer_count; index++)
+                {
+                    ASYNC_SOCKET_POOLED_BUFFER* pooled_buffer = malloc_flex(sizeof(ASYNC_SOCKET_POOLED_BUFFER), buffer_size, sizeof(unsigned char));
+                    if (pooled_buffer == NULL)
+                    {
+                        LogError("failure in malloc_flex(sizeof(ASYNC_SOCKET_POOLED_BUFFER)=%zu, buffer_size=%" PRIu32 ", sizeof(unsigned char)=%zu), buffer %" PRIu32 " of %" PRIu32 "",
+                            sizeof(ASYNC_SOCKET_POOLED_BUFFER), buffer_size, sizeof(unsigned char), index, buffer_count);
+                        break;
+                    }
+                    pooled_buffer->next = result->free_buffers;
+                    result->free_buffers = pooled_buffer;
+                    result->free_buffer_count++;
+                }
+
+                if (index == buffer_count)
+                {
+                    goto all_ok;
+                }
+
+                while (result->free_buffers != NULL)
+                {
+                    ASYNC_SOCKET_POOLED_BUFFER* next_buffer = result->free_buffers->next;
+                    free(result->free_buffers);
+                    result->free_buffers = next_buffer;
+                }
+                srw_lock_ll_deinit(&result->lock);
+            }
+            free(result);
+        }
+    }
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_093: [ If any error occurs, async_socket_buffer_pool_create shall fail and return NULL. ]
+    result = NULL;
+
+all_ok:
+    return result;
+}
+
+void async_socket_buffer_pool_destroy(ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool)
+{
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_094: [ If buffer_pool is NULL, async_socket_buffer_pool_destroy shall return. ]
+    if (buffer_pool == NULL)
+    {
+        LogError("Invalid arguments: ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool=%p", buffer_pool);
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_095: [ async_socket_buffer_pool_destroy shall free the free buffers of the pool, deinitialize the lock by calling srw_lock_ll_deinit and free the pool. ]
+        while (buffer_pool->free_buffers != NULL)
+        {
+            ASYNC_SOCKET_POOLED_BUFFER* next_buffer = buffer_pool->free_buffers->next;
+            free(buffer_pool->free_buffers);
+            buffer_pool->free_buffers = next_buffer;
+        }
+        srw_lock_ll_deinit(&buffer_pool->lock);
+        free(buffer_pool);
+    }
+}
+
+void async_socket_buffer_pool_return(ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool, void* buffer)
+{
+    if (
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_096: [ If buffer_pool is NULL, async_socket_buffer_pool_return shall return. ]
+        buffer_pool == NULL ||
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_097: [ If buffer is NULL, async_socket_buffer_pool_return shall return. ]
+        buffer == NULL
+        )
+    {
+        LogError("Invalid arguments: ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool=%p, void* buffer=%p", buffer_pool, buffer);
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_098: [ If the pool keeps fewer than buffer_count free buffers, async_socket_buffer_pool_return shall add buffer to the free buffers of the pool, otherwise it shall free buffer. ]
+        buffer_pool_put(buffer_pool, CONTAINING_RECORD(buffer, ASYNC_SOCKET_POOLED_BUFFER, data));
+    }
+}
+
+int async_socket_set_receive_buffer_pool(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool)
+{
+    int result;
+
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_099: [ If async_socket is NULL, async_socket_set_receive_buffer_pool shall fail and return a non-zero value. ]
+    if (async_socket == NULL)
+    {
+        LogError("Invalid arguments: ASYNC_SOCKET_HANDLE async_socket=%p, ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool=%p", async_socket, buffer_pool);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_100: [ Otherwise, async_socket_set_receive_buffer_pool shall switch the state from CLOSED to OPENING. ]
+        int32_t current_state = interlocked_compare_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_OPENING, ASYNC_SOCKET_LINUX_STATE_CLOSED);
+        if (current_state != ASYNC_SOCKET_LINUX_STATE_CLOSED)
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_101: [ If async_socket is not CLOSED, async_socket_set_receive_buffer_pool shall fail and return a non-zero value. ]
+            LogError("The receive buffer pool can only be set before open, current state is %" PRI_MU_ENUM "", MU_ENUM_VALUE(ASYNC_SOCKET_LINUX_STATE, current_state));
+            result = MU_FAILURE;
         }
         else
         {
-            internal_close(async_socket);
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_102: [ async_socket_set_receive_buffer_pool shall store buffer_pool, NULL turning the pooled receives off. ]
+            async_socket->receive_buffer_pool = buffer_pool;
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_103: [ The socket shall submit its operations to the io_uring of the completion port if zero copy is off and async_socket_create_with_vectored_transport would, whether buffer_pool is NULL or not. ]
+            async_socket->is_io_uring = can_use_io_uring(async_socket);
+
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_104: [ async_socket_set_receive_buffer_pool shall set the state back to CLOSED and return 0. ]
+            (void)interlocked_exchange(&async_socket->state, ASYNC_SOCKET_LINUX_STATE_CLOSED);
+            wake_by_address_single(&async_socket->state);
+            result = 0;
         }
     }
+
+    return result;
 }
 
 ASYNC_SOCKET_SEND_SYNC_RESULT async_socket_send_async(ASYNC_SOCKET_HANDLE async_socket, const ASYNC_SOCKET_BUFFER* buffers, uint32_t buffer_count, ON_ASYNC_SOCKET_SEND_COMPLETE on_send_complete, void* on_send_complete_context)
@@ -637,50 +2639,125 @@ ASYNC_SOCKET_SEND_SYNC_RESULT async_socket_send_async(ASYNC_SOCKET_HANDLE async_
                 LogVerbose("Starting send of %" PRIu32 " bytes at %lf", total_buffer_bytes, timer_global_get_elapsed_us());
 #endif
 
-                ASYNC_SOCKET_SEND_RESULT send_result;
-                for (index = 0; index < buffer_count; index++)
+                if (async_socket->is_io_uring)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_024: [ If the socket submits its operations to the io_uring of the completion port, async_socket_send_async shall create a context for the send where an iovec for each of the buffers of payload, on_send_complete and on_send_complete_context shall be stored. ]
+                    ASYNC_SOCKET_IO_CONTEXT* io_context = create_message_context(async_socket, ASYNC_SOCKET_IO_TYPE_SEND, buffers, buffer_count, total_buffer_bytes);
+                    if (io_context == NULL)
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+                        result = ASYNC_SOCKET_SEND_SYNC_ERROR;
+                        goto all_ok;
+                    }
+
+                    io_context->on_send_complete = on_send_complete;
+                    io_context->callback_context = on_send_complete_context;
+
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                    {
+                        if (async_socket->send_queue.head != NULL)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_12_025: [ If the send queue is not empty, async_socket_send_async shall add the context at the tail of the send queue. ]
+                            io_queue_push_back(&async_socket->send_queue, io_context);
+                            result = ASYNC_SOCKET_SEND_SYNC_OK;
+                        }
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_026: [ Otherwise, async_socket_send_async shall submit the send by calling completion_port_submit_io and add the context to the send queue. ]
+                        else if (submit_io_context(async_socket, io_context) != 0)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+                            free(io_context);
+                            result = ASYNC_SOCKET_SEND_SYNC_ERROR;
+                        }
+                        else
+                        {
+                            io_queue_push_back(&async_socket->send_queue, io_context);
+                            async_socket->send_queue.is_completing = true;
+                            result = ASYNC_SOCKET_SEND_SYNC_OK;
+                        }
+                    }
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
+                    goto all_ok;
+                }
+
+                bool is_sending_inline;
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_075: [ If zero copy is on and the payload is at least zero_copy_send_threshold bytes, the send shall be a zero copy send, which is never sent on the calling thread. ]
+                bool is_zero_copy = (async_socket->zero_copy_send_threshold != 0) && (total_buffer_bytes >= async_socket->zero_copy_send_threshold);
+
+                srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_006: [ If buffer_count is at most 16, the send queue is empty, no other thread is completing sends and the socket is writable, async_socket_send_async shall send the payload on the calling thread. ]
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_076: [ If zero copy is on, async_socket_send_async shall also send the payload on the calling thread only if the zero copy queue is empty and no other thread is completing the sends in it. ]
+                    is_sending_inline =
+                        !is_zero_copy &&
+                        buffer_count <= ASYNC_SOCKET_INLINE_SEND_IOVEC_COUNT &&
+                        async_socket->send_queue.head == NULL &&
+                        !async_socket->send_queue.is_completing &&
+                        async_socket->send_queue.is_ready &&
+                        async_socket->zero_copy_queue.head == NULL &&
+                        !async_socket->zero_copy_queue.is_completing;
+                    if (is_sending_inline)
+                    {
+                        // sends queued meanwhile wait for this one, a writable event that arrives meanwhile marks the socket writable again
+                        async_socket->send_queue.is_completing = true;
+                        async_socket->send_queue.is_ready = false;
+                    }
+                }
+                srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                if (is_sending_inline)
                 {
+                    ASYNC_SOCKET_SEND_RESULT send_result;
+                    ASYNC_SOCKET_IO_CONTEXT* io_context = NULL;
+                    bool is_writable = false;
+                    struct iovec iovecs[ASYNC_SOCKET_INLINE_SEND_IOVEC_COUNT];
+                    struct msghdr message;
+                    uint32_t bytes_left = total_buffer_bytes;
                     int error_no;
-                    ssize_t total_data_sent;
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_054: [ If the send fails to send the data, async_socket_send_async shall do the following: ]
-                    if (send_data(async_socket, &buffers[index], &total_data_sent, &error_no) != 0)
+
+                    for (index = 0; index < buffer_count; index++)
+                    {
+                        iovecs[index].iov_base = buffers[index].buffer;
+                        iovecs[index].iov_len = buffers[index].length;
+                    }
+                    (void)memset(&message, 0, sizeof(message));
+                    message.msg_iov = iovecs;
+                    message.msg_iovlen = buffer_count;
+
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_054: [ If on_sendv fails to send the data, async_socket_send_async shall do the following: ]
+                    if (send_message(async_socket, &message, &bytes_left, &error_no) != 0)
                     {
                         // Codes_SRS_ASYNC_SOCKET_LINUX_11_055: [ If the errno value is EAGAIN or EWOULDBLOCK. ]
                         if (error_no == EAGAIN || error_no == EWOULDBLOCK)
                         {
-                            // Codes_SRS_ASYNC_SOCKET_LINUX_11_056: [ async_socket_send_async shall create a context for the send where the payload, on_send_complete and on_send_complete_context shall be stored. ]
-                            ASYNC_SOCKET_IO_CONTEXT* io_context = malloc(sizeof(ASYNC_SOCKET_IO_CONTEXT));
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_11_056: [ async_socket_send_async shall create a context for the send where the payload that is left to send, on_send_complete and on_send_complete_context shall be stored. ]
+                            io_context = create_message_context(async_socket, ASYNC_SOCKET_IO_TYPE_SEND, buffers, buffer_count, total_buffer_bytes);
                             if (io_context == NULL)
                             {
-                                LogError("malloc(sizeof(ASYNC_SOCKET_SEND_CONTEXT)=%zu failed", sizeof(ASYNC_SOCKET_IO_CONTEXT));
+                                if (bytes_left < total_buffer_bytes)
+                                {
+                                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_140: [ If creating the context fails after part of the payload was sent, async_socket_send_async shall call shutdown with SHUT_RDWR so that no other data follows the partial payload on the socket. ]
+                                    // the caller cannot resend the payload without repeating the bytes that are already on the wire
+                                    LogError("failure creating the context for the %" PRIu32 " bytes left to send out of %" PRIu32 ", shutting the socket down", bytes_left, total_buffer_bytes);
+                                    if (shutdown(async_socket->socket_handle, SHUT_RDWR) != 0)
+                                    {
+                                        LogErrorNo("failure in shutdown(socket_handle=%" PRI_SOCKET ", SHUT_RDWR)", async_socket->socket_handle);
+                                    }
+                                }
+                                // Codes_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
                                 result = ASYNC_SOCKET_SEND_SYNC_ERROR;
                                 send_result = ASYNC_SOCKET_SEND_ABANDONED;
-                                break;
                             }
                             else
                             {
-                                send_result = ASYNC_SOCKET_SEND_ERROR;
-                                io_context->io_type = ASYNC_SOCKET_IO_TYPE_SEND;
-                                io_context->data.send_ctx.total_buffer_bytes = total_buffer_bytes - total_data_sent;
                                 io_context->on_send_complete = on_send_complete;
                                 io_context->callback_context = on_send_complete_context;
-                                io_context->async_socket = async_socket;
-
-                                io_context->data.send_ctx.socket_buffer.buffer = buffers[index].buffer + total_data_sent;
-                                io_context->data.send_ctx.socket_buffer.length = buffers[index].length - total_data_sent;
-
-                                // Codes_SRS_ASYNC_SOCKET_LINUX_11_057: [ The context shall then be added to the completion port system by calling completion_port_add with EPOLL_CTL_MOD and event_complete_callback as the callback. ]
-                                if (completion_port_add(async_socket->completion_port, EPOLLOUT, async_socket->socket_handle, event_complete_callback, io_context) != 0)
-                                {
-                                    LogError("failure with completion_port_add");
-                                    result = ASYNC_SOCKET_SEND_SYNC_ERROR;
-                                }
-                                else
+                                if (bytes_left < total_buffer_bytes)
                                 {
-                                    (void)interlocked_increment(&async_socket->added_to_completion_port);
-                                    result = ASYNC_SOCKET_SEND_SYNC_OK;
-                                    goto all_ok;
+                                    io_context->message_ctx.total_buffer_bytes = bytes_left;
+                                    skip_sent_bytes(&io_context->message_ctx.message, total_buffer_bytes - bytes_left);
                                 }
+                                send_result = ASYNC_SOCKET_SEND_ERROR;
+                                result = ASYNC_SOCKET_SEND_SYNC_OK;
                             }
                         }
                         // Codes_SRS_ASYNC_SOCKET_LINUX_11_059: [ If the errno value is ECONNRESET, ENOTCONN, or EPIPE shall fail and return ASYNC_SOCKET_SEND_SYNC_ABANDONED. ]
@@ -690,6 +2767,7 @@ ASYNC_SOCKET_SEND_SYNC_RESULT async_socket_send_async(ASYNC_SOCKET_HANDLE async_
                             send_result = ASYNC_SOCKET_SEND_ABANDONED;
                             // Socket was closed
                             result = ASYNC_SOCKET_SEND_SYNC_NOT_OPEN;
+                            is_writable = true;
                         }
                         else
                         {
@@ -697,6 +2775,7 @@ ASYNC_SOCKET_SEND_SYNC_RESULT async_socket_send_async(ASYNC_SOCKET_HANDLE async_
                             LogErrorNo("failure sending socket error no");
                             result = ASYNC_SOCKET_SEND_SYNC_ERROR;
                             send_result = ASYNC_SOCKET_SEND_ERROR;
+                            is_writable = true;
                         }
                     }
                     else
@@ -704,22 +2783,62 @@ ASYNC_SOCKET_SEND_SYNC_RESULT async_socket_send_async(ASYNC_SOCKET_HANDLE async_
                         // Codes_SRS_ASYNC_SOCKET_LINUX_11_062: [ On success, async_socket_send_async shall return ASYNC_SOCKET_SEND_SYNC_OK. ]
                         send_result = ASYNC_SOCKET_SEND_OK;
                         result = ASYNC_SOCKET_SEND_SYNC_OK;
+                        is_writable = true;
                     }
-                }
-                // Only call the callback if the call was successfully sent
-                // Otherwise we're going to be returning an error
-                if (send_result == ASYNC_SOCKET_SEND_OK)
-                {
+                    // Only call the callback if the call was successfully sent
+                    // Otherwise we're going to be returning an error
+                    if (send_result == ASYNC_SOCKET_SEND_OK)
+                    {
 #ifdef ENABLE_SOCKET_LOGGING
-                    LogVerbose("Send completed synchronously at %lf", timer_global_get_elapsed_us());
+                        LogVerbose("Send completed synchronously at %lf", timer_global_get_elapsed_us());
 #endif
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_061: [ If the send is successful, async_socket_send_async shall call the on_send_complete with on_send_complete_context and ASYNC_SOCKET_SEND_SYNC_OK. ]
-                    on_send_complete(on_send_complete_context, send_result);
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_061: [ If the send is successful, async_socket_send_async shall call the on_send_complete with on_send_complete_context and ASYNC_SOCKET_SEND_SYNC_OK. ]
+                        on_send_complete(on_send_complete_context, send_result);
+                    }
+                    else
+                    {
+                        // Do nothing.  If failure happend do not call the callback
+                    }
+
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                    {
+                        if (io_context != NULL)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_11_057: [ The context shall then be inserted at the head of the send queue so that it is sent before any send queued meanwhile when the socket becomes writable. ]
+                            io_queue_push_front(&async_socket->send_queue, io_context);
+                        }
+                        if (is_writable)
+                        {
+                            async_socket->send_queue.is_ready = true;
+                        }
+                        async_socket->send_queue.is_completing = false;
+                    }
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
                 }
                 else
                 {
-                    // Do nothing.  If failure happend do not call the callback
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_007: [ Otherwise, async_socket_send_async shall create a context for the send where an iovec for each of the buffers of payload, on_send_complete and on_send_complete_context shall be stored and add it at the tail of the send queue. ]
+                    ASYNC_SOCKET_IO_CONTEXT* io_context = create_message_context(async_socket, ASYNC_SOCKET_IO_TYPE_SEND, buffers, buffer_count, total_buffer_bytes);
+                    if (io_context == NULL)
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+                        result = ASYNC_SOCKET_SEND_SYNC_ERROR;
+                        goto all_ok;
+                    }
+
+                    io_context->on_send_complete = on_send_complete;
+                    io_context->callback_context = on_send_complete_context;
+                    io_context->is_zero_copy = is_zero_copy;
+
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                    io_queue_push_back(&async_socket->send_queue, io_context);
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                    result = ASYNC_SOCKET_SEND_SYNC_OK;
                 }
+
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_008: [ async_socket_send_async shall then complete the operations in the send queue if the socket is writable. ]
+                complete_queued_io(async_socket, &async_socket->send_queue);
             }
 all_ok:
             if (interlocked_decrement(&async_socket->pending_api_calls) == 0)
@@ -732,7 +2851,8 @@ all_ok:
     return result;
 }
 
-int async_socket_receive_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER* payload, uint32_t buffer_count, ON_ASYNC_SOCKET_RECEIVE_COMPLETE on_receive_complete, void* on_receive_complete_context)
+// a continuous receive is also stored in the socket, only one can be started at a time
+static int queue_receive(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER* payload, uint32_t buffer_count, ON_ASYNC_SOCKET_RECEIVE_COMPLETE on_receive_complete, void* on_receive_complete_context, bool is_continuous)
 {
     int result;
     // Codes_SRS_ASYNC_SOCKET_LINUX_11_071: [ on_receive_complete_context shall be allowed to be NULL. ]
@@ -796,53 +2916,117 @@ int async_socket_receive_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BU
                 LogWarning("Not open, current state is %" PRI_MU_ENUM "", MU_ENUM_VALUE(ASYNC_SOCKET_LINUX_STATE, current_state));
                 result = MU_FAILURE;
             }
-            else
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_166: [ If the socket receives with a buffer ring, async_socket_receive_async shall queue the receive and complete the receive queue the same way as when the socket does not use io_uring. ]
+            else if (async_socket->is_io_uring && async_socket->receive_buffer_ring == NULL)
             {
-                // Codes_SRS_ASYNC_SOCKET_LINUX_11_074: [ The context shall also allocate enough memory to keep an array of buffer_count items. ]
-                ASYNC_SOCKET_IO_CONTEXT* io_context = malloc_flex(sizeof(ASYNC_SOCKET_IO_CONTEXT), buffer_count, sizeof(ASYNC_SOCKET_BUFFER));
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_027: [ Otherwise, if the socket submits its operations to the io_uring of the completion port, async_socket_receive_async shall create a context for the receive where an iovec for each of the buffers of payload, on_receive_complete and on_receive_complete_context shall be stored. ]
+                ASYNC_SOCKET_IO_CONTEXT* io_context = create_message_context(async_socket, ASYNC_SOCKET_IO_TYPE_RECEIVE, payload, buffer_count, total_buffer_bytes);
                 if (io_context == NULL)
                 {
-                    LogError("failure in malloc_flex(sizeof(ASYNC_SOCKET_RECV_CONTEXT)=%zu, buffer_count=%" PRIu32 ", sizeof(ASYNC_SOCKET_BUFFER)=%zu) failed",
-                        sizeof(ASYNC_SOCKET_IO_CONTEXT), buffer_count, sizeof(ASYNC_SOCKET_BUFFER));
-                    result = ASYNC_SOCKET_SEND_SYNC_ERROR;
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_078: [ If any error occurs, async_socket_receive_async shall fail and return a non-zero value. ]
+                    result = MU_FAILURE;
                 }
                 else
                 {
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_073: [ Otherwise async_socket_receive_async shall create a context for the recv where the payload, on_receive_complete and on_receive_complete_context shall be stored. ]
-                    io_context->io_type = ASYNC_SOCKET_IO_TYPE_RECEIVE;
                     io_context->on_receive_complete = on_receive_complete;
                     io_context->callback_context = on_receive_complete_context;
-                    io_context->async_socket = async_socket;
-                    io_context->data.recv_ctx.total_buffer_count = buffer_count;
+                    io_context->is_continuous = is_continuous;
 
-                    for (index = 0; index < buffer_count; index++)
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
                     {
-                        io_context->data.recv_ctx.recv_buffers[index].buffer = payload[index].buffer;
-                        io_context->data.recv_ctx.recv_buffers[index].length = payload[index].length;
+                        if (async_socket->continuous_receive_io_context != NULL)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_12_122: [ If the socket already has a continuous receive, async_socket_receive_continuous_async shall fail and return a non-zero value. ]
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_12_144: [ If the socket has a continuous receive, async_socket_receive_async shall fail and return a non-zero value. ]
+                            LogError("A continuous receive is already started, ASYNC_SOCKET_HANDLE async_socket=%p", async_socket);
+                            free(io_context);
+                            result = MU_FAILURE;
+                        }
+                        else if (async_socket->receive_queue.head != NULL)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_12_028: [ If the receive queue is not empty, async_socket_receive_async shall add the context at the tail of the receive queue. ]
+                            io_queue_push_back(&async_socket->receive_queue, io_context);
+                            result = 0;
+                        }
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_029: [ Otherwise, async_socket_receive_async shall submit the receive by calling completion_port_submit_io and add the context to the receive queue. ]
+                        else if (submit_io_context(async_socket, io_context) != 0)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_11_078: [ If any error occurs, async_socket_receive_async shall fail and return a non-zero value. ]
+                            free(io_context);
+                            result = MU_FAILURE;
+                        }
+                        else
+                        {
+                            io_queue_push_back(&async_socket->receive_queue, io_context);
+                            async_socket->receive_queue.is_completing = true;
+                            result = 0;
+                        }
+
+                        if (is_continuous && result == 0)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_12_123: [ async_socket_receive_continuous_async shall store the context as the continuous receive of the socket. ]
+                            async_socket->continuous_receive_io_context = io_context;
+                        }
                     }
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
+                }
+            }
+            else
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_073: [ Otherwise async_socket_receive_async shall create a context for the recv where an iovec for each of the buffers of payload, on_receive_complete and on_receive_complete_context shall be stored. ]
+                // Codes_SRS_ASYNC_SOCKET_LINUX_11_074: [ The context shall also allocate enough memory to keep an array of buffer_count iovecs. ]
+                ASYNC_SOCKET_IO_CONTEXT* io_context = create_message_context(async_socket, ASYNC_SOCKET_IO_TYPE_RECEIVE, payload, buffer_count, total_buffer_bytes);
+                if (io_context == NULL)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_078: [ If any error occurs, async_socket_receive_async shall fail and return a non-zero value. ]
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    bool has_continuous_receive;
+
+                    io_context->on_receive_complete = on_receive_complete;
+                    io_context->callback_context = on_receive_complete_context;
+                    io_context->is_continuous = is_continuous;
 
 #ifdef ENABLE_SOCKET_LOGGING
                     LogVerbose("Starting receive at %lf", timer_global_get_elapsed_us());
 #endif
 
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_11_102: [ Then the context shall then be added to the completion port system by calling completion_port_add with EPOLLIN and event_complete_callback as the callback. ]
-                    if (completion_port_add(async_socket->completion_port, EPOLLIN | EPOLLRDHUP | EPOLLONESHOT, async_socket->socket_handle, event_complete_callback, io_context) != 0)
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                    // a receive queued behind the continuous receive would only complete once it ended
+                    has_continuous_receive = (async_socket->continuous_receive_io_context != NULL);
+                    if (!has_continuous_receive)
+                    {
+                        if (is_continuous)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_12_123: [ async_socket_receive_continuous_async shall store the context as the continuous receive of the socket. ]
+                            async_socket->continuous_receive_io_context = io_context;
+                        }
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_102: [ Then the context shall be added at the tail of the receive queue. ]
+                        io_queue_push_back(&async_socket->receive_queue, io_context);
+                    }
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                    if (has_continuous_receive)
                     {
-                        // Codes_SRS_ASYNC_SOCKET_LINUX_11_078: [ If any error occurs, async_socket_receive_async shall fail and return a non-zero value. ]
-                        LogWarning("failure with completion_port_add");
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_122: [ If the socket already has a continuous receive, async_socket_receive_continuous_async shall fail and return a non-zero value. ]
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_144: [ If the socket has a continuous receive, async_socket_receive_async shall fail and return a non-zero value. ]
+                        LogError("A continuous receive is already started, ASYNC_SOCKET_HANDLE async_socket=%p", async_socket);
+                        free(io_context);
                         result = MU_FAILURE;
                     }
                     else
                     {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_009: [ async_socket_receive_async shall then complete the operations in the receive queue if the socket is readable. ]
+                        complete_queued_io(async_socket, &async_socket->receive_queue);
+
                         // Codes_SRS_ASYNC_SOCKET_LINUX_11_077: [ On success, async_socket_receive_async shall return 0. ]
                         result = 0;
-                        (void)interlocked_increment(&async_socket->added_to_completion_port);
-                        goto all_ok;
                     }
-                    free(io_context);
                 }
             }
-all_ok:
+
             if (interlocked_decrement(&async_socket->pending_api_calls) == 0)
             {
                 wake_by_address_single(&async_socket->pending_api_calls);
@@ -852,6 +3036,184 @@ all_ok:
     return result;
 }
 
+int async_socket_receive_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER* payload, uint32_t buffer_count, ON_ASYNC_SOCKET_RECEIVE_COMPLETE on_receive_complete, void* on_receive_complete_context)
+{
+    return queue_receive(async_socket, payload, buffer_count, on_receive_complete, on_receive_complete_context, false);
+}
+
+int async_socket_receive_continuous_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER* payload, uint32_t buffer_count, ON_ASYNC_SOCKET_RECEIVE_COMPLETE on_receive_complete, void* on_receive_complete_context)
+{
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_121: [ async_socket_receive_continuous_async shall validate its arguments, create the context of the receive and add it to the receive queue the same way as async_socket_receive_async. ]
+    return queue_receive(async_socket, payload, buffer_count, on_receive_complete, on_receive_complete_context, true);
+}
+
+int async_socket_cancel_continuous_receive(ASYNC_SOCKET_HANDLE async_socket)
+{
+    int result;
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_125: [ If async_socket is NULL, async_socket_cancel_continuous_receive shall fail and return a non-zero value. ]
+    if (async_socket == NULL)
+    {
+        LogError("Invalid arguments: ASYNC_SOCKET_HANDLE async_socket=%p", async_socket);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        (void)interlocked_increment(&async_socket->pending_api_calls);
+
+        ASYNC_SOCKET_LINUX_STATE current_state;
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_126: [ If async_socket is not OPEN, async_socket_cancel_continuous_receive shall fail and return a non-zero value. ]
+        if ((current_state = interlocked_add(&async_socket->state, 0)) != ASYNC_SOCKET_LINUX_STATE_OPEN)
+        {
+            LogWarning("Not open, current state is %" PRI_MU_ENUM "", MU_ENUM_VALUE(ASYNC_SOCKET_LINUX_STATE, current_state));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            ASYNC_SOCKET_IO_CONTEXT* abandoned_io_context = NULL;
+
+            srw_lock_ll_acquire_exclusive(&async_socket->lock);
+            {
+                ASYNC_SOCKET_IO_CONTEXT* io_context = async_socket->continuous_receive_io_context;
+                if (io_context == NULL)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_127: [ If the socket has no continuous receive, async_socket_cancel_continuous_receive shall fail and return a non-zero value. ]
+                    LogError("No continuous receive is started, ASYNC_SOCKET_HANDLE async_socket=%p", async_socket);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    ASYNC_SOCKET_IO_CONTEXT* queued_io_context = async_socket->receive_queue.head;
+
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_128: [ Otherwise async_socket_cancel_continuous_receive shall remove the continuous receive from the socket. ]
+                    async_socket->continuous_receive_io_context = NULL;
+
+                    while (queued_io_context != NULL && queued_io_context != io_context)
+                    {
+                        queued_io_context = queued_io_context->next;
+                    }
+
+                    if (queued_io_context == NULL)
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_131: [ If the continuous receive is being completed, it shall be completed with ASYNC_SOCKET_RECEIVE_ABANDONED by the thread completing it. ]
+                    }
+                    else if (async_socket->is_io_uring && async_socket->receive_buffer_ring == NULL && async_socket->receive_queue.head == io_context && async_socket->receive_queue.is_completing)
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_130: [ If the continuous receive is submitted to the io_uring of the completion port, async_socket_cancel_continuous_receive shall cancel it by calling completion_port_cancel_io. ]
+                        if (completion_port_cancel_io(async_socket->completion_port, async_socket->socket_handle, &io_context->completion_port_io) != 0)
+                        {
+                            LogWarning("failure cancelling the continuous receive of socket %" PRI_SOCKET ", it completes with its next data", async_socket->socket_handle);
+                        }
+                    }
+                    else
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_129: [ If the continuous receive is waiting in the receive queue, async_socket_cancel_continuous_receive shall remove it from the queue, call its on_receive_complete with ASYNC_SOCKET_RECEIVE_ABANDONED and free it. ]
+                        io_queue_remove(&async_socket->receive_queue, io_context);
+                        io_context->next = NULL;
+                        abandoned_io_context = io_context;
+                    }
+
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_132: [ On success, async_socket_cancel_continuous_receive shall return 0. ]
+                    result = 0;
+                }
+            }
+            srw_lock_ll_release_exclusive(&async_socket->lock);
+
+            complete_io_contexts_with_failure(abandoned_io_context, COMPLETION_PORT_EPOLL_ABANDONED);
+        }
+
+        if (interlocked_decrement(&async_socket->pending_api_calls) == 0)
+        {
+            wake_by_address_single(&async_socket->pending_api_calls);
+        }
+    }
+    return result;
+}
+
+int async_socket_receive_pooled_async(ASYNC_SOCKET_HANDLE async_socket, ON_ASYNC_SOCKET_RECEIVE_POOLED_COMPLETE on_receive_complete, void* on_receive_complete_context)
+{
+    int result;
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_108: [ on_receive_complete_context shall be allowed to be NULL. ]
+    if (
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_106: [ If async_socket is NULL, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+        async_socket == NULL ||
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_107: [ If on_receive_complete is NULL, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+        on_receive_complete == NULL
+        )
+    {
+        LogError("Invalid arguments: ASYNC_SOCKET_HANDLE async_socket=%p, ON_ASYNC_SOCKET_RECEIVE_POOLED_COMPLETE on_receive_complete=%p, void*, on_receive_complete_context=%p",
+            async_socket, on_receive_complete, on_receive_complete_context);
+        result = MU_FAILURE;
+    }
+    // Codes_SRS_ASYNC_SOCKET_LINUX_12_109: [ If the socket has no receive buffer pool, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+    else if (async_socket->receive_buffer_pool == NULL)
+    {
+        LogError("No receive buffer pool is set, ASYNC_SOCKET_HANDLE async_socket=%p", async_socket);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        (void)interlocked_increment(&async_socket->pending_api_calls);
+
+        ASYNC_SOCKET_LINUX_STATE current_state;
+        // Codes_SRS_ASYNC_SOCKET_LINUX_12_110: [ If async_socket is not OPEN, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+        if ((current_state = interlocked_add(&async_socket->state, 0)) != ASYNC_SOCKET_LINUX_STATE_OPEN)
+        {
+            LogWarning("Not open, current state is %" PRI_MU_ENUM "", MU_ENUM_VALUE(ASYNC_SOCKET_LINUX_STATE, current_state));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            // Codes_SRS_ASYNC_SOCKET_LINUX_12_111: [ Otherwise async_socket_receive_pooled_async shall create a context for the receive without any buffer where on_receive_complete and on_receive_complete_context shall be stored. ]
+            ASYNC_SOCKET_IO_CONTEXT* io_context = create_message_context(async_socket, ASYNC_SOCKET_IO_TYPE_RECEIVE, NULL, 0, 0);
+            if (io_context == NULL)
+            {
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_115: [ If any error occurs, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+                result = MU_FAILURE;
+            }
+            else
+            {
+                bool has_continuous_receive;
+
+                io_context->is_pooled = true;
+                io_context->on_receive_pooled_complete = on_receive_complete;
+                io_context->callback_context = on_receive_complete_context;
+
+                srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                // a receive queued behind the continuous receive would only complete once it ended
+                has_continuous_receive = (async_socket->continuous_receive_io_context != NULL);
+                if (!has_continuous_receive)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_112: [ Then the context shall be added at the tail of the receive queue. ]
+                    io_queue_push_back(&async_socket->receive_queue, io_context);
+                }
+                srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                if (has_continuous_receive)
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_145: [ If the socket has a continuous receive, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+                    LogError("A continuous receive is started, ASYNC_SOCKET_HANDLE async_socket=%p", async_socket);
+                    free(io_context);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_113: [ async_socket_receive_pooled_async shall then complete the operations in the receive queue if the socket is readable. ]
+                    complete_queued_io(async_socket, &async_socket->receive_queue);
+
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_114: [ On success, async_socket_receive_pooled_async shall return 0. ]
+                    result = 0;
+                }
+            }
+        }
+
+        if (interlocked_decrement(&async_socket->pending_api_calls) == 0)
+        {
+            wake_by_address_single(&async_socket->pending_api_calls);
+        }
+    }
+    return result;
+}
+
 int async_socket_notify_io_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE io_type, ON_ASYNC_SOCKET_NOTIFY_IO_COMPLETE on_notify_io_complete, void* on_notify_io_complete_context)
 {
     int result;
@@ -881,42 +3243,78 @@ int async_socket_notify_io_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_
         }
         else
         {
-            // Codes_SRS_ASYNC_SOCKET_LINUX_04_017: [ Otherwise async_socket_notify_io_async shall create a context for the notify where the on_notify_io_complete and on_notify_io_complete_context shall be stored. ]
-            ASYNC_SOCKET_IO_CONTEXT* io_context = malloc(sizeof(ASYNC_SOCKET_IO_CONTEXT));
+            // Codes_SRS_ASYNC_SOCKET_LINUX_04_017: [ Otherwise async_socket_notify_io_async shall create a context for the notify without any buffer where the on_notify_io_complete and on_notify_io_complete_context shall be stored. ]
+            ASYNC_SOCKET_IO_CONTEXT* io_context = create_message_context(async_socket, ASYNC_SOCKET_IO_TYPE_NOTIFY, NULL, 0, 0);
             if (io_context == NULL)
             {
                 // Codes_SRS_ASYNC_SOCKET_LINUX_04_020: [ If any error occurs, async_socket_notify_io_async shall fail and return a non-zero value. ]
-                LogError("failure in malloc(sizeof(ASYNC_SOCKET_IO_CONTEXT)=%zu) failed", sizeof(ASYNC_SOCKET_IO_CONTEXT));
                 result = MU_FAILURE;
             }
             else
             {
-                io_context->io_type = ASYNC_SOCKET_IO_TYPE_NOTIFY;
                 io_context->on_notify_io_complete = on_notify_io_complete;
                 io_context->callback_context = on_notify_io_complete_context;
-                io_context->async_socket = async_socket;
 
-                int epoll_op = (io_type == ASYNC_SOCKET_NOTIFY_IO_TYPE_IN) ? EPOLLIN : EPOLLOUT;
-
-                // Codes_SRS_ASYNC_SOCKET_LINUX_04_018: [ Then the context shall then be added to the completion port system by calling completion_port_add with EPOLLIN if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and EPOLLOUT otherwise and event_complete_callback as the callback. ]
-                if (completion_port_add(async_socket->completion_port, epoll_op, async_socket->socket_handle, event_complete_callback, io_context) != 0)
+                // Codes_SRS_ASYNC_SOCKET_LINUX_12_167: [ If the socket receives with a buffer ring, async_socket_notify_io_async shall add a notification for ASYNC_SOCKET_NOTIFY_IO_TYPE_IN to the receive queue and complete the receive queue the same way as when the socket does not use io_uring, since the kernel takes the data out of the socket as it arrives. ]
+                if (async_socket->is_io_uring && !(io_type == ASYNC_SOCKET_NOTIFY_IO_TYPE_IN && async_socket->receive_buffer_ring != NULL))
                 {
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_04_020: [ If any error occurs, async_socket_notify_io_async shall fail and return a non-zero value. ]
-                    LogWarning("failure with completion_port_add");
-                    result = MU_FAILURE;
+                    // Codes_SRS_ASYNC_SOCKET_LINUX_12_030: [ Otherwise, if the socket submits its operations to the io_uring of the completion port, async_socket_notify_io_async shall submit a poll for POLLIN if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and for POLLOUT otherwise by calling completion_port_submit_io and add the context to the notification queue. ]
+                    io_context->completion_port_io.io_type = COMPLETION_PORT_IO_TYPE_POLL;
+                    io_context->completion_port_io.message = NULL;
+                    io_context->completion_port_io.poll_events = (io_type == ASYNC_SOCKET_NOTIFY_IO_TYPE_IN) ? POLLIN : POLLOUT;
+                    io_context->completion_port_io.on_io_complete = on_io_uring_notify_complete;
+                    io_context->completion_port_io.on_io_complete_context = io_context;
+
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                    {
+                        if (submit_io_context(async_socket, io_context) != 0)
+                        {
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_04_020: [ If any error occurs, async_socket_notify_io_async shall fail and return a non-zero value. ]
+                            free(io_context);
+                            result = MU_FAILURE;
+                        }
+                        else
+                        {
+                            io_queue_push_back(&async_socket->notify_queue, io_context);
+                            // Codes_SRS_ASYNC_SOCKET_LINUX_04_019: [ On success, async_socket_notify_io_async shall return 0. ]
+                            result = 0;
+                        }
+                    }
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
                 }
                 else
                 {
-                    // Codes_SRS_ASYNC_SOCKET_LINUX_04_019: [ On success, async_socket_notify_io_async shall return 0. ]
-                    result = 0;
-                    (void)interlocked_increment(&async_socket->added_to_completion_port);
-                    goto all_ok;
-                }
+                    ASYNC_SOCKET_IO_QUEUE* io_queue = (io_type == ASYNC_SOCKET_NOTIFY_IO_TYPE_IN) ? &async_socket->receive_queue : &async_socket->send_queue;
+                    bool has_continuous_receive;
 
-                free(io_context);
+                    srw_lock_ll_acquire_exclusive(&async_socket->lock);
+                    // a notification queued behind the continuous receive would only complete once it ended
+                    has_continuous_receive = (io_type == ASYNC_SOCKET_NOTIFY_IO_TYPE_IN) && (async_socket->continuous_receive_io_context != NULL);
+                    if (!has_continuous_receive)
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_04_018: [ Then the context shall be added at the tail of the receive queue if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and at the tail of the send queue otherwise. ]
+                        io_queue_push_back(io_queue, io_context);
+                    }
+                    srw_lock_ll_release_exclusive(&async_socket->lock);
+
+                    if (has_continuous_receive)
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_146: [ If io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and the socket has a continuous receive, async_socket_notify_io_async shall fail and return a non-zero value. ]
+                        LogError("A continuous receive is started, ASYNC_SOCKET_HANDLE async_socket=%p", async_socket);
+                        free(io_context);
+                        result = MU_FAILURE;
+                    }
+                    else
+                    {
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_12_010: [ async_socket_notify_io_async shall then complete the operations in that queue if the socket is ready. ]
+                        complete_queued_io(async_socket, io_queue);
+
+                        // Codes_SRS_ASYNC_SOCKET_LINUX_04_019: [ On success, async_socket_notify_io_async shall return 0. ]
+                        result = 0;
+                    }
+                }
             }
         }
-all_ok:
         if (interlocked_decrement(&async_socket->pending_api_calls) == 0)
         {
             wake_by_address_single(&async_socket->pending_api_calls);
@@ -3,10 +3,15 @@
 #include <stdbool.h>                      // for true
 #include <stdlib.h>                       // for free, malloc
 #include <inttypes.h>
+#include <string.h>
 #include <unistd.h>
 #include <errno.h>
 
 #include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <linux/io_uring.h>
 
 #ifdef USE_VALGRIND
 #include "valgrind/helgrind.h"
@@ -32,22 +37,79 @@
 #define MAX_EVENTS_NUM      64
 #define EVENTS_TIMEOUT_MS   2*1000
 
+#define IO_URING_SQ_ENTRIES         256
+#define IO_URING_CQ_ENTRIES         4096
+// single mapping for both rings (5.4), no completion is dropped when the completion queue is full (5.5), sends and receives wait for readiness internally (5.7)
+#define IO_URING_REQUIRED_FEATURES  (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL)
+// the kernel limits the entries of a provided-buffer ring to 32768
+#define IO_URING_MAX_RING_BUFFERS   32768
+
 typedef struct EPOLL_THREAD_DATA_TAG
 {
-    S_LIST_ENTRY link;
+    // links the armed objects of the same socket, armed is false when the object is not armed
+    struct EPOLL_THREAD_DATA_TAG* previous_armed;
+    struct EPOLL_THREAD_DATA_TAG* next_armed;
+    bool armed;
+    // links the object in the free or abandoned list of its epoll thread
+    S_LIST_ENTRY free_link;
     ON_COMPLETION_PORT_EVENT_COMPLETE event_callback;
     void* event_callback_ctx;
     volatile_atomic int32_t event_callback_called;
     SOCKET_HANDLE socket;
+    // a persistent (EPOLLET) object is signaled for every event until completion_port_remove is called
+    bool persistent;
 } EPOLL_THREAD_DATA;
 
-typedef struct COMPLETION_PORT_TAG
+typedef struct IO_URING_RING_TAG
+{
+    int ring_fd;
+    void* rings;
+    size_t rings_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    uint32_t sq_entries;
+    uint32_t sq_mask;
+    uint32_t* sq_head;
+    uint32_t* sq_tail;
+    uint32_t* sq_flags;
+    uint32_t* sq_array;
+    uint32_t cq_mask;
+    uint32_t* cq_head;
+    uint32_t* cq_tail;
+    struct io_uring_cqe* cqes;
+    // serializes the threads that submit operations, the completions are only consumed by the epoll thread
+    volatile_atomic int32_t submit_access;
+    // the callbacks of the completions queued entries that the epoll thread has to submit, only used by the epoll thread
+    bool has_queued_entries;
+    // the last buffer group id handed out to a provided-buffer ring of the io_uring
+    volatile_atomic int32_t last_buffer_group;
+} IO_URING_RING;
+
+typedef struct EPOLL_THREAD_TAG
 {
+    struct COMPLETION_PORT_TAG* completion_port;
     int epoll;
     THREAD_HANDLE thread_handle;
+    volatile_atomic int32_t data_access;
+    // the first object registered with epoll for each socket of the thread, at the index socket / thread_count (the sockets of a thread are thread_count apart),
+    // so that completion_port_remove finds the objects of a socket without looking at the objects of the other sockets
+    EPOLL_THREAD_DATA** armed_data;
+    uint32_t armed_data_count;
+    // objects that can be reused by completion_port_add
+    S_LIST_ENTRY free_data;
+    // objects removed by completion_port_remove that the epoll thread might still see in the events of its current epoll_wait
+    S_LIST_ENTRY abandoned_data;
+    // the io_uring whose completions are handled by the epoll thread (COMPLETION_PORT_ENGINE_IO_URING only)
+    IO_URING_RING ring;
+} EPOLL_THREAD;
+
+typedef struct COMPLETION_PORT_TAG
+{
+    // each epoll thread waits on its own epoll instance, a socket is always added to the epoll instance of the same thread
+    uint32_t thread_count;
+    EPOLL_THREAD* epoll_threads;
+    COMPLETION_PORT_ENGINE engine;
     volatile_atomic int32_t worker_thread_continue;
-    S_LIST_ENTRY alloc_data_list;
-    volatile_atomic int32_t recv_data_access;
     volatile_atomic int32_t pending_calls;
 } COMPLETION_PORT;
 
@@ -60,14 +122,32 @@ MU_DEFINE_ENUM(COMPLETION_PORT_CALLBACK_STATE, COMPLETION_PORT_CALLBACK_STATE_VA
 MU_DEFINE_ENUM_STRINGS(COMPLETION_PORT_CALLBACK_STATE, COMPLETION_PORT_CALLBACK_STATE_VALUES)
 
 MU_DEFINE_ENUM_STRINGS(COMPLETION_PORT_EPOLL_ACTION, COMPLETION_PORT_EPOLL_ACTION_VALUES)
+MU_DEFINE_ENUM_STRINGS(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_VALUES)
+MU_DEFINE_ENUM_STRINGS(COMPLETION_PORT_IO_TYPE, COMPLETION_PORT_IO_TYPE_VALUES)
+
+// A provided-buffer ring (5.19) registered with the io_uring of the epoll thread of a socket, the kernel picks the buffers of the receives of the socket from it
+typedef struct COMPLETION_PORT_BUFFER_RING_TAG
+{
+    IO_URING_RING* ring;
+    // the entries shared with the kernel, the tail of the ring overlays the reserved field of the first entry
+    struct io_uring_buf_ring* buffers;
+    size_t buffers_size;
+    uint32_t buffer_mask;
+    uint16_t buffer_group;
+    // the tail published to the kernel, only changed by completion_port_buffer_ring_add
+    uint16_t tail;
+} COMPLETION_PORT_BUFFER_RING;
 
 DEFINE_REFCOUNT_TYPE(COMPLETION_PORT);
 
-static void enter_crit_section(COMPLETION_PORT* completion_port)
+// The io_uring whose completions are consumed by the current thread (NULL for any other thread)
+static _Thread_local IO_URING_RING* current_completing_ring = NULL;
+
+static void enter_crit_section(volatile_atomic int32_t* access)
 {
     do
     {
-        int32_t current_val = interlocked_compare_exchange(&completion_port->recv_data_access, 1, 0);
+        int32_t current_val = interlocked_compare_exchange(access, 1, 0);
         if (current_val == 0)
         {
             break;
@@ -76,73 +156,409 @@ static void enter_crit_section(COMPLETION_PORT* completion_port)
         {
             // Do Nothing wait for address
         }
-        (void)wait_on_address(&completion_port->recv_data_access, current_val, UINT32_MAX);
+        (void)wait_on_address(access, current_val, UINT32_MAX);
     } while (true);
 }
 
-static void leave_crit_section(COMPLETION_PORT* completion_port)
+static void leave_crit_section(volatile_atomic int32_t* access)
+{
+    (void)interlocked_exchange(access, 0);
+    wake_by_address_single(access);
+}
+
+// the functions below must be called from within the critical section of epoll_thread
+
+static uint32_t get_armed_data_index(EPOLL_THREAD* epoll_thread, SOCKET_HANDLE socket)
 {
-    (void)interlocked_exchange(&completion_port->recv_data_access, 0);
-    wake_by_address_single(&completion_port->recv_data_access);
+    return (uint32_t)socket / epoll_thread->completion_port->thread_count;
 }
 
-static int add_thread_data_to_list(COMPLETION_PORT* completion_port, EPOLL_THREAD_DATA* epoll_data)
+static int reserve_armed_data(EPOLL_THREAD* epoll_thread, uint32_t index)
 {
     int result;
-    enter_crit_section(completion_port);
+    if (index < epoll_thread->armed_data_count)
     {
-        if (s_list_add(&completion_port->alloc_data_list, &epoll_data->link) != 0)
+        result = 0;
+    }
+    else
+    {
+        // the kernel allocates the lowest free socket handle, so the table only grows up to the peak number of open sockets
+        uint32_t new_count = (epoll_thread->armed_data_count * 2 > index) ? epoll_thread->armed_data_count * 2 : index + 1;
+        EPOLL_THREAD_DATA** new_armed_data = realloc_2(epoll_thread->armed_data, new_count, sizeof(EPOLL_THREAD_DATA*));
+        if (new_armed_data == NULL)
         {
-            LogError("failure adding receive data to list");
+            LogError("failure realloc_2(epoll_thread->armed_data=%p, new_count=%" PRIu32 ", sizeof(EPOLL_THREAD_DATA*)=%zu)", epoll_thread->armed_data, new_count, sizeof(EPOLL_THREAD_DATA*));
             result = MU_FAILURE;
         }
         else
         {
+            (void)memset(&new_armed_data[epoll_thread->armed_data_count], 0, (new_count - epoll_thread->armed_data_count) * sizeof(EPOLL_THREAD_DATA*));
+            epoll_thread->armed_data = new_armed_data;
+            epoll_thread->armed_data_count = new_count;
             result = 0;
         }
     }
-    leave_crit_section(completion_port);
     return result;
 }
 
-static int remove_thread_data_from_list(COMPLETION_PORT* completion_port, EPOLL_THREAD_DATA* epoll_data)
+static void link_armed_data(EPOLL_THREAD* epoll_thread, EPOLL_THREAD_DATA* epoll_data)
+{
+    uint32_t index = get_armed_data_index(epoll_thread, epoll_data->socket);
+    epoll_data->previous_armed = NULL;
+    epoll_data->next_armed = epoll_thread->armed_data[index];
+    if (epoll_data->next_armed != NULL)
+    {
+        epoll_data->next_armed->previous_armed = epoll_data;
+    }
+    epoll_thread->armed_data[index] = epoll_data;
+    epoll_data->armed = true;
+}
+
+static void unlink_armed_data(EPOLL_THREAD* epoll_thread, EPOLL_THREAD_DATA* epoll_data)
+{
+    if (epoll_data->previous_armed == NULL)
+    {
+        epoll_thread->armed_data[get_armed_data_index(epoll_thread, epoll_data->socket)] = epoll_data->next_armed;
+    }
+    else
+    {
+        epoll_data->previous_armed->next_armed = epoll_data->next_armed;
+    }
+    if (epoll_data->next_armed != NULL)
+    {
+        epoll_data->next_armed->previous_armed = epoll_data->previous_armed;
+    }
+    epoll_data->previous_armed = NULL;
+    epoll_data->next_armed = NULL;
+    epoll_data->armed = false;
+}
+
+static void release_thread_data(EPOLL_THREAD* epoll_thread, EPOLL_THREAD_DATA* epoll_data)
+{
+    // an object that was abandoned by completion_port_remove is released once the epoll thread is done with its events
+    if (epoll_data->armed)
+    {
+        unlink_armed_data(epoll_thread, epoll_data);
+        (void)s_list_add(&epoll_thread->free_data, &epoll_data->free_link);
+    }
+}
+
+static void release_abandoned_data(EPOLL_THREAD* epoll_thread)
+{
+    PS_LIST_ENTRY entry;
+    while ((entry = s_list_remove_head(&epoll_thread->abandoned_data)) != &epoll_thread->abandoned_data)
+    {
+        (void)s_list_add(&epoll_thread->free_data, entry);
+    }
+}
+
+static void free_thread_data(EPOLL_THREAD* epoll_thread)
+{
+    for (uint32_t i = 0; i < epoll_thread->armed_data_count; i++)
+    {
+        while (epoll_thread->armed_data[i] != NULL)
+        {
+            EPOLL_THREAD_DATA* epoll_data = epoll_thread->armed_data[i];
+            unlink_armed_data(epoll_thread, epoll_data);
+            free(epoll_data);
+        }
+    }
+
+    release_abandoned_data(epoll_thread);
+
+    PS_LIST_ENTRY entry;
+    while ((entry = s_list_remove_head(&epoll_thread->free_data)) != &epoll_thread->free_data)
+    {
+        EPOLL_THREAD_DATA* epoll_data = CONTAINING_RECORD(entry, EPOLL_THREAD_DATA, free_link);
+        free(epoll_data);
+    }
+
+    free(epoll_thread->armed_data);
+}
+
+static int io_uring_setup(uint32_t entries, struct io_uring_params* params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int io_uring_enter(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+{
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int io_uring_register(int ring_fd, uint32_t opcode, void* arg, uint32_t arg_count)
+{
+    return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg, arg_count);
+}
+
+static int io_uring_ring_init(IO_URING_RING* ring)
 {
     int result;
-    enter_crit_section(completion_port);
+    struct io_uring_params params;
+
+    (void)memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = IO_URING_CQ_ENTRIES;
+
+    ring->ring_fd = io_uring_setup(IO_URING_SQ_ENTRIES, &params);
+    if (ring->ring_fd < 0)
+    {
+        LogErrorNo("failure io_uring_setup(entries=%d)", IO_URING_SQ_ENTRIES);
+        result = MU_FAILURE;
+    }
+    else
     {
-        if (s_list_remove(&completion_port->alloc_data_list, &epoll_data->link) != 0)
+        if ((params.features & IO_URING_REQUIRED_FEATURES) != IO_URING_REQUIRED_FEATURES)
         {
-            LogError("failure removing receive data");
-            result = MU_FAILURE;
+            LogError("io_uring features=%" PRIx32 " do not include the required features=%" PRIx32 "", (uint32_t)params.features, (uint32_t)IO_URING_REQUIRED_FEATURES);
         }
         else
         {
+            size_t sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+            size_t cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+            ring->rings_size = (sq_ring_size > cq_ring_size) ? sq_ring_size : cq_ring_size;
+            ring->rings = mmap(NULL, ring->rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING);
+            if (ring->rings == MAP_FAILED)
+            {
+                LogErrorNo("failure mmap(rings_size=%zu) for the io_uring rings", ring->rings_size);
+            }
+            else
+            {
+                ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+                ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQES);
+                if (ring->sqes == MAP_FAILED)
+                {
+                    LogErrorNo("failure mmap(sqes_size=%zu) for the io_uring submission queue entries", ring->sqes_size);
+                }
+                else
+                {
+                    uint8_t* rings = ring->rings;
+                    ring->sq_entries = params.sq_entries;
+                    ring->sq_mask = *(uint32_t*)(rings + params.sq_off.ring_mask);
+                    ring->sq_head = (uint32_t*)(rings + params.sq_off.head);
+                    ring->sq_tail = (uint32_t*)(rings + params.sq_off.tail);
+                    ring->sq_flags = (uint32_t*)(rings + params.sq_off.flags);
+                    ring->sq_array = (uint32_t*)(rings + params.sq_off.array);
+                    ring->cq_mask = *(uint32_t*)(rings + params.cq_off.ring_mask);
+                    ring->cq_head = (uint32_t*)(rings + params.cq_off.head);
+                    ring->cq_tail = (uint32_t*)(rings + params.cq_off.tail);
+                    ring->cqes = (struct io_uring_cqe*)(rings + params.cq_off.cqes);
+                    (void)interlocked_exchange(&ring->submit_access, 0);
+                    ring->has_queued_entries = false;
+                    (void)interlocked_exchange(&ring->last_buffer_group, 0);
+
+                    result = 0;
+                    goto all_ok;
+                }
+                (void)munmap(ring->rings, ring->rings_size);
+            }
+        }
+        (void)close(ring->ring_fd);
+        result = MU_FAILURE;
+    }
+all_ok:
+    return result;
+}
+
+static void io_uring_ring_deinit(IO_URING_RING* ring)
+{
+    (void)munmap(ring->sqes, ring->sqes_size);
+    (void)munmap(ring->rings, ring->rings_size);
+    if (close(ring->ring_fd) != 0)
+    {
+        LogErrorNo("failure closing io_uring %d", ring->ring_fd);
+    }
+}
+
+static int io_uring_ring_enter(IO_URING_RING* ring, uint32_t to_submit)
+{
+    int submitted;
+    do
+    {
+        submitted = io_uring_enter(ring->ring_fd, to_submit, 0, 0);
+    } while (submitted < 0 && errno == EINTR);
+    return submitted;
+}
+
+// must be called from within the submit critical section of the ring
+static int io_uring_ring_submit(IO_URING_RING* ring, const struct io_uring_sqe* sqe)
+{
+    int result;
+    uint32_t tail = *ring->sq_tail;
+    uint32_t queued_count = tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+    if (queued_count >= ring->sq_entries)
+    {
+        // the entries queued by the callbacks of the completions fill the submission queue, submit them to make room
+        (void)io_uring_ring_enter(ring, queued_count);
+        queued_count = tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    }
+
+    if (queued_count >= ring->sq_entries)
+    {
+        LogError("io_uring submission queue is full, sq_entries=%" PRIu32 "", ring->sq_entries);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t index = tail & ring->sq_mask;
+
+        ring->sqes[index] = *sqe;
+        ring->sq_array[index] = index;
+        __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        if (current_completing_ring == ring)
+        {
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_058: [ If it is called by the epoll thread from an on_io_complete callback, completion_port_submit_io shall only queue the entry, which the epoll thread submits with the other entries queued by the callbacks once it consumed the completions. ]
+            ring->has_queued_entries = true;
             result = 0;
         }
+        else
+        {
+            // the entries still queued by the callbacks of the completions are submitted with this one
+            int submitted = io_uring_ring_enter(ring, queued_count + 1);
+            if (submitted != (int)(queued_count + 1))
+            {
+                LogErrorNo("failure io_uring_enter(ring_fd=%d, to_submit=%" PRIu32 "), submitted=%d", ring->ring_fd, queued_count + 1, submitted);
+                // the entry is the last one, so it was not consumed by the kernel, take it back so that it is never submitted
+                __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                result = 0;
+            }
+        }
     }
-    leave_crit_section(completion_port);
 
     return result;
 }
 
+// must be called from within the submit critical section of the ring
+static void io_uring_ring_submit_queued_entries(IO_URING_RING* ring)
+{
+    uint32_t queued_count = *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (queued_count > 0)
+    {
+        int submitted = io_uring_ring_enter(ring, queued_count);
+        if (submitted != (int)queued_count)
+        {
+            // the callbacks were told that their entries are submitted, the entries left are submitted by the next io_uring_enter of the ring
+            LogErrorNo("failure io_uring_enter(ring_fd=%d, to_submit=%" PRIu32 "), submitted=%d", ring->ring_fd, queued_count, submitted);
+        }
+    }
+    ring->has_queued_entries = false;
+}
+
+static void complete_ring_io(IO_URING_RING* ring)
+{
+    current_completing_ring = ring;
+    do
+    {
+        uint32_t head = *ring->cq_head;
+        if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+        {
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_031: [ If the completion queue is empty and the kernel kept completions that did not fit in it, epoll_worker_func shall call io_uring_enter with IORING_ENTER_GETEVENTS to move them to the completion queue. ]
+            if (
+                ((__atomic_load_n(ring->sq_flags, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW) == 0) ||
+                (io_uring_enter(ring->ring_fd, 0, 0, IORING_ENTER_GETEVENTS) < 0)
+                )
+            {
+                break;
+            }
+        }
+        else
+        {
+            struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+            COMPLETION_PORT_IO* io = (COMPLETION_PORT_IO*)(uintptr_t)cqe->user_data;
+            int32_t io_result = cqe->res;
+            uint32_t io_flags = cqe->flags;
+
+            __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+
+            // the completions of cancel requests carry no COMPLETION_PORT_IO
+            if (io != NULL)
+            {
+                if (io->io_type == COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING)
+                {
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_060: [ If the io_type of the COMPLETION_PORT_IO is COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, epoll_worker_func shall first set its has_buffer and buffer_id from the IORING_CQE_F_BUFFER flag and the buffer id of the completion, and its has_more from the IORING_CQE_F_MORE flag. ]
+                    io->has_buffer = ((io_flags & IORING_CQE_F_BUFFER) != 0);
+                    io->buffer_id = (uint16_t)(io_flags >> IORING_CQE_BUFFER_SHIFT);
+                    io->has_more = ((io_flags & IORING_CQE_F_MORE) != 0);
+                }
+
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_030: [ For each completion, epoll_worker_func shall call the on_io_complete callback of the COMPLETION_PORT_IO with on_io_complete_context and the result of the operation. ]
+                io->on_io_complete(io->on_io_complete_context, io_result);
+            }
+        }
+    } while (true);
+    current_completing_ring = NULL;
+
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_059: [ After consuming the completions, epoll_worker_func shall submit the entries queued by the on_io_complete callbacks with a single call to io_uring_enter. ]
+    if (ring->has_queued_entries)
+    {
+        enter_crit_section(&ring->submit_access);
+        {
+            io_uring_ring_submit_queued_entries(ring);
+        }
+        leave_crit_section(&ring->submit_access);
+    }
+}
+
+static EPOLL_THREAD* get_epoll_thread(COMPLETION_PORT* completion_port, SOCKET_HANDLE socket)
+{
+    // all the events of a socket are handled by the same thread, so that the callbacks for a socket are never executed concurrently or out of order
+    return &completion_port->epoll_threads[(uint32_t)socket % completion_port->thread_count];
+}
+
+static void call_persistent_event_callback(EPOLL_THREAD_DATA* epoll_data, uint32_t events)
+{
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_017: [ epoll_worker_func shall not call the event_callback once completion_port_remove called it with COMPLETION_PORT_EPOLL_ABANDONED. ]
+    if (interlocked_compare_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTING, COMPLETION_PORT_CALLBACK_INIT) == COMPLETION_PORT_CALLBACK_INIT)
+    {
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_014: [ epoll_worker_func shall call the event_callback with COMPLETION_PORT_EPOLL_EPOLLRDHUP if the events contain EPOLLRDHUP, otherwise with COMPLETION_PORT_EPOLL_EPOLLIN if the events contain EPOLLIN, EPOLLERR or EPOLLHUP. ]
+        if (events & EPOLLRDHUP)
+        {
+            epoll_data->event_callback(epoll_data->event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP);
+        }
+        else if (events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+        {
+            epoll_data->event_callback(epoll_data->event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+        }
+
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_015: [ epoll_worker_func shall then call the event_callback with COMPLETION_PORT_EPOLL_EPOLLOUT if the events contain EPOLLOUT, EPOLLERR or EPOLLHUP. ]
+        if (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+        {
+            epoll_data->event_callback(epoll_data->event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
+        }
+
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_016: [ epoll_worker_func shall keep the EPOLL_THREAD_DATA object in the armed objects of its socket so that the event_callback is called for the following events. ]
+        (void)interlocked_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_INIT);
+        wake_by_address_single(&epoll_data->event_callback_called);
+    }
+}
+
 static int epoll_worker_func(void* parameter)
 {
-    COMPLETION_PORT_HANDLE completion_port = (COMPLETION_PORT_HANDLE)parameter;
+    EPOLL_THREAD* epoll_thread = (EPOLL_THREAD*)parameter;
     // Codes_SRS_COMPLETION_PORT_LINUX_11_031: [ If parameter is NULL, epoll_worker_func shall do nothing. ]
-    if (completion_port == NULL)
+    if (epoll_thread == NULL)
     {
-        LogCritical("Invalid arguement epoll_worker_function COMPLETION_PORT_HANDLE completion_port=%p", completion_port);
+        LogCritical("Invalid arguement epoll_worker_function EPOLL_THREAD* epoll_thread=%p", epoll_thread);
     }
     else
     {
+        COMPLETION_PORT_HANDLE completion_port = epoll_thread->completion_port;
         int log_only_once = 0;
         // Loop while true
         do
         {
             struct epoll_event events[MAX_EVENTS_NUM];
             // Codes_SRS_COMPLETION_PORT_LINUX_11_032: [ epoll_worker_func shall call epoll_wait to wait for an epoll event to become signaled with a timeout of 2 Seconds. ]
-            int num_ready = epoll_wait(completion_port->epoll, events, MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS);
-            if (num_ready == -1)
+            int num_ready = epoll_wait(epoll_thread->epoll, events, MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS);
+            // the task work that the io_uring runs on the threads that submit to it interrupts epoll_wait with EINTR, which is not a failure
+            if (num_ready == -1 && errno != EINTR)
             {
                 if (log_only_once < 1)
                 {
@@ -154,55 +570,105 @@ static int epoll_worker_func(void* parameter)
             // Codes_SRS_COMPLETION_PORT_LINUX_11_034: [ epoll_worker_func shall loop through the num of descriptors that was returned. ]
             for (int index = 0; index < num_ready; index++)
             {
-                COMPLETION_PORT_EPOLL_ACTION epoll_action;
-                EPOLL_THREAD_DATA* epoll_data = events[index].data.ptr;
-                if (events[index].events & EPOLLRDHUP)
-                {
-                    epoll_action = COMPLETION_PORT_EPOLL_EPOLLRDHUP;
-                }
-                else if (events[index].events & EPOLLIN)
-                {
-                    epoll_action = COMPLETION_PORT_EPOLL_EPOLLIN;
-                }
-                else if (events[index].events & EPOLLOUT)
+                if (events[index].data.ptr == epoll_thread)
                 {
-                    epoll_action = COMPLETION_PORT_EPOLL_EPOLLOUT;
-                }
-                else
-                {
-                    LogWarning("Unexpected epoll event %d", events[index].events);
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_029: [ If the event is for the io_uring of the epoll thread, epoll_worker_func shall consume all the completions in its completion queue. ]
+                    complete_ring_io(&epoll_thread->ring);
                     continue;
                 }
+
+                EPOLL_THREAD_DATA* epoll_data = events[index].data.ptr;
                 #ifdef USE_VALGRIND
                     ANNOTATE_HAPPENS_AFTER(epoll_data);
                 #endif
-                // If we haven't called into event_callback yet
-                if (interlocked_compare_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTING, COMPLETION_PORT_CALLBACK_INIT) == COMPLETION_PORT_CALLBACK_INIT)
+                if (epoll_data->persistent)
                 {
-                    // Codes_SRS_COMPLETION_PORT_LINUX_11_035: [ epoll_worker_func shall call the event_callback with the specified COMPLETION_PORT_EPOLL_ACTION that was returned. ]
-                    epoll_data->event_callback(epoll_data->event_callback_ctx, epoll_action);
-
-                    (void)interlocked_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTED);
-                    wake_by_address_single(&epoll_data->event_callback_called);
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_013: [ If the EPOLL_THREAD_DATA object is persistent, epoll_worker_func shall do the following: ]
+                    call_persistent_event_callback(epoll_data, events[index].events);
                 }
-                // Codes_SRS_COMPLETION_PORT_LINUX_11_036: [ Then epoll_worker_func shall remove the EPOLL_THREAD_DATA from the list and free the object. ]
-                if (remove_thread_data_from_list(completion_port, epoll_data) != 0)
+                else
                 {
-                    LogWarning("failure removing receive data from list %p, action: %" PRI_MU_ENUM "", epoll_data, MU_ENUM_VALUE(COMPLETION_PORT_EPOLL_ACTION, epoll_action));
+                    COMPLETION_PORT_EPOLL_ACTION epoll_action;
+                    if (events[index].events & EPOLLRDHUP)
+                    {
+                        epoll_action = COMPLETION_PORT_EPOLL_EPOLLRDHUP;
+                    }
+                    else if (events[index].events & EPOLLIN)
+                    {
+                        epoll_action = COMPLETION_PORT_EPOLL_EPOLLIN;
+                    }
+                    else if (events[index].events & EPOLLOUT)
+                    {
+                        epoll_action = COMPLETION_PORT_EPOLL_EPOLLOUT;
+                    }
+                    else
+                    {
+                        LogWarning("Unexpected epoll event %d", events[index].events);
+                        continue;
+                    }
+                    // If we haven't called into event_callback yet
+                    if (interlocked_compare_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTING, COMPLETION_PORT_CALLBACK_INIT) == COMPLETION_PORT_CALLBACK_INIT)
+                    {
+                        // Codes_SRS_COMPLETION_PORT_LINUX_11_035: [ epoll_worker_func shall call the event_callback with the specified COMPLETION_PORT_EPOLL_ACTION that was returned. ]
+                        epoll_data->event_callback(epoll_data->event_callback_ctx, epoll_action);
+
+                        (void)interlocked_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTED);
+                        wake_by_address_single(&epoll_data->event_callback_called);
+                    }
+                    // Codes_SRS_COMPLETION_PORT_LINUX_11_036: [ Then epoll_worker_func shall remove the EPOLL_THREAD_DATA from the armed objects of its socket and add it to the list of free objects of the epoll thread. ]
+                    enter_crit_section(&epoll_thread->data_access);
+                    {
+                        release_thread_data(epoll_thread, epoll_data);
+                    }
+                    leave_crit_section(&epoll_thread->data_access);
                 }
-                free(epoll_data);
             }
+
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_010: [ After handling the events, epoll_worker_func shall move the EPOLL_THREAD_DATA objects abandoned by completion_port_remove to the list of free objects of the epoll thread. ]
+            enter_crit_section(&epoll_thread->data_access);
+            {
+                release_abandoned_data(epoll_thread);
+            }
+            leave_crit_section(&epoll_thread->data_access);
             // Codes_SRS_COMPLETION_PORT_LINUX_11_033: [ On a epoll_wait timeout epoll_worker_func shall ensure it should not exit and issue another epoll_wait. ]
         } while (interlocked_add(&completion_port->worker_thread_continue, 0) == 0);
     }
     return 0;
 }
 
-COMPLETION_PORT_HANDLE completion_port_create(void)
+static void stop_epoll_threads(COMPLETION_PORT* completion_port, uint32_t thread_count)
+{
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        if (close(completion_port->epoll_threads[i].epoll) != 0)
+        {
+            LogErrorNo("failure closing epoll %" PRIu32 "", i);
+        }
+    }
+
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        int dont_care;
+        if (ThreadAPI_Join(completion_port->epoll_threads[i].thread_handle, &dont_care) != THREADAPI_OK)
+        {
+            LogError("Failure joining thread %" PRIu32 "", i);
+        }
+    }
+
+    if (completion_port->engine == COMPLETION_PORT_ENGINE_IO_URING)
+    {
+        for (uint32_t i = 0; i < thread_count; i++)
+        {
+            io_uring_ring_deinit(&completion_port->epoll_threads[i].ring);
+        }
+    }
+}
+
+static COMPLETION_PORT_HANDLE completion_port_create_internal(uint32_t thread_count, COMPLETION_PORT_ENGINE engine)
 {
     COMPLETION_PORT_HANDLE result;
 
-    // Codes_SRS_COMPLETION_PORT_LINUX_11_001: [ completion_port_create shall allocate memory for a completion port object. ]
+    // Codes_SRS_COMPLETION_PORT_LINUX_11_001: [ completion_port_create_with_thread_count shall allocate memory for a completion port object. ]
     result = REFCOUNT_TYPE_CREATE(COMPLETION_PORT);
     if (result == NULL)
     {
@@ -211,37 +677,104 @@ COMPLETION_PORT_HANDLE completion_port_create(void)
     else
     {
         (void)interlocked_exchange(&result->worker_thread_continue, 0);
-        (void)interlocked_exchange(&result->recv_data_access, 0);
         (void)interlocked_exchange(&result->pending_calls, 0);
 
-        if (s_list_initialize(&result->alloc_data_list) != 0)
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_003: [ completion_port_create_with_thread_count shall allocate memory for thread_count epoll threads. ]
+        result->epoll_threads = malloc_2(thread_count, sizeof(EPOLL_THREAD));
+        if (result->epoll_threads == NULL)
         {
-            LogError("failure initializing recv list");
+            LogError("failure malloc_2(thread_count=%" PRIu32 ", sizeof(EPOLL_THREAD)=%zu)", thread_count, sizeof(EPOLL_THREAD));
         }
         else
         {
-            // Codes_SRS_COMPLETION_PORT_LINUX_11_002: [ completion_port_create shall create the epoll instance by calling epoll_create. ]
-            result->epoll = epoll_create(MAX_EVENTS_NUM);
-            if (result->epoll == -1)
-            {
-                LogErrorNo("failure epoll_create MAX_EVENTS_NUM: %d", MAX_EVENTS_NUM);
-            }
-            else
+            uint32_t i;
+            result->thread_count = thread_count;
+            result->engine = engine;
+
+            for (i = 0; i < thread_count; i++)
             {
-                // Codes_SRS_COMPLETION_PORT_LINUX_11_003: [ completion_port_create shall create a thread that runs epoll_worker_func to handle the epoll events. ]
-                if (ThreadAPI_Create(&result->thread_handle, epoll_worker_func, result) != THREADAPI_OK)
+                EPOLL_THREAD* epoll_thread = &result->epoll_threads[i];
+                epoll_thread->completion_port = result;
+                (void)interlocked_exchange(&epoll_thread->data_access, 0);
+                epoll_thread->armed_data = NULL;
+                epoll_thread->armed_data_count = 0;
+                if (
+                    (s_list_initialize(&epoll_thread->free_data) != 0) ||
+                    (s_list_initialize(&epoll_thread->abandoned_data) != 0)
+                    )
                 {
-                    LogCritical("Failure creating thread");
+                    LogError("failure initializing the lists of epoll thread %" PRIu32 "", i);
+                    break;
                 }
-                else
+
+                // Codes_SRS_COMPLETION_PORT_LINUX_11_002: [ completion_port_create_with_thread_count shall create an epoll instance for each epoll thread by calling epoll_create. ]
+                epoll_thread->epoll = epoll_create(MAX_EVENTS_NUM);
+                if (epoll_thread->epoll == -1)
                 {
-                    // Codes_SRS_COMPLETION_PORT_LINUX_11_004: [ On success completion_port_create shall return the allocated COMPLETION_PORT_HANDLE. ]
-                    goto all_ok;
+                    LogErrorNo("failure epoll_create MAX_EVENTS_NUM: %d", MAX_EVENTS_NUM);
+                    break;
                 }
+
+                if (result->engine == COMPLETION_PORT_ENGINE_IO_URING)
+                {
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_022: [ If engine is COMPLETION_PORT_ENGINE_IO_URING, completion_port_create_with_engine shall set up an io_uring for each epoll thread by calling io_uring_setup and mapping its rings with mmap. ]
+                    if (io_uring_ring_init(&epoll_thread->ring) != 0)
+                    {
+                        if (i == 0)
+                        {
+                            // Codes_SRS_COMPLETION_PORT_LINUX_12_023: [ If the io_uring of the first epoll thread cannot be set up or the kernel does not support IORING_FEAT_SINGLE_MMAP, IORING_FEAT_NODROP and IORING_FEAT_FAST_POLL, completion_port_create_with_engine shall fall back to COMPLETION_PORT_ENGINE_EPOLL. ]
+                            LogWarning("io_uring is not available, falling back to %" PRI_MU_ENUM "", MU_ENUM_VALUE(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_EPOLL));
+                            result->engine = COMPLETION_PORT_ENGINE_EPOLL;
+                        }
+                        else
+                        {
+                            LogError("failure setting up the io_uring of epoll thread %" PRIu32 "", i);
+                            (void)close(epoll_thread->epoll);
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        struct epoll_event ev = { 0 };
+                        ev.events = EPOLLIN;
+                        ev.data.ptr = epoll_thread;
+                        // Codes_SRS_COMPLETION_PORT_LINUX_12_024: [ completion_port_create_with_engine shall add each io_uring to the epoll instance of its epoll thread by calling epoll_ctl with EPOLL_CTL_ADD and EPOLLIN, so that the epoll thread handles the completions. ]
+                        if (epoll_ctl(epoll_thread->epoll, EPOLL_CTL_ADD, epoll_thread->ring.ring_fd, &ev) < 0)
+                        {
+                            LogErrorNo("failure with epoll_ctl EPOLL_CTL_ADD for the io_uring of epoll thread %" PRIu32 "", i);
+                            io_uring_ring_deinit(&epoll_thread->ring);
+                            (void)close(epoll_thread->epoll);
+                            break;
+                        }
+                    }
+                }
+
+                // Codes_SRS_COMPLETION_PORT_LINUX_11_003: [ For each epoll thread, completion_port_create_with_thread_count shall create a thread named cp_epoll that runs epoll_worker_func to handle the events of the epoll instance by calling ThreadAPI_CreateEx. ]
+                THREADAPI_CREATE_OPTIONS thread_options = { 0 };
+                thread_options.name = "cp_epoll";
+                if (ThreadAPI_CreateEx(&epoll_thread->thread_handle, epoll_worker_func, epoll_thread, &thread_options) != THREADAPI_OK)
+                {
+                    LogCritical("Failure creating thread %" PRIu32 "", i);
+                    if (result->engine == COMPLETION_PORT_ENGINE_IO_URING)
+                    {
+                        io_uring_ring_deinit(&epoll_thread->ring);
+                    }
+                    (void)close(epoll_thread->epoll);
+                    break;
+                }
+            }
+
+            if (i == thread_count)
+            {
+                // Codes_SRS_COMPLETION_PORT_LINUX_11_004: [ On success completion_port_create_with_thread_count shall return the allocated COMPLETION_PORT_HANDLE. ]
+                goto all_ok;
             }
-            (void)close(result->epoll);
+
+            (void)interlocked_increment(&result->worker_thread_continue);
+            stop_epoll_threads(result, i);
+            free(result->epoll_threads);
         }
-        // Codes_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create shall fail and return NULL. ]
+        // Codes_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create_with_thread_count shall fail and return NULL. ]
         REFCOUNT_TYPE_DESTROY(COMPLETION_PORT, result);
         result = NULL;
     }
@@ -249,6 +782,73 @@ all_ok:
     return result;
 }
 
+COMPLETION_PORT_HANDLE completion_port_create(void)
+{
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_001: [ completion_port_create shall create a completion port the same way completion_port_create_with_thread_count does, with a single epoll thread. ]
+    return completion_port_create_internal(1, COMPLETION_PORT_ENGINE_EPOLL);
+}
+
+COMPLETION_PORT_HANDLE completion_port_create_with_thread_count(uint32_t thread_count)
+{
+    COMPLETION_PORT_HANDLE result;
+
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_002: [ If thread_count is 0, completion_port_create_with_thread_count shall fail and return NULL. ]
+    if (thread_count == 0)
+    {
+        LogError("Invalid arguments: uint32_t thread_count=%" PRIu32 "", thread_count);
+        result = NULL;
+    }
+    else
+    {
+        result = completion_port_create_internal(thread_count, COMPLETION_PORT_ENGINE_EPOLL);
+    }
+
+    return result;
+}
+
+COMPLETION_PORT_HANDLE completion_port_create_with_engine(uint32_t thread_count, COMPLETION_PORT_ENGINE engine)
+{
+    COMPLETION_PORT_HANDLE result;
+
+    if (
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_019: [ If thread_count is 0, completion_port_create_with_engine shall fail and return NULL. ]
+        thread_count == 0 ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_020: [ If engine is not COMPLETION_PORT_ENGINE_EPOLL or COMPLETION_PORT_ENGINE_IO_URING, completion_port_create_with_engine shall fail and return NULL. ]
+        (engine != COMPLETION_PORT_ENGINE_EPOLL && engine != COMPLETION_PORT_ENGINE_IO_URING)
+        )
+    {
+        LogError("Invalid arguments: uint32_t thread_count=%" PRIu32 ", COMPLETION_PORT_ENGINE engine=%" PRI_MU_ENUM "",
+            thread_count, MU_ENUM_VALUE(COMPLETION_PORT_ENGINE, engine));
+        result = NULL;
+    }
+    else
+    {
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_021: [ completion_port_create_with_engine shall create a completion port with thread_count epoll threads the same way completion_port_create_with_thread_count does. ]
+        result = completion_port_create_internal(thread_count, engine);
+    }
+
+    return result;
+}
+
+COMPLETION_PORT_ENGINE completion_port_get_engine(COMPLETION_PORT_HANDLE completion_port)
+{
+    COMPLETION_PORT_ENGINE result;
+
+    if (completion_port == NULL)
+    {
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_025: [ If completion_port is NULL, completion_port_get_engine shall return COMPLETION_PORT_ENGINE_EPOLL. ]
+        LogError("Invalid arguments: COMPLETION_PORT_HANDLE completion_port=%p", completion_port);
+        result = COMPLETION_PORT_ENGINE_EPOLL;
+    }
+    else
+    {
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_026: [ Otherwise, completion_port_get_engine shall return the engine used by completion_port. ]
+        result = completion_port->engine;
+    }
+
+    return result;
+}
+
 void completion_port_inc_ref(COMPLETION_PORT_HANDLE completion_port)
 {
     // Codes_SRS_COMPLETION_PORT_LINUX_11_006: [ If completion_port is NULL, completion_port_inc_ref shall return. ]
@@ -286,26 +886,17 @@ void completion_port_dec_ref(COMPLETION_PORT_HANDLE completion_port)
                 (void)wait_on_address(&completion_port->pending_calls, value, UINT32_MAX);
             }
 
-            // Codes_SRS_COMPLETION_PORT_LINUX_11_013: [ close the epoll object. ]
-            if (close(completion_port->epoll) != 0)
-            {
-                LogErrorNo("failure closing epoll");
-            }
-
-            int dont_care;
-            // Codes_SRS_COMPLETION_PORT_LINUX_11_014: [ close the thread by calling ThreadAPI_Join. ]
-            if (ThreadAPI_Join(completion_port->thread_handle, &dont_care) != THREADAPI_OK)
-            {
-                LogError("Failure joining thread");
-            }
+            // Codes_SRS_COMPLETION_PORT_LINUX_11_013: [ close the epoll objects. ]
+            // Codes_SRS_COMPLETION_PORT_LINUX_11_014: [ close the threads by calling ThreadAPI_Join. ]
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_027: [ unmap the rings and close the io_uring of each epoll thread if the engine is COMPLETION_PORT_ENGINE_IO_URING. ]
+            stop_epoll_threads(completion_port, completion_port->thread_count);
 
-            // Codes_SRS_COMPLETION_PORT_LINUX_11_015: [ then the memory associated with completion_port shall be freed. ]
-            PS_LIST_ENTRY entry;
-            while ((entry = s_list_remove_head(&completion_port->alloc_data_list)) != &completion_port->alloc_data_list)
+            // Codes_SRS_COMPLETION_PORT_LINUX_11_015: [ then the memory associated with completion_port, including all the EPOLL_THREAD_DATA objects, shall be freed. ]
+            for (uint32_t i = 0; i < completion_port->thread_count; i++)
             {
-                EPOLL_THREAD_DATA* epoll_data = CONTAINING_RECORD(entry, EPOLL_THREAD_DATA, link);
-                free(epoll_data);
+                free_thread_data(&completion_port->epoll_threads[i]);
             }
+            free(completion_port->epoll_threads);
 
             REFCOUNT_TYPE_DESTROY(COMPLETION_PORT, completion_port);
         }
@@ -345,49 +936,90 @@ int completion_port_add(COMPLETION_PORT_HANDLE completion_port, int epoll_op, SO
             // Codes_SRS_COMPLETION_PORT_LINUX_11_020: [ completion_port_add shall increment the ongoing call count value to prevent close. ]
             (void)interlocked_increment(&completion_port->pending_calls);
 
-            // Codes_SRS_COMPLETION_PORT_LINUX_11_021: [ completion_port_add shall allocate a EPOLL_THREAD_DATA object to store thread data. ]
-            EPOLL_THREAD_DATA* epoll_thread_data = malloc(sizeof(EPOLL_THREAD_DATA));
-            if (epoll_thread_data == NULL)
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_004: [ completion_port_add shall use the epoll instance of the epoll thread at the index socket modulo the number of epoll threads. ]
+            EPOLL_THREAD* epoll_thread = get_epoll_thread(completion_port, socket);
+            EPOLL_THREAD_DATA* epoll_thread_data;
+
+            enter_crit_section(&epoll_thread->data_access);
             {
-                LogError("failure allocating epoll thread data size: %zu", sizeof(EPOLL_THREAD_DATA));
-                result = MU_FAILURE;
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_056: [ completion_port_add shall grow the table of the armed objects of the sockets of the epoll thread if it has no entry at the index socket divided by the number of epoll threads. ]
+                if (reserve_armed_data(epoll_thread, get_armed_data_index(epoll_thread, socket)) != 0)
+                {
+                    LogError("failure reserving the armed objects of socket %" PRI_SOCKET "", socket);
+                    epoll_thread_data = NULL;
+                }
+                else
+                {
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_006: [ completion_port_add shall reuse an EPOLL_THREAD_DATA object from the list of free objects of the epoll thread. ]
+                    PS_LIST_ENTRY entry = s_list_remove_head(&epoll_thread->free_data);
+                    if (entry != &epoll_thread->free_data)
+                    {
+                        epoll_thread_data = CONTAINING_RECORD(entry, EPOLL_THREAD_DATA, free_link);
+                    }
+                    else
+                    {
+                        // Codes_SRS_COMPLETION_PORT_LINUX_11_021: [ If there is no free EPOLL_THREAD_DATA object, completion_port_add shall allocate a EPOLL_THREAD_DATA object to store thread data. ]
+                        epoll_thread_data = malloc(sizeof(EPOLL_THREAD_DATA));
+                    }
+
+                    if (epoll_thread_data == NULL)
+                    {
+                        LogError("failure allocating epoll thread data size: %zu", sizeof(EPOLL_THREAD_DATA));
+                    }
+                    else
+                    {
+                        epoll_thread_data->event_callback = event_callback;
+                        epoll_thread_data->event_callback_ctx = event_callback_ctx;
+                        (void)interlocked_exchange(&epoll_thread_data->event_callback_called, COMPLETION_PORT_CALLBACK_INIT);
+                        epoll_thread_data->socket = socket;
+                        // Codes_SRS_COMPLETION_PORT_LINUX_12_011: [ If epoll_op contains EPOLLET, completion_port_add shall register the socket persistently, so that the EPOLL_THREAD_DATA object stays armed until completion_port_remove is called. ]
+                        epoll_thread_data->persistent = ((epoll_op & EPOLLET) != 0);
+
+                        // Codes_SRS_COMPLETION_PORT_LINUX_11_022: [ completion_port_add shall add the EPOLL_THREAD_DATA object to the armed objects of socket in the epoll thread. ]
+                        link_armed_data(epoll_thread, epoll_thread_data);
+                    }
+                }
             }
-            else
-            {
-                epoll_thread_data->event_callback = event_callback;
-                epoll_thread_data->event_callback_ctx = event_callback_ctx;
-                (void)interlocked_exchange(&epoll_thread_data->event_callback_called, COMPLETION_PORT_CALLBACK_INIT);
-                epoll_thread_data->socket = socket;
-                epoll_thread_data->link.next = NULL;
+            leave_crit_section(&epoll_thread->data_access);
 
+            if (epoll_thread_data != NULL)
+            {
                 struct epoll_event ev = {0};
-                ev.events = epoll_op;
                 ev.data.ptr = (void*)epoll_thread_data;
                 #ifdef USE_VALGRIND
                     ANNOTATE_HAPPENS_BEFORE(epoll_thread_data);
                 #endif
-                // Codes_SRS_COMPLETION_PORT_LINUX_11_022: [ completion_port_add shall add the EPOLL_THREAD_DATA object to a list for later removal. ]
-                if (add_thread_data_to_list(completion_port, epoll_thread_data) != 0)
+                if (epoll_thread_data->persistent)
                 {
-                    LogError("failure adding data to list");
+                    ev.events = epoll_op;
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_012: [ If epoll_op contains EPOLLET, completion_port_add shall add the socket in the epoll system by calling epoll_ctl with EPOLL_CTL_ADD along with the epoll_op variable. ]
+                    if (epoll_ctl(epoll_thread->epoll, EPOLL_CTL_ADD, socket, &ev) < 0)
+                    {
+                        LogErrorNo("failure with epoll_ctl EPOLL_CTL_ADD");
+                    }
+                    else
+                    {
+                        result = 0;
+                        goto all_ok;
+                    }
                 }
                 else
                 {
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_007: [ Otherwise, completion_port_add shall add EPOLLONESHOT to epoll_op so that the EPOLL_THREAD_DATA object is signaled at most once. ]
+                    ev.events = epoll_op | EPOLLONESHOT;
                     // Codes_SRS_COMPLETION_PORT_LINUX_11_023: [ completion_port_add shall add the socket in the epoll system by calling epoll_ctl with EPOLL_CTL_MOD along with the epoll_op variable. ]
-                    if (epoll_ctl(completion_port->epoll, EPOLL_CTL_MOD, epoll_thread_data->socket, &ev) < 0)
+                    if (epoll_ctl(epoll_thread->epoll, EPOLL_CTL_MOD, socket, &ev) < 0)
                     {
                         if (errno == ENOENT)
                         {
                             // Codes_SRS_COMPLETION_PORT_LINUX_11_024: [ If the epoll_ctl call fails with ENOENT, completion_port_add shall call epoll_ctl again with EPOLL_CTL_ADD. ]
-                            if (epoll_ctl(completion_port->epoll, EPOLL_CTL_ADD, epoll_thread_data->socket, &ev) < 0)
+                            if (epoll_ctl(epoll_thread->epoll, EPOLL_CTL_ADD, socket, &ev) < 0)
                             {
                                 LogErrorNo("failure with epoll_ctl EPOLL_CTL_ADD");
                             }
                             else
                             {
                                 result = 0;
-                                // (void)interlocked_decrement(&completion_port->pending_calls);
-                                // wake_by_address_single(&completion_port->pending_calls);
                                 goto all_ok;
                             }
                         }
@@ -402,10 +1034,14 @@ int completion_port_add(COMPLETION_PORT_HANDLE completion_port, int epoll_op, SO
                         result = 0;
                         goto all_ok;
                     }
-                    // Remove
-                    remove_thread_data_from_list(completion_port, epoll_thread_data);
                 }
-                free(epoll_thread_data);
+
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_008: [ If epoll_ctl fails, completion_port_add shall move the EPOLL_THREAD_DATA object back to the list of free objects of the epoll thread. ]
+                enter_crit_section(&epoll_thread->data_access);
+                {
+                    release_thread_data(epoll_thread, epoll_thread_data);
+                }
+                leave_crit_section(&epoll_thread->data_access);
             }
             // Codes_SRS_COMPLETION_PORT_LINUX_11_027: [ If any error occurs, completion_port_add shall fail and return a non-zero value. ]
             result = MU_FAILURE;
@@ -438,46 +1074,384 @@ void completion_port_remove(COMPLETION_PORT_HANDLE completion_port, SOCKET_HANDL
         {
             (void)interlocked_increment(&completion_port->pending_calls);
 
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_005: [ completion_port_remove shall use the epoll instance of the epoll thread at the index socket modulo the number of epoll threads. ]
+            EPOLL_THREAD* epoll_thread = get_epoll_thread(completion_port, socket);
+
             // Codes_SRS_COMPLETION_PORT_LINUX_11_030: [ completion_port_remove shall remove the underlying socket from the epoll by calling epoll_ctl with EPOLL_CTL_DEL. ]
-            if (epoll_ctl(completion_port->epoll, EPOLL_CTL_DEL, socket, NULL) == -1)
+            if (epoll_ctl(epoll_thread->epoll, EPOLL_CTL_DEL, socket, NULL) == -1)
             {
                 LogErrorNo("Failure epoll_ctl with EPOLL_CTL_DEL %" PRI_SOCKET "", socket);
             }
 
-            // Codes_SRS_COMPLETION_PORT_LINUX_11_037: [ completion_port_remove shall loop through the list of EPOLL_THREAD_DATA object and call the event_callback with COMPLETION_PORT_EPOLL_ABANDONED ]
-            enter_crit_section(completion_port);
+            enter_crit_section(&epoll_thread->data_access);
             {
-                PS_LIST_ENTRY current_item = completion_port->alloc_data_list.next;
-                while (current_item != NULL)
+                // Codes_SRS_COMPLETION_PORT_LINUX_11_037: [ completion_port_remove shall call the event_callback with COMPLETION_PORT_EPOLL_ABANDONED for each armed EPOLL_THREAD_DATA object of socket, which it finds in the table of the armed objects of the sockets of the epoll thread at the index socket divided by the number of epoll threads. ]
+                uint32_t index = get_armed_data_index(epoll_thread, socket);
+                while (index < epoll_thread->armed_data_count && epoll_thread->armed_data[index] != NULL)
                 {
-                    EPOLL_THREAD_DATA* epoll_data = CONTAINING_RECORD(current_item, EPOLL_THREAD_DATA, link);
-                    if (epoll_data->socket == socket)
+                    EPOLL_THREAD_DATA* epoll_data = epoll_thread->armed_data[index];
+                    COMPLETION_PORT_CALLBACK_STATE callback_state = interlocked_compare_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTING, COMPLETION_PORT_CALLBACK_INIT);
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_018: [ If the EPOLL_THREAD_DATA object is persistent and its event_callback is executing, completion_port_remove shall wait for the event_callback to return and then call the event_callback with COMPLETION_PORT_EPOLL_ABANDONED. ]
+                    while (epoll_data->persistent && callback_state == COMPLETION_PORT_CALLBACK_EXECUTING)
                     {
-                        COMPLETION_PORT_CALLBACK_STATE callback_state = interlocked_compare_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTING, COMPLETION_PORT_CALLBACK_INIT);
-                        // Codes_SRS_COMPLETION_PORT_LINUX_11_038: [ If the event_callback has not been called, completion_port_remove shall call the event_callback. ]
-                        if (callback_state == COMPLETION_PORT_CALLBACK_INIT)
-                        {
-                            epoll_data->event_callback(epoll_data->event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
-                            (void)interlocked_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTED);
-                        }
-                        // Codes_SRS_COMPLETION_PORT_LINUX_11_039: [ If the event_callback is currently executing, completion_port_remove shall wait for the event_callback function to finish before completing. ]
-                        else if (callback_state == COMPLETION_PORT_CALLBACK_EXECUTING)
-                        {
-                            // Callback is executing, so wait till the callback is done
-                            (void)InterlockedHL_WaitForValue(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTED, UINT32_MAX);
-                        }
-                        else
-                        {
-                            // callback state is Executed Do Nothing
-                        }
+                        (void)wait_on_address(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTING, UINT32_MAX);
+                        callback_state = interlocked_compare_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTING, COMPLETION_PORT_CALLBACK_INIT);
+                    }
+                    // Codes_SRS_COMPLETION_PORT_LINUX_11_038: [ If the event_callback has not been called, completion_port_remove shall call the event_callback. ]
+                    if (callback_state == COMPLETION_PORT_CALLBACK_INIT)
+                    {
+                        epoll_data->event_callback(epoll_data->event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
+                        (void)interlocked_exchange(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTED);
+                    }
+                    // Codes_SRS_COMPLETION_PORT_LINUX_11_039: [ If the event_callback is currently executing, completion_port_remove shall wait for the event_callback function to finish before completing. ]
+                    else if (callback_state == COMPLETION_PORT_CALLBACK_EXECUTING)
+                    {
+                        // Callback is executing, so wait till the callback is done
+                        (void)InterlockedHL_WaitForValue(&epoll_data->event_callback_called, COMPLETION_PORT_CALLBACK_EXECUTED, UINT32_MAX);
+                    }
+                    else
+                    {
+                        // callback state is Executed Do Nothing
                     }
-                    current_item = current_item->next;
+
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_009: [ completion_port_remove shall move the EPOLL_THREAD_DATA object from the armed objects of socket to the list of abandoned objects of the epoll thread. ]
+                    unlink_armed_data(epoll_thread, epoll_data);
+                    (void)s_list_add(&epoll_thread->abandoned_data, &epoll_data->free_link);
                 }
             }
-            leave_crit_section(completion_port);
+            leave_crit_section(&epoll_thread->data_access);
 
             (void)interlocked_decrement(&completion_port->pending_calls);
             wake_by_address_single(&completion_port->pending_calls);
         }
     }
 }
+
+static bool is_io_uring_port_call_valid(COMPLETION_PORT_HANDLE completion_port)
+{
+    bool result;
+    if (completion_port->engine != COMPLETION_PORT_ENGINE_IO_URING)
+    {
+        LogError("The completion port uses %" PRI_MU_ENUM "", MU_ENUM_VALUE(COMPLETION_PORT_ENGINE, completion_port->engine));
+        result = false;
+    }
+    else if (interlocked_add(&completion_port->worker_thread_continue, 0) != 0)
+    {
+        LogError("Invalid call sequence completion port module is destroying");
+        result = false;
+    }
+    else
+    {
+        result = true;
+    }
+    return result;
+}
+
+static int submit_sqe(COMPLETION_PORT_HANDLE completion_port, SOCKET_HANDLE socket, const struct io_uring_sqe* sqe)
+{
+    int result;
+
+    (void)interlocked_increment(&completion_port->pending_calls);
+
+    EPOLL_THREAD* epoll_thread = get_epoll_thread(completion_port, socket);
+
+    enter_crit_section(&epoll_thread->ring.submit_access);
+    {
+        result = io_uring_ring_submit(&epoll_thread->ring, sqe);
+    }
+    leave_crit_section(&epoll_thread->ring.submit_access);
+
+    (void)interlocked_decrement(&completion_port->pending_calls);
+    wake_by_address_single(&completion_port->pending_calls);
+
+    return result;
+}
+
+int completion_port_submit_io(COMPLETION_PORT_HANDLE completion_port, SOCKET_HANDLE socket, COMPLETION_PORT_IO* io)
+{
+    int result;
+    if (
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_032: [ If completion_port is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+        completion_port == NULL ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_033: [ If socket is INVALID_SOCKET, completion_port_submit_io shall fail and return a non-zero value. ]
+        socket == INVALID_SOCKET ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_034: [ If io is NULL or its on_io_complete is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+        io == NULL ||
+        io->on_io_complete == NULL ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_035: [ If the io_type of io is not COMPLETION_PORT_IO_TYPE_SEND, COMPLETION_PORT_IO_TYPE_RECEIVE, COMPLETION_PORT_IO_TYPE_POLL or COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, completion_port_submit_io shall fail and return a non-zero value. ]
+        (io->io_type != COMPLETION_PORT_IO_TYPE_SEND && io->io_type != COMPLETION_PORT_IO_TYPE_RECEIVE && io->io_type != COMPLETION_PORT_IO_TYPE_POLL && io->io_type != COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING) ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_036: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_SEND or COMPLETION_PORT_IO_TYPE_RECEIVE and its message is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+        ((io->io_type == COMPLETION_PORT_IO_TYPE_SEND || io->io_type == COMPLETION_PORT_IO_TYPE_RECEIVE) && io->message == NULL) ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_061: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING and its buffer_ring is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+        (io->io_type == COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING && io->buffer_ring == NULL)
+        )
+    {
+        LogError("Invalid arguments: COMPLETION_PORT_HANDLE completion_port=%p, SOCKET_HANDLE socket=%" PRI_SOCKET ", COMPLETION_PORT_IO* io=%p",
+            completion_port, socket, io);
+        result = MU_FAILURE;
+    }
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_037: [ If the engine of completion_port is not COMPLETION_PORT_ENGINE_IO_URING, completion_port_submit_io shall fail and return a non-zero value. ]
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_038: [ completion_port_submit_io shall ensure the thread completion flag is not set. ]
+    else if (!is_io_uring_port_call_valid(completion_port))
+    {
+        result = MU_FAILURE;
+    }
+    else
+    {
+        struct io_uring_sqe sqe;
+        (void)memset(&sqe, 0, sizeof(sqe));
+        sqe.fd = socket;
+        sqe.user_data = (uint64_t)(uintptr_t)io;
+
+        switch (io->io_type)
+        {
+            case COMPLETION_PORT_IO_TYPE_SEND:
+            {
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_039: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_SEND, completion_port_submit_io shall prepare an IORING_OP_SENDMSG operation for the message of io with the MSG_NOSIGNAL flag. ]
+                sqe.opcode = IORING_OP_SENDMSG;
+                sqe.addr = (uint64_t)(uintptr_t)io->message;
+                sqe.len = 1;
+                sqe.msg_flags = MSG_NOSIGNAL;
+                break;
+            }
+            case COMPLETION_PORT_IO_TYPE_RECEIVE:
+            {
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_040: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_RECEIVE, completion_port_submit_io shall prepare an IORING_OP_RECVMSG operation for the message of io. ]
+                sqe.opcode = IORING_OP_RECVMSG;
+                sqe.addr = (uint64_t)(uintptr_t)io->message;
+                sqe.len = 1;
+                break;
+            }
+            case COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING:
+            {
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_062: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, completion_port_submit_io shall prepare an IORING_OP_RECV operation with IOSQE_BUFFER_SELECT that receives into a buffer picked from the buffer group of buffer_ring, with IORING_RECV_MULTISHOT if is_multishot is true. ]
+                sqe.opcode = IORING_OP_RECV;
+                sqe.flags = IOSQE_BUFFER_SELECT;
+                sqe.buf_group = io->buffer_ring->buffer_group;
+                // the length of the receive is the length of the buffer the kernel picks
+                sqe.len = 0;
+                sqe.ioprio = io->is_multishot ? IORING_RECV_MULTISHOT : 0;
+                break;
+            }
+            default:
+            {
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_041: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_POLL, completion_port_submit_io shall prepare an IORING_OP_POLL_ADD operation for the poll_events of io. ]
+                sqe.opcode = IORING_OP_POLL_ADD;
+                sqe.poll32_events = io->poll_events;
+                break;
+            }
+        }
+
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_042: [ completion_port_submit_io shall increment the ongoing call count value to prevent close. ]
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_043: [ completion_port_submit_io shall copy the operation with io as user data in the next submission queue entry of the io_uring of the epoll thread at the index socket modulo the number of epoll threads and submit it, along with the entries queued by the on_io_complete callbacks, by calling io_uring_enter. ]
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_044: [ If the submission queue is still full after submitting the entries queued by the on_io_complete callbacks or io_uring_enter does not submit the entry, completion_port_submit_io shall take the entry back and fail. ]
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_045: [ completion_port_submit_io shall decrement the ongoing call count value to unblock close. ]
+        if (submit_sqe(completion_port, socket, &sqe) != 0)
+        {
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_047: [ If any error occurs, completion_port_submit_io shall fail and return a non-zero value. ]
+            LogError("failure submitting %" PRI_MU_ENUM " for socket %" PRI_SOCKET "", MU_ENUM_VALUE(COMPLETION_PORT_IO_TYPE, io->io_type), socket);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_046: [ On success, completion_port_submit_io shall return 0. ]
+            result = 0;
+        }
+    }
+    return result;
+}
+
+int completion_port_cancel_io(COMPLETION_PORT_HANDLE completion_port, SOCKET_HANDLE socket, COMPLETION_PORT_IO* io)
+{
+    int result;
+    if (
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_048: [ If completion_port is NULL, completion_port_cancel_io shall fail and return a non-zero value. ]
+        completion_port == NULL ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_049: [ If socket is INVALID_SOCKET, completion_port_cancel_io shall fail and return a non-zero value. ]
+        socket == INVALID_SOCKET ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_050: [ If io is NULL, completion_port_cancel_io shall fail and return a non-zero value. ]
+        io == NULL
+        )
+    {
+        LogError("Invalid arguments: COMPLETION_PORT_HANDLE completion_port=%p, SOCKET_HANDLE socket=%" PRI_SOCKET ", COMPLETION_PORT_IO* io=%p",
+            completion_port, socket, io);
+        result = MU_FAILURE;
+    }
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_051: [ If the engine of completion_port is not COMPLETION_PORT_ENGINE_IO_URING, completion_port_cancel_io shall fail and return a non-zero value. ]
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_052: [ completion_port_cancel_io shall ensure the thread completion flag is not set. ]
+    else if (!is_io_uring_port_call_valid(completion_port))
+    {
+        result = MU_FAILURE;
+    }
+    else
+    {
+        struct io_uring_sqe sqe;
+        (void)memset(&sqe, 0, sizeof(sqe));
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_053: [ completion_port_cancel_io shall submit an IORING_OP_ASYNC_CANCEL operation for the user data io to the io_uring of the epoll thread at the index socket modulo the number of epoll threads, without user data so that its own completion is not reported. ]
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = -1;
+        sqe.addr = (uint64_t)(uintptr_t)io;
+        if (submit_sqe(completion_port, socket, &sqe) != 0)
+        {
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_055: [ If any error occurs, completion_port_cancel_io shall fail and return a non-zero value. ]
+            LogError("failure submitting the cancel of io=%p for socket %" PRI_SOCKET "", io, socket);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_054: [ On success, completion_port_cancel_io shall return 0. ]
+            result = 0;
+        }
+    }
+    return result;
+}
+
+COMPLETION_PORT_BUFFER_RING_HANDLE completion_port_buffer_ring_create(COMPLETION_PORT_HANDLE completion_port, SOCKET_HANDLE socket, uint32_t buffer_count)
+{
+    COMPLETION_PORT_BUFFER_RING_HANDLE result;
+    if (
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_063: [ If completion_port is NULL, completion_port_buffer_ring_create shall fail and return NULL. ]
+        completion_port == NULL ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_064: [ If socket is INVALID_SOCKET, completion_port_buffer_ring_create shall fail and return NULL. ]
+        socket == INVALID_SOCKET ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_065: [ If buffer_count is 0, is not a power of 2 or is greater than 32768, completion_port_buffer_ring_create shall fail and return NULL. ]
+        buffer_count == 0 ||
+        (buffer_count & (buffer_count - 1)) != 0 ||
+        buffer_count > IO_URING_MAX_RING_BUFFERS
+        )
+    {
+        LogError("Invalid arguments: COMPLETION_PORT_HANDLE completion_port=%p, SOCKET_HANDLE socket=%" PRI_SOCKET ", uint32_t buffer_count=%" PRIu32 "",
+            completion_port, socket, buffer_count);
+        result = NULL;
+    }
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_066: [ If the engine of completion_port is not COMPLETION_PORT_ENGINE_IO_URING, completion_port_buffer_ring_create shall fail and return NULL. ]
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_067: [ completion_port_buffer_ring_create shall ensure the thread completion flag is not set. ]
+    else if (!is_io_uring_port_call_valid(completion_port))
+    {
+        result = NULL;
+    }
+    else
+    {
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_068: [ completion_port_buffer_ring_create shall allocate memory for the buffer ring. ]
+        result = malloc(sizeof(COMPLETION_PORT_BUFFER_RING));
+        if (result == NULL)
+        {
+            LogError("failure allocating COMPLETION_PORT_BUFFER_RING");
+        }
+        else
+        {
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_069: [ completion_port_buffer_ring_create shall map page aligned memory for buffer_count entries with mmap, which the kernel shares with the process. ]
+            result->buffers_size = buffer_count * sizeof(struct io_uring_buf);
+            result->buffers = mmap(NULL, result->buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (result->buffers == MAP_FAILED)
+            {
+                LogErrorNo("failure mmap(buffers_size=%zu) for the provided-buffer ring", result->buffers_size);
+            }
+            else
+            {
+                EPOLL_THREAD* epoll_thread = get_epoll_thread(completion_port, socket);
+                struct io_uring_buf_reg buffer_registration;
+                int register_result;
+
+                result->ring = &epoll_thread->ring;
+                result->buffer_mask = buffer_count - 1;
+                result->tail = 0;
+
+                (void)interlocked_increment(&completion_port->pending_calls);
+
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_070: [ completion_port_buffer_ring_create shall register the entries as the buffer group of the next buffer group id of the io_uring of the epoll thread at the index socket modulo the number of epoll threads by calling io_uring_register with IORING_REGISTER_PBUF_RING. ]
+                // Codes_SRS_COMPLETION_PORT_LINUX_12_071: [ If the buffer group id is already registered, completion_port_buffer_ring_create shall try the next buffer group id. ]
+                uint32_t attempt = 0;
+                do
+                {
+                    result->buffer_group = (uint16_t)interlocked_increment(&result->ring->last_buffer_group);
+                    (void)memset(&buffer_registration, 0, sizeof(buffer_registration));
+                    buffer_registration.ring_addr = (uint64_t)(uintptr_t)result->buffers;
+                    buffer_registration.ring_entries = buffer_count;
+                    buffer_registration.bgid = result->buffer_group;
+                    register_result = io_uring_register(result->ring->ring_fd, IORING_REGISTER_PBUF_RING, &buffer_registration, 1);
+                    attempt++;
+                } while (register_result < 0 && errno == EEXIST && attempt <= UINT16_MAX);
+
+                (void)interlocked_decrement(&completion_port->pending_calls);
+                wake_by_address_single(&completion_port->pending_calls);
+
+                if (register_result < 0)
+                {
+                    // kernels before 5.19 do not support provided-buffer rings
+                    LogErrorNo("failure io_uring_register(ring_fd=%d, IORING_REGISTER_PBUF_RING, ring_entries=%" PRIu32 ")", result->ring->ring_fd, buffer_count);
+                }
+                else
+                {
+                    // Codes_SRS_COMPLETION_PORT_LINUX_12_072: [ On success, completion_port_buffer_ring_create shall return the buffer ring. ]
+                    goto all_ok;
+                }
+                (void)munmap(result->buffers, result->buffers_size);
+            }
+            free(result);
+            // Codes_SRS_COMPLETION_PORT_LINUX_12_073: [ If any error occurs, completion_port_buffer_ring_create shall fail and return NULL. ]
+            result = NULL;
+        }
+    }
+all_ok:
+    return result;
+}
+
+void completion_port_buffer_ring_destroy(COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring)
+{
+    // Codes_SRS_COMPLETION_PORT_LINUX_12_074: [ If buffer_ring is NULL, completion_port_buffer_ring_destroy shall return. ]
+    if (buffer_ring == NULL)
+    {
+        LogError("Invalid arguments: COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring=%p", buffer_ring);
+    }
+    else
+    {
+        struct io_uring_buf_reg buffer_registration;
+        (void)memset(&buffer_registration, 0, sizeof(buffer_registration));
+        buffer_registration.bgid = buffer_ring->buffer_group;
+
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_075: [ completion_port_buffer_ring_destroy shall unregister the buffer group by calling io_uring_register with IORING_UNREGISTER_PBUF_RING. ]
+        if (io_uring_register(buffer_ring->ring->ring_fd, IORING_UNREGISTER_PBUF_RING, &buffer_registration, 1) < 0)
+        {
+            LogErrorNo("failure io_uring_register(ring_fd=%d, IORING_UNREGISTER_PBUF_RING, bgid=%" PRIu16 ")", buffer_ring->ring->ring_fd, buffer_ring->buffer_group);
+        }
+
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_076: [ completion_port_buffer_ring_destroy shall unmap the entries and free the buffer ring. ]
+        (void)munmap(buffer_ring->buffers, buffer_ring->buffers_size);
+        free(buffer_ring);
+    }
+}
+
+int completion_port_buffer_ring_add(COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring, void* buffer, uint32_t buffer_size, uint16_t buffer_id)
+{
+    int result;
+    if (
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_077: [ If buffer_ring is NULL, completion_port_buffer_ring_add shall fail and return a non-zero value. ]
+        buffer_ring == NULL ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_078: [ If buffer is NULL, completion_port_buffer_ring_add shall fail and return a non-zero value. ]
+        buffer == NULL ||
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_079: [ If buffer_size is 0, completion_port_buffer_ring_add shall fail and return a non-zero value. ]
+        buffer_size == 0
+        )
+    {
+        LogError("Invalid arguments: COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring=%p, void* buffer=%p, uint32_t buffer_size=%" PRIu32 ", uint16_t buffer_id=%" PRIu16 "",
+            buffer_ring, buffer, buffer_size, buffer_id);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_080: [ completion_port_buffer_ring_add shall write buffer, buffer_size and buffer_id in the entry at the tail of the buffer ring. ]
+        struct io_uring_buf* entry = &buffer_ring->buffers->bufs[buffer_ring->tail & buffer_ring->buffer_mask];
+        entry->addr = (uint64_t)(uintptr_t)buffer;
+        entry->len = buffer_size;
+        entry->bid = buffer_id;
+
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_081: [ completion_port_buffer_ring_add shall then publish the entry to the kernel by storing the incremented tail with release semantics. ]
+        buffer_ring->tail++;
+        __atomic_store_n(&buffer_ring->buffers->tail, buffer_ring->tail, __ATOMIC_RELEASE);
+
+        // Codes_SRS_COMPLETION_PORT_LINUX_12_082: [ On success, completion_port_buffer_ring_add shall return 0. ]
+        result = 0;
+    }
+    return result;
+}
@@ -1,5 +1,6 @@
 // Copyright (C) Microsoft Corporation. All rights reserved.
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <inttypes.h>
 
@@ -9,15 +10,17 @@
 
 #include "c_pal/refcount.h"
 #include "c_pal/execution_engine.h"
+#include "c_pal/execution_engine_linux.h"
 
 typedef struct EXECUTION_ENGINE_TAG
 {
     EXECUTION_ENGINE_PARAMETERS params;
+    EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS thread_params;
 }EXECUTION_ENGINE;
 
 DEFINE_REFCOUNT_TYPE(EXECUTION_ENGINE);
 
-EXECUTION_ENGINE_HANDLE execution_engine_create(const EXECUTION_ENGINE_PARAMETERS* execution_engine_parameters)
+static EXECUTION_ENGINE_HANDLE execution_engine_create_internal(const EXECUTION_ENGINE_PARAMETERS* execution_engine_parameters, const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* thread_parameters)
 {
     EXECUTION_ENGINE_HANDLE result;
 
@@ -44,6 +47,19 @@ EXECUTION_ENGINE_HANDLE execution_engine_create(const EXECUTION_ENGINE_PARAMETER
             result->params.max_thread_count = execution_engine_parameters->max_thread_count;
         }
 
+        if (thread_parameters == NULL)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_12_002: [ If thread_parameters is NULL, execution_engine_linux_create shall not pin the threads to a NUMA node and shall use the default thread stack size. ]*/
+            result->thread_params.pin_to_numa_node = false;
+            result->thread_params.numa_node = 0;
+            result->thread_params.thread_stack_size = 0;
+        }
+        else
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_12_003: [ Otherwise execution_engine_linux_create shall copy the fields of thread_parameters. ]*/
+            result->thread_params = *thread_parameters;
+        }
+
         if ((result->params.max_thread_count != 0) &&
             (result->params.max_thread_count < result->params.min_thread_count))
         {
@@ -53,7 +69,8 @@ EXECUTION_ENGINE_HANDLE execution_engine_create(const EXECUTION_ENGINE_PARAMETER
         }
         else
         {
-            LogInfo("Creating execution engine with min thread count=%" PRIu32 ", max thread count=%" PRIu32 "", result->params.min_thread_count, result->params.max_thread_count);
+            LogInfo("Creating execution engine with min thread count=%" PRIu32 ", max thread count=%" PRIu32 ", pin to NUMA node=%s, NUMA node=%" PRIu32 ", thread stack size=%zu",
+                result->params.min_thread_count, result->params.max_thread_count, (result->thread_params.pin_to_numa_node ? "true" : "false"), result->thread_params.numa_node, result->thread_params.thread_stack_size);
 
             goto all_ok;
         }
@@ -64,6 +81,17 @@ all_ok:
     return result;
 }
 
+EXECUTION_ENGINE_HANDLE execution_engine_create(const EXECUTION_ENGINE_PARAMETERS* execution_engine_parameters)
+{
+    return execution_engine_create_internal(execution_engine_parameters, NULL);
+}
+
+EXECUTION_ENGINE_HANDLE execution_engine_linux_create(const EXECUTION_ENGINE_PARAMETERS* execution_engine_parameters, const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* thread_parameters)
+{
+    /* Codes_SRS_EXECUTION_ENGINE_LINUX_12_001: [ execution_engine_linux_create shall create the execution engine like execution_engine_create, using execution_engine_parameters for the thread counts. ]*/
+    return execution_engine_create_internal(execution_engine_parameters, thread_parameters);
+}
+
 void execution_engine_dec_ref(EXECUTION_ENGINE_HANDLE execution_engine)
 {
     if (execution_engine == NULL)
@@ -115,3 +143,22 @@ const EXECUTION_ENGINE_PARAMETERS* execution_engine_linux_get_parameters(EXECUTI
 
     return result;
 }
+
+const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* execution_engine_linux_get_thread_parameters(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* result;
+
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_12_004: [ If execution_engine is NULL, execution_engine_linux_get_thread_parameters shall fail and return NULL. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_12_005: [ Otherwise, execution_engine_linux_get_thread_parameters shall return the thread parameters in EXECUTION_ENGINE. ]*/
+        result = &execution_engine->thread_params;
+    }
+
+    return result;
+}
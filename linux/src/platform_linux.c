@@ -2,6 +2,8 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stddef.h>                       // for NULL
+#include <stdint.h>
+#include <inttypes.h>
 
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -48,36 +50,67 @@ static int warmup_getaddrinfo(void)
 }
 
 int platform_init(void)
+{
+    // Codes_SRS_PLATFORM_LINUX_12_013: [ platform_init shall initialize the platform by calling platform_linux_init_with_engine with 1 and COMPLETION_PORT_ENGINE_EPOLL. ]
+    return platform_linux_init_with_engine(1, COMPLETION_PORT_ENGINE_EPOLL);
+}
+
+int platform_linux_init(uint32_t completion_port_thread_count)
+{
+    // Codes_SRS_PLATFORM_LINUX_12_014: [ platform_linux_init shall initialize the platform by calling platform_linux_init_with_engine with completion_port_thread_count and COMPLETION_PORT_ENGINE_EPOLL. ]
+    return platform_linux_init_with_engine(completion_port_thread_count, COMPLETION_PORT_ENGINE_EPOLL);
+}
+
+int platform_linux_init_with_engine(uint32_t completion_port_thread_count, COMPLETION_PORT_ENGINE engine)
 {
     int result;
 
     if (g_completion_port == NULL)
     {
-        if (warmup_getaddrinfo() != 0)
+        // Codes_SRS_PLATFORM_LINUX_12_008: [ If completion_port_thread_count is 0, platform_linux_init_with_engine shall fail and return a non-zero value. ]
+        // Codes_SRS_PLATFORM_LINUX_12_001: [ If completion_port_thread_count is 0, platform_linux_init shall fail and return a non-zero value. ]
+        if (completion_port_thread_count == 0)
+        {
+            LogError("Invalid arguments: uint32_t completion_port_thread_count=%" PRIu32 ", COMPLETION_PORT_ENGINE engine=%" PRI_MU_ENUM "",
+                completion_port_thread_count, MU_ENUM_VALUE(COMPLETION_PORT_ENGINE, engine));
+            result = MU_FAILURE;
+        }
+        // Codes_SRS_PLATFORM_LINUX_12_009: [ Otherwise, platform_linux_init_with_engine shall call getaddrinfo for localhost and port 4242. ]
+        // Codes_SRS_PLATFORM_LINUX_12_002: [ Otherwise, platform_linux_init shall call getaddrinfo for localhost and port 4242. ]
+        else if (warmup_getaddrinfo() != 0)
         {
+            // Codes_SRS_PLATFORM_LINUX_12_011: [ If any error occurs, platform_linux_init_with_engine shall return a non-zero value. ]
+            // Codes_SRS_PLATFORM_LINUX_12_004: [ If any error occurs, platform_linux_init shall return a non-zero value. ]
             LogError("Failure calling warmup_getaddrinfo");
             result = MU_FAILURE;
         }
         else
         {
-            // Codes_SRS_PLATFORM_LINUX_11_001: [ platform_init shall call completion_port_create. ]
-            g_completion_port = completion_port_create();
+            // Codes_SRS_PLATFORM_LINUX_12_010: [ platform_linux_init_with_engine shall call completion_port_create_with_engine with completion_port_thread_count and engine. ]
+            g_completion_port = completion_port_create_with_engine(completion_port_thread_count, engine);
             if (g_completion_port == NULL)
             {
+                // Codes_SRS_PLATFORM_LINUX_12_011: [ If any error occurs, platform_linux_init_with_engine shall return a non-zero value. ]
                 // Codes_SRS_PLATFORM_LINUX_01_002: [ If any error occurs, platform_init shall return a non-zero value. ]
-                LogError("Failure calling completion_port_create");
+                // Codes_SRS_PLATFORM_LINUX_12_004: [ If any error occurs, platform_linux_init shall return a non-zero value. ]
+                LogError("Failure calling completion_port_create_with_engine(completion_port_thread_count=%" PRIu32 ", engine=%" PRI_MU_ENUM ")",
+                    completion_port_thread_count, MU_ENUM_VALUE(COMPLETION_PORT_ENGINE, engine));
                 result = MU_FAILURE;
             }
             else
             {
+                // Codes_SRS_PLATFORM_LINUX_12_012: [ platform_linux_init_with_engine shall succeed and return zero. ]
                 // Codes_SRS_PLATFORM_LINUX_11_002: [ platform_init shall succeed and return zero. ]
+                // Codes_SRS_PLATFORM_LINUX_12_005: [ platform_linux_init shall succeed and return zero. ]
                 result = 0;
             }
         }
     }
     else
     {
+        // Codes_SRS_PLATFORM_LINUX_12_007: [ If the completion port object is non-NULL, platform_linux_init_with_engine shall return zero. ]
         // Codes_SRS_PLATFORM_LINUX_11_007: [ If the completion port object is non-NULL, platform_init shall return zero. ]
+        // Codes_SRS_PLATFORM_LINUX_12_006: [ If the completion port object is non-NULL, platform_linux_init shall return zero. ]
         result = 0;
     }
     return result;
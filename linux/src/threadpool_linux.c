@@ -1,18 +1,16 @@
 // Copyright (C) Microsoft Corporation. All rights reserved.
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <inttypes.h>
 #include <stdio.h>
-#include <semaphore.h>
 #include <time.h>
 #include <string.h>
-#include <signal.h>
+#include <unistd.h>
+
+#include <sys/timerfd.h>
 
-#include <bits/types/__sigval_t.h>         // for __sigval_t
-#include <bits/types/sigevent_t.h>         // for sigevent, sigev_notify_fun...
-#include <bits/types/sigval_t.h>           // for sigval_t
 #include <bits/types/struct_itimerspec.h>  // for itimerspec
-#include <bits/types/timer_t.h>            // for timer_t
 
 #include "macro_utils/macro_utils.h"
 
@@ -22,6 +20,8 @@
 
 #include "c_pal/gballoc_hl.h" // IWYU pragma: keep
 #include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/containing_record.h"
+#include "c_pal/srw_lock_ll.h"
 #include "c_pal/threadapi.h"
 #include "c_pal/interlocked.h"
 #include "c_pal/interlocked_hl.h"
@@ -31,14 +31,43 @@
 #include "c_pal/sync.h"
 #include "c_pal/thandle.h" // IWYU pragma: keep
 #include "c_pal/thandle_ll.h"
+#include "c_pal/timer.h"
 #include "c_pal/tqueue.h"
-#include "c_pal/tqueue_threadpool_work_item.h"
+#include "c_pal/tqueue_threadpool_task.h"
+#include "c_pal/threadpool_task_deque.h"
 
 #include "c_pal/threadpool.h"
+#include "c_pal/threadpool_linux.h"
 
 #define DEFAULT_TASK_ARRAY_SIZE         2048
+// Size of the queue owned by each worker thread, work scheduled from a worker thread goes to the global queue once this is full
+#define LOCAL_TASK_ARRAY_SIZE           256
 #define MILLISEC_TO_NANOSEC             1000000
-#define TP_SEMAPHORE_TIMEOUT_MS         (100*MILLISEC_TO_NANOSEC) // The timespec value is in nanoseconds so need to multiply to get 100 MS
+
+// A new thread is added when all threads are busy and either more than this many items are waiting in the queue ...
+#define THREADPOOL_GROW_QUEUE_DEPTH_THRESHOLD   64
+// ... or no item has been dequeued for this long
+#define THREADPOOL_GROW_DEQUEUE_STALL_MS        100
+// Threads above min_thread_count exit after being idle for this long
+#define THREADPOOL_IDLE_THREAD_TIMEOUT_MS       10000
+
+// threadpool_linux_schedule_work_batch pushes the tasks of a batch in the global task queue in chunks of at most this many tasks
+#define THREADPOOL_TASK_BATCH_SIZE              64
+
+// Size of a cache line, the statistics counters published by a worker are kept on their own cache lines
+#define THREADPOOL_CACHE_LINE_SIZE              64
+
+// Every THREADPOOL_LANE_STARVATION_QUOTA-th task popped by a worker is taken from one of the lower priority lanes first
+// (the lower lanes take turns), so that a busy higher priority lane cannot starve them
+#define THREADPOOL_LANE_STARVATION_QUOTA        8
+
+// Timers are kept in a hierarchical timer wheel: level 0 has one slot per millisecond and every level above has slots
+// TIMER_WHEEL_SLOT_COUNT times wider than the level below. 6 levels of 64 slots cover 2^36 ms, more than any uint32_t delay.
+#define TIMER_WHEEL_SLOT_BITS           6
+#define TIMER_WHEEL_SLOT_COUNT          (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK           (TIMER_WHEEL_SLOT_COUNT - 1)
+#define TIMER_WHEEL_LEVEL_COUNT         6
+#define TIMER_WHEEL_NO_TICK             UINT64_MAX
 
 #define TASK_RESULT_VALUES  \
     TASK_NOT_USED,          \
@@ -57,120 +86,327 @@ MU_DEFINE_ENUM_STRINGS(TASK_RESULT, TASK_RESULT_VALUES)
 MU_DEFINE_ENUM(TIMER_STATE, TIMER_STATE_VALUES);
 MU_DEFINE_ENUM_STRINGS(TIMER_STATE, TIMER_STATE_VALUES)
 
+#define THREADPOOL_THREAD_STATE_VALUES  \
+    THREADPOOL_THREAD_NOT_USED,         \
+    THREADPOOL_THREAD_STARTING,         \
+    THREADPOOL_THREAD_RUNNING,          \
+    THREADPOOL_THREAD_EXITED            \
+
+MU_DEFINE_ENUM(THREADPOOL_THREAD_STATE, THREADPOOL_THREAD_STATE_VALUES);
+MU_DEFINE_ENUM_STRINGS(THREADPOOL_THREAD_STATE, THREADPOOL_THREAD_STATE_VALUES)
+
+MU_DEFINE_ENUM_STRINGS_WITHOUT_INVALID(THREADPOOL_PRIORITY, THREADPOOL_PRIORITY_VALUES)
+
+typedef struct TIMER_WHEEL_LINK_TAG
+{
+    struct TIMER_WHEEL_LINK_TAG* next;
+    struct TIMER_WHEEL_LINK_TAG* previous;
+} TIMER_WHEEL_LINK;
+
 typedef struct CUSTOM_TIMER_DATA_TAG
 {
     THREADPOOL_WORK_FUNCTION work_function;
     void* work_function_ctx;
     volatile_atomic int32_t timer_state; // TIMER_STATE
-    int64_t epoch_number;
+    volatile_atomic int32_t epoch_number;
+    // 1 while the work item that calls work_function is queued or executing, further expirations are skipped
+    volatile_atomic int32_t dispatch_pending;
+    // 1 for the THREADPOOL_TIMER + 1 while dispatch_pending is set
+    volatile_atomic int32_t ref_count;
+    int32_t dispatched_epoch_number;
+
+    // Protected by the timer lock of the threadpool
+    TIMER_WHEEL_LINK link; // next is NULL when the timer is not in the timer wheel
+    uint64_t expire_tick;
+    uint32_t period_ms;
+    uint32_t wheel_level;
+    uint32_t wheel_slot;
 } CUSTOM_TIMER_DATA;
 
 typedef struct THREADPOOL_TIMER_TAG
 {
-    timer_t time_id;
+    THANDLE(THREADPOOL) threadpool;
     CUSTOM_TIMER_DATA* custom_timer_data;
 } THREADPOOL_TIMER;
 
 THANDLE_TYPE_DEFINE(THREADPOOL_TIMER);
 
-typedef struct THREADPOOL_TASK_TAG
-{
-    THREADPOOL_WORK_FUNCTION work_function;
-    void* work_function_ctx;
-} THREADPOOL_TASK;
-
 typedef struct THREADPOOL_WORK_ITEM_TAG
 {
     THREADPOOL_WORK_FUNCTION work_function;
     void* work_function_ctx;
+    THREADPOOL_PRIORITY priority;
 } THREADPOOL_WORK_ITEM, *THREADPOOL_WORK_ITEM_HANDLE;
 
 THANDLE_TYPE_DEFINE(THREADPOOL_WORK_ITEM);
 
+typedef struct TIMER_WHEEL_TAG
+{
+    uint64_t current_tick; // the next tick (in ms) to be processed
+    uint64_t armed_tick; // the tick the timer fd is armed for, TIMER_WHEEL_NO_TICK if it is not armed
+    uint64_t occupied_slots[TIMER_WHEEL_LEVEL_COUNT]; // one bit for each non-empty slot
+    TIMER_WHEEL_LINK slots[TIMER_WHEEL_LEVEL_COUNT][TIMER_WHEEL_SLOT_COUNT];
+} TIMER_WHEEL;
+
+// Private copy of the statistics of a worker, only touched by the worker running in the slot
+typedef struct THREADPOOL_THREAD_COUNTER_VALUES_TAG
+{
+    int64_t executed_count[THREADPOOL_PRIORITY_COUNT];
+    int64_t total_wait_time_us[THREADPOOL_PRIORITY_COUNT];
+    int64_t wait_time_buckets[THREADPOOL_LATENCY_BUCKET_COUNT];
+    int64_t execution_time_buckets[THREADPOOL_LATENCY_BUCKET_COUNT];
+    int64_t total_execution_time_us;
+} THREADPOOL_THREAD_COUNTER_VALUES;
+
+// Statistics of a worker, only written by the worker running in the slot (by storing the values of its private copy) and summed over all the slots when read
+typedef struct THREADPOOL_THREAD_COUNTERS_TAG
+{
+    volatile_atomic int64_t executed_count[THREADPOOL_PRIORITY_COUNT];
+    volatile_atomic int64_t total_wait_time_us[THREADPOOL_PRIORITY_COUNT];
+    volatile_atomic int64_t wait_time_buckets[THREADPOOL_LATENCY_BUCKET_COUNT];
+    volatile_atomic int64_t execution_time_buckets[THREADPOOL_LATENCY_BUCKET_COUNT];
+    volatile_atomic int64_t total_execution_time_us;
+} THREADPOOL_THREAD_COUNTERS;
+
+typedef struct THREADPOOL_THREAD_TAG
+{
+    THREAD_HANDLE thread_handle;
+    // Handle of the thread that used the slot before it was reused, joined by the thread now using the slot
+    THREAD_HANDLE previous_thread_handle;
+    volatile_atomic int32_t state; // THREADPOOL_THREAD_STATE
+    struct THREADPOOL_TAG* threadpool;
+    // Only holds normal priority tasks, pushed and popped at the bottom by the thread using the slot, stolen from the top by the other threads
+    THREADPOOL_TASK_DEQUE local_queue;
+    // Number of tasks popped by the thread, only touched by the thread itself
+    uint32_t pop_count;
+    // Slot the thread tries to steal from first, only touched by the thread itself
+    uint32_t next_victim_index;
+    // Last dequeue time (in ms) the thread stored in the threadpool, only touched by the thread itself
+    int64_t last_published_dequeue_time_ms;
+    // The counters are kept across the threads that use the slot
+    THREADPOOL_THREAD_COUNTER_VALUES local_counters;
+    // The published counters are written for every task, the padding keeps them off the cache lines read by the other threads (the state and the local queue of the slot, the next slot)
+    uint8_t counters_leading_padding[THREADPOOL_CACHE_LINE_SIZE];
+    THREADPOOL_THREAD_COUNTERS counters;
+    uint8_t counters_trailing_padding[THREADPOOL_CACHE_LINE_SIZE];
+} THREADPOOL_THREAD;
+
+typedef struct THREADPOOL_LANE_TAG
+{
+    TQUEUE(THREADPOOL_TASK) task_queue;
+} THREADPOOL_LANE;
+
 typedef struct THREADPOOL_TAG
 {
     volatile_atomic int32_t stop_thread;
     uint32_t max_thread_count;
     uint32_t min_thread_count;
-    int32_t used_thread_count;
-
-    sem_t semaphore;
-
-    THREAD_HANDLE* thread_handle_array;
-    TQUEUE(THANDLE(THREADPOOL_WORK_ITEM)) task_queue;
+    EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS thread_params;
+    uint32_t thread_array_size;
+
+    volatile_atomic int32_t thread_count;
+    volatile_atomic int32_t active_thread_count;
+    volatile_atomic int64_t last_dequeue_time_ms;
+
+    // Idle threads wait on this value; it is incremented every time work is scheduled
+    volatile_atomic int32_t work_sequence;
+    volatile_atomic int32_t waiting_thread_count;
+
+    THREADPOOL_THREAD* thread_array;
+    // One global task queue for each THREADPOOL_PRIORITY, indexed by the priority
+    THREADPOOL_LANE lanes[THREADPOOL_PRIORITY_COUNT];
+
+    // The timer thread and the timer wheel are set up by the first threadpool_timer_start
+    call_once_t timer_lazy;
+    bool timer_thread_started;
+    int timer_fd;
+    THREAD_HANDLE timer_thread_handle;
+    volatile_atomic int32_t timer_thread_stop;
+    SRW_LOCK_LL timer_lock;
+    TIMER_WHEEL timer_wheel;
 } THREADPOOL;
 
 THANDLE_TYPE_DEFINE(THREADPOOL);
 
-// This gives us 1024 timers, plenty for us
-// We'll use the remaining bits as epoch to avoid ABA problems (even though ABA is highly unlikely, we'll make it even less likely :-))
-/* Codes_SRS_THREADPOOL_LINUX_01_003: [ 1024 timers shall be supported. ]*/
-#define TIMER_TABLE_INDEX_BITS 10
-#define TIMER_EPOCH_BITS ((sizeof(uintptr_t) * 8) - TIMER_TABLE_INDEX_BITS)
+// The thread slot of the threadpool worker running on the current thread (NULL for any other thread)
+static _Thread_local THREADPOOL_THREAD* current_threadpool_thread = NULL;
+
+static bool threadpool_try_retire_thread(THREADPOOL* threadpool, THREADPOOL_THREAD* threadpool_thread)
+{
+    bool result;
 
-#define TIMER_TABLE_SIZE (1 << TIMER_TABLE_INDEX_BITS)
-#define TIMER_TABLE_SIZE_MASK (TIMER_TABLE_SIZE - 1)
-#define TIMER_EPOCH_MAX ((1UL << TIMER_EPOCH_BITS) - 1)
+    int32_t current_thread_count = interlocked_add(&threadpool->thread_count, 0);
 
-#define TIMER_SIGVAL_TO_EPOCH(x) (x >> TIMER_TABLE_INDEX_BITS)
-#define TIMER_SIGVAL_TO_TIMER_INDEX(x) ((x) & TIMER_TABLE_SIZE_MASK)
+    /* Codes_SRS_THREADPOOL_LINUX_12_012: [ If the number of live threads is not greater than min_thread_count, the thread shall keep waiting for work. ]*/
+    if ((current_thread_count <= (int32_t)threadpool->min_thread_count) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_013: [ Otherwise threadpool_work_func shall decrement the number of live threads. ]*/
+        (interlocked_compare_exchange(&threadpool->thread_count, current_thread_count - 1, current_thread_count) != current_thread_count))
+    {
+        result = false;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_014: [ threadpool_work_func shall set the state of its thread slot to EXITED and return. ]*/
+        if (interlocked_compare_exchange(&threadpool_thread->state, THREADPOOL_THREAD_EXITED, THREADPOOL_THREAD_RUNNING) != THREADPOOL_THREAD_RUNNING)
+        {
+            // the thread that started us did not yet publish the slot, stay around
+            (void)interlocked_increment(&threadpool->thread_count);
+            result = false;
+        }
+        else
+        {
+            result = true;
+        }
+    }
 
-#define MAKE_SIGVAL_FROM_INDEX_AND_EPOCH(index, epoch) \
-    (void*)(uintptr_t)((index & TIMER_TABLE_SIZE_MASK) | (epoch << TIMER_TABLE_INDEX_BITS))
+    return result;
+}
 
-static volatile_atomic int64_t timer_epoch_number;
+static uint32_t threadpool_get_latency_bucket(int64_t latency_us)
+{
+    uint32_t bucket = 0;
 
-static call_once_t g_lazy = LAZY_INIT_NOT_DONE;
+    while ((latency_us > 0) && (bucket < THREADPOOL_LATENCY_BUCKET_COUNT - 1))
+    {
+        bucket++;
+        latency_us >>= 1;
+    }
 
-static CUSTOM_TIMER_DATA timer_table[TIMER_TABLE_SIZE];
+    return bucket;
+}
 
-static int do_init(void* params)
+static TQUEUE_PUSH_RESULT threadpool_push_task(THREADPOOL* threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_TASK* task)
 {
-    for (uint32_t i = 0; i < TIMER_TABLE_SIZE; i++)
+    TQUEUE_PUSH_RESULT result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_106: [ threadpool_push_task shall set the enqueue time of the task by calling timer_global_get_elapsed_us. ]*/
+    task->enqueue_time_us = (int64_t)timer_global_get_elapsed_us();
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_037: [ If priority is THREADPOOL_PRIORITY_NORMAL and the current thread is a worker thread of threadpool, threadpool_push_task shall push the task at the bottom of the local queue of the thread by calling threadpool_task_deque_push. ]*/
+    if ((priority != THREADPOOL_PRIORITY_NORMAL) ||
+        (current_threadpool_thread == NULL) ||
+        (current_threadpool_thread->threadpool != threadpool) ||
+        (threadpool_task_deque_push(&current_threadpool_thread->local_queue, task) != THREADPOOL_TASK_DEQUE_OK))
     {
-        /* Codes_SRS_THREADPOOL_LINUX_01_004: [ do_init shall initialize the state for each timer to NOT_USED. ]*/
-        (void)interlocked_exchange(&timer_table[i].timer_state, TIMER_NOT_USED);
+        /* Codes_SRS_THREADPOOL_LINUX_12_038: [ Otherwise, or if the local queue is full, threadpool_push_task shall push the task in the global task queue of the priority lane by calling TQUEUE_PUSH(THREADPOOL_TASK). ]*/
+        result = TQUEUE_PUSH(THREADPOOL_TASK)(threadpool->lanes[priority].task_queue, task, NULL);
+    }
+    else
+    {
+        result = TQUEUE_PUSH_OK;
     }
 
-    /* Codes_SRS_THREADPOOL_LINUX_07_099: [ do_init shall succeed and return 0. ]*/
-    return 0;
+    return result;
 }
 
-static void on_timer_callback(sigval_t timer_data)
+static TQUEUE_POP_RESULT threadpool_pop_task_from_lane(THREADPOOL* threadpool, THREADPOOL_THREAD* threadpool_thread, THREADPOOL_PRIORITY priority, THREADPOOL_TASK* task)
 {
-    /* Codes_SRS_THREADPOOL_LINUX_45_002: [ on_timer_callback shall extract from the lower 10 bits of timer_data.sival_ptr the information indicating which timer table entry is being triggered. ]*/
-    uint32_t timer_index = TIMER_SIGVAL_TO_TIMER_INDEX((uintptr_t)timer_data.sival_ptr);
+    TQUEUE_POP_RESULT result;
+
+    if (priority != THREADPOOL_PRIORITY_NORMAL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_107: [ For the high and low priority lanes, threadpool_pop_task shall pop a task from the global task queue of the lane by calling TQUEUE_POP(THREADPOOL_TASK). ]*/
+        result = TQUEUE_POP(THREADPOOL_TASK)(threadpool->lanes[priority].task_queue, task, NULL, NULL, NULL);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_039: [ For the normal priority lane, threadpool_pop_task shall pop the newest task from the bottom of the local queue of the thread by calling threadpool_task_deque_pop. ]*/
+        if (threadpool_task_deque_pop(&threadpool_thread->local_queue, task) == THREADPOOL_TASK_DEQUE_OK)
+        {
+            result = TQUEUE_POP_OK;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_040: [ If the local queue is empty, threadpool_pop_task shall pop a task from the global task queue of the normal priority lane by calling TQUEUE_POP(THREADPOOL_TASK). ]*/
+            result = TQUEUE_POP(THREADPOOL_TASK)(threadpool->lanes[THREADPOOL_PRIORITY_NORMAL].task_queue, task, NULL, NULL, NULL);
+            if (result != TQUEUE_POP_OK)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_041: [ If the global task queue is empty, threadpool_pop_task shall try to steal the oldest task from the top of the local queue of each other thread slot in the RUNNING state by calling threadpool_task_deque_steal, starting with the slot after the one it last stole from. ]*/
+                uint32_t victim_index = threadpool_thread->next_victim_index;
+                for (uint32_t i = 0; i < threadpool->thread_array_size; i++)
+                {
+                    THREADPOOL_THREAD* victim = &threadpool->thread_array[victim_index];
+                    victim_index = (victim_index + 1) % threadpool->thread_array_size;
+
+                    // slots without a running thread have nothing to steal: a thread only exits once its local queue is empty
+                    if ((victim != threadpool_thread) &&
+                        (interlocked_add(&victim->state, 0) == THREADPOOL_THREAD_RUNNING) &&
+                        (threadpool_task_deque_steal(&victim->local_queue, task) == THREADPOOL_TASK_DEQUE_OK))
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_12_149: [ After a successful steal, threadpool_pop_task shall remember the slot after the victim as the first slot to steal from next time. ]*/
+                        threadpool_thread->next_victim_index = victim_index;
+                        result = TQUEUE_POP_OK;
+                        break;
+                    }
+                }
+            }
+        }
+    }
 
-    /* Codes_SRS_THREADPOOL_LINUX_01_012: [ on_timer_callback shall use the rest of the higher bits of timer_data.sival_ptr as timer epoch. ]*/
-    uint64_t timer_epoch = TIMER_SIGVAL_TO_EPOCH((uintptr_t)timer_data.sival_ptr);
+    return result;
+}
 
-    CUSTOM_TIMER_DATA* timer_instance = &timer_table[timer_index];
+static TQUEUE_POP_RESULT threadpool_pop_task(THREADPOOL* threadpool, THREADPOOL_THREAD* threadpool_thread, THREADPOOL_TASK* task, THREADPOOL_PRIORITY* priority)
+{
+    THREADPOOL_PRIORITY first_lane;
 
-    /* Codes_SRS_THREADPOOL_LINUX_01_008: [ If the timer is in the state ARMED: ]*/
-    /* Codes_SRS_THREADPOOL_LINUX_01_007: [ on_timer_callback shall transition it to CALLING_CALLBACK. ]*/
-    if (interlocked_compare_exchange(&timer_instance->timer_state, TIMER_CALLING_CALLBACK, TIMER_ARMED) == TIMER_ARMED)
+    if ((threadpool_thread->pop_count % THREADPOOL_LANE_STARVATION_QUOTA) == (THREADPOOL_LANE_STARVATION_QUOTA - 1))
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_108: [ Every THREADPOOL_LANE_STARVATION_QUOTA-th pop of the thread, threadpool_pop_task shall first try one of the lanes below THREADPOOL_PRIORITY_HIGH, the lower lanes taking turns. ]*/
+        first_lane = (THREADPOOL_PRIORITY)(1 + ((threadpool_thread->pop_count / THREADPOOL_LANE_STARVATION_QUOTA) % (THREADPOOL_PRIORITY_COUNT - 1)));
+    }
+    else
+    {
+        first_lane = THREADPOOL_PRIORITY_HIGH;
+    }
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_109: [ threadpool_pop_task shall pop a task from the lanes in priority order (high, normal, low), stopping at the first lane that has a task. ]*/
+    THREADPOOL_PRIORITY lane = first_lane;
+    TQUEUE_POP_RESULT result = threadpool_pop_task_from_lane(threadpool, threadpool_thread, lane, task);
+    for (uint32_t i = 0; (result != TQUEUE_POP_OK) && (i < THREADPOOL_PRIORITY_COUNT); i++)
     {
-        if (timer_epoch == timer_instance->epoch_number)
+        if (i != (uint32_t)first_lane)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_45_004: [ If the timer epoch of the timer table entry is the same like the timer epoch in timer_data.sival_ptr, on_timer_callback shall call the timer's work_function with work_function_ctx. ]*/
-            timer_instance->work_function(timer_instance->work_function_ctx);
+            lane = (THREADPOOL_PRIORITY)i;
+            result = threadpool_pop_task_from_lane(threadpool, threadpool_thread, lane, task);
         }
+    }
 
-        /* Codes_SRS_THREADPOOL_LINUX_01_009: [ on_timer_callback shall transition it to ARMED. ]*/
-        (void)InterlockedHL_SetAndWake(&timer_instance->timer_state, TIMER_ARMED);
+    if (result == TQUEUE_POP_OK)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_110: [ If a task was popped, threadpool_pop_task shall increment the number of tasks popped by the thread and return the priority of the lane the task was popped from. ]*/
+        threadpool_thread->pop_count++;
+        *priority = lane;
+    }
+
+    return result;
+}
+
+static void threadpool_join_thread_handle(THREAD_HANDLE thread_handle)
+{
+    int dont_care;
+    if (ThreadAPI_Join(thread_handle, &dont_care) != THREADAPI_OK)
+    {
+        LogError("Failure joining thread %p", thread_handle);
+    }
+    else
+    {
+        // Everything Okay.
     }
 }
 
-static void THANDLE_THREADPOOL_WORK_ITEM_copy_item(void* context, THANDLE(THREADPOOL_WORK_ITEM)* dst, THANDLE(THREADPOOL_WORK_ITEM)* src)
+static void threadpool_join_thread(THREADPOOL_THREAD* threadpool_thread)
 {
-    (void)context;
-    THANDLE_INITIALIZE(THREADPOOL_WORK_ITEM)(dst, *src);
+    threadpool_join_thread_handle(threadpool_thread->thread_handle);
 }
 
-static void THANDLE_THREADPOOL_WORK_ITEM_dispose(void* context, THANDLE(THREADPOOL_WORK_ITEM)* item)
+static void threadpool_join_previous_thread(THREADPOOL_THREAD* threadpool_thread)
 {
-    (void)context;
-    THANDLE_ASSIGN(THREADPOOL_WORK_ITEM)(item, NULL);
+    if (threadpool_thread->previous_thread_handle != NULL)
+    {
+        threadpool_join_thread_handle(threadpool_thread->previous_thread_handle);
+        threadpool_thread->previous_thread_handle = NULL;
+    }
 }
 
 static int threadpool_work_func(void* param)
@@ -182,530 +418,1747 @@ static int threadpool_work_func(void* param)
     }
     else
     {
-        struct timespec ts;
-        THREADPOOL* threadpool = param;
+        THREADPOOL_THREAD* threadpool_thread = param;
+        THREADPOOL* threadpool = threadpool_thread->threadpool;
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_036: [ threadpool_work_func shall remember the thread slot of the current thread so that work scheduled from work items goes to the local queue of the thread. ]*/
+        current_threadpool_thread = threadpool_thread;
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_147: [ If the thread slot holds the handle of the thread that previously used the slot, threadpool_work_func shall join it by calling ThreadAPI_Join and clear it from the slot. ]*/
+        threadpool_join_previous_thread(threadpool_thread);
 
-        do
+        while (1)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_07_074: [ threadpool_work_func shall get the real time by calling clock_gettime to set the waiting time for semaphore. ]*/
-            if (clock_gettime(CLOCK_REALTIME, &ts) == -1)
-            {
-                /* Codes_SRS_THREADPOOL_LINUX_07_088: [ If clock_gettime fails, threadpool_work_func shall run the loop again. ]*/
-                LogError("Failure getting time from clock_gettime");
-            }
-            else
+            THREADPOOL_TASK task;
+            THREADPOOL_PRIORITY priority;
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_026: [ threadpool_work_func shall read the current value of the work sequence before draining the task queue. ]*/
+            int32_t current_work_sequence = interlocked_add(&threadpool->work_sequence, 0);
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_008: [ threadpool_work_func shall increment the number of active threads before draining the task queue and decrement it after the queue has been drained. ]*/
+            (void)interlocked_increment(&threadpool->active_thread_count);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_016: [ threadpool_work_func shall pop a task by calling threadpool_pop_task. ]*/
+            /* Codes_SRS_THREADPOOL_LINUX_01_017: [ If the pop returns TQUEUE_POP_OK: ]*/
+            // the time a task finished executing is also the dequeue time of the next task of the drain, so the time is read once per task
+            int64_t current_time_us = -1;
+            while (threadpool_pop_task(threadpool, threadpool_thread, &task, &priority) == TQUEUE_POP_OK)
             {
-                ts.tv_nsec += TP_SEMAPHORE_TIMEOUT_MS;
+                THREADPOOL_THREAD_COUNTER_VALUES* local_counters = &threadpool_thread->local_counters;
+                THREADPOOL_THREAD_COUNTERS* counters = &threadpool_thread->counters;
 
-                /* Codes_SRS_THREADPOOL_LINUX_07_075: [ threadpool_work_func shall wait on the semaphore with a time limit. ]*/
-                if (sem_timedwait(&threadpool->semaphore, &ts) != 0)
+                /* Codes_SRS_THREADPOOL_LINUX_12_009: [ For the first task of a drain threadpool_work_func shall record the time of the dequeue by calling timer_global_get_elapsed_us, for the other tasks it shall use the time at which the previous task finished executing. ]*/
+                if (current_time_us < 0)
                 {
-                    /* Codes_SRS_THREADPOOL_LINUX_07_087: [ If sem_timedwait fails, threadpool_work_func shall timeout and run the loop again. ]*/
+                    current_time_us = (int64_t)timer_global_get_elapsed_us();
                 }
-                else
+                int64_t start_time_us = current_time_us;
+
+                /* Codes_SRS_THREADPOOL_LINUX_12_151: [ If the time of the dequeue in milliseconds differs from the last one stored by the thread slot, threadpool_work_func shall store it in the last dequeue time of the threadpool by calling interlocked_exchange_64. ]*/
+                int64_t start_time_ms = start_time_us / 1000;
+                if (start_time_ms != threadpool_thread->last_published_dequeue_time_ms)
                 {
-                    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item;
+                    threadpool_thread->last_published_dequeue_time_ms = start_time_ms;
+                    (void)interlocked_exchange_64(&threadpool->last_dequeue_time_ms, start_time_ms);
+                }
 
-                    /* Codes_SRS_THREADPOOL_LINUX_01_016: [ threadpool_work_func shall pop an item from the task queue by calling TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM)). ]*/
-                    /* Codes_SRS_THREADPOOL_LINUX_01_017: [ If the pop returns TQUEUE_POP_OK: ]*/
-                    while (TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM))(threadpool->task_queue, &threadpool_work_item, NULL, NULL, NULL) == TQUEUE_POP_OK)
-                    {
-                        /* Codes_SRS_THREADPOOL_LINUX_07_084: [ threadpool_work_func shall execute the work_function with work_function_ctx. ]*/
-                        threadpool_work_item->work_function(threadpool_work_item->work_function_ctx);
+                /* Codes_SRS_THREADPOOL_LINUX_12_111: [ threadpool_work_func shall increment the executed count of the lane of the task and add the time the task waited in the queue to the total wait time of the lane in the private counters of its thread slot and store the new values in the published counters of the slot by calling interlocked_exchange_64. ]*/
+                int64_t wait_time_us = start_time_us - task.enqueue_time_us;
+                if (wait_time_us < 0)
+                {
+                    wait_time_us = 0;
+                }
+                local_counters->executed_count[priority]++;
+                local_counters->total_wait_time_us[priority] += wait_time_us;
+                (void)interlocked_exchange_64(&counters->executed_count[priority], local_counters->executed_count[priority]);
+                (void)interlocked_exchange_64(&counters->total_wait_time_us[priority], local_counters->total_wait_time_us[priority]);
+
+                /* Codes_SRS_THREADPOOL_LINUX_12_137: [ threadpool_work_func shall count the time the task waited in the queue in the wait time histogram of the private counters of its thread slot and store the new value of the bucket in the published counters of the slot by calling interlocked_exchange_64. ]*/
+                uint32_t wait_time_bucket = threadpool_get_latency_bucket(wait_time_us);
+                local_counters->wait_time_buckets[wait_time_bucket]++;
+                (void)interlocked_exchange_64(&counters->wait_time_buckets[wait_time_bucket], local_counters->wait_time_buckets[wait_time_bucket]);
+
+                /* Codes_SRS_THREADPOOL_LINUX_07_084: [ threadpool_work_func shall execute the work_function with work_function_ctx. ]*/
+                task.work_function(task.work_function_ctx);
+
+                /* Codes_SRS_THREADPOOL_LINUX_12_138: [ After the work_function returns, threadpool_work_func shall obtain the execution time of the task by calling timer_global_get_elapsed_us, count it in the execution time histogram and add it to the total execution time of the private counters of its thread slot and store the new values in the published counters of the slot by calling interlocked_exchange_64. ]*/
+                current_time_us = (int64_t)timer_global_get_elapsed_us();
+                int64_t execution_time_us = current_time_us - start_time_us;
+                if (execution_time_us < 0)
+                {
+                    execution_time_us = 0;
+                    current_time_us = start_time_us;
+                }
+                uint32_t execution_time_bucket = threadpool_get_latency_bucket(execution_time_us);
+                local_counters->execution_time_buckets[execution_time_bucket]++;
+                local_counters->total_execution_time_us += execution_time_us;
+                (void)interlocked_exchange_64(&counters->execution_time_buckets[execution_time_bucket], local_counters->execution_time_buckets[execution_time_bucket]);
+                (void)interlocked_exchange_64(&counters->total_execution_time_us, local_counters->total_execution_time_us);
+            }
 
-                        /* Codes_SRS_THREADPOOL_LINUX_01_018: [ threadpool_work_func shall release the reference to the work item. ]*/
-                        THANDLE_ASSIGN(THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
-                    }
+            (void)interlocked_decrement(&threadpool->active_thread_count);
+
+            /* Codes_SRS_THREADPOOL_LINUX_07_085: [ threadpool_work_func shall loop until the flag to stop the threads is not set to 1. ]*/
+            if (interlocked_add(&threadpool->stop_thread, 0) == 1)
+            {
+                break;
+            }
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_027: [ If the number of live threads is greater than min_thread_count, threadpool_work_func shall use THREADPOOL_IDLE_THREAD_TIMEOUT_MS as wait timeout, otherwise it shall wait without a timeout (UINT32_MAX). ]*/
+            uint32_t timeout_ms = (interlocked_add(&threadpool->thread_count, 0) > (int32_t)threadpool->min_thread_count) ? THREADPOOL_IDLE_THREAD_TIMEOUT_MS : UINT32_MAX;
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_028: [ threadpool_work_func shall increment the number of waiting threads, wait for the work sequence to change from the value read before draining the queue by calling wait_on_address and then decrement the number of waiting threads. ]*/
+            (void)interlocked_increment(&threadpool->waiting_thread_count);
+            WAIT_ON_ADDRESS_RESULT wait_result = wait_on_address(&threadpool->work_sequence, current_work_sequence, timeout_ms);
+            (void)interlocked_decrement(&threadpool->waiting_thread_count);
+
+            if (wait_result == WAIT_ON_ADDRESS_TIMEOUT)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_011: [ If wait_on_address returns WAIT_ON_ADDRESS_TIMEOUT: ]*/
+                if (threadpool_try_retire_thread(threadpool, threadpool_thread))
+                {
+                    break;
                 }
             }
-        /* Codes_SRS_THREADPOOL_LINUX_07_085: [ threadpool_work_func shall loop until the flag to stop the threads is not set to 1. ]*/
-        } while (interlocked_add(&threadpool->stop_thread, 0) != 1);
+            else if (wait_result == WAIT_ON_ADDRESS_ERROR)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_029: [ If wait_on_address returns WAIT_ON_ADDRESS_ERROR, threadpool_work_func shall run the loop again. ]*/
+                LogError("wait_on_address(&threadpool->work_sequence=%p, current_work_sequence=%" PRId32 ", timeout_ms=%" PRIu32 ") failed",
+                    &threadpool->work_sequence, current_work_sequence, timeout_ms);
+            }
+            else
+            {
+                // work was signalled (or the value changed before we got to wait), go drain the queue
+            }
+        }
+
+        current_threadpool_thread = NULL;
     }
     return 0;
 }
 
-static void threadpool_dispose(THREADPOOL* threadpool)
+static void threadpool_signal_work(THREADPOOL* threadpool, uint32_t work_item_count)
 {
-    /* Codes_SRS_THREADPOOL_LINUX_07_089: [ threadpool_dispose shall signal all threads to return. ]*/
-    (void)InterlockedHL_SetAndWakeAll(&threadpool->stop_thread, 1);
-    for (uint32_t index = 0; index < threadpool->used_thread_count; index++)
+    /* Codes_SRS_THREADPOOL_LINUX_12_030: [ threadpool_signal_work shall increment the work sequence. ]*/
+    (void)interlocked_increment(&threadpool->work_sequence);
+
+    int32_t waiting_thread_count = interlocked_add(&threadpool->waiting_thread_count, 0);
+    if (waiting_thread_count > 0)
     {
-        int dont_care;
-        /* Codes_SRS_THREADPOOL_LINUX_07_027: [ threadpool_dispose shall join all threads in the threadpool. ]*/
-        if (ThreadAPI_Join(threadpool->thread_handle_array[index], &dont_care) != THREADAPI_OK)
+        if ((work_item_count > 1) && (work_item_count >= (uint32_t)waiting_thread_count))
         {
-            LogError("Failure joining thread number %" PRIu32 "", index);
+            /* Codes_SRS_THREADPOOL_LINUX_12_082: [ If work_item_count is greater than 1 and not less than the number of waiting threads, threadpool_signal_work shall wake all the waiting threads by calling wake_by_address_all. ]*/
+            wake_by_address_all(&threadpool->work_sequence);
         }
         else
         {
-            // Everything Okay.
+            /* Codes_SRS_THREADPOOL_LINUX_12_031: [ Otherwise, if there are threads waiting for work, threadpool_signal_work shall wake one of them for each of the work_item_count work items by calling wake_by_address_single. ]*/
+            for (uint32_t i = 0; i < work_item_count; i++)
+            {
+                wake_by_address_single(&threadpool->work_sequence);
+            }
         }
     }
+}
 
-    /* Codes_SRS_THREADPOOL_LINUX_07_016: [ threadpool_dispose shall free the memory allocated in threadpool_create. ]*/
-    TQUEUE_ASSIGN(THANDLE(THREADPOOL_WORK_ITEM))(&threadpool->task_queue, NULL);
-    free(threadpool->thread_handle_array);
+static void threadpool_stop_threads(THREADPOOL* threadpool)
+{
+    (void)InterlockedHL_SetAndWakeAll(&threadpool->stop_thread, 1);
 
-    /* Codes_SRS_THREADPOOL_LINUX_07_014: [ threadpool_dispose shall destroy the semphore by calling sem_destroy. ]*/
-    sem_destroy(&threadpool->semaphore);
+    /* Codes_SRS_THREADPOOL_LINUX_12_032: [ threadpool_stop_threads shall increment the work sequence and wake all waiting threads by calling wake_by_address_all. ]*/
+    (void)interlocked_increment(&threadpool->work_sequence);
+    wake_by_address_all(&threadpool->work_sequence);
 }
 
-THANDLE(THREADPOOL) threadpool_create(EXECUTION_ENGINE_HANDLE execution_engine)
+static void threadpool_get_thread_create_options(THREADPOOL* threadpool, const char* name, THREADAPI_CREATE_OPTIONS* options)
 {
-    THREADPOOL* result = NULL;
+    options->name = name;
+    options->stack_size = threadpool->thread_params.thread_stack_size;
+    options->cpus = NULL;
+    options->cpu_count = 0;
+    options->use_numa_node = threadpool->thread_params.pin_to_numa_node;
+    options->numa_node = threadpool->thread_params.numa_node;
+}
 
-    /* Codes_SRS_THREADPOOL_LINUX_07_002: [ If execution_engine is NULL, threadpool_create shall fail and return NULL. ]*/
-    if (execution_engine == NULL)
+static int threadpool_start_thread(THREADPOOL* threadpool, THREADPOOL_THREAD* threadpool_thread)
+{
+    int result;
+
+    threadpool_thread->threadpool = threadpool;
+    threadpool_thread->pop_count = 0;
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_146: [ The worker threads shall be created with the name tp_worker_<slot index>, the thread stack size from the thread parameters and, if pin_to_numa_node is true, restricted to the CPUs of numa_node. ]*/
+    char thread_name[THREADAPI_MAX_THREAD_NAME_LENGTH + 1];
+    (void)snprintf(thread_name, sizeof(thread_name), "tp_worker_%" PRIu32, (uint32_t)(threadpool_thread - threadpool->thread_array));
+    THREADAPI_CREATE_OPTIONS options;
+    threadpool_get_thread_create_options(threadpool, thread_name, &options);
+
+    if (ThreadAPI_CreateEx(&threadpool_thread->thread_handle, threadpool_work_func, threadpool_thread, &options) != THREADAPI_OK)
     {
-        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine: %p", execution_engine);
-        result = NULL;
+        LogError("ThreadAPI_CreateEx(&threadpool_thread->thread_handle=%p, threadpool_work_func=%p, threadpool_thread=%p, options.name=%s) failed",
+            &threadpool_thread->thread_handle, threadpool_work_func, threadpool_thread, thread_name);
+        (void)interlocked_exchange(&threadpool_thread->state, THREADPOOL_THREAD_NOT_USED);
+        result = MU_FAILURE;
     }
     else
     {
-        /* Codes_SRS_THREADPOOL_LINUX_07_001: [ threadpool_create shall allocate memory for a threadpool object and on success return a non-NULL handle to it. ]*/
-        result = THANDLE_MALLOC(THREADPOOL)(threadpool_dispose);
-        if (result == NULL)
+        (void)interlocked_exchange(&threadpool_thread->state, THREADPOOL_THREAD_RUNNING);
+        result = 0;
+    }
+
+    return result;
+}
+
+static void threadpool_add_thread_if_needed(THREADPOOL* threadpool)
+{
+    int32_t current_thread_count = interlocked_add(&threadpool->thread_count, 0);
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_12_015: [ If the number of live threads is already equal to the size of the thread array, no thread shall be added. ]*/
+        (current_thread_count >= (int32_t)threadpool->thread_array_size) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_016: [ If not all live threads are busy executing work items, no thread shall be added. ]*/
+        (interlocked_add(&threadpool->active_thread_count, 0) < current_thread_count)
+        )
+    {
+        // nothing to do
+    }
+    else
+    {
+        bool should_add_thread;
+        int64_t queue_depth = 0;
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_017: [ If the number of tasks in the global task queues of all the lanes obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK) plus the number of tasks in the local queues of the thread slots in the RUNNING state obtained by calling threadpool_task_deque_get_volatile_count is greater than THREADPOOL_GROW_QUEUE_DEPTH_THRESHOLD or if the queues are not empty and no item was dequeued in the last THREADPOOL_GROW_DEQUEUE_STALL_MS milliseconds, a new thread shall be added: ]*/
+        for (uint32_t i = 0; i < THREADPOOL_PRIORITY_COUNT; i++)
         {
-            LogError("Failure allocating THREADPOOL structure");
+            queue_depth += TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(threadpool->lanes[i].task_queue);
         }
-        else
+
+        // work scheduled from work items sits in the local queues, while its owner is blocked only a new thread stealing it can run it
+        for (uint32_t i = 0; i < threadpool->thread_array_size; i++)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_07_004: [ threadpool_create shall get the min_thread_count and max_thread_count thread parameters from the execution_engine. ]*/
-            const EXECUTION_ENGINE_PARAMETERS* param = execution_engine_linux_get_parameters(execution_engine);
+            if (interlocked_add(&threadpool->thread_array[i].state, 0) == THREADPOOL_THREAD_RUNNING)
+            {
+                queue_depth += threadpool_task_deque_get_volatile_count(&threadpool->thread_array[i].local_queue);
+            }
+        }
 
-            result->min_thread_count = param->min_thread_count;
-            result->max_thread_count = param->max_thread_count;
-            result->used_thread_count = result->min_thread_count;
+        if (queue_depth > THREADPOOL_GROW_QUEUE_DEPTH_THRESHOLD)
+        {
+            should_add_thread = true;
+        }
+        else if (queue_depth > 0)
+        {
+            int64_t now_ms = (int64_t)timer_global_get_elapsed_ms();
+            should_add_thread = (now_ms - interlocked_add_64(&threadpool->last_dequeue_time_ms, 0) > THREADPOOL_GROW_DEQUEUE_STALL_MS);
+        }
+        else
+        {
+            should_add_thread = false;
+        }
 
-            /* Codes_SRS_THREADPOOL_LINUX_07_005: [ threadpool_create shall allocate memory for an array of thread handles of size min_thread_count and on success return a non-NULL handle to it. ]*/
-            result->thread_handle_array = malloc_2(result->used_thread_count, sizeof(THREAD_HANDLE));
-            if (result->thread_handle_array == NULL)
+        if (should_add_thread)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_018: [ The number of live threads shall be incremented. ]*/
+            if (interlocked_compare_exchange(&threadpool->thread_count, current_thread_count + 1, current_thread_count) != current_thread_count)
             {
-                /* Codes_SRS_THREADPOOL_LINUX_07_011: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
-                LogError("Failure malloc_2(result->used_thread_count: %" PRIu32 ", sizeof(THREAD_HANDLE)): %zu", result->used_thread_count, sizeof(THREAD_HANDLE));
+                // another producer is adding a thread, let it do the job
             }
             else
             {
-                /* Codes_SRS_THREADPOOL_LINUX_07_009: [ threadpool_create shall create a shared semaphore with initialized value zero. ]*/
-                if (sem_init(&result->semaphore, 0 , 0) != 0)
+                uint32_t i;
+
+                /* Codes_SRS_THREADPOOL_LINUX_12_019: [ A thread slot in state NOT_USED or EXITED shall be found in the thread array and marked as STARTING. ]*/
+                for (i = 0; i < threadpool->thread_array_size; i++)
                 {
-                    /* Codes_SRS_THREADPOOL_LINUX_07_011: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
-                    LogError("Failure creating sem_init");
+                    int32_t current_state = interlocked_add(&threadpool->thread_array[i].state, 0);
+                    if (
+                        ((current_state == THREADPOOL_THREAD_NOT_USED) || (current_state == THREADPOOL_THREAD_EXITED)) &&
+                        (interlocked_compare_exchange(&threadpool->thread_array[i].state, THREADPOOL_THREAD_STARTING, current_state) == current_state)
+                        )
+                    {
+                        if (current_state == THREADPOOL_THREAD_EXITED)
+                        {
+                            /* Codes_SRS_THREADPOOL_LINUX_12_020: [ If the slot was in state EXITED, the handle of the thread that previously used it shall be kept in the slot so that the new thread joins it. ]*/
+                            // joining here would block the producer (or the timer thread holding the timer lock) until the old thread is gone
+                            threadpool->thread_array[i].previous_thread_handle = threadpool->thread_array[i].thread_handle;
+                        }
+                        break;
+                    }
+                }
+
+                if (i == threadpool->thread_array_size)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_12_022: [ If no thread slot is available or starting the thread fails, the number of live threads shall be decremented. ]*/
+                    LogWarning("No thread slot available, a retiring thread has not yet released its slot");
+                    (void)interlocked_decrement(&threadpool->thread_count);
                 }
                 else
                 {
-                    /* Codes_SRS_THREADPOOL_LINUX_01_013: [ threadpool_create shall create a queue of threadpool work items by calling TQUEUE_CREATE(THANDLE(THREADPOOL_WORK_ITEM)) with initial size 2048 and max size UINT32_MAX. ]*/
-                    TQUEUE(THANDLE(THREADPOOL_WORK_ITEM)) temp_task_queue = TQUEUE_CREATE(THANDLE(THREADPOOL_WORK_ITEM))(DEFAULT_TASK_ARRAY_SIZE, UINT32_MAX, THANDLE_THREADPOOL_WORK_ITEM_copy_item, THANDLE_THREADPOOL_WORK_ITEM_dispose, NULL);
-                    if (temp_task_queue == NULL)
+                    /* Codes_SRS_THREADPOOL_LINUX_12_021: [ The new thread shall be started by calling ThreadAPI_CreateEx with the same options as the worker threads started by threadpool_create and the slot shall be marked as RUNNING. ]*/
+                    if (threadpool_start_thread(threadpool, &threadpool->thread_array[i]) != 0)
                     {
-                        LogError("TQUEUE_CREATE(THANDLE(THREADPOOL_WORK_ITEM))(DEFAULT_TASK_ARRAY_SIZE=%d, UINT32_MAX, THANDLE_THREADPOOL_WORK_ITEM_copy_item, THANDLE_THREADPOOL_WORK_ITEM_dispose, NULL) failed", DEFAULT_TASK_ARRAY_SIZE);
+                        /* Codes_SRS_THREADPOOL_LINUX_12_022: [ If no thread slot is available or starting the thread fails, the number of live threads shall be decremented. ]*/
+                        (void)interlocked_decrement(&threadpool->thread_count);
                     }
                     else
                     {
-                        TQUEUE_INITIALIZE_MOVE(THANDLE(THREADPOOL_WORK_ITEM))(&result->task_queue, &temp_task_queue);
-                        {
-                            (void)interlocked_exchange(&result->stop_thread, 0);
-
-                            uint32_t index;
-                            for (index = 0; index < result->used_thread_count; index++)
-                            {
-                                /* Codes_SRS_THREADPOOL_LINUX_07_020: [ threadpool_create shall create min_thread_count number of threads for threadpool using ThreadAPI_Create. ]*/
-                                if (ThreadAPI_Create(&result->thread_handle_array[index], threadpool_work_func, result) != THREADAPI_OK)
-                                {
-                                    /* Codes_SRS_THREADPOOL_LINUX_07_011: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
-                                    LogError("Failure creating thread %" PRIu32 "", index);
-                                    break;
-                                }
-                            }
-
-                            /* Codes_SRS_THREADPOOL_LINUX_07_022: [ If one of the thread creation fails, threadpool_create shall fail, terminate all threads already created and return NULL. ]*/
-                            if (index < result->used_thread_count)
-                            {
-                                LogError("Failed starting one of the threadpool threads");
-                            }
-                            else
-                            {
-                                goto all_ok;
-                            }
-
-                            (void)interlocked_exchange(&result->stop_thread, 1);
-                            for (uint32_t inner = 0; inner < index; inner++)
-                            {
-                                int dont_care;
-                                if (ThreadAPI_Join(result->thread_handle_array[inner], &dont_care) != THREADAPI_OK)
-                                {
-                                    LogError("Failure joining thread number %" PRIu32 "", inner);
-                                }
-                                else
-                                {
-                                    // do nothing
-                                }
-                            }
-
-                            TQUEUE_ASSIGN(THANDLE(THREADPOOL_WORK_ITEM))(&result->task_queue, NULL);
-                        }
+                        LogVerbose("threadpool=%p grew to %" PRId32 " threads", threadpool, current_thread_count + 1);
                     }
                 }
-                free(result->thread_handle_array);
             }
-            THANDLE_FREE(THREADPOOL)(result);
-            result = NULL;
+        }
+        else
+        {
+            // work is flowing, no need for more threads
         }
     }
-all_ok:
-    return result;
 }
 
-int threadpool_schedule_work(THANDLE(THREADPOOL) threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+static void timer_wheel_link_initialize(TIMER_WHEEL_LINK* head)
 {
-    int result;
-    if (
-        /* Codes_SRS_THREADPOOL_LINUX_07_029: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-        threadpool == NULL ||
-        /* Codes_SRS_THREADPOOL_LINUX_07_030: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-        work_function == NULL)
+    head->next = head;
+    head->previous = head;
+}
+
+static void timer_wheel_link_insert_tail(TIMER_WHEEL_LINK* head, TIMER_WHEEL_LINK* link)
+{
+    link->next = head;
+    link->previous = head->previous;
+    head->previous->next = link;
+    head->previous = link;
+}
+
+static void timer_wheel_link_remove(TIMER_WHEEL_LINK* link)
+{
+    link->previous->next = link->next;
+    link->next->previous = link->previous;
+    link->next = NULL;
+    link->previous = NULL;
+}
+
+static void timer_wheel_link_move(TIMER_WHEEL_LINK* destination_head, TIMER_WHEEL_LINK* source_head)
+{
+    if (source_head->next == source_head)
     {
-        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_WORK_FUNCTION work_function: %p, void* work_function_context: %p", threadpool, work_function, work_function_context);
-        result = MU_FAILURE;
+        timer_wheel_link_initialize(destination_head);
     }
     else
     {
-        THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
+        destination_head->next = source_head->next;
+        destination_head->previous = source_head->previous;
+        destination_head->next->previous = destination_head;
+        destination_head->previous->next = destination_head;
+        timer_wheel_link_initialize(source_head);
+    }
+}
 
-        /* Codes_SRS_THREADPOOL_LINUX_01_014: [ threadpool_schedule_work shall create a new THANDLE(THREADPOOL_WORK_ITEM) and save the work_function and work_function_context in it. ]*/
-        THREADPOOL_WORK_ITEM* threadpool_work_item_ptr = THANDLE_MALLOC(THREADPOOL_WORK_ITEM)(NULL);
-        if (threadpool_work_item_ptr == NULL)
+static void timer_wheel_initialize(TIMER_WHEEL* timer_wheel, uint64_t current_tick)
+{
+    timer_wheel->current_tick = current_tick;
+    timer_wheel->armed_tick = TIMER_WHEEL_NO_TICK;
+    for (uint32_t level = 0; level < TIMER_WHEEL_LEVEL_COUNT; level++)
+    {
+        timer_wheel->occupied_slots[level] = 0;
+        for (uint32_t slot = 0; slot < TIMER_WHEEL_SLOT_COUNT; slot++)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_07_042: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-            LogError("THANDLE_MALLOC(THREADPOOL_WORK_ITEM)(NULL) failed");
-            result = MU_FAILURE;
+            timer_wheel_link_initialize(&timer_wheel->slots[level][slot]);
         }
-        else
-        {
-            threadpool_work_item_ptr->work_function_ctx = work_function_context;
-            threadpool_work_item_ptr->work_function = work_function;
-
-            THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_work_item_ptr;
+    }
+}
+
+static bool timer_wheel_is_empty(const TIMER_WHEEL* timer_wheel)
+{
+    uint64_t occupied_slots = 0;
+    for (uint32_t level = 0; level < TIMER_WHEEL_LEVEL_COUNT; level++)
+    {
+        occupied_slots |= timer_wheel->occupied_slots[level];
+    }
+    return (occupied_slots == 0);
+}
+
+static void timer_wheel_insert(TIMER_WHEEL* timer_wheel, CUSTOM_TIMER_DATA* custom_timer_data, uint64_t expire_tick)
+{
+    if (expire_tick < timer_wheel->current_tick)
+    {
+        expire_tick = timer_wheel->current_tick;
+    }
+
+    // pick the lowest level whose slots still cover the distance to the expiration tick
+    uint64_t ticks_to_expire = expire_tick - timer_wheel->current_tick;
+    uint32_t level = 0;
+    while ((level < TIMER_WHEEL_LEVEL_COUNT - 1) &&
+        (ticks_to_expire >= ((uint64_t)1 << (TIMER_WHEEL_SLOT_BITS * (level + 1)))))
+    {
+        level++;
+    }
+    uint32_t slot = (uint32_t)((expire_tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK);
+
+    custom_timer_data->expire_tick = expire_tick;
+    custom_timer_data->wheel_level = level;
+    custom_timer_data->wheel_slot = slot;
+    timer_wheel_link_insert_tail(&timer_wheel->slots[level][slot], &custom_timer_data->link);
+    timer_wheel->occupied_slots[level] |= ((uint64_t)1 << slot);
+}
+
+static void timer_wheel_remove(TIMER_WHEEL* timer_wheel, CUSTOM_TIMER_DATA* custom_timer_data)
+{
+    if (custom_timer_data->link.next == NULL)
+    {
+        // not in the timer wheel (expired one shot timer or cancelled timer)
+    }
+    else
+    {
+        TIMER_WHEEL_LINK* slot_head = &timer_wheel->slots[custom_timer_data->wheel_level][custom_timer_data->wheel_slot];
+        timer_wheel_link_remove(&custom_timer_data->link);
+        if (slot_head->next == slot_head)
+        {
+            timer_wheel->occupied_slots[custom_timer_data->wheel_level] &= ~((uint64_t)1 << custom_timer_data->wheel_slot);
+        }
+    }
+}
+
+static void timer_wheel_detach_slot(TIMER_WHEEL* timer_wheel, uint32_t level, uint32_t slot, TIMER_WHEEL_LINK* detached_head)
+{
+    timer_wheel_link_move(detached_head, &timer_wheel->slots[level][slot]);
+    timer_wheel->occupied_slots[level] &= ~((uint64_t)1 << slot);
+}
+
+static uint64_t timer_wheel_get_next_tick(const TIMER_WHEEL* timer_wheel)
+{
+    uint64_t result = TIMER_WHEEL_NO_TICK;
+
+    for (uint32_t level = 0; level < TIMER_WHEEL_LEVEL_COUNT; level++)
+    {
+        uint64_t occupied_slots = timer_wheel->occupied_slots[level];
+        if (occupied_slots != 0)
+        {
+            // a slot at this level needs processing when a slot of this level starts at a tick >= current_tick and has the index of the slot
+            uint32_t shift = TIMER_WHEEL_SLOT_BITS * level;
+            uint64_t first_slot_start = (timer_wheel->current_tick + (((uint64_t)1 << shift) - 1)) >> shift;
+            uint32_t rotate = (uint32_t)(first_slot_start & TIMER_WHEEL_SLOT_MASK);
+            uint64_t rotated_slots = (rotate == 0) ? occupied_slots : ((occupied_slots >> rotate) | (occupied_slots << (TIMER_WHEEL_SLOT_COUNT - rotate)));
+            uint64_t tick = (first_slot_start + (uint64_t)__builtin_ctzll(rotated_slots)) << shift;
+            if (tick < result)
+            {
+                result = tick;
+            }
+        }
+    }
+
+    return result;
+}
+
+static void timer_wheel_cascade(TIMER_WHEEL* timer_wheel)
+{
+    // every level whose slot starts at current_tick moves its timers to the lower levels
+    for (uint32_t level = 1; level < TIMER_WHEEL_LEVEL_COUNT; level++)
+    {
+        uint32_t shift = TIMER_WHEEL_SLOT_BITS * level;
+        if ((timer_wheel->current_tick & (((uint64_t)1 << shift) - 1)) != 0)
+        {
+            break;
+        }
+
+        TIMER_WHEEL_LINK detached_head;
+        timer_wheel_detach_slot(timer_wheel, level, (uint32_t)((timer_wheel->current_tick >> shift) & TIMER_WHEEL_SLOT_MASK), &detached_head);
+        while (detached_head.next != &detached_head)
+        {
+            CUSTOM_TIMER_DATA* custom_timer_data = CONTAINING_RECORD(detached_head.next, CUSTOM_TIMER_DATA, link);
+            timer_wheel_link_remove(&custom_timer_data->link);
+            timer_wheel_insert(timer_wheel, custom_timer_data, custom_timer_data->expire_tick);
+        }
+    }
+}
+
+static uint64_t threadpool_timer_get_expire_tick(double now_ms, uint32_t delay_ms)
+{
+    // never expire early, round up to the next millisecond
+    double expire_ms = now_ms + delay_ms;
+    uint64_t result = (uint64_t)expire_ms;
+    if ((double)result < expire_ms)
+    {
+        result++;
+    }
+    return result;
+}
+
+static int threadpool_timer_wheel_arm(THREADPOOL* threadpool)
+{
+    int result;
+    TIMER_WHEEL* timer_wheel = &threadpool->timer_wheel;
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_059: [ threadpool_timer_wheel_arm shall compute the next tick at which a slot of the timer wheel needs processing. ]*/
+    uint64_t next_tick = timer_wheel_get_next_tick(timer_wheel);
+    if (next_tick == timer_wheel->armed_tick)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_060: [ If the timer fd is already armed for the next tick, threadpool_timer_wheel_arm shall succeed and return 0. ]*/
+        result = 0;
+    }
+    else
+    {
+        struct itimerspec its = { 0 };
+        if (next_tick != TIMER_WHEEL_NO_TICK)
+        {
+            double delay_ms = (double)next_tick - timer_global_get_elapsed_ms();
+            uint64_t delay_ns = (delay_ms <= 0) ? 1 : (uint64_t)(delay_ms * MILLISEC_TO_NANOSEC) + 1;
+            its.it_value.tv_sec = (time_t)(delay_ns / 1000000000);
+            its.it_value.tv_nsec = (long)(delay_ns % 1000000000);
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_061: [ Otherwise threadpool_timer_wheel_arm shall call timerfd_settime to expire at the next tick, or to disarm the timer fd if the timer wheel is empty. ]*/
+        if (timerfd_settime(threadpool->timer_fd, 0, &its, NULL) != 0)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_062: [ If timerfd_settime fails, threadpool_timer_wheel_arm shall fail and return a non-zero value. ]*/
+            LogErrorNo("timerfd_settime(threadpool->timer_fd=%d, 0, &its=%p, NULL) failed", threadpool->timer_fd, &its);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            timer_wheel->armed_tick = next_tick;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static int threadpool_timer_wheel_add(THREADPOOL* threadpool, CUSTOM_TIMER_DATA* custom_timer_data, uint32_t delay_ms)
+{
+    int result;
+    TIMER_WHEEL* timer_wheel = &threadpool->timer_wheel;
+    double now_ms = timer_global_get_elapsed_ms();
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_054: [ threadpool_timer_wheel_add shall perform the following steps while holding the timer lock of the threadpool, acquired by calling srw_lock_ll_acquire_exclusive and released by calling srw_lock_ll_release_exclusive. ]*/
+    srw_lock_ll_acquire_exclusive(&threadpool->timer_lock);
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_055: [ If the timer wheel is empty, threadpool_timer_wheel_add shall move the current tick of the timer wheel to the current time. ]*/
+        if (timer_wheel_is_empty(timer_wheel) && (timer_wheel->current_tick < (uint64_t)now_ms))
+        {
+            timer_wheel->current_tick = (uint64_t)now_ms;
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_056: [ threadpool_timer_wheel_add shall insert the timer in the slot of the lowest level of the timer wheel which covers the expiration time, computed by calling timer_global_get_elapsed_ms and adding delay_ms. ]*/
+        timer_wheel_insert(timer_wheel, custom_timer_data, threadpool_timer_get_expire_tick(now_ms, delay_ms));
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_057: [ threadpool_timer_wheel_add shall arm the timer fd by calling threadpool_timer_wheel_arm. ]*/
+        if (threadpool_timer_wheel_arm(threadpool) != 0)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_058: [ If threadpool_timer_wheel_arm fails, threadpool_timer_wheel_add shall remove the timer from the timer wheel, fail and return a non-zero value. ]*/
+            LogError("threadpool_timer_wheel_arm(threadpool=%p) failed", threadpool);
+            timer_wheel_remove(timer_wheel, custom_timer_data);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    /* Codes_SRS_THREADPOOL_LINUX_12_054: [ threadpool_timer_wheel_add shall perform the following steps while holding the timer lock of the threadpool, acquired by calling srw_lock_ll_acquire_exclusive and released by calling srw_lock_ll_release_exclusive. ]*/
+    srw_lock_ll_release_exclusive(&threadpool->timer_lock);
+
+    return result;
+}
+
+static void custom_timer_data_release(CUSTOM_TIMER_DATA* custom_timer_data)
+{
+    if (interlocked_decrement(&custom_timer_data->ref_count) == 0)
+    {
+        free(custom_timer_data);
+    }
+}
+
+static void on_timer_callback(void* context)
+{
+    CUSTOM_TIMER_DATA* timer_instance = context;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_008: [ If the timer is in the state ARMED: ]*/
+    /* Codes_SRS_THREADPOOL_LINUX_01_007: [ on_timer_callback shall transition it to CALLING_CALLBACK. ]*/
+    if (interlocked_compare_exchange(&timer_instance->timer_state, TIMER_CALLING_CALLBACK, TIMER_ARMED) == TIMER_ARMED)
+    {
+        if (interlocked_add(&timer_instance->epoch_number, 0) == timer_instance->dispatched_epoch_number)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_079: [ If the timer epoch number is the same as the epoch number recorded when the callback was dispatched, on_timer_callback shall call the timer's work_function with work_function_ctx. ]*/
+            timer_instance->work_function(timer_instance->work_function_ctx);
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_009: [ on_timer_callback shall transition it to ARMED. ]*/
+        (void)InterlockedHL_SetAndWake(&timer_instance->timer_state, TIMER_ARMED);
+    }
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_080: [ on_timer_callback shall clear the dispatch pending flag of the timer and release its reference to the timer data. ]*/
+    (void)interlocked_exchange(&timer_instance->dispatch_pending, 0);
+    custom_timer_data_release(timer_instance);
+}
+
+static void threadpool_release_queued_task(const THREADPOOL_TASK* task)
+{
+    // only the timer tasks own a reference, the context of any other task belongs to the caller that scheduled it
+    if (task->work_function == on_timer_callback)
+    {
+        CUSTOM_TIMER_DATA* custom_timer_data = task->work_function_ctx;
+        (void)interlocked_exchange(&custom_timer_data->dispatch_pending, 0);
+        custom_timer_data_release(custom_timer_data);
+    }
+}
+
+static void threadpool_release_queued_tasks(THREADPOOL* threadpool)
+{
+    THREADPOOL_TASK task;
 
-            /* Codes_SRS_THREADPOOL_LINUX_01_015: [ threadpool_schedule_work shall push the newly created THANDLE(THREADPOOL_WORK_ITEM) in the work item queue. ]*/
-            if (TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(threadpool_ptr->task_queue, &threadpool_work_item, NULL) != TQUEUE_PUSH_OK)
+    for (uint32_t i = 0; i < threadpool->thread_array_size; i++)
+    {
+        while (threadpool_task_deque_pop(&threadpool->thread_array[i].local_queue, &task) == THREADPOOL_TASK_DEQUE_OK)
+        {
+            threadpool_release_queued_task(&task);
+        }
+    }
+    for (uint32_t i = 0; i < THREADPOOL_PRIORITY_COUNT; i++)
+    {
+        while (TQUEUE_POP(THREADPOOL_TASK)(threadpool->lanes[i].task_queue, &task, NULL, NULL, NULL) == TQUEUE_POP_OK)
+        {
+            threadpool_release_queued_task(&task);
+        }
+    }
+}
+
+static void threadpool_timer_dispatch(THREADPOOL* threadpool, CUSTOM_TIMER_DATA* custom_timer_data)
+{
+    if (interlocked_compare_exchange(&custom_timer_data->dispatch_pending, 1, 0) != 0)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_076: [ If the callback of the timer is still queued or executing, threadpool_timer_dispatch shall skip this expiration. ]*/
+        LogVerbose("Timer %p is still executing its previous expiration, skipping", custom_timer_data);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_077: [ Otherwise threadpool_timer_dispatch shall record the epoch number of the timer, take a reference to the timer data and push a task with on_timer_callback as work function and the timer data as context by calling threadpool_push_task. ]*/
+        custom_timer_data->dispatched_epoch_number = interlocked_add(&custom_timer_data->epoch_number, 0);
+        (void)interlocked_increment(&custom_timer_data->ref_count);
+        THREADPOOL_TASK task = { on_timer_callback, custom_timer_data, 0 };
+        if (threadpool_push_task(threadpool, THREADPOOL_PRIORITY_NORMAL, &task) != TQUEUE_PUSH_OK)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_078: [ If threadpool_push_task fails, threadpool_timer_dispatch shall clear the dispatch pending flag and release the reference to the timer data. ]*/
+            LogError("threadpool_push_task(threadpool=%p, &task=%p) failed", threadpool, &task);
+            (void)interlocked_exchange(&custom_timer_data->dispatch_pending, 0);
+            custom_timer_data_release(custom_timer_data);
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_077: [ Otherwise threadpool_timer_dispatch shall record the epoch number of the timer, take a reference to the timer data and push a task with on_timer_callback as work function and the timer data as context by calling threadpool_push_task. ]*/
+            threadpool_signal_work(threadpool, 1);
+            threadpool_add_thread_if_needed(threadpool);
+        }
+    }
+}
+
+static void threadpool_timer_wheel_expire(THREADPOOL* threadpool)
+{
+    TIMER_WHEEL* timer_wheel = &threadpool->timer_wheel;
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_072: [ Otherwise threadpool_timer_thread_func shall perform the following steps while holding the timer lock, acquired by calling srw_lock_ll_acquire_exclusive and released by calling srw_lock_ll_release_exclusive. ]*/
+    srw_lock_ll_acquire_exclusive(&threadpool->timer_lock);
+    {
+        if (interlocked_add(&threadpool->timer_thread_stop, 0) != 0)
+        {
+            // threadpool_dispose already armed the timer fd to stop this thread, leave it alone
+        }
+        else
+        {
+            // the timer fd is one shot, it is not armed anymore
+            timer_wheel->armed_tick = TIMER_WHEEL_NO_TICK;
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_073: [ For each tick up to the current time obtained by calling timer_global_get_elapsed_ms at which a slot needs processing, threadpool_timer_thread_func shall move the timers of the higher level slots starting at that tick to the lower levels and dispatch the timers in the level 0 slot of that tick by calling threadpool_timer_dispatch. ]*/
+            uint64_t now_tick = (uint64_t)timer_global_get_elapsed_ms();
+            uint64_t next_tick;
+            while ((next_tick = timer_wheel_get_next_tick(timer_wheel)) <= now_tick)
+            {
+                timer_wheel->current_tick = next_tick;
+                timer_wheel_cascade(timer_wheel);
+
+                TIMER_WHEEL_LINK expired_head;
+                timer_wheel_detach_slot(timer_wheel, 0, (uint32_t)(next_tick & TIMER_WHEEL_SLOT_MASK), &expired_head);
+                while (expired_head.next != &expired_head)
+                {
+                    CUSTOM_TIMER_DATA* custom_timer_data = CONTAINING_RECORD(expired_head.next, CUSTOM_TIMER_DATA, link);
+                    timer_wheel_link_remove(&custom_timer_data->link);
+
+                    threadpool_timer_dispatch(threadpool, custom_timer_data);
+
+                    if (custom_timer_data->period_ms != 0)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_12_074: [ threadpool_timer_thread_func shall insert periodic timers back in the timer wheel one period after their expiration, or one period after the current time if that is already in the past. ]*/
+                        uint64_t expire_tick = custom_timer_data->expire_tick + custom_timer_data->period_ms;
+                        if (expire_tick <= now_tick)
+                        {
+                            expire_tick = now_tick + custom_timer_data->period_ms;
+                        }
+                        timer_wheel_insert(timer_wheel, custom_timer_data, expire_tick);
+                    }
+                }
+
+                timer_wheel->current_tick = next_tick + 1;
+            }
+
+            if (timer_wheel->current_tick <= now_tick)
+            {
+                timer_wheel->current_tick = now_tick + 1;
+            }
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_075: [ threadpool_timer_thread_func shall arm the timer fd for the next expiration by calling threadpool_timer_wheel_arm. ]*/
+            if (threadpool_timer_wheel_arm(threadpool) != 0)
+            {
+                LogError("threadpool_timer_wheel_arm(threadpool=%p) failed", threadpool);
+            }
+        }
+    }
+    /* Codes_SRS_THREADPOOL_LINUX_12_072: [ Otherwise threadpool_timer_thread_func shall perform the following steps while holding the timer lock, acquired by calling srw_lock_ll_acquire_exclusive and released by calling srw_lock_ll_release_exclusive. ]*/
+    srw_lock_ll_release_exclusive(&threadpool->timer_lock);
+}
+
+static int threadpool_timer_thread_func(void* param)
+{
+    if (param == NULL)
+    {
+        LogCritical("Invalid args: param: %p", param);
+    }
+    else
+    {
+        THREADPOOL* threadpool = param;
+
+        while (1)
+        {
+            uint64_t expiration_count;
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_069: [ threadpool_timer_thread_func shall wait for the timer fd to expire by calling read. ]*/
+            if (read(threadpool->timer_fd, &expiration_count, sizeof(expiration_count)) != (ssize_t)sizeof(expiration_count))
             {
-                /* Codes_SRS_THREADPOOL_LINUX_07_042: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-                LogError("TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(threadpool_ptr->task_queue, &threadpool_work_item, NULL) failed");
+                /* Codes_SRS_THREADPOOL_LINUX_12_070: [ If read fails, threadpool_timer_thread_func shall log the error and continue. ]*/
+                LogErrorNo("read(threadpool->timer_fd=%d, &expiration_count=%p, sizeof(expiration_count)=%zu) failed", threadpool->timer_fd, &expiration_count, sizeof(expiration_count));
+            }
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_071: [ If the timer thread was signalled to stop, threadpool_timer_thread_func shall return. ]*/
+            if (interlocked_add(&threadpool->timer_thread_stop, 0) != 0)
+            {
+                break;
+            }
+
+            threadpool_timer_wheel_expire(threadpool);
+        }
+    }
+    return 0;
+}
+
+static int do_init(void* params)
+{
+    int result;
+    THREADPOOL* threadpool = params;
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_044: [ do_init shall initialize the timer lock by calling srw_lock_ll_init. ]*/
+    if (srw_lock_ll_init(&threadpool->timer_lock) != 0)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_048: [ If any error occurs, do_init shall fail and return a non-zero value. ]*/
+        LogError("srw_lock_ll_init(&threadpool->timer_lock=%p) failed", &threadpool->timer_lock);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_12_045: [ do_init shall initialize all the slots of the timer wheel as empty and set the current tick of the timer wheel by calling timer_global_get_elapsed_ms. ]*/
+        timer_wheel_initialize(&threadpool->timer_wheel, (uint64_t)timer_global_get_elapsed_ms());
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_046: [ do_init shall create the timer fd by calling timerfd_create with CLOCK_MONOTONIC. ]*/
+        threadpool->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (threadpool->timer_fd == -1)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_048: [ If any error occurs, do_init shall fail and return a non-zero value. ]*/
+            LogErrorNo("timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC) failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            (void)interlocked_exchange(&threadpool->timer_thread_stop, 0);
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_047: [ do_init shall start the timer thread by calling ThreadAPI_CreateEx with threadpool_timer_thread_func, the name tp_timer and the same thread stack size and NUMA node as the worker threads. ]*/
+            THREADAPI_CREATE_OPTIONS options;
+            threadpool_get_thread_create_options(threadpool, "tp_timer", &options);
+            if (ThreadAPI_CreateEx(&threadpool->timer_thread_handle, threadpool_timer_thread_func, threadpool, &options) != THREADAPI_OK)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_048: [ If any error occurs, do_init shall fail and return a non-zero value. ]*/
+                LogError("ThreadAPI_CreateEx(&threadpool->timer_thread_handle=%p, threadpool_timer_thread_func=%p, threadpool=%p) failed",
+                    &threadpool->timer_thread_handle, threadpool_timer_thread_func, threadpool);
                 result = MU_FAILURE;
             }
             else
             {
-                /* Codes_SRS_THREADPOOL_LINUX_07_051: [ threadpool_schedule_work shall unblock the threadpool semaphore by calling sem_post. ]*/
-                sem_post(&threadpool_ptr->semaphore);
+                threadpool->timer_thread_started = true;
+
+                /* Codes_SRS_THREADPOOL_LINUX_07_099: [ do_init shall succeed and return 0. ]*/
+                result = 0;
+                goto all_ok;
+            }
+
+            if (close(threadpool->timer_fd) != 0)
+            {
+                LogErrorNo("close(threadpool->timer_fd=%d) failed", threadpool->timer_fd);
+            }
+        }
+        srw_lock_ll_deinit(&threadpool->timer_lock);
+    }
+all_ok:
+    return result;
+}
+
+static void threadpool_stop_timer_thread(THREADPOOL* threadpool)
+{
+    srw_lock_ll_acquire_exclusive(&threadpool->timer_lock);
+    {
+        (void)interlocked_exchange(&threadpool->timer_thread_stop, 1);
+
+        // expire the timer fd right away so that the timer thread wakes up and sees the stop flag
+        struct itimerspec its = { 0 };
+        its.it_value.tv_nsec = 1;
+        if (timerfd_settime(threadpool->timer_fd, 0, &its, NULL) != 0)
+        {
+            LogErrorNo("timerfd_settime(threadpool->timer_fd=%d, 0, &its=%p, NULL) failed", threadpool->timer_fd, &its);
+        }
+    }
+    srw_lock_ll_release_exclusive(&threadpool->timer_lock);
+
+    int dont_care;
+    if (ThreadAPI_Join(threadpool->timer_thread_handle, &dont_care) != THREADAPI_OK)
+    {
+        LogError("Failure joining timer thread %p", threadpool->timer_thread_handle);
+    }
+
+    if (close(threadpool->timer_fd) != 0)
+    {
+        LogErrorNo("close(threadpool->timer_fd=%d) failed", threadpool->timer_fd);
+    }
+
+    srw_lock_ll_deinit(&threadpool->timer_lock);
+}
+
+static void threadpool_dispose(THREADPOOL* threadpool)
+{
+    /* Codes_SRS_THREADPOOL_LINUX_12_081: [ If the timer thread was started, threadpool_dispose shall signal it to stop, expire the timer fd by calling timerfd_settime, join the timer thread, close the timer fd and deinitialize the timer lock. ]*/
+    if (threadpool->timer_thread_started)
+    {
+        threadpool_stop_timer_thread(threadpool);
+    }
 
-                THANDLE_ASSIGN(THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
+    /* Codes_SRS_THREADPOOL_LINUX_07_089: [ threadpool_dispose shall signal all threads to return. ]*/
+    threadpool_stop_threads(threadpool);
+    for (uint32_t index = 0; index < threadpool->thread_array_size; index++)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_07_027: [ threadpool_dispose shall join all threads in the threadpool. ]*/
+        /* Codes_SRS_THREADPOOL_LINUX_12_023: [ threadpool_dispose shall join all threads whose slot is in state RUNNING or EXITED. ]*/
+        if (interlocked_add(&threadpool->thread_array[index].state, 0) != THREADPOOL_THREAD_NOT_USED)
+        {
+            threadpool_join_thread(&threadpool->thread_array[index]);
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_148: [ threadpool_dispose shall join the thread that previously used a slot if its handle is still held by the slot. ]*/
+        threadpool_join_previous_thread(&threadpool->thread_array[index]);
+    }
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_150: [ threadpool_dispose shall pop the tasks left in the local queues of all the thread slots by calling threadpool_task_deque_pop and in the global task queues of all the lanes by calling TQUEUE_POP(THREADPOOL_TASK), and for each timer task (whose work function is on_timer_callback) it shall clear the dispatch pending flag of the timer and release the reference of the task to the timer data. ]*/
+    threadpool_release_queued_tasks(threadpool);
+
+    /* Codes_SRS_THREADPOOL_LINUX_07_016: [ threadpool_dispose shall free the memory allocated in threadpool_create. ]*/
+    for (uint32_t i = 0; i < threadpool->thread_array_size; i++)
+    {
+        threadpool_task_deque_deinit(&threadpool->thread_array[i].local_queue);
+    }
+    for (uint32_t i = 0; i < THREADPOOL_PRIORITY_COUNT; i++)
+    {
+        TQUEUE_ASSIGN(THREADPOOL_TASK)(&threadpool->lanes[i].task_queue, NULL);
+    }
+    free(threadpool->thread_array);
+}
+
+THANDLE(THREADPOOL) threadpool_create(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    THREADPOOL* result = NULL;
+
+    /* Codes_SRS_THREADPOOL_LINUX_07_002: [ If execution_engine is NULL, threadpool_create shall fail and return NULL. ]*/
+    if (execution_engine == NULL)
+    {
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine: %p", execution_engine);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_07_001: [ threadpool_create shall allocate memory for a threadpool object and on success return a non-NULL handle to it. ]*/
+        result = THANDLE_MALLOC(THREADPOOL)(threadpool_dispose);
+        if (result == NULL)
+        {
+            LogError("Failure allocating THREADPOOL structure");
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_07_004: [ threadpool_create shall get the min_thread_count and max_thread_count thread parameters from the execution_engine. ]*/
+            const EXECUTION_ENGINE_PARAMETERS* param = execution_engine_linux_get_parameters(execution_engine);
+
+            result->min_thread_count = param->min_thread_count;
+            result->max_thread_count = param->max_thread_count;
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_145: [ threadpool_create shall get the NUMA node and the thread stack size from the execution_engine by calling execution_engine_linux_get_thread_parameters. ]*/
+            result->thread_params = *execution_engine_linux_get_thread_parameters(execution_engine);
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_001: [ If max_thread_count is 0, the threadpool shall not grow beyond min_thread_count threads. ]*/
+            result->thread_array_size = (result->max_thread_count == 0) ? result->min_thread_count : result->max_thread_count;
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_002: [ threadpool_create shall allocate memory for an array of thread slots of size max_thread_count (or min_thread_count if max_thread_count is 0). ]*/
+            result->thread_array = malloc_2(result->thread_array_size, sizeof(THREADPOOL_THREAD));
+            if (result->thread_array == NULL)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_07_011: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
+                LogError("Failure malloc_2(result->thread_array_size: %" PRIu32 ", sizeof(THREADPOOL_THREAD)): %zu", result->thread_array_size, sizeof(THREADPOOL_THREAD));
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_013: [ threadpool_create shall create a queue of threadpool tasks for each priority lane by calling TQUEUE_CREATE(THREADPOOL_TASK) with initial size 2048, max size UINT32_MAX and no copy and dispose functions. ]*/
+                uint32_t lane_count;
+                for (lane_count = 0; lane_count < THREADPOOL_PRIORITY_COUNT; lane_count++)
+                {
+                    TQUEUE(THREADPOOL_TASK) temp_task_queue = TQUEUE_CREATE(THREADPOOL_TASK)(DEFAULT_TASK_ARRAY_SIZE, UINT32_MAX, NULL, NULL, NULL);
+                    if (temp_task_queue == NULL)
+                    {
+                        LogError("TQUEUE_CREATE(THREADPOOL_TASK)(DEFAULT_TASK_ARRAY_SIZE=%d, UINT32_MAX, NULL, NULL, NULL) failed", DEFAULT_TASK_ARRAY_SIZE);
+                        break;
+                    }
+                    TQUEUE_INITIALIZE_MOVE(THREADPOOL_TASK)(&result->lanes[lane_count].task_queue, &temp_task_queue);
+                }
+
+                if (lane_count < THREADPOOL_PRIORITY_COUNT)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_07_011: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
+                    LogError("Failed creating the task queues of the priority lanes");
+                }
+                else
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_12_042: [ threadpool_create shall initialize a local queue of LOCAL_TASK_ARRAY_SIZE tasks for each thread slot by calling threadpool_task_deque_init and shall set the first slot to steal from to the slot after it. ]*/
+                    uint32_t local_queue_count;
+                    for (local_queue_count = 0; local_queue_count < result->thread_array_size; local_queue_count++)
+                    {
+                        if (threadpool_task_deque_init(&result->thread_array[local_queue_count].local_queue, LOCAL_TASK_ARRAY_SIZE) != 0)
+                        {
+                            LogError("threadpool_task_deque_init(LOCAL_TASK_ARRAY_SIZE=%d) failed", LOCAL_TASK_ARRAY_SIZE);
+                            break;
+                        }
+                        result->thread_array[local_queue_count].next_victim_index = (local_queue_count + 1) % result->thread_array_size;
+                    }
+
+                    if (local_queue_count < result->thread_array_size)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_07_011: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
+                        LogError("Failed creating the local queues");
+                    }
+                    else
+                    {
+                        (void)interlocked_exchange(&result->stop_thread, 0);
+
+                        /* Codes_SRS_THREADPOOL_LINUX_12_043: [ threadpool_create shall initialize the lazy initialization state of the timers, the timer thread is started by the first threadpool_timer_start. ]*/
+                        (void)interlocked_exchange(&result->timer_lazy, LAZY_INIT_NOT_DONE);
+                        result->timer_thread_started = false;
+
+                        /* Codes_SRS_THREADPOOL_LINUX_12_033: [ threadpool_create shall initialize the work sequence and the number of waiting threads to 0. ]*/
+                        (void)interlocked_exchange(&result->work_sequence, 0);
+                        (void)interlocked_exchange(&result->waiting_thread_count, 0);
+
+                        /* Codes_SRS_THREADPOOL_LINUX_12_112: [ threadpool_create shall initialize the private and the published statistics counters of all thread slots to 0. ]*/
+                        for (uint32_t i = 0; i < result->thread_array_size; i++)
+                        {
+                            // no worker thread is running yet
+                            (void)memset(&result->thread_array[i].local_counters, 0, sizeof(result->thread_array[i].local_counters));
+                            (void)memset(&result->thread_array[i].counters, 0, sizeof(result->thread_array[i].counters));
+                            // so that the first dequeue of the thread is always stored
+                            result->thread_array[i].last_published_dequeue_time_ms = -1;
+                        }
+
+                        /* Codes_SRS_THREADPOOL_LINUX_12_003: [ threadpool_create shall initialize the state of all thread slots to NOT_USED. ]*/
+                        for (uint32_t i = 0; i < result->thread_array_size; i++)
+                        {
+                            (void)interlocked_exchange(&result->thread_array[i].state, THREADPOOL_THREAD_NOT_USED);
+                            result->thread_array[i].previous_thread_handle = NULL;
+                        }
+
+                        /* Codes_SRS_THREADPOOL_LINUX_12_004: [ threadpool_create shall initialize the number of live threads to min_thread_count and the number of active threads to 0. ]*/
+                        (void)interlocked_exchange(&result->thread_count, (int32_t)result->min_thread_count);
+                        (void)interlocked_exchange(&result->active_thread_count, 0);
+                        (void)interlocked_exchange_64(&result->last_dequeue_time_ms, 0);
+
+                        uint32_t index;
+                        for (index = 0; index < result->min_thread_count; index++)
+                        {
+                            /* Codes_SRS_THREADPOOL_LINUX_07_020: [ threadpool_create shall create min_thread_count number of threads for threadpool using ThreadAPI_CreateEx. ]*/
+                            if (threadpool_start_thread(result, &result->thread_array[index]) != 0)
+                            {
+                                /* Codes_SRS_THREADPOOL_LINUX_07_011: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
+                                LogError("Failure creating thread %" PRIu32 "", index);
+                                break;
+                            }
+                        }
+
+                        /* Codes_SRS_THREADPOOL_LINUX_07_022: [ If one of the thread creation fails, threadpool_create shall fail, terminate all threads already created and return NULL. ]*/
+                        if (index < result->min_thread_count)
+                        {
+                            LogError("Failed starting one of the threadpool threads");
+                        }
+                        else
+                        {
+                            goto all_ok;
+                        }
+
+                        threadpool_stop_threads(result);
+                        for (uint32_t inner = 0; inner < index; inner++)
+                        {
+                            threadpool_join_thread(&result->thread_array[inner]);
+                        }
+                    }
+
+                    for (uint32_t i = 0; i < local_queue_count; i++)
+                    {
+                        threadpool_task_deque_deinit(&result->thread_array[i].local_queue);
+                    }
+                }
+
+                for (uint32_t i = 0; i < lane_count; i++)
+                {
+                    TQUEUE_ASSIGN(THREADPOOL_TASK)(&result->lanes[i].task_queue, NULL);
+                }
+                free(result->thread_array);
+            }
+            THANDLE_FREE(THREADPOOL)(result);
+            result = NULL;
+        }
+    }
+all_ok:
+    return result;
+}
+
+int threadpool_schedule_work(THANDLE(THREADPOOL) threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    int result;
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_07_029: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        threadpool == NULL ||
+        /* Codes_SRS_THREADPOOL_LINUX_07_030: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        work_function == NULL)
+    {
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_WORK_FUNCTION work_function: %p, void* work_function_context: %p", threadpool, work_function, work_function_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_014: [ threadpool_schedule_work shall store work_function and work_function_context in a THREADPOOL_TASK. ]*/
+        THREADPOOL_TASK task = { work_function, work_function_context, 0 };
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_015: [ threadpool_schedule_work shall push the task in a task queue of the normal priority lane by calling threadpool_push_task. ]*/
+        if (threadpool_push_task(threadpool_ptr, THREADPOOL_PRIORITY_NORMAL, &task) != TQUEUE_PUSH_OK)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_07_042: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+            LogError("threadpool_push_task(threadpool_ptr=%p, &task=%p) failed", threadpool_ptr, &task);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_034: [ threadpool_schedule_work shall signal that work is available by calling threadpool_signal_work. ]*/
+            threadpool_signal_work(threadpool_ptr, 1);
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_005: [ threadpool_schedule_work shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+            threadpool_add_thread_if_needed(threadpool_ptr);
+
+            /* Codes_SRS_THREADPOOL_LINUX_07_047: [ threadpool_schedule_work shall return zero on success. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static void threadpool_timer_dispose(THREADPOOL_TIMER* timer)
+{
+    THREADPOOL* threadpool = THANDLE_GET_T(THREADPOOL)(timer->threadpool);
+    CUSTOM_TIMER_DATA* custom_timer_data = timer->custom_timer_data;
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_066: [ threadpool_timer_dispose shall remove the timer from the timer wheel while holding the timer lock. ]*/
+    srw_lock_ll_acquire_exclusive(&threadpool->timer_lock);
+    timer_wheel_remove(&threadpool->timer_wheel, custom_timer_data);
+    srw_lock_ll_release_exclusive(&threadpool->timer_lock);
+
+    do
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_006: [ If the timer state is ARMED, threadpool_timer_dispose shall set the state of the timer to NOT_USED. ]*/
+        int32_t current_timer_state = interlocked_compare_exchange(&custom_timer_data->timer_state, TIMER_NOT_USED, TIMER_ARMED);
+        if (current_timer_state == TIMER_ARMED)
+        {
+            wake_by_address_all(&custom_timer_data->timer_state);
+            break;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_010: [ Otherwise, threadpool_timer_dispose shall block until the state is ARMED and reattempt to set the state to NOT_USED. ]*/
+            (void)InterlockedHL_WaitForNotValue(&custom_timer_data->timer_state, current_timer_state, UINT32_MAX);
+        }
+    } while (1);
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_067: [ threadpool_timer_dispose shall release its reference to the timer data, freeing the timer data if no callback is queued for it. ]*/
+    custom_timer_data_release(custom_timer_data);
+
+    /* Codes_SRS_THREADPOOL_LINUX_12_068: [ threadpool_timer_dispose shall release its reference to the threadpool. ]*/
+    THANDLE_ASSIGN(THREADPOOL)(&timer->threadpool, NULL);
+}
+
+THANDLE(THREADPOOL_TIMER) threadpool_timer_start(THANDLE(THREADPOOL) threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_ctx)
+{
+    THREADPOOL_TIMER* result = NULL;
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_07_054: [ If threadpool is NULL, threadpool_timer_start shall fail and return NULL. ]*/
+        threadpool == NULL ||
+        /* Codes_SRS_THREADPOOL_LINUX_07_055: [ If work_function is NULL, threadpool_timer_start shall fail and return NULL. ]*/
+        work_function == NULL
+        )
+    {
+        LogError("Invalid args: THANDLE(THREADPOOL) threadpool = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function = %p, void* work_function_context = %p",
+            threadpool, start_delay_ms, timer_period_ms, work_function, work_function_ctx);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_07_058: [ threadpool_timer_start shall allocate memory for THANDLE(THREADPOOL_TIMER), passing threadpool_timer_dispose as dispose function and store work_function and work_function_ctx in it. ]*/
+        result = THANDLE_MALLOC(THREADPOOL_TIMER)(threadpool_timer_dispose);
+        if (result == NULL)
+        {
+            LogError("failure in THANDLE_MALLOC(THREADPOOL_TIMER)(threadpool_timer_dispose=%p)",
+                        threadpool_timer_dispose);
+        }
+        else
+        {
+            THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
+
+            /* Codes_SRS_THREADPOOL_LINUX_07_096: [ threadpool_timer_start shall call lazy_init with do_init as initialization function to start the timer thread of the threadpool. ]*/
+            if (lazy_init(&threadpool_ptr->timer_lazy, do_init, threadpool_ptr) != LAZY_INIT_OK)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
+                LogError("failure in lazy_init(&threadpool_ptr->timer_lazy=%p, do_init=%p, threadpool_ptr=%p)",
+                    &threadpool_ptr->timer_lazy, do_init, threadpool_ptr);
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_049: [ threadpool_timer_start shall allocate memory for the timer data. ]*/
+                CUSTOM_TIMER_DATA* custom_timer_data = malloc(sizeof(CUSTOM_TIMER_DATA));
+                if (custom_timer_data == NULL)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
+                    LogError("failure in malloc(sizeof(CUSTOM_TIMER_DATA)=%zu)", sizeof(CUSTOM_TIMER_DATA));
+                }
+                else
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_07_057: [ work_function_ctx shall be allowed to be NULL. ]*/
+                    custom_timer_data->work_function = work_function;
+                    custom_timer_data->work_function_ctx = work_function_ctx;
+                    custom_timer_data->period_ms = timer_period_ms;
+                    custom_timer_data->link.next = NULL;
+                    custom_timer_data->link.previous = NULL;
+
+                    /* Codes_SRS_THREADPOOL_LINUX_12_051: [ threadpool_timer_start shall set the state of the timer to ARMED, its epoch number to 0 and its reference count to 1. ]*/
+                    (void)interlocked_exchange(&custom_timer_data->timer_state, TIMER_ARMED);
+                    (void)interlocked_exchange(&custom_timer_data->epoch_number, 0);
+                    (void)interlocked_exchange(&custom_timer_data->dispatch_pending, 0);
+                    (void)interlocked_exchange(&custom_timer_data->ref_count, 1);
+
+                    /* Codes_SRS_THREADPOOL_LINUX_12_052: [ threadpool_timer_start shall add the timer to the timer wheel to expire after start_delay_ms by calling threadpool_timer_wheel_add. ]*/
+                    if (threadpool_timer_wheel_add(threadpool_ptr, custom_timer_data, start_delay_ms) != 0)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
+                        LogError("threadpool_timer_wheel_add(threadpool_ptr=%p, custom_timer_data=%p, start_delay_ms=%" PRIu32 ") failed",
+                            threadpool_ptr, custom_timer_data, start_delay_ms);
+                    }
+                    else
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_12_053: [ threadpool_timer_start shall store a reference to threadpool in the timer. ]*/
+                        THANDLE_INITIALIZE(THREADPOOL)(&result->threadpool, threadpool);
+                        result->custom_timer_data = custom_timer_data;
+
+                        /* Codes_SRS_THREADPOOL_LINUX_07_062: [ threadpool_timer_start shall succeed and return a non-NULL handle. ]*/
+                        goto all_ok;
+                    }
+
+                    free(custom_timer_data);
+                }
+            }
+            THANDLE_FREE(THREADPOOL_TIMER)(result);
+        }
+        /* Codes_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
+        result = NULL;
+    }
+all_ok:
+    return result;
+}
+
+int threadpool_timer_restart(THANDLE(THREADPOOL_TIMER) timer, uint32_t start_delay_ms, uint32_t timer_period_ms)
+{
+    int result;
+    if (timer == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_07_064: [ If timer is NULL, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+        LogError("Invalid args: THANDLE(THREADPOOL_TIMER) timer = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 "",
+            timer, start_delay_ms, timer_period_ms);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        THREADPOOL_TIMER* timer_content = THANDLE_GET_T(THREADPOOL_TIMER)(timer);
+        THREADPOOL* threadpool = THANDLE_GET_T(THREADPOOL)(timer_content->threadpool);
+        CUSTOM_TIMER_DATA* custom_timer_data = timer_content->custom_timer_data;
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_063: [ threadpool_timer_restart shall remove the timer from the timer wheel, increment the timer epoch number and store timer_period_ms while holding the timer lock. ]*/
+        srw_lock_ll_acquire_exclusive(&threadpool->timer_lock);
+        timer_wheel_remove(&threadpool->timer_wheel, custom_timer_data);
+        (void)interlocked_increment(&custom_timer_data->epoch_number);
+        custom_timer_data->period_ms = timer_period_ms;
+        srw_lock_ll_release_exclusive(&threadpool->timer_lock);
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_064: [ threadpool_timer_restart shall add the timer to the timer wheel to expire after start_delay_ms by calling threadpool_timer_wheel_add. ]*/
+        if (threadpool_timer_wheel_add(threadpool, custom_timer_data, start_delay_ms) != 0)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_07_066: [ If threadpool_timer_wheel_add fails, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+            LogError("threadpool_timer_wheel_add(threadpool=%p, custom_timer_data=%p, start_delay_ms=%" PRIu32 ") failed",
+                threadpool, custom_timer_data, start_delay_ms);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_07_067: [ threadpool_timer_restart shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+void threadpool_timer_cancel(THANDLE(THREADPOOL_TIMER) timer)
+{
+    if (timer == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_07_068: [ If timer is NULL, threadpool_timer_cancel shall fail and return. ]*/
+        LogError("Invalid args: THANDLE(THREADPOOL_TIMER) timer = %p", timer);
+    }
+    else
+    {
+        THREADPOOL_TIMER* timer_content = THANDLE_GET_T(THREADPOOL_TIMER)(timer);
+        THREADPOOL* threadpool = THANDLE_GET_T(THREADPOOL)(timer_content->threadpool);
+        CUSTOM_TIMER_DATA* custom_timer_data = timer_content->custom_timer_data;
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_065: [ threadpool_timer_cancel shall remove the timer from the timer wheel and increment the timer epoch number while holding the timer lock, so that an already dispatched callback does not call work_function. ]*/
+        srw_lock_ll_acquire_exclusive(&threadpool->timer_lock);
+        timer_wheel_remove(&threadpool->timer_wheel, custom_timer_data);
+        (void)interlocked_increment(&custom_timer_data->epoch_number);
+        srw_lock_ll_release_exclusive(&threadpool->timer_lock);
+    }
+}
+
+THANDLE(THREADPOOL_WORK_ITEM) threadpool_create_work_item(THANDLE(THREADPOOL) threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    THREADPOOL_WORK_ITEM_HANDLE threadpool_work_item_ptr = NULL;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_05_001: [ If threadpool is NULL, threadpool_create_work_item shall fail and return a NULL value. ] */
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_05_002: [ If work_function is NULL, threadpool_create_work_item shall fail and return a NULL value. ]*/
+        (work_function == NULL)
+        )
+    {
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_WORK_FUNCTION work_function: %p, void* work_function_ctx: %p", threadpool, work_function, work_function_context);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_05_005: [ threadpool_create_work_item shall allocate memory for threadpool_work_item of type THANDLE(THREADPOOL_WORK_ITEM). ] */
+        threadpool_work_item_ptr = THANDLE_MALLOC(THREADPOOL_WORK_ITEM)(NULL);
+
+        if (threadpool_work_item_ptr == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_05_006: [ If during the initialization of threadpool_work_item, malloc fails then threadpool_create_work_item shall fail and return a NULL value. ]*/
+            LogError("Could not allocate memory for Work Item Context");
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_05_007: [ threadpool_create_work_item shall copy the work_function and work_function_context into the threadpool work item. ] */
+            threadpool_work_item_ptr->work_function_ctx = work_function_context;
+            threadpool_work_item_ptr->work_function = work_function;
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_113: [ threadpool_create_work_item shall set the priority of the threadpool work item to THREADPOOL_PRIORITY_NORMAL. ]*/
+            threadpool_work_item_ptr->priority = THREADPOOL_PRIORITY_NORMAL;
+        }
+    }
+    return threadpool_work_item_ptr;
+}
+
+int threadpool_schedule_work_item(THANDLE(THREADPOOL) threadpool, THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item)
+{
+    int result;
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_05_010: [ If threadpool is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_05_011: [ If threadpool_work_item is NULL,  threadpool_schedule_work_item shall fail and set the return variable with a non-zero value. ] */
+        (threadpool_work_item == NULL)
+        )
+    {
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_WORK_ITEM_HANDLE threadpool_work_item: %p", threadpool, threadpool_work_item);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
 
-                /* Codes_SRS_THREADPOOL_LINUX_07_047: [ threadpool_schedule_work shall return zero on success. ]*/
-                result = 0;
+        /* Codes_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall push a task with the work_function and work_function_context of threadpool_work_item in a task queue of the priority lane of threadpool_work_item by calling threadpool_push_task. ]*/
+        THREADPOOL_TASK task = { threadpool_work_item->work_function, threadpool_work_item->work_function_ctx, 0 };
+        if (threadpool_push_task(threadpool_ptr, threadpool_work_item->priority, &task) != TQUEUE_PUSH_OK)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_020: [ If any error occurrs, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+            LogError("threadpool_push_task(threadpool_ptr=%p, &task=%p) failed", threadpool_ptr, &task);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_035: [ threadpool_schedule_work_item shall signal that work is available by calling threadpool_signal_work. ]*/
+            threadpool_signal_work(threadpool_ptr, 1);
 
-                goto all_ok;
-            }
+            /* Codes_SRS_THREADPOOL_LINUX_12_006: [ threadpool_schedule_work_item shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+            threadpool_add_thread_if_needed(threadpool_ptr);
 
-            THANDLE_FREE(THREADPOOL_WORK_ITEM)(threadpool_work_item_ptr);
+            /* Codes_SRS_THREADPOOL_LINUX_05_026: [ threadpool_schedule_work_item shall succeed and return 0. ]*/
+            result = 0;
         }
     }
-
-all_ok:
     return result;
 }
 
-static void threadpool_timer_dispose(THREADPOOL_TIMER* timer)
+uint32_t threadpool_linux_get_thread_count(THANDLE(THREADPOOL) threadpool)
 {
-    /* Codes_SRS_THREADPOOL_LINUX_07_071: [ threadpool_timer_dispose shall call timer_delete to destroy the ongoing timers. ]*/
-    if (timer_delete(timer->time_id) != 0)
+    uint32_t result;
+
+    if (threadpool == NULL)
     {
-        LogErrorNo("Failure calling timer_delete.");
+        /* Codes_SRS_THREADPOOL_LINUX_12_024: [ If threadpool is NULL, threadpool_linux_get_thread_count shall fail and return 0. ]*/
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p", threadpool);
+        result = 0;
     }
     else
     {
-        // Do Nothing
+        THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_025: [ Otherwise threadpool_linux_get_thread_count shall return the number of live threads in the threadpool. ]*/
+        result = (uint32_t)interlocked_add(&threadpool_ptr->thread_count, 0);
     }
 
-    CUSTOM_TIMER_DATA* custom_timer_data = timer->custom_timer_data;
+    return result;
+}
 
-    do
+int threadpool_linux_schedule_work_batch(THANDLE(THREADPOOL) threadpool, const THREADPOOL_WORK_BATCH_ENTRY* work_batch, uint32_t work_batch_count)
+{
+    int result;
+    uint32_t i = 0;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_12_083: [ If threadpool is NULL, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_084: [ If work_batch is NULL, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (work_batch == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_085: [ If work_batch_count is 0, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (work_batch_count == 0)
+        )
     {
-        /* Codes_SRS_THREADPOOL_LINUX_01_006: [ If the timer state is ARMED, threadpool_timer_dispose shall set the state of the timer to NOT_USED. ]*/
-        int32_t current_timer_state = interlocked_compare_exchange(&custom_timer_data->timer_state, TIMER_NOT_USED, TIMER_ARMED);
-        if (current_timer_state == TIMER_ARMED)
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, const THREADPOOL_WORK_BATCH_ENTRY* work_batch: %p, uint32_t work_batch_count: %" PRIu32 "",
+            threadpool, work_batch, work_batch_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        for (i = 0; i < work_batch_count; i++)
         {
-            wake_by_address_all(&custom_timer_data->timer_state);
-            break;
+            if (work_batch[i].work_function == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i < work_batch_count)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_086: [ If the work_function of any of the entries in work_batch is NULL, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+            LogError("Invalid arguments: work_batch[%" PRIu32 "].work_function is NULL", i);
+            result = MU_FAILURE;
         }
         else
         {
-            /* Codes_SRS_THREADPOOL_LINUX_01_010: [ Otherwise, threadpool_timer_dispose shall block until the state is ARMED and reattempt to set the state to NOT_USED. ]*/
-            (void)InterlockedHL_WaitForNotValue(&custom_timer_data->timer_state, current_timer_state, UINT32_MAX);
+            THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
+            TQUEUE(THREADPOOL_TASK) task_queue = threadpool_ptr->lanes[THREADPOOL_PRIORITY_NORMAL].task_queue;
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_114: [ threadpool_linux_schedule_work_batch shall obtain the enqueue time of the tasks by calling timer_global_get_elapsed_us once for the whole batch. ]*/
+            int64_t enqueue_time_us = (int64_t)timer_global_get_elapsed_us();
+
+            // the entries of a batch are meant to be spread over the workers, so they always go to the global task queue
+            THREADPOOL_TASK tasks[THREADPOOL_TASK_BATCH_SIZE];
+            i = 0;
+            while (i < work_batch_count)
+            {
+                uint32_t task_count = work_batch_count - i;
+                if (task_count > THREADPOOL_TASK_BATCH_SIZE)
+                {
+                    task_count = THREADPOOL_TASK_BATCH_SIZE;
+                }
+
+                for (uint32_t j = 0; j < task_count; j++)
+                {
+                    tasks[j].work_function = work_batch[i + j].work_function;
+                    tasks[j].work_function_ctx = work_batch[i + j].work_function_context;
+                    tasks[j].enqueue_time_us = enqueue_time_us;
+                }
+
+                /* Codes_SRS_THREADPOOL_LINUX_12_087: [ threadpool_linux_schedule_work_batch shall push tasks with the work_function and work_function_context of the entries in work_batch in the global task queue of the normal priority lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the entries are pushed. ]*/
+                uint32_t pushed_task_count;
+                TQUEUE_PUSH_RESULT push_result = TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(task_queue, tasks, task_count, NULL, &pushed_task_count);
+                if (push_result != TQUEUE_PUSH_OK)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_12_088: [ If pushing tasks fails, threadpool_linux_schedule_work_batch shall not push the remaining entries. ]*/
+                    LogError("TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(task_queue=%p, tasks=%p, task_count=%" PRIu32 ", NULL, &pushed_task_count=%p) failed with %" PRI_MU_ENUM " for entry %" PRIu32 "",
+                        task_queue, tasks, task_count, &pushed_task_count, MU_ENUM_VALUE(TQUEUE_PUSH_RESULT, push_result), i);
+                    break;
+                }
+
+                i += pushed_task_count;
+            }
+
+            if (i > 0)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_089: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+                threadpool_signal_work(threadpool_ptr, i);
+
+                /* Codes_SRS_THREADPOOL_LINUX_12_090: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+                threadpool_add_thread_if_needed(threadpool_ptr);
+            }
+
+            if (i < work_batch_count)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_091: [ If any of the entries could not be pushed, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_092: [ threadpool_linux_schedule_work_batch shall succeed and return 0. ]*/
+                result = 0;
+            }
         }
-    } while (1);
+    }
+
+    return result;
 }
 
-THANDLE(THREADPOOL_TIMER) threadpool_timer_start(THANDLE(THREADPOOL) threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_ctx)
+int threadpool_linux_schedule_work_item_batch(THANDLE(THREADPOOL) threadpool, THANDLE(THREADPOOL_WORK_ITEM)* threadpool_work_items, uint32_t work_item_count)
 {
-    THREADPOOL_TIMER* result = NULL;
+    int result;
 
     if (
-        /* Codes_SRS_THREADPOOL_LINUX_07_054: [ If threadpool is NULL, threadpool_timer_start shall fail and return NULL. ]*/
-        threadpool == NULL ||
-        /* Codes_SRS_THREADPOOL_LINUX_07_055: [ If work_function is NULL, threadpool_timer_start shall fail and return NULL. ]*/
-        work_function == NULL
+        /* Codes_SRS_THREADPOOL_LINUX_12_093: [ If threadpool is NULL, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_094: [ If threadpool_work_items is NULL, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+        (threadpool_work_items == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_095: [ If work_item_count is 0, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+        (work_item_count == 0)
         )
     {
-        LogError("Invalid args: THANDLE(THREADPOOL) threadpool = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function = %p, void* work_function_context = %p",
-            threadpool, start_delay_ms, timer_period_ms, work_function, work_function_ctx);
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THANDLE(THREADPOOL_WORK_ITEM)* threadpool_work_items: %p, uint32_t work_item_count: %" PRIu32 "",
+            threadpool, threadpool_work_items, work_item_count);
+        result = MU_FAILURE;
     }
     else
     {
-        /* Codes_SRS_THREADPOOL_LINUX_07_058: [ threadpool_timer_start shall allocate memory for THANDLE(THREADPOOL_TIMER), passing threadpool_timer_dispose as dispose function and store work_function and work_function_ctx in it. ]*/
-        result = THANDLE_MALLOC(THREADPOOL_TIMER)(threadpool_timer_dispose);
-        if (result == NULL)
+        uint32_t i;
+        for (i = 0; i < work_item_count; i++)
         {
-            LogError("failure in THANDLE_MALLOC(THREADPOOL_TIMER)(threadpool_timer_dispose=%p)",
-                        threadpool_timer_dispose);
+            if (threadpool_work_items[i] == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i < work_item_count)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_12_096: [ If any of the work items in threadpool_work_items is NULL, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+            LogError("Invalid arguments: threadpool_work_items[%" PRIu32 "] is NULL", i);
+            result = MU_FAILURE;
         }
         else
         {
-            /* Codes_SRS_THREADPOOL_LINUX_07_096: [ threadpool_timer_start shall call lazy_init with do_init as initialization function.  ]*/
-            if(lazy_init(&g_lazy, do_init, NULL) != LAZY_INIT_OK)
-            {
-                /* Codes_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
-                LogError("failure in lazy_init(&g_lazy=%p, do_init=%p, NULL)", &g_lazy, do_init);
-            }
-            else
-            {
-                uint32_t i;
+            THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
 
-                /* Codes_SRS_THREADPOOL_LINUX_01_002: [ threadpool_timer_start shall find an unused entry in the timers table maintained by the module. ]*/
-                for (i = 0; i < TIMER_TABLE_SIZE; i++)
-                {
-                    /* Codes_SRS_THREADPOOL_LINUX_01_005: [ If an unused entry is found, it's state shall be marked as ARMED. ]*/
-                    if (interlocked_compare_exchange(&timer_table[i].timer_state, TIMER_ARMED, TIMER_NOT_USED) == TIMER_NOT_USED)
-                    {
-                        // found an unused timer entry
-                        break;
-                    }
-                }
+            /* Codes_SRS_THREADPOOL_LINUX_12_115: [ threadpool_linux_schedule_work_item_batch shall obtain the enqueue time of the tasks by calling timer_global_get_elapsed_us once for the whole batch. ]*/
+            int64_t enqueue_time_us = (int64_t)timer_global_get_elapsed_us();
 
-                if (i == TIMER_TABLE_SIZE)
-                {
-                    /* Codes_SRS_THREADPOOL_LINUX_01_001: [ If all timer entries are used, threadpool_timer_start shall fail and return NULL. ]*/
-                    LogError("No timers available");
-                }
-                else
+            // the work items of a batch are meant to be spread over the workers, so they always go to the global task queues
+            THREADPOOL_TASK tasks[THREADPOOL_TASK_BATCH_SIZE];
+            uint32_t pushed_task_count = 0;
+            bool push_failed = false;
+
+            for (uint32_t priority = 0; (priority < THREADPOOL_PRIORITY_COUNT) && !push_failed; priority++)
+            {
+                TQUEUE(THREADPOOL_TASK) task_queue = threadpool_ptr->lanes[priority].task_queue;
+
+                i = 0;
+                while ((i < work_item_count) && !push_failed)
                 {
-                    // point custom data to the proper place in the table
-                    CUSTOM_TIMER_DATA* custom_timer_data = &timer_table[i];
-                    result->custom_timer_data = custom_timer_data;
+                    uint32_t task_count = 0;
 
-                    /* Codes_SRS_THREADPOOL_LINUX_01_011: [ threadpool_timer_start shall increment the timer epoch number and store it in the selected entry in the timer table. ]*/
-                    do
+                    for (; (i < work_item_count) && (task_count < THREADPOOL_TASK_BATCH_SIZE); i++)
                     {
-                        int64_t current_epoch_number = interlocked_add_64(&timer_epoch_number, 0);
-                        int64_t new_epoch_number;
-                        if (timer_epoch_number == TIMER_EPOCH_MAX)
-                        {
-                            new_epoch_number = 0;
-                        }
-                        else
-                        {
-                            new_epoch_number = current_epoch_number + 1;
-                        }
-                        if (interlocked_compare_exchange_64(&timer_epoch_number, new_epoch_number, current_epoch_number) == current_epoch_number)
-                        {
-                            custom_timer_data->epoch_number = new_epoch_number;
-                            break;
-                        }
-                        else
+                        if ((uint32_t)threadpool_work_items[i]->priority == priority)
                         {
-                            // somethiung changed, try again
+                            tasks[task_count].work_function = threadpool_work_items[i]->work_function;
+                            tasks[task_count].work_function_ctx = threadpool_work_items[i]->work_function_ctx;
+                            tasks[task_count].enqueue_time_us = enqueue_time_us;
+                            task_count++;
                         }
-                    } while (1);
-                    
-                    custom_timer_data->work_function = work_function;
-                    /* Codes_SRS_THREADPOOL_LINUX_07_057: [ work_function_ctx shall be allowed to be NULL. ]*/
-                    custom_timer_data->work_function_ctx = work_function_ctx;
-    
-                    struct sigevent sigev = {0};
-                    timer_t time_id = 0;
-    
-                    sigev.sigev_notify          = SIGEV_THREAD;
-                    sigev.sigev_notify_function = on_timer_callback;
-                    sigev.sigev_value.sival_ptr = MAKE_SIGVAL_FROM_INDEX_AND_EPOCH(i, custom_timer_data->epoch_number);
-    
-                    /* Codes_SRS_THREADPOOL_LINUX_07_059: [ threadpool_timer_start shall call timer_create and timer_settime to schedule execution. ]*/
-                    if (timer_create(CLOCK_REALTIME, &sigev, &time_id) != 0)
-                    {
-                        LogErrorNo("Failure calling timer_create.");
                     }
-                    else
+
+                    /* Codes_SRS_THREADPOOL_LINUX_12_152: [ For each priority lane, threadpool_linux_schedule_work_item_batch shall push tasks with the work_function and work_function_context of the work items of that priority in the global task queue of the lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the work items of that priority are pushed. ]*/
+                    uint32_t lane_task_index = 0;
+                    while (lane_task_index < task_count)
                     {
-                        struct itimerspec its;
-                        its.it_value.tv_sec = start_delay_ms / 1000;
-                        its.it_value.tv_nsec = start_delay_ms * MILLISEC_TO_NANOSEC % 1000000000;
-                        its.it_interval.tv_sec = timer_period_ms / 1000;
-                        its.it_interval.tv_nsec = timer_period_ms * MILLISEC_TO_NANOSEC % 1000000000;
-    
-                        if (timer_settime(time_id, 0, &its, NULL) == -1)
-                        {
-                            LogErrorNo("Failure calling timer_settime");
-                        }
-                        else
+                        uint32_t lane_pushed_task_count;
+                        TQUEUE_PUSH_RESULT push_result = TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(task_queue, &tasks[lane_task_index], task_count - lane_task_index, NULL, &lane_pushed_task_count);
+                        if (push_result != TQUEUE_PUSH_OK)
                         {
-                            /* Codes_SRS_THREADPOOL_LINUX_07_062: [ threadpool_timer_start shall succeed and return a non-NULL handle. ]*/
-                            result->time_id = time_id;
-                            goto all_ok;
-                        }
-                        /* Codes_SRS_THREADPOOL_LINUX_07_063: [ If timer_settime fails, threadpool_timer_start shall delete the timer by calling timer_delete. ]*/
-                        if (timer_delete(time_id) != 0)
-                        {
-                            LogErrorNo("Failure calling timer_delete.");
+                            /* Codes_SRS_THREADPOOL_LINUX_12_098: [ If pushing a task fails, threadpool_linux_schedule_work_item_batch shall not push the remaining work items. ]*/
+                            LogError("TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(task_queue=%p, tasks=%p, task_count=%" PRIu32 ", NULL, &lane_pushed_task_count=%p) failed with %" PRI_MU_ENUM " for priority %" PRIu32 "",
+                                task_queue, &tasks[lane_task_index], task_count - lane_task_index, &lane_pushed_task_count, MU_ENUM_VALUE(TQUEUE_PUSH_RESULT, push_result), priority);
+                            push_failed = true;
+                            break;
                         }
+
+                        lane_task_index += lane_pushed_task_count;
                     }
 
-                    (void)interlocked_exchange(&custom_timer_data[i].timer_state, TIMER_NOT_USED);
+                    pushed_task_count += lane_task_index;
                 }
             }
 
-            THANDLE_FREE(THREADPOOL_TIMER)(result);
+            if (pushed_task_count > 0)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_100: [ If at least one task was pushed, threadpool_linux_schedule_work_item_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+                threadpool_signal_work(threadpool_ptr, pushed_task_count);
+
+                /* Codes_SRS_THREADPOOL_LINUX_12_101: [ If at least one task was pushed, threadpool_linux_schedule_work_item_batch shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+                threadpool_add_thread_if_needed(threadpool_ptr);
+            }
+
+            if (push_failed)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_102: [ If any of the work items could not be pushed, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_12_099: [ threadpool_linux_schedule_work_item_batch shall succeed and return 0. ]*/
+                result = 0;
+            }
         }
-        /* Codes_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
-        result = NULL;
     }
-all_ok:
+
     return result;
 }
 
-int threadpool_timer_restart(THANDLE(THREADPOOL_TIMER) timer, uint32_t start_delay_ms, uint32_t timer_period_ms)
+THANDLE(THREADPOOL_WORK_ITEM) threadpool_linux_create_work_item_with_priority(THANDLE(THREADPOOL) threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
 {
-    int result;
-    if (timer == NULL)
+    THREADPOOL_WORK_ITEM_HANDLE threadpool_work_item_ptr = NULL;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_12_116: [ If threadpool is NULL, threadpool_linux_create_work_item_with_priority shall fail and return NULL. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_117: [ If priority is not a valid THREADPOOL_PRIORITY value, threadpool_linux_create_work_item_with_priority shall fail and return NULL. ]*/
+        ((uint32_t)priority >= THREADPOOL_PRIORITY_COUNT) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_118: [ If work_function is NULL, threadpool_linux_create_work_item_with_priority shall fail and return NULL. ]*/
+        (work_function == NULL)
+        )
     {
-        /* Codes_SRS_THREADPOOL_LINUX_07_064: [ If timer is NULL, threadpool_timer_restart shall fail and return a non-zero value. ]*/
-        LogError("Invalid args: THANDLE(THREADPOOL_TIMER) timer = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 "",
-            timer, start_delay_ms, timer_period_ms);
-        result = MU_FAILURE;
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_PRIORITY priority: %" PRI_MU_ENUM ", THREADPOOL_WORK_FUNCTION work_function: %p, void* work_function_context: %p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), work_function, work_function_context);
     }
     else
     {
-        struct itimerspec its = {0};
-        its.it_value.tv_sec = start_delay_ms / 1000;
-        its.it_value.tv_nsec = start_delay_ms * MILLISEC_TO_NANOSEC % 1000000000;
-        its.it_interval.tv_sec = timer_period_ms / 1000;
-        its.it_interval.tv_nsec = timer_period_ms * MILLISEC_TO_NANOSEC % 1000000000;
-
-        THREADPOOL_TIMER * timer_content = THANDLE_GET_T(THREADPOOL_TIMER)(timer);
+        /* Codes_SRS_THREADPOOL_LINUX_12_119: [ threadpool_linux_create_work_item_with_priority shall allocate memory for a work item of type THANDLE(THREADPOOL_WORK_ITEM). ]*/
+        threadpool_work_item_ptr = THANDLE_MALLOC(THREADPOOL_WORK_ITEM)(NULL);
 
-        /* Codes_SRS_THREADPOOL_LINUX_07_065: [ threadpool_timer_restart shall call timer_settime to change the delay and period. ]*/
-        if (timer_settime(timer_content->time_id, 0, &its, NULL) != 0)
+        if (threadpool_work_item_ptr == NULL)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_07_066: [ If timer_settime fails, threadpool_timer_restart shall fail and return a non-zero value. ]*/
-            LogErrorNo("Failure calling timer_settime.");
-            result = MU_FAILURE;
+            /* Codes_SRS_THREADPOOL_LINUX_12_120: [ If allocating the memory fails, threadpool_linux_create_work_item_with_priority shall fail and return NULL. ]*/
+            LogError("THANDLE_MALLOC(THREADPOOL_WORK_ITEM)(NULL) failed");
         }
         else
         {
-            /* Codes_SRS_THREADPOOL_LINUX_07_067: [ threadpool_timer_restart shall succeed and return 0. ]*/
-            result = 0;
+            /* Codes_SRS_THREADPOOL_LINUX_12_121: [ threadpool_linux_create_work_item_with_priority shall copy the work_function, work_function_context and priority into the work item and return it. ]*/
+            threadpool_work_item_ptr->work_function_ctx = work_function_context;
+            threadpool_work_item_ptr->work_function = work_function;
+            threadpool_work_item_ptr->priority = priority;
         }
     }
-    return result;
+    return threadpool_work_item_ptr;
 }
 
-void threadpool_timer_cancel(THANDLE(THREADPOOL_TIMER) timer)
+int threadpool_linux_schedule_work_with_priority(THANDLE(THREADPOOL) threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
 {
-    if (timer == NULL)
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_12_122: [ If threadpool is NULL, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_123: [ If priority is not a valid THREADPOOL_PRIORITY value, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        ((uint32_t)priority >= THREADPOOL_PRIORITY_COUNT) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_124: [ If work_function is NULL, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        (work_function == NULL)
+        )
     {
-        /* Codes_SRS_THREADPOOL_LINUX_07_068: [ If timer is NULL, threadpool_timer_cancel shall fail and return. ]*/
-        LogError("Invalid args: THANDLE(THREADPOOL_TIMER) timer = %p", timer);
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_PRIORITY priority: %" PRI_MU_ENUM ", THREADPOOL_WORK_FUNCTION work_function: %p, void* work_function_context: %p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), work_function, work_function_context);
+        result = MU_FAILURE;
     }
     else
     {
-        THREADPOOL_TIMER * timer_content = THANDLE_GET_T(THREADPOOL_TIMER)(timer);
+        THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
 
-        struct itimerspec its = {0};
-        /* Codes_SRS_THREADPOOL_LINUX_07_069: [ threadpool_timer_cancel shall call timer_settime with 0 for flags and NULL for old_value and {0} for new_value to cancel the ongoing timers. ]*/
-        if (timer_settime(timer_content->time_id, 0, &its, NULL) != 0)
+        /* Codes_SRS_THREADPOOL_LINUX_12_125: [ threadpool_linux_schedule_work_with_priority shall push a task with work_function and work_function_context in a task queue of the priority lane by calling threadpool_push_task. ]*/
+        THREADPOOL_TASK task = { work_function, work_function_context, 0 };
+        if (threadpool_push_task(threadpool_ptr, priority, &task) != TQUEUE_PUSH_OK)
         {
-            LogErrorNo("Failure calling timer_settime");
+            /* Codes_SRS_THREADPOOL_LINUX_12_126: [ If threadpool_push_task fails, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+            LogError("threadpool_push_task(threadpool_ptr=%p, priority=%" PRI_MU_ENUM ", &task=%p) failed", threadpool_ptr, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), &task);
+            result = MU_FAILURE;
         }
         else
         {
-            // Do Nothing
+            /* Codes_SRS_THREADPOOL_LINUX_12_127: [ threadpool_linux_schedule_work_with_priority shall signal that work is available by calling threadpool_signal_work. ]*/
+            threadpool_signal_work(threadpool_ptr, 1);
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_128: [ threadpool_linux_schedule_work_with_priority shall add a new thread if all live threads are busy and the task queues are backing up. ]*/
+            threadpool_add_thread_if_needed(threadpool_ptr);
+
+            /* Codes_SRS_THREADPOOL_LINUX_12_129: [ threadpool_linux_schedule_work_with_priority shall succeed and return 0. ]*/
+            result = 0;
         }
     }
+
+    return result;
 }
 
-THANDLE(THREADPOOL_WORK_ITEM) threadpool_create_work_item(THANDLE(THREADPOOL) threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+int threadpool_linux_get_lane_statistics(THANDLE(THREADPOOL) threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_LANE_STATISTICS* lane_statistics)
 {
-    THREADPOOL_WORK_ITEM_HANDLE threadpool_work_item_ptr = NULL;
+    int result;
 
     if (
-        /* Codes_SRS_THREADPOOL_LINUX_05_001: [ If threadpool is NULL, threadpool_create_work_item shall fail and return a NULL value. ] */
+        /* Codes_SRS_THREADPOOL_LINUX_12_130: [ If threadpool is NULL, threadpool_linux_get_lane_statistics shall fail and return a non-zero value. ]*/
         (threadpool == NULL) ||
-        /* Codes_SRS_THREADPOOL_LINUX_05_002: [ If work_function is NULL, threadpool_create_work_item shall fail and return a NULL value. ]*/
-        (work_function == NULL)
+        /* Codes_SRS_THREADPOOL_LINUX_12_131: [ If priority is not a valid THREADPOOL_PRIORITY value, threadpool_linux_get_lane_statistics shall fail and return a non-zero value. ]*/
+        ((uint32_t)priority >= THREADPOOL_PRIORITY_COUNT) ||
+        /* Codes_SRS_THREADPOOL_LINUX_12_132: [ If lane_statistics is NULL, threadpool_linux_get_lane_statistics shall fail and return a non-zero value. ]*/
+        (lane_statistics == NULL)
         )
     {
-        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_WORK_FUNCTION work_function: %p, void* work_function_ctx: %p", threadpool, work_function, work_function_context);
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_PRIORITY priority: %" PRI_MU_ENUM ", THREADPOOL_LANE_STATISTICS* lane_statistics: %p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), lane_statistics);
+        result = MU_FAILURE;
     }
     else
     {
-        /* Codes_SRS_THREADPOOL_LINUX_05_005: [ threadpool_create_work_item shall allocate memory for threadpool_work_item of type THANDLE(THREADPOOL_WORK_ITEM). ] */
-        threadpool_work_item_ptr = THANDLE_MALLOC(THREADPOOL_WORK_ITEM)(NULL);
+        THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
 
-        if (threadpool_work_item_ptr == NULL)
+        /* Codes_SRS_THREADPOOL_LINUX_12_133: [ threadpool_linux_get_lane_statistics shall set the queue depth to the number of tasks in the global task queue of the lane obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK). ]*/
+        int64_t queue_depth = TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(threadpool_ptr->lanes[priority].task_queue);
+
+        if (priority == THREADPOOL_PRIORITY_NORMAL)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_05_006: [ If during the initialization of threadpool_work_item, malloc fails then threadpool_create_work_item shall fail and return a NULL value. ]*/
-            LogError("Could not allocate memory for Work Item Context");
+            /* Codes_SRS_THREADPOOL_LINUX_12_134: [ For the normal priority lane, threadpool_linux_get_lane_statistics shall add to the queue depth the number of tasks in the local queues of all the thread slots obtained by calling threadpool_task_deque_get_volatile_count. ]*/
+            for (uint32_t i = 0; i < threadpool_ptr->thread_array_size; i++)
+            {
+                queue_depth += threadpool_task_deque_get_volatile_count(&threadpool_ptr->thread_array[i].local_queue);
+            }
         }
-        else
+
+        lane_statistics->queue_depth = (queue_depth < 0) ? 0 : (uint64_t)queue_depth;
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_135: [ threadpool_linux_get_lane_statistics shall set the executed count and the total wait time to the sum of the values accumulated for the lane in the counters of all the thread slots. ]*/
+        lane_statistics->executed_count = 0;
+        lane_statistics->total_wait_time_us = 0;
+        for (uint32_t i = 0; i < threadpool_ptr->thread_array_size; i++)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_05_007: [ threadpool_create_work_item shall copy the work_function and work_function_context into the threadpool work item. ] */
-            threadpool_work_item_ptr->work_function_ctx = work_function_context;
-            threadpool_work_item_ptr->work_function = work_function;
+            THREADPOOL_THREAD_COUNTERS* counters = &threadpool_ptr->thread_array[i].counters;
+            lane_statistics->executed_count += (uint64_t)interlocked_add_64(&counters->executed_count[priority], 0);
+            lane_statistics->total_wait_time_us += (uint64_t)interlocked_add_64(&counters->total_wait_time_us[priority], 0);
         }
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_136: [ threadpool_linux_get_lane_statistics shall succeed and return 0. ]*/
+        result = 0;
     }
-    return threadpool_work_item_ptr;
+
+    return result;
 }
 
-int threadpool_schedule_work_item(THANDLE(THREADPOOL) threadpool, THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item)
+int threadpool_linux_get_statistics(THANDLE(THREADPOOL) threadpool, THREADPOOL_STATISTICS* statistics)
 {
     int result;
+
     if (
-        /* Codes_SRS_THREADPOOL_LINUX_05_010: [ If threadpool is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+        /* Codes_SRS_THREADPOOL_LINUX_12_139: [ If threadpool is NULL, threadpool_linux_get_statistics shall fail and return a non-zero value. ]*/
         (threadpool == NULL) ||
-        /* Codes_SRS_THREADPOOL_LINUX_05_011: [ If threadpool_work_item is NULL,  threadpool_schedule_work_item shall fail and set the return variable with a non-zero value. ] */
-        (threadpool_work_item == NULL)
+        /* Codes_SRS_THREADPOOL_LINUX_12_140: [ If statistics is NULL, threadpool_linux_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
         )
     {
-        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_WORK_ITEM_HANDLE threadpool_work_item: %p", threadpool, threadpool_work_item);
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool: %p, THREADPOOL_STATISTICS* statistics: %p",
+            threadpool, statistics);
         result = MU_FAILURE;
     }
     else
     {
         THREADPOOL* threadpool_ptr = THANDLE_GET_T(THREADPOOL)(threadpool);
 
-        /* Codes_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall TQUEUE_PUSH the threadpool_work_item into the task queue. ]*/
-        if (TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(threadpool_ptr->task_queue, &threadpool_work_item, NULL) != TQUEUE_PUSH_OK)
+        (void)memset(statistics, 0, sizeof(THREADPOOL_STATISTICS));
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_141: [ threadpool_linux_get_statistics shall set the queue depth to the number of tasks in the global task queues of all the lanes obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK) and in the local queues of all the thread slots obtained by calling threadpool_task_deque_get_volatile_count. ]*/
+        int64_t queue_depth = 0;
+        for (uint32_t i = 0; i < THREADPOOL_PRIORITY_COUNT; i++)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_01_020: [ If any error occurrs, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
-            LogError("TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(threadpool_ptr->task_queue, &threadpool_work_item, NULL) failed");
-            result = MU_FAILURE;
+            queue_depth += TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(threadpool_ptr->lanes[i].task_queue);
         }
-        else
+        for (uint32_t i = 0; i < threadpool_ptr->thread_array_size; i++)
         {
-            /* Codes_SRS_THREADPOOL_LINUX_05_025: [ threadpool_schedule_work_item shall unblock the threadpool semaphore by calling sem_post. ]*/
-            sem_post(&threadpool_ptr->semaphore);
+            queue_depth += threadpool_task_deque_get_volatile_count(&threadpool_ptr->thread_array[i].local_queue);
+        }
+        statistics->queue_depth = (queue_depth < 0) ? 0 : (uint64_t)queue_depth;
 
-            /* Codes_SRS_THREADPOOL_LINUX_05_026: [ threadpool_schedule_work_item shall succeed and return 0. ]*/
-            result = 0;
+        /* Codes_SRS_THREADPOOL_LINUX_12_142: [ threadpool_linux_get_statistics shall set the number of live threads, the number of active threads and the number of idle threads (the threads waiting for work). ]*/
+        statistics->thread_count = (uint32_t)interlocked_add(&threadpool_ptr->thread_count, 0);
+        statistics->active_thread_count = (uint32_t)interlocked_add(&threadpool_ptr->active_thread_count, 0);
+        statistics->idle_thread_count = (uint32_t)interlocked_add(&threadpool_ptr->waiting_thread_count, 0);
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_143: [ threadpool_linux_get_statistics shall set the executed count, the wait time histogram and the execution time histogram to the sum of the counters of all the thread slots. ]*/
+        for (uint32_t i = 0; i < threadpool_ptr->thread_array_size; i++)
+        {
+            THREADPOOL_THREAD_COUNTERS* counters = &threadpool_ptr->thread_array[i].counters;
+
+            for (uint32_t j = 0; j < THREADPOOL_PRIORITY_COUNT; j++)
+            {
+                statistics->executed_count += (uint64_t)interlocked_add_64(&counters->executed_count[j], 0);
+                statistics->wait_time.total_latency_us += (uint64_t)interlocked_add_64(&counters->total_wait_time_us[j], 0);
+            }
+            for (uint32_t j = 0; j < THREADPOOL_LATENCY_BUCKET_COUNT; j++)
+            {
+                statistics->wait_time.buckets[j] += (uint64_t)interlocked_add_64(&counters->wait_time_buckets[j], 0);
+                statistics->execution_time.buckets[j] += (uint64_t)interlocked_add_64(&counters->execution_time_buckets[j], 0);
+            }
+            statistics->execution_time.total_latency_us += (uint64_t)interlocked_add_64(&counters->total_execution_time_us, 0);
         }
+
+        /* Codes_SRS_THREADPOOL_LINUX_12_144: [ threadpool_linux_get_statistics shall succeed and return 0. ]*/
+        result = 0;
     }
+
     return result;
 }
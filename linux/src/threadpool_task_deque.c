@@ -0,0 +1,229 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <inttypes.h>
+#include <stdint.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h" // IWYU pragma: keep
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/tqueue_threadpool_task.h"
+
+#include "c_pal/threadpool_task_deque.h"
+
+MU_DEFINE_ENUM_STRINGS(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_RESULT_VALUES)
+
+int threadpool_task_deque_init(THREADPOOL_TASK_DEQUE* deque, uint32_t capacity)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_001: [ If deque is NULL, threadpool_task_deque_init shall fail and return a non-zero value. ]*/
+        (deque == NULL) ||
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_002: [ If capacity is 0 or is not a power of 2, threadpool_task_deque_init shall fail and return a non-zero value. ]*/
+        (capacity == 0) ||
+        ((capacity & (capacity - 1)) != 0)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_TASK_DEQUE* deque=%p, uint32_t capacity=%" PRIu32 "", deque, capacity);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_003: [ threadpool_task_deque_init shall allocate the array of capacity tasks by calling malloc_2. ]*/
+        deque->tasks = malloc_2(capacity, sizeof(THREADPOOL_TASK));
+        if (deque->tasks == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_004: [ If malloc_2 fails, threadpool_task_deque_init shall fail and return a non-zero value. ]*/
+            LogError("failure in malloc_2(capacity=%" PRIu32 ", sizeof(THREADPOOL_TASK)=%zu)", capacity, sizeof(THREADPOOL_TASK));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_005: [ threadpool_task_deque_init shall initialize top and bottom to 0 and return 0. ]*/
+            deque->capacity_mask = capacity - 1;
+            (void)interlocked_exchange_64(&deque->top, 0);
+            (void)interlocked_exchange_64(&deque->bottom, 0);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+void threadpool_task_deque_deinit(THREADPOOL_TASK_DEQUE* deque)
+{
+    if (deque == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_006: [ If deque is NULL, threadpool_task_deque_deinit shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_TASK_DEQUE* deque=%p", deque);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_007: [ Otherwise, threadpool_task_deque_deinit shall free the array of tasks. ]*/
+        free(deque->tasks);
+        deque->tasks = NULL;
+    }
+}
+
+THREADPOOL_TASK_DEQUE_RESULT threadpool_task_deque_push(THREADPOOL_TASK_DEQUE* deque, const THREADPOOL_TASK* task)
+{
+    THREADPOOL_TASK_DEQUE_RESULT result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_008: [ If deque is NULL or task is NULL, threadpool_task_deque_push shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+        (deque == NULL) ||
+        (task == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_TASK_DEQUE* deque=%p, const THREADPOOL_TASK* task=%p", deque, task);
+        result = THREADPOOL_TASK_DEQUE_INVALID_ARGS;
+    }
+    else
+    {
+        int64_t bottom = interlocked_add_64(&deque->bottom, 0);
+        int64_t top = interlocked_add_64(&deque->top, 0);
+
+        if (bottom - top > (int64_t)deque->capacity_mask)
+        {
+            /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_009: [ If the deque already holds capacity tasks, threadpool_task_deque_push shall return THREADPOOL_TASK_DEQUE_FULL. ]*/
+            result = THREADPOOL_TASK_DEQUE_FULL;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_010: [ Otherwise, threadpool_task_deque_push shall copy the task at index bottom, publish it by setting bottom to bottom + 1 with interlocked_exchange_64 and return THREADPOOL_TASK_DEQUE_OK. ]*/
+            // the slot cannot be read by a thief until bottom is published: thieves only read the slots between top and bottom
+            deque->tasks[bottom & deque->capacity_mask] = *task;
+            (void)interlocked_exchange_64(&deque->bottom, bottom + 1);
+            result = THREADPOOL_TASK_DEQUE_OK;
+        }
+    }
+
+    return result;
+}
+
+THREADPOOL_TASK_DEQUE_RESULT threadpool_task_deque_pop(THREADPOOL_TASK_DEQUE* deque, THREADPOOL_TASK* task)
+{
+    THREADPOOL_TASK_DEQUE_RESULT result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_011: [ If deque is NULL or task is NULL, threadpool_task_deque_pop shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+        (deque == NULL) ||
+        (task == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_TASK_DEQUE* deque=%p, THREADPOOL_TASK* task=%p", deque, task);
+        result = THREADPOOL_TASK_DEQUE_INVALID_ARGS;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_012: [ threadpool_task_deque_pop shall claim the task at index bottom - 1 by setting bottom to bottom - 1 with interlocked_exchange_64 before reading top. ]*/
+        // the store of bottom has to be ordered before the load of top, otherwise the owner and a thief could both take the last task
+        int64_t bottom = interlocked_add_64(&deque->bottom, 0) - 1;
+        (void)interlocked_exchange_64(&deque->bottom, bottom);
+        int64_t top = interlocked_add_64(&deque->top, 0);
+
+        if (top > bottom)
+        {
+            /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_013: [ If the deque is empty, threadpool_task_deque_pop shall restore bottom and return THREADPOOL_TASK_DEQUE_EMPTY. ]*/
+            (void)interlocked_exchange_64(&deque->bottom, bottom + 1);
+            result = THREADPOOL_TASK_DEQUE_EMPTY;
+        }
+        else if (top < bottom)
+        {
+            /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_014: [ If the claimed task is not the last task in the deque, threadpool_task_deque_pop shall copy it to task and return THREADPOOL_TASK_DEQUE_OK. ]*/
+            *task = deque->tasks[bottom & deque->capacity_mask];
+            result = THREADPOOL_TASK_DEQUE_OK;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_015: [ If the claimed task is the last task in the deque, threadpool_task_deque_pop shall race the thieves for it by incrementing top with interlocked_compare_exchange_64 and shall then restore bottom. ]*/
+            if (interlocked_compare_exchange_64(&deque->top, top + 1, top) != top)
+            {
+                /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_016: [ If incrementing top fails, threadpool_task_deque_pop shall return THREADPOOL_TASK_DEQUE_EMPTY. ]*/
+                result = THREADPOOL_TASK_DEQUE_EMPTY;
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_017: [ Otherwise threadpool_task_deque_pop shall copy the task to task and return THREADPOOL_TASK_DEQUE_OK. ]*/
+                *task = deque->tasks[bottom & deque->capacity_mask];
+                result = THREADPOOL_TASK_DEQUE_OK;
+            }
+
+            // top is now bottom + 1 either way, the deque is empty
+            (void)interlocked_exchange_64(&deque->bottom, bottom + 1);
+        }
+    }
+
+    return result;
+}
+
+THREADPOOL_TASK_DEQUE_RESULT threadpool_task_deque_steal(THREADPOOL_TASK_DEQUE* deque, THREADPOOL_TASK* task)
+{
+    THREADPOOL_TASK_DEQUE_RESULT result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_018: [ If deque is NULL or task is NULL, threadpool_task_deque_steal shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+        (deque == NULL) ||
+        (task == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_TASK_DEQUE* deque=%p, THREADPOOL_TASK* task=%p", deque, task);
+        result = THREADPOOL_TASK_DEQUE_INVALID_ARGS;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_019: [ threadpool_task_deque_steal shall read top and then bottom and if top is not less than bottom it shall return THREADPOOL_TASK_DEQUE_EMPTY. ]*/
+        int64_t top = interlocked_add_64(&deque->top, 0);
+        int64_t bottom = interlocked_add_64(&deque->bottom, 0);
+
+        if (top >= bottom)
+        {
+            result = THREADPOOL_TASK_DEQUE_EMPTY;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_020: [ Otherwise threadpool_task_deque_steal shall copy the task at index top and claim it by incrementing top with interlocked_compare_exchange_64. ]*/
+            // the copy has to be made before claiming the slot: once top moves the owner may reuse the slot.
+            // If the slot was reused while copying, top has moved and the copy is discarded below.
+            THREADPOOL_TASK stolen_task = deque->tasks[top & deque->capacity_mask];
+            if (interlocked_compare_exchange_64(&deque->top, top + 1, top) != top)
+            {
+                /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_021: [ If incrementing top fails, threadpool_task_deque_steal shall return THREADPOOL_TASK_DEQUE_ABORT. ]*/
+                result = THREADPOOL_TASK_DEQUE_ABORT;
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_022: [ Otherwise threadpool_task_deque_steal shall copy the task to task and return THREADPOOL_TASK_DEQUE_OK. ]*/
+                *task = stolen_task;
+                result = THREADPOOL_TASK_DEQUE_OK;
+            }
+        }
+    }
+
+    return result;
+}
+
+int64_t threadpool_task_deque_get_volatile_count(THREADPOOL_TASK_DEQUE* deque)
+{
+    int64_t result;
+
+    if (deque == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_023: [ If deque is NULL, threadpool_task_deque_get_volatile_count shall return 0. ]*/
+        LogError("Invalid arguments: THREADPOOL_TASK_DEQUE* deque=%p", deque);
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_TASK_DEQUE_12_024: [ Otherwise threadpool_task_deque_get_volatile_count shall return bottom - top read with interlocked_add_64, or 0 if the difference is negative. ]*/
+        int64_t top = interlocked_add_64(&deque->top, 0);
+        int64_t bottom = interlocked_add_64(&deque->bottom, 0);
+        result = (bottom > top) ? (bottom - top) : 0;
+    }
+
+    return result;
+}
@@ -6,7 +6,7 @@
 #include "c_pal/thandle.h"
 #include "c_pal/tqueue.h"
 
-#include "c_pal/tqueue_threadpool_work_item.h"
+#include "c_pal/tqueue_threadpool_task.h"
 
-THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(THANDLE(THREADPOOL_WORK_ITEM)));
-TQUEUE_TYPE_DEFINE(THANDLE(THREADPOOL_WORK_ITEM));
+THANDLE_TYPE_DEFINE(TQUEUE_TYPEDEF_NAME(THREADPOOL_TASK));
+TQUEUE_TYPE_DEFINE(THREADPOOL_TASK);
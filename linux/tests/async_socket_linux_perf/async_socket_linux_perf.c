@@ -0,0 +1,286 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "c_logging/logger.h"
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "testrunnerswitcher.h"
+
+#include "c_pal/timer.h"
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/socket_handle.h"
+#include "c_pal/sync.h"
+#include "c_pal/async_socket.h"
+#include "c_pal/async_socket_linux.h"
+#include "c_pal/completion_port_linux.h"
+#include "c_pal/platform.h"
+#include "c_pal/platform_linux.h"
+
+#define COMPLETION_PORT_THREAD_COUNT    4
+#define BUFFER_SIZE                     (64 * 1024)
+#define SENDS_IN_FLIGHT                 4
+#define SENDS_PER_RUN                   (16 * 1024)
+#define ZERO_COPY_SEND_THRESHOLD        (16 * 1024)
+
+TEST_DEFINE_ENUM_TYPE(ASYNC_SOCKET_OPEN_RESULT, ASYNC_SOCKET_OPEN_RESULT_VALUES)
+TEST_DEFINE_ENUM_TYPE(ASYNC_SOCKET_SEND_RESULT, ASYNC_SOCKET_SEND_RESULT_VALUES)
+TEST_DEFINE_ENUM_TYPE(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_RESULT_VALUES)
+
+typedef struct PERF_CONNECTION_TAG
+{
+    ASYNC_SOCKET_HANDLE send_socket;
+    ASYNC_SOCKET_HANDLE receive_socket;
+    // the sends that are left to start
+    volatile_atomic int32_t sends_left;
+    // the sends that completed, the sockets are closed only after all of them so that none is abandoned
+    volatile_atomic int32_t sends_completed;
+    // only one receive is pending at a time, so only its complete callback touches these
+    uint64_t bytes_received;
+    uint64_t total_bytes;
+    volatile_atomic int32_t is_done;
+} PERF_CONNECTION;
+
+static uint8_t g_send_data[BUFFER_SIZE];
+static uint8_t g_receive_data[BUFFER_SIZE];
+
+static void on_open_complete(void* context, ASYNC_SOCKET_OPEN_RESULT open_result)
+{
+    (void)context;
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_OPEN_RESULT, ASYNC_SOCKET_OPEN_OK, open_result);
+}
+
+static void set_nonblocking(SOCKET_HANDLE socket)
+{
+    int opts = fcntl(socket, F_GETFL);
+    ASSERT_IS_TRUE(opts >= 0, "Failure getting socket option");
+
+    opts = fcntl(socket, F_SETFL, opts | O_NONBLOCK);
+    ASSERT_IS_TRUE(opts >= 0, "Failure setting socket option");
+}
+
+// connects 2 sockets over loopback TCP
+static void setup_connected_sockets(SOCKET_HANDLE* client_socket, SOCKET_HANDLE* accept_socket)
+{
+    SOCKET_HANDLE listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_ARE_NOT_EQUAL(int, INVALID_SOCKET, listen_socket);
+
+    struct sockaddr_in service;
+    (void)memset(&service, 0, sizeof(service));
+    service.sin_family = AF_INET;
+    service.sin_port = htons(0);
+    service.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_ARE_EQUAL(int, 0, bind(listen_socket, (struct sockaddr*)&service, sizeof(service)), "Failure attempting to bind error (%d): %s", errno, strerror(errno));
+
+    struct sockaddr_in actual_addr;
+    socklen_t addr_len = sizeof(actual_addr);
+    ASSERT_ARE_EQUAL(int, 0, getsockname(listen_socket, (struct sockaddr*)&actual_addr, &addr_len), "Failure getting socket name error (%d): %s", errno, strerror(errno));
+    ASSERT_ARE_EQUAL(int, 0, listen(listen_socket, 1), "Failure on listen socket error (%d)", errno);
+
+    *client_socket = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_ARE_NOT_EQUAL(int, INVALID_SOCKET, *client_socket);
+    ASSERT_ARE_EQUAL(int, 0, connect(*client_socket, (struct sockaddr*)&actual_addr, sizeof(actual_addr)), "Unable to connect client");
+
+    *accept_socket = accept(listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, INVALID_SOCKET, *accept_socket);
+    (void)close(listen_socket);
+
+    set_nonblocking(*client_socket);
+    set_nonblocking(*accept_socket);
+}
+
+static void start_send(PERF_CONNECTION* connection);
+
+static void on_send_complete(void* context, ASYNC_SOCKET_SEND_RESULT send_result)
+{
+    PERF_CONNECTION* connection = context;
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_RESULT, ASYNC_SOCKET_SEND_OK, send_result);
+
+    // keep SENDS_IN_FLIGHT sends pending until all of them are started
+    start_send(connection);
+
+    (void)interlocked_increment(&connection->sends_completed);
+    wake_by_address_single(&connection->sends_completed);
+}
+
+static void start_send(PERF_CONNECTION* connection)
+{
+    if (interlocked_decrement(&connection->sends_left) >= 0)
+    {
+        ASYNC_SOCKET_BUFFER send_buffer;
+        send_buffer.buffer = g_send_data;
+        send_buffer.length = sizeof(g_send_data);
+        ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(connection->send_socket, &send_buffer, 1, on_send_complete, connection));
+    }
+}
+
+static void start_receive(PERF_CONNECTION* connection);
+
+static void on_receive_complete(void* context, ASYNC_SOCKET_RECEIVE_RESULT receive_result, uint32_t bytes_received)
+{
+    PERF_CONNECTION* connection = context;
+    if (receive_result == ASYNC_SOCKET_RECEIVE_OK)
+    {
+        connection->bytes_received += bytes_received;
+        if (connection->bytes_received < connection->total_bytes)
+        {
+            start_receive(connection);
+        }
+        else
+        {
+            (void)interlocked_exchange(&connection->is_done, 1);
+            wake_by_address_single(&connection->is_done);
+        }
+    }
+}
+
+static void start_receive(PERF_CONNECTION* connection)
+{
+    ASYNC_SOCKET_BUFFER receive_buffer;
+    receive_buffer.buffer = g_receive_data;
+    receive_buffer.length = sizeof(g_receive_data);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(connection->receive_socket, &receive_buffer, 1, on_receive_complete, connection));
+}
+
+// the CPU time of the whole process (user and system), which includes the copies done by the kernel
+static double get_cpu_seconds(void)
+{
+    struct rusage usage;
+    ASSERT_ARE_EQUAL(int, 0, getrusage(RUSAGE_SELF, &usage));
+    return
+        (double)usage.ru_utime.tv_sec + (double)usage.ru_utime.tv_usec / 1000000.0 +
+        (double)usage.ru_stime.tv_sec + (double)usage.ru_stime.tv_usec / 1000000.0;
+}
+
+static void run_streaming(COMPLETION_PORT_ENGINE engine, uint32_t zero_copy_send_threshold)
+{
+    ASSERT_ARE_EQUAL(int, 0, platform_linux_init_with_engine(COMPLETION_PORT_THREAD_COUNT, engine));
+    // the completion port falls back to epoll when the kernel does not support io_uring
+    COMPLETION_PORT_HANDLE completion_port = platform_get_completion_port();
+    ASSERT_IS_NOT_NULL(completion_port);
+    COMPLETION_PORT_ENGINE actual_engine = completion_port_get_engine(completion_port);
+    completion_port_dec_ref(completion_port);
+
+    SOCKET_HANDLE client_socket;
+    SOCKET_HANDLE accept_socket;
+    setup_connected_sockets(&client_socket, &accept_socket);
+
+    PERF_CONNECTION connection;
+    connection.send_socket = async_socket_create(NULL);
+    ASSERT_IS_NOT_NULL(connection.send_socket);
+    connection.receive_socket = async_socket_create(NULL);
+    ASSERT_IS_NOT_NULL(connection.receive_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_zero_copy_send_threshold(connection.send_socket, zero_copy_send_threshold));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(connection.send_socket, client_socket, on_open_complete, NULL));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(connection.receive_socket, accept_socket, on_open_complete, NULL));
+
+    (void)interlocked_exchange(&connection.sends_left, SENDS_PER_RUN);
+    (void)interlocked_exchange(&connection.sends_completed, 0);
+    (void)interlocked_exchange(&connection.is_done, 0);
+    connection.bytes_received = 0;
+    connection.total_bytes = (uint64_t)SENDS_PER_RUN * BUFFER_SIZE;
+
+    double start_time = timer_global_get_elapsed_ms();
+    double start_cpu_seconds = get_cpu_seconds();
+
+    start_receive(&connection);
+    for (uint32_t i = 0; i < SENDS_IN_FLIGHT; i++)
+    {
+        start_send(&connection);
+    }
+
+    while (interlocked_add(&connection.is_done, 0) == 0)
+    {
+        (void)wait_on_address(&connection.is_done, 0, UINT32_MAX);
+    }
+
+    // a zero copy send completes only once the kernel released its pages, which can be after the data was received
+    int32_t sends_completed;
+    while ((sends_completed = interlocked_add(&connection.sends_completed, 0)) != SENDS_PER_RUN)
+    {
+        (void)wait_on_address(&connection.sends_completed, sends_completed, UINT32_MAX);
+    }
+
+    double elapsed_ms = timer_global_get_elapsed_ms() - start_time;
+    double cpu_seconds = get_cpu_seconds() - start_cpu_seconds;
+
+    // over loopback the kernel copies the pages of the zero copy sends anyway, so the zero copy run shows the cost of the notifications
+    LogInfo("%" PRI_MU_ENUM " (requested %" PRI_MU_ENUM ") on %d completion port threads, zero copy send threshold %" PRIu32 ": %" PRIu64 " bytes in %.02f ms, %.02f MB/s, %.03f CPU seconds per GB",
+        MU_ENUM_VALUE(COMPLETION_PORT_ENGINE, actual_engine), MU_ENUM_VALUE(COMPLETION_PORT_ENGINE, engine), COMPLETION_PORT_THREAD_COUNT, zero_copy_send_threshold,
+        connection.bytes_received, elapsed_ms, (double)connection.bytes_received / (1024.0 * 1024.0) * 1000.0 / elapsed_ms,
+        cpu_seconds * (1024.0 * 1024.0 * 1024.0) / (double)connection.bytes_received);
+
+    async_socket_close(connection.receive_socket);
+    async_socket_close(connection.send_socket);
+    async_socket_destroy(connection.receive_socket);
+    async_socket_destroy(connection.send_socket);
+
+    platform_deinit();
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+/* loopback TCP streaming, every completed send starts the next one */
+
+TEST_FUNCTION(async_socket_streaming_throughput_with_epoll)
+{
+    // arrange
+
+    // act
+    run_streaming(COMPLETION_PORT_ENGINE_EPOLL, 0);
+
+    // assert
+}
+
+TEST_FUNCTION(async_socket_streaming_throughput_with_io_uring)
+{
+    // arrange
+
+    // act
+    run_streaming(COMPLETION_PORT_ENGINE_IO_URING, 0);
+
+    // assert
+}
+
+TEST_FUNCTION(async_socket_streaming_throughput_with_zero_copy)
+{
+    // arrange
+
+    // act
+    run_streaming(COMPLETION_PORT_ENGINE_EPOLL, ZERO_COPY_SEND_THRESHOLD);
+
+    // assert
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -2,13 +2,21 @@
 
 #include <stddef.h>     // for size_t
 #include <sys/types.h>  // for ssize_t
+#include <sys/socket.h> // for struct msghdr
+#include <poll.h>       // for struct pollfd
 
 #define close           mocked_close
-#define send            mocked_send
-#define recv            mocked_recv
+#define sendmsg         mocked_sendmsg
+#define recvmsg         mocked_recvmsg
+#define shutdown        mocked_shutdown
+#define setsockopt      mocked_setsockopt
+#define poll            mocked_poll
 
 int mocked_close(int s);
-ssize_t mocked_send(int fd, const void* buf, size_t n, int flags);
-ssize_t mocked_recv(int fd, void* buf, size_t n, int flags);
+ssize_t mocked_sendmsg(int fd, const struct msghdr* message, int flags);
+ssize_t mocked_recvmsg(int fd, struct msghdr* message, int flags);
+int mocked_shutdown(int fd, int how);
+int mocked_setsockopt(int fd, int level, int optname, const void* optval, socklen_t optlen);
+int mocked_poll(struct pollfd* fds, nfds_t nfds, int timeout);
 
 #include "../../src/async_socket_linux.c"
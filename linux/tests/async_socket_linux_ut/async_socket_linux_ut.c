@@ -9,10 +9,46 @@ static void* test_callback_ctx = (void*)0x4244;
 static void* test_send_ctx = (void*)0x4245;
 static void* test_recv_ctx = (void*)0x4246;
 static COMPLETION_PORT_HANDLE test_completion_port = (COMPLETION_PORT_HANDLE)0x4245;
+static COMPLETION_PORT_BUFFER_RING_HANDLE test_buffer_ring = (COMPLETION_PORT_BUFFER_RING_HANDLE)0x4247;
 
 static ON_COMPLETION_PORT_EVENT_COMPLETE g_event_callback;
 static void* g_event_callback_ctx;
 
+typedef struct TEST_IO_COMPLETION_TAG
+{
+    COMPLETION_PORT_IO* io;
+    int32_t result;
+} TEST_IO_COMPLETION;
+
+static COMPLETION_PORT_IO* g_submitted_io[TEST_MAX_SUBMITTED_IO];
+static size_t g_submitted_io_count;
+static TEST_IO_COMPLETION g_io_completions[TEST_MAX_SUBMITTED_IO];
+static size_t g_io_completion_count;
+static int g_cancel_io_result;
+
+// what sendmsg and recvmsg were called with
+typedef struct TEST_MESSAGE_TAG
+{
+    const void* first_byte;
+    size_t length;
+    size_t iovec_count;
+} TEST_MESSAGE;
+
+static TEST_MESSAGE g_sent_messages[TEST_MAX_MESSAGES];
+static size_t g_sent_message_count;
+static TEST_MESSAGE g_received_messages[TEST_MAX_MESSAGES];
+static size_t g_received_message_count;
+
+// the sequence numbers of the MSG_ZEROCOPY sendmsg calls that recvmsg with MSG_ERRQUEUE reports as released
+static uint32_t g_zero_copy_released_first;
+static uint32_t g_zero_copy_released_last;
+
+// the buffer the last pooled receive completed with
+static void* g_pooled_buffer;
+
+// the buffers lent to the buffer ring, by buffer id
+static void* g_ring_buffers[TEST_RING_BUFFER_COUNT];
+
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
 TEST_DEFINE_ENUM_TYPE(ASYNC_SOCKET_OPEN_RESULT, ASYNC_SOCKET_OPEN_RESULT_VALUES)
@@ -32,6 +68,11 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(ASYNC_SOCKET_NOTIFY_IO_RESULT, ASYNC_SOCKET_NOTIFY_I
 
 MU_DEFINE_ENUM_STRINGS(COMPLETION_PORT_EPOLL_ACTION, COMPLETION_PORT_EPOLL_ACTION_VALUES)
 
+MU_DEFINE_ENUM_STRINGS(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_VALUES)
+
+IMPLEMENT_UMOCK_C_ENUM_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT_VALUES)
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
@@ -48,13 +89,151 @@ static int my_completion_port_add(COMPLETION_PORT_HANDLE completion_port, int ep
     return 0;
 }
 
+static void add_test_io_completion(COMPLETION_PORT_IO* io, int32_t result)
+{
+    ASSERT_IS_TRUE(g_io_completion_count < TEST_MAX_SUBMITTED_IO);
+    g_io_completions[g_io_completion_count].io = io;
+    g_io_completions[g_io_completion_count].result = result;
+    g_io_completion_count++;
+}
+
+static int my_completion_port_submit_io(COMPLETION_PORT_HANDLE completion_port, SOCKET_HANDLE socket, COMPLETION_PORT_IO* io)
+{
+    (void)completion_port;
+    (void)socket;
+    ASSERT_IS_TRUE(g_submitted_io_count < TEST_MAX_SUBMITTED_IO);
+    g_submitted_io[g_submitted_io_count++] = io;
+    return 0;
+}
+
+static int my_completion_port_buffer_ring_add(COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring, void* buffer, uint32_t buffer_size, uint16_t buffer_id)
+{
+    (void)buffer_ring;
+    (void)buffer_size;
+    ASSERT_IS_TRUE(buffer_id < TEST_RING_BUFFER_COUNT);
+    g_ring_buffers[buffer_id] = buffer;
+    return 0;
+}
+
+static int my_completion_port_cancel_io(COMPLETION_PORT_HANDLE completion_port, SOCKET_HANDLE socket, COMPLETION_PORT_IO* io)
+{
+    (void)completion_port;
+    (void)socket;
+    if (g_cancel_io_result == 0)
+    {
+        // the cancelled operation completes later on a completion port thread
+        add_test_io_completion(io, -ECANCELED);
+    }
+    return g_cancel_io_result;
+}
+
+// completes the cancelled operations, like the completion port threads would
+static void run_test_io_completions(void)
+{
+    for (size_t index = 0; index < g_io_completion_count; index++)
+    {
+        COMPLETION_PORT_IO* io = g_io_completions[index].io;
+        if (io->io_type == COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING)
+        {
+            // a cancelled receive of the buffer ring ends without a buffer
+            io->has_buffer = false;
+            io->has_more = false;
+        }
+        io->on_io_complete(io->on_io_complete_context, g_io_completions[index].result);
+    }
+    g_io_completion_count = 0;
+}
+
+static WAIT_ON_ADDRESS_RESULT my_wait_on_address(volatile_atomic int32_t* address, int32_t compare_value, uint32_t timeout_ms)
+{
+    (void)address;
+    (void)compare_value;
+    (void)timeout_ms;
+    // the operations complete on the completion port threads while async_socket_close waits for them
+    run_test_io_completions();
+    return WAIT_ON_ADDRESS_OK;
+}
+
+static void my_completion_port_remove(COMPLETION_PORT_HANDLE completion_port, SOCKET_HANDLE socket)
+{
+    (void)completion_port;
+    (void)socket;
+    // the completion port abandons the socket when it is removed
+    if (g_event_callback != NULL)
+    {
+        ON_COMPLETION_PORT_EVENT_COMPLETE event_callback = g_event_callback;
+        g_event_callback = NULL;
+        event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
+    }
+}
+
+static ssize_t get_test_iovecs_length(const struct iovec* iov, size_t iovcnt)
+{
+    ssize_t result = 0;
+    for (size_t index = 0; index < iovcnt; index++)
+    {
+        result += iov[index].iov_len;
+    }
+    return result;
+}
+
+// returns the number of bytes in all the iovecs of message, which is what sendmsg and recvmsg return when they do not block
+static ssize_t record_test_message(TEST_MESSAGE* messages, size_t* message_count, const struct msghdr* message)
+{
+    ssize_t result = get_test_iovecs_length(message->msg_iov, message->msg_iovlen);
+
+    ASSERT_IS_TRUE(*message_count < TEST_MAX_MESSAGES);
+    messages[*message_count].first_byte = message->msg_iov[0].iov_base;
+    messages[*message_count].length = result;
+    messages[*message_count].iovec_count = message->msg_iovlen;
+    (*message_count)++;
+
+    return result;
+}
+
+// fills message with a zero copy notification, like recvmsg with MSG_ERRQUEUE does once the kernel released the pages of MSG_ZEROCOPY sendmsg calls
+static ssize_t record_test_zero_copy_notification(struct msghdr* message)
+{
+    struct sock_extended_err extended_error;
+    (void)memset(&extended_error, 0, sizeof(extended_error));
+    extended_error.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+    extended_error.ee_info = g_zero_copy_released_first;
+    extended_error.ee_data = g_zero_copy_released_last;
+
+    ASSERT_IS_TRUE(message->msg_controllen >= CMSG_SPACE(sizeof(extended_error)));
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+    cmsg->cmsg_level = SOL_IP;
+    cmsg->cmsg_type = IP_RECVERR;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(extended_error));
+    (void)memcpy(CMSG_DATA(cmsg), &extended_error, sizeof(extended_error));
+    message->msg_controllen = CMSG_SPACE(sizeof(extended_error));
+
+    return 0;
+}
+
 MOCK_FUNCTION_WITH_CODE(, int, mocked_close, int, s)
 MOCK_FUNCTION_END(0)
 
-MOCK_FUNCTION_WITH_CODE(, ssize_t, mocked_send, int, fd, const void*, buf, size_t, n, int, flags)
-MOCK_FUNCTION_END(n)
-MOCK_FUNCTION_WITH_CODE(, ssize_t, mocked_recv, int, fd, void*, buf, size_t, n, int, flags)
-MOCK_FUNCTION_END(n)
+MOCK_FUNCTION_WITH_CODE(, ssize_t, mocked_sendmsg, int, fd, const struct msghdr*, message, int, flags)
+    ssize_t message_length = record_test_message(g_sent_messages, &g_sent_message_count, message);
+MOCK_FUNCTION_END(message_length)
+MOCK_FUNCTION_WITH_CODE(, ssize_t, mocked_recvmsg, int, fd, struct msghdr*, message, int, flags)
+    ssize_t message_length;
+    if ((flags & MSG_ERRQUEUE) != 0)
+    {
+        message_length = record_test_zero_copy_notification(message);
+    }
+    else
+    {
+        message_length = record_test_message(g_received_messages, &g_received_message_count, message);
+    }
+MOCK_FUNCTION_END(message_length)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_shutdown, int, fd, int, how)
+MOCK_FUNCTION_END(0)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_setsockopt, int, fd, int, level, int, optname, const void*, optval, socklen_t, optlen)
+MOCK_FUNCTION_END(0)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_poll, struct pollfd*, fds, nfds_t, nfds, int, timeout)
+MOCK_FUNCTION_END(0)
 
 MOCK_FUNCTION_WITH_CODE(, int, mocked_on_send, void*, context, ASYNC_SOCKET_HANDLE, async_socket, const void*, buf, size_t, n)
     ASSERT_IS_NOT_NULL(context);
@@ -72,19 +251,62 @@ MOCK_FUNCTION_WITH_CODE(, int, mocked_on_recv, void*, context, ASYNC_SOCKET_HAND
     ASSERT_IS_TRUE(n > 0);
 MOCK_FUNCTION_END(n)
 
+MOCK_FUNCTION_WITH_CODE(, ssize_t, mocked_on_sendv, void*, context, ASYNC_SOCKET_HANDLE, async_socket, const struct iovec*, iov, int, iovcnt)
+    ASSERT_ARE_EQUAL(void_ptr, test_send_ctx, context);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_IS_NOT_NULL(iov);
+    ASSERT_IS_TRUE(iovcnt > 0);
+MOCK_FUNCTION_END(get_test_iovecs_length(iov, iovcnt))
+
+MOCK_FUNCTION_WITH_CODE(, ssize_t, mocked_on_recvv, void*, context, ASYNC_SOCKET_HANDLE, async_socket, const struct iovec*, iov, int, iovcnt)
+    ASSERT_ARE_EQUAL(void_ptr, test_recv_ctx, context);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_IS_NOT_NULL(iov);
+    ASSERT_IS_TRUE(iovcnt > 0);
+MOCK_FUNCTION_END(get_test_iovecs_length(iov, iovcnt))
+
 MOCK_FUNCTION_WITH_CODE(, void, test_on_open_complete, void*, context, ASYNC_SOCKET_OPEN_RESULT, open_result)
 MOCK_FUNCTION_END()
+static ASYNC_SOCKET_HANDLE g_send_again_async_socket;
+static ASYNC_SOCKET_BUFFER* g_send_again_buffer;
+
 MOCK_FUNCTION_WITH_CODE(, void, test_on_send_complete, void*, context, ASYNC_SOCKET_SEND_RESULT, send_result)
+    if (g_send_again_async_socket != NULL)
+    {
+        // send again from the callback, like a user that chains its sends
+        ASYNC_SOCKET_HANDLE async_socket = g_send_again_async_socket;
+        g_send_again_async_socket = NULL;
+        ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, g_send_again_buffer, 1, test_on_send_complete, NULL));
+    }
 MOCK_FUNCTION_END()
+static ASYNC_SOCKET_HANDLE g_cancel_continuous_receive_async_socket;
+
 MOCK_FUNCTION_WITH_CODE(, void, test_on_receive_complete, void*, context, ASYNC_SOCKET_RECEIVE_RESULT, receive_result, uint32_t, bytes_received)
+    if (g_cancel_continuous_receive_async_socket != NULL)
+    {
+        // cancel from the callback, like a user that stops receiving once it got what it needs
+        ASYNC_SOCKET_HANDLE async_socket = g_cancel_continuous_receive_async_socket;
+        g_cancel_continuous_receive_async_socket = NULL;
+        ASSERT_ARE_EQUAL(int, 0, async_socket_cancel_continuous_receive(async_socket));
+    }
+MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(, void, test_on_receive_pooled_complete, void*, context, ASYNC_SOCKET_RECEIVE_RESULT, receive_result, void*, buffer, uint32_t, bytes_received)
+    g_pooled_buffer = buffer;
 MOCK_FUNCTION_END()
 MOCK_FUNCTION_WITH_CODE(, void, test_on_notify_complete, void*, context, ASYNC_SOCKET_NOTIFY_IO_RESULT, notify_result)
 MOCK_FUNCTION_END()
 
+static void setup_lock_mocks(void)
+{
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+}
+
 static void mock_internal_close_setup(void)
 {
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(completion_port_remove(test_completion_port, test_socket));
+    setup_lock_mocks();
     STRICT_EXPECTED_CALL(mocked_close(test_socket));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
         .CallCannotFail();
@@ -95,44 +317,209 @@ static void mock_async_socket_create_with_transport_setup(void)
 {
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(platform_get_completion_port());
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .CallCannotFail();
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
         .CallCannotFail();
 }
 
+// creates and opens a socket that submits its operations to the io_uring of the completion port
+static ASYNC_SOCKET_HANDLE create_and_open_io_uring_async_socket(void)
+{
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+    return async_socket;
+}
+
+static void setup_submit_io_mocks(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_submit_io(test_completion_port, test_socket, IGNORED_ARG));
+}
+
+// completes the operation that was submitted at index, like the completion port thread would
+static void complete_submitted_io(size_t index, int32_t result)
+{
+    ASSERT_IS_TRUE(index < g_submitted_io_count);
+    g_submitted_io[index]->on_io_complete(g_submitted_io[index]->on_io_complete_context, result);
+}
+
 static void setup_async_socket_receive_async_mocks(void)
 {
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(ASYNC_SOCKET_BUFFER)));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLRDHUP | EPOLLONESHOT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
-        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    // queue the receive
+    setup_lock_mocks();
+    // the socket is not readable, nothing to complete
+    setup_lock_mocks();
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 }
 
-static void setup_async_socket_notify_io_async_mocks(ASYNC_SOCKET_NOTIFY_IO_TYPE io_type)
+static void setup_async_socket_notify_io_async_IN_mocks(void)
 {
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, (io_type == ASYNC_SOCKET_NOTIFY_IO_TYPE_IN) ? EPOLLIN : EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    // queue the notify
+    setup_lock_mocks();
+    // the socket is not readable, nothing to complete
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+}
+
+// sends payload_buffers while the socket cannot take any data, which leaves the send queued until the socket becomes writable
+static void setup_send_that_would_block(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER* payload_buffers, uint32_t buffer_count)
+{
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    errno = EWOULDBLOCK;
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, buffer_count, test_on_send_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+}
+
+// creates and opens a socket that sends the payloads of at least TEST_ZERO_COPY_SEND_THRESHOLD bytes with MSG_ZEROCOPY
+static ASYNC_SOCKET_HANDLE create_and_open_zero_copy_async_socket(void)
+{
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_zero_copy_send_threshold(async_socket, TEST_ZERO_COPY_SEND_THRESHOLD));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+    return async_socket;
+}
+
+// a zero copy send on a writable socket is sent from the send queue and then waits in the zero copy queue for the kernel to release its pages
+static void setup_zero_copy_send_mocks(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    // take the send from the send queue
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL | MSG_ZEROCOPY));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    // add it to the zero copy queue, its pages are not released yet
+    setup_lock_mocks();
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+}
+
+// sends payload_buffers with MSG_ZEROCOPY, the send waits for its zero copy notification
+static void setup_zero_copy_send(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BUFFER* payload_buffers)
+{
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+}
+
+// receiving the zero copy notifications of a socket, the error queue holds one notification for the sequence numbers from first_released to last_released
+static void setup_receive_zero_copy_notification_mocks(uint32_t first_released, uint32_t last_released)
+{
+    g_zero_copy_released_first = first_released;
+    g_zero_copy_released_last = last_released;
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, MSG_ERRQUEUE));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, MSG_ERRQUEUE))
+        .SetReturn(-1);
+}
+
+// creates and opens a socket whose pooled receives take their buffer from buffer_pool
+static ASYNC_SOCKET_HANDLE create_and_open_pooled_async_socket(ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool)
+{
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_receive_buffer_pool(async_socket, buffer_pool));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+    return async_socket;
+}
+
+static void setup_async_socket_receive_pooled_async_mocks(void)
+{
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    // queue the receive
+    setup_lock_mocks();
+    // the socket is not readable, nothing to complete
+    setup_lock_mocks();
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 }
 
+// a pooled receive on a readable socket gets all the bytes a buffer of the pool can hold, the caller then owns the buffer
+static void* setup_pooled_buffer_taken(ASYNC_SOCKET_HANDLE async_socket)
+{
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    ASSERT_IS_NOT_NULL(g_pooled_buffer);
+    umock_c_reset_all_calls();
+    return g_pooled_buffer;
+}
+
+// creates and opens a socket whose receives take the data the kernel receives in the pool buffers of its buffer ring
+static ASYNC_SOCKET_HANDLE create_and_open_buffer_ring_async_socket(ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool)
+{
+    // once for async_socket_create and once for async_socket_set_receive_buffer_pool
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_receive_buffer_pool(async_socket, buffer_pool));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+    umock_c_reset_all_calls();
+    return async_socket;
+}
+
+// completes the receive of the buffer ring with io_result, like the completion port thread would for a completion of the kernel,
+// has_buffer tells whether the kernel received in the buffer of buffer_id and has_more whether the receive goes on
+static void complete_ring_receive(int32_t io_result, bool has_buffer, uint16_t buffer_id, bool has_more)
+{
+    ASSERT_IS_TRUE(g_submitted_io_count > 0);
+    COMPLETION_PORT_IO* ring_receive_io = g_submitted_io[g_submitted_io_count - 1];
+    ASSERT_ARE_EQUAL(int, COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, ring_receive_io->io_type);
+    ring_receive_io->has_buffer = has_buffer;
+    ring_receive_io->buffer_id = buffer_id;
+    ring_receive_io->has_more = has_more;
+    ring_receive_io->on_io_complete(ring_receive_io->on_io_complete_context, io_result);
+}
+
+// the kernel receives bytes in the buffer of buffer_id, the multishot receive goes on
+static void receive_in_ring_buffer(uint16_t buffer_id, const uint8_t* bytes, uint32_t byte_count)
+{
+    ASSERT_IS_NOT_NULL(g_ring_buffers[buffer_id]);
+    (void)memcpy(g_ring_buffers[buffer_id], bytes, byte_count);
+    complete_ring_receive((int32_t)byte_count, true, buffer_id, true);
+}
+
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -151,12 +538,23 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_ARE_EQUAL(int, 0, result, "umocktypes_charptr_register_types failed");
 
     REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+    REGISTER_SRW_LOCK_LL_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(srw_lock_ll_init, MU_FAILURE);
 
     REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
 
     REGISTER_GLOBAL_MOCK_HOOK(completion_port_add, my_completion_port_add);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(completion_port_add, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_HOOK(completion_port_remove, my_completion_port_remove);
+    REGISTER_GLOBAL_MOCK_RETURN(completion_port_get_engine, COMPLETION_PORT_ENGINE_EPOLL);
+    REGISTER_GLOBAL_MOCK_HOOK(completion_port_submit_io, my_completion_port_submit_io);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(completion_port_submit_io, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_HOOK(completion_port_cancel_io, my_completion_port_cancel_io);
+    REGISTER_GLOBAL_MOCK_RETURNS(completion_port_buffer_ring_create, test_buffer_ring, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(completion_port_buffer_ring_add, my_completion_port_buffer_ring_add);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(completion_port_buffer_ring_add, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_HOOK(wait_on_address, my_wait_on_address);
 
     REGISTER_GLOBAL_MOCK_RETURNS(platform_get_completion_port, test_completion_port, NULL);
 
@@ -165,11 +563,22 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(ON_COMPLETION_PORT_EVENT_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ssize_t, long);
     REGISTER_UMOCK_ALIAS_TYPE(SOCKET_HANDLE, int);
+    REGISTER_UMOCK_ALIAS_TYPE(COMPLETION_PORT_BUFFER_RING_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(COMPLETION_PORT_IO*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const struct msghdr*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(struct msghdr*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const struct iovec*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(socklen_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(struct pollfd*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(nfds_t, unsigned long);
+    REGISTER_UMOCK_ALIAS_TYPE(ASYNC_SOCKET_HANDLE, void*);
 
     REGISTER_TYPE(ASYNC_SOCKET_OPEN_RESULT, ASYNC_SOCKET_OPEN_RESULT);
     REGISTER_TYPE(ASYNC_SOCKET_SEND_RESULT, ASYNC_SOCKET_SEND_RESULT);
     REGISTER_TYPE(ASYNC_SOCKET_RECEIVE_RESULT, ASYNC_SOCKET_RECEIVE_RESULT);
     REGISTER_TYPE(ASYNC_SOCKET_NOTIFY_IO_RESULT, ASYNC_SOCKET_NOTIFY_IO_RESULT);
+    REGISTER_TYPE(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE);
+    REGISTER_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -183,6 +592,20 @@ TEST_FUNCTION_INITIALIZE(method_init)
 {
     umock_c_reset_all_calls();
     umock_c_negative_tests_init();
+
+    g_event_callback = NULL;
+    g_event_callback_ctx = NULL;
+    g_send_again_async_socket = NULL;
+    g_cancel_continuous_receive_async_socket = NULL;
+    g_submitted_io_count = 0;
+    g_io_completion_count = 0;
+    g_cancel_io_result = 0;
+    g_sent_message_count = 0;
+    g_received_message_count = 0;
+    g_zero_copy_released_first = 0;
+    g_zero_copy_released_last = 0;
+    g_pooled_buffer = NULL;
+    (void)memset(g_ring_buffers, 0, sizeof(g_ring_buffers));
 }
 
 TEST_FUNCTION_CLEANUP(method_cleanup)
@@ -192,7 +615,7 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 
 // async_socket_create
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_001: [ async_socket_create shall delegate to async_socket_create_with_transport passing in callbacks for on_send and on_recv that implement socket read and write by calling send and recv respectively from system socket API. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_001: [ async_socket_create shall delegate to async_socket_create_with_vectored_transport passing in callbacks for on_sendv and on_recvv that send and receive all the buffers with one call to sendmsg and recvmsg respectively from system socket API. ]
 TEST_FUNCTION(async_socket_create_succeeds)
 {
     // arrange
@@ -260,8 +683,10 @@ TEST_FUNCTION(async_socket_create_with_transport_with_NULL_on_recv_fails)
     ASSERT_IS_NULL(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_001: [ async_socket_create_with_transport shall allocate a new async socket and on success shall return a non-NULL handle. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_005: [ async_socket_create_with_transport shall retrieve an COMPLETION_PORT_HANDLE object by calling platform_get_completion_port. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_001: [ async_socket_create_with_vectored_transport shall allocate a new async socket and on success shall return a non-NULL handle. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_005: [ async_socket_create_with_vectored_transport shall retrieve an COMPLETION_PORT_HANDLE object by calling platform_get_completion_port. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_001: [ async_socket_create_with_vectored_transport shall initialize the lock protecting the operation queues by calling srw_lock_ll_init. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_002: [ async_socket_create_with_vectored_transport shall initialize an empty receive queue for a socket that is not readable and an empty send queue for a socket that is writable. ]
 TEST_FUNCTION(async_socket_create_with_transport_succeeds)
 {
     // arrange
@@ -306,134 +731,153 @@ TEST_FUNCTION(async_socket_create_with_transport_fails)
     }
 }
 
-// async_socket_destroy
-
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_019: [ If async_socket is NULL, async_socket_destroy shall return. ]
-TEST_FUNCTION(async_socket_destroy_with_NULL_returns)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_014: [ If on_sendv and on_recvv are the callbacks that call sendmsg and recvmsg and completion_port_get_engine returns COMPLETION_PORT_ENGINE_IO_URING, async_socket_create_with_vectored_transport shall submit the operations of the socket to the io_uring of the completion port. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_015: [ async_socket_create_with_vectored_transport shall initialize an empty queue of submitted notifications and set the count of submitted operations to 0. ]
+TEST_FUNCTION(async_socket_create_with_io_uring_completion_port_succeeds)
 {
     // arrange
+    ASYNC_SOCKET_HANDLE async_socket;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(platform_get_completion_port());
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
 
     // act
-    async_socket_destroy(NULL);
+    async_socket = async_socket_create(test_execution_engine);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-}
-
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_020: [ While async_socket is OPENING or CLOSING, async_socket_destroy shall wait for the open/close to complete either successfully or with error. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_022: [ async_socket_destroy shall decrement the reference count on the completion port. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_023: [ async_socket_destroy shall free all resources associated with async_socket. ]
-TEST_FUNCTION(async_socket_destroy_frees_resources)
-{
-    // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
 
-    STRICT_EXPECTED_CALL(completion_port_dec_ref(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-
-    // act
+    // cleanup
     async_socket_destroy(async_socket);
-
-    // assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_020: [ While async_socket is OPENING or CLOSING, async_socket_destroy shall wait for the open/close to complete either successfully or with error. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_021: [ async_socket_destroy shall perform an implicit close if async_socket is OPEN. ]
-TEST_FUNCTION(async_socket_destroy_closes_first_if_open)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_014: [ If on_sendv and on_recvv are the callbacks that call sendmsg and recvmsg and completion_port_get_engine returns COMPLETION_PORT_ENGINE_IO_URING, async_socket_create_with_vectored_transport shall submit the operations of the socket to the io_uring of the completion port. ]
+TEST_FUNCTION(async_socket_create_with_transport_with_io_uring_completion_port_keeps_a_custom_transport_on_epoll)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
     ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    // close first
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    mock_internal_close_setup();
-    STRICT_EXPECTED_CALL(completion_port_dec_ref(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
 
     // act
-    async_socket_destroy(async_socket);
+    int result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
 }
 
-// async_socket_open_async
+// async_socket_create_with_vectored_transport
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_024: [ If async_socket is NULL, async_socket_open_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_open_async_with_NULL_async_socket_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_058: [ If on_sendv is NULL , async_socket_create_with_vectored_transport shall fail and return NULL. ]
+TEST_FUNCTION(async_socket_create_with_vectored_transport_with_NULL_on_sendv_fails)
 {
     // arrange
-    int result;
+    ASYNC_SOCKET_HANDLE async_socket;
 
     // act
-    result = async_socket_open_async(NULL, test_socket, test_on_open_complete, test_callback_ctx);
+    async_socket = async_socket_create_with_vectored_transport(test_execution_engine, NULL, NULL, mocked_on_recvv, test_recv_ctx);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_003: [ If socket_handle is INVALID_SOCKET, async_socket_open_async shall fail and return non-zero value. ]
-TEST_FUNCTION(async_socket_open_async_with_INVALID_SOCKET_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_059: [ If on_recvv is NULL , async_socket_create_with_vectored_transport shall fail and return NULL. ]
+TEST_FUNCTION(async_socket_create_with_vectored_transport_with_NULL_on_recvv_fails)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    umock_c_reset_all_calls();
+    ASYNC_SOCKET_HANDLE async_socket;
 
     // act
-    int result = async_socket_open_async(async_socket, INVALID_SOCKET, test_on_open_complete, test_callback_ctx);
+    async_socket = async_socket_create_with_vectored_transport(test_execution_engine, mocked_on_sendv, test_send_ctx, NULL, NULL);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
-
-    // cleanup
-    async_socket_destroy(async_socket);
+    ASSERT_IS_NULL(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_025: [ If on_open_complete is NULL, async_socket_open_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_open_async_with_NULL_on_open_complete_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_001: [ async_socket_create_with_vectored_transport shall allocate a new async socket and on success shall return a non-NULL handle. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_002: [ execution_engine shall be allowed to be NULL. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_005: [ async_socket_create_with_vectored_transport shall retrieve an COMPLETION_PORT_HANDLE object by calling platform_get_completion_port. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_001: [ async_socket_create_with_vectored_transport shall initialize the lock protecting the operation queues by calling srw_lock_ll_init. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_002: [ async_socket_create_with_vectored_transport shall initialize an empty receive queue for a socket that is not readable and an empty send queue for a socket that is writable. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_088: [ async_socket_create_with_vectored_transport shall turn zero copy off and initialize an empty zero copy queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_105: [ async_socket_create_with_vectored_transport shall not set a receive buffer pool. ]
+TEST_FUNCTION(async_socket_create_with_vectored_transport_succeeds)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
+    ASYNC_SOCKET_HANDLE async_socket;
 
-    int result;
-    umock_c_reset_all_calls();
+    mock_async_socket_create_with_transport_setup();
 
     // act
-    result = async_socket_open_async(async_socket, test_socket, NULL, test_callback_ctx);
+    async_socket = async_socket_create_with_vectored_transport(NULL, mocked_on_sendv, test_send_ctx, mocked_on_recvv, test_recv_ctx);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(async_socket);
 
     // cleanup
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_027: [ Otherwise, async_socket_open_async shall switch the state to OPENING. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_028: [ On success, async_socket_open_async shall return 0. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_031: [ async_socket_open_async shall add the socket to the epoll system by calling epoll_ctl with EPOLL_CTL_ADD. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_032: [ async_socket_open_async shall set the state to OPEN. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_033: [ On success async_socket_open_async shall call on_open_complete_context with ASYNC_SOCKET_OPEN_OK. ]
-TEST_FUNCTION(async_socket_open_async_succeeds)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_060: [ If any error occurs, async_socket_create_with_vectored_transport shall fail and return NULL. ]
+TEST_FUNCTION(async_socket_create_with_vectored_transport_fails)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASYNC_SOCKET_HANDLE async_socket;
+
+    mock_async_socket_create_with_transport_setup();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
+    {
+        if (umock_c_negative_tests_can_call_fail(index))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(index);
+
+            // act
+            async_socket = async_socket_create_with_vectored_transport(test_execution_engine, mocked_on_sendv, test_send_ctx, mocked_on_recvv, test_recv_ctx);
+
+            // assert
+            ASSERT_IS_NULL(async_socket, "On failed call %zu", index);
+        }
+    }
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_014: [ If on_sendv and on_recvv are the callbacks that call sendmsg and recvmsg and completion_port_get_engine returns COMPLETION_PORT_ENGINE_IO_URING, async_socket_create_with_vectored_transport shall submit the operations of the socket to the io_uring of the completion port. ]
+TEST_FUNCTION(async_socket_create_with_vectored_transport_with_io_uring_completion_port_keeps_a_custom_transport_on_epoll)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_vectored_transport(test_execution_engine, mocked_on_sendv, test_send_ctx, mocked_on_recvv, test_recv_ctx);
     ASSERT_IS_NOT_NULL(async_socket);
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
 
@@ -449,45 +893,209 @@ TEST_FUNCTION(async_socket_open_async_succeeds)
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_026: [ on_open_complete_context shall be allowed to be NULL. ]
-TEST_FUNCTION(async_socket_open_async_succeeds_with_NULL_context)
+// async_socket_set_zero_copy_send_threshold
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_065: [ If async_socket is NULL, async_socket_set_zero_copy_send_threshold shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_set_zero_copy_send_threshold_with_NULL_async_socket_fails)
+{
+    // arrange
+
+    // act
+    int result = async_socket_set_zero_copy_send_threshold(NULL, TEST_ZERO_COPY_SEND_THRESHOLD);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_066: [ If zero_copy_send_threshold is not 0 and the socket does not send with sendmsg, async_socket_set_zero_copy_send_threshold shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_set_zero_copy_send_threshold_with_vectored_transport_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_vectored_transport(test_execution_engine, mocked_on_sendv, test_send_ctx, mocked_on_recvv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_set_zero_copy_send_threshold(async_socket, TEST_ZERO_COPY_SEND_THRESHOLD);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_068: [ If async_socket is not CLOSED, async_socket_set_zero_copy_send_threshold shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_set_zero_copy_send_threshold_after_open_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    int result = async_socket_set_zero_copy_send_threshold(async_socket, TEST_ZERO_COPY_SEND_THRESHOLD);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_067: [ Otherwise, async_socket_set_zero_copy_send_threshold shall switch the state from CLOSED to OPENING. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_069: [ async_socket_set_zero_copy_send_threshold shall store zero_copy_send_threshold, 0 turning zero copy off. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_071: [ async_socket_set_zero_copy_send_threshold shall set the state back to CLOSED and return 0. ]
+TEST_FUNCTION(async_socket_set_zero_copy_send_threshold_succeeds)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
-    int result;
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(test_on_open_complete(NULL, ASYNC_SOCKET_OPEN_OK));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, NULL);
+    int result = async_socket_set_zero_copy_send_threshold(async_socket, TEST_ZERO_COPY_SEND_THRESHOLD);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_070: [ If zero_copy_send_threshold is not 0, the socket shall not submit its operations to the io_uring of the completion port, otherwise it shall submit them if no receive buffer pool is set and async_socket_create_with_vectored_transport would. ]
+TEST_FUNCTION(async_socket_set_zero_copy_send_threshold_with_io_uring_registers_the_socket_with_epoll_on_open)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_set_zero_copy_send_threshold(async_socket, TEST_ZERO_COPY_SEND_THRESHOLD);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASSERT_IS_NOT_NULL(g_event_callback);
 
     // cleanup
     async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_034: [ If any error occurs, async_socket_open_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(when_underlying_calls_fail_async_socket_open_async_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_070: [ If zero_copy_send_threshold is not 0, the socket shall not submit its operations to the io_uring of the completion port, otherwise it shall submit them if no receive buffer pool is set and async_socket_create_with_vectored_transport would. ]
+TEST_FUNCTION(async_socket_set_zero_copy_send_threshold_with_0_submits_the_operations_to_io_uring_again)
 {
     // arrange
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
-    int result;
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_zero_copy_send_threshold(async_socket, TEST_ZERO_COPY_SEND_THRESHOLD));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_set_zero_copy_send_threshold(async_socket, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASSERT_IS_NULL(g_event_callback);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// async_socket_buffer_pool_create
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_090: [ If buffer_size is 0, async_socket_buffer_pool_create shall fail and return NULL. ]
+TEST_FUNCTION(async_socket_buffer_pool_create_with_0_buffer_size_fails)
+{
+    // arrange
+
+    // act
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(0, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_091: [ async_socket_buffer_pool_create shall allocate a new buffer pool and initialize the lock protecting its free buffers by calling srw_lock_ll_init. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_092: [ async_socket_buffer_pool_create shall allocate buffer_count buffers of buffer_size bytes and keep them as the free buffers of the pool. ]
+TEST_FUNCTION(async_socket_buffer_pool_create_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, sizeof(unsigned char)));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, sizeof(unsigned char)));
+
+    // act
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(buffer_pool);
+
+    // cleanup
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_091: [ async_socket_buffer_pool_create shall allocate a new buffer pool and initialize the lock protecting its free buffers by calling srw_lock_ll_init. ]
+TEST_FUNCTION(async_socket_buffer_pool_create_with_0_buffer_count_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(buffer_pool);
+
+    // cleanup
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_093: [ If any error occurs, async_socket_buffer_pool_create shall fail and return NULL. ]
+TEST_FUNCTION(when_underlying_calls_fail_async_socket_buffer_pool_create_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, sizeof(unsigned char)));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, sizeof(unsigned char)));
 
     umock_c_negative_tests_snapshot();
 
@@ -499,1777 +1107,6599 @@ TEST_FUNCTION(when_underlying_calls_fail_async_socket_open_async_fails)
             umock_c_negative_tests_fail_call(index);
 
             // act
-            result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+            ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 2);
 
             // assert
-            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", index);
+            ASSERT_IS_NULL(buffer_pool, "On failed call %zu", index);
         }
     }
+}
+
+// async_socket_buffer_pool_destroy
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_094: [ If buffer_pool is NULL, async_socket_buffer_pool_destroy shall return. ]
+TEST_FUNCTION(async_socket_buffer_pool_destroy_with_NULL_returns)
+{
+    // arrange
+
+    // act
+    async_socket_buffer_pool_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_095: [ async_socket_buffer_pool_destroy shall free the free buffers of the pool, deinitialize the lock by calling srw_lock_ll_deinit and free the pool. ]
+TEST_FUNCTION(async_socket_buffer_pool_destroy_frees_the_free_buffers)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 2);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    async_socket_buffer_pool_destroy(buffer_pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+// async_socket_buffer_pool_return
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_096: [ If buffer_pool is NULL, async_socket_buffer_pool_return shall return. ]
+TEST_FUNCTION(async_socket_buffer_pool_return_with_NULL_buffer_pool_returns)
+{
+    // arrange
+    uint8_t buffer_bytes[TEST_RECEIVE_BUFFER_SIZE];
+
+    // act
+    async_socket_buffer_pool_return(NULL, buffer_bytes);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_097: [ If buffer is NULL, async_socket_buffer_pool_return shall return. ]
+TEST_FUNCTION(async_socket_buffer_pool_return_with_NULL_buffer_returns)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    umock_c_reset_all_calls();
+
+    // act
+    async_socket_buffer_pool_return(buffer_pool, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_098: [ If the pool keeps fewer than buffer_count free buffers, async_socket_buffer_pool_return shall add buffer to the free buffers of the pool, otherwise it shall free buffer. ]
+TEST_FUNCTION(async_socket_buffer_pool_return_adds_the_buffer_to_the_free_buffers)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    void* buffer = setup_pooled_buffer_taken(async_socket);
+
+    setup_lock_mocks();
+
+    // act
+    async_socket_buffer_pool_return(buffer_pool, buffer);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_029: [ If async_socket is already OPEN or OPENING, async_socket_open_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_open_async_after_async_socket_open_async_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_098: [ If the pool keeps fewer than buffer_count free buffers, async_socket_buffer_pool_return shall add buffer to the free buffers of the pool, otherwise it shall free buffer. ]
+TEST_FUNCTION(async_socket_buffer_pool_return_frees_the_buffer_when_the_pool_keeps_buffer_count_free_buffers)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    int result;
-    umock_c_reset_all_calls();
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 0);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    void* buffer = setup_pooled_buffer_taken(async_socket);
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
-    result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+    async_socket_buffer_pool_return(buffer_pool, buffer);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// async_socket_close
+// async_socket_set_receive_buffer_pool
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_035: [ If async_socket is NULL, async_socket_close shall return. ]
-TEST_FUNCTION(async_socket_close_with_NULL_returns)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_099: [ If async_socket is NULL, async_socket_set_receive_buffer_pool shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_set_receive_buffer_pool_with_NULL_async_socket_fails)
 {
     // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    umock_c_reset_all_calls();
 
     // act
-    async_socket_close(NULL);
+    int result = async_socket_set_receive_buffer_pool(NULL, buffer_pool);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_036: [ Otherwise, async_socket_close shall switch the state to CLOSING. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_037: [ async_socket_close shall wait for all executing async_socket_send_async and async_socket_receive_async APIs. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_039: [ async_socket_close shall call close on the underlying socket. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_041: [ async_socket_close shall set the state to closed. ]
-TEST_FUNCTION(async_socket_close_reverses_the_actions_from_open)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_101: [ If async_socket is not CLOSED, async_socket_set_receive_buffer_pool shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_set_receive_buffer_pool_after_open_fails)
 {
     // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    mock_internal_close_setup();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    int result = async_socket_set_receive_buffer_pool(async_socket, buffer_pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_100: [ Otherwise, async_socket_set_receive_buffer_pool shall switch the state from CLOSED to OPENING. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_102: [ async_socket_set_receive_buffer_pool shall store buffer_pool, NULL turning the pooled receives off. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_104: [ async_socket_set_receive_buffer_pool shall set the state back to CLOSED and return 0. ]
+TEST_FUNCTION(async_socket_set_receive_buffer_pool_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_set_receive_buffer_pool(async_socket, buffer_pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_103: [ The socket shall submit its operations to the io_uring of the completion port if zero copy is off and async_socket_create_with_vectored_transport would, whether buffer_pool is NULL or not. ]
+TEST_FUNCTION(async_socket_set_receive_buffer_pool_with_io_uring_keeps_submitting_the_operations_to_io_uring)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_set_receive_buffer_pool(async_socket, buffer_pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASSERT_IS_NULL(g_event_callback);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(int, COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, g_submitted_io[0]->io_type);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_102: [ async_socket_set_receive_buffer_pool shall store buffer_pool, NULL turning the pooled receives off. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_103: [ The socket shall submit its operations to the io_uring of the completion port if zero copy is off and async_socket_create_with_vectored_transport would, whether buffer_pool is NULL or not. ]
+TEST_FUNCTION(async_socket_set_receive_buffer_pool_with_NULL_submits_the_operations_to_io_uring_again)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_receive_buffer_pool(async_socket, buffer_pool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_set_receive_buffer_pool(async_socket, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASSERT_IS_NULL(g_event_callback);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// async_socket_destroy
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_019: [ If async_socket is NULL, async_socket_destroy shall return. ]
+TEST_FUNCTION(async_socket_destroy_with_NULL_returns)
+{
+    // arrange
+
+    // act
+    async_socket_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_020: [ While async_socket is OPENING or CLOSING, async_socket_destroy shall wait for the open/close to complete either successfully or with error. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_003: [ async_socket_destroy shall deinitialize the lock by calling srw_lock_ll_deinit. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_022: [ async_socket_destroy shall decrement the reference count on the completion port. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_023: [ async_socket_destroy shall free all resources associated with async_socket. ]
+TEST_FUNCTION(async_socket_destroy_frees_resources)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_dec_ref(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    async_socket_destroy(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_020: [ While async_socket is OPENING or CLOSING, async_socket_destroy shall wait for the open/close to complete either successfully or with error. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_021: [ async_socket_destroy shall perform an implicit close if async_socket is OPEN. ]
+TEST_FUNCTION(async_socket_destroy_closes_first_if_open)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    // close first
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    mock_internal_close_setup();
+    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_dec_ref(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    async_socket_destroy(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+// async_socket_open_async
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_024: [ If async_socket is NULL, async_socket_open_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_open_async_with_NULL_async_socket_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = async_socket_open_async(NULL, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_003: [ If socket_handle is INVALID_SOCKET, async_socket_open_async shall fail and return non-zero value. ]
+TEST_FUNCTION(async_socket_open_async_with_INVALID_SOCKET_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_open_async(async_socket, INVALID_SOCKET, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_025: [ If on_open_complete is NULL, async_socket_open_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_open_async_with_NULL_on_open_complete_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+
+    int result;
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_open_async(async_socket, test_socket, NULL, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_027: [ Otherwise, async_socket_open_async shall switch the state to OPENING. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_028: [ On success, async_socket_open_async shall return 0. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_031: [ async_socket_open_async shall register the socket once with the completion port by calling completion_port_add with EPOLLIN, EPOLLOUT, EPOLLRDHUP and EPOLLET, event_complete_callback as the callback and async_socket as the context. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_032: [ async_socket_open_async shall set the state to OPEN. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_033: [ On success async_socket_open_async shall call on_open_complete_context with ASYNC_SOCKET_OPEN_OK. ]
+TEST_FUNCTION(async_socket_open_async_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
+
+    // act
+    int result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(g_event_callback);
+    ASSERT_ARE_EQUAL(void_ptr, async_socket, g_event_callback_ctx);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_026: [ on_open_complete_context shall be allowed to be NULL. ]
+TEST_FUNCTION(async_socket_open_async_succeeds_with_NULL_context)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(NULL, ASYNC_SOCKET_OPEN_OK));
+
+    // act
+    result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_034: [ If any error occurs, async_socket_open_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_underlying_calls_fail_async_socket_open_async_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
+    {
+        if (umock_c_negative_tests_can_call_fail(index))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(index);
+
+            // act
+            result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", index);
+        }
+    }
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_004: [ If completion_port_add fails, async_socket_open_async shall set the state back to CLOSED. ]
+TEST_FUNCTION(when_completion_port_add_fails_async_socket_open_async_can_be_called_again)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_029: [ If async_socket is already OPEN or OPENING, async_socket_open_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_open_async_after_async_socket_open_async_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_019: [ If the socket submits its operations to the io_uring of the completion port, async_socket_open_async shall not call completion_port_add. ]
+TEST_FUNCTION(async_socket_open_async_with_io_uring_does_not_add_the_socket_to_the_completion_port)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
+
+    // act
+    int result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(g_event_callback);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_072: [ If zero copy is on, async_socket_open_async shall enable zero copy on the socket by calling setsockopt with SOL_SOCKET and SO_ZEROCOPY. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_074: [ async_socket_open_async shall start the zero copy sequence numbers of the socket at 0. ]
+TEST_FUNCTION(async_socket_open_async_with_zero_copy_enables_SO_ZEROCOPY)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_zero_copy_send_threshold(async_socket, TEST_ZERO_COPY_SEND_THRESHOLD));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_setsockopt(test_socket, SOL_SOCKET, SO_ZEROCOPY, IGNORED_ARG, sizeof(int)));
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
+
+    // act
+    int result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_073: [ If setsockopt fails, async_socket_open_async shall turn zero copy off and continue opening the socket. ]
+TEST_FUNCTION(async_socket_open_async_with_zero_copy_when_setsockopt_fails_sends_without_zero_copy)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_zero_copy_send_threshold(async_socket, TEST_ZERO_COPY_SEND_THRESHOLD));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_setsockopt(test_socket, SOL_SOCKET, SO_ZEROCOPY, IGNORED_ARG, sizeof(int)))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
+
+    // act
+    int result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // a payload over the threshold is sent inline without MSG_ZEROCOPY
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_150: [ If the socket submits its operations to the io_uring of the completion port and has a receive buffer pool, async_socket_open_async shall create a buffer ring of 8 buffers for the socket by calling completion_port_buffer_ring_create and lend it 8 buffers taken from the receive buffer pool by calling completion_port_buffer_ring_add. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_152: [ If the socket has a buffer ring, async_socket_open_async shall then submit a multishot receive that picks its buffers from the buffer ring by calling completion_port_submit_io, so that the kernel receives the data as it arrives. ]
+TEST_FUNCTION(async_socket_open_async_with_io_uring_and_a_receive_buffer_pool_creates_a_buffer_ring_and_submits_a_multishot_receive)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_receive_buffer_pool(async_socket, buffer_pool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_buffer_ring_create(test_completion_port, test_socket, TEST_RING_BUFFER_COUNT));
+    for (uint16_t buffer_id = 0; buffer_id < TEST_RING_BUFFER_COUNT; buffer_id++)
+    {
+        // take a free buffer of the pool
+        setup_lock_mocks();
+        STRICT_EXPECTED_CALL(completion_port_buffer_ring_add(test_buffer_ring, IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, buffer_id));
+    }
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
+
+    // act
+    int result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(g_event_callback);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(int, COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, g_submitted_io[0]->io_type);
+    ASSERT_ARE_EQUAL(void_ptr, test_buffer_ring, g_submitted_io[0]->buffer_ring);
+    ASSERT_IS_TRUE(g_submitted_io[0]->is_multishot);
+    for (uint16_t buffer_id = 0; buffer_id < TEST_RING_BUFFER_COUNT; buffer_id++)
+    {
+        ASSERT_IS_NOT_NULL(g_ring_buffers[buffer_id]);
+    }
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_151: [ If completion_port_buffer_ring_create fails, the socket shall wait for readiness with completion_port_add instead of submitting its operations to the io_uring of the completion port, since the kernel does not support buffer rings (before 5.19). ]
+TEST_FUNCTION(when_completion_port_buffer_ring_create_fails_async_socket_open_async_adds_the_socket_to_the_completion_port)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_receive_buffer_pool(async_socket, buffer_pool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_buffer_ring_create(test_completion_port, test_socket, TEST_RING_BUFFER_COUNT))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(test_callback_ctx, ASYNC_SOCKET_OPEN_OK));
+
+    // act
+    int result = async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(g_event_callback);
+    ASSERT_ARE_EQUAL(void_ptr, async_socket, g_event_callback_ctx);
+    ASSERT_ARE_EQUAL(size_t, 0, g_submitted_io_count);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_153: [ If completion_port_submit_io fails, the receives of the socket shall complete with ASYNC_SOCKET_RECEIVE_ERROR. ]
+TEST_FUNCTION(when_submitting_the_receive_of_the_buffer_ring_fails_the_pooled_receives_complete_with_ERROR)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    STRICT_EXPECTED_CALL(completion_port_get_engine(test_completion_port))
+        .SetReturn(COMPLETION_PORT_ENGINE_IO_URING);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_receive_buffer_pool(async_socket, buffer_pool));
+    STRICT_EXPECTED_CALL(completion_port_submit_io(test_completion_port, test_socket, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    // queue the receive
+    setup_lock_mocks();
+    // take it from the receive queue, the socket is marked as readable
+    setup_lock_mocks();
+    // no data was received, the stream ended with the error
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, NULL, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(g_pooled_buffer);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// async_socket_close
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_035: [ If async_socket is NULL, async_socket_close shall return. ]
+TEST_FUNCTION(async_socket_close_with_NULL_returns)
+{
+    // arrange
+
+    // act
+    async_socket_close(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_036: [ Otherwise, async_socket_close shall switch the state to CLOSING. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_037: [ async_socket_close shall wait for all executing async_socket_send_async and async_socket_receive_async APIs. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_005: [ async_socket_close shall remove the socket from the completion port by calling completion_port_remove, which completes all the queued operations with ABANDONED. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_039: [ async_socket_close shall call close on the underlying socket. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_041: [ async_socket_close shall set the state to CLOSED. ]
+TEST_FUNCTION(async_socket_close_reverses_the_actions_from_open)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    mock_internal_close_setup();
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_042: [ If async_socket is not OPEN, async_socket_close shall return. ]
+TEST_FUNCTION(async_socket_close_when_not_open_returns)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_042: [ If async_socket is not OPEN, async_socket_close shall return. ]
+TEST_FUNCTION(async_socket_close_after_close_returns)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    async_socket_close(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_005: [ async_socket_close shall remove the socket from the completion port by calling completion_port_remove, which completes all the queued operations with ABANDONED. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_039: [ async_socket_close shall call close on the underlying socket. ]
+TEST_FUNCTION(async_socket_close_after_open_and_recv_abandons_the_receive)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(completion_port_remove(test_completion_port, test_socket));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(test_socket));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_147: [ If zero copy is on, async_socket_close shall first wait for the kernel to release the pages of the zero copy sends: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_148: [ async_socket_close shall receive the zero copy notifications of the socket, which completes the sends whose pages the kernel released. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_149: [ While the zero copy queue is not empty or the send that is partially sent waits for zero copy notifications, async_socket_close shall call poll for the socket with a timeout of 100 ms and receive the zero copy notifications again, at most 10 times. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_089: [ event_complete_callback shall also remove all the sends that are left in the zero copy queue, whose pages the kernel did not release in time, and complete them the same way. ]
+TEST_FUNCTION(async_socket_close_with_zero_copy_abandons_the_sends_whose_pages_are_not_released_in_time)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
+
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    setup_zero_copy_send(async_socket, payload_buffers);
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    // the error queue stays empty
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, MSG_ERRQUEUE))
+        .SetReturn(-1);
+    setup_lock_mocks();
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        setup_lock_mocks();
+        STRICT_EXPECTED_CALL(mocked_poll(IGNORED_ARG, 1, 100));
+        STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, MSG_ERRQUEUE))
+            .SetReturn(-1);
+        setup_lock_mocks();
+    }
+    STRICT_EXPECTED_CALL(completion_port_remove(test_completion_port, test_socket));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(test_socket));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_147: [ If zero copy is on, async_socket_close shall first wait for the kernel to release the pages of the zero copy sends: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_149: [ While the zero copy queue is not empty or the send that is partially sent waits for zero copy notifications, async_socket_close shall call poll for the socket with a timeout of 100 ms and receive the zero copy notifications again, at most 10 times. ]
+TEST_FUNCTION(async_socket_close_with_zero_copy_completes_the_send_once_its_pages_are_released)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
+
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    setup_zero_copy_send(async_socket, payload_buffers);
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, MSG_ERRQUEUE))
+        .SetReturn(-1);
+    setup_lock_mocks();
+    setup_lock_mocks();
+    // the notification arrives while polling
+    STRICT_EXPECTED_CALL(mocked_poll(IGNORED_ARG, 1, 100));
+    setup_receive_zero_copy_notification_mocks(0, 0);
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    // nothing is left to wait for, nor to abandon
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(completion_port_remove(test_completion_port, test_socket));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_close(test_socket));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_020: [ If the socket uses the io_uring engine, async_socket_close shall cancel the submitted receive, the submitted send and all the submitted notifications by calling completion_port_cancel_io. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_022: [ async_socket_close shall wait for all the submitted operations to complete. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_023: [ async_socket_close shall then complete the contexts left in the receive and send queues with ABANDONED. ]
+TEST_FUNCTION(async_socket_close_with_io_uring_cancels_the_submitted_operations_and_abandons_the_queued_ones)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(size_t, 3, g_submitted_io_count);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_cancel_io(test_completion_port, test_socket, g_submitted_io[0]));
+    STRICT_EXPECTED_CALL(completion_port_cancel_io(test_completion_port, test_socket, g_submitted_io[1]));
+    STRICT_EXPECTED_CALL(completion_port_cancel_io(test_completion_port, test_socket, g_submitted_io[2]));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 3, UINT32_MAX));
+    // the cancelled receive completes, the queued receive is not submitted anymore
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    // the cancelled send completes
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    // the cancelled notify completes
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    // the queued receive is abandoned
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(test_socket));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_021: [ If any completion_port_cancel_io fails, async_socket_close shall call shutdown with SHUT_RDWR so that the submitted operations complete. ]
+TEST_FUNCTION(when_completion_port_cancel_io_fails_async_socket_close_shuts_down_the_socket)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    g_cancel_io_result = MU_FAILURE;
+    // the shutdown completes the receive with 0 bytes
+    add_test_io_completion(g_submitted_io[0], 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_cancel_io(test_completion_port, test_socket, g_submitted_io[0]));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_shutdown(test_socket, SHUT_RDWR));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 1, UINT32_MAX));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_close(test_socket));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_164: [ If the socket receives with a buffer ring, async_socket_close shall cancel the receive of the buffer ring if it is submitted, instead of the submitted receive. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_165: [ If the socket receives with a buffer ring, async_socket_close shall then give the buffers lent to the kernel and the received buffers back to the receive buffer pool and destroy the buffer ring by calling completion_port_buffer_ring_destroy. ]
+TEST_FUNCTION(async_socket_close_with_a_buffer_ring_cancels_its_receive_and_gives_its_buffers_back_to_the_pool)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    uint8_t received_bytes[] = { 0x42 };
+    receive_in_ring_buffer(0, received_bytes, sizeof(received_bytes));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_cancel_io(test_completion_port, test_socket, g_submitted_io[0]));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 1, UINT32_MAX));
+    // the cancelled receive of the buffer ring completes, the socket is not open anymore
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(completion_port_buffer_ring_destroy(test_buffer_ring));
+    for (uint32_t index = 0; index < TEST_RING_BUFFER_COUNT; index++)
+    {
+        // the lent buffers and the received buffer go back to the pool
+        setup_lock_mocks();
+    }
+    STRICT_EXPECTED_CALL(mocked_close(test_socket));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    async_socket_close(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// async_socket_send_async
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_043: [ If async_socket is NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_NULL_async_socket_fails)
+{
+    // arrange
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    // act
+    result = async_socket_send_async(NULL, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, (void*)0x4244);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_044: [ If buffers is NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_NULL_payload_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_send_async(async_socket, NULL, 1, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_045: [ If buffer_count is 0, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_0_payload_count_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, 0, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_046: [ If any of the buffers in payload has buffer set to NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_first_out_of_2_buffers_having_buffer_NULL_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = NULL;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    payload_buffers[1].buffer = payload_bytes;
+    payload_buffers[1].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_046: [ If any of the buffers in payload has buffer set to NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_second_out_of_2_buffers_having_buffer_NULL_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    payload_buffers[1].buffer = NULL;
+    payload_buffers[1].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_047: [ If any of the buffers in payload has length set to 0, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_first_out_of_2_buffers_having_length_0_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = 0;
+    payload_buffers[1].buffer = payload_bytes;
+    payload_buffers[1].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_047: [ If any of the buffers in payload has length set to 0, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_second_out_of_2_buffers_having_length_0_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    payload_buffers[1].buffer = payload_bytes;
+    payload_buffers[1].length = 0;
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_048: [ If the sum of buffer lengths for all the buffers in payload is greater than UINT32_MAX, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_UINT32_MAX_buffers_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    payload_buffers[1].buffer = payload_bytes;
+    payload_buffers[1].length = 0;
+    umock_c_reset_all_calls();
+
+    // act
+    // UINT32_MAX will for sure make us want more memory than UINT32_MAX bytes
+    result = async_socket_send_async(async_socket, payload_buffers, UINT32_MAX, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_049: [ If on_send_complete is NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(async_socket_send_async_with_on_send_complete_NULL_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), NULL, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_051: [ If async_socket is not OPEN, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ABANDONED. ]
+TEST_FUNCTION(async_socket_send_async_when_not_open_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_NOT_OPEN, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_051: [ If async_socket is not OPEN, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ABANDONED. ]
+TEST_FUNCTION(async_socket_send_async_after_close_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    async_socket_close(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_NOT_OPEN, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_sendv callback with an iovec for each of the buffers to send the whole payload with one call. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_sendv shall send all the iovecs by calling sendmsg with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_053: [ async_socket_send_async shall continue to send the data until the payload length has been sent. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_062: [ On success, async_socket_send_async shall return ASYNC_SOCKET_SEND_SYNC_OK. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_061: [ If the send is successful, async_socket_send_async shall call the on_send_complete with on_send_complete_context and ASYNC_SOCKET_SEND_SYNC_OK. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_062: [ On success, async_socket_send_async shall return ASYNC_SOCKET_SEND_SYNC_OK. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_006: [ If buffer_count is at most 16, the send queue is empty, no other thread is completing sends and the socket is writable, async_socket_send_async shall send the payload on the calling thread. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_008: [ async_socket_send_async shall then complete the operations in the send queue if the socket is writable. ]
+TEST_FUNCTION(async_socket_send_async_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_sendv callback with an iovec for each of the buffers to send the whole payload with one call. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_sendv shall send all the iovecs by calling sendmsg with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
+TEST_FUNCTION(async_socket_send_async_with_2_buffers_sends_both_with_one_sendmsg)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_1, g_sent_messages[0].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes_1) + sizeof(payload_bytes_2), g_sent_messages[0].length);
+    ASSERT_ARE_EQUAL(size_t, 2, g_sent_messages[0].iovec_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_006: [ If buffer_count is at most 16, the send queue is empty, no other thread is completing sends and the socket is writable, async_socket_send_async shall send the payload on the calling thread. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_007: [ Otherwise, async_socket_send_async shall create a context for the send where an iovec for each of the buffers of payload, on_send_complete and on_send_complete_context shall be stored and add it at the tail of the send queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_008: [ async_socket_send_async shall then complete the operations in the send queue if the socket is writable. ]
+TEST_FUNCTION(async_socket_send_async_with_17_buffers_sends_them_from_the_send_queue_with_one_sendmsg)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[17];
+    ASYNC_SOCKET_BUFFER payload_buffers[17];
+    for (uint32_t i = 0; i < 17; i++)
+    {
+        payload_bytes[i] = (uint8_t)i;
+        payload_buffers[i].buffer = &payload_bytes[i];
+        payload_buffers[i].length = 1;
+    }
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 17, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_sent_message_count);
+    ASSERT_ARE_EQUAL(size_t, 17, g_sent_messages[0].length);
+    ASSERT_ARE_EQUAL(size_t, 17, g_sent_messages[0].iovec_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_sendv callback with an iovec for each of the buffers to send the whole payload with one call. ]
+TEST_FUNCTION(async_socket_send_async_with_vectored_transport_calls_on_sendv_with_all_the_buffers)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_vectored_transport(test_execution_engine, mocked_on_sendv, test_send_ctx, mocked_on_recvv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_sendv(test_send_ctx, async_socket, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_sendv callback with an iovec for each of the buffers to send the whole payload with one call. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_sendv shall send all the iovecs by calling sendmsg with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_053: [ async_socket_send_async shall continue to send the data until the payload length has been sent. ]
+TEST_FUNCTION(async_socket_send_async_multiple_sends_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x50 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ssize_t send_amt = payload_buffers[0].length/2;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(send_amt);
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 2, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes + send_amt, g_sent_messages[1].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes) - send_amt, g_sent_messages[1].length);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_sendv callback with an iovec for each of the buffers to send the whole payload with one call. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_sendv shall send all the iovecs by calling sendmsg with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_053: [ async_socket_send_async shall continue to send the data until the payload length has been sent. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_056: [ async_socket_send_async shall create a context for the send where the payload that is left to send, on_send_complete and on_send_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_057: [ The context shall then be inserted at the head of the send queue so that it is sent before any send queued meanwhile when the socket becomes writable. ]
+TEST_FUNCTION(async_socket_send_async_multiple_sends_WOULDBLOCK_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x50 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ssize_t send_amt = payload_buffers[0].length/2;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(send_amt);
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    // the socket is not writable, nothing to complete
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    errno = EWOULDBLOCK;
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_050: [ on_send_complete_context shall be allowed to be NULL. ]
+TEST_FUNCTION(async_socket_send_async_with_NULL_on_send_complete_context_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(NULL, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(when_underlying_calls_fail_async_socket_send_async_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    errno = EDESTADDRREQ;
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_054: [ If on_sendv fails to send the data, async_socket_send_async shall do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_055: [ If the errno value is EAGAIN or EWOULDBLOCK. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_056: [ async_socket_send_async shall create a context for the send where the payload that is left to send, on_send_complete and on_send_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_057: [ The context shall then be inserted at the head of the send queue so that it is sent before any send queued meanwhile when the socket becomes writable. ]
+TEST_FUNCTION(when_errno_for_send_returns_EWOULDBLOCK_the_send_is_queued_and_treated_as_successfull)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    errno = EWOULDBLOCK;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(when_malloc_flex_fails_after_EWOULDBLOCK_async_socket_send_async_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)))
+        .SetReturn(NULL);
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    errno = EWOULDBLOCK;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_140: [ If creating the context fails after part of the payload was sent, async_socket_send_async shall call shutdown with SHUT_RDWR so that no other data follows the partial payload on the socket. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(when_malloc_flex_fails_after_a_partial_send_and_EWOULDBLOCK_async_socket_send_async_shuts_down_the_socket_and_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    // the first byte is sent
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_shutdown(test_socket, SHUT_RDWR));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    errno = EWOULDBLOCK;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_057: [ The context shall then be inserted at the head of the send queue so that it is sent before any send queued meanwhile when the socket becomes writable. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_056: [ async_socket_send_async shall create a context for the send where the payload that is left to send, on_send_complete and on_send_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_101: [ If on_sendv returns a value > 0 but less than the amount to be sent, complete_queued_io shall skip the bytes that were sent, across as many buffers as needed, and call on_sendv again until the payload length has been sent. ]
+TEST_FUNCTION(when_EWOULDBLOCK_happens_in_the_second_buffer_only_the_bytes_left_are_queued)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    uint8_t payload_bytes_3[] = { 0x45 };
+    ASYNC_SOCKET_BUFFER payload_buffers[3];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    payload_buffers[2].buffer = payload_bytes_3;
+    payload_buffers[2].length = sizeof(payload_bytes_3);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    // the first buffer and 1 byte of the second buffer are sent
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(sizeof(payload_bytes_1) + 1);
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    errno = EWOULDBLOCK;
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 2, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_1, g_sent_messages[0].first_byte);
+    ASSERT_ARE_EQUAL(size_t, 3, g_sent_messages[0].iovec_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_2 + 1, g_sent_messages[1].first_byte);
+    ASSERT_ARE_EQUAL(size_t, 2, g_sent_messages[1].iovec_count);
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 3, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_2 + 1, g_sent_messages[2].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes_2) - 1 + sizeof(payload_bytes_3), g_sent_messages[2].length);
+    ASSERT_ARE_EQUAL(size_t, 2, g_sent_messages[2].iovec_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_007: [ Otherwise, async_socket_send_async shall create a context for the send where an iovec for each of the buffers of payload, on_send_complete and on_send_complete_context shall be stored and add it at the tail of the send queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_008: [ async_socket_send_async shall then complete the operations in the send queue if the socket is writable. ]
+TEST_FUNCTION(async_socket_send_async_queues_the_send_while_the_socket_is_not_writable)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, 1);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    // the socket is not writable, nothing to complete
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_075: [ If zero copy is on and the payload is at least zero_copy_send_threshold bytes, the send shall be a zero copy send, which is never sent on the calling thread. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_078: [ For a zero copy send, complete_queued_io shall call sendmsg with MSG_NOSIGNAL and MSG_ZEROCOPY instead of on_sendv, while holding the lock. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_080: [ If sendmsg with MSG_ZEROCOPY succeeds, complete_queued_io shall record that the send waits for one more zero copy notification, with the next sequence number of the socket. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_081: [ If zero copy is on, complete_queued_io shall add the send with its result at the tail of the zero copy queue instead of completing it, so that the sends complete in order once the kernel released the pages of the zero copy sends, and then call complete_zero_copy_sends. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_083: [ While the kernel released all the pages of the send at the head of the zero copy queue, complete_zero_copy_sends shall remove it from the queue, call its on_send_complete without holding the lock with the result the send completed with and free it. ]
+TEST_FUNCTION(async_socket_send_async_with_zero_copy_sends_with_MSG_ZEROCOPY_and_does_not_complete_the_send)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
+
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    setup_zero_copy_send_mocks();
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes, g_sent_messages[0].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes), g_sent_messages[0].length);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_075: [ If zero copy is on and the payload is at least zero_copy_send_threshold bytes, the send shall be a zero copy send, which is never sent on the calling thread. ]
+TEST_FUNCTION(async_socket_send_async_with_zero_copy_sends_a_payload_under_the_threshold_inline)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
+
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD - 1] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_076: [ If zero copy is on, async_socket_send_async shall also send the payload on the calling thread only if the zero copy queue is empty and no other thread is completing the sends in it. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_081: [ If zero copy is on, complete_queued_io shall add the send with its result at the tail of the zero copy queue instead of completing it, so that the sends complete in order once the kernel released the pages of the zero copy sends, and then call complete_zero_copy_sends. ]
+TEST_FUNCTION(async_socket_send_async_with_zero_copy_completes_a_small_send_only_after_the_zero_copy_send_before_it)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
+
+    uint8_t zero_copy_payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
+    ASYNC_SOCKET_BUFFER zero_copy_payload_buffers[1];
+    zero_copy_payload_buffers[0].buffer = zero_copy_payload_bytes;
+    zero_copy_payload_buffers[0].length = sizeof(zero_copy_payload_bytes);
+    uint8_t payload_bytes[] = { 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    setup_zero_copy_send(async_socket, zero_copy_payload_buffers);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL));
+    // the send waits in the zero copy queue behind the zero copy send
+    setup_lock_mocks();
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_079: [ If sendmsg fails with ENOBUFS, complete_queued_io shall call sendmsg again with MSG_NOSIGNAL only, so that the data is copied. ]
+TEST_FUNCTION(async_socket_send_async_with_zero_copy_when_sendmsg_fails_with_ENOBUFS_sends_a_copy_and_completes_the_send)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
+
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL | MSG_ZEROCOPY))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    // no notification comes for a copied send
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    errno = ENOBUFS;
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(when_malloc_flex_fails_async_socket_send_async_that_is_queued_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, 1);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_007: [ Otherwise, async_socket_send_async shall create a context for the send where an iovec for each of the buffers of payload, on_send_complete and on_send_complete_context shall be stored and add it at the tail of the send queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_011: [ If another thread is completing the operations of the queue, complete_queued_io shall return. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_012: [ While the queue is not empty and the socket is ready for the direction of the queue, complete_queued_io shall remove the first context from the queue and complete it without holding the lock: ]
+TEST_FUNCTION(async_socket_send_async_from_the_send_complete_callback_is_sent_after_the_callback_returns)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    ASYNC_SOCKET_BUFFER send_again_buffer;
+    send_again_buffer.buffer = payload_bytes_2;
+    send_again_buffer.length = sizeof(payload_bytes_2);
+    g_send_again_async_socket = async_socket;
+    g_send_again_buffer = &send_again_buffer;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    // the send from the callback is queued behind the send that is completing
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    // and sent once the first send is done
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(NULL, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_059: [ If the errno value is ECONNRESET, ENOTCONN, or EPIPE shall fail and return ASYNC_SOCKET_SEND_SYNC_ABANDONED. ]
+TEST_FUNCTION(when_errno_for_send_returns_ECONNRESET_async_socket_send_async_returns_ABANDONED)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    errno = ECONNRESET;
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_NOT_OPEN, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_060: [ If any other error is encountered, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(when_errno_for_send_returns_error_async_socket_send_async_returns_ERROR)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    errno = EAFNOSUPPORT;
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_101: [ If the sum of buffer lengths for all the buffers in payload is greater than UINT32_MAX, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]*/
+TEST_FUNCTION(async_socket_send_async_with_sum_of_buffer_lengths_exceeding_UINT32_MAX_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = UINT32_MAX;
+    payload_buffers[1].buffer = payload_bytes;
+    payload_buffers[1].length = 1;
+    umock_c_reset_all_calls();
+
+    // act
+    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_024: [ If the socket submits its operations to the io_uring of the completion port, async_socket_send_async shall create a context for the send where an iovec for each of the buffers of payload, on_send_complete and on_send_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_026: [ Otherwise, async_socket_send_async shall submit the send by calling completion_port_submit_io and add the context to the send queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_062: [ On success, async_socket_send_async shall return ASYNC_SOCKET_SEND_SYNC_OK. ]
+TEST_FUNCTION(async_socket_send_async_with_io_uring_submits_the_send)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes_1[] = { 0x42, 0x43 };
+    uint8_t payload_bytes_2[] = { 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, 2, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(int, COMPLETION_PORT_IO_TYPE_SEND, g_submitted_io[0]->io_type);
+    ASSERT_ARE_EQUAL(size_t, 2, g_submitted_io[0]->message->msg_iovlen);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_1, g_submitted_io[0]->message->msg_iov[0].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes_1), g_submitted_io[0]->message->msg_iov[0].iov_len);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_2, g_submitted_io[0]->message->msg_iov[1].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes_2), g_submitted_io[0]->message->msg_iov[1].iov_len);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_025: [ If the send queue is not empty, async_socket_send_async shall add the context at the tail of the send queue. ]
+TEST_FUNCTION(async_socket_send_async_with_io_uring_queues_the_send_behind_the_submitted_send)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(when_completion_port_submit_io_fails_async_socket_send_async_with_io_uring_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_submit_io(test_completion_port, test_socket, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
+TEST_FUNCTION(when_malloc_flex_fails_async_socket_send_async_with_io_uring_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(size_t, 0, g_submitted_io_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// async_socket_receive_async
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_064: [ If async_socket is NULL, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_NULL_async_socket_fails)
+{
+    // arrange
+    int result;
+    uint8_t payload_bytes[1];
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    // act
+    result = async_socket_receive_async(NULL, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_065: [ If buffers is NULL, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_NULL_payload_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_async(async_socket, NULL, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_066: [ If buffer_count is 0, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_0_payload_count_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    uint8_t payload_bytes[1];
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, 0, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_067: [ If any of the buffers in payload has buffer set to NULL, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_first_out_of_2_buffers_having_buffer_NULL_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[1];
+    uint8_t payload_bytes_2[1];
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = NULL;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_067: [ If any of the buffers in payload has buffer set to NULL, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_second_out_of_2_buffers_having_buffer_NULL_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[1];
+    uint8_t payload_bytes_2[1];
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = NULL;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_068: [ If any of the buffers in payload has length set to 0, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_first_out_of_2_buffers_having_length_0_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[1];
+    uint8_t payload_bytes_2[1];
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = 0;
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_068: [ If any of the buffers in payload has length set to 0, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_second_out_of_2_buffers_having_length_0_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[1];
+    uint8_t payload_bytes_2[1];
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = 0;
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_069: [ If the sum of buffer lengths for all the buffers in payload is greater than UINT32_MAX, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_sum_of_buffer_lengths_exceeding_UINT32_MAX_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = UINT32_MAX;
+    payload_buffers[1].buffer = payload_bytes;
+    payload_buffers[1].length = 1;
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_070: [ If on_receive_complete is NULL, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_on_recv_complete_NULL_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), NULL, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_072: [ If async_socket is not OPEN, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_when_not_open_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_072: [ If async_socket is not OPEN, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_after_close_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    (void)async_socket_close(async_socket);
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_144: [ If the socket has a continuous receive, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_when_a_continuous_receive_is_started_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_073: [ Otherwise async_socket_receive_async shall create a context for the recv where an iovec for each of the buffers of payload, on_receive_complete and on_receive_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_074: [ The context shall also allocate enough memory to keep an array of buffer_count iovecs. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_102: [ Then the context shall be added at the tail of the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_077: [ On success, async_socket_receive_async shall return 0. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_009: [ async_socket_receive_async shall then complete the operations in the receive queue if the socket is readable. ]
+TEST_FUNCTION(async_socket_receive_async_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    setup_async_socket_receive_async_mocks();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_071: [ on_receive_complete_context shall be allowed to be NULL. ]
+TEST_FUNCTION(async_socket_receive_async_with_NULL_on_recv_complete_context_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    setup_async_socket_receive_async_mocks();
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_009: [ async_socket_receive_async shall then complete the operations in the receive queue if the socket is readable. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_012: [ While the queue is not empty and the socket is ready for the direction of the queue, complete_queued_io shall remove the first context from the queue and complete it without holding the lock: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_016: [ If the on_recvv filled all the buffers, complete_queued_io shall keep the socket marked as readable, since more data may be available. ]
+TEST_FUNCTION(async_socket_receive_async_completes_the_receive_when_the_socket_is_readable)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, sizeof(payload_bytes)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_083: [ For ASYNC_SOCKET_IO_TYPE_RECEIVE, complete_queued_io shall call the on_recvv callback with an iovec for each of the buffers to receive in all of them with one call and do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_007: [ on_socket_recvv shall receive in all the iovecs by calling the system recvmsg socket API. ]
+TEST_FUNCTION(async_socket_receive_async_with_2_buffers_receives_in_both_with_one_recvmsg)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, sizeof(payload_bytes_1) + sizeof(payload_bytes_2)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_received_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_1, g_received_messages[0].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes_1) + sizeof(payload_bytes_2), g_received_messages[0].length);
+    ASSERT_ARE_EQUAL(size_t, 2, g_received_messages[0].iovec_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_083: [ For ASYNC_SOCKET_IO_TYPE_RECEIVE, complete_queued_io shall call the on_recvv callback with an iovec for each of the buffers to receive in all of them with one call and do the following: ]
+TEST_FUNCTION(async_socket_receive_async_with_vectored_transport_calls_on_recvv_with_all_the_buffers)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_vectored_transport(test_execution_engine, mocked_on_sendv, test_send_ctx, mocked_on_recvv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_recvv(test_recv_ctx, async_socket, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, sizeof(payload_bytes_1) + sizeof(payload_bytes_2)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_078: [ If any error occurs, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_underlying_calls_fail_async_socket_receive_async_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    setup_async_socket_receive_async_mocks();
+
+    umock_c_negative_tests_snapshot();
+    errno = 0;
+
+    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
+    {
+        if (umock_c_negative_tests_can_call_fail(index))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(index);
+
+            // act
+            int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, NULL);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", index);
+        }
+    }
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_027: [ Otherwise, if the socket submits its operations to the io_uring of the completion port, async_socket_receive_async shall create a context for the receive where an iovec for each of the buffers of payload, on_receive_complete and on_receive_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_029: [ Otherwise, async_socket_receive_async shall submit the receive by calling completion_port_submit_io and add the context to the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_077: [ On success, async_socket_receive_async shall return 0. ]
+TEST_FUNCTION(async_socket_receive_async_with_io_uring_submits_the_receive)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(int, COMPLETION_PORT_IO_TYPE_RECEIVE, g_submitted_io[0]->io_type);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io[0]->message->msg_iovlen);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes, g_submitted_io[0]->message->msg_iov[0].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes), g_submitted_io[0]->message->msg_iov[0].iov_len);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_028: [ If the receive queue is not empty, async_socket_receive_async shall add the context at the tail of the receive queue. ]
+TEST_FUNCTION(async_socket_receive_async_with_io_uring_queues_the_receive_behind_the_submitted_receive)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_078: [ If any error occurs, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_completion_port_submit_io_fails_async_socket_receive_async_with_io_uring_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_submit_io(test_completion_port, test_socket, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_144: [ If the socket has a continuous receive, async_socket_receive_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_async_with_io_uring_when_a_continuous_receive_is_started_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_166: [ If the socket receives with a buffer ring, async_socket_receive_async shall queue the receive and complete the receive queue the same way as when the socket does not use io_uring. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_162: [ If the socket receives with a buffer ring, complete_queued_io shall instead copy the data of the buffers the kernel received in, in the order of the stream, in the buffers of the receive and lend each buffer whose data was all taken back to the kernel. ]
+TEST_FUNCTION(async_socket_receive_async_with_a_buffer_ring_copies_the_received_data_and_lends_the_buffer_back_to_the_kernel)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    uint8_t received_bytes[] = { 0x42, 0x43 };
+    receive_in_ring_buffer(0, received_bytes, sizeof(received_bytes));
+    uint8_t payload_bytes[4] = { 0 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    // queue the receive
+    setup_lock_mocks();
+    // take it from the receive queue
+    setup_lock_mocks();
+    // take the received buffers
+    setup_lock_mocks();
+    // all the data of the buffer was copied, it goes back to the kernel
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_buffer_ring_add(test_buffer_ring, g_ring_buffers[0], TEST_RECEIVE_BUFFER_SIZE, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, sizeof(received_bytes)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint8_t, 0x42, payload_bytes[0]);
+    ASSERT_ARE_EQUAL(uint8_t, 0x43, payload_bytes[1]);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_162: [ If the socket receives with a buffer ring, complete_queued_io shall instead copy the data of the buffers the kernel received in, in the order of the stream, in the buffers of the receive and lend each buffer whose data was all taken back to the kernel. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_158: [ on_io_uring_ring_receive_complete shall submit the receive of the buffer ring again if the stream did not end and the kernel has buffers to receive in, otherwise it is submitted again once the receives lend buffers back to the kernel. ]
+TEST_FUNCTION(async_socket_receive_async_with_a_buffer_ring_that_ran_out_of_buffers_submits_its_receive_again_once_half_the_buffers_are_lent_back)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    for (uint16_t buffer_id = 0; buffer_id < TEST_RING_BUFFER_COUNT; buffer_id++)
+    {
+        uint8_t received_byte = (uint8_t)(0x10 + buffer_id);
+        receive_in_ring_buffer(buffer_id, &received_byte, 1);
+    }
+    complete_ring_receive(-ENOBUFS, false, 0, false);
+    uint8_t payload_bytes[TEST_RING_BUFFER_COUNT / 2] = { 0 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    // queue the receive
+    setup_lock_mocks();
+    // take it from the receive queue
+    setup_lock_mocks();
+    // take the received buffers
+    setup_lock_mocks();
+    // the first half of the buffers goes back to the kernel and the receive of the buffer ring is submitted again
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    for (uint16_t buffer_id = 0; buffer_id < TEST_RING_BUFFER_COUNT / 2; buffer_id++)
+    {
+        STRICT_EXPECTED_CALL(completion_port_buffer_ring_add(test_buffer_ring, g_ring_buffers[buffer_id], TEST_RECEIVE_BUFFER_SIZE, buffer_id));
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, sizeof(payload_bytes)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    for (uint32_t index = 0; index < sizeof(payload_bytes); index++)
+    {
+        ASSERT_ARE_EQUAL(uint8_t, (uint8_t)(0x10 + index), payload_bytes[index]);
+    }
+    ASSERT_ARE_EQUAL(size_t, 2, g_submitted_io_count);
+    ASSERT_IS_TRUE(g_submitted_io[1]->is_multishot);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// async_socket_receive_pooled_async
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_106: [ If async_socket is NULL, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_with_NULL_async_socket_fails)
+{
+    // arrange
+
+    // act
+    int result = async_socket_receive_pooled_async(NULL, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_107: [ If on_receive_complete is NULL, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_with_NULL_on_receive_complete_fails)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, NULL, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_109: [ If the socket has no receive buffer pool, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_without_a_receive_buffer_pool_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_110: [ If async_socket is not OPEN, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_when_not_open_fails)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_set_receive_buffer_pool(async_socket, buffer_pool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_145: [ If the socket has a continuous receive, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_when_a_continuous_receive_is_started_fails)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_111: [ Otherwise async_socket_receive_pooled_async shall create a context for the receive without any buffer where on_receive_complete and on_receive_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_112: [ Then the context shall be added at the tail of the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_113: [ async_socket_receive_pooled_async shall then complete the operations in the receive queue if the socket is readable. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_114: [ On success, async_socket_receive_pooled_async shall return 0. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+
+    setup_async_socket_receive_pooled_async_mocks();
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_108: [ on_receive_complete_context shall be allowed to be NULL. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_with_NULL_on_receive_complete_context_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+
+    setup_async_socket_receive_pooled_async_mocks();
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_115: [ If any error occurs, async_socket_receive_pooled_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_underlying_calls_fail_async_socket_receive_pooled_async_fails)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+
+    setup_async_socket_receive_pooled_async_mocks();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
+    {
+        if (umock_c_negative_tests_can_call_fail(index))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(index);
+
+            // act
+            int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", index);
+        }
+    }
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_113: [ async_socket_receive_pooled_async shall then complete the operations in the receive queue if the socket is readable. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_116: [ For a pooled receive, complete_queued_io shall take a buffer from the receive buffer pool of the socket, allocating a new one if the pool has no free buffer, and call the on_recvv callback with an iovec for the buffer. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_119: [ complete_queued_io shall call the on_receive_complete callback of a pooled receive with the buffer taken from the pool when the on_recvv size > 0, the caller then owning the buffer, and with NULL otherwise. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_completes_the_receive_in_a_buffer_of_the_pool_when_the_socket_is_readable)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    // take the free buffer of the pool
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(g_pooled_buffer);
+    ASSERT_ARE_EQUAL(size_t, 1, g_received_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, g_pooled_buffer, g_received_messages[0].first_byte);
+    ASSERT_ARE_EQUAL(size_t, TEST_RECEIVE_BUFFER_SIZE, g_received_messages[0].length);
+    ASSERT_ARE_EQUAL(size_t, 1, g_received_messages[0].iovec_count);
+
+    // cleanup
+    async_socket_buffer_pool_return(buffer_pool, g_pooled_buffer);
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_160: [ For a pooled receive of a socket that receives with a buffer ring, complete_queued_io shall take the first buffer the kernel received in, without copying its data, and lend a buffer taken from the receive buffer pool to the kernel in its place. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_163: [ After a pooled receive of a socket that receives with a buffer ring, complete_queued_io shall keep the socket marked as readable if the kernel received in more buffers or the stream ended. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_with_a_buffer_ring_takes_the_next_received_buffer_right_away)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    uint8_t first_received_bytes[] = { 0x42 };
+    uint8_t second_received_bytes[] = { 0x43, 0x44 };
+    receive_in_ring_buffer(0, first_received_bytes, sizeof(first_received_bytes));
+    receive_in_ring_buffer(1, second_received_bytes, sizeof(second_received_bytes));
+    void* second_received_buffer = g_ring_buffers[1];
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
+    void* first_pooled_buffer = g_pooled_buffer;
+    ASSERT_IS_NOT_NULL(first_pooled_buffer);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    // queue the receive
+    setup_lock_mocks();
+    // take it from the receive queue, the socket is still marked as readable
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    // the pool has no free buffer left to lend to the kernel in place of the received one
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, sizeof(unsigned char)));
+    STRICT_EXPECTED_CALL(completion_port_buffer_ring_add(test_buffer_ring, IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, 1));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, second_received_buffer, sizeof(second_received_bytes)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(void_ptr, second_received_buffer, g_pooled_buffer);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, second_received_buffer, g_ring_buffers[1]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(second_received_bytes, g_pooled_buffer, sizeof(second_received_bytes)));
+
+    // cleanup
+    async_socket_buffer_pool_return(buffer_pool, first_pooled_buffer);
+    async_socket_buffer_pool_return(buffer_pool, g_pooled_buffer);
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_161: [ If a receive with buffers already took the start of the data of that buffer, complete_queued_io shall instead copy the rest of the data in a buffer taken from the receive buffer pool and lend the received buffer back to the kernel. ]
+TEST_FUNCTION(async_socket_receive_pooled_async_with_a_buffer_ring_copies_the_rest_of_a_buffer_partially_taken_by_a_receive)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    uint8_t received_bytes[] = { 0x42, 0x43 };
+    receive_in_ring_buffer(0, received_bytes, sizeof(received_bytes));
+    void* received_buffer = g_ring_buffers[0];
+    uint8_t payload_bytes[1] = { 0 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    // queue the receive
+    setup_lock_mocks();
+    // take it from the receive queue
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    // take the free buffer of the pool to copy the rest of the data in, the received buffer goes back to the kernel
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(completion_port_buffer_ring_add(test_buffer_ring, received_buffer, TEST_RECEIVE_BUFFER_SIZE, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(g_pooled_buffer);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, received_buffer, g_pooled_buffer);
+    ASSERT_ARE_EQUAL(uint8_t, 0x42, payload_bytes[0]);
+    ASSERT_ARE_EQUAL(uint8_t, 0x43, ((uint8_t*)g_pooled_buffer)[0]);
+
+    // cleanup
+    async_socket_buffer_pool_return(buffer_pool, g_pooled_buffer);
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// async_socket_receive_continuous_async
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_121: [ async_socket_receive_continuous_async shall validate its arguments, create the context of the receive and add it to the receive queue the same way as async_socket_receive_async. ]
+TEST_FUNCTION(async_socket_receive_continuous_async_with_NULL_async_socket_fails)
+{
+    // arrange
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    // act
+    int result = async_socket_receive_continuous_async(NULL, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_121: [ async_socket_receive_continuous_async shall validate its arguments, create the context of the receive and add it to the receive queue the same way as async_socket_receive_async. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_123: [ async_socket_receive_continuous_async shall store the context as the continuous receive of the socket. ]
+TEST_FUNCTION(async_socket_receive_continuous_async_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+
+    setup_async_socket_receive_async_mocks();
+
+    // act
+    int result = async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_122: [ If the socket already has a continuous receive, async_socket_receive_continuous_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_continuous_async_when_a_continuous_receive_is_started_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_124: [ async_socket_open_async shall start the socket without a continuous receive. ]
+TEST_FUNCTION(async_socket_receive_continuous_async_after_the_socket_is_reopened_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    async_socket_close(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_async_socket_receive_async_mocks();
+
+    // act
+    int result = async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_121: [ async_socket_receive_continuous_async shall validate its arguments, create the context of the receive and add it to the receive queue the same way as async_socket_receive_async. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_123: [ async_socket_receive_continuous_async shall store the context as the continuous receive of the socket. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_029: [ Otherwise, async_socket_receive_async shall submit the receive by calling completion_port_submit_io and add the context to the receive queue. ]
+TEST_FUNCTION(async_socket_receive_continuous_async_with_io_uring_submits_the_receive)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes, g_submitted_io[0]->message->msg_iov[0].iov_base);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_122: [ If the socket already has a continuous receive, async_socket_receive_continuous_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_receive_continuous_async_with_io_uring_when_a_continuous_receive_is_started_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// async_socket_cancel_continuous_receive
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_125: [ If async_socket is NULL, async_socket_cancel_continuous_receive shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_cancel_continuous_receive_with_NULL_async_socket_fails)
+{
+    // arrange
+
+    // act
+    int result = async_socket_cancel_continuous_receive(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_126: [ If async_socket is not OPEN, async_socket_cancel_continuous_receive shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_cancel_continuous_receive_when_not_open_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_cancel_continuous_receive(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_127: [ If the socket has no continuous receive, async_socket_cancel_continuous_receive shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_cancel_continuous_receive_without_a_continuous_receive_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_cancel_continuous_receive(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_128: [ Otherwise async_socket_cancel_continuous_receive shall remove the continuous receive from the socket. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_129: [ If the continuous receive is waiting in the receive queue, async_socket_cancel_continuous_receive shall remove it from the queue, call its on_receive_complete with ASYNC_SOCKET_RECEIVE_ABANDONED and free it. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_132: [ On success, async_socket_cancel_continuous_receive shall return 0. ]
+TEST_FUNCTION(async_socket_cancel_continuous_receive_abandons_the_queued_receive)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_cancel_continuous_receive(async_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    // a new continuous receive can be started
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_130: [ If the continuous receive is submitted to the io_uring of the completion port, async_socket_cancel_continuous_receive shall cancel it by calling completion_port_cancel_io. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_044: [ If result is -ECANCELED or -ECONNRESET, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(async_socket_cancel_continuous_receive_with_io_uring_cancels_the_submitted_receive)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_cancel_io(test_completion_port, test_socket, g_submitted_io[0]));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    // the cancelled receive completes on a completion port thread
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_cancel_continuous_receive(async_socket);
+    run_test_io_completions();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// on_transport_sendv
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_050: [ async_socket_create_with_transport shall delegate to async_socket_create_with_vectored_transport passing in callbacks for on_sendv and on_recvv that call on_send and on_recv for each buffer. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_051: [ async_socket_create_with_transport shall store on_send, on_send_context, on_recv and on_recv_context in the socket. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_052: [ on_transport_sendv shall call on_send for each iovec, for as long as on_send sends the whole iovec. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_054: [ Otherwise on_transport_sendv shall return the number of bytes sent. ]
+TEST_FUNCTION(on_transport_sendv_calls_on_send_for_each_buffer)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)));
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_2, sizeof(payload_bytes_2)));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_052: [ on_transport_sendv shall call on_send for each iovec, for as long as on_send sends the whole iovec. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_054: [ Otherwise on_transport_sendv shall return the number of bytes sent. ]
+TEST_FUNCTION(when_on_send_sends_part_of_the_first_buffer_on_transport_sendv_returns_and_the_rest_is_sent_by_the_next_call)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42, 0x43 };
+    uint8_t payload_bytes_2[] = { 0x44, 0x45 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_1 + 1, sizeof(payload_bytes_1) - 1));
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_2, sizeof(payload_bytes_2)));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_053: [ If on_send fails before any byte was sent, on_transport_sendv shall return -1. ]
+TEST_FUNCTION(when_on_send_fails_for_the_first_buffer_on_transport_sendv_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)))
+        .SetReturn(-1);
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    errno = EDESTADDRREQ;
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_054: [ Otherwise on_transport_sendv shall return the number of bytes sent. ]
+TEST_FUNCTION(when_on_send_fails_for_the_second_buffer_on_transport_sendv_returns_the_bytes_of_the_first_buffer)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)));
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_2, sizeof(payload_bytes_2)))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_on_send(test_send_ctx, async_socket, payload_bytes_2, sizeof(payload_bytes_2)))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, sizeof(struct iovec)));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    errno = EWOULDBLOCK;
+    ASYNC_SOCKET_SEND_SYNC_RESULT result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// on_transport_recvv
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_050: [ async_socket_create_with_transport shall delegate to async_socket_create_with_vectored_transport passing in callbacks for on_sendv and on_recvv that call on_send and on_recv for each buffer. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_051: [ async_socket_create_with_transport shall store on_send, on_send_context, on_recv and on_recv_context in the socket. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_055: [ on_transport_recvv shall call on_recv for each iovec, for as long as on_recv fills the whole iovec. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_057: [ Otherwise on_transport_recvv shall return the number of bytes received. ]
+TEST_FUNCTION(on_transport_recvv_calls_on_recv_for_each_buffer)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_recv(test_recv_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)));
+    STRICT_EXPECTED_CALL(mocked_on_recv(test_recv_ctx, async_socket, payload_bytes_2, sizeof(payload_bytes_2)));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, sizeof(payload_bytes_1) + sizeof(payload_bytes_2)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_055: [ on_transport_recvv shall call on_recv for each iovec, for as long as on_recv fills the whole iovec. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_057: [ Otherwise on_transport_recvv shall return the number of bytes received. ]
+TEST_FUNCTION(when_on_recv_partially_fills_the_first_buffer_on_transport_recvv_returns_the_bytes_received)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42, 0x43 };
+    uint8_t payload_bytes_2[] = { 0x44, 0x45 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_recv(test_recv_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_056: [ If on_recv fails or returns 0 before any byte was received, on_transport_recvv shall return the value returned by on_recv. ]
+TEST_FUNCTION(when_on_recv_returns_0_for_the_first_buffer_on_transport_recvv_returns_0)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_recv(test_recv_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)))
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_056: [ If on_recv fails or returns 0 before any byte was received, on_transport_recvv shall return the value returned by on_recv. ]
+TEST_FUNCTION(when_on_recv_fails_with_EAGAIN_for_the_first_buffer_the_receive_stays_queued)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_recv(test_recv_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)))
+        .SetReturn(-1);
+    setup_lock_mocks();
+
+    // act
+    errno = EAGAIN;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_057: [ Otherwise on_transport_recvv shall return the number of bytes received. ]
+TEST_FUNCTION(when_on_recv_fails_for_the_second_buffer_on_transport_recvv_returns_the_bytes_of_the_first_buffer)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create_with_transport(test_execution_engine, mocked_on_send, test_send_ctx, mocked_on_recv, test_recv_ctx);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_on_recv(test_recv_ctx, async_socket, payload_bytes_1, sizeof(payload_bytes_1)));
+    STRICT_EXPECTED_CALL(mocked_on_recv(test_recv_ctx, async_socket, payload_bytes_2, sizeof(payload_bytes_2)))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, sizeof(payload_bytes_1)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// event_complete_callback
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_079: [ If context is NULL, event_complete_callback shall do nothing. ]
+TEST_FUNCTION(event_complete_func_context_NULL_fail)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    // act
+    g_event_callback(NULL, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_082: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLIN or COMPLETION_PORT_EPOLL_EPOLLRDHUP, event_complete_callback shall mark the socket as readable and complete the operations in the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_083: [ For ASYNC_SOCKET_IO_TYPE_RECEIVE, complete_queued_io shall call the on_recvv callback with an iovec for each of the buffers to receive in all of them with one call and do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_007: [ on_socket_recvv shall receive in all the iovecs by calling the system recvmsg socket API. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_092: [ If the on_recvv size > 0, complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context, ASYNC_SOCKET_RECEIVE_OK and the on_recvv size. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_093: [ complete_queued_io shall then free the io_context memory. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_012: [ While the queue is not empty and the socket is ready for the direction of the queue, complete_queued_io shall remove the first context from the queue and complete it without holding the lock: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_016: [ If the on_recvv filled all the buffers, complete_queued_io shall keep the socket marked as readable, since more data may be available. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_action)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    uint32_t payload_size = sizeof(payload_bytes) / sizeof(payload_bytes[0]);
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(payload_size);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, payload_size));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_092: [ If the on_recvv size > 0, complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context, ASYNC_SOCKET_RECEIVE_OK and the on_recvv size. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_012: [ While the queue is not empty and the socket is ready for the direction of the queue, complete_queued_io shall remove the first context from the queue and complete it without holding the lock: ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_short_receive_leaves_the_next_receive_queued)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_089: [ If errno is EAGAIN or EWOULDBLOCK, then complete_queued_io shall put the context back at the head of the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_012: [ While the queue is not empty and the socket is ready for the direction of the queue, complete_queued_io shall remove the first context from the queue and complete it without holding the lock: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_016: [ If the on_recvv filled all the buffers, complete_queued_io shall keep the socket marked as readable, since more data may be available. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_full_receive_completes_the_next_receive_too)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, sizeof(payload_bytes)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    // the socket has no more data, the second receive goes back to the queue
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(-1);
+    setup_lock_mocks();
+
+    // act
+    errno = EAGAIN;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_088: [ If the on_recvv size < 0, then: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_089: [ If errno is EAGAIN or EWOULDBLOCK, then complete_queued_io shall put the context back at the head of the receive queue. ]
+TEST_FUNCTION(event_complete_func_recv_returns_EWOULDBLOCK_leaves_the_receive_queued)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    setup_lock_mocks();
+
+    // act
+    errno = EWOULDBLOCK;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_090: [ If errno is ECONNRESET, then complete_queued_io shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(event_complete_func_recv_returns_ECONNRESET)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    errno = ECONNRESET;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_095: [ If errno is any other error, then complete_queued_io shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ERROR. ]
+TEST_FUNCTION(event_complete_callback_recv_returns_any_random_error_no)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
+    // act
+    errno = EMSGSIZE;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_091: [ If the on_recvv size equals 0, then complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(event_complete_func_recv_returns_0_bytes_success)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    async_socket_close(async_socket);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_042: [ If async_socket is not OPEN, async_socket_close shall return. ]
-TEST_FUNCTION(async_socket_close_when_not_open_returns)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_082: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLIN or COMPLETION_PORT_EPOLL_EPOLLRDHUP, event_complete_callback shall mark the socket as readable and complete the operations in the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_013: [ For ASYNC_SOCKET_IO_TYPE_NOTIFY, complete_queued_io shall call the notify complete callback with an IN flag for the receive queue and with an OUT flag for the send queue. ]
+PARAMETERIZED_TEST_FUNCTION(event_complete_func_readable_completes_the_IN_notify,
+    ARGS(COMPLETION_PORT_EPOLL_ACTION, epoll_action),
+    CASE((COMPLETION_PORT_EPOLL_EPOLLIN), EPOLLIN),
+    CASE((COMPLETION_PORT_EPOLL_EPOLLRDHUP), EPOLLRDHUP))
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_IN));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    async_socket_close(async_socket);
+    g_event_callback(g_event_callback_ctx, epoll_action);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_042: [ If async_socket is not OPEN, async_socket_close shall return. ]
-TEST_FUNCTION(async_socket_close_after_close_returns)
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_008: [ event_complete_callback shall call the notify complete callback with an ABANDONED flag when the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_011: [ If the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY then event_complete_callback shall call the notify complete callback with an ERROR flag. ]
+PARAMETERIZED_TEST_FUNCTION(event_complete_func_notify_calls_callback_with_expected_result,
+    ARGS(ASYNC_SOCKET_NOTIFY_IO_TYPE, io_type, COMPLETION_PORT_EPOLL_ACTION, epoll_action, ASYNC_SOCKET_NOTIFY_IO_RESULT, expected_result),
+    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, COMPLETION_PORT_EPOLL_ABANDONED, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED), IN_ABANDONED_abandons),
+    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, COMPLETION_PORT_EPOLL_ABANDONED, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED), OUT_ABANDONED_abandons),
+    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, COMPLETION_PORT_EPOLL_ERROR, ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR), IN_ERROR),
+    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, COMPLETION_PORT_EPOLL_ERROR, ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR), OUT_ERROR))
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    async_socket_close(async_socket);
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+    // a send that is waiting for the socket to become writable keeps an OUT notify queued
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, io_type, test_on_notify_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    setup_lock_mocks();
+    if (io_type == ASYNC_SOCKET_NOTIFY_IO_TYPE_IN)
+    {
+        STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, expected_result));
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, (expected_result == ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR) ? ASYNC_SOCKET_SEND_ERROR : ASYNC_SOCKET_SEND_ABANDONED));
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    }
+    else
+    {
+        STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, (expected_result == ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR) ? ASYNC_SOCKET_SEND_ERROR : ASYNC_SOCKET_SEND_ABANDONED));
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, expected_result));
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    }
 
     // act
-    async_socket_close(async_socket);
+    g_event_callback(g_event_callback_ctx, epoll_action);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_039: [ async_socket_close shall call close on the underlying socket. ]
-TEST_FUNCTION(async_socket_close_after_open_and_recv)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_082: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLIN or COMPLETION_PORT_EPOLL_EPOLLRDHUP, event_complete_callback shall mark the socket as readable and complete the operations in the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_091: [ If the on_recvv size equals 0, then complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_018: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLRDHUP, event_complete_callback shall also keep the socket marked as readable from then on, so that the receives get the data sent before the peer closed the connection and then complete with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(event_complete_func_recv_EPOLLRDHUP_receives_the_data_left_and_then_abandons)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    uint8_t payload_bytes[] = { 0x42 };
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    umock_c_reset_all_calls();
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx));
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(completion_port_remove(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_close(test_socket));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    async_socket_close(async_socket);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// async_socket_send_async
-
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_043: [ If async_socket is NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_NULL_async_socket_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_082: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLIN or COMPLETION_PORT_EPOLL_EPOLLRDHUP, event_complete_callback shall mark the socket as readable and complete the operations in the receive queue. ]
+TEST_FUNCTION(event_complete_func_EPOLLRDHUP_leaves_the_sends_queued)
 {
     // arrange
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
+
+    // mark readable, nothing to receive
+    setup_lock_mocks();
+    setup_lock_mocks();
 
     // act
-    result = async_socket_send_async(NULL, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, (void*)0x4244);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_044: [ If buffers is NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_NULL_payload_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_080: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_ABANDONED, event_complete_callback shall remove all the contexts from the receive and send queues and for each of them do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_084: [ Then event_complete_callback shall free the context memory. ]
+TEST_FUNCTION(event_complete_func_recv_ABANDONED_and_abandons_the_connection)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
     // act
-    result = async_socket_send_async(async_socket, NULL, 1, test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
 
     // cleanup
     async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_045: [ If buffer_count is 0, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_0_payload_count_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_080: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_ABANDONED, event_complete_callback shall remove all the contexts from the receive and send queues and for each of them do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_084: [ Then event_complete_callback shall free the context memory. ]
+TEST_FUNCTION(event_complete_func_send_ABANDONED_and_abandons_the_connection)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
     umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
+
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, 0, test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
 
     // cleanup
     async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_046: [ If any of the buffers in payload has buffer set to NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_first_out_of_2_buffers_having_buffer_NULL_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_089: [ event_complete_callback shall also remove all the sends that are left in the zero copy queue, whose pages the kernel did not release in time, and complete them the same way. ]
+TEST_FUNCTION(event_complete_func_send_ABANDONED_with_zero_copy_abandons_the_zero_copy_sends_without_waiting)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
 
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
-    payload_buffers[0].buffer = NULL;
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    payload_buffers[1].buffer = payload_bytes;
-    payload_buffers[1].length = sizeof(payload_bytes);
-    umock_c_reset_all_calls();
+    setup_zero_copy_send(async_socket, payload_buffers);
+
+    // no poll, the callback runs with the lock of the epoll thread held
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
 
     // cleanup
     async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_046: [ If any of the buffers in payload has buffer set to NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_second_out_of_2_buffers_having_buffer_NULL_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_094: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLOUT, event_complete_callback shall mark the socket as writable and complete the operations in the send queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_096: [ For ASYNC_SOCKET_IO_TYPE_SEND, complete_queued_io shall call on_sendv with the iovecs of the data that is left to send. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_093: [ complete_queued_io shall then free the io_context memory. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_012: [ While the queue is not empty and the socket is ready for the direction of the queue, complete_queued_io shall remove the first context from the queue and complete it without holding the lock: ]
+TEST_FUNCTION(event_complete_func_send_EPOLLOUT_success)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
 
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    payload_buffers[1].buffer = NULL;
-    payload_buffers[1].length = sizeof(payload_bytes);
     umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
 
     // cleanup
     async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_047: [ If any of the buffers in payload has length set to 0, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_first_out_of_2_buffers_having_length_0_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_097: [ If on_sendv returns value is < 0 complete_queued_io shall do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_098: [ if errno is ECONNRESET, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ABANDONED. ]
+TEST_FUNCTION(event_complete_func_send_EPOLLOUT_abandoned)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = 0;
-    payload_buffers[1].buffer = payload_bytes;
-    payload_buffers[1].length = sizeof(payload_bytes);
+    payload_buffers[0].length = sizeof(payload_bytes);
     umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    errno = ECONNRESET;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
 
     // cleanup
     async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_047: [ If any of the buffers in payload has length set to 0, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_second_out_of_2_buffers_having_length_0_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_099: [ if errno is anything else, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ERROR. ]
+TEST_FUNCTION(event_complete_func_send_EPOLLOUT_error)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    payload_buffers[1].buffer = payload_bytes;
-    payload_buffers[1].length = 0;
     umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ERROR));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    errno = ENOBUFS;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
 
     // cleanup
     async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_048: [ If the sum of buffer lengths for all the buffers in payload is greater than UINT32_MAX, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_UINT32_MAX_buffers_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_101: [ If on_sendv returns a value > 0 but less than the amount to be sent, complete_queued_io shall skip the bytes that were sent, across as many buffers as needed, and call on_sendv again until the payload length has been sent. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_multiple_sends_success)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
+
+    uint8_t payload_bytes[] = { 0x42, 0x43, 0x44, 0x45 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    payload_buffers[1].buffer = payload_bytes;
-    payload_buffers[1].length = 0;
     umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    // UINT32_MAX will for sure make us want more memory than UINT32_MAX bytes
-    result = async_socket_send_async(async_socket, payload_buffers, UINT32_MAX, test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(size_t, 3, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes, g_sent_messages[1].first_byte);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes + 2, g_sent_messages[2].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes) - 2, g_sent_messages[2].length);
 
     // cleanup
     async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_049: [ If on_send_complete is NULL, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(async_socket_send_async_with_on_send_complete_NULL_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_017: [ If errno is EAGAIN or EWOULDBLOCK, complete_queued_io shall put the contexts with the data that is left to send back at the head of the send queue, in the order they were queued. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_would_block_keeps_the_rest_of_the_send_queued)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
+
+    uint8_t payload_bytes[] = { 0x42, 0x43, 0x44, 0x45 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
     umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    setup_lock_mocks();
+    // the next writable event sends what is left
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), NULL, test_callback_ctx);
+    errno = EWOULDBLOCK;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_051: [ If async_socket is not OPEN, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ABANDONED. ]
-TEST_FUNCTION(async_socket_send_async_when_not_open_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_012: [ While the queue is not empty and the socket is ready for the direction of the queue, complete_queued_io shall remove the first context from the queue and complete it without holding the lock: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_061: [ For ASYNC_SOCKET_IO_TYPE_SEND, complete_queued_io shall also remove from the queue the sends that follow the first one, for as long as the iovecs of all of them fit in 64 iovecs. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_062: [ complete_queued_io shall call on_sendv once with the iovecs of the data that is left to send of all the sends taken from the queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_063: [ complete_queued_io shall call on_send_complete with ASYNC_SOCKET_SEND_OK for each send that was sent entirely, in the order the sends were queued. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_013: [ For ASYNC_SOCKET_IO_TYPE_NOTIFY, complete_queued_io shall call the notify complete callback with an IN flag for the receive queue and with an OUT flag for the send queue. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_completes_the_send_queue_in_order)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers_1[1];
+    payload_buffers_1[0].buffer = payload_bytes_1;
+    payload_buffers_1[0].length = sizeof(payload_bytes_1);
+    ASYNC_SOCKET_BUFFER payload_buffers_2[1];
+    payload_buffers_2[0].buffer = payload_bytes_2;
+    payload_buffers_2[0].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers_1, 1);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers_2, 1, test_on_send_complete, NULL));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, test_on_notify_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    // both sends go out with one sendmsg
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(NULL, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_NOT_OPEN, result);
+    ASSERT_ARE_EQUAL(size_t, 2, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_1, g_sent_messages[1].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes_1) + sizeof(payload_bytes_2), g_sent_messages[1].length);
+    ASSERT_ARE_EQUAL(size_t, 2, g_sent_messages[1].iovec_count);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_051: [ If async_socket is not OPEN, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ABANDONED. ]
-TEST_FUNCTION(async_socket_send_async_after_close_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_063: [ complete_queued_io shall call on_send_complete with ASYNC_SOCKET_SEND_OK for each send that was sent entirely, in the order the sends were queued. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_101: [ If on_sendv returns a value > 0 but less than the amount to be sent, complete_queued_io shall skip the bytes that were sent, across as many buffers as needed, and call on_sendv again until the payload length has been sent. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_017: [ If errno is EAGAIN or EWOULDBLOCK, complete_queued_io shall put the contexts with the data that is left to send back at the head of the send queue, in the order they were queued. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_partial_coalesced_send_completes_only_the_sends_that_were_sent)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    async_socket_close(async_socket);
+
+    uint8_t payload_bytes_1[] = { 0x42, 0x43 };
+    uint8_t payload_bytes_2[] = { 0x44, 0x45 };
+    ASYNC_SOCKET_BUFFER payload_buffers_1[1];
+    payload_buffers_1[0].buffer = payload_bytes_1;
+    payload_buffers_1[0].length = sizeof(payload_bytes_1);
+    ASYNC_SOCKET_BUFFER payload_buffers_2[1];
+    payload_buffers_2[0].buffer = payload_bytes_2;
+    payload_buffers_2[0].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers_1, 1);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers_2, 1, test_on_send_complete, NULL));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(sizeof(payload_bytes_1) + 1);
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    setup_lock_mocks();
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    errno = EWOULDBLOCK;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_NOT_OPEN, result);
+    ASSERT_ARE_EQUAL(size_t, 3, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_2 + 1, g_sent_messages[2].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes_2) - 1, g_sent_messages[2].length);
+    ASSERT_ARE_EQUAL(size_t, 1, g_sent_messages[2].iovec_count);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_send callback to send the buffer. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_send shall attempt to send the data by calling send with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_053: [ async_socket_send_async shall continue to send the data until the payload length has been sent. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_062: [ On success, async_socket_send_async shall return ASYNC_SOCKET_SEND_SYNC_OK. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_061: [ If the send is successful, async_socket_send_async shall call the on_send_complete with on_send_complete_context and ASYNC_SOCKET_SEND_SYNC_OK. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_062: [ On success, async_socket_send_async shall return ASYNC_SOCKET_SEND_SYNC_OK. ]
-TEST_FUNCTION(async_socket_send_async_succeeds)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_064: [ Only the first send that is left to send shall be completed with the error, the sends after it shall be put back at the head of the send queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_098: [ if errno is ECONNRESET, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ABANDONED. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_coalesced_send_error_completes_only_the_first_send_with_the_error)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
 
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
-
+    uint8_t payload_bytes_1[] = { 0x42, 0x43 };
+    uint8_t payload_bytes_2[] = { 0x44, 0x45 };
+    ASYNC_SOCKET_BUFFER payload_buffers_1[1];
+    payload_buffers_1[0].buffer = payload_bytes_1;
+    payload_buffers_1[0].length = sizeof(payload_bytes_1);
+    ASYNC_SOCKET_BUFFER payload_buffers_2[1];
+    payload_buffers_2[0].buffer = payload_bytes_2;
+    payload_buffers_2[0].length = sizeof(payload_bytes_2);
+    umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers_1, 1);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers_2, 1, test_on_send_complete, NULL));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
-    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    // the second send is put back in the queue and gets its own error
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(test_on_send_complete(NULL, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    errno = ECONNRESET;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_send callback to send the buffer. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_send shall attempt to send the data by calling send with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_053: [ async_socket_send_async shall continue to send the data until the payload length has been sent. ]
-TEST_FUNCTION(async_socket_send_async_multiple_sends_succeeds)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_061: [ For ASYNC_SOCKET_IO_TYPE_SEND, complete_queued_io shall also remove from the queue the sends that follow the first one, for as long as the iovecs of all of them fit in 64 iovecs. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_does_not_coalesce_sends_with_more_than_64_iovecs)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
 
-    uint8_t payload_bytes[] = { 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x50 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
-    ssize_t send_amt = payload_buffers[0].length/2;
+    uint8_t payload_bytes_1[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers_1[1];
+    payload_buffers_1[0].buffer = payload_bytes_1;
+    payload_buffers_1[0].length = sizeof(payload_bytes_1);
+    uint8_t payload_bytes_2[64];
+    ASYNC_SOCKET_BUFFER payload_buffers_2[64];
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        payload_bytes_2[i] = (uint8_t)i;
+        payload_buffers_2[i].buffer = &payload_bytes_2[i];
+        payload_buffers_2[i].length = 1;
+    }
+    umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers_1, 1);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers_2, 64, test_on_send_complete, NULL));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(send_amt);
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
     STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
+    STRICT_EXPECTED_CALL(test_on_send_complete(NULL, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 3, g_sent_message_count);
+    ASSERT_ARE_EQUAL(size_t, 1, g_sent_messages[1].iovec_count);
+    ASSERT_ARE_EQUAL(size_t, 64, g_sent_messages[2].iovec_count);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_004: [ async_socket_send_async shall call the on_send callback to send the buffer. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_052: [ on_socket_send shall attempt to send the data by calling send with the MSG_NOSIGNAL flag to ensure SIGPIPE is not generated on errors. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_053: [ async_socket_send_async shall continue to send the data until the payload length has been sent. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_057: [ The context shall then be added to the completion port system by calling completion_port_add with EPOLL_CTL_MOD and event_complete_callback as the callback. ]
-TEST_FUNCTION(async_socket_send_async_multiple_sends_WOULDBLOCK_succeeds)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_084: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLOUT and zero copy is on, event_complete_callback shall first receive the zero copy notifications of the socket: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_085: [ event_complete_callback shall receive the messages of the error queue of the socket by calling recvmsg with MSG_ERRQUEUE until it fails. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_086: [ For each zero copy notification, event_complete_callback shall add the released sequence numbers, from ee_info to ee_data, to the send that is partially sent and to the sends in the zero copy queue they belong to. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_087: [ event_complete_callback shall then call complete_zero_copy_sends. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_083: [ While the kernel released all the pages of the send at the head of the zero copy queue, complete_zero_copy_sends shall remove it from the queue, call its on_send_complete without holding the lock with the result the send completed with and free it. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_with_zero_copy_completes_the_send_once_its_pages_are_released)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
 
-    uint8_t payload_bytes[] = { 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x50 };
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    ssize_t send_amt = payload_buffers[0].length/2;
-    umock_c_reset_all_calls();
+    setup_zero_copy_send(async_socket, payload_buffers);
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, payload_buffers[0].buffer, payload_buffers[0].length, MSG_NOSIGNAL))
-        .SetReturn(send_amt);
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, payload_buffers[0].buffer + send_amt, payload_buffers[0].length - send_amt, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_receive_zero_copy_notification_mocks(0, 0);
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    // mark the socket writable, the send queue is empty
+    setup_lock_mocks();
+    setup_lock_mocks();
 
     // act
-    errno = EWOULDBLOCK;
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
-    free(g_event_callback_ctx);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_050: [ on_send_complete_context shall be allowed to be NULL. ]
-TEST_FUNCTION(async_socket_send_async_with_NULL_on_send_complete_context_succeeds)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_086: [ For each zero copy notification, event_complete_callback shall add the released sequence numbers, from ee_info to ee_data, to the send that is partially sent and to the sends in the zero copy queue they belong to. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_with_zero_copy_does_not_complete_the_send_for_the_notification_of_another_sendmsg)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
 
-    uint8_t payload_bytes[] = { 0x42 };
+    uint8_t payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    setup_zero_copy_send(async_socket, payload_buffers);
 
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
-    STRICT_EXPECTED_CALL(test_on_send_complete(NULL, ASYNC_SOCKET_SEND_OK));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_receive_zero_copy_notification_mocks(1, 2);
+    setup_lock_mocks();
+    setup_lock_mocks();
+    setup_lock_mocks();
 
     // act
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_063: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(when_underlying_calls_fail_async_socket_send_async_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_081: [ If zero copy is on, complete_queued_io shall add the send with its result at the tail of the zero copy queue instead of completing it, so that the sends complete in order once the kernel released the pages of the zero copy sends, and then call complete_zero_copy_sends. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_083: [ While the kernel released all the pages of the send at the head of the zero copy queue, complete_zero_copy_sends shall remove it from the queue, call its on_send_complete without holding the lock with the result the send completed with and free it. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_with_zero_copy_completes_the_sends_in_order)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
 
-    uint8_t payload_bytes[] = { 0x42 };
+    uint8_t zero_copy_payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x42 };
+    ASYNC_SOCKET_BUFFER zero_copy_payload_buffers[1];
+    zero_copy_payload_buffers[0].buffer = zero_copy_payload_bytes;
+    zero_copy_payload_buffers[0].length = sizeof(zero_copy_payload_bytes);
+    uint8_t payload_bytes[] = { 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    setup_zero_copy_send(async_socket, zero_copy_payload_buffers);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, NULL));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-
-    errno = EDESTADDRREQ;
+    setup_receive_zero_copy_notification_mocks(0, 0);
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(NULL, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    setup_lock_mocks();
 
     // act
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_054: [ If the send fails to send the data, async_socket_send_async shall do the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_055: [ If the errno value is EAGAIN or EWOULDBLOCK. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_056: [ async_socket_send_async shall create a context for the send where the payload, on_send_complete and on_send_complete_context shall be stored. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_057: [ The context shall then be added to the completion port system by calling completion_port_add with EPOLL_CTL_MOD and event_complete_callback as the callback. ]
-TEST_FUNCTION(when_errno_for_send_returns_EWOULDBLOCK_it_uses_completion_port_treated_as_successfull)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_077: [ A zero copy send shall not be coalesced with other sends. ]
+TEST_FUNCTION(event_complete_func_EPOLLOUT_does_not_coalesce_zero_copy_sends)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_zero_copy_async_socket();
 
     uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    uint8_t zero_copy_payload_bytes[TEST_ZERO_COPY_SEND_THRESHOLD] = { 0x43 };
+    ASYNC_SOCKET_BUFFER zero_copy_payload_buffers[1];
+    zero_copy_payload_buffers[0].buffer = zero_copy_payload_bytes;
+    zero_copy_payload_buffers[0].length = sizeof(zero_copy_payload_bytes);
+    setup_send_that_would_block(async_socket, payload_buffers, 1);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, zero_copy_payload_buffers, 1, test_on_send_complete, NULL));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
+    // the error queue is empty
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, MSG_ERRQUEUE))
         .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    // the small send goes out alone and completes, nothing is waiting for a notification before it
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    // then the zero copy send goes out with its own sendmsg
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_sendmsg(test_socket, IGNORED_ARG, MSG_NOSIGNAL | MSG_ZEROCOPY));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    setup_lock_mocks();
 
     // act
-    errno = EWOULDBLOCK;
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
 
     // assert
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 3, g_sent_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes, g_sent_messages[1].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload_bytes), g_sent_messages[1].length);
+    ASSERT_ARE_EQUAL(void_ptr, zero_copy_payload_bytes, g_sent_messages[2].first_byte);
+    ASSERT_ARE_EQUAL(size_t, sizeof(zero_copy_payload_bytes), g_sent_messages[2].length);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
-    free(g_event_callback_ctx);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_059: [ If the errno value is ECONNRESET, ENOTCONN, or EPIPE shall fail and return ASYNC_SOCKET_SEND_SYNC_ABANDONED. ]
-TEST_FUNCTION(when_errno_for_send_returns_ECONNRESET_async_socket_send_async_returns_ABANDONED)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_085: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_ERROR, event_complete_callback shall remove all the contexts from the receive and send queues and for each of them do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_086: [ Otherwise event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ERROR flag. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_087: [ Then event_complete_callback shall and free the io_context memory. ]
+TEST_FUNCTION(event_complete_func_recv_ERROR_and_error_the_connection)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-
-    errno = ECONNRESET;
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ERROR);
 
     // assert
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_NOT_OPEN, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_060: [ If any other error is encountered, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]
-TEST_FUNCTION(when_errno_for_send_returns_error_async_socket_send_async_returns_ERROR)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_085: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_ERROR, event_complete_callback shall remove all the contexts from the receive and send queues and for each of them do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_086: [ Otherwise event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ERROR flag. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_087: [ Then event_complete_callback shall and free the io_context memory. ]
+TEST_FUNCTION(event_complete_func_send_ERROR_and_error_the_connection)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
+
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
     umock_c_reset_all_calls();
+    setup_send_that_would_block(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]));
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-
-    errno = EAFNOSUPPORT;
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ERROR));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ERROR);
 
     // assert
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_101: [ If the sum of buffer lengths for all the buffers in payload is greater than UINT32_MAX, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]*/
-TEST_FUNCTION(async_socket_send_async_with_sum_of_buffer_lengths_exceeding_UINT32_MAX_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_116: [ For a pooled receive, complete_queued_io shall take a buffer from the receive buffer pool of the socket, allocating a new one if the pool has no free buffer, and call the on_recvv callback with an iovec for the buffer. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_119: [ complete_queued_io shall call the on_receive_complete callback of a pooled receive with the buffer taken from the pool when the on_recvv size > 0, the caller then owning the buffer, and with NULL otherwise. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_pooled_receive_allocates_a_buffer_when_the_pool_has_no_free_buffer)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    ASYNC_SOCKET_SEND_SYNC_RESULT result;
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = UINT32_MAX;
-    payload_buffers[1].buffer = payload_bytes;
-    payload_buffers[1].length = 1;
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 0);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    setup_lock_mocks();
+    // the pool has no free buffer
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, sizeof(unsigned char)));
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
     // act
-    result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_ERROR, result);
+    ASSERT_IS_NOT_NULL(g_pooled_buffer);
+    ASSERT_ARE_EQUAL(void_ptr, g_pooled_buffer, g_received_messages[0].first_byte);
 
     // cleanup
+    async_socket_buffer_pool_return(buffer_pool, g_pooled_buffer);
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// async_socket_receive_async
-
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_064: [ If async_socket is NULL, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_NULL_async_socket_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_117: [ If no buffer can be allocated, complete_queued_io shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ERROR. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_pooled_receive_completes_with_ERROR_when_no_buffer_can_be_allocated)
 {
     // arrange
-    int result;
-    uint8_t payload_bytes[1];
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 0);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, sizeof(unsigned char)))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, NULL, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    result = async_socket_receive_async(NULL, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, g_received_message_count);
+
+    // cleanup
+    async_socket_close(async_socket);
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_065: [ If buffers is NULL, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_NULL_payload_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_089: [ If errno is EAGAIN or EWOULDBLOCK, then complete_queued_io shall put the context back at the head of the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_118: [ If the on_recvv size is not > 0, complete_queued_io shall give the buffer back to the pool. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_pooled_receive_that_would_block_gives_the_buffer_back_and_stays_queued)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    setup_lock_mocks();
+    // take the free buffer of the pool
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(-1);
+    // give it back
+    setup_lock_mocks();
+    setup_lock_mocks();
+
     // act
-    int result = async_socket_receive_async(async_socket, NULL, 1, test_on_receive_complete, test_callback_ctx);
+    errno = EAGAIN;
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_066: [ If buffer_count is 0, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_0_payload_count_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_091: [ If the on_recvv size equals 0, then complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_118: [ If the on_recvv size is not > 0, complete_queued_io shall give the buffer back to the pool. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_119: [ complete_queued_io shall call the on_receive_complete callback of a pooled receive with the buffer taken from the pool when the on_recvv size > 0, the caller then owning the buffer, and with NULL otherwise. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_pooled_receive_of_0_bytes_gives_the_buffer_back_and_completes_with_ABANDONED)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    uint8_t payload_bytes[1];
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(0);
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, NULL, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, 0, test_on_receive_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_067: [ If any of the buffers in payload has buffer set to NULL, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_first_out_of_2_buffers_having_buffer_NULL_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_120: [ event_complete_callback shall call the complete callback of a pooled receive with a NULL buffer. ]
+TEST_FUNCTION(event_complete_func_pooled_recv_ABANDONED_completes_the_receive_with_a_NULL_buffer)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes_1[1];
-    uint8_t payload_bytes_2[1];
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
-    payload_buffers[0].buffer = NULL;
-    payload_buffers[0].length = sizeof(payload_bytes_1);
-    payload_buffers[1].buffer = payload_bytes_2;
-    payload_buffers[1].length = sizeof(payload_bytes_2);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, NULL, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_067: [ If any of the buffers in payload has buffer set to NULL, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_second_out_of_2_buffers_having_buffer_NULL_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_086: [ Otherwise event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ERROR flag. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_120: [ event_complete_callback shall call the complete callback of a pooled receive with a NULL buffer. ]
+TEST_FUNCTION(event_complete_func_pooled_recv_ERROR_completes_the_receive_with_a_NULL_buffer)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes_1[1];
-    uint8_t payload_bytes_2[1];
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
-    payload_buffers[0].buffer = payload_bytes_1;
-    payload_buffers[0].length = sizeof(payload_bytes_1);
-    payload_buffers[1].buffer = NULL;
-    payload_buffers[1].length = sizeof(payload_bytes_2);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_pooled_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, NULL, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ERROR);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_068: [ If any of the buffers in payload has length set to 0, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_first_out_of_2_buffers_having_length_0_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_133: [ After calling on_receive_complete with ASYNC_SOCKET_RECEIVE_OK for the continuous receive of the socket, complete_queued_io shall put the context back at the head of the receive queue instead of freeing it, so that it receives the next data in the same buffers. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_092: [ If the on_recvv size > 0, complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context, ASYNC_SOCKET_RECEIVE_OK and the on_recvv size. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_continuous_receive_receives_the_next_data_in_the_same_buffers)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
 
-    uint8_t payload_bytes_1[1];
-    uint8_t payload_bytes_2[1];
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
-    payload_buffers[0].buffer = payload_bytes_1;
-    payload_buffers[0].length = 0;
-    payload_buffers[1].buffer = payload_bytes_2;
-    payload_buffers[1].length = sizeof(payload_bytes_2);
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
+    setup_lock_mocks();
+    // the same receive gets the next data
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
+    setup_lock_mocks();
+
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 2, g_received_message_count);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes, g_received_messages[0].first_byte);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes, g_received_messages[1].first_byte);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_068: [ If any of the buffers in payload has length set to 0, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_second_out_of_2_buffers_having_length_0_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_135: [ When the continuous receive of the socket completes with any other result, complete_queued_io shall remove it from the socket before calling on_receive_complete, so that a new continuous receive can be started from the callback, and then free the context. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_11_091: [ If the on_recvv size equals 0, then complete_queued_io shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_continuous_receive_of_0_bytes_ends_the_continuous_receive)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
 
-    uint8_t payload_bytes_1[1];
-    uint8_t payload_bytes_2[1];
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
-    payload_buffers[0].buffer = payload_bytes_1;
-    payload_buffers[0].length = sizeof(payload_bytes_1);
-    payload_buffers[1].buffer = payload_bytes_2;
-    payload_buffers[1].length = 0;
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(0);
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    // the socket has no continuous receive anymore
+    ASSERT_ARE_NOT_EQUAL(int, 0, async_socket_cancel_continuous_receive(async_socket));
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_069: [ If the sum of buffer lengths for all the buffers in payload is greater than UINT32_MAX, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_sum_of_buffer_lengths_exceeding_UINT32_MAX_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_131: [ If the continuous receive is being completed, it shall be completed with ASYNC_SOCKET_RECEIVE_ABANDONED by the thread completing it. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_134: [ If the continuous receive was cancelled, complete_queued_io shall instead call on_receive_complete with ASYNC_SOCKET_RECEIVE_ABANDONED once the lock is released and free the context. ]
+TEST_FUNCTION(event_complete_func_EPOLLIN_continuous_receive_cancelled_from_its_callback_completes_with_ABANDONED)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
 
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = UINT32_MAX;
-    payload_buffers[1].buffer = payload_bytes;
-    payload_buffers[1].length = 1;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    g_cancel_continuous_receive_async_socket = async_socket;
     umock_c_reset_all_calls();
 
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(mocked_recvmsg(test_socket, IGNORED_ARG, 0))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
+    // the receive is cancelled from the callback while it is being completed
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    // and completes with ABANDONED once the callback returns
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
+    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_070: [ If on_receive_complete is NULL, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_with_on_recv_complete_NULL_fails)
+// on_io_uring_send_complete
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_035: [ Otherwise on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_OK. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_038: [ When a send or a receive completes, its context shall be removed from the head of its queue and, if the socket is OPEN, the next context of the queue shall be submitted by calling completion_port_submit_io. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_039: [ The complete callback of the operation shall then be called and its context shall be freed. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+TEST_FUNCTION(on_io_uring_send_complete_completes_the_send_with_OK)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), NULL, test_callback_ctx);
+    complete_submitted_io(0, sizeof(payload_bytes));
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_072: [ If async_socket is not OPEN, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_when_not_open_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_038: [ When a send or a receive completes, its context shall be removed from the head of its queue and, if the socket is OPEN, the next context of the queue shall be submitted by calling completion_port_submit_io. ]
+TEST_FUNCTION(on_io_uring_send_complete_submits_the_next_send)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
     uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
-
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    complete_submitted_io(0, sizeof(payload_bytes));
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 2, g_submitted_io_count);
 
     // cleanup
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_072: [ If async_socket is not OPEN, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_receive_async_after_close_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_040: [ The contexts that cannot be submitted shall be completed with an ERROR result. ]
+TEST_FUNCTION(when_submitting_the_next_send_fails_on_io_uring_send_complete_completes_it_with_ERROR)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-    (void)async_socket_close(async_socket);
-
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
     uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_submit_io(test_completion_port, test_socket, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ERROR));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    complete_submitted_io(0, sizeof(payload_bytes));
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_073: [ Otherwise async_socket_receive_async shall create a context for the recv where the payload, on_receive_complete and on_receive_complete_context shall be stored. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_074: [ The context shall also allocate enough memory to keep an array of buffer_count items. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_102: [ Then the context shall then be added to the completion port system by calling completion_port_add with EPOLLIN and event_complete_callback as the callback. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_077: [ On success, async_socket_receive_async shall return 0. ]
-TEST_FUNCTION(async_socket_receive_async_succeeds)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_034: [ If result is less than the number of bytes left to send, on_io_uring_send_complete shall skip the bytes that were sent and submit the rest of the send again by calling completion_port_submit_io. ]
+TEST_FUNCTION(on_io_uring_send_complete_submits_the_rest_of_a_partial_send)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes_1[] = { 0x42 };
+    uint8_t payload_bytes_2[] = { 0x43, 0x44 };
+    ASYNC_SOCKET_BUFFER payload_buffers[2];
+    payload_buffers[0].buffer = payload_bytes_1;
+    payload_buffers[0].length = sizeof(payload_bytes_1);
+    payload_buffers[1].buffer = payload_bytes_2;
+    payload_buffers[1].length = sizeof(payload_bytes_2);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 2, test_on_send_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    setup_async_socket_receive_async_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
 
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, test_callback_ctx);
+    complete_submitted_io(0, sizeof(payload_bytes_1) + 1);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 2, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(void_ptr, g_submitted_io[0], g_submitted_io[1]);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io[1]->message->msg_iovlen);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes_2 + 1, g_submitted_io[1]->message->msg_iov[0].iov_base);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io[1]->message->msg_iov[0].iov_len);
 
     // cleanup
     async_socket_destroy(async_socket);
-    free(g_event_callback_ctx);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_071: [ on_receive_complete_context shall be allowed to be NULL. ]
-TEST_FUNCTION(async_socket_receive_async_with_NULL_on_recv_complete_context_succeeds)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_036: [ If the socket is not OPEN, on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_ABANDONED. ]
+TEST_FUNCTION(on_io_uring_send_complete_abandons_a_partial_send_when_the_socket_is_not_OPEN)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    setup_async_socket_receive_async_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(TEST_ASYNC_SOCKET_LINUX_STATE_CLOSING);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, NULL);
+    complete_submitted_io(0, 1);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
 
     // cleanup
     async_socket_destroy(async_socket);
-    free(g_event_callback_ctx);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_078: [ If any error occurs, async_socket_receive_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(when_underlying_calls_fail_async_socket_receive_async_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_037: [ If completion_port_submit_io fails, on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_ERROR. ]
+TEST_FUNCTION(when_submitting_the_rest_of_a_partial_send_fails_on_io_uring_send_complete_completes_it_with_ERROR)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    setup_async_socket_receive_async_mocks();
-
-    umock_c_negative_tests_snapshot();
-    errno = 0;
-
-    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
-    {
-        if (umock_c_negative_tests_can_call_fail(index))
-        {
-            umock_c_negative_tests_reset();
-            umock_c_negative_tests_fail_call(index);
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_submit_io(test_completion_port, test_socket, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ERROR));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
-            // act
-            int result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, NULL);
+    // act
+    complete_submitted_io(0, 1);
 
-            // assert
-            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", index);
-        }
-    }
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
     async_socket_destroy(async_socket);
 }
 
-// event_complete_callback
-
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_079: [ If context is NULL, event_complete_callback shall do nothing. ]
-TEST_FUNCTION(event_complete_func_context_NULL_fail)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_032: [ If result is -ECANCELED or -ECONNRESET, on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_ABANDONED. ]
+TEST_FUNCTION(on_io_uring_send_complete_with_ECONNRESET_completes_the_send_with_ABANDONED)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
     // act
-    g_event_callback(NULL, COMPLETION_PORT_EPOLL_EPOLLIN);
+    complete_submitted_io(0, -ECONNRESET);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
-    free(g_event_callback_ctx);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_082: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLIN, event_complete_callback shall do the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_083: [ Otherwise event_complete_callback shall call the on_recv callback with the recv_buffer buffer and length and do the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_007: [ on_socket_recv shall attempt to receive data by calling the system recv socket API. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_088: [ If the socket_transport_receive size < 0, then: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_092: [ If the socket_transport_receive size > 0, if we have another buffer to fill then we will attempt another read, otherwise we shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_OK. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_093: [ event_complete_callback shall then free the io_context memory. ]
-TEST_FUNCTION(event_complete_func_EPOLLIN_action)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_033: [ If result is any other negative value, on_io_uring_send_complete shall complete the send with ASYNC_SOCKET_SEND_ERROR. ]
+TEST_FUNCTION(on_io_uring_send_complete_with_any_other_error_completes_the_send_with_ERROR)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    uint32_t payload_size = sizeof(payload_bytes) / sizeof(payload_bytes[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, 1, test_on_send_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_recv(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .SetReturn(payload_size);
-    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, payload_size));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ERROR));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    complete_submitted_io(0, -EIO);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_089: [ If errno is EAGAIN or EWOULDBLOCK, then no data is available and event_complete_callback will break out of the function. ]
-TEST_FUNCTION(event_complete_func_recv_returns_EWOULDBLOCK)
+// on_io_uring_receive_complete
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_042: [ If result is greater than 0, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_OK and result as the number of bytes received. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_038: [ When a send or a receive completes, its context shall be removed from the head of its queue and, if the socket is OPEN, the next context of the queue shall be submitted by calling completion_port_submit_io. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_039: [ The complete callback of the operation shall then be called and its context shall be freed. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+TEST_FUNCTION(on_io_uring_receive_complete_completes_the_receive_with_OK)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
     uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_recv(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    errno = EWOULDBLOCK;
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    complete_submitted_io(0, 1);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_090: [ If errno is ECONNRESET, then event_complete_callback shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
-TEST_FUNCTION(event_complete_func_recv_returns_ECONNRESET)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_043: [ If result is 0, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(on_io_uring_receive_complete_with_0_bytes_completes_the_receive_with_ABANDONED)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_recv(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    errno = ECONNRESET;
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    complete_submitted_io(0, 0);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_095: [ If errno is any other error, then event_complete_callback shall call the on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ERROR. ]
-TEST_FUNCTION(event_complete_callback_recv_returns_any_random_error_no)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_044: [ If result is -ECANCELED or -ECONNRESET, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(on_io_uring_receive_complete_with_ECONNRESET_completes_the_receive_with_ABANDONED)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_recv(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    errno = EMSGSIZE;
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    complete_submitted_io(0, -ECONNRESET);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_091: [ If the socket_transport_receive size equals 0, then event_complete_callback shall call on_receive_complete callback with the on_receive_complete_context and ASYNC_SOCKET_RECEIVE_ABANDONED. ]
-TEST_FUNCTION(event_complete_func_recv_returns_0_bytes_success)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_045: [ If result is any other negative value, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_ERROR. ]
+TEST_FUNCTION(on_io_uring_receive_complete_with_any_other_error_completes_the_receive_with_ERROR)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_recv(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .SetReturn(0);
-    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN);
+    complete_submitted_io(0, -EIO);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_008: [ event_complete_callback shall call the notify complete callback with an ABANDONED flag when the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_009: [ If the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY then event_complete_callback shall call the notify complete callback with an IN flag. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_010: [ If the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY then event_complete_callback shall call the notify complete callback with an OUT flag. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_011: [ If the IO type is ASYNC_SOCKET_IO_TYPE_NOTIFY then event_complete_callback shall call the notify complete callback with an ERROR flag. ]
-PARAMETERIZED_TEST_FUNCTION(event_complete_func_notify_calls_callback_with_expected_result,
-    ARGS(ASYNC_SOCKET_NOTIFY_IO_TYPE, io_type, COMPLETION_PORT_EPOLL_ACTION, epoll_action, ASYNC_SOCKET_NOTIFY_IO_RESULT, expected_result),
-    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, COMPLETION_PORT_EPOLL_EPOLLRDHUP, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED), IN_EPOLLRDHUP_abandons),
-    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, COMPLETION_PORT_EPOLL_ABANDONED, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED), IN_ABANDONED_abandons),
-    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, COMPLETION_PORT_EPOLL_EPOLLRDHUP, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED), OUT_EPOLLRDHUP_abandons),
-    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, COMPLETION_PORT_EPOLL_ABANDONED, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED), OUT_ABANDONED_abandons),
-    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, COMPLETION_PORT_EPOLL_EPOLLIN, ASYNC_SOCKET_NOTIFY_IO_RESULT_IN), IN_EPOLLIN),
-    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, COMPLETION_PORT_EPOLL_EPOLLOUT, ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT), OUT_EPOLLOUT),
-    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, COMPLETION_PORT_EPOLL_ERROR, ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR), IN_ERROR),
-    CASE((ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, COMPLETION_PORT_EPOLL_ERROR, ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR), OUT_ERROR))
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_136: [ If the continuous receive of the socket completes with ASYNC_SOCKET_RECEIVE_OK, on_io_uring_receive_complete shall keep it at the head of the receive queue, call on_receive_complete and then submit it again by calling completion_port_submit_io, so that it receives the next data in the same buffers. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+TEST_FUNCTION(on_io_uring_receive_complete_with_OK_submits_the_continuous_receive_again)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, io_type, test_on_notify_complete, test_callback_ctx));
-
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, expected_result));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, epoll_action);
+    complete_submitted_io(0, 1);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 2, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(void_ptr, g_submitted_io[0], g_submitted_io[1]);
+    ASSERT_ARE_EQUAL(void_ptr, payload_bytes, g_submitted_io[1]->message->msg_iov[0].iov_base);
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_080: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLRDHUP or COMPLETION_PORT_EPOLL_ABANDONED, event_complete_callback shall do the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_084: [ Then event_complete_callback shall free the context memory. ]
-TEST_FUNCTION(event_complete_func_recv_EPOLLRDHUP_and_abandons_the_connection)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_137: [ If the continuous receive was cancelled or the socket is not OPEN, on_io_uring_receive_complete shall instead complete it with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(on_io_uring_receive_complete_with_OK_for_a_cancelled_continuous_receive_completes_it_with_ABANDONED)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
     uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    // the receive is not cancelled in the io_uring and completes with the next data
+    g_cancel_io_result = MU_FAILURE;
+    ASSERT_ARE_EQUAL(int, 0, async_socket_cancel_continuous_receive(async_socket));
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 2));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP);
+    complete_submitted_io(0, 2);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_084: [ Then event_complete_callback shall free the context memory. ]
-TEST_FUNCTION(event_complete_func_send_EPOLLRDHUP_and_abandons_the_connection)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_138: [ If completion_port_submit_io fails, on_io_uring_receive_complete shall complete the continuous receive with ASYNC_SOCKET_RECEIVE_ERROR. ]
+TEST_FUNCTION(when_completion_port_submit_io_fails_on_io_uring_receive_complete_completes_the_continuous_receive_with_ERROR)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
     uint8_t payload_bytes[] = { 0x42, 0x43 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, 1));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_submit_io(test_completion_port, test_socket, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    errno = EWOULDBLOCK;
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP);
+    complete_submitted_io(0, 1);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_080: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLRDHUP or COMPLETION_PORT_EPOLL_ABANDONED, event_complete_callback shall do the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_084: [ Then event_complete_callback shall free the context memory. ]
-TEST_FUNCTION(event_complete_func_recv_ABANDONED_and_abandons_the_connection)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_139: [ When the continuous receive of the socket completes, on_io_uring_receive_complete shall remove it from the socket before calling on_receive_complete, so that a new continuous receive can be started from the callback. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_043: [ If result is 0, on_io_uring_receive_complete shall complete the receive with ASYNC_SOCKET_RECEIVE_ABANDONED. ]
+TEST_FUNCTION(on_io_uring_receive_complete_with_0_bytes_ends_the_continuous_receive)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    uint8_t payload_bytes[] = { 0x42 };
     ASYNC_SOCKET_BUFFER payload_buffers[1];
     payload_buffers[0].buffer = payload_bytes;
     payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
+    complete_submitted_io(0, 0);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    // a new continuous receive can be started
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_080: [ If COMPLETION_PORT_EPOLL_ACTION is COMPLETION_PORT_EPOLL_EPOLLRDHUP or COMPLETION_PORT_EPOLL_ABANDONED, event_complete_callback shall do the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_081: [ event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ABANDONED flag when the IO type is either ASYNC_SOCKET_IO_TYPE_SEND or ASYNC_SOCKET_IO_TYPE_RECEIVE respectively. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_084: [ Then event_complete_callback shall free the context memory. ]
-TEST_FUNCTION(event_complete_func_send_ABANDONED_and_abandons_the_connection)
+// on_io_uring_ring_receive_complete
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_154: [ If the kernel received data in a buffer of the ring, on_io_uring_ring_receive_complete shall add the buffer at the tail of the received buffers of the socket. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_159: [ If the socket is OPEN, on_io_uring_ring_receive_complete shall mark the socket as readable and complete the operations in the receive queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_160: [ For a pooled receive of a socket that receives with a buffer ring, complete_queued_io shall take the first buffer the kernel received in, without copying its data, and lend a buffer taken from the receive buffer pool to the kernel in its place. ]
+TEST_FUNCTION(on_io_uring_ring_receive_complete_with_data_completes_the_queued_pooled_receive_with_the_received_buffer)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
+    uint8_t received_bytes[] = { 0x42, 0x43 };
+    void* received_buffer = g_ring_buffers[0];
+    (void)memcpy(received_buffer, received_bytes, sizeof(received_bytes));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    errno = EWOULDBLOCK;
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    // take the receive from the receive queue
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    // take the free buffer of the pool to lend to the kernel in place of the received one
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(completion_port_buffer_ring_add(test_buffer_ring, IGNORED_ARG, TEST_RECEIVE_BUFFER_SIZE, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_OK, received_buffer, sizeof(received_bytes)));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED);
+    complete_ring_receive(sizeof(received_bytes), true, 0, true);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, received_buffer, g_pooled_buffer);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received_bytes, g_pooled_buffer, sizeof(received_bytes)));
+    ASSERT_ARE_NOT_EQUAL(void_ptr, received_buffer, g_ring_buffers[0]);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
 
     // cleanup
-    async_socket_close(async_socket);
+    async_socket_buffer_pool_return(buffer_pool, g_pooled_buffer);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_094: [ If the events value contains COMPLETION_PORT_EPOLL_EPOLLOUT, event_complete_callback shall the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_096: [ event_complete_callback shall call socket_transport_send on the data in the ASYNC_SOCKET_SEND_CONTEXT buffer. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_100: [ Then event_complete_callback shall free the io_context memory ]
-TEST_FUNCTION(event_complete_func_send_EPOLLOUT_success)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_159: [ If the socket is OPEN, on_io_uring_ring_receive_complete shall mark the socket as readable and complete the operations in the receive queue. ]
+TEST_FUNCTION(on_io_uring_ring_receive_complete_with_data_completes_the_queued_notify_with_IN)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    errno = EWOULDBLOCK;
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL));
-    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    // take the notify from the receive queue
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_IN));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
+    complete_ring_receive(1, true, 0, true);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_097: [ If socket_transport_send returns value is < 0 event_complete_callback shall do the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_098: [ if errno is ECONNRESET, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ABANDONED. ]
-TEST_FUNCTION(event_complete_func_send_EPOLLOUT_abandoned)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_155: [ If the receive of the buffer ring ended, on_io_uring_ring_receive_complete shall do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_158: [ on_io_uring_ring_receive_complete shall submit the receive of the buffer ring again if the stream did not end and the kernel has buffers to receive in, otherwise it is submitted again once the receives lend buffers back to the kernel. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+TEST_FUNCTION(on_io_uring_ring_receive_complete_with_ENOBUFS_does_not_submit_the_receive_again_while_the_kernel_has_no_buffer)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    for (uint16_t buffer_id = 0; buffer_id < TEST_RING_BUFFER_COUNT; buffer_id++)
+    {
+        uint8_t received_byte = (uint8_t)buffer_id;
+        receive_in_ring_buffer(buffer_id, &received_byte, 1);
+    }
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    errno = EWOULDBLOCK;
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ABANDONED));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    // the receive queue is empty
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    errno = ECONNRESET;
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
+    complete_ring_receive(-ENOBUFS, false, 0, false);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_099: [ if errno is anything else, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ERROR. ]
-TEST_FUNCTION(event_complete_func_send_EPOLLOUT_error)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_155: [ If the receive of the buffer ring ended, on_io_uring_ring_receive_complete shall do the following: ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_158: [ on_io_uring_ring_receive_complete shall submit the receive of the buffer ring again if the stream did not end and the kernel has buffers to receive in, otherwise it is submitted again once the receives lend buffers back to the kernel. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+TEST_FUNCTION(on_io_uring_ring_receive_complete_with_ENOBUFS_submits_the_receive_again_when_the_kernel_has_buffers)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
-    umock_c_reset_all_calls();
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    errno = EWOULDBLOCK;
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
 
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ERROR));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    // act
+    complete_ring_receive(-ENOBUFS, false, 0, false);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 2, g_submitted_io_count);
+    ASSERT_IS_TRUE(g_submitted_io[1]->is_multishot);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_156: [ If the receive was multishot and io_result is -EINVAL, on_io_uring_ring_receive_complete shall submit a receive that completes once from then on, since the kernel does not support multishot receives. ]
+TEST_FUNCTION(on_io_uring_ring_receive_complete_with_EINVAL_for_the_multishot_receive_submits_a_receive_that_completes_once)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
 
     // act
-    errno = ENOBUFS;
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
+    complete_ring_receive(-EINVAL, false, 0, false);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 2, g_submitted_io_count);
+    ASSERT_IS_FALSE(g_submitted_io[1]->is_multishot);
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_101: [ If socket_transport_send returns a value > 0 but less than the amount to be sent, event_complete_callback shall continue to socket_transport_send the data until the payload length has been sent. ]
-TEST_FUNCTION(event_complete_func_EPOLLOUT_multiple_sends_success)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_157: [ If io_result is 0 or a negative errno other than -ENOBUFS, on_io_uring_ring_receive_complete shall end the stream of the socket with io_result and keep the socket marked as readable, so that the receives get the received data and then the end of the stream. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+TEST_FUNCTION(on_io_uring_ring_receive_complete_with_0_completes_the_queued_pooled_receive_with_ABANDONED)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43, 0x44, 0x45 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_size = sizeof(payload_bytes) / sizeof(payload_bytes[0]);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    // the stream ended, the receive is not submitted again
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, payload_size, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    errno = EWOULDBLOCK;
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, payload_size, MSG_NOSIGNAL))
-        .SetReturn(2);
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, payload_size-2, MSG_NOSIGNAL));
-    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_OK));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    // take the receive from the receive queue
+    setup_lock_mocks();
+    // no data was received before the end of the stream
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, NULL, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT);
+    complete_ring_receive(0, false, 0, false);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_085: [ If the events value contains COMPLETION_PORT_EPOLL_ERROR, event_complete_callback shall the following: ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_086: [ Otherwise event_complete_callback shall call either the socket_transport_send or socket_transport_receive complete callback with an ERROR flag. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_087: [ Then event_complete_callback shall and free the io_context memory. ]
-TEST_FUNCTION(event_complete_func_recv_ERROR_and_error_the_connection)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_157: [ If io_result is 0 or a negative errno other than -ENOBUFS, on_io_uring_ring_receive_complete shall end the stream of the socket with io_result and keep the socket marked as readable, so that the receives get the received data and then the end of the stream. ]
+TEST_FUNCTION(on_io_uring_ring_receive_complete_with_an_error_completes_the_queued_pooled_receive_with_ERROR)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
-    uint32_t payload_count = sizeof(payload_buffers) / sizeof(payload_buffers[0]);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_async(async_socket, payload_buffers, payload_count, test_on_receive_complete, test_callback_ctx));
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(test_on_receive_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ERROR, NULL, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ERROR);
+    complete_ring_receive(-EIO, false, 0, false);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    async_socket_close(async_socket);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_11_099: [ if errno is anything else, then on_send_complete shall be called with ASYNC_SOCKET_SEND_ERROR. ]
-TEST_FUNCTION(event_complete_func_send_ERROR_and_error_the_connection)
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_157: [ If io_result is 0 or a negative errno other than -ENOBUFS, on_io_uring_ring_receive_complete shall end the stream of the socket with io_result and keep the socket marked as readable, so that the receives get the received data and then the end of the stream. ]
+TEST_FUNCTION(on_io_uring_ring_receive_complete_with_0_after_data_completes_the_pooled_receives_with_the_data_and_then_ABANDONED)
 {
     // arrange
-    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
-    ASSERT_IS_NOT_NULL(async_socket);
-    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
-
-    uint8_t payload_bytes[] = { 0x42, 0x43 };
-    ASYNC_SOCKET_BUFFER payload_buffers[1];
-    payload_buffers[0].buffer = payload_bytes;
-    payload_buffers[0].length = sizeof(payload_bytes);
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+    uint8_t received_bytes[] = { 0x42 };
+    receive_in_ring_buffer(0, received_bytes, sizeof(received_bytes));
+    void* received_buffer = g_ring_buffers[0];
+    complete_ring_receive(0, false, 0, false);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(void_ptr, received_buffer, g_pooled_buffer);
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_send(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, MSG_NOSIGNAL))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG));
-    errno = EWOULDBLOCK;
-    ASSERT_ARE_EQUAL(ASYNC_SOCKET_SEND_SYNC_RESULT, ASYNC_SOCKET_SEND_SYNC_OK, async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(test_on_send_complete(test_callback_ctx, ASYNC_SOCKET_SEND_ERROR));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    // queue the receive
+    setup_lock_mocks();
+    // take it from the receive queue, the socket is still marked as readable
+    setup_lock_mocks();
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_receive_pooled_complete(test_callback_ctx, ASYNC_SOCKET_RECEIVE_ABANDONED, NULL, 0));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
-    g_event_callback(g_event_callback_ctx, COMPLETION_PORT_EPOLL_ERROR);
+    int result = async_socket_receive_pooled_async(async_socket, test_on_receive_pooled_complete, test_callback_ctx);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
 
     // cleanup
-    async_socket_close(async_socket);
+    async_socket_buffer_pool_return(buffer_pool, received_buffer);
     async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
 }
 
 // async_socket_notify_io_async
@@ -2337,7 +7767,7 @@ TEST_FUNCTION(async_socket_notify_io_async_with_NULL_on_notify_io_complete_conte
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    setup_async_socket_notify_io_async_mocks(ASYNC_SOCKET_NOTIFY_IO_TYPE_IN);
+    setup_async_socket_notify_io_async_IN_mocks();
 
     // act
     int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, NULL);
@@ -2348,7 +7778,6 @@ TEST_FUNCTION(async_socket_notify_io_async_with_NULL_on_notify_io_complete_conte
 
     // cleanup
     async_socket_destroy(async_socket);
-    free(g_event_callback_ctx);
 }
 
 // Tests_SRS_ASYNC_SOCKET_LINUX_04_015: [ If the async socket's current state is not ASYNC_SOCKET_LINUX_STATE_OPEN then async_socket_notify_io_async shall fail and return a non-zero value. ]
@@ -2376,7 +7805,7 @@ TEST_FUNCTION(async_socket_notify_io_async_fails_when_state_is_not_OPEN)
 }
 
 // Tests_SRS_ASYNC_SOCKET_LINUX_04_020: [ If any error occurs, async_socket_notify_io_async shall fail and return a non-zero value. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_017: [ Otherwise async_socket_notify_io_async shall create a context for the notify where the on_notify_io_complete and on_notify_io_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_017: [ Otherwise async_socket_notify_io_async shall create a context for the notify without any buffer where the on_notify_io_complete and on_notify_io_complete_context shall be stored. ]
 TEST_FUNCTION(async_socket_notify_io_async_fails_when_alloc_context_fails)
 {
     // arrange
@@ -2387,7 +7816,7 @@ TEST_FUNCTION(async_socket_notify_io_async_fails_when_alloc_context_fails)
 
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)))
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
@@ -2403,9 +7832,44 @@ TEST_FUNCTION(async_socket_notify_io_async_fails_when_alloc_context_fails)
     async_socket_destroy(async_socket);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_018: [ Then the context shall then be added to the completion port system by calling completion_port_add with EPOLLIN if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and EPOLLOUT otherwise and event_complete_callback as the callback. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_146: [ If io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and the socket has a continuous receive, async_socket_notify_io_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(async_socket_notify_io_async_for_IN_when_a_continuous_receive_is_started_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(async_socket);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_018: [ Then the context shall be added at the tail of the receive queue if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and at the tail of the send queue otherwise. ]
 // Tests_SRS_ASYNC_SOCKET_LINUX_04_019: [ On success, async_socket_notify_io_async shall return 0. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_017: [ Otherwise async_socket_notify_io_async shall create a context for the notify where the on_notify_io_complete and on_notify_io_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_017: [ Otherwise async_socket_notify_io_async shall create a context for the notify without any buffer where the on_notify_io_complete and on_notify_io_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_010: [ async_socket_notify_io_async shall then complete the operations in that queue if the socket is ready. ]
 TEST_FUNCTION(async_socket_notify_io_async_succeeds_for_IN)
 {
     // arrange
@@ -2414,7 +7878,7 @@ TEST_FUNCTION(async_socket_notify_io_async_succeeds_for_IN)
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    setup_async_socket_notify_io_async_mocks(ASYNC_SOCKET_NOTIFY_IO_TYPE_IN);
+    setup_async_socket_notify_io_async_IN_mocks();
 
     // act
     int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx);
@@ -2425,12 +7889,13 @@ TEST_FUNCTION(async_socket_notify_io_async_succeeds_for_IN)
 
     // cleanup
     async_socket_destroy(async_socket);
-    free(g_event_callback_ctx);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_018: [ Then the context shall then be added to the completion port system by calling completion_port_add with EPOLLIN if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and EPOLLOUT otherwise and event_complete_callback as the callback. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_018: [ Then the context shall be added at the tail of the receive queue if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and at the tail of the send queue otherwise. ]
 // Tests_SRS_ASYNC_SOCKET_LINUX_04_019: [ On success, async_socket_notify_io_async shall return 0. ]
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_017: [ Otherwise async_socket_notify_io_async shall create a context for the notify where the on_notify_io_complete and on_notify_io_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_017: [ Otherwise async_socket_notify_io_async shall create a context for the notify without any buffer where the on_notify_io_complete and on_notify_io_complete_context shall be stored. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_010: [ async_socket_notify_io_async shall then complete the operations in that queue if the socket is ready. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_013: [ For ASYNC_SOCKET_IO_TYPE_NOTIFY, complete_queued_io shall call the notify complete callback with an IN flag for the receive queue and with an OUT flag for the send queue. ]
 TEST_FUNCTION(async_socket_notify_io_async_succeeds_for_OUT)
 {
     // arrange
@@ -2439,7 +7904,17 @@ TEST_FUNCTION(async_socket_notify_io_async_succeeds_for_OUT)
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    setup_async_socket_notify_io_async_mocks(ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    setup_lock_mocks();
+    // the socket is writable, the notify completes right away
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
     int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, test_on_notify_complete, test_callback_ctx);
@@ -2450,30 +7925,129 @@ TEST_FUNCTION(async_socket_notify_io_async_succeeds_for_OUT)
 
     // cleanup
     async_socket_destroy(async_socket);
-    free(g_event_callback_ctx);
 }
 
-// Tests_SRS_ASYNC_SOCKET_LINUX_04_020: [ If any error occurs, async_socket_notify_io_async shall fail and return a non-zero value. ]
-TEST_FUNCTION(async_socket_notify_io_async_fails_when_completion_port_add_fails)
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_018: [ Then the context shall be added at the tail of the receive queue if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and at the tail of the send queue otherwise. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_019: [ On success, async_socket_notify_io_async shall return 0. ]
+TEST_FUNCTION(async_socket_notify_io_async_for_OUT_when_a_continuous_receive_is_started_succeeds)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine);
     ASSERT_IS_NOT_NULL(async_socket);
     ASSERT_ARE_EQUAL(int, 0, async_socket_open_async(async_socket, test_socket, test_on_open_complete, test_callback_ctx));
+
+    uint8_t payload_bytes[] = { 0x42 };
+    ASYNC_SOCKET_BUFFER payload_buffers[1];
+    payload_buffers[0].buffer = payload_bytes;
+    payload_buffers[0].length = sizeof(payload_bytes);
+    ASSERT_ARE_EQUAL(int, 0, async_socket_receive_continuous_async(async_socket, payload_buffers, 1, test_on_receive_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_add(test_completion_port, EPOLLOUT, test_socket, IGNORED_ARG, IGNORED_ARG))
-        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    setup_lock_mocks();
+    // the socket is writable, the notify completes right away
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, test_on_notify_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_030: [ Otherwise, if the socket submits its operations to the io_uring of the completion port, async_socket_notify_io_async shall submit a poll for POLLIN if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and for POLLOUT otherwise by calling completion_port_submit_io and add the context to the notification queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_019: [ On success, async_socket_notify_io_async shall return 0. ]
+TEST_FUNCTION(async_socket_notify_io_async_with_io_uring_submits_a_poll_for_IN)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(int, COMPLETION_PORT_IO_TYPE_POLL, g_submitted_io[0]->io_type);
+    ASSERT_ARE_EQUAL(uint32_t, POLLIN, g_submitted_io[0]->poll_events);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_030: [ Otherwise, if the socket submits its operations to the io_uring of the completion port, async_socket_notify_io_async shall submit a poll for POLLIN if io_type is ASYNC_SOCKET_NOTIFY_IO_TYPE_IN and for POLLOUT otherwise by calling completion_port_submit_io and add the context to the notification queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_019: [ On success, async_socket_notify_io_async shall return 0. ]
+TEST_FUNCTION(async_socket_notify_io_async_with_io_uring_submits_a_poll_for_OUT)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    setup_submit_io_mocks();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     // act
     int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, test_on_notify_complete, test_callback_ctx);
 
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+    ASSERT_ARE_EQUAL(int, COMPLETION_PORT_IO_TYPE_POLL, g_submitted_io[0]->io_type);
+    ASSERT_ARE_EQUAL(uint32_t, POLLOUT, g_submitted_io[0]->poll_events);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_04_020: [ If any error occurs, async_socket_notify_io_async shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_completion_port_submit_io_fails_async_socket_notify_io_async_with_io_uring_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, sizeof(struct iovec)));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_submit_io(test_completion_port, test_socket, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx);
+
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_NOT_EQUAL(int, 0, result);
@@ -2482,4 +8056,129 @@ TEST_FUNCTION(async_socket_notify_io_async_fails_when_completion_port_add_fails)
     async_socket_destroy(async_socket);
 }
 
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_167: [ If the socket receives with a buffer ring, async_socket_notify_io_async shall add a notification for ASYNC_SOCKET_NOTIFY_IO_TYPE_IN to the receive queue and complete the receive queue the same way as when the socket does not use io_uring, since the kernel takes the data out of the socket as it arrives. ]
+TEST_FUNCTION(async_socket_notify_io_async_IN_with_a_buffer_ring_queues_the_notify_instead_of_submitting_it)
+{
+    // arrange
+    ASYNC_SOCKET_BUFFER_POOL_HANDLE buffer_pool = async_socket_buffer_pool_create(TEST_RECEIVE_BUFFER_SIZE, TEST_RING_BUFFER_COUNT + 1);
+    ASSERT_IS_NOT_NULL(buffer_pool);
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_buffer_ring_async_socket(buffer_pool);
+
+    setup_async_socket_notify_io_async_IN_mocks();
+
+    // act
+    int result = async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_submitted_io_count);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+    async_socket_buffer_pool_destroy(buffer_pool);
+}
+
+// on_io_uring_notify_complete
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_046: [ If result is not negative, on_io_uring_notify_complete shall call the notify complete callback with ASYNC_SOCKET_NOTIFY_IO_RESULT_IN if POLLIN was requested and with ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT otherwise. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_049: [ on_io_uring_notify_complete shall remove the context from the notification queue. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_039: [ The complete callback of the operation shall then be called and its context shall be freed. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_041: [ The count of submitted operations shall then be decremented. ]
+TEST_FUNCTION(on_io_uring_notify_complete_for_POLLIN_completes_the_notify_with_IN)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_IN));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    complete_submitted_io(0, POLLIN);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_046: [ If result is not negative, on_io_uring_notify_complete shall call the notify complete callback with ASYNC_SOCKET_NOTIFY_IO_RESULT_IN if POLLIN was requested and with ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT otherwise. ]
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_049: [ on_io_uring_notify_complete shall remove the context from the notification queue. ]
+TEST_FUNCTION(on_io_uring_notify_complete_for_POLLOUT_completes_the_notify_with_OUT)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_OUT, test_on_notify_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_OUT));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    complete_submitted_io(0, POLLOUT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_047: [ If result is -ECANCELED, on_io_uring_notify_complete shall call the notify complete callback with ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED. ]
+TEST_FUNCTION(on_io_uring_notify_complete_with_ECANCELED_completes_the_notify_with_ABANDONED)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_ABANDONED));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    complete_submitted_io(0, -ECANCELED);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+// Tests_SRS_ASYNC_SOCKET_LINUX_12_048: [ If result is any other negative value, on_io_uring_notify_complete shall call the notify complete callback with ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR. ]
+TEST_FUNCTION(on_io_uring_notify_complete_with_any_other_error_completes_the_notify_with_ERROR)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = create_and_open_io_uring_async_socket();
+    ASSERT_ARE_EQUAL(int, 0, async_socket_notify_io_async(async_socket, ASYNC_SOCKET_NOTIFY_IO_TYPE_IN, test_on_notify_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_lock_mocks();
+    STRICT_EXPECTED_CALL(test_on_notify_complete(test_callback_ctx, ASYNC_SOCKET_NOTIFY_IO_RESULT_ERROR));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    // act
+    complete_submitted_io(0, -EIO);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
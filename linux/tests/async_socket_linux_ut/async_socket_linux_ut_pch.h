@@ -7,10 +7,14 @@
 
 #include <stdlib.h>
 #include <inttypes.h>
+#include <string.h>
 #include <sys/epoll.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <errno.h>
 #include <sys/types.h>                       // for ssize_t
+#include <netinet/in.h>                      // for IP_RECVERR
+#include <linux/errqueue.h>                  // for struct sock_extended_err
 
 #include "macro_utils/macro_utils.h"  // IWYU pragma: keep
 
@@ -31,16 +35,34 @@
 #include "c_pal/gballoc_hl_redirect.h"
 #include "c_pal/interlocked.h"
 #include "c_pal/platform_linux.h"
+#include "c_pal/srw_lock_ll.h"
 #include "c_pal/sync.h"
 #include "c_pal/socket_handle.h"
 
 #include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
 
 #include "real_interlocked.h"
+#include "real_srw_lock_ll.h"
 #include "real_gballoc_hl.h" // IWYU pragma: keep
 
 #include "c_pal/async_socket.h"
+#include "c_pal/async_socket_linux.h"
 
 #define TEST_MAX_EVENTS_NUM     64
 
+#define TEST_MAX_SUBMITTED_IO   8
+
+#define TEST_MAX_MESSAGES       8
+
+#define TEST_ZERO_COPY_SEND_THRESHOLD   4
+
+// the size of the buffers of the receive buffer pools
+#define TEST_RECEIVE_BUFFER_SIZE        16
+
+// matches ASYNC_SOCKET_RING_BUFFER_COUNT in async_socket_linux.c
+#define TEST_RING_BUFFER_COUNT          8
+
+// matches ASYNC_SOCKET_LINUX_STATE_CLOSING in async_socket_linux.c
+#define TEST_ASYNC_SOCKET_LINUX_STATE_CLOSING   3
+
 #endif // ASYNC_SOCKET_LINUX_UT_PCH_H
@@ -0,0 +1,209 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+
+#include "c_logging/logger.h"
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "testrunnerswitcher.h"
+
+#include "c_pal/timer.h"
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/socket_handle.h"
+#include "c_pal/sync.h"
+#include "c_pal/completion_port_linux.h"
+
+#define EPOLL_THREAD_COUNT              4
+#define COMPLETIONS_PER_RUN             (1024 * 1024)
+
+// file descriptors kept for the process itself (stdio, epoll instances, log files)
+#define RESERVED_FD_COUNT               64
+
+typedef struct PERF_CONTEXT_TAG
+{
+    COMPLETION_PORT_HANDLE completion_port;
+    volatile_atomic int32_t completed_count;
+    int32_t total_count;
+} PERF_CONTEXT;
+
+typedef struct PERF_SOCKET_TAG
+{
+    PERF_CONTEXT* perf_context;
+    SOCKET_HANDLE socket;
+    int32_t remaining_count;
+} PERF_SOCKET;
+
+static uint32_t get_max_socket_count(uint32_t socket_count)
+{
+    struct rlimit limit;
+    ASSERT_ARE_EQUAL(int, 0, getrlimit(RLIMIT_NOFILE, &limit));
+
+    // allow as many file descriptors as the hard limit lets us
+    if (limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        (void)setrlimit(RLIMIT_NOFILE, &limit);
+        ASSERT_ARE_EQUAL(int, 0, getrlimit(RLIMIT_NOFILE, &limit));
+    }
+
+    uint32_t result = socket_count;
+    if (limit.rlim_cur < (rlim_t)socket_count + RESERVED_FD_COUNT)
+    {
+        result = (uint32_t)(limit.rlim_cur - RESERVED_FD_COUNT);
+        LogInfo("RLIMIT_NOFILE is %" PRIu64 ", running with %" PRIu32 " sockets instead of %" PRIu32 "",
+            (uint64_t)limit.rlim_cur, result, socket_count);
+    }
+    return result;
+}
+
+static void signal_socket(SOCKET_HANDLE socket)
+{
+    uint64_t value = 1;
+    ASSERT_ARE_EQUAL(int, (int)sizeof(value), (int)write(socket, &value, sizeof(value)));
+}
+
+static void on_socket_event(void* context, COMPLETION_PORT_EPOLL_ACTION action)
+{
+    PERF_SOCKET* perf_socket = context;
+    if (action == COMPLETION_PORT_EPOLL_EPOLLIN)
+    {
+        uint64_t value;
+        (void)read(perf_socket->socket, &value, sizeof(value));
+
+        perf_socket->remaining_count--;
+        if (perf_socket->remaining_count > 0)
+        {
+            // arm the socket again, which is what a socket does for every receive
+            ASSERT_ARE_EQUAL(int, 0, completion_port_add(perf_socket->perf_context->completion_port, EPOLLIN, perf_socket->socket, on_socket_event, perf_socket));
+            signal_socket(perf_socket->socket);
+        }
+
+        if (interlocked_increment(&perf_socket->perf_context->completed_count) == perf_socket->perf_context->total_count)
+        {
+            wake_by_address_single(&perf_socket->perf_context->completed_count);
+        }
+    }
+}
+
+static double run_completions(PERF_CONTEXT* perf_context, PERF_SOCKET* perf_sockets, uint32_t socket_count, int32_t completions_per_socket)
+{
+    perf_context->total_count = (int32_t)socket_count * completions_per_socket;
+    (void)interlocked_exchange(&perf_context->completed_count, 0);
+
+    double start_time = timer_global_get_elapsed_ms();
+
+    for (uint32_t i = 0; i < socket_count; i++)
+    {
+        perf_sockets[i].remaining_count = completions_per_socket;
+        ASSERT_ARE_EQUAL(int, 0, completion_port_add(perf_context->completion_port, EPOLLIN, perf_sockets[i].socket, on_socket_event, &perf_sockets[i]));
+        signal_socket(perf_sockets[i].socket);
+    }
+
+    int32_t value;
+    while ((value = interlocked_add(&perf_context->completed_count, 0)) != perf_context->total_count)
+    {
+        (void)wait_on_address(&perf_context->completed_count, value, UINT32_MAX);
+    }
+
+    double elapsed_ms = timer_global_get_elapsed_ms() - start_time;
+    return (double)perf_context->total_count * 1000.0 / elapsed_ms;
+}
+
+static void run_concurrent_sockets(uint32_t requested_socket_count)
+{
+    uint32_t socket_count = get_max_socket_count(requested_socket_count);
+    ASSERT_ARE_NOT_EQUAL(uint32_t, 0, socket_count);
+
+    PERF_CONTEXT perf_context;
+    perf_context.completion_port = completion_port_create_with_thread_count(EPOLL_THREAD_COUNT);
+    ASSERT_IS_NOT_NULL(perf_context.completion_port);
+
+    PERF_SOCKET* perf_sockets = malloc_2(socket_count, sizeof(PERF_SOCKET));
+    ASSERT_IS_NOT_NULL(perf_sockets);
+    for (uint32_t i = 0; i < socket_count; i++)
+    {
+        perf_sockets[i].perf_context = &perf_context;
+        perf_sockets[i].socket = eventfd(0, EFD_NONBLOCK);
+        ASSERT_ARE_NOT_EQUAL(int, -1, perf_sockets[i].socket);
+    }
+
+    int32_t completions_per_socket = (COMPLETIONS_PER_RUN / socket_count > 0) ? (int32_t)(COMPLETIONS_PER_RUN / socket_count) : 1;
+
+    // the first run arms every socket for the first time
+    double first_run_completions_per_second = run_completions(&perf_context, perf_sockets, socket_count, completions_per_socket);
+    // the second run finds all the registrations of the first run ready to be reused
+    double second_run_completions_per_second = run_completions(&perf_context, perf_sockets, socket_count, completions_per_socket);
+
+    LogInfo("%" PRIu32 " concurrent sockets on %d epoll threads, %" PRId32 " completions per socket: first run %.02f completions/s, second run %.02f completions/s",
+        socket_count, EPOLL_THREAD_COUNT, completions_per_socket, first_run_completions_per_second, second_run_completions_per_second);
+
+    for (uint32_t i = 0; i < socket_count; i++)
+    {
+        completion_port_remove(perf_context.completion_port, perf_sockets[i].socket);
+        (void)close(perf_sockets[i].socket);
+    }
+    free(perf_sockets);
+    completion_port_dec_ref(perf_context.completion_port);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+/* completion throughput, every completion arms the socket again */
+
+TEST_FUNCTION(completion_port_throughput_with_1000_sockets)
+{
+    // arrange
+
+    // act
+    run_concurrent_sockets(1000);
+
+    // assert
+}
+
+TEST_FUNCTION(completion_port_throughput_with_10000_sockets)
+{
+    // arrange
+
+    // act
+    run_concurrent_sockets(10000);
+
+    // assert
+}
+
+TEST_FUNCTION(completion_port_throughput_with_100000_sockets)
+{
+    // arrange
+
+    // act
+    run_concurrent_sockets(100000);
+
+    // assert
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
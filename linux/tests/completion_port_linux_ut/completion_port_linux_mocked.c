@@ -1,15 +1,23 @@
 // Copyright (c) Microsoft. All rights reserved.
 
 #include <sys/epoll.h>  // IWYU pragma: keep
+#include <sys/mman.h>   // IWYU pragma: keep
+#include <sys/types.h>  // IWYU pragma: keep
 
 #define epoll_create    mocked_epoll_create
 #define epoll_ctl       mocked_epoll_ctl
 #define epoll_wait      mocked_epoll_wait
 #define close           mocked_close
+#define syscall         mocked_syscall
+#define mmap            mocked_mmap
+#define munmap          mocked_munmap
 
 int mocked_epoll_create(int __size);
 int mocked_epoll_ctl(int epfd, int op, int fd, struct epoll_event* event);
 int mocked_epoll_wait(int epfd, struct epoll_event* events, int maxevents, int timeout);
 int mocked_close(int s);
+long mocked_syscall(long number, ...);
+void* mocked_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset);
+int mocked_munmap(void* addr, size_t length);
 
 #include "../../src/completion_port_linux.c"
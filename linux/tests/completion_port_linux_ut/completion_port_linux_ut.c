@@ -12,11 +12,50 @@ static void* g_saved_worker_thread_func_context;
 static struct epoll_event g_events[2];
 static uint32_t g_event_index = 0;
 static int g_test_epoll = 2;
+static uint32_t g_epoll_ctl_events;
 
-THREADAPI_RESULT my_ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg)
+static char g_saved_thread_name[THREADAPI_MAX_THREAD_NAME_LENGTH + 1];
+
+#define TEST_SQ_ENTRIES     4
+#define TEST_CQ_ENTRIES     8
+#define TEST_RING_BUFFERS   4
+
+// the layout of the rings that the kernel shares with the io_uring, as described by the offsets returned by io_uring_setup
+typedef struct TEST_IO_URING_RINGS_TAG
+{
+    uint32_t sq_head;
+    uint32_t sq_tail;
+    uint32_t sq_ring_mask;
+    uint32_t sq_flags;
+    uint32_t sq_array[TEST_SQ_ENTRIES];
+    uint32_t cq_head;
+    uint32_t cq_tail;
+    uint32_t cq_ring_mask;
+    struct io_uring_cqe cqes[TEST_CQ_ENTRIES];
+} TEST_IO_URING_RINGS;
+
+static TEST_IO_URING_RINGS g_test_rings;
+static struct io_uring_sqe g_test_sqes[TEST_SQ_ENTRIES];
+static int g_test_ring_fd = 20;
+static uint32_t g_test_ring_features;
+static void* g_mmap_result;
+static int g_io_uring_enter_result;
+static struct io_uring_cqe g_overflowed_cqe;
+static bool g_has_overflowed_cqe;
+static COMPLETION_PORT_HANDLE g_submitting_port;
+// the entries of a provided-buffer ring, the tail of the ring overlays the reserved field of the first entry
+static struct io_uring_buf g_test_ring_buffers[TEST_RING_BUFFERS];
+static struct io_uring_buf_reg g_test_buffer_registration;
+static int g_io_uring_register_errno;
+
+static void* test_io_context = (void*)0x4246;
+static struct msghdr test_message;
+
+THREADAPI_RESULT my_ThreadAPI_CreateEx(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg, const THREADAPI_CREATE_OPTIONS* options)
 {
     g_saved_worker_thread_func = func;
     g_saved_worker_thread_func_context = arg;
+    (void)snprintf(g_saved_thread_name, sizeof(g_saved_thread_name), "%s", options->name);
     *threadHandle = test_thread_handle;
     return THREADAPI_OK;
 }
@@ -31,6 +70,10 @@ MU_DEFINE_ENUM_STRINGS(INTERLOCKED_HL_RESULT, INTERLOCKED_HL_RESULT_VALUES);
 TEST_DEFINE_ENUM_TYPE(INTERLOCKED_HL_RESULT, INTERLOCKED_HL_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(INTERLOCKED_HL_RESULT, INTERLOCKED_HL_RESULT_VALUES);
 
+IMPLEMENT_UMOCK_C_ENUM_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT_VALUES);
+
+TEST_DEFINE_ENUM_TYPE(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_VALUES);
+
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
@@ -42,7 +85,8 @@ MOCK_FUNCTION_END(g_test_epoll)
 MOCK_FUNCTION_WITH_CODE(, int, mocked_epoll_ctl, int, epfd, int, op, int, fd, struct epoll_event*, event)
     if (event != NULL)
     {
-        if (op == EPOLL_CTL_MOD)
+        g_epoll_ctl_events = event->events;
+        if ((op == EPOLL_CTL_MOD || op == EPOLL_CTL_ADD) && g_event_index < sizeof(g_events) / sizeof(g_events[0]))
         {
             g_events[g_event_index++].data.ptr = event->data.ptr;
         }
@@ -53,8 +97,106 @@ MOCK_FUNCTION_END(0)
 MOCK_FUNCTION_WITH_CODE(, int, mocked_close, int, s)
 MOCK_FUNCTION_END(0)
 
+MOCK_FUNCTION_WITH_CODE(, int, mocked_io_uring_setup, uint32_t, entries, struct io_uring_params*, params)
+    params->features = g_test_ring_features;
+    params->sq_entries = TEST_SQ_ENTRIES;
+    params->cq_entries = TEST_CQ_ENTRIES;
+    params->sq_off.head = offsetof(TEST_IO_URING_RINGS, sq_head);
+    params->sq_off.tail = offsetof(TEST_IO_URING_RINGS, sq_tail);
+    params->sq_off.ring_mask = offsetof(TEST_IO_URING_RINGS, sq_ring_mask);
+    params->sq_off.flags = offsetof(TEST_IO_URING_RINGS, sq_flags);
+    params->sq_off.array = offsetof(TEST_IO_URING_RINGS, sq_array);
+    params->cq_off.head = offsetof(TEST_IO_URING_RINGS, cq_head);
+    params->cq_off.tail = offsetof(TEST_IO_URING_RINGS, cq_tail);
+    params->cq_off.ring_mask = offsetof(TEST_IO_URING_RINGS, cq_ring_mask);
+    params->cq_off.cqes = offsetof(TEST_IO_URING_RINGS, cqes);
+MOCK_FUNCTION_END(g_test_ring_fd)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_io_uring_enter, int, ring_fd, uint32_t, to_submit, uint32_t, min_complete, uint32_t, flags)
+    // all the entries are submitted
+    g_io_uring_enter_result = (int)to_submit;
+    if ((flags & IORING_ENTER_GETEVENTS) != 0)
+    {
+        // the kernel moves the completions that did not fit in the completion queue
+        g_test_rings.sq_flags &= ~IORING_SQ_CQ_OVERFLOW;
+        if (g_has_overflowed_cqe)
+        {
+            g_test_rings.cqes[g_test_rings.cq_tail & (TEST_CQ_ENTRIES - 1)] = g_overflowed_cqe;
+            g_test_rings.cq_tail++;
+            g_has_overflowed_cqe = false;
+        }
+    }
+MOCK_FUNCTION_END(g_io_uring_enter_result)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_io_uring_register, int, ring_fd, uint32_t, opcode, void*, arg, uint32_t, nr_args)
+    g_test_buffer_registration = *(struct io_uring_buf_reg*)arg;
+    // the error of a failed registration
+    errno = g_io_uring_register_errno;
+MOCK_FUNCTION_END(0)
+MOCK_FUNCTION_WITH_CODE(, void*, mocked_mmap, void*, addr, size_t, length, int, prot, int, flags, int, fd, off_t, offset)
+    if (fd == -1)
+    {
+        // the anonymous mapping of a provided-buffer ring
+        g_mmap_result = (void*)g_test_ring_buffers;
+    }
+    else
+    {
+        g_mmap_result = (offset == IORING_OFF_SQ_RING) ? (void*)&g_test_rings : (void*)g_test_sqes;
+    }
+MOCK_FUNCTION_END(g_mmap_result)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_munmap, void*, addr, size_t, length)
+MOCK_FUNCTION_END(0)
+
 MOCK_FUNCTION_WITH_CODE(, void, test_port_event_complete, void*, context, COMPLETION_PORT_EPOLL_ACTION, action)
 MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(, void, test_on_io_complete, void*, context, int32_t, result)
+MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(, void, test_on_io_complete_submitting_the_next_io, void*, context, int32_t, result)
+    // the socket submits its next operation from the callback, like async_socket does
+    (void)completion_port_submit_io(g_submitting_port, test_socket, context);
+MOCK_FUNCTION_END()
+
+long mocked_syscall(long number, ...)
+{
+    long result;
+    va_list args;
+    va_start(args, number);
+    if (number == __NR_io_uring_setup)
+    {
+        uint32_t entries = va_arg(args, uint32_t);
+        struct io_uring_params* params = va_arg(args, struct io_uring_params*);
+        result = mocked_io_uring_setup(entries, params);
+    }
+    else if (number == __NR_io_uring_enter)
+    {
+        int ring_fd = va_arg(args, int);
+        uint32_t to_submit = va_arg(args, uint32_t);
+        uint32_t min_complete = va_arg(args, uint32_t);
+        uint32_t flags = va_arg(args, uint32_t);
+        result = mocked_io_uring_enter(ring_fd, to_submit, min_complete, flags);
+    }
+    else if (number == __NR_io_uring_register)
+    {
+        int ring_fd = va_arg(args, int);
+        uint32_t opcode = va_arg(args, uint32_t);
+        void* arg = va_arg(args, void*);
+        uint32_t nr_args = va_arg(args, uint32_t);
+        result = mocked_io_uring_register(ring_fd, opcode, arg, nr_args);
+    }
+    else
+    {
+        ASSERT_FAIL("unexpected syscall %ld", number);
+        result = -1;
+    }
+    va_end(args);
+    return result;
+}
+
+static void setup_epoll_thread_init_mocks(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(s_list_initialize(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_initialize(IGNORED_ARG));
+}
 
 static void setup_completion_port_create_mocks(void)
 {
@@ -66,45 +208,212 @@ static void setup_completion_port_create_mocks(void)
         .CallCannotFail();
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(s_list_initialize(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
     STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
-    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
         .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
 }
 
+static void setup_completion_port_add_mocks_for_epoll_ex(int epoll, SOCKET_HANDLE socket, bool grows_armed_data, bool has_free_thread_data)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetFailReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    if (grows_armed_data)
+    {
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG))
+        .CallCannotFail();
+    if (!has_free_thread_data)
+    {
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(epoll, EPOLL_CTL_MOD, socket, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+}
+
+static void setup_completion_port_add_mocks_for_epoll(int epoll, SOCKET_HANDLE socket)
+{
+    setup_completion_port_add_mocks_for_epoll_ex(epoll, socket, true, false);
+}
+
 static void setup_completion_port_add_mocks(void)
+{
+    setup_completion_port_add_mocks_for_epoll(g_test_epoll, test_socket);
+}
+
+static void setup_completion_port_add_persistent_mocks(void)
 {
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
         .SetFailReturn(1);
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG))
+        .CallCannotFail();
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_ADD, test_socket, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+}
+
+static void setup_io_uring_ring_init_mocks(void)
+{
+    STRICT_EXPECTED_CALL(mocked_io_uring_setup(TEST_IO_URING_SQ_ENTRIES, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, IGNORED_ARG, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, g_test_ring_fd, IORING_OFF_SQ_RING));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, IGNORED_ARG, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, g_test_ring_fd, IORING_OFF_SQES));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+}
+
+static void setup_io_uring_ring_deinit_mocks(void)
+{
+    STRICT_EXPECTED_CALL(mocked_munmap(g_test_sqes, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_munmap(&g_test_rings, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(g_test_ring_fd));
+}
+
+static void setup_completion_port_create_with_io_uring_mocks(void)
+{
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
+    setup_io_uring_ring_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_ADD, g_test_ring_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+}
+
+static COMPLETION_PORT_HANDLE create_completion_port_with_io_uring(void)
+{
+    COMPLETION_PORT_HANDLE result = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_IO_URING);
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_IO_URING, completion_port_get_engine(result));
+    return result;
+}
+
+static void setup_submit_sqe_mocks(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(mocked_io_uring_enter(g_test_ring_fd, 1, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
+        .CallCannotFail();
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_MOD, test_socket, IGNORED_ARG));
+}
+
+static void add_test_cqe_with_flags(void* io, int32_t res, uint32_t flags)
+{
+    struct io_uring_cqe* cqe = &g_test_rings.cqes[g_test_rings.cq_tail & (TEST_CQ_ENTRIES - 1)];
+    cqe->user_data = (uint64_t)(uintptr_t)io;
+    cqe->res = res;
+    cqe->flags = flags;
+    g_test_rings.cq_tail++;
+}
+
+static void add_test_cqe(void* io, int32_t res)
+{
+    add_test_cqe_with_flags(io, res, 0);
+}
+
+static void setup_completion_port_buffer_ring_create_mocks(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetFailReturn(1);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, TEST_RING_BUFFERS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(mocked_io_uring_register(g_test_ring_fd, IORING_REGISTER_PBUF_RING, IGNORED_ARG, 1));
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 }
 
-static void setup_remove_thread_data(void)
+static COMPLETION_PORT_BUFFER_RING_HANDLE create_buffer_ring(COMPLETION_PORT_HANDLE port_handle)
+{
+    COMPLETION_PORT_BUFFER_RING_HANDLE result = completion_port_buffer_ring_create(port_handle, test_socket, TEST_RING_BUFFERS);
+    ASSERT_IS_NOT_NULL(result);
+    return result;
+}
+
+static COMPLETION_PORT_HANDLE create_completion_port_with_3_threads(void)
+{
+    // the epoll instances of the 3 threads are 10, 11 and 12
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM))
+        .SetReturn(10);
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM))
+        .SetReturn(11);
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM))
+        .SetReturn(12);
+    COMPLETION_PORT_HANDLE result = completion_port_create_with_thread_count(3);
+    ASSERT_IS_NOT_NULL(result);
+    return result;
+}
+
+static void setup_release_thread_data(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+}
+
+static void setup_release_abandoned_data(void)
 {
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(s_list_remove(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 }
 
+static void setup_free_thread_data_mocks(void)
+{
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG)); // abandoned objects
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG)); // free objects
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // armed objects of the sockets
+}
+
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -121,23 +430,32 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(realloc_2, NULL);
 
     REGISTER_GLOBAL_MOCK_RETURNS(s_list_initialize, 0, MU_FAILURE);
     REGISTER_GLOBAL_MOCK_RETURNS(s_list_add, 0, MU_FAILURE);
 
-    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_Create, my_ThreadAPI_Create);
-    REGISTER_GLOBAL_MOCK_FAIL_RETURN(ThreadAPI_Create, THREADAPI_ERROR);
+    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_CreateEx, my_ThreadAPI_CreateEx);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(ThreadAPI_CreateEx, THREADAPI_ERROR);
     REGISTER_GLOBAL_MOCK_RETURN(ThreadAPI_Join, THREADAPI_OK);
 
     REGISTER_GLOBAL_MOCK_RETURNS(mocked_epoll_create, g_test_epoll, -1);
     REGISTER_GLOBAL_MOCK_RETURNS(mocked_epoll_ctl, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(wait_on_address, WAIT_ON_ADDRESS_OK, WAIT_ON_ADDRESS_ERROR);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_io_uring_setup, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_io_uring_enter, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_io_uring_register, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_mmap, MAP_FAILED);
 
     REGISTER_UMOCK_ALIAS_TYPE(THREAD_START_FUNC, void*);
     REGISTER_UMOCK_ALIAS_TYPE(THREAD_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(PS_LIST_ENTRY, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(off_t, int64_t);
 
     REGISTER_TYPE(THREADAPI_RESULT, THREADAPI_RESULT);
     REGISTER_TYPE(INTERLOCKED_HL_RESULT, INTERLOCKED_HL_RESULT);
+    REGISTER_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT);
     REGISTER_TYPE(COMPLETION_PORT_EPOLL_ACTION, COMPLETION_PORT_EPOLL_ACTION);
 }
 
@@ -154,6 +472,16 @@ TEST_FUNCTION_INITIALIZE(init)
     errno = 0;
     g_event_index = 0;
     memset(g_events, 0, sizeof(struct epoll_event)*2);
+
+    (void)memset(&g_test_rings, 0, sizeof(g_test_rings));
+    (void)memset(g_test_sqes, 0, sizeof(g_test_sqes));
+    g_test_rings.sq_ring_mask = TEST_SQ_ENTRIES - 1;
+    g_test_rings.cq_ring_mask = TEST_CQ_ENTRIES - 1;
+    g_test_ring_features = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL;
+    g_has_overflowed_cqe = false;
+    (void)memset(g_test_ring_buffers, 0, sizeof(g_test_ring_buffers));
+    (void)memset(&g_test_buffer_registration, 0, sizeof(g_test_buffer_registration));
+    g_io_uring_register_errno = 0;
 }
 
 TEST_FUNCTION_CLEANUP(cleanup)
@@ -163,10 +491,10 @@ TEST_FUNCTION_CLEANUP(cleanup)
 
 // completion_port_create
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_001: [ completion_port_create shall allocate memory for a completion port object. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_002: [ completion_port_create shall create the epoll instance by calling epoll_create. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_003: [ completion_port_create shall create a thread that runs epoll_worker_func to handle the epoll events. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_004: [ On success completion_port_create shall return the allocated COMPLETION_PORT_HANDLE. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_001: [ completion_port_create_with_thread_count shall allocate memory for a completion port object. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_002: [ completion_port_create_with_thread_count shall create an epoll instance for each epoll thread by calling epoll_create. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_003: [ For each epoll thread, completion_port_create_with_thread_count shall create a thread named cp_epoll that runs epoll_worker_func to handle the events of the epoll instance by calling ThreadAPI_CreateEx. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_004: [ On success completion_port_create_with_thread_count shall return the allocated COMPLETION_PORT_HANDLE. ]
 TEST_FUNCTION(completion_port_create_success)
 {
     //arrange
@@ -178,12 +506,13 @@ TEST_FUNCTION(completion_port_create_success)
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(char_ptr, "cp_epoll", g_saved_thread_name);
 
     // cleanup
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create shall fail and return NULL. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create_with_thread_count shall fail and return NULL. ]
 TEST_FUNCTION(completion_port_create_fails)
 {
     // arrange
@@ -209,165 +538,2357 @@ TEST_FUNCTION(completion_port_create_fails)
     }
 }
 
-// completion_port_inc_ref
-
-// Tests_SRS_COMPLETION_PORT_LINUX_11_006: [ If completion_port is NULL, completion_port_inc_ref shall return. ]
-TEST_FUNCTION(completion_port_inc_ref_handle_NULL_fail)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_001: [ completion_port_create shall create a completion port the same way completion_port_create_with_thread_count does, with a single epoll thread. ]
+TEST_FUNCTION(completion_port_create_creates_a_single_epoll_thread)
 {
     //arrange
+    setup_completion_port_create_mocks();
 
     //act
-    completion_port_inc_ref(NULL);
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(port_handle);
 
     // cleanup
+    completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_007: [ Otherwise completion_port_inc_ref shall increment the internally maintained reference count. ]
-TEST_FUNCTION(completion_port_inc_ref_success)
+// completion_port_create_with_thread_count
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_002: [ If thread_count is 0, completion_port_create_with_thread_count shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_create_with_thread_count_with_thread_count_0_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
-        .CallCannotFail();
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_thread_count(0);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_001: [ completion_port_create_with_thread_count shall allocate memory for a completion port object. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_003: [ completion_port_create_with_thread_count shall allocate memory for thread_count epoll threads. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_002: [ completion_port_create_with_thread_count shall create an epoll instance for each epoll thread by calling epoll_create. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_003: [ For each epoll thread, completion_port_create_with_thread_count shall create a thread named cp_epoll that runs epoll_worker_func to handle the events of the epoll instance by calling ThreadAPI_CreateEx. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_004: [ On success completion_port_create_with_thread_count shall return the allocated COMPLETION_PORT_HANDLE. ]
+TEST_FUNCTION(completion_port_create_with_thread_count_succeeds)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_2(3, IGNORED_ARG));
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        setup_epoll_thread_init_mocks();
+        STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM))
+            .SetReturn(10 + i);
+        STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+            .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+    }
 
     //act
-    completion_port_inc_ref(port_handle);
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_thread_count(3);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(char_ptr, "cp_epoll", g_saved_thread_name);
 
     // cleanup
     completion_port_dec_ref(port_handle);
-    completion_port_dec_ref(port_handle);
 }
 
-// completion_port_dec_ref
-
-// Tests_SRS_COMPLETION_PORT_LINUX_11_008: [ If completion_port is NULL, completion_port_dec_ref shall return. ]
-TEST_FUNCTION(completion_port_dec_ref_handle_NULL_fail)
+// Tests_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create_with_thread_count shall fail and return NULL. ]
+TEST_FUNCTION(when_creating_the_second_thread_fails_completion_port_create_with_thread_count_stops_the_first_thread_and_fails)
 {
     //arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM))
+        .SetReturn(10);
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM))
+        .SetReturn(11);
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(THREADAPI_ERROR);
+    STRICT_EXPECTED_CALL(mocked_close(11));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(10));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(test_thread_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     //act
-    completion_port_dec_ref(NULL);
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_thread_count(2);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(port_handle);
+}
 
-    // cleanup
+// Tests_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create_with_thread_count shall fail and return NULL. ]
+TEST_FUNCTION(when_underlying_calls_fail_completion_port_create_with_thread_count_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
+    {
+        if (umock_c_negative_tests_can_call_fail(index))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(index);
+
+            // act
+            COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_thread_count(2);
+
+            // assert
+            ASSERT_IS_NULL(port_handle, "On failed call %zu", index);
+        }
+    }
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_009: [ completion_port_dec_ref shall decrement the reference count for completion_port. ]
-TEST_FUNCTION(completion_port_dec_ref_1_ref_success)
+// completion_port_create_with_engine
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_019: [ If thread_count is 0, completion_port_create_with_engine shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_create_with_engine_with_thread_count_0_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    completion_port_inc_ref(port_handle);
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
 
     //act
-    completion_port_dec_ref(port_handle);
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(0, COMPLETION_PORT_ENGINE_IO_URING);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    // cleanup
-    completion_port_dec_ref(port_handle);
+    ASSERT_IS_NULL(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_010: [ If the reference count reaches 0, completion_port_dec_ref shall do the following: ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_011: [ wait for the ongoing call count to reach zero. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_012: [ increment the flag signaling that the threads can complete. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_013: [ close the epoll object. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_014: [ close the thread by calling ThreadAPI_Join. ]
-TEST_FUNCTION(completion_port_dec_ref_0_ref_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_020: [ If engine is not COMPLETION_PORT_ENGINE_EPOLL or COMPLETION_PORT_ENGINE_IO_URING, completion_port_create_with_engine shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_create_with_engine_with_invalid_engine_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_close(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     //act
-    completion_port_dec_ref(port_handle);
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, (COMPLETION_PORT_ENGINE)(COMPLETION_PORT_ENGINE_IO_URING + 1));
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    // cleanup
+    ASSERT_IS_NULL(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_015: [ then the memory associated with completion_port shall be freed. ]
-TEST_FUNCTION(completion_port_dec_ref_remove_item_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_021: [ completion_port_create_with_engine shall create a completion port with thread_count epoll threads the same way completion_port_create_with_thread_count does. ]
+TEST_FUNCTION(completion_port_create_with_engine_with_EPOLL_succeeds)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
+    setup_completion_port_create_mocks();
+
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_EPOLL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_EPOLL, completion_port_get_engine(port_handle));
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_021: [ completion_port_create_with_engine shall create a completion port with thread_count epoll threads the same way completion_port_create_with_thread_count does. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_022: [ If engine is COMPLETION_PORT_ENGINE_IO_URING, completion_port_create_with_engine shall set up an io_uring for each epoll thread by calling io_uring_setup and mapping its rings with mmap. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_024: [ completion_port_create_with_engine shall add each io_uring to the epoll instance of its epoll thread by calling epoll_ctl with EPOLL_CTL_ADD and EPOLLIN, so that the epoll thread handles the completions. ]
+TEST_FUNCTION(completion_port_create_with_engine_with_IO_URING_sets_up_an_io_uring_for_the_epoll_thread)
+{
+    //arrange
+    setup_completion_port_create_with_io_uring_mocks();
+
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_IO_URING, completion_port_get_engine(port_handle));
+    ASSERT_ARE_EQUAL(uint32_t, EPOLLIN, g_epoll_ctl_events);
+    ASSERT_ARE_EQUAL(void_ptr, g_saved_worker_thread_func_context, g_events[0].data.ptr);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_023: [ If the io_uring of the first epoll thread cannot be set up or the kernel does not support IORING_FEAT_SINGLE_MMAP, IORING_FEAT_NODROP and IORING_FEAT_FAST_POLL, completion_port_create_with_engine shall fall back to COMPLETION_PORT_ENGINE_EPOLL. ]
+TEST_FUNCTION(when_io_uring_setup_fails_completion_port_create_with_engine_falls_back_to_EPOLL)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
+    STRICT_EXPECTED_CALL(mocked_io_uring_setup(TEST_IO_URING_SQ_ENTRIES, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_EPOLL, completion_port_get_engine(port_handle));
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_023: [ If the io_uring of the first epoll thread cannot be set up or the kernel does not support IORING_FEAT_SINGLE_MMAP, IORING_FEAT_NODROP and IORING_FEAT_FAST_POLL, completion_port_create_with_engine shall fall back to COMPLETION_PORT_ENGINE_EPOLL. ]
+TEST_FUNCTION(when_the_kernel_does_not_support_IORING_FEAT_FAST_POLL_completion_port_create_with_engine_falls_back_to_EPOLL)
+{
+    //arrange
+    g_test_ring_features = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
+    STRICT_EXPECTED_CALL(mocked_io_uring_setup(TEST_IO_URING_SQ_ENTRIES, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(g_test_ring_fd));
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_EPOLL, completion_port_get_engine(port_handle));
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_023: [ If the io_uring of the first epoll thread cannot be set up or the kernel does not support IORING_FEAT_SINGLE_MMAP, IORING_FEAT_NODROP and IORING_FEAT_FAST_POLL, completion_port_create_with_engine shall fall back to COMPLETION_PORT_ENGINE_EPOLL. ]
+TEST_FUNCTION(when_mapping_the_submission_queue_entries_fails_completion_port_create_with_engine_falls_back_to_EPOLL)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
+    STRICT_EXPECTED_CALL(mocked_io_uring_setup(TEST_IO_URING_SQ_ENTRIES, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, IGNORED_ARG, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, g_test_ring_fd, IORING_OFF_SQ_RING));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, IGNORED_ARG, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, g_test_ring_fd, IORING_OFF_SQES))
+        .SetReturn(MAP_FAILED);
+    STRICT_EXPECTED_CALL(mocked_munmap(&g_test_rings, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(g_test_ring_fd));
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_EPOLL, completion_port_get_engine(port_handle));
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create_with_thread_count shall fail and return NULL. ]
+TEST_FUNCTION(when_setting_up_the_io_uring_of_the_second_epoll_thread_fails_completion_port_create_with_engine_stops_the_first_thread_and_fails)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_2(2, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM))
+        .SetReturn(10);
+    setup_io_uring_ring_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(10, EPOLL_CTL_ADD, g_test_ring_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_threadHandle(&test_thread_handle, sizeof(test_thread_handle));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM))
+        .SetReturn(11);
+    STRICT_EXPECTED_CALL(mocked_io_uring_setup(TEST_IO_URING_SQ_ENTRIES, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_close(11));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(10));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(test_thread_handle, IGNORED_ARG));
+    setup_io_uring_ring_deinit_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(2, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create_with_thread_count shall fail and return NULL. ]
+TEST_FUNCTION(when_adding_the_io_uring_to_the_epoll_instance_fails_completion_port_create_with_engine_fails)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
+    setup_io_uring_ring_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_ADD, g_test_ring_fd, IGNORED_ARG))
+        .SetReturn(-1);
+    setup_io_uring_ring_deinit_mocks();
+    STRICT_EXPECTED_CALL(mocked_close(g_test_epoll));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_005: [ If there are any errors then completion_port_create_with_thread_count shall fail and return NULL. ]
+TEST_FUNCTION(when_creating_the_thread_fails_completion_port_create_with_engine_closes_the_io_uring_and_fails)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc_2(1, IGNORED_ARG));
+    setup_epoll_thread_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_create(TEST_MAX_EVENTS_NUM));
+    setup_io_uring_ring_init_mocks();
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_ADD, g_test_ring_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(THREADAPI_ERROR);
+    setup_io_uring_ring_deinit_mocks();
+    STRICT_EXPECTED_CALL(mocked_close(g_test_epoll));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    //act
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(port_handle);
+}
+
+// completion_port_get_engine
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_025: [ If completion_port is NULL, completion_port_get_engine shall return COMPLETION_PORT_ENGINE_EPOLL. ]
+TEST_FUNCTION(completion_port_get_engine_with_NULL_completion_port_returns_EPOLL)
+{
+    //arrange
+
+    //act
+    COMPLETION_PORT_ENGINE engine = completion_port_get_engine(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_EPOLL, engine);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_026: [ Otherwise, completion_port_get_engine shall return the engine used by completion_port. ]
+TEST_FUNCTION(completion_port_get_engine_returns_EPOLL_for_a_completion_port_created_by_completion_port_create)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    //act
+    COMPLETION_PORT_ENGINE engine = completion_port_get_engine(port_handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_EPOLL, engine);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_026: [ Otherwise, completion_port_get_engine shall return the engine used by completion_port. ]
+TEST_FUNCTION(completion_port_get_engine_returns_IO_URING_for_a_completion_port_using_io_uring)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_IO_URING);
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    //act
+    COMPLETION_PORT_ENGINE engine = completion_port_get_engine(port_handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_IO_URING, engine);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// completion_port_inc_ref
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_006: [ If completion_port is NULL, completion_port_inc_ref shall return. ]
+TEST_FUNCTION(completion_port_inc_ref_handle_NULL_fail)
+{
+    //arrange
+
+    //act
+    completion_port_inc_ref(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_007: [ Otherwise completion_port_inc_ref shall increment the internally maintained reference count. ]
+TEST_FUNCTION(completion_port_inc_ref_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+
+    //act
+    completion_port_inc_ref(port_handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+    completion_port_dec_ref(port_handle);
+}
+
+// completion_port_dec_ref
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_008: [ If completion_port is NULL, completion_port_dec_ref shall return. ]
+TEST_FUNCTION(completion_port_dec_ref_handle_NULL_fail)
+{
+    //arrange
+
+    //act
+    completion_port_dec_ref(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_009: [ completion_port_dec_ref shall decrement the reference count for completion_port. ]
+TEST_FUNCTION(completion_port_dec_ref_1_ref_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    completion_port_inc_ref(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    //act
+    completion_port_dec_ref(port_handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_010: [ If the reference count reaches 0, completion_port_dec_ref shall do the following: ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_011: [ wait for the ongoing call count to reach zero. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_012: [ increment the flag signaling that the threads can complete. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_013: [ close the epoll objects. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_014: [ close the threads by calling ThreadAPI_Join. ]
+TEST_FUNCTION(completion_port_dec_ref_0_ref_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mocked_close(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+    setup_free_thread_data_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // epoll threads
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    //act
+    completion_port_dec_ref(port_handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_015: [ then the memory associated with completion_port, including all the EPOLL_THREAD_DATA objects, shall be freed. ]
+TEST_FUNCTION(completion_port_dec_ref_remove_item_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mocked_close(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // armed object
+    setup_free_thread_data_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // epoll threads
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    //act
+    completion_port_dec_ref(port_handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_013: [ close the epoll objects. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_014: [ close the threads by calling ThreadAPI_Join. ]
+TEST_FUNCTION(completion_port_dec_ref_0_ref_with_3_threads_closes_all_the_epoll_objects_and_threads)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_3_threads();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mocked_close(10));
+    STRICT_EXPECTED_CALL(mocked_close(11));
+    STRICT_EXPECTED_CALL(mocked_close(12));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+    setup_free_thread_data_mocks();
+    setup_free_thread_data_mocks();
+    setup_free_thread_data_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // epoll threads
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    //act
+    completion_port_dec_ref(port_handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_027: [ unmap the rings and close the io_uring of each epoll thread if the engine is COMPLETION_PORT_ENGINE_IO_URING. ]
+TEST_FUNCTION(completion_port_dec_ref_0_ref_with_IO_URING_closes_the_io_uring)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mocked_close(g_test_epoll));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+    setup_io_uring_ring_deinit_mocks();
+    setup_free_thread_data_mocks();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // epoll threads
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    //act
+    completion_port_dec_ref(port_handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// completion_port_add
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_016: [ If completion_port is NULL, completion_port_add shall return a non-zero value. ]
+TEST_FUNCTION(completion_port_add_handle_NULL_fail)
+{
+    //arrange
+
+    //act
+    int result = completion_port_add(NULL, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_018: [ If event_callback is NULL, completion_port_add shall return a non-zero value. ]
+TEST_FUNCTION(completion_port_add_event_callback_NULL_fail)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    //act
+    int result = completion_port_add(port_handle, EPOLLIN, test_socket, NULL, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_017: [ If socket is INVALID_SOCKET, completion_port_add shall return a non-zero value. ]
+TEST_FUNCTION(completion_port_add_socket_handle_INVALID_fail)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    //act
+    int result = completion_port_add(port_handle, EPOLLIN, INVALID_SOCKET, test_port_event_complete, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_019: [ completion_port_add shall ensure the thread completion flag is not set. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_020: [ completion_port_add shall increment the ongoing call count value to prevent close. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_021: [ If there is no free EPOLL_THREAD_DATA object, completion_port_add shall allocate a EPOLL_THREAD_DATA object to store thread data. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_022: [ completion_port_add shall add the EPOLL_THREAD_DATA object to the armed objects of socket in the epoll thread. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_007: [ Otherwise, completion_port_add shall add EPOLLONESHOT to epoll_op so that the EPOLL_THREAD_DATA object is signaled at most once. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_023: [ completion_port_add shall add the socket in the epoll system by calling epoll_ctl with EPOLL_CTL_MOD along with the epoll_op variable. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_025: [ completion_port_add shall decrement the ongoing call count value to unblock close. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_026: [ On success, completion_port_add shall return 0. ]
+TEST_FUNCTION(completion_port_add_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    setup_completion_port_add_mocks();
+
+    //act
+    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, EPOLLIN | EPOLLONESHOT, g_epoll_ctl_events);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_027: [ If any error occurs, completion_port_add shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_add_fail)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    // the table of the armed objects of the sockets only grows for the first call
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_completion_port_add_mocks_for_epoll_ex(g_test_epoll, test_socket, false, false);
+
+    umock_c_negative_tests_snapshot();
+
+    //act
+    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
+    {
+        if (umock_c_negative_tests_can_call_fail(index))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(index);
+
+            errno = EACCES;
+            int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+
+            //assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", index);
+        }
+    }
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_056: [ completion_port_add shall grow the table of the armed objects of the sockets of the epoll thread if it has no entry at the index socket divided by the number of epoll threads. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_027: [ If any error occurs, completion_port_add shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_growing_the_armed_objects_of_the_sockets_fails_completion_port_add_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_056: [ completion_port_add shall grow the table of the armed objects of the sockets of the epoll thread if it has no entry at the index socket divided by the number of epoll threads. ]
+TEST_FUNCTION(completion_port_add_for_a_socket_with_a_lower_handle_does_not_grow_the_armed_objects_of_the_sockets)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    setup_completion_port_add_mocks_for_epoll_ex(g_test_epoll, test_socket - 1, false, false);
+
+    //act
+    int result = completion_port_add(port_handle, EPOLLIN, test_socket - 1, test_port_event_complete, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_019: [ completion_port_add shall ensure the thread completion flag is not set. ]
+TEST_FUNCTION(completion_port_add_dec_ref_running_fail)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_008: [ If epoll_ctl fails, completion_port_add shall move the EPOLL_THREAD_DATA object back to the list of free objects of the epoll thread. ]
+TEST_FUNCTION(when_epoll_ctl_fails_completion_port_add_moves_the_thread_data_to_the_free_list)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_MOD, test_socket, IGNORED_ARG))
+        .SetReturn(-1);
+    setup_release_thread_data();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    errno = EACCES;
+    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_006: [ completion_port_add shall reuse an EPOLL_THREAD_DATA object from the list of free objects of the epoll thread. ]
+TEST_FUNCTION(completion_port_add_after_an_event_was_handled_reuses_the_thread_data)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx));
+
+    // the epoll thread handles the event, which puts the thread data in the free list
+    g_events[0].events = EPOLLIN;
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    umock_c_reset_all_calls();
+
+    setup_completion_port_add_mocks_for_epoll_ex(g_test_epoll, test_socket, false, true);
+
+    //act
+    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, g_events[0].data.ptr, g_events[1].data.ptr);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_024: [ If the epoll_ctl call fails with ENOENT, completion_port_add shall call epoll_ctl again with EPOLL_CTL_ADD. ]
+TEST_FUNCTION(completion_port_add_epoll_add_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_MOD, test_socket, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_ADD, test_socket, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    errno = ENOENT;
+    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_011: [ If epoll_op contains EPOLLET, completion_port_add shall register the socket persistently, so that the EPOLL_THREAD_DATA object stays armed until completion_port_remove is called. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_012: [ If epoll_op contains EPOLLET, completion_port_add shall add the socket in the epoll system by calling epoll_ctl with EPOLL_CTL_ADD along with the epoll_op variable. ]
+TEST_FUNCTION(completion_port_add_with_EPOLLET_adds_the_socket_persistently)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    setup_completion_port_add_persistent_mocks();
+
+    //act
+    int result = completion_port_add(port_handle, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, test_port_event_complete, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, g_epoll_ctl_events);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_008: [ If epoll_ctl fails, completion_port_add shall move the EPOLL_THREAD_DATA object back to the list of free objects of the epoll thread. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_027: [ If any error occurs, completion_port_add shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_epoll_ctl_fails_completion_port_add_with_EPOLLET_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_ADD, test_socket, IGNORED_ARG))
+        .SetReturn(-1);
+    setup_release_thread_data();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    errno = EEXIST;
+    int result = completion_port_add(port_handle, EPOLLIN | EPOLLOUT | EPOLLET, test_socket, test_port_event_complete, test_callback_ctx);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_004: [ completion_port_add shall use the epoll instance of the epoll thread at the index socket modulo the number of epoll threads. ]
+TEST_FUNCTION(completion_port_add_with_3_threads_uses_the_epoll_instance_of_the_thread_of_the_socket)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_3_threads();
+    umock_c_reset_all_calls();
+
+    for (SOCKET_HANDLE socket = test_socket; socket < test_socket + 4; socket++)
+    {
+        setup_completion_port_add_mocks_for_epoll(10 + ((uint32_t)socket % 3), socket);
+    }
+
+    //act
+    for (SOCKET_HANDLE socket = test_socket; socket < test_socket + 4; socket++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, socket, test_port_event_complete, test_callback_ctx));
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// completion_port_remove
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_028: [ If completion_port is NULL, completion_port_remove shall return. ]
+TEST_FUNCTION(completion_port_remove_completion_port_NULL_fail)
+{
+    //arrange
+
+    //act
+    completion_port_remove(NULL, test_socket);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_029: [ If socket is INVALID_SOCKET, completion_port_remove shall return. ]
+TEST_FUNCTION(completion_port_remove_socket_INVALID_fail)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    //act
+    completion_port_remove(port_handle, INVALID_SOCKET);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_030: [ completion_port_remove shall remove the underlying socket from the epoll by calling epoll_ctl with EPOLL_CTL_DEL. ]
+TEST_FUNCTION(completion_port_remove_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    completion_port_remove(port_handle, test_socket);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_030: [ completion_port_remove shall remove the underlying socket from the epoll by calling epoll_ctl with EPOLL_CTL_DEL. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_039: [ If the event_callback is currently executing, completion_port_remove shall wait for the event_callback function to finish before completing. ]
+TEST_FUNCTION(completion_port_remove_callback_executing)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(TEST_COMPLETION_PORT_CALLBACK_EXECUTING);
+
+    STRICT_EXPECTED_CALL(InterlockedHL_WaitForValue(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(TEST_COMPLETION_PORT_CALLBACK_EXECUTED);
+    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    completion_port_remove(port_handle, test_socket);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_037: [ completion_port_remove shall call the event_callback with COMPLETION_PORT_EPOLL_ABANDONED for each armed EPOLL_THREAD_DATA object of socket, which it finds in the table of the armed objects of the sockets of the epoll thread at the index socket divided by the number of epoll threads. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_038: [ If the event_callback has not been called, completion_port_remove shall call the event_callback. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_009: [ completion_port_remove shall move the EPOLL_THREAD_DATA object from the armed objects of socket to the list of abandoned objects of the epoll thread. ]
+TEST_FUNCTION(completion_port_remove_port_event_callback_called_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
     ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    completion_port_remove(port_handle, test_socket);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_038: [ If the event_callback has not been called, completion_port_remove shall call the event_callback. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_009: [ completion_port_remove shall move the EPOLL_THREAD_DATA object from the armed objects of socket to the list of abandoned objects of the epoll thread. ]
+TEST_FUNCTION(completion_port_remove_abandons_a_persistent_registration)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLOUT | EPOLLET, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    completion_port_remove(port_handle, test_socket);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_037: [ completion_port_remove shall call the event_callback with COMPLETION_PORT_EPOLL_ABANDONED for each armed EPOLL_THREAD_DATA object of socket, which it finds in the table of the armed objects of the sockets of the epoll thread at the index socket divided by the number of epoll threads. ]
+TEST_FUNCTION(completion_port_remove_abandons_only_the_armed_objects_of_the_socket)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    void* other_callback_ctx = (void*)0x4245;
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket - 1, test_port_event_complete, other_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT, test_socket, test_port_event_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket + 1, test_port_event_complete, other_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED));
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    completion_port_remove(port_handle, test_socket);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_018: [ If the EPOLL_THREAD_DATA object is persistent and its event_callback is executing, completion_port_remove shall wait for the event_callback to return and then call the event_callback with COMPLETION_PORT_EPOLL_ABANDONED. ]
+TEST_FUNCTION(completion_port_remove_waits_for_the_executing_persistent_event_callback_and_abandons_the_registration)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLOUT | EPOLLET, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    // the epoll thread is executing the callback for an event
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(TEST_COMPLETION_PORT_CALLBACK_EXECUTING);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, TEST_COMPLETION_PORT_CALLBACK_EXECUTING, UINT32_MAX));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    completion_port_remove(port_handle, test_socket);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_005: [ completion_port_remove shall use the epoll instance of the epoll thread at the index socket modulo the number of epoll threads. ]
+TEST_FUNCTION(completion_port_remove_with_3_threads_uses_the_epoll_instance_of_the_thread_of_the_socket)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_3_threads();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_epoll_ctl(10 + ((uint32_t)(test_socket + 1) % 3), EPOLL_CTL_DEL, test_socket + 1, NULL));
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    completion_port_remove(port_handle, test_socket + 1);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// epoll worker func
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_031: [ If parameter is NULL, epoll_worker_func shall do nothing. ]
+TEST_FUNCTION(epoll_worker_func_parameter_NULL_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    //act
+    g_saved_worker_thread_func(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_032: [ epoll_worker_func shall call epoll_wait to wait for an epoll event to become signaled with a timeout of 2 Seconds. ]
+TEST_FUNCTION(epoll_worker_func_epoll_wait_timeout_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .SetReturn(0);
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_035: [ epoll_worker_func shall call the event_callback with the specified COMPLETION_PORT_EPOLL_ACTION that was returned. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_036: [ Then epoll_worker_func shall remove the EPOLL_THREAD_DATA from the armed objects of its socket and add it to the list of free objects of the epoll thread. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_033: [ On a epoll_wait timeout epoll_worker_func shall ensure it should not exit and issue another epoll_wait. ]
+TEST_FUNCTION(epoll_worker_func_epoll_wait_EPOLLRDHUP_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    g_events[0].events = 0;
+    g_events[0].events |= EPOLLRDHUP;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_thread_data();
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_035: [ epoll_worker_func shall call the event_callback with the specified COMPLETION_PORT_EPOLL_ACTION that was returned. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_036: [ Then epoll_worker_func shall remove the EPOLL_THREAD_DATA from the armed objects of its socket and add it to the list of free objects of the epoll thread. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_033: [ On a epoll_wait timeout epoll_worker_func shall ensure it should not exit and issue another epoll_wait. ]
+TEST_FUNCTION(epoll_worker_func_epoll_wait_EPOLLIN_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    g_events[0].events = 0;
+    g_events[0].events |= EPOLLIN;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_thread_data();
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_035: [ epoll_worker_func shall call the event_callback with the specified COMPLETION_PORT_EPOLL_ACTION that was returned. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_036: [ Then epoll_worker_func shall remove the EPOLL_THREAD_DATA from the armed objects of its socket and add it to the list of free objects of the epoll thread. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_11_033: [ On a epoll_wait timeout epoll_worker_func shall ensure it should not exit and issue another epoll_wait. ]
+TEST_FUNCTION(epoll_worker_func_epoll_wait_EPOLLOUT_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    g_events[0].events = 0;
+    g_events[0].events |= EPOLLOUT;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_thread_data();
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_034: [ epoll_worker_func shall loop through the num of descriptors that was returned. ]
+TEST_FUNCTION(epoll_worker_func_epoll_wait_multiple_values_success)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT, test_socket, test_port_event_complete, test_callback_ctx));
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    g_events[0].events = 0;
+    g_events[0].events |= EPOLLOUT;
+    g_events[1].events = 0;
+    g_events[1].events |= EPOLLRDHUP;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event)*2)
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_thread_data();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_thread_data();
+
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_010: [ After handling the events, epoll_worker_func shall move the EPOLL_THREAD_DATA objects abandoned by completion_port_remove to the list of free objects of the epoll thread. ]
+TEST_FUNCTION(epoll_worker_func_reuses_the_thread_data_abandoned_by_completion_port_remove_only_after_handling_the_events)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx));
+    completion_port_remove(port_handle, test_socket);
+    umock_c_reset_all_calls();
+
+    // the event was returned by epoll_wait before the socket was removed
+    g_events[0].events = EPOLLIN;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_013: [ If the EPOLL_THREAD_DATA object is persistent, epoll_worker_func shall do the following: ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_014: [ epoll_worker_func shall call the event_callback with COMPLETION_PORT_EPOLL_EPOLLRDHUP if the events contain EPOLLRDHUP, otherwise with COMPLETION_PORT_EPOLL_EPOLLIN if the events contain EPOLLIN, EPOLLERR or EPOLLHUP. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_015: [ epoll_worker_func shall then call the event_callback with COMPLETION_PORT_EPOLL_EPOLLOUT if the events contain EPOLLOUT, EPOLLERR or EPOLLHUP. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_016: [ epoll_worker_func shall keep the EPOLL_THREAD_DATA object in the armed objects of its socket so that the event_callback is called for the following events. ]
+TEST_FUNCTION(epoll_worker_func_calls_the_persistent_event_callback_for_every_event)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    // the socket becomes readable and writable, then readable again
+    g_events[0].events = EPOLLIN | EPOLLOUT;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_014: [ epoll_worker_func shall call the event_callback with COMPLETION_PORT_EPOLL_EPOLLRDHUP if the events contain EPOLLRDHUP, otherwise with COMPLETION_PORT_EPOLL_EPOLLIN if the events contain EPOLLIN, EPOLLERR or EPOLLHUP. ]
+TEST_FUNCTION(epoll_worker_func_calls_the_persistent_event_callback_with_EPOLLRDHUP)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    g_events[0].events = EPOLLIN | EPOLLRDHUP;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_014: [ epoll_worker_func shall call the event_callback with COMPLETION_PORT_EPOLL_EPOLLRDHUP if the events contain EPOLLRDHUP, otherwise with COMPLETION_PORT_EPOLL_EPOLLIN if the events contain EPOLLIN, EPOLLERR or EPOLLHUP. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_015: [ epoll_worker_func shall then call the event_callback with COMPLETION_PORT_EPOLL_EPOLLOUT if the events contain EPOLLOUT, EPOLLERR or EPOLLHUP. ]
+TEST_FUNCTION(epoll_worker_func_calls_the_persistent_event_callback_with_EPOLLIN_and_EPOLLOUT_for_EPOLLERR)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, test_socket, test_port_event_complete, test_callback_ctx));
+    umock_c_reset_all_calls();
+
+    g_events[0].events = EPOLLERR;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN));
+    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_017: [ epoll_worker_func shall not call the event_callback once completion_port_remove called it with COMPLETION_PORT_EPOLL_ABANDONED. ]
+TEST_FUNCTION(epoll_worker_func_does_not_call_the_persistent_event_callback_after_completion_port_remove)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLOUT | EPOLLET, test_socket, test_port_event_complete, test_callback_ctx));
+    completion_port_remove(port_handle, test_socket);
+    umock_c_reset_all_calls();
+
+    // the event was returned by epoll_wait before the socket was removed
+    g_events[0].events = EPOLLIN;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_11_032: [ epoll_worker_func shall call epoll_wait to wait for an epoll event to become signaled with a timeout of 2 Seconds. ]
+TEST_FUNCTION(epoll_worker_func_with_3_threads_waits_on_the_epoll_instance_of_its_thread)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_3_threads();
+    umock_c_reset_all_calls();
+
+    // the last created thread runs on the last epoll instance
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(12, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .SetReturn(0);
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_029: [ If the event is for the io_uring of the epoll thread, epoll_worker_func shall consume all the completions in its completion queue. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_030: [ For each completion, epoll_worker_func shall call the on_io_complete callback of the COMPLETION_PORT_IO with on_io_complete_context and the result of the operation. ]
+TEST_FUNCTION(epoll_worker_func_with_IO_URING_calls_on_io_complete_for_each_completion)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+
+    COMPLETION_PORT_IO io_1 = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = (void*)0x4301 };
+    COMPLETION_PORT_IO io_2 = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = (void*)0x4302 };
+    add_test_cqe(&io_1, 42);
+    add_test_cqe(NULL, 0); // the completion of a cancel request
+    add_test_cqe(&io_2, -ECANCELED);
+    g_events[0].events = EPOLLIN;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_io_complete((void*)0x4301, 42));
+    STRICT_EXPECTED_CALL(test_on_io_complete((void*)0x4302, -ECANCELED));
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, g_test_rings.cq_head);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_031: [ If the completion queue is empty and the kernel kept completions that did not fit in it, epoll_worker_func shall call io_uring_enter with IORING_ENTER_GETEVENTS to move them to the completion queue. ]
+TEST_FUNCTION(epoll_worker_func_with_IO_URING_moves_the_overflowed_completions_to_the_completion_queue)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+
+    COMPLETION_PORT_IO io_1 = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = (void*)0x4301 };
+    COMPLETION_PORT_IO io_2 = { .io_type = COMPLETION_PORT_IO_TYPE_POLL, .poll_events = POLLIN, .on_io_complete = test_on_io_complete, .on_io_complete_context = (void*)0x4302 };
+    add_test_cqe(&io_1, 42);
+    g_overflowed_cqe.user_data = (uint64_t)(uintptr_t)&io_2;
+    g_overflowed_cqe.res = POLLIN;
+    g_has_overflowed_cqe = true;
+    g_test_rings.sq_flags = IORING_SQ_CQ_OVERFLOW;
+    g_events[0].events = EPOLLIN;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_io_complete((void*)0x4301, 42));
+    STRICT_EXPECTED_CALL(mocked_io_uring_enter(g_test_ring_fd, 0, 0, IORING_ENTER_GETEVENTS));
+    STRICT_EXPECTED_CALL(test_on_io_complete((void*)0x4302, POLLIN));
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, g_test_rings.cq_head);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_060: [ If the io_type of the COMPLETION_PORT_IO is COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, epoll_worker_func shall first set its has_buffer and buffer_id from the IORING_CQE_F_BUFFER flag and the buffer id of the completion, and its has_more from the IORING_CQE_F_MORE flag. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_030: [ For each completion, epoll_worker_func shall call the on_io_complete callback of the COMPLETION_PORT_IO with on_io_complete_context and the result of the operation. ]
+TEST_FUNCTION(epoll_worker_func_with_IO_URING_sets_the_buffer_of_the_completions_of_a_receive_of_a_buffer_ring)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+
+    COMPLETION_PORT_IO io_1 = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, .buffer_ring = (COMPLETION_PORT_BUFFER_RING_HANDLE)0x4247, .is_multishot = true, .on_io_complete = test_on_io_complete, .on_io_complete_context = (void*)0x4301 };
+    COMPLETION_PORT_IO io_2 = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, .buffer_ring = (COMPLETION_PORT_BUFFER_RING_HANDLE)0x4247, .is_multishot = true, .on_io_complete = test_on_io_complete, .on_io_complete_context = (void*)0x4302, .has_buffer = true, .has_more = true };
+    add_test_cqe_with_flags(&io_1, 42, IORING_CQE_F_BUFFER | IORING_CQE_F_MORE | (3 << IORING_CQE_BUFFER_SHIFT));
+    add_test_cqe_with_flags(&io_2, -ENOBUFS, 0);
+    g_events[0].events = EPOLLIN;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(test_on_io_complete((void*)0x4301, 42));
+    STRICT_EXPECTED_CALL(test_on_io_complete((void*)0x4302, -ENOBUFS));
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(io_1.has_buffer);
+    ASSERT_ARE_EQUAL(uint16_t, 3, io_1.buffer_id);
+    ASSERT_IS_TRUE(io_1.has_more);
+    // the final completion of the receive carries no buffer
+    ASSERT_IS_FALSE(io_2.has_buffer);
+    ASSERT_IS_FALSE(io_2.has_more);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_058: [ If it is called by the epoll thread from an on_io_complete callback, completion_port_submit_io shall only queue the entry, which the epoll thread submits with the other entries queued by the callbacks once it consumed the completions. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_059: [ After consuming the completions, epoll_worker_func shall submit the entries queued by the on_io_complete callbacks with a single call to io_uring_enter. ]
+TEST_FUNCTION(epoll_worker_func_with_IO_URING_submits_the_operations_of_the_callbacks_with_one_io_uring_enter)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    g_submitting_port = port_handle;
+    umock_c_reset_all_calls();
+
+    COMPLETION_PORT_IO next_io_1 = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = (void*)0x4303 };
+    COMPLETION_PORT_IO next_io_2 = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = (void*)0x4304 };
+    COMPLETION_PORT_IO io_1 = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete_submitting_the_next_io, .on_io_complete_context = &next_io_1 };
+    COMPLETION_PORT_IO io_2 = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE, .message = &test_message, .on_io_complete = test_on_io_complete_submitting_the_next_io, .on_io_complete_context = &next_io_2 };
+    add_test_cqe(&io_1, 42);
+    add_test_cqe(&io_2, 43);
+    g_events[0].events = EPOLLIN;
+
+    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
+        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
+        .SetReturn(1);
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(test_on_io_complete_submitting_the_next_io(IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(mocked_io_uring_enter(g_test_ring_fd, 2, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    setup_release_abandoned_data();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, g_test_rings.sq_tail);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&next_io_1, g_test_sqes[0].user_data);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&next_io_2, g_test_sqes[1].user_data);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// completion_port_submit_io
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_032: [ If completion_port is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_NULL_completion_port_fails)
+{
+    //arrange
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_submit_io(NULL, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_033: [ If socket is INVALID_SOCKET, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_INVALID_SOCKET_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_submit_io(port_handle, INVALID_SOCKET, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_034: [ If io is NULL or its on_io_complete is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_NULL_io_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_034: [ If io is NULL or its on_io_complete is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_NULL_on_io_complete_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = NULL, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_035: [ If the io_type of io is not COMPLETION_PORT_IO_TYPE_SEND, COMPLETION_PORT_IO_TYPE_RECEIVE, COMPLETION_PORT_IO_TYPE_POLL or COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_invalid_io_type_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = (COMPLETION_PORT_IO_TYPE)(COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING + 1), .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_036: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_SEND or COMPLETION_PORT_IO_TYPE_RECEIVE and its message is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_NULL_message_for_a_send_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = NULL, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_036: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_SEND or COMPLETION_PORT_IO_TYPE_RECEIVE and its message is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_NULL_message_for_a_receive_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE, .message = NULL, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_061: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING and its buffer_ring is NULL, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_NULL_buffer_ring_for_a_receive_of_a_buffer_ring_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, .buffer_ring = NULL, .is_multishot = true, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_037: [ If the engine of completion_port is not COMPLETION_PORT_ENGINE_IO_URING, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_submit_io_with_EPOLL_completion_port_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
+    ASSERT_IS_NOT_NULL(port_handle);
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_038: [ completion_port_submit_io shall ensure the thread completion flag is not set. ]
+TEST_FUNCTION(completion_port_submit_io_while_the_completion_port_is_destroyed_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_038: [ completion_port_submit_io shall ensure the thread completion flag is not set. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_039: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_SEND, completion_port_submit_io shall prepare an IORING_OP_SENDMSG operation for the message of io with the MSG_NOSIGNAL flag. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_042: [ completion_port_submit_io shall increment the ongoing call count value to prevent close. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_043: [ completion_port_submit_io shall copy the operation with io as user data in the next submission queue entry of the io_uring of the epoll thread at the index socket modulo the number of epoll threads and submit it, along with the entries queued by the on_io_complete callbacks, by calling io_uring_enter. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_045: [ completion_port_submit_io shall decrement the ongoing call count value to unblock close. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_046: [ On success, completion_port_submit_io shall return 0. ]
+TEST_FUNCTION(completion_port_submit_io_submits_a_send)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_sqe_mocks();
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, g_test_rings.sq_tail);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g_test_rings.sq_array[0]);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_SENDMSG, g_test_sqes[0].opcode);
+    ASSERT_ARE_EQUAL(int32_t, test_socket, g_test_sqes[0].fd);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&test_message, g_test_sqes[0].addr);
+    ASSERT_ARE_EQUAL(uint32_t, 1, g_test_sqes[0].len);
+    ASSERT_ARE_EQUAL(uint32_t, MSG_NOSIGNAL, g_test_sqes[0].msg_flags);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&io, g_test_sqes[0].user_data);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_040: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_RECEIVE, completion_port_submit_io shall prepare an IORING_OP_RECVMSG operation for the message of io. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_043: [ completion_port_submit_io shall copy the operation with io as user data in the next submission queue entry of the io_uring of the epoll thread at the index socket modulo the number of epoll threads and submit it, along with the entries queued by the on_io_complete callbacks, by calling io_uring_enter. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_046: [ On success, completion_port_submit_io shall return 0. ]
+TEST_FUNCTION(completion_port_submit_io_submits_a_receive_in_the_next_submission_queue_entry)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    g_test_rings.sq_head = TEST_SQ_ENTRIES + 1;
+    g_test_rings.sq_tail = TEST_SQ_ENTRIES + 1;
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_sqe_mocks();
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_SQ_ENTRIES + 2, g_test_rings.sq_tail);
+    ASSERT_ARE_EQUAL(uint32_t, 1, g_test_rings.sq_array[1]);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_RECVMSG, g_test_sqes[1].opcode);
+    ASSERT_ARE_EQUAL(int32_t, test_socket, g_test_sqes[1].fd);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&test_message, g_test_sqes[1].addr);
+    ASSERT_ARE_EQUAL(uint32_t, 1, g_test_sqes[1].len);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g_test_sqes[1].msg_flags);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&io, g_test_sqes[1].user_data);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_041: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_POLL, completion_port_submit_io shall prepare an IORING_OP_POLL_ADD operation for the poll_events of io. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_046: [ On success, completion_port_submit_io shall return 0. ]
+TEST_FUNCTION(completion_port_submit_io_submits_a_poll)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_POLL, .poll_events = POLLOUT, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_sqe_mocks();
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_POLL_ADD, g_test_sqes[0].opcode);
+    ASSERT_ARE_EQUAL(int32_t, test_socket, g_test_sqes[0].fd);
+    ASSERT_ARE_EQUAL(uint32_t, POLLOUT, g_test_sqes[0].poll32_events);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&io, g_test_sqes[0].user_data);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_062: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, completion_port_submit_io shall prepare an IORING_OP_RECV operation with IOSQE_BUFFER_SELECT that receives into a buffer picked from the buffer group of buffer_ring, with IORING_RECV_MULTISHOT if is_multishot is true. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_046: [ On success, completion_port_submit_io shall return 0. ]
+TEST_FUNCTION(completion_port_submit_io_submits_a_multishot_receive_of_a_buffer_ring)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = create_buffer_ring(port_handle);
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, .buffer_ring = buffer_ring, .is_multishot = true, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_sqe_mocks();
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_RECV, g_test_sqes[0].opcode);
+    ASSERT_ARE_EQUAL(int32_t, test_socket, g_test_sqes[0].fd);
+    ASSERT_ARE_EQUAL(uint8_t, IOSQE_BUFFER_SELECT, g_test_sqes[0].flags);
+    ASSERT_ARE_EQUAL(uint16_t, g_test_buffer_registration.bgid, g_test_sqes[0].buf_group);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g_test_sqes[0].len);
+    ASSERT_ARE_EQUAL(uint16_t, IORING_RECV_MULTISHOT, g_test_sqes[0].ioprio);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&io, g_test_sqes[0].user_data);
+
+    // cleanup
+    completion_port_buffer_ring_destroy(buffer_ring);
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_062: [ If the io_type of io is COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, completion_port_submit_io shall prepare an IORING_OP_RECV operation with IOSQE_BUFFER_SELECT that receives into a buffer picked from the buffer group of buffer_ring, with IORING_RECV_MULTISHOT if is_multishot is true. ]
+TEST_FUNCTION(completion_port_submit_io_submits_a_single_shot_receive_of_a_buffer_ring)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = create_buffer_ring(port_handle);
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE_BUFFER_RING, .buffer_ring = buffer_ring, .is_multishot = false, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_sqe_mocks();
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_RECV, g_test_sqes[0].opcode);
+    ASSERT_ARE_EQUAL(uint8_t, IOSQE_BUFFER_SELECT, g_test_sqes[0].flags);
+    ASSERT_ARE_EQUAL(uint16_t, g_test_buffer_registration.bgid, g_test_sqes[0].buf_group);
+    ASSERT_ARE_EQUAL(uint16_t, 0, g_test_sqes[0].ioprio);
+
+    // cleanup
+    completion_port_buffer_ring_destroy(buffer_ring);
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_044: [ If the submission queue is still full after submitting the entries queued by the on_io_complete callbacks or io_uring_enter does not submit the entry, completion_port_submit_io shall take the entry back and fail. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_045: [ completion_port_submit_io shall decrement the ongoing call count value to unblock close. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_047: [ If any error occurs, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_io_uring_enter_fails_completion_port_submit_io_takes_the_entry_back_and_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(mocked_io_uring_enter(g_test_ring_fd, 1, 0, 0))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g_test_rings.sq_tail);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_044: [ If the submission queue is still full after submitting the entries queued by the on_io_complete callbacks or io_uring_enter does not submit the entry, completion_port_submit_io shall take the entry back and fail. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_047: [ If any error occurs, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_io_uring_enter_does_not_submit_the_entry_completion_port_submit_io_takes_the_entry_back_and_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_RECEIVE, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(mocked_close(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(s_list_remove_head(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(mocked_io_uring_enter(g_test_ring_fd, 1, 0, 0))
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g_test_rings.sq_tail);
+
+    // cleanup
     completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_044: [ If the submission queue is still full after submitting the entries queued by the on_io_complete callbacks or io_uring_enter does not submit the entry, completion_port_submit_io shall take the entry back and fail. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_047: [ If any error occurs, completion_port_submit_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_the_submission_queue_is_full_completion_port_submit_io_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    g_test_rings.sq_tail = TEST_SQ_ENTRIES;
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    // the kernel does not consume the queued entries
+    STRICT_EXPECTED_CALL(mocked_io_uring_enter(g_test_ring_fd, TEST_SQ_ENTRIES, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    int result = completion_port_submit_io(port_handle, test_socket, &io);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_SQ_ENTRIES, g_test_rings.sq_tail);
 
     // cleanup
+    completion_port_dec_ref(port_handle);
 }
 
-// completion_port_add
+// completion_port_cancel_io
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_016: [ If completion_port is NULL, completion_port_add shall return a non-zero value. ]
-TEST_FUNCTION(completion_port_add_handle_NULL_fail)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_048: [ If completion_port is NULL, completion_port_cancel_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_cancel_io_with_NULL_completion_port_fails)
 {
     //arrange
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
 
     //act
-    int result = completion_port_add(NULL, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+    int result = completion_port_cancel_io(NULL, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_049: [ If socket is INVALID_SOCKET, completion_port_cancel_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_cancel_io_with_INVALID_SOCKET_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    //act
+    int result = completion_port_cancel_io(port_handle, INVALID_SOCKET, &io);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
+    completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_018: [ If event_callback is NULL, completion_port_add shall return a non-zero value. ]
-TEST_FUNCTION(completion_port_add_event_callback_NULL_fail)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_050: [ If io is NULL, completion_port_cancel_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_cancel_io_with_NULL_io_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
     umock_c_reset_all_calls();
 
     //act
-    int result = completion_port_add(port_handle, EPOLLIN, test_socket, NULL, test_callback_ctx);
+    int result = completion_port_cancel_io(port_handle, test_socket, NULL);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -377,16 +2898,17 @@ TEST_FUNCTION(completion_port_add_event_callback_NULL_fail)
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_017: [ If socket is INVALID_SOCKET, completion_port_add shall return a non-zero value. ]
-TEST_FUNCTION(completion_port_add_socket_handle_INVALID_fail)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_051: [ If the engine of completion_port is not COMPLETION_PORT_ENGINE_IO_URING, completion_port_cancel_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_cancel_io_with_EPOLL_completion_port_fails)
 {
     //arrange
     COMPLETION_PORT_HANDLE port_handle = completion_port_create();
     ASSERT_IS_NOT_NULL(port_handle);
     umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
 
     //act
-    int result = completion_port_add(port_handle, EPOLLIN, INVALID_SOCKET, test_port_event_complete, test_callback_ctx);
+    int result = completion_port_cancel_io(port_handle, test_socket, &io);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -396,327 +2918,388 @@ TEST_FUNCTION(completion_port_add_socket_handle_INVALID_fail)
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_019: [ completion_port_add shall ensure the thread completion flag is not set. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_020: [ completion_port_add shall increment the ongoing call count value to prevent close. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_021: [ completion_port_add shall allocate a EPOLL_THREAD_DATA object to store thread data. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_022: [ completion_port_add shall add the EPOLL_THREAD_DATA object to a list for later removal. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_023: [ completion_port_add shall add the socket in the epoll system by calling epoll_ctl with EPOLL_CTL_MOD along with the epoll_op variable. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_025: [ completion_port_add shall decrement the ongoing call count value to unblock close. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_026: [ On success, completion_port_add shall return 0. ]
-TEST_FUNCTION(completion_port_add_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_052: [ completion_port_cancel_io shall ensure the thread completion flag is not set. ]
+TEST_FUNCTION(completion_port_cancel_io_while_the_completion_port_is_destroyed_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
     umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
 
-    setup_completion_port_add_mocks();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
 
     //act
-    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+    int result = completion_port_cancel_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_053: [ completion_port_cancel_io shall submit an IORING_OP_ASYNC_CANCEL operation for the user data io to the io_uring of the epoll thread at the index socket modulo the number of epoll threads, without user data so that its own completion is not reported. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_054: [ On success, completion_port_cancel_io shall return 0. ]
+TEST_FUNCTION(completion_port_cancel_io_submits_a_cancel_for_io)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_sqe_mocks();
+
+    //act
+    int result = completion_port_cancel_io(port_handle, test_socket, &io);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_ASYNC_CANCEL, g_test_sqes[0].opcode);
+    ASSERT_ARE_EQUAL(int32_t, -1, g_test_sqes[0].fd);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)&io, g_test_sqes[0].addr);
+    ASSERT_ARE_EQUAL(uint64_t, 0, g_test_sqes[0].user_data);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_055: [ If any error occurs, completion_port_cancel_io shall fail and return a non-zero value. ]
+TEST_FUNCTION(when_io_uring_enter_fails_completion_port_cancel_io_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+    COMPLETION_PORT_IO io = { .io_type = COMPLETION_PORT_IO_TYPE_SEND, .message = &test_message, .on_io_complete = test_on_io_complete, .on_io_complete_context = test_io_context };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(mocked_io_uring_enter(g_test_ring_fd, 1, 0, 0))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    //act
+    int result = completion_port_cancel_io(port_handle, test_socket, &io);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g_test_rings.sq_tail);
 
     // cleanup
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_027: [ If any error occurs, completion_port_add shall fail and return a non-zero value. ]
-TEST_FUNCTION(completion_port_add_fail)
+// completion_port_buffer_ring_create
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_063: [ If completion_port is NULL, completion_port_buffer_ring_create shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_buffer_ring_create_with_NULL_completion_port_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
+
+    //act
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(NULL, test_socket, TEST_RING_BUFFERS);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_ring);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_064: [ If socket is INVALID_SOCKET, completion_port_buffer_ring_create shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_buffer_ring_create_with_INVALID_SOCKET_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
     umock_c_reset_all_calls();
 
-    setup_completion_port_add_mocks();
+    //act
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, INVALID_SOCKET, TEST_RING_BUFFERS);
 
-    umock_c_negative_tests_snapshot();
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_ring);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_065: [ If buffer_count is 0, is not a power of 2 or is greater than 32768, completion_port_buffer_ring_create shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_buffer_ring_create_with_0_buffer_count_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
 
     //act
-    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
-    {
-        if (umock_c_negative_tests_can_call_fail(index))
-        {
-            umock_c_negative_tests_reset();
-            umock_c_negative_tests_fail_call(index);
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, 0);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_ring);
+
+    // cleanup
+    completion_port_dec_ref(port_handle);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_065: [ If buffer_count is 0, is not a power of 2 or is greater than 32768, completion_port_buffer_ring_create shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_buffer_ring_create_with_a_buffer_count_that_is_not_a_power_of_2_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
 
-            errno = EACCES;
-            int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
+    //act
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, 3);
 
-            //assert
-            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", index);
-        }
-    }
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_ring);
 
     // cleanup
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_019: [ completion_port_add shall ensure the thread completion flag is not set. ]
-TEST_FUNCTION(completion_port_add_dec_ref_running_fail)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_065: [ If buffer_count is 0, is not a power of 2 or is greater than 32768, completion_port_buffer_ring_create shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_buffer_ring_create_with_more_than_32768_buffers_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
-        .SetReturn(1);
-
     //act
-    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, 65536);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_ring);
 
     // cleanup
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_024: [ If the epoll_ctl call fails with ENOENT, completion_port_add shall call epoll_ctl again with EPOLL_CTL_ADD. ]
-TEST_FUNCTION(completion_port_add_epoll_add_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_066: [ If the engine of completion_port is not COMPLETION_PORT_ENGINE_IO_URING, completion_port_buffer_ring_create shall fail and return NULL. ]
+TEST_FUNCTION(completion_port_buffer_ring_create_with_EPOLL_completion_port_fails)
 {
     //arrange
     COMPLETION_PORT_HANDLE port_handle = completion_port_create();
     ASSERT_IS_NOT_NULL(port_handle);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(s_list_add(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_MOD, test_socket, IGNORED_ARG))
-        .SetReturn(-1);
-    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_ADD, test_socket, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-
     //act
-    errno = ENOENT;
-    int result = completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx);
-    ASSERT_ARE_EQUAL(int, 0, result);
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, TEST_RING_BUFFERS);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_ring);
 
     // cleanup
     completion_port_dec_ref(port_handle);
 }
 
-// completion_port_remove
-
-// Tests_SRS_COMPLETION_PORT_LINUX_11_028: [ If completion_port is NULL, completion_port_remove shall return. ]
-TEST_FUNCTION(completion_port_remove_completion_port_NULL_fail)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_067: [ completion_port_buffer_ring_create shall ensure the thread completion flag is not set. ]
+TEST_FUNCTION(completion_port_buffer_ring_create_while_the_completion_port_is_destroyed_fails)
 {
     //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
 
     //act
-    completion_port_remove(NULL, test_socket);
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, TEST_RING_BUFFERS);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_ring);
 
     // cleanup
+    completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_029: [ If socket is INVALID_SOCKET, completion_port_remove shall return. ]
-TEST_FUNCTION(completion_port_remove_socket_INVALID_fail)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_067: [ completion_port_buffer_ring_create shall ensure the thread completion flag is not set. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_068: [ completion_port_buffer_ring_create shall allocate memory for the buffer ring. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_069: [ completion_port_buffer_ring_create shall map page aligned memory for buffer_count entries with mmap, which the kernel shares with the process. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_070: [ completion_port_buffer_ring_create shall register the entries as the buffer group of the next buffer group id of the io_uring of the epoll thread at the index socket modulo the number of epoll threads by calling io_uring_register with IORING_REGISTER_PBUF_RING. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_072: [ On success, completion_port_buffer_ring_create shall return the buffer ring. ]
+TEST_FUNCTION(completion_port_buffer_ring_create_registers_the_buffer_ring_with_the_io_uring)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
     umock_c_reset_all_calls();
 
+    setup_completion_port_buffer_ring_create_mocks();
+
     //act
-    completion_port_remove(port_handle, INVALID_SOCKET);
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, TEST_RING_BUFFERS);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(buffer_ring);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)g_test_ring_buffers, g_test_buffer_registration.ring_addr);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_RING_BUFFERS, g_test_buffer_registration.ring_entries);
+    ASSERT_ARE_EQUAL(uint16_t, 1, g_test_buffer_registration.bgid);
 
     // cleanup
+    completion_port_buffer_ring_destroy(buffer_ring);
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_030: [ completion_port_remove shall remove the underlying socket from the epoll by calling epoll_ctl with EPOLL_CTL_DEL. ]
-TEST_FUNCTION(completion_port_remove_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_071: [ If the buffer group id is already registered, completion_port_buffer_ring_create shall try the next buffer group id. ]
+TEST_FUNCTION(when_the_buffer_group_id_is_already_registered_completion_port_buffer_ring_create_registers_the_next_one)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
     umock_c_reset_all_calls();
+    g_io_uring_register_errno = EEXIST;
 
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, TEST_RING_BUFFERS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
-
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_io_uring_register(g_test_ring_fd, IORING_REGISTER_PBUF_RING, IGNORED_ARG, 1))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_io_uring_register(g_test_ring_fd, IORING_REGISTER_PBUF_RING, IGNORED_ARG, 1));
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
 
     //act
-    completion_port_remove(port_handle, test_socket);
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, TEST_RING_BUFFERS);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(buffer_ring);
+    ASSERT_ARE_EQUAL(uint16_t, 2, g_test_buffer_registration.bgid);
 
     // cleanup
+    completion_port_buffer_ring_destroy(buffer_ring);
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_030: [ completion_port_remove shall remove the underlying socket from the epoll by calling epoll_ctl with EPOLL_CTL_DEL. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_039: [ If the event_callback is currently executing, completion_port_remove shall wait for the event_callback function to finish before completing. ]
-TEST_FUNCTION(completion_port_remove_callback_executing)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_073: [ If any error occurs, completion_port_buffer_ring_create shall fail and return NULL. ]
+TEST_FUNCTION(when_the_kernel_does_not_support_provided_buffer_rings_completion_port_buffer_ring_create_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
     umock_c_reset_all_calls();
+    g_io_uring_register_errno = EINVAL;
 
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, TEST_RING_BUFFERS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .SetReturn(TEST_COMPLETION_PORT_CALLBACK_EXECUTING);
-
-    STRICT_EXPECTED_CALL(InterlockedHL_WaitForValue(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .SetReturn(TEST_COMPLETION_PORT_CALLBACK_EXECUTED);
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_io_uring_register(g_test_ring_fd, IORING_REGISTER_PBUF_RING, IGNORED_ARG, 1))
+        .SetReturn(-1);
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
     STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_munmap(g_test_ring_buffers, TEST_RING_BUFFERS * sizeof(struct io_uring_buf)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     //act
-    completion_port_remove(port_handle, test_socket);
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, TEST_RING_BUFFERS);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(buffer_ring);
 
     // cleanup
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_037: [ completion_port_remove shall loop through the list of EPOLL_THREAD_DATA object and call the event_callback with COMPLETION_PORT_EPOLL_ABANDONED ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_038: [ If the event_callback has not been called, completion_port_remove shall call the event_callback. ]
-TEST_FUNCTION(completion_port_remove_port_event_callback_called_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_073: [ If any error occurs, completion_port_buffer_ring_create shall fail and return NULL. ]
+TEST_FUNCTION(when_underlying_calls_fail_completion_port_buffer_ring_create_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_epoll_ctl(g_test_epoll, EPOLL_CTL_DEL, test_socket, NULL));
+    setup_completion_port_buffer_ring_create_mocks();
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_ABANDONED));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    umock_c_negative_tests_snapshot();
 
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    for (size_t index = 0; index < umock_c_negative_tests_call_count(); index++)
+    {
+        if (umock_c_negative_tests_can_call_fail(index))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(index);
 
-    //act
-    completion_port_remove(port_handle, test_socket);
+            //act
+            COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = completion_port_buffer_ring_create(port_handle, test_socket, TEST_RING_BUFFERS);
 
-    //assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+            //assert
+            ASSERT_IS_NULL(buffer_ring, "On failed call %zu", index);
+        }
+    }
 
     // cleanup
     completion_port_dec_ref(port_handle);
 }
 
-// epoll worker func
+// completion_port_buffer_ring_destroy
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_031: [ If parameter is NULL, epoll_worker_func shall do nothing. ]
-TEST_FUNCTION(epoll_worker_func_parameter_NULL_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_074: [ If buffer_ring is NULL, completion_port_buffer_ring_destroy shall return. ]
+TEST_FUNCTION(completion_port_buffer_ring_destroy_with_NULL_buffer_ring_returns)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
 
     //act
-    g_saved_worker_thread_func(NULL);
+    completion_port_buffer_ring_destroy(NULL);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    // cleanup
-    completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_032: [ epoll_worker_func shall call epoll_wait to wait for an epoll event to become signaled with a timeout of 2 Seconds. ]
-TEST_FUNCTION(epoll_worker_func_epoll_wait_timeout_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_075: [ completion_port_buffer_ring_destroy shall unregister the buffer group by calling io_uring_register with IORING_UNREGISTER_PBUF_RING. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_076: [ completion_port_buffer_ring_destroy shall unmap the entries and free the buffer ring. ]
+TEST_FUNCTION(completion_port_buffer_ring_destroy_unregisters_the_buffer_group_and_frees_the_buffer_ring)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = create_buffer_ring(port_handle);
+    (void)memset(&g_test_buffer_registration, 0, sizeof(g_test_buffer_registration));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
-        .SetReturn(0);
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
-        .SetReturn(1);
+    STRICT_EXPECTED_CALL(mocked_io_uring_register(g_test_ring_fd, IORING_UNREGISTER_PBUF_RING, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(mocked_munmap(g_test_ring_buffers, TEST_RING_BUFFERS * sizeof(struct io_uring_buf)));
+    STRICT_EXPECTED_CALL(free(buffer_ring));
 
     //act
-    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    completion_port_buffer_ring_destroy(buffer_ring);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint16_t, 1, g_test_buffer_registration.bgid);
 
     // cleanup
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_035: [ epoll_worker_func shall call the event_callback with the specified COMPLETION_PORT_EPOLL_ACTION that was returned. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_036: [ Then epoll_worker_func shall remove the EPOLL_THREAD_DATA from the list and free the object. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_033: [ On a epoll_wait timeout epoll_worker_func shall ensure it should not exit and issue another epoll_wait. ]
-TEST_FUNCTION(epoll_worker_func_epoll_wait_EPOLLRDHUP_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_076: [ completion_port_buffer_ring_destroy shall unmap the entries and free the buffer ring. ]
+TEST_FUNCTION(when_unregistering_the_buffer_group_fails_completion_port_buffer_ring_destroy_still_frees_the_buffer_ring)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN | EPOLLRDHUP, test_socket, test_port_event_complete, test_callback_ctx));
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = create_buffer_ring(port_handle);
     umock_c_reset_all_calls();
 
-    g_events[0].events = 0;
-    g_events[0].events |= EPOLLRDHUP;
-
-    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
-        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
-        .SetReturn(1);
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-    setup_remove_thread_data();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
-        .SetReturn(1);
+    STRICT_EXPECTED_CALL(mocked_io_uring_register(g_test_ring_fd, IORING_UNREGISTER_PBUF_RING, IGNORED_ARG, 1))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_munmap(g_test_ring_buffers, TEST_RING_BUFFERS * sizeof(struct io_uring_buf)));
+    STRICT_EXPECTED_CALL(free(buffer_ring));
 
     //act
-    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    completion_port_buffer_ring_destroy(buffer_ring);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -725,122 +3308,123 @@ TEST_FUNCTION(epoll_worker_func_epoll_wait_EPOLLRDHUP_success)
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_035: [ epoll_worker_func shall call the event_callback with the specified COMPLETION_PORT_EPOLL_ACTION that was returned. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_036: [ Then epoll_worker_func shall remove the EPOLL_THREAD_DATA from the list and free the object. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_033: [ On a epoll_wait timeout epoll_worker_func shall ensure it should not exit and issue another epoll_wait. ]
-TEST_FUNCTION(epoll_worker_func_epoll_wait_EPOLLIN_success)
+// completion_port_buffer_ring_add
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_077: [ If buffer_ring is NULL, completion_port_buffer_ring_add shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_buffer_ring_add_with_NULL_buffer_ring_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLIN, test_socket, test_port_event_complete, test_callback_ctx));
-    umock_c_reset_all_calls();
+    uint8_t buffer[16];
 
-    g_events[0].events = 0;
-    g_events[0].events |= EPOLLIN;
+    //act
+    int result = completion_port_buffer_ring_add(NULL, buffer, sizeof(buffer), 0);
 
-    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
-        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
-        .SetReturn(1);
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLIN));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-    setup_remove_thread_data();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
-        .SetReturn(1);
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_COMPLETION_PORT_LINUX_12_078: [ If buffer is NULL, completion_port_buffer_ring_add shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_buffer_ring_add_with_NULL_buffer_fails)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = create_buffer_ring(port_handle);
+    umock_c_reset_all_calls();
 
     //act
-    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    int result = completion_port_buffer_ring_add(buffer_ring, NULL, 16, 0);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint16_t, 0, ((struct io_uring_buf_ring*)g_test_ring_buffers)->tail);
 
     // cleanup
+    completion_port_buffer_ring_destroy(buffer_ring);
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_035: [ epoll_worker_func shall call the event_callback with the specified COMPLETION_PORT_EPOLL_ACTION that was returned. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_036: [ Then epoll_worker_func shall remove the EPOLL_THREAD_DATA from the list and free the object. ]
-// Tests_SRS_COMPLETION_PORT_LINUX_11_033: [ On a epoll_wait timeout epoll_worker_func shall ensure it should not exit and issue another epoll_wait. ]
-TEST_FUNCTION(epoll_worker_func_epoll_wait_EPOLLOUT_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_079: [ If buffer_size is 0, completion_port_buffer_ring_add shall fail and return a non-zero value. ]
+TEST_FUNCTION(completion_port_buffer_ring_add_with_0_buffer_size_fails)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT, test_socket, test_port_event_complete, test_callback_ctx));
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = create_buffer_ring(port_handle);
     umock_c_reset_all_calls();
-
-    g_events[0].events = 0;
-    g_events[0].events |= EPOLLOUT;
-
-    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
-        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event))
-        .SetReturn(1);
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-    setup_remove_thread_data();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
-        .SetReturn(1);
+    uint8_t buffer[16];
 
     //act
-    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    int result = completion_port_buffer_ring_add(buffer_ring, buffer, 0, 0);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint16_t, 0, ((struct io_uring_buf_ring*)g_test_ring_buffers)->tail);
 
     // cleanup
+    completion_port_buffer_ring_destroy(buffer_ring);
     completion_port_dec_ref(port_handle);
 }
 
-// Tests_SRS_COMPLETION_PORT_LINUX_11_034: [ epoll_worker_func shall loop through the num of descriptors that was returned. ]
-TEST_FUNCTION(epoll_worker_func_epoll_wait_multiple_values_success)
+// Tests_SRS_COMPLETION_PORT_LINUX_12_080: [ completion_port_buffer_ring_add shall write buffer, buffer_size and buffer_id in the entry at the tail of the buffer ring. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_081: [ completion_port_buffer_ring_add shall then publish the entry to the kernel by storing the incremented tail with release semantics. ]
+// Tests_SRS_COMPLETION_PORT_LINUX_12_082: [ On success, completion_port_buffer_ring_add shall return 0. ]
+TEST_FUNCTION(completion_port_buffer_ring_add_publishes_the_buffer_at_the_tail_of_the_buffer_ring)
 {
     //arrange
-    COMPLETION_PORT_HANDLE port_handle = completion_port_create();
-    ASSERT_IS_NOT_NULL(port_handle);
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT, test_socket, test_port_event_complete, test_callback_ctx));
-    ASSERT_ARE_EQUAL(int, 0, completion_port_add(port_handle, EPOLLOUT, test_socket, test_port_event_complete, test_callback_ctx));
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = create_buffer_ring(port_handle);
     umock_c_reset_all_calls();
+    uint8_t buffer_1[16];
+    uint8_t buffer_2[32];
 
-    g_events[0].events = 0;
-    g_events[0].events |= EPOLLOUT;
-    g_events[1].events = 0;
-    g_events[1].events |= EPOLLRDHUP;
+    //act
+    int result_1 = completion_port_buffer_ring_add(buffer_ring, buffer_1, sizeof(buffer_1), 3);
+    int result_2 = completion_port_buffer_ring_add(buffer_ring, buffer_2, sizeof(buffer_2), 1);
 
-    STRICT_EXPECTED_CALL(mocked_epoll_wait(g_test_epoll, IGNORED_ARG, TEST_MAX_EVENTS_NUM, EVENTS_TIMEOUT_MS))
-        .CopyOutArgumentBuffer_events(&g_events, sizeof(struct epoll_event)*2)
-        .SetReturn(2);
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLOUT));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-    setup_remove_thread_data();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result_1);
+    ASSERT_ARE_EQUAL(int, 0, result_2);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)buffer_1, g_test_ring_buffers[0].addr);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(buffer_1), g_test_ring_buffers[0].len);
+    ASSERT_ARE_EQUAL(uint16_t, 3, g_test_ring_buffers[0].bid);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)buffer_2, g_test_ring_buffers[1].addr);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(buffer_2), g_test_ring_buffers[1].len);
+    ASSERT_ARE_EQUAL(uint16_t, 1, g_test_ring_buffers[1].bid);
+    ASSERT_ARE_EQUAL(uint16_t, 2, ((struct io_uring_buf_ring*)g_test_ring_buffers)->tail);
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .CallCannotFail();
-    STRICT_EXPECTED_CALL(test_port_event_complete(test_callback_ctx, COMPLETION_PORT_EPOLL_EPOLLRDHUP));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
-    setup_remove_thread_data();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    // cleanup
+    completion_port_buffer_ring_destroy(buffer_ring);
+    completion_port_dec_ref(port_handle);
+}
 
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
-        .SetReturn(1);
+// Tests_SRS_COMPLETION_PORT_LINUX_12_080: [ completion_port_buffer_ring_add shall write buffer, buffer_size and buffer_id in the entry at the tail of the buffer ring. ]
+TEST_FUNCTION(completion_port_buffer_ring_add_wraps_around_the_entries_of_the_buffer_ring)
+{
+    //arrange
+    COMPLETION_PORT_HANDLE port_handle = create_completion_port_with_io_uring();
+    COMPLETION_PORT_BUFFER_RING_HANDLE buffer_ring = create_buffer_ring(port_handle);
+    uint8_t buffers[TEST_RING_BUFFERS + 1][16];
+    for (uint16_t buffer_id = 0; buffer_id < TEST_RING_BUFFERS; buffer_id++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, completion_port_buffer_ring_add(buffer_ring, buffers[buffer_id], sizeof(buffers[buffer_id]), buffer_id));
+    }
+    umock_c_reset_all_calls();
 
     //act
-    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    int result = completion_port_buffer_ring_add(buffer_ring, buffers[TEST_RING_BUFFERS], sizeof(buffers[TEST_RING_BUFFERS]), TEST_RING_BUFFERS);
 
     //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)(uintptr_t)buffers[TEST_RING_BUFFERS], g_test_ring_buffers[0].addr);
+    ASSERT_ARE_EQUAL(uint16_t, TEST_RING_BUFFERS, g_test_ring_buffers[0].bid);
+    ASSERT_ARE_EQUAL(uint16_t, TEST_RING_BUFFERS + 1, ((struct io_uring_buf_ring*)g_test_ring_buffers)->tail);
 
     // cleanup
+    completion_port_buffer_ring_destroy(buffer_ring);
     completion_port_dec_ref(port_handle);
 }
 
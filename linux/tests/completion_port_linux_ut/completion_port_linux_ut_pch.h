@@ -5,12 +5,23 @@
 #ifndef COMPLETION_PORT_LINUX_UT_PCH_H
 #define COMPLETION_PORT_LINUX_UT_PCH_H
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <inttypes.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <poll.h>
 #include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
 #include <errno.h>
 #include <string.h>                          // for memset
 
+#include <linux/io_uring.h>
+
 #include "macro_utils/macro_utils.h" // IWYU pragma: keep
 
 #include "real_gballoc_ll.h"    // IWYU pragma: keep
@@ -47,6 +58,8 @@
 #define TEST_MAX_EVENTS_NUM     64
 #define EVENTS_TIMEOUT_MS       2*1000
 
+#define TEST_IO_URING_SQ_ENTRIES    256
+
 #define TEST_COMPLETION_PORT_CALLBACK_EXECUTING  2
 #define TEST_COMPLETION_PORT_CALLBACK_EXECUTED   3
 
@@ -138,6 +138,85 @@ TEST_FUNCTION(execution_engine_create_fails_when_allocation_fails)
     ASSERT_IS_NULL(execution_engine);
 }
 
+/* execution_engine_linux_create */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_12_001: [ execution_engine_linux_create shall create the execution engine like execution_engine_create, using execution_engine_parameters for the thread counts. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_12_002: [ If thread_parameters is NULL, execution_engine_linux_create shall not pin the threads to a NUMA node and shall use the default thread stack size. ]*/
+TEST_FUNCTION(execution_engine_linux_create_with_NULL_thread_parameters_uses_the_default_thread_parameters)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    execution_engine = execution_engine_linux_create(&test_execution_engine_parameter, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+    const EXECUTION_ENGINE_PARAMETERS* parameters = execution_engine_linux_get_parameters(execution_engine);
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT, parameters->min_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, MAX_THREAD_COUNT, parameters->max_thread_count);
+    const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* thread_parameters = execution_engine_linux_get_thread_parameters(execution_engine);
+    ASSERT_IS_FALSE(thread_parameters->pin_to_numa_node);
+    ASSERT_ARE_EQUAL(size_t, 0, thread_parameters->thread_stack_size);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_12_001: [ execution_engine_linux_create shall create the execution engine like execution_engine_create, using execution_engine_parameters for the thread counts. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_12_003: [ Otherwise execution_engine_linux_create shall copy the fields of thread_parameters. ]*/
+TEST_FUNCTION(execution_engine_linux_create_succeeds)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS test_thread_parameters = { true, 1, 256 * 1024 };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    execution_engine = execution_engine_linux_create(&test_execution_engine_parameter, &test_thread_parameters);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+    const EXECUTION_ENGINE_PARAMETERS* parameters = execution_engine_linux_get_parameters(execution_engine);
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT, parameters->min_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, MAX_THREAD_COUNT, parameters->max_thread_count);
+    const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* thread_parameters = execution_engine_linux_get_thread_parameters(execution_engine);
+    ASSERT_IS_TRUE(thread_parameters->pin_to_numa_node);
+    ASSERT_ARE_EQUAL(uint32_t, 1, thread_parameters->numa_node);
+    ASSERT_ARE_EQUAL(size_t, 256 * 1024, thread_parameters->thread_stack_size);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_12_001: [ execution_engine_linux_create shall create the execution engine like execution_engine_create, using execution_engine_parameters for the thread counts. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_07_005: [ If max_thread_count is non-zero and less than min_thread_count, execution_engine_create shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_create_fails_when_max_thread_count_nonzero_and_less_than_min_thread_count)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS test_execution_engine_parameter = {5, 3};
+    EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS test_thread_parameters = { true, 1, 0 };
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine = execution_engine_linux_create(&test_execution_engine_parameter, &test_thread_parameters);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(execution_engine);
+}
+
 /* execution_engine_execution_engine_dec_ref */
 
 /* Tests_SRS_EXECUTION_ENGINE_LINUX_07_007: [ If execution_engine is NULL, execution_engine_dec_ref shall return. ]*/
@@ -263,4 +342,43 @@ TEST_FUNCTION(execution_engine_linux_get_parameters_succeeds)
     execution_engine_dec_ref(execution_engine);
 }
 
+/* execution_engine_linux_get_thread_parameters */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_12_004: [ If execution_engine is NULL, execution_engine_linux_get_thread_parameters shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_get_thread_parameters_with_NULL_execution_engine_fails)
+{
+    // arrange
+    const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* result;
+
+    // act
+    result = execution_engine_linux_get_thread_parameters(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_12_002: [ If thread_parameters is NULL, execution_engine_linux_create shall not pin the threads to a NUMA node and shall use the default thread stack size. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_12_005: [ Otherwise, execution_engine_linux_get_thread_parameters shall return the thread parameters in EXECUTION_ENGINE. ]*/
+TEST_FUNCTION(execution_engine_linux_get_thread_parameters_returns_the_defaults_for_execution_engine_create)
+{
+    // arrange
+    const EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS* result;
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    execution_engine = execution_engine_create(&test_execution_engine_parameter);
+    umock_c_reset_all_calls();
+
+    // act
+    result = execution_engine_linux_get_thread_parameters(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_FALSE(result->pin_to_numa_node);
+    ASSERT_ARE_EQUAL(size_t, 0, result->thread_stack_size);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
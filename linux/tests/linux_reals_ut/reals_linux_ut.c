@@ -24,6 +24,7 @@ TEST_FUNCTION(check_all_c_pal_reals) // no-srs
     REGISTER_THANDLE_LOG_CONTEXT_HANDLE_GLOBAL_MOCK_HOOK();
     REGISTER_SOCKET_TRANSPORT_GLOBAL_MOCK_HOOK();
     REGISTER_ASYNC_SOCKET_GLOBAL_MOCK_HOOK();
+    REGISTER_THREADPOOL_TASK_DEQUE_GLOBAL_MOCK_HOOK();
     // assert
     // no explicit assert, if it builds it works
 }
@@ -18,6 +18,8 @@
 #include "c_pal/thandle_log_context_handle.h" // IWYU pragma: keep
 #include "c_pal/socket_transport.h" // IWYU pragma: keep
 #include "c_pal/async_socket.h" // IWYU pragma: keep
+#include "c_pal/async_socket_linux.h" // IWYU pragma: keep
+#include "c_pal/threadpool_task_deque.h" // IWYU pragma: keep
 
 #define REGISTER_GLOBAL_MOCK_HOOK(original, real) \
     (original == real) ? (void)0 : (void)1;
@@ -34,5 +36,6 @@
 #include "real_thandle_log_context_handle.h"
 #include "real_socket_transport.h"
 #include "real_async_socket.h"
+#include "real_threadpool_task_deque.h"
 
 #endif // REALS_LINUX_UT_PCH_H
@@ -7,6 +7,9 @@ static COMPLETION_PORT_HANDLE test_completion_port = (COMPLETION_PORT_HANDLE)0x4
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
+MU_DEFINE_ENUM_STRINGS(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE_VALUES);
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
@@ -29,11 +32,13 @@ TEST_SUITE_INITIALIZE(suite_init)
 {
     ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
     ASSERT_ARE_EQUAL(int, 0, umocktypes_charptr_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
 
-    REGISTER_GLOBAL_MOCK_RETURNS(completion_port_create, test_completion_port, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(completion_port_create_with_engine, test_completion_port, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(mocked_getaddrinfo, my_getaddrinfo);
 
     REGISTER_UMOCK_ALIAS_TYPE(COMPLETION_PORT_HANDLE, void*);
+    REGISTER_TYPE(COMPLETION_PORT_ENGINE, COMPLETION_PORT_ENGINE);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -52,15 +57,15 @@ TEST_FUNCTION_CLEANUP(function_cleanup)
 
 // platform_init
 
-/* Tests_SRS_PLATFORM_LINUX_01_001: [ Otherwise, platform_init shall call getaddrinfo for localhost and port 4242. ]*/
-// Tests_SRS_PLATFORM_LINUX_11_001: [ platform_init shall call completion_port_create. ]
+// Tests_SRS_PLATFORM_LINUX_12_013: [ platform_init shall initialize the platform by calling platform_linux_init_with_engine with 1 and COMPLETION_PORT_ENGINE_EPOLL. ]
+// Tests_SRS_PLATFORM_LINUX_01_001: [ Otherwise, platform_init shall call getaddrinfo for localhost and port 4242. ]
 // Tests_SRS_PLATFORM_LINUX_11_002: [ platform_init shall succeed and return zero. ]
 TEST_FUNCTION(platform_init_succeeds)
 {
     //arrange
     STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_freeaddrinfo(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_create());
+    STRICT_EXPECTED_CALL(completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_EPOLL));
 
     //act
     int result = platform_init();
@@ -79,7 +84,7 @@ TEST_FUNCTION(platform_init_2nd_call_succeeds)
     //arrange
     STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_freeaddrinfo(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_create());
+    STRICT_EXPECTED_CALL(completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_EPOLL));
 
     ASSERT_ARE_EQUAL(int, 0, platform_init());
     umock_c_reset_all_calls();
@@ -114,12 +119,12 @@ TEST_FUNCTION(when_getaddrinfo_fails_platform_init_fails)
 }
 
 // Tests_SRS_PLATFORM_LINUX_01_002: [ If any error occurs, platform_init shall return a non-zero value. ]
-TEST_FUNCTION(when_completion_port_create_fails_platform_init_fails)
+TEST_FUNCTION(when_completion_port_create_with_engine_fails_platform_init_fails)
 {
     //arrange
     STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_freeaddrinfo(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(completion_port_create())
+    STRICT_EXPECTED_CALL(completion_port_create_with_engine(1, COMPLETION_PORT_ENGINE_EPOLL))
         .SetReturn(NULL);
 
     //act
@@ -133,6 +138,196 @@ TEST_FUNCTION(when_completion_port_create_fails_platform_init_fails)
     platform_deinit();
 }
 
+// platform_linux_init
+
+// Tests_SRS_PLATFORM_LINUX_12_001: [ If completion_port_thread_count is 0, platform_linux_init shall fail and return a non-zero value. ]
+TEST_FUNCTION(platform_linux_init_with_completion_port_thread_count_0_fails)
+{
+    //arrange
+
+    //act
+    int result = platform_linux_init(0);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// Tests_SRS_PLATFORM_LINUX_12_014: [ platform_linux_init shall initialize the platform by calling platform_linux_init_with_engine with completion_port_thread_count and COMPLETION_PORT_ENGINE_EPOLL. ]
+// Tests_SRS_PLATFORM_LINUX_12_002: [ Otherwise, platform_linux_init shall call getaddrinfo for localhost and port 4242. ]
+// Tests_SRS_PLATFORM_LINUX_12_005: [ platform_linux_init shall succeed and return zero. ]
+TEST_FUNCTION(platform_linux_init_succeeds)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_freeaddrinfo(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_create_with_engine(4, COMPLETION_PORT_ENGINE_EPOLL));
+
+    //act
+    int result = platform_linux_init(4);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// Tests_SRS_PLATFORM_LINUX_12_006: [ If the completion port object is non-NULL, platform_linux_init shall return zero. ]
+TEST_FUNCTION(platform_linux_init_after_platform_init_succeeds)
+{
+    //arrange
+    ASSERT_ARE_EQUAL(int, 0, platform_init());
+    umock_c_reset_all_calls();
+
+    //act
+    int result = platform_linux_init(4);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// Tests_SRS_PLATFORM_LINUX_12_004: [ If any error occurs, platform_linux_init shall return a non-zero value. ]
+TEST_FUNCTION(when_getaddrinfo_fails_platform_linux_init_fails)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+
+    //act
+    int result = platform_linux_init(4);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// Tests_SRS_PLATFORM_LINUX_12_004: [ If any error occurs, platform_linux_init shall return a non-zero value. ]
+TEST_FUNCTION(when_completion_port_create_with_engine_fails_platform_linux_init_fails)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_freeaddrinfo(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_create_with_engine(4, COMPLETION_PORT_ENGINE_EPOLL))
+        .SetReturn(NULL);
+
+    //act
+    int result = platform_linux_init(4);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// platform_linux_init_with_engine
+
+// Tests_SRS_PLATFORM_LINUX_12_008: [ If completion_port_thread_count is 0, platform_linux_init_with_engine shall fail and return a non-zero value. ]
+TEST_FUNCTION(platform_linux_init_with_engine_with_completion_port_thread_count_0_fails)
+{
+    //arrange
+
+    //act
+    int result = platform_linux_init_with_engine(0, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// Tests_SRS_PLATFORM_LINUX_12_009: [ Otherwise, platform_linux_init_with_engine shall call getaddrinfo for localhost and port 4242. ]
+// Tests_SRS_PLATFORM_LINUX_12_010: [ platform_linux_init_with_engine shall call completion_port_create_with_engine with completion_port_thread_count and engine. ]
+// Tests_SRS_PLATFORM_LINUX_12_012: [ platform_linux_init_with_engine shall succeed and return zero. ]
+TEST_FUNCTION(platform_linux_init_with_engine_succeeds)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_freeaddrinfo(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_create_with_engine(4, COMPLETION_PORT_ENGINE_IO_URING));
+
+    //act
+    int result = platform_linux_init_with_engine(4, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// Tests_SRS_PLATFORM_LINUX_12_007: [ If the completion port object is non-NULL, platform_linux_init_with_engine shall return zero. ]
+TEST_FUNCTION(platform_linux_init_with_engine_after_platform_init_succeeds)
+{
+    //arrange
+    ASSERT_ARE_EQUAL(int, 0, platform_init());
+    umock_c_reset_all_calls();
+
+    //act
+    int result = platform_linux_init_with_engine(4, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// Tests_SRS_PLATFORM_LINUX_12_011: [ If any error occurs, platform_linux_init_with_engine shall return a non-zero value. ]
+TEST_FUNCTION(when_getaddrinfo_fails_platform_linux_init_with_engine_fails)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+
+    //act
+    int result = platform_linux_init_with_engine(4, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
+// Tests_SRS_PLATFORM_LINUX_12_011: [ If any error occurs, platform_linux_init_with_engine shall return a non-zero value. ]
+TEST_FUNCTION(when_completion_port_create_with_engine_fails_platform_linux_init_with_engine_fails)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(mocked_getaddrinfo("localhost", "4242", IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_freeaddrinfo(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(completion_port_create_with_engine(4, COMPLETION_PORT_ENGINE_IO_URING))
+        .SetReturn(NULL);
+
+    //act
+    int result = platform_linux_init_with_engine(4, COMPLETION_PORT_ENGINE_IO_URING);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    platform_deinit();
+}
+
 // platform_deinit
 
 // Tests_SRS_PLATFORM_LINUX_11_004: [ If the completion port object is non-NULL, platform_deinit shall decrement whose reference by calling completion_port_dec_ref. ]
@@ -0,0 +1,409 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include "c_logging/logger.h"
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "testrunnerswitcher.h"
+
+#include "c_pal/timer.h"
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/execution_engine.h"
+#include "c_pal/sysinfo.h"
+#include "c_pal/thandle.h" // IWYU pragma: keep
+#include "c_pal/threadpool.h"
+#include "c_pal/threadpool_linux.h"
+
+#define IDLE_THREAD_COUNT               16
+#define IDLE_MEASURE_TIME_MS            5000
+#define IDLE_SCHEDULE_WAKEUP_COUNT      1000
+
+// The baseline period schedules one item every IDLE_BASELINE_PERIOD_MS for IDLE_MEASURE_TIME_MS
+#define IDLE_BASELINE_PERIOD_MS         10
+// An idle threadpool should not wake up on its own at all, the idle period may only cause a small fraction of the wakeups of the baseline period
+#define MAX_IDLE_TO_BASELINE_WAKEUP_RATIO 0.02
+
+#define WORKER_THREAD_NAME_PREFIX       "tp_worker_"
+
+#define FAN_OUT_ROOT_ITEMS              64
+#define FAN_OUT_CHILD_ITEMS             4096
+#define FAN_OUT_CHILD_SPIN_COUNT        2000
+
+#define BATCH_THREAD_COUNT              8
+#define BATCH_TOTAL_ITEMS               (1024 * 1024)
+#define BATCH_SIZE                      64
+
+typedef struct FAN_OUT_CONTEXT_TAG
+{
+    THANDLE(THREADPOOL) threadpool;
+    volatile_atomic int32_t execution_counter;
+} FAN_OUT_CONTEXT;
+
+static uint64_t get_voluntary_context_switches(void)
+{
+    struct rusage usage;
+    ASSERT_ARE_EQUAL(int, 0, getrusage(RUSAGE_SELF, &usage));
+    return (uint64_t)usage.ru_nvcsw;
+}
+
+typedef struct WORKER_WAKEUPS_TAG
+{
+    uint32_t worker_count;
+    uint64_t voluntary_context_switches;
+} WORKER_WAKEUPS;
+
+static bool read_task_file(const char* task_name, const char* file_name, char* buffer, size_t buffer_size)
+{
+    bool result;
+    char path[64];
+    (void)snprintf(path, sizeof(path), "/proc/self/task/%s/%s", task_name, file_name);
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        // the thread is gone
+        result = false;
+    }
+    else
+    {
+        size_t read_size = fread(buffer, 1, buffer_size - 1, file);
+        buffer[read_size] = '\0';
+        (void)fclose(file);
+        result = true;
+    }
+    return result;
+}
+
+// Sums the voluntary context switches (every time a thread blocks and is woken up again) of the threadpool worker threads of the process
+static WORKER_WAKEUPS get_worker_wakeups(void)
+{
+    WORKER_WAKEUPS result = { 0, 0 };
+
+    DIR* task_dir = opendir("/proc/self/task");
+    ASSERT_IS_NOT_NULL(task_dir);
+
+    struct dirent* entry;
+    while ((entry = readdir(task_dir)) != NULL)
+    {
+        char buffer[2048];
+        if (
+            (entry->d_name[0] != '.') &&
+            read_task_file(entry->d_name, "comm", buffer, sizeof(buffer)) &&
+            (strncmp(buffer, WORKER_THREAD_NAME_PREFIX, sizeof(WORKER_THREAD_NAME_PREFIX) - 1) == 0) &&
+            read_task_file(entry->d_name, "status", buffer, sizeof(buffer))
+            )
+        {
+            const char* switches = strstr(buffer, "\nvoluntary_ctxt_switches:");
+            ASSERT_IS_NOT_NULL(switches);
+            result.voluntary_context_switches += strtoull(switches + sizeof("\nvoluntary_ctxt_switches:") - 1, NULL, 10);
+            result.worker_count++;
+        }
+    }
+
+    (void)closedir(task_dir);
+
+    return result;
+}
+
+static void wait_for_counter(volatile_atomic int32_t* counter, int32_t expected_value)
+{
+    int32_t value;
+    while ((value = interlocked_add(counter, 0)) != expected_value)
+    {
+        (void)wait_on_address(counter, value, UINT32_MAX);
+    }
+}
+
+static void count_work_function(void* context)
+{
+    volatile_atomic int32_t* counter = context;
+    (void)interlocked_increment(counter);
+    wake_by_address_single(counter);
+}
+
+static void fan_out_child_work_function(void* context)
+{
+    FAN_OUT_CONTEXT* fan_out_context = context;
+
+    // a bit of CPU work, so that the benchmark is not only measuring the queues
+    volatile uint32_t spin = 0;
+    for (uint32_t i = 0; i < FAN_OUT_CHILD_SPIN_COUNT; i++)
+    {
+        spin++;
+    }
+
+    if (interlocked_increment(&fan_out_context->execution_counter) == FAN_OUT_ROOT_ITEMS * FAN_OUT_CHILD_ITEMS)
+    {
+        wake_by_address_single(&fan_out_context->execution_counter);
+    }
+}
+
+static void fan_out_root_work_function(void* context)
+{
+    FAN_OUT_CONTEXT* fan_out_context = context;
+    for (uint32_t i = 0; i < FAN_OUT_CHILD_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(fan_out_context->threadpool, fan_out_child_work_function, fan_out_context));
+    }
+}
+
+static double run_fan_out_fan_in(uint32_t thread_count)
+{
+    EXECUTION_ENGINE_PARAMETERS execution_engine_parameters = { thread_count, thread_count };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+
+    FAN_OUT_CONTEXT fan_out_context;
+    THANDLE(THREADPOOL) threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+    THANDLE_INITIALIZE_MOVE(THREADPOOL)(&fan_out_context.threadpool, &threadpool);
+    (void)interlocked_exchange(&fan_out_context.execution_counter, 0);
+
+    double start_time = timer_global_get_elapsed_ms();
+
+    for (uint32_t i = 0; i < FAN_OUT_ROOT_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(fan_out_context.threadpool, fan_out_root_work_function, &fan_out_context));
+    }
+    wait_for_counter(&fan_out_context.execution_counter, FAN_OUT_ROOT_ITEMS * FAN_OUT_CHILD_ITEMS);
+
+    double elapsed_ms = timer_global_get_elapsed_ms() - start_time;
+    double items_per_second = (double)(FAN_OUT_ROOT_ITEMS * FAN_OUT_CHILD_ITEMS) * 1000.0 / elapsed_ms;
+
+    THANDLE_ASSIGN(THREADPOOL)(&fan_out_context.threadpool, NULL);
+    execution_engine_dec_ref(execution_engine);
+
+    return items_per_second;
+}
+
+static void schedule_one_at_a_time(THANDLE(THREADPOOL) threadpool, volatile_atomic int32_t* counter)
+{
+    for (uint32_t i = 0; i < BATCH_TOTAL_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, count_work_function, (void*)counter));
+    }
+}
+
+static void schedule_in_batches(THANDLE(THREADPOOL) threadpool, volatile_atomic int32_t* counter)
+{
+    THREADPOOL_WORK_BATCH_ENTRY work_batch[BATCH_SIZE];
+    for (uint32_t i = 0; i < BATCH_SIZE; i++)
+    {
+        work_batch[i].work_function = count_work_function;
+        work_batch[i].work_function_context = (void*)counter;
+    }
+
+    for (uint32_t i = 0; i < BATCH_TOTAL_ITEMS; i += BATCH_SIZE)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_batch(threadpool, work_batch, BATCH_SIZE));
+    }
+}
+
+static double run_schedule_throughput(void (*schedule_items)(THANDLE(THREADPOOL) threadpool, volatile_atomic int32_t* counter))
+{
+    EXECUTION_ENGINE_PARAMETERS execution_engine_parameters = { BATCH_THREAD_COUNT, BATCH_THREAD_COUNT };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+    THANDLE(THREADPOOL) threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    volatile_atomic int32_t counter;
+    (void)interlocked_exchange(&counter, 0);
+
+    double start_time = timer_global_get_elapsed_ms();
+
+    schedule_items(threadpool, &counter);
+    wait_for_counter(&counter, BATCH_TOTAL_ITEMS);
+
+    double elapsed_ms = timer_global_get_elapsed_ms() - start_time;
+
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+    execution_engine_dec_ref(execution_engine);
+
+    return (double)BATCH_TOTAL_ITEMS * 1000.0 / elapsed_ms;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+/* idle wakeups */
+
+TEST_FUNCTION(threadpool_idle_wakeups_per_second)
+{
+    // arrange
+    EXECUTION_ENGINE_PARAMETERS execution_engine_parameters = { IDLE_THREAD_COUNT, IDLE_THREAD_COUNT };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+    THANDLE(THREADPOOL) threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    // let the threads start and park
+    volatile_atomic int32_t counter;
+    (void)interlocked_exchange(&counter, 0);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, count_work_function, (void*)&counter));
+    wait_for_counter(&counter, 1);
+    ThreadAPI_Sleep(100);
+
+    // baseline: the workers of the same threadpool while a trickle of items is scheduled
+    WORKER_WAKEUPS start_wakeups = get_worker_wakeups();
+    ASSERT_ARE_EQUAL(uint32_t, IDLE_THREAD_COUNT, start_wakeups.worker_count);
+    double start_time = timer_global_get_elapsed_ms();
+    int32_t baseline_item_count = 0;
+    while (timer_global_get_elapsed_ms() - start_time < IDLE_MEASURE_TIME_MS)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, count_work_function, (void*)&counter));
+        baseline_item_count++;
+        ThreadAPI_Sleep(IDLE_BASELINE_PERIOD_MS);
+    }
+    wait_for_counter(&counter, 1 + baseline_item_count);
+    double baseline_elapsed_ms = timer_global_get_elapsed_ms() - start_time;
+    WORKER_WAKEUPS end_wakeups = get_worker_wakeups();
+    ASSERT_ARE_EQUAL(uint32_t, IDLE_THREAD_COUNT, end_wakeups.worker_count);
+    uint64_t baseline_wakeups = end_wakeups.voluntary_context_switches - start_wakeups.voluntary_context_switches;
+    ThreadAPI_Sleep(100);
+
+    // act
+    start_wakeups = get_worker_wakeups();
+    start_time = timer_global_get_elapsed_ms();
+
+    ThreadAPI_Sleep(IDLE_MEASURE_TIME_MS);
+
+    double idle_elapsed_ms = timer_global_get_elapsed_ms() - start_time;
+    end_wakeups = get_worker_wakeups();
+    ASSERT_ARE_EQUAL(uint32_t, IDLE_THREAD_COUNT, end_wakeups.worker_count);
+    uint64_t idle_wakeups = end_wakeups.voluntary_context_switches - start_wakeups.voluntary_context_switches;
+
+    // assert
+    double baseline_wakeups_per_worker_per_second = (double)baseline_wakeups * 1000.0 / baseline_elapsed_ms / IDLE_THREAD_COUNT;
+    double idle_wakeups_per_worker_per_second = (double)idle_wakeups * 1000.0 / idle_elapsed_ms / IDLE_THREAD_COUNT;
+    LogInfo("Threadpool with %" PRIu32 " threads: %.04f wakeups/s per worker when idle, %.04f wakeups/s per worker with %" PRId32 " items scheduled in %.02f ms",
+        threadpool_linux_get_thread_count(threadpool), idle_wakeups_per_worker_per_second, baseline_wakeups_per_worker_per_second, baseline_item_count, baseline_elapsed_ms);
+    ASSERT_IS_TRUE(baseline_wakeups >= (uint64_t)baseline_item_count, "Only %" PRIu64 " worker wakeups for %" PRId32 " items", baseline_wakeups, baseline_item_count);
+    ASSERT_IS_TRUE(idle_wakeups_per_worker_per_second <= baseline_wakeups_per_worker_per_second * MAX_IDLE_TO_BASELINE_WAKEUP_RATIO,
+        "Idle workers woke up %.04f times per second, %.04f times per second with a trickle of work", idle_wakeups_per_worker_per_second, baseline_wakeups_per_worker_per_second);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(threadpool_wakeups_per_scheduled_item_when_idle)
+{
+    // arrange
+    EXECUTION_ENGINE_PARAMETERS execution_engine_parameters = { IDLE_THREAD_COUNT, IDLE_THREAD_COUNT };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+    THANDLE(THREADPOOL) threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    volatile_atomic int32_t counter;
+    (void)interlocked_exchange(&counter, 0);
+    ThreadAPI_Sleep(100);
+
+    uint64_t start_switches = get_voluntary_context_switches();
+    double start_time = timer_global_get_elapsed_ms();
+
+    // act
+    for (int32_t i = 0; i < IDLE_SCHEDULE_WAKEUP_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, count_work_function, (void*)&counter));
+        wait_for_counter(&counter, i + 1);
+    }
+
+    double elapsed_ms = timer_global_get_elapsed_ms() - start_time;
+    uint64_t wakeups = get_voluntary_context_switches() - start_switches;
+
+    // assert
+    // each item wakes one worker and the test thread, anything more means a thundering herd
+    double wakeups_per_item = (double)wakeups / IDLE_SCHEDULE_WAKEUP_COUNT;
+    LogInfo("Scheduling %d items one at a time on an idle threadpool with %" PRIu32 " threads: %.02f ms, %.02f wakeups/item",
+        IDLE_SCHEDULE_WAKEUP_COUNT, threadpool_linux_get_thread_count(threadpool), elapsed_ms, wakeups_per_item);
+    ASSERT_IS_TRUE(wakeups_per_item < 4.0, "Scheduling an item caused %.02f wakeups", wakeups_per_item);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* fan-out/fan-in */
+
+TEST_FUNCTION(threadpool_fan_out_fan_in_throughput)
+{
+    // arrange
+    uint32_t processor_count = sysinfo_get_processor_count();
+    ASSERT_ARE_NOT_EQUAL(uint32_t, 0, processor_count);
+
+    double single_thread_items_per_second = 0;
+
+    // act
+    // 1, 2, 4, ... and finally all the processors
+    uint32_t thread_count = 1;
+    while (thread_count != 0)
+    {
+        double items_per_second = run_fan_out_fan_in(thread_count);
+        if (thread_count == 1)
+        {
+            single_thread_items_per_second = items_per_second;
+        }
+
+        // assert
+        LogInfo("Fan-out/fan-in with %" PRIu32 " threads: %.02f items/s, speedup %.02f (%.02f%% of linear)",
+            thread_count, items_per_second, items_per_second / single_thread_items_per_second,
+            items_per_second / single_thread_items_per_second * 100.0 / thread_count);
+
+        if (thread_count == processor_count)
+        {
+            thread_count = 0;
+        }
+        else
+        {
+            thread_count = (thread_count * 2 > processor_count) ? processor_count : thread_count * 2;
+        }
+    }
+}
+
+/* batch scheduling */
+
+TEST_FUNCTION(threadpool_schedule_work_batch_throughput)
+{
+    // arrange
+
+    // act
+    double one_at_a_time_items_per_second = run_schedule_throughput(schedule_one_at_a_time);
+    double batch_items_per_second = run_schedule_throughput(schedule_in_batches);
+
+    // assert
+    LogInfo("Scheduling %d items on %d threads: one at a time %.02f items/s, in batches of %d %.02f items/s (%.02fx)",
+        BATCH_TOTAL_ITEMS, BATCH_THREAD_COUNT, one_at_a_time_items_per_second, BATCH_SIZE, batch_items_per_second,
+        batch_items_per_second / one_at_a_time_items_per_second);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -1,28 +1,20 @@
 // Copyright (c) Microsoft. All rights reserved.
 
 #include <time.h>
-#include <semaphore.h>
-#include <bits/types/timer_t.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
 
-#define timer_create mocked_timer_create
-#define timer_settime mocked_timer_settime
-#define timer_delete mocked_timer_delete
-#define sem_init mocked_sem_init
-#define sem_post mocked_sem_post
-#define sem_timedwait mocked_sem_timedwait
-#define clock_gettime mocked_clock_gettime
+#define timerfd_create mocked_timerfd_create
+#define timerfd_settime mocked_timerfd_settime
+#define read mocked_read
+#define close mocked_close
 
 struct itimerspec;
-struct sigevent;
-struct timespec;
 
-int mocked_timer_create(clockid_t clockid, struct sigevent* restrict sevp, timer_t* restrict timerid);
-int mocked_timer_settime(timer_t timerid, int flags, const struct itimerspec* new_value, struct itimerspec* old_value);
-int mocked_timer_delete(timer_t timerid);
-int mocked_sem_post(sem_t* sem);
-int mocked_sem_init(sem_t* sem, int pshared, unsigned int value);
-int mocked_sem_timedwait(sem_t* sem, const struct timespec* abs_timeout);
-int mocked_clock_gettime(clockid_t clockid, struct timespec* tp);
+int mocked_timerfd_create(clockid_t clockid, int flags);
+int mocked_timerfd_settime(int fd, int flags, const struct itimerspec* new_value, struct itimerspec* old_value);
+ssize_t mocked_read(int fd, void* buf, size_t count);
+int mocked_close(int fd);
 
 // These exist here to avoid collisions with the mocks
 // This is due to the fact that THREADPOOL_WORK_ITEM is internal to threadpool_linux.c
@@ -7,15 +7,20 @@ struct itimerspec;
 struct timespec;
 
 static EXECUTION_ENGINE_PARAMETERS execution_engine = {MIN_THREAD_COUNT, MAX_THREAD_COUNT};
+static EXECUTION_ENGINE_LINUX_THREAD_PARAMETERS test_thread_parameters = { false, 0, 0 };
 static EXECUTION_ENGINE_HANDLE test_execution_engine = (EXECUTION_ENGINE_HANDLE)0x4243;
 static THREAD_HANDLE test_thread_handle = (THREAD_HANDLE)0x4200;
 static THREAD_START_FUNC g_saved_worker_thread_func;
 static void* g_saved_worker_thread_func_context;
+static char g_saved_thread_name[THREADAPI_MAX_THREAD_NAME_LENGTH + 1];
+static THREADAPI_CREATE_OPTIONS g_saved_thread_options;
 
-THREADAPI_RESULT my_ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg)
+THREADAPI_RESULT my_ThreadAPI_CreateEx(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg, const THREADAPI_CREATE_OPTIONS* options)
 {
     g_saved_worker_thread_func = func;
     g_saved_worker_thread_func_context = arg;
+    g_saved_thread_options = *options;
+    (void)snprintf(g_saved_thread_name, sizeof(g_saved_thread_name), "%s", options->name);
     *threadHandle = test_thread_handle;
     return THREADAPI_OK;
 }
@@ -32,6 +37,8 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(LAZY_INIT_RESULT, LAZY_INIT_RESULT_VALUES);
 
 IMPLEMENT_UMOCK_C_ENUM_TYPE(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(TQUEUE_POP_RESULT, TQUEUE_POP_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_RESULT_VALUES);
 
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
@@ -48,61 +55,196 @@ MOCK_FUNCTION_END()
 MOCK_FUNCTION_WITH_CODE(, void, test_get_next_timer_instance, THREADPOOL*, threadpool)
 MOCK_FUNCTION_END()
 
-MOCK_FUNCTION_WITH_CODE(, int, mocked_sem_init, sem_t*, sem, int, pshared, unsigned int, value)
-MOCK_FUNCTION_END(0)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_timerfd_create, clockid_t, clockid, int, flags)
+MOCK_FUNCTION_END(TEST_TIMER_FD)
 
-MOCK_FUNCTION_WITH_CODE(, int, mocked_sem_post, sem_t*, sem)
+MOCK_FUNCTION_WITH_CODE(, int, mocked_timerfd_settime, int, fd, int, flags, const struct itimerspec* , new_value, struct itimerspec* , old_value)
 MOCK_FUNCTION_END(0)
 
-MOCK_FUNCTION_WITH_CODE(, int, mocked_sem_timedwait, sem_t*, sem, const struct timespec*, abs_timeout)
+MOCK_FUNCTION_WITH_CODE(, ssize_t, mocked_read, int, fd, void*, buf, size_t, count)
+MOCK_FUNCTION_END((ssize_t)sizeof(uint64_t))
+
+MOCK_FUNCTION_WITH_CODE(, int, mocked_close, int, fd)
 MOCK_FUNCTION_END(0)
 
-struct sigevent g_sigevent;
+static void threadpool_create_lane_queues_expectations(void)
+{
+    for (uint32_t i = 0; i < THREADPOOL_PRIORITY_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(TQUEUE_CREATE(THREADPOOL_TASK)(2048, UINT32_MAX, NULL, NULL, NULL));
+        STRICT_EXPECTED_CALL(TQUEUE_INITIALIZE_MOVE(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG));
+    }
+}
 
-MOCK_FUNCTION_WITH_CODE(, int, mocked_timer_create, clockid_t,clockid, struct sigevent*, sevp, timer_t *, timerid)
-    g_sigevent = *sevp;
-    timer_create(clockid, sevp, timerid);
-MOCK_FUNCTION_END(0)
+static void threadpool_free_lane_queues_expectations(void)
+{
+    for (uint32_t i = 0; i < THREADPOOL_PRIORITY_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(TQUEUE_ASSIGN(THREADPOOL_TASK)(IGNORED_ARG, NULL));
+    }
+}
 
-MOCK_FUNCTION_WITH_CODE(, int, mocked_timer_settime, timer_t, timerid, int, flags, const struct itimerspec* , new_value, struct itimerspec* , old_value)
-MOCK_FUNCTION_END(0)
+static void threadpool_create_local_queues_expectations(uint32_t thread_array_size)
+{
+    for (uint32_t i = 0; i < thread_array_size; i++)
+    {
+        STRICT_EXPECTED_CALL(threadpool_task_deque_init(IGNORED_ARG, 256));
+    }
+}
 
-MOCK_FUNCTION_WITH_CODE(, int, mocked_timer_delete, timer_t, timerid)
-MOCK_FUNCTION_END(0)
+static void threadpool_free_local_queues_expectations(uint32_t thread_array_size)
+{
+    for (uint32_t i = 0; i < thread_array_size; i++)
+    {
+        STRICT_EXPECTED_CALL(threadpool_task_deque_deinit(IGNORED_ARG));
+    }
+}
 
-MOCK_FUNCTION_WITH_CODE(, int, mocked_clock_gettime, clockid_t, clockid, struct timespec*, tp)
-MOCK_FUNCTION_END(0)
+static void threadpool_release_queued_tasks_expectations(uint32_t thread_array_size)
+{
+    for (uint32_t i = 0; i < thread_array_size; i++)
+    {
+        STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    }
+    for (uint32_t i = 0; i < THREADPOOL_PRIORITY_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // global queue of the lane is empty
+    }
+}
 
-static void threadpool_create_succeed_expectations(void)
+static void threadpool_steal_no_item_expectations(void)
+{
+    // the worker under test uses slot MIN_THREAD_COUNT - 1 (the last one started by threadpool_create), so it starts stealing with the slot after it
+    for (uint32_t i = MIN_THREAD_COUNT; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state is NOT_USED
+    }
+    for (uint32_t i = 0; i < MIN_THREAD_COUNT - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state is RUNNING
+        STRICT_EXPECTED_CALL(threadpool_task_deque_steal(IGNORED_ARG, IGNORED_ARG));
+    }
+}
+
+static void threadpool_pop_normal_lane_no_item_expectations(void)
+{
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // global queue
+    threadpool_steal_no_item_expectations();
+}
+
+static void threadpool_pop_no_item_expectations(void)
+{
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane
+    threadpool_pop_normal_lane_no_item_expectations();
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane
+}
+
+static void threadpool_dequeue_counters_expectations(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // executed_count
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // total_wait_time_us
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // wait_time_buckets
+}
+
+// first task of the first drain of the thread slot
+static void threadpool_dequeue_expectations(void)
+{
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // last_dequeue_time_ms
+    threadpool_dequeue_counters_expectations();
+}
+
+// next tasks of the drain, the time has not changed so the last dequeue time is not stored again
+static void threadpool_next_dequeue_expectations(void)
+{
+    threadpool_dequeue_counters_expectations();
+}
+
+static void threadpool_task_executed_expectations(void)
+{
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // execution_time_buckets
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // total_execution_time_us
+}
+
+static void threadpool_init_thread_slots_expectations(uint32_t thread_array_size)
+{
+    for (uint32_t i = 0; i < thread_array_size; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+            .CallCannotFail();
+    }
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, MIN_THREAD_COUNT))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0))
+        .CallCannotFail();
+}
+
+static void threadpool_create_with_thread_array_size_succeed_expectations(uint32_t thread_array_size)
 {
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(execution_engine_linux_get_parameters(test_execution_engine))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(malloc_2(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_init(IGNORED_ARG, 0, 0));
-    STRICT_EXPECTED_CALL(TQUEUE_CREATE(THANDLE(THREADPOOL_WORK_ITEM))(2048, UINT32_MAX, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(TQUEUE_INITIALIZE_MOVE(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_thread_parameters(test_execution_engine))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_2(thread_array_size, IGNORED_ARG));
+    threadpool_create_lane_queues_expectations();
+    threadpool_create_local_queues_expectations(thread_array_size);
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
         .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // timer_lazy
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // work_sequence
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // waiting_thread_count
+        .CallCannotFail();
+    threadpool_init_thread_slots_expectations(thread_array_size);
 
     for(size_t i = 0; i < MIN_THREAD_COUNT; i++)
     {
-        STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+            .CallCannotFail();
     }
 }
 
+static void threadpool_create_succeed_expectations(void)
+{
+    threadpool_create_with_thread_array_size_succeed_expectations(MAX_THREAD_COUNT);
+}
+
+static void threadpool_stop_threads_expectations(void)
+{
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWakeAll(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // work_sequence
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+}
+
+static void threadpool_signal_work_expectations(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)).CallCannotFail(); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).CallCannotFail(); // waiting_thread_count
+}
+
+static void threadpool_no_thread_added_expectations(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).CallCannotFail(); // thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).CallCannotFail(); // active_thread_count
+}
+
 static void threadpool_schedule_work_success_expectations(void)
 {
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));  // THANDLE_MALLOC
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG)).CallCannotFail(); // THANDLE_MALLOC
-    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL))
-        .SetFailReturn(TQUEUE_PUSH_ERROR);
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)).CallCannotFail(); // THANDLE_ASSIGN
-    STRICT_EXPECTED_CALL(mocked_sem_post(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)).CallCannotFail();
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL))
+        .SetFailReturn(TQUEUE_PUSH_ERROR);
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
 }
 
 static void threadpool_create_work_item_success_expectations(void)
@@ -128,50 +270,148 @@ static THANDLE(THREADPOOL) test_create_threadpool(void)
     return threadpool;
 }
 
-static void setup_lazy_init(void)
+static void threadpool_timer_do_init_expectations(void)
 {
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
-    // create one timer 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // state set to ARMED
-    STRICT_EXPECTED_CALL(mocked_timer_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(mocked_timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // timer_thread_stop
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+}
 
-    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, NULL);
-    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+static void threadpool_timer_wheel_arm_expectations(void)
+{
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(mocked_timerfd_settime(TEST_TIMER_FD, 0, IGNORED_ARG, NULL));
+}
 
-    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
-    umock_c_reset_all_calls();
+static void threadpool_timer_wheel_add_expectations(bool arm)
+{
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    if (arm)
+    {
+        threadpool_timer_wheel_arm_expectations();
+    }
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
 }
 
-static void setup_epoch_increment_expectations(void)
+static void threadpool_timer_start_expectations(bool do_init, bool arm)
 {
-    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)).CallCannotFail();
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)).CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); // THANDLE(THREADPOOL_TIMER)
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetFailReturn(LAZY_INIT_ERROR);
+    if (do_init)
+    {
+        threadpool_timer_do_init_expectations();
+    }
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); // timer data
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG)) // state set to ARMED
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // epoch_number
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)) // dispatch_pending
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1)) // ref_count
+        .CallCannotFail();
+    threadpool_timer_wheel_add_expectations(arm);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)) // reference to the threadpool
+        .CallCannotFail();
 }
 
-static THANDLE(THREADPOOL_TIMER) test_create_threadpool_and_start_timer(uint32_t start_delay_ms, uint32_t timer_period_ms, void* work_function_context, THANDLE(THREADPOOL)* threadpool)
+static void threadpool_timer_dispose_expectations(void)
 {
-    setup_lazy_init();
-    THANDLE(THREADPOOL) test_result = test_create_threadpool();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // state set to NOT_USED
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // ref_count
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // reference to the threadpool
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+}
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // state set to ARMED
-    setup_epoch_increment_expectations();
-    STRICT_EXPECTED_CALL(mocked_timer_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL));
+static void threadpool_timer_thread_read_expectations(void)
+{
+    STRICT_EXPECTED_CALL(mocked_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // timer_thread_stop
+}
+
+static void threadpool_timer_thread_stop_expectations(void)
+{
+    STRICT_EXPECTED_CALL(mocked_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // timer_thread_stop
+        .SetReturn(1);
+}
+
+static void threadpool_timer_wheel_expire_begin_expectations(double now_ms)
+{
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // timer_thread_stop
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(now_ms);
+}
 
-    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(test_result, start_delay_ms, timer_period_ms, test_work_function, work_function_context);
+static void threadpool_timer_dispatch_expectations(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0)); // dispatch_pending
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // epoch_number
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // ref_count
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+}
+
+static void threadpool_stop_timer_thread_expectations(void)
+{
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1)); // timer_thread_stop
+    STRICT_EXPECTED_CALL(mocked_timerfd_settime(TEST_TIMER_FD, 0, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_TIMER_FD));
+    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
+}
+
+static void threadpool_work_func_pop_timer_task_expectations(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_dequeue_expectations();
+}
+
+static void threadpool_work_func_no_more_work_expectations(void)
+{
+    threadpool_pop_no_item_expectations();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
+}
+
+static THANDLE(THREADPOOL_TIMER) test_start_timer(THANDLE(THREADPOOL) threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, void* work_function_context)
+{
+    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, start_delay_ms, timer_period_ms, test_work_function, work_function_context);
     ASSERT_IS_NOT_NULL(timer_instance);
-    THANDLE_MOVE(THREADPOOL)(threadpool, &test_result);
     umock_c_reset_all_calls();
     return timer_instance;
 }
 
+static THANDLE(THREADPOOL_TIMER) test_create_threadpool_and_start_timer(uint32_t start_delay_ms, uint32_t timer_period_ms, void* work_function_context, THANDLE(THREADPOOL)* threadpool)
+{
+    THANDLE(THREADPOOL) test_result = test_create_threadpool();
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_start_timer(test_result, start_delay_ms, timer_period_ms, work_function_context);
+    THANDLE_MOVE(THREADPOOL)(threadpool, &test_result);
+    return timer_instance;
+}
+
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -185,36 +425,42 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(EXECUTION_ENGINE_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(THREADAPI_RESULT, int);
     REGISTER_UMOCK_ALIAS_TYPE(clockid_t, int);
-    REGISTER_UMOCK_ALIAS_TYPE(timer_t, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ssize_t, long);
     REGISTER_UMOCK_ALIAS_TYPE(LAZY_INIT_FUNCTION, void*);
 
     REGISTER_GLOBAL_MOCK_RETURN(execution_engine_linux_get_parameters, &execution_engine);
-    REGISTER_GLOBAL_MOCK_RETURNS(mocked_sem_init, 0, -1);
-    REGISTER_GLOBAL_MOCK_RETURNS(mocked_clock_gettime, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURN(execution_engine_linux_get_thread_parameters, &test_thread_parameters);
+    REGISTER_GLOBAL_MOCK_RETURNS(wait_on_address, WAIT_ON_ADDRESS_OK, WAIT_ON_ADDRESS_ERROR);
     REGISTER_GLOBAL_MOCK_RETURN(ThreadAPI_Join, THREADAPI_OK);
-    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_Create, my_ThreadAPI_Create);
-    REGISTER_GLOBAL_MOCK_RETURNS(ThreadAPI_Create, THREADAPI_OK, THREADAPI_ERROR);
+    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_CreateEx, my_ThreadAPI_CreateEx);
+    REGISTER_GLOBAL_MOCK_RETURNS(ThreadAPI_CreateEx, THREADAPI_OK, THREADAPI_ERROR);
 
     REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
     REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
     REGISTER_INTERLOCKED_HL_GLOBAL_MOCK_HOOK();
     REGISTER_LAZY_INIT_GLOBAL_MOCK_HOOK();
+    REGISTER_SRW_LOCK_LL_GLOBAL_MOCK_HOOK();
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
-    REGISTER_GLOBAL_MOCK_RETURNS(mocked_timer_create, 0, 1);
-    REGISTER_GLOBAL_MOCK_RETURNS(mocked_timer_settime, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_timerfd_create, TEST_TIMER_FD, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_timerfd_settime, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_read, (ssize_t)sizeof(uint64_t), -1);
 
-    REGISTER_UMOCK_ALIAS_TYPE(TQUEUE_COPY_ITEM_FUNC(THANDLE(THREADPOOL_WORK_ITEM)), void*);
-    REGISTER_UMOCK_ALIAS_TYPE(TQUEUE_DISPOSE_ITEM_FUNC(THANDLE(THREADPOOL_WORK_ITEM)), void*);
-    REGISTER_UMOCK_ALIAS_TYPE(TQUEUE_CONDITION_FUNC(THANDLE(THREADPOOL_WORK_ITEM)), void*);
-    REGISTER_UMOCK_ALIAS_TYPE(TQUEUE(THANDLE(THREADPOOL_WORK_ITEM)), void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TQUEUE_COPY_ITEM_FUNC(THREADPOOL_TASK), void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TQUEUE_DISPOSE_ITEM_FUNC(THREADPOOL_TASK), void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TQUEUE_CONDITION_FUNC(THREADPOOL_TASK), void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TQUEUE(THREADPOOL_TASK), void*);
 
-    REGISTER_TQUEUE_THREADPOOL_WORK_ITEM_GLOBAL_MOCK_HOOK();
+    REGISTER_TQUEUE_THREADPOOL_TASK_GLOBAL_MOCK_HOOK();
+    REGISTER_THREADPOOL_TASK_DEQUE_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(threadpool_task_deque_init, MU_FAILURE);
 
     REGISTER_TYPE(INTERLOCKED_HL_RESULT, INTERLOCKED_HL_RESULT);
     REGISTER_TYPE(LAZY_INIT_RESULT, LAZY_INIT_RESULT);
     REGISTER_TYPE(TQUEUE_PUSH_RESULT, TQUEUE_PUSH_RESULT);
     REGISTER_TYPE(TQUEUE_POP_RESULT, TQUEUE_POP_RESULT);
+    REGISTER_TYPE(WAIT_ON_ADDRESS_RESULT, WAIT_ON_ADDRESS_RESULT);
+    REGISTER_TYPE(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_RESULT);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -230,6 +476,9 @@ TEST_FUNCTION_INITIALIZE(method_init)
     ASSERT_ARE_EQUAL(int, 0, umock_c_negative_tests_init(), "umock_c_negative_tests_init failed");
     g_saved_worker_thread_func = NULL;
     g_saved_worker_thread_func_context = NULL;
+    test_thread_parameters.pin_to_numa_node = false;
+    test_thread_parameters.numa_node = 0;
+    test_thread_parameters.thread_stack_size = 0;
 }
 
 TEST_FUNCTION_CLEANUP(method_cleanup)
@@ -253,10 +502,14 @@ TEST_FUNCTION(threadpool_create_with_NULL_execution_engine_fails)
 
 /* Tests_SRS_THREADPOOL_LINUX_07_001: [ threadpool_create shall allocate memory for a threadpool object and on success return a non-NULL handle to it. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_004: [ threadpool_create shall get the min_thread_count and max_thread_count thread parameters from the execution_engine. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_005: [ threadpool_create shall allocate memory for an array of thread handles of size min_thread_count and on success return a non-NULL handle to it. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_013: [ threadpool_create shall create a queue of threadpool work items by calling TQUEUE_CREATE(THANDLE(THREADPOOL_WORK_ITEM)) with initial size 2048 and max size UINT32_MAX. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_009: [ threadpool_create shall create a shared semaphore with initialized value zero. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_020: [ threadpool_create shall create min_thread_count number of threads for threadpool using ThreadAPI_Create. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_002: [ threadpool_create shall allocate memory for an array of thread slots of size max_thread_count (or min_thread_count if max_thread_count is 0). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_003: [ threadpool_create shall initialize the state of all thread slots to NOT_USED. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_004: [ threadpool_create shall initialize the number of live threads to min_thread_count and the number of active threads to 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_013: [ threadpool_create shall create a queue of threadpool tasks for each priority lane by calling TQUEUE_CREATE(THREADPOOL_TASK) with initial size 2048, max size UINT32_MAX and no copy and dispose functions. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_042: [ threadpool_create shall initialize a local queue of LOCAL_TASK_ARRAY_SIZE tasks for each thread slot by calling threadpool_task_deque_init and shall set the first slot to steal from to the slot after it. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_033: [ threadpool_create shall initialize the work sequence and the number of waiting threads to 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_043: [ threadpool_create shall initialize the lazy initialization state of the timers, the timer thread is started by the first threadpool_timer_start. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_07_020: [ threadpool_create shall create min_thread_count number of threads for threadpool using ThreadAPI_CreateEx. ]*/
 TEST_FUNCTION(threadpool_create_succeeds)
 {
     //arrange
@@ -299,10 +552,13 @@ TEST_FUNCTION(when_underlying_calls_fail_threadpool_create_also_fails)
 
 /* Tests_SRS_THREADPOOL_LINUX_07_001: [ threadpool_create shall allocate memory for a threadpool object and on success return a non-NULL handle to it. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_004: [ threadpool_create shall get the min_thread_count and max_thread_count thread parameters from the execution_engine. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_005: [ threadpool_create shall allocate memory for an array of thread handles of size min_thread_count and on success return a non-NULL handle to it. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_013: [ threadpool_create shall create a queue of threadpool work items by calling TQUEUE_CREATE(THANDLE(THREADPOOL_WORK_ITEM)) with initial size 2048 and max size UINT32_MAX. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_009: [ threadpool_create shall create a shared semaphore with initialized value zero. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_020: [ threadpool_create shall create min_thread_count number of threads for threadpool using ThreadAPI_Create. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_002: [ threadpool_create shall allocate memory for an array of thread slots of size max_thread_count (or min_thread_count if max_thread_count is 0). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_003: [ threadpool_create shall initialize the state of all thread slots to NOT_USED. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_004: [ threadpool_create shall initialize the number of live threads to min_thread_count and the number of active threads to 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_013: [ threadpool_create shall create a queue of threadpool tasks for each priority lane by calling TQUEUE_CREATE(THREADPOOL_TASK) with initial size 2048, max size UINT32_MAX and no copy and dispose functions. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_042: [ threadpool_create shall initialize a local queue of LOCAL_TASK_ARRAY_SIZE tasks for each thread slot by calling threadpool_task_deque_init and shall set the first slot to steal from to the slot after it. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_033: [ threadpool_create shall initialize the work sequence and the number of waiting threads to 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_07_020: [ threadpool_create shall create min_thread_count number of threads for threadpool using ThreadAPI_CreateEx. ]*/
 TEST_FUNCTION(creating_2_threadpool_succeeds)
 {
     // arrange
@@ -324,27 +580,61 @@ TEST_FUNCTION(creating_2_threadpool_succeeds)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool_2, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_020: [ threadpool_create shall create min_thread_count number of threads for threadpool using ThreadAPI_Create. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_145: [ threadpool_create shall get the NUMA node and the thread stack size from the execution_engine by calling execution_engine_linux_get_thread_parameters. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_146: [ The worker threads shall be created with the name tp_worker_<slot index>, the thread stack size from the thread parameters and, if pin_to_numa_node is true, restricted to the CPUs of numa_node. ]*/
+TEST_FUNCTION(threadpool_create_creates_the_worker_threads_with_the_thread_parameters_of_the_execution_engine)
+{
+    // arrange
+    test_thread_parameters.pin_to_numa_node = true;
+    test_thread_parameters.numa_node = 1;
+    test_thread_parameters.thread_stack_size = 256 * 1024;
+    threadpool_create_succeed_expectations();
+
+    // act
+    THANDLE(THREADPOOL) threadpool = threadpool_create(test_execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(threadpool);
+    // the last thread started by threadpool_create is the one in slot MIN_THREAD_COUNT - 1
+    ASSERT_ARE_EQUAL(char_ptr, "tp_worker_4", g_saved_thread_name);
+    ASSERT_ARE_EQUAL(size_t, 256 * 1024, g_saved_thread_options.stack_size);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g_saved_thread_options.cpu_count);
+    ASSERT_IS_TRUE(g_saved_thread_options.use_numa_node);
+    ASSERT_ARE_EQUAL(uint32_t, 1, g_saved_thread_options.numa_node);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_07_020: [ threadpool_create shall create min_thread_count number of threads for threadpool using ThreadAPI_CreateEx. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_022: [ If one of the thread creation fails, threadpool_create shall fail, terminate all threads already created and return NULL. ]*/
-TEST_FUNCTION(threadpool_create_fails_when_ThreadAPI_Create_fails)
+TEST_FUNCTION(threadpool_create_fails_when_ThreadAPI_CreateEx_fails)
 {
     // arrange
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(execution_engine_linux_get_parameters(test_execution_engine));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_thread_parameters(test_execution_engine));
     STRICT_EXPECTED_CALL(malloc_2(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_init(IGNORED_ARG, 0, 0));
-    STRICT_EXPECTED_CALL(TQUEUE_CREATE(THANDLE(THREADPOOL_WORK_ITEM))(2048, UINT32_MAX, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(TQUEUE_INITIALIZE_MOVE(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG));
+    threadpool_create_lane_queues_expectations();
+    threadpool_create_local_queues_expectations(MAX_THREAD_COUNT);
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // timer_lazy
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // waiting_thread_count
+    threadpool_init_thread_slots_expectations(MAX_THREAD_COUNT);
 
-    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
         .SetReturn(THREADAPI_ERROR);
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    threadpool_stop_threads_expectations();
     STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(TQUEUE_ASSIGN(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, NULL));
+    threadpool_free_local_queues_expectations(MAX_THREAD_COUNT);
+    threadpool_free_lane_queues_expectations();
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
@@ -359,21 +649,28 @@ TEST_FUNCTION(threadpool_create_fails_when_ThreadAPI_Create_fails)
 /* threadpool_dispose */
 
 /* Tests_SRS_THREADPOOL_LINUX_07_016: [ threadpool_dispose shall free the memory allocated in threadpool_create. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_014: [ threadpool_dispose shall destroy the semphore by calling sem_destroy. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_027: [ threadpool_dispose shall join all threads in the threadpool. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_089: [ threadpool_dispose shall signal all threads to return. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_032: [ threadpool_stop_threads shall increment the work sequence and wake all waiting threads by calling wake_by_address_all. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_023: [ threadpool_dispose shall join all threads whose slot is in state RUNNING or EXITED. ]*/
 TEST_FUNCTION(threadpool_dispose_frees_resources)
 {
     // arrange
     THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWakeAll(IGNORED_ARG, IGNORED_ARG));
-    for(size_t i = 0; i < MIN_THREAD_COUNT; i++)
+    threadpool_stop_threads_expectations();
+    for(size_t i = 0; i < MAX_THREAD_COUNT; i++)
     {
-        STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        if (i < MIN_THREAD_COUNT)
+        {
+            STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+        }
     }
-    STRICT_EXPECTED_CALL(TQUEUE_ASSIGN(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, NULL));
+    threadpool_release_queued_tasks_expectations(MAX_THREAD_COUNT);
+    threadpool_free_local_queues_expectations(MAX_THREAD_COUNT);
+    threadpool_free_lane_queues_expectations();
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
@@ -419,9 +716,11 @@ TEST_FUNCTION(threadpool_schedule_work_with_NULL_work_function_fails)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_051: [ threadpool_schedule_work shall unblock the threadpool semaphore by calling sem_post. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_014: [ threadpool_schedule_work shall create a new THANDLE(THREADPOOL_WORK_ITEM) and save the work_function and work_function_context in it. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_015: [ threadpool_schedule_work shall push the newly created THANDLE(THREADPOOL_WORK_ITEM) in the work item queue. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_034: [ threadpool_schedule_work shall signal that work is available by calling threadpool_signal_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_030: [ threadpool_signal_work shall increment the work sequence. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_014: [ threadpool_schedule_work shall store work_function and work_function_context in a THREADPOOL_TASK. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_015: [ threadpool_schedule_work shall push the task in a task queue of the normal priority lane by calling threadpool_push_task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_038: [ Otherwise, or if the local queue is full, threadpool_push_task shall push the task in the global task queue of the priority lane by calling TQUEUE_PUSH(THREADPOOL_TASK). ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_047: [ threadpool_schedule_work shall return zero on success. ]*/
 TEST_FUNCTION(threadpool_schedule_work_succeeds)
 {
@@ -443,9 +742,38 @@ TEST_FUNCTION(threadpool_schedule_work_succeeds)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_051: [ threadpool_schedule_work shall unblock the threadpool semaphore by calling sem_post. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_014: [ threadpool_schedule_work shall create a new THANDLE(THREADPOOL_WORK_ITEM) and save the work_function and work_function_context in it. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_015: [ threadpool_schedule_work shall push the newly created THANDLE(THREADPOOL_WORK_ITEM) in the work item queue. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_030: [ threadpool_signal_work shall increment the work sequence. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_031: [ Otherwise, if there are threads waiting for work, threadpool_signal_work shall wake one of them for each of the work_item_count work items by calling wake_by_address_single. ]*/
+TEST_FUNCTION(threadpool_schedule_work_wakes_one_waiting_thread)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    int result;
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // waiting_thread_count
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    threadpool_no_thread_added_expectations();
+
+    // act
+    result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_034: [ threadpool_schedule_work shall signal that work is available by calling threadpool_signal_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_030: [ threadpool_signal_work shall increment the work sequence. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_014: [ threadpool_schedule_work shall store work_function and work_function_context in a THREADPOOL_TASK. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_015: [ threadpool_schedule_work shall push the task in a task queue of the normal priority lane by calling threadpool_push_task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_038: [ Otherwise, or if the local queue is full, threadpool_push_task shall push the task in the global task queue of the priority lane by calling TQUEUE_PUSH(THREADPOOL_TASK). ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_047: [ threadpool_schedule_work shall return zero on success. ]*/
 TEST_FUNCTION(threadpool_schedule_work_succeeds_with_NULL_work_function_context)
 {
@@ -515,15 +843,30 @@ TEST_FUNCTION(threadpool_work_func_parameter_NULL_succeeds)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_074: [ threadpool_work_func shall get the real time by calling clock_gettime to set the waiting time for semaphore. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_088: [ If clock_gettime fails, threadpool_work_func shall run the loop again. ]*/
-TEST_FUNCTION(threadpool_work_func_succeeds_when_clock_gettime_fails)
+static void threadpool_work_func_empty_queue_expectations(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    threadpool_pop_no_item_expectations();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_027: [ If the number of live threads is greater than min_thread_count, threadpool_work_func shall use THREADPOOL_IDLE_THREAD_TIMEOUT_MS as wait timeout, otherwise it shall wait without a timeout (UINT32_MAX). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_028: [ threadpool_work_func shall increment the number of waiting threads, wait for the work sequence to change from the value read before draining the queue by calling wait_on_address and then decrement the number of waiting threads. ]*/
+TEST_FUNCTION(threadpool_work_func_waits_for_work_without_timeout_when_at_min_thread_count)
 {
     //arrange
     THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
-    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_REALTIME, IGNORED_ARG)).SetReturn(-1);
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // stop_thread
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // thread_count is MIN_THREAD_COUNT
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // waiting_thread_count
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, UINT32_MAX));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // waiting_thread_count
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
 
     //act
     g_saved_worker_thread_func(g_saved_worker_thread_func_context);
@@ -535,15 +878,22 @@ TEST_FUNCTION(threadpool_work_func_succeeds_when_clock_gettime_fails)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_087: [ If sem_timedwait fails, threadpool_work_func shall timeout and run the loop again. ]*/
-TEST_FUNCTION(threadpool_work_func_succeeds_when_sem_timedwait_fails)
+/* Tests_SRS_THREADPOOL_LINUX_12_029: [ If wait_on_address returns WAIT_ON_ADDRESS_ERROR, threadpool_work_func shall run the loop again. ]*/
+TEST_FUNCTION(threadpool_work_func_runs_the_loop_again_when_wait_on_address_fails)
 {
     //arrange
     THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
-    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_REALTIME, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_timedwait(IGNORED_ARG, IGNORED_ARG)).SetReturn(1);
-    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // stop_thread
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // thread_count
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // waiting_thread_count
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, UINT32_MAX))
+        .SetReturn(WAIT_ON_ADDRESS_ERROR);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // waiting_thread_count
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
 
     //act
     g_saved_worker_thread_func(g_saved_worker_thread_func_context);
@@ -555,12 +905,13 @@ TEST_FUNCTION(threadpool_work_func_succeeds_when_sem_timedwait_fails)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_074: [ threadpool_work_func shall get the real time by calling clock_gettime to set the waiting time for semaphore. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_075: [ threadpool_work_func shall wait on the semaphore with a time limit. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_016: [ threadpool_work_func shall pop an item from the task queue by calling TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM)). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_026: [ threadpool_work_func shall read the current value of the work sequence before draining the task queue. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_008: [ threadpool_work_func shall increment the number of active threads before draining the task queue and decrement it after the queue has been drained. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_016: [ threadpool_work_func shall pop a task by calling threadpool_pop_task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_039: [ For the normal priority lane, threadpool_pop_task shall pop the newest task from the bottom of the local queue of the thread by calling threadpool_task_deque_pop. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_040: [ If the local queue is empty, threadpool_pop_task shall pop a task from the global task queue of the normal priority lane by calling TQUEUE_POP(THREADPOOL_TASK). ]*/
 /* Tests_SRS_THREADPOOL_LINUX_01_017: [ If the pop returns TQUEUE_POP_OK: ]*/
     /* Tests_SRS_THREADPOOL_LINUX_07_084: [ threadpool_work_func shall execute the work_function with work_function_ctx. ]*/
-    /* Tests_SRS_THREADPOOL_LINUX_01_018: [ threadpool_work_func shall release the reference to the work item. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_085: [ threadpool_work_func shall loop until the flag to stop the threads is not set to 1. ]*/
 TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work)
 {
@@ -571,17 +922,18 @@ TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work)
     ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_work_function, (void*)0x4242));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_REALTIME, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_timedwait(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_dequeue_expectations();
     STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    threadpool_task_executed_expectations();
 
     // 2nd item attempt
-    STRICT_EXPECTED_CALL(TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_pop_no_item_expectations();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
 
     //act
@@ -594,12 +946,13 @@ TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_074: [ threadpool_work_func shall get the real time by calling clock_gettime to set the waiting time for semaphore. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_075: [ threadpool_work_func shall wait on the semaphore with a time limit. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_016: [ threadpool_work_func shall pop an item from the task queue by calling TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM)). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_026: [ threadpool_work_func shall read the current value of the work sequence before draining the task queue. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_008: [ threadpool_work_func shall increment the number of active threads before draining the task queue and decrement it after the queue has been drained. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_016: [ threadpool_work_func shall pop a task by calling threadpool_pop_task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_039: [ For the normal priority lane, threadpool_pop_task shall pop the newest task from the bottom of the local queue of the thread by calling threadpool_task_deque_pop. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_040: [ If the local queue is empty, threadpool_pop_task shall pop a task from the global task queue of the normal priority lane by calling TQUEUE_POP(THREADPOOL_TASK). ]*/
 /* Tests_SRS_THREADPOOL_LINUX_01_017: [ If the pop returns TQUEUE_POP_OK: ]*/
     /* Tests_SRS_THREADPOOL_LINUX_07_084: [ threadpool_work_func shall execute the work_function with work_function_ctx. ]*/
-    /* Tests_SRS_THREADPOOL_LINUX_01_018: [ threadpool_work_func shall release the reference to the work item. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_085: [ threadpool_work_func shall loop until the flag to stop the threads is not set to 1. ]*/
 TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work_2_items)
 {
@@ -612,24 +965,25 @@ TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work_2_items
     ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_work_function, (void*)0x4242));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_REALTIME, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_timedwait(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_dequeue_expectations();
     STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    threadpool_task_executed_expectations();
 
-    STRICT_EXPECTED_CALL(TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_next_dequeue_expectations();
     STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    threadpool_task_executed_expectations();
 
     // 3rd item attempt
-    STRICT_EXPECTED_CALL(TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_pop_no_item_expectations();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
 
     //act
@@ -642,12 +996,74 @@ TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work_2_items
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_074: [ threadpool_work_func shall get the real time by calling clock_gettime to set the waiting time for semaphore. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_075: [ threadpool_work_func shall wait on the semaphore with a time limit. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_016: [ threadpool_work_func shall pop an item from the task queue by calling TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM)). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_009: [ For the first task of a drain threadpool_work_func shall record the time of the dequeue by calling timer_global_get_elapsed_us, for the other tasks it shall use the time at which the previous task finished executing. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_151: [ If the time of the dequeue in milliseconds differs from the last one stored by the thread slot, threadpool_work_func shall store it in the last dequeue time of the threadpool by calling interlocked_exchange_64. ]*/
+TEST_FUNCTION(threadpool_work_func_stores_the_last_dequeue_time_only_when_it_changed)
+{
+    //arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        threadpool_schedule_work_success_expectations();
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_work_function, (void*)0x4242));
+    }
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1500.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // last_dequeue_time_ms
+    threadpool_dequeue_counters_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1900.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // execution_time_buckets
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // total_execution_time_us
+
+    // dequeued at 1900 us, still in the same millisecond
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_dequeue_counters_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(2100.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // execution_time_buckets
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG)); // total_execution_time_us
+
+    // dequeued at 2100 us
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 2)); // last_dequeue_time_ms
+    threadpool_dequeue_counters_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
+    threadpool_task_executed_expectations();
+
+    threadpool_work_func_no_more_work_expectations();
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_026: [ threadpool_work_func shall read the current value of the work sequence before draining the task queue. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_008: [ threadpool_work_func shall increment the number of active threads before draining the task queue and decrement it after the queue has been drained. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_016: [ threadpool_work_func shall pop a task by calling threadpool_pop_task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_039: [ For the normal priority lane, threadpool_pop_task shall pop the newest task from the bottom of the local queue of the thread by calling threadpool_task_deque_pop. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_040: [ If the local queue is empty, threadpool_pop_task shall pop a task from the global task queue of the normal priority lane by calling TQUEUE_POP(THREADPOOL_TASK). ]*/
 /* Tests_SRS_THREADPOOL_LINUX_01_017: [ If the pop returns TQUEUE_POP_OK: ]*/
     /* Tests_SRS_THREADPOOL_LINUX_07_084: [ threadpool_work_func shall execute the work_function with work_function_ctx. ]*/
-    /* Tests_SRS_THREADPOOL_LINUX_01_018: [ threadpool_work_func shall release the reference to the work item. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_085: [ threadpool_work_func shall loop until the flag to stop the threads is not set to 1. ]*/
 TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work_item)
 {
@@ -659,17 +1075,18 @@ TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work_item)
     THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_clock_gettime(CLOCK_REALTIME, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_timedwait(IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_dequeue_expectations();
     STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    threadpool_task_executed_expectations();
 
     // 2nd item attempt
-    STRICT_EXPECTED_CALL(TQUEUE_POP(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_pop_no_item_expectations();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
     STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
 
     //act
@@ -682,109 +1099,188 @@ TEST_FUNCTION(threadpool_work_func_succeeds_for_threadpool_schedule_work_item)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* threadpool_timer_start */
+static void test_schedule_work_from_work_item(void* context)
+{
+    THANDLE(THREADPOOL)* threadpool = context;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(*threadpool, test_work_function, (void*)0x4243));
+}
 
-/* Tests_SRS_THREADPOOL_LINUX_07_054: [ If threadpool is NULL, threadpool_timer_start shall fail and return NULL. ]*/
-TEST_FUNCTION(threadpool_timer_start_with_NULL_threadpool_fails)
+/* Tests_SRS_THREADPOOL_LINUX_12_036: [ threadpool_work_func shall remember the thread slot of the current thread so that work scheduled from work items goes to the local queue of the thread. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_037: [ If priority is THREADPOOL_PRIORITY_NORMAL and the current thread is a worker thread of threadpool, threadpool_push_task shall push the task at the bottom of the local queue of the thread by calling threadpool_task_deque_push. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_039: [ For the normal priority lane, threadpool_pop_task shall pop the newest task from the bottom of the local queue of the thread by calling threadpool_task_deque_pop. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_041: [ If the global task queue is empty, threadpool_pop_task shall try to steal the oldest task from the top of the local queue of each other thread slot in the RUNNING state by calling threadpool_task_deque_steal, starting with the slot after the one it last stole from. ]*/
+TEST_FUNCTION(threadpool_work_func_executes_work_scheduled_from_a_work_item_from_the_local_queue)
 {
-    // arrange
+    //arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_schedule_work_from_work_item, (void*)&threadpool));
+    umock_c_reset_all_calls();
 
-    // act
-    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(NULL, 42, 2000, test_work_function, (void*)0x4243);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_dequeue_expectations();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(threadpool_task_deque_push(IGNORED_ARG, IGNORED_ARG)); // pushed in the local queue
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+    threadpool_task_executed_expectations();
+
+    // the item scheduled from the work item is in the local queue
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue
+    threadpool_next_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    threadpool_task_executed_expectations();
 
-    // assert
+    threadpool_pop_no_item_expectations();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NULL(timer_instance);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_055: [ If work_function is NULL, threadpool_timer_start shall fail and return NULL. ]*/
-TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_fails)
+/* Tests_SRS_THREADPOOL_LINUX_12_041: [ If the global task queue is empty, threadpool_pop_task shall try to steal the oldest task from the top of the local queue of each other thread slot in the RUNNING state by calling threadpool_task_deque_steal, starting with the slot after the one it last stole from. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_149: [ After a successful steal, threadpool_pop_task shall remember the slot after the victim as the first slot to steal from next time. ]*/
+TEST_FUNCTION(threadpool_work_func_steals_from_the_running_threads_and_starts_with_the_slot_after_the_last_victim_next_time)
 {
-    // arrange
+    //arrange
     THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_TASK stolen_task = { test_work_function, (void*)0x4245, 0 };
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // global queue is empty
+    for (uint32_t i = MIN_THREAD_COUNT; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state is NOT_USED
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot 0 state is RUNNING
+    STRICT_EXPECTED_CALL(threadpool_task_deque_steal(IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_task(&stolen_task, sizeof(stolen_task))
+        .SetReturn(THREADPOOL_TASK_DEQUE_OK);
+    threadpool_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    threadpool_task_executed_expectations();
+
+    // the next steal starts with slot 1
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // global queue is empty
+    for (uint32_t i = 1; i < MIN_THREAD_COUNT - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state is RUNNING
+        STRICT_EXPECTED_CALL(threadpool_task_deque_steal(IGNORED_ARG, IGNORED_ARG));
+    }
+    for (uint32_t i = MIN_THREAD_COUNT; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state is NOT_USED
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot 0 state is RUNNING
+    STRICT_EXPECTED_CALL(threadpool_task_deque_steal(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane is empty
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
 
-    // act
-    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, NULL, (void*)0x4243);
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
 
-    // assert
+    //assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NULL(timer_instance);
 
     // cleanup
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_01_002: [ threadpool_timer_start shall find an unused entry in the timers table maintained by the module. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_001: [ If all timer entries are used, threadpool_timer_start shall fail and return NULL. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_003: [ 1024 timers shall be supported. ]*/
-TEST_FUNCTION(threadpool_timer_start_fails_when_no_available_slot_in_timer_table)
+/* threadpool_timer_start */
+
+/* Tests_SRS_THREADPOOL_LINUX_07_054: [ If threadpool is NULL, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_threadpool_fails)
 {
     // arrange
-    setup_lazy_init();
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
-
-    THANDLE(THREADPOOL_TIMER)* timers = malloc_2(MAX_TIMERS, sizeof(THANDLE(THREADPOOL_TIMER)));
-    ASSERT_IS_NOT_NULL(timers);
-    for (uint32_t i = 0; i < MAX_TIMERS; i++)
-    {
-        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-        STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
-        THANDLE(THREADPOOL_TIMER) timer_temp = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243);
 
-        THANDLE_INITIALIZE_MOVE(THREADPOOL_TIMER)((void*)&timers[i], &timer_temp);
-        ASSERT_IS_NOT_NULL(timers[i]);
-        umock_c_reset_all_calls();
+    // act
+    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(NULL, 42, 2000, test_work_function, (void*)0x4243);
 
-        LogInfo("Timer %" PRIu32 " created", i);
-    }
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(timer_instance);
+}
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    for (uint32_t i = 0; i < MAX_TIMERS; i++)
-    {
-        STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // attempt to set state to ARMED
-    }
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+/* Tests_SRS_THREADPOOL_LINUX_07_055: [ If work_function is NULL, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
-    //act
-    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243);
+    // act
+    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, NULL, (void*)0x4243);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_IS_NULL(timer_instance);
 
     // cleanup
-    for (uint32_t i = 0; i < MAX_TIMERS; i++)
-    {
-        THANDLE_ASSIGN(THREADPOOL_TIMER)((void*)&timers[i], NULL);
-    }
-    free((void*)timers);
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
 /* Tests_SRS_THREADPOOL_LINUX_07_058: [ threadpool_timer_start shall allocate memory for THANDLE(THREADPOOL_TIMER), passing threadpool_timer_dispose as dispose function and store work_function and work_function_ctx in it. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_096: [ threadpool_timer_start shall call lazy_init with do_init as initialization function.  ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_004: [ do_init shall initialize the state for each timer to NOT_USED. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_07_096: [ threadpool_timer_start shall call lazy_init with do_init as initialization function to start the timer thread of the threadpool. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_044: [ do_init shall initialize the timer lock by calling srw_lock_ll_init. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_045: [ do_init shall initialize all the slots of the timer wheel as empty and set the current tick of the timer wheel by calling timer_global_get_elapsed_ms. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_046: [ do_init shall create the timer fd by calling timerfd_create with CLOCK_MONOTONIC. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_047: [ do_init shall start the timer thread by calling ThreadAPI_CreateEx with threadpool_timer_thread_func, the name tp_timer and the same thread stack size and NUMA node as the worker threads. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_099: [ do_init shall succeed and return 0. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_057: [ work_function_ctx shall be allowed to be NULL. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_005: [ If an unused entry is found, it's state shall be marked as ARMED. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_011: [ threadpool_timer_start shall increment the timer epoch number and store it in the selected entry in the timer table. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_059: [ threadpool_timer_start shall call timer_create and timer_settime to schedule execution. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_049: [ threadpool_timer_start shall allocate memory for the timer data. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_051: [ threadpool_timer_start shall set the state of the timer to ARMED, its epoch number to 0 and its reference count to 1. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_052: [ threadpool_timer_start shall add the timer to the timer wheel to expire after start_delay_ms by calling threadpool_timer_wheel_add. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_054: [ threadpool_timer_wheel_add shall perform the following steps while holding the timer lock of the threadpool, acquired by calling srw_lock_ll_acquire_exclusive and released by calling srw_lock_ll_release_exclusive. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_056: [ threadpool_timer_wheel_add shall insert the timer in the slot of the lowest level of the timer wheel which covers the expiration time, computed by calling timer_global_get_elapsed_ms and adding delay_ms. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_057: [ threadpool_timer_wheel_add shall arm the timer fd by calling threadpool_timer_wheel_arm. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_059: [ threadpool_timer_wheel_arm shall compute the next tick at which a slot of the timer wheel needs processing. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_061: [ Otherwise threadpool_timer_wheel_arm shall call timerfd_settime to expire at the next tick, or to disarm the timer fd if the timer wheel is empty. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_053: [ threadpool_timer_start shall store a reference to threadpool in the timer. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_062: [ threadpool_timer_start shall succeed and return a non-NULL handle. ]*/
 TEST_FUNCTION(threadpool_timer_start_succeeds)
 {
     // arrange
-    setup_lazy_init();
     THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // state set to ARMED
-    setup_epoch_increment_expectations();
-    STRICT_EXPECTED_CALL(mocked_timer_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL));
+    threadpool_timer_start_expectations(true, true);
+
+    // act
+    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(timer_instance);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_047: [ do_init shall start the timer thread by calling ThreadAPI_CreateEx with threadpool_timer_thread_func, the name tp_timer and the same thread stack size and NUMA node as the worker threads. ]*/
+TEST_FUNCTION(threadpool_timer_start_starts_the_timer_thread_with_the_thread_parameters_of_the_execution_engine)
+{
+    // arrange
+    test_thread_parameters.pin_to_numa_node = true;
+    test_thread_parameters.numa_node = 1;
+    test_thread_parameters.thread_stack_size = 256 * 1024;
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_timer_start_expectations(true, true);
 
     // act
     THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243);
@@ -792,6 +1288,10 @@ TEST_FUNCTION(threadpool_timer_start_succeeds)
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_IS_NOT_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, "tp_timer", g_saved_thread_name);
+    ASSERT_ARE_EQUAL(size_t, 256 * 1024, g_saved_thread_options.stack_size);
+    ASSERT_IS_TRUE(g_saved_thread_options.use_numa_node);
+    ASSERT_ARE_EQUAL(uint32_t, 1, g_saved_thread_options.numa_node);
 
     // cleanup
     THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
@@ -800,26 +1300,13 @@ TEST_FUNCTION(threadpool_timer_start_succeeds)
 
 /* Tests_SRS_THREADPOOL_LINUX_07_057: [ work_function_ctx shall be allowed to be NULL. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_058: [ threadpool_timer_start shall allocate memory for THANDLE(THREADPOOL_TIMER), passing threadpool_timer_dispose as dispose function and store work_function and work_function_ctx in it. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_096: [ threadpool_timer_start shall call lazy_init with do_init as initialization function.  ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_004: [ do_init shall initialize the state for each timer to NOT_USED. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_099: [ do_init shall succeed and return 0. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_005: [ If an unused entry is found, it's state shall be marked as ARMED. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_011: [ threadpool_timer_start shall increment the timer epoch number and store it in the selected entry in the timer table. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_059: [ threadpool_timer_start shall call timer_create and timer_settime to schedule execution. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_062: [ threadpool_timer_start shall succeed and return a non-NULL handle. ]*/
 TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_context_succeeds)
 {
     // arrange
-    setup_lazy_init();
     THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
-    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // state set to ARMED
-    setup_epoch_increment_expectations();
-    STRICT_EXPECTED_CALL(mocked_timer_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL));
+    threadpool_timer_start_expectations(true, true);
 
     // act
     THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, NULL);
@@ -833,27 +1320,70 @@ TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_context_succeeds)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_057: [ work_function_ctx shall be allowed to be NULL. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_058: [ threadpool_timer_start shall allocate memory for THANDLE(THREADPOOL_TIMER), passing threadpool_timer_dispose as dispose function and store work_function and work_function_ctx in it. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_059: [ threadpool_timer_start shall call timer_create and timer_settime to schedule execution. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_07_063: [ If timer_settime fails, threadpool_timer_start shall delete the timer by calling timer_delete. ]*/
-TEST_FUNCTION(when_timer_set_time_functions_fails_threadpool_timer_start_fails)
+/* Tests_SRS_THREADPOOL_LINUX_07_096: [ threadpool_timer_start shall call lazy_init with do_init as initialization function to start the timer thread of the threadpool. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_060: [ If the timer fd is already armed for the next tick, threadpool_timer_wheel_arm shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_timer_start_for_a_2nd_timer_does_not_start_another_timer_thread)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = NULL;
+    THANDLE(THREADPOOL_TIMER) timer_instance_1 = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
+
+    threadpool_timer_start_expectations(false, false);
+
+    // act
+    THANDLE(THREADPOOL_TIMER) timer_instance_2 = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4244);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(timer_instance_2);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance_1, NULL);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance_2, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_048: [ If any error occurs, do_init shall fail and return a non-zero value. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(when_srw_lock_ll_init_fails_threadpool_timer_start_fails)
 {
     // arrange
-    setup_lazy_init();
     THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
     STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // state set to ARMED
-    setup_epoch_increment_expectations();
-    STRICT_EXPECTED_CALL(mocked_timer_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL)).SetReturn(-1);
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(timer_instance);
 
-    STRICT_EXPECTED_CALL(mocked_timer_delete(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG)); // state revert to NOT_USED
-    STRICT_EXPECTED_CALL(gballoc_hl_free(IGNORED_ARG));
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_048: [ If any error occurs, do_init shall fail and return a non-zero value. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(when_timerfd_create_fails_threadpool_timer_start_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(mocked_timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
     THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243);
@@ -866,20 +1396,50 @@ TEST_FUNCTION(when_timer_set_time_functions_fails_threadpool_timer_start_fails)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
+/* Tests_SRS_THREADPOOL_LINUX_12_048: [ If any error occurs, do_init shall fail and return a non-zero value. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
-TEST_FUNCTION(when_underlying_calls_fail_threadpool_timer_start_fails)
+TEST_FUNCTION(when_creating_the_timer_thread_fails_threadpool_timer_start_fails)
 {
     // arrange
     THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1)).CallCannotFail();
-    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .SetFailReturn(LAZY_INIT_ERROR);
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)).CallCannotFail();  // state set to ARMED
-    setup_epoch_increment_expectations();
-    STRICT_EXPECTED_CALL(mocked_timer_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(mocked_timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // timer_thread_stop
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(THREADAPI_ERROR);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_TIMER_FD));
+    STRICT_EXPECTED_CALL(srw_lock_ll_deinit(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(timer_instance);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_058: [ If threadpool_timer_wheel_arm fails, threadpool_timer_wheel_add shall remove the timer from the timer wheel, fail and return a non-zero value. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_062: [ If timerfd_settime fails, threadpool_timer_wheel_arm shall fail and return a non-zero value. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_07_060: [ If any error occurs, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_timer_start_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = NULL;
+    THANDLE(THREADPOOL_TIMER) first_timer = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&first_timer, NULL);
+    umock_c_reset_all_calls();
+
+    // the timer fd is armed for the first timer, a different delay makes threadpool_timer_start arm it again
+    threadpool_timer_start_expectations(false, true);
 
     umock_c_negative_tests_snapshot();
 
@@ -891,7 +1451,7 @@ TEST_FUNCTION(when_underlying_calls_fail_threadpool_timer_start_fails)
             umock_c_negative_tests_fail_call(i);
 
             // act
-            THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243);
+            THANDLE(THREADPOOL_TIMER) timer_instance = threadpool_timer_start(threadpool, 43, 2000, test_work_function, (void*)0x4243);
 
             // assert
             ASSERT_IS_NULL(timer_instance, "On failed call %zu", i);
@@ -917,7 +1477,8 @@ TEST_FUNCTION(threadpool_timer_restart_with_NULL_timer_fails)
     ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_065: [ threadpool_timer_restart shall call timer_settime to change the delay and period. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_063: [ threadpool_timer_restart shall remove the timer from the timer wheel, increment the timer epoch number and store timer_period_ms while holding the timer lock. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_064: [ threadpool_timer_restart shall add the timer to the timer wheel to expire after start_delay_ms by calling threadpool_timer_wheel_add. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_07_067: [ threadpool_timer_restart shall succeed and return 0. ]*/
 TEST_FUNCTION(threadpool_timer_restart_succeeds)
 {
@@ -925,7 +1486,10 @@ TEST_FUNCTION(threadpool_timer_restart_succeeds)
     THANDLE(THREADPOOL) threadpool = NULL;
     THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
 
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // epoch_number
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_wheel_add_expectations(true);
 
     // act
     int result = threadpool_timer_restart(timer_instance, 43, 1000);
@@ -939,14 +1503,23 @@ TEST_FUNCTION(threadpool_timer_restart_succeeds)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_066: [ If timer_settime fails, threadpool_timer_restart shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(threadpool_timer_restart_fails_when_timer_set_time_fails)
+/* Tests_SRS_THREADPOOL_LINUX_12_058: [ If threadpool_timer_wheel_arm fails, threadpool_timer_wheel_add shall remove the timer from the timer wheel, fail and return a non-zero value. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_07_066: [ If threadpool_timer_wheel_add fails, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_restart_fails_when_timerfd_settime_fails)
 {
     // arrange
     THANDLE(THREADPOOL) threadpool = NULL;
     THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
 
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL)).SetReturn(-1);
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // epoch_number
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(mocked_timerfd_settime(TEST_TIMER_FD, 0, IGNORED_ARG, NULL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
 
     // act
     int result = threadpool_timer_restart(timer_instance, 43, 1000);
@@ -974,14 +1547,16 @@ TEST_FUNCTION(threadpool_timer_cancel_with_NULL_timer_fails)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_07_069: [ threadpool_timer_cancel shall call timer_settime with 0 for flags and NULL for old_value and {0} for new_value to cancel the ongoing timers. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_065: [ threadpool_timer_cancel shall remove the timer from the timer wheel and increment the timer epoch number while holding the timer lock, so that an already dispatched callback does not call work_function. ]*/
 TEST_FUNCTION(threadpool_timer_cancel_succeeds)
 {
     // arrange
     THANDLE(THREADPOOL) threadpool = NULL;
     THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
 
-    STRICT_EXPECTED_CALL(mocked_timer_settime(IGNORED_ARG, 0, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // epoch_number
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
 
     // act
     threadpool_timer_cancel(timer_instance);
@@ -996,19 +1571,17 @@ TEST_FUNCTION(threadpool_timer_cancel_succeeds)
 
 /* threadpool_timer_dispose */
 
-/* Tests_SRS_THREADPOOL_LINUX_07_071: [ threadpool_timer_dispose shall call timer_delete to destroy the ongoing timers. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_066: [ threadpool_timer_dispose shall remove the timer from the timer wheel while holding the timer lock. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_01_006: [ If the timer state is ARMED, threadpool_timer_dispose shall set the state of the timer to NOT_USED. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_067: [ threadpool_timer_dispose shall release its reference to the timer data, freeing the timer data if no callback is queued for it. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_068: [ threadpool_timer_dispose shall release its reference to the threadpool. ]*/
 TEST_FUNCTION(threadpool_timer_dispose_succeeds)
 {
     // arrange
     THANDLE(THREADPOOL) threadpool = NULL;
     THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
 
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_delete(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // state set to NOT_USED
-    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    threadpool_timer_dispose_expectations();
 
     // act
     THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
@@ -1028,24 +1601,28 @@ TEST_FUNCTION(threadpool_timer_dispose_waits_for_state_to_be_ARMED)
     int32_t armed_state_value;
     // create one timer and capture the ARMED state
     THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
+    THANDLE(THREADPOOL_TIMER) timer_instance_2 = test_start_timer(threadpool, 42, 2000, (void*)0x4243);
 
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_delete(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
         .CaptureReturn(&armed_state_value);  // state set to NOT_USED
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
     THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+    umock_c_reset_all_calls();
 
-    // now do it again so we can simulate that a different value is returned from the interlocked_compare_exchange
-    THANDLE(THREADPOOL_TIMER) timer_instance_2 = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
-
+    // now dispose the 2nd timer and simulate that a different value is returned from the interlocked_compare_exchange
     STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_timer_delete(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
         .SetReturn(armed_state_value + 1);
     STRICT_EXPECTED_CALL(InterlockedHL_WaitForNotValue(IGNORED_ARG, armed_state_value + 1, UINT32_MAX));
     STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // ref_count
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // reference to the threadpool
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
@@ -1058,196 +1635,476 @@ TEST_FUNCTION(threadpool_timer_dispose_waits_for_state_to_be_ARMED)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* on_timer_callback */
-
-/* Tests_SRS_THREADPOOL_LINUX_45_002: [ on_timer_callback shall extract from the lower 10 bits of timer_data.sival_ptr the information indicating which timer table entry is being triggered. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_012: [ on_timer_callback shall use the rest of the higher bits of timer_data.sival_ptr as timer epoch. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_008: [ If the timer is in the state ARMED: ]*/
-    /* Tests_SRS_THREADPOOL_LINUX_01_007: [ on_timer_callback shall transition it to CALLING_CALLBACK. ]*/
-    /* Tests_SRS_THREADPOOL_LINUX_45_004: [ If the timer epoch of the timer table entry is the same like the timer epoch in timer_data.sival_ptr, on_timer_callback shall call the timer's work_function with work_function_ctx. ]*/
-    /* Tests_SRS_THREADPOOL_LINUX_01_009: [ on_timer_callback shall transition it to ARMED. ]*/
-TEST_FUNCTION(on_timer_callback_calls_work_function)
+/* Tests_SRS_THREADPOOL_LINUX_12_081: [ If the timer thread was started, threadpool_dispose shall signal it to stop, expire the timer fd by calling timerfd_settime, join the timer thread, close the timer fd and deinitialize the timer lock. ]*/
+TEST_FUNCTION(threadpool_dispose_stops_the_timer_thread)
 {
     // arrange
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL) threadpool = NULL;
     THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // state set to CALLING_CALLBACK
-    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
-    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, IGNORED_ARG));  // state set to ARMED
-
-    sigval_t timer_data = {0};
-    timer_data.sival_ptr = g_sigevent.sigev_value.sival_ptr;
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    threadpool_stop_timer_thread_expectations();
+    threadpool_stop_threads_expectations();
+    for (size_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        if (i < MIN_THREAD_COUNT)
+        {
+            STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+        }
+    }
+    threadpool_release_queued_tasks_expectations(MAX_THREAD_COUNT);
+    threadpool_free_local_queues_expectations(MAX_THREAD_COUNT);
+    threadpool_free_lane_queues_expectations();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
-    g_sigevent.sigev_notify_function(timer_data);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    // cleanup
-    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
-    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_45_002: [ on_timer_callback shall extract from the lower 10 bits of timer_data.sival_ptr the information indicating which timer table entry is being triggered. ]*/
-TEST_FUNCTION(on_timer_callback_does_nothing_after_dispose)
+/* threadpool_timer_thread_func */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_069: [ threadpool_timer_thread_func shall wait for the timer fd to expire by calling read. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_071: [ If the timer thread was signalled to stop, threadpool_timer_thread_func shall return. ]*/
+TEST_FUNCTION(threadpool_timer_thread_func_returns_when_signalled_to_stop)
 {
     // arrange
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL) threadpool = NULL;
     THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
-    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // attempt to set state to CALLING_CALLBACK
 
-    sigval_t timer_data = {0};
-    timer_data.sival_ptr = g_sigevent.sigev_value.sival_ptr;
+    threadpool_timer_thread_stop_expectations();
 
     // act
-    g_sigevent.sigev_notify_function(timer_data);
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_45_004: [ If the timer epoch of the timer table entry is the same like the timer epoch in timer_data.sival_ptr, on_timer_callback shall call the timer's work_function with work_function_ctx. ]*/
-TEST_FUNCTION(on_timer_for_an_old_timer_does_not_call_the_timer_user_callback)
+/* Tests_SRS_THREADPOOL_LINUX_12_069: [ threadpool_timer_thread_func shall wait for the timer fd to expire by calling read. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_072: [ Otherwise threadpool_timer_thread_func shall perform the following steps while holding the timer lock, acquired by calling srw_lock_ll_acquire_exclusive and released by calling srw_lock_ll_release_exclusive. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_073: [ For each tick up to the current time obtained by calling timer_global_get_elapsed_ms at which a slot needs processing, threadpool_timer_thread_func shall move the timers of the higher level slots starting at that tick to the lower levels and dispatch the timers in the level 0 slot of that tick by calling threadpool_timer_dispatch. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_077: [ Otherwise threadpool_timer_dispatch shall record the epoch number of the timer, take a reference to the timer data and push a task with on_timer_callback as work function and the timer data as context by calling threadpool_push_task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_075: [ threadpool_timer_thread_func shall arm the timer fd for the next expiration by calling threadpool_timer_wheel_arm. ]*/
+TEST_FUNCTION(threadpool_timer_thread_func_dispatches_an_expired_timer)
 {
     // arrange
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
-    THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
-    sigval_t timer_data_1 = {0};
-    timer_data_1.sival_ptr = g_sigevent.sigev_value.sival_ptr;
-
-    // dispose of the first timer
-    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
-
-    THANDLE(THREADPOOL_TIMER) timer_instance_2 = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4244, &threadpool);
-    umock_c_reset_all_calls();
+    THANDLE(THREADPOOL) threadpool = NULL;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 0, (void*)0x4243, &threadpool);
 
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // set state to CALLING_CALLBACK
-    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, IGNORED_ARG));  // state set to ARMED
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(42);
+    threadpool_timer_dispatch_expectations();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG)); // the timer wheel is empty, the timer fd is not armed again
+    threadpool_timer_thread_stop_expectations();
 
     // act
-    g_sigevent.sigev_notify_function(timer_data_1);
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance_2, NULL);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_45_004: [ If the timer epoch of the timer table entry is the same like the timer epoch in timer_data.sival_ptr, on_timer_callback shall call the timer's work_function with work_function_ctx. ]*/
-TEST_FUNCTION(on_timer_for_timer_with_correct_epoch_for_2nd_timer_succeeds)
+/* Tests_SRS_THREADPOOL_LINUX_12_073: [ For each tick up to the current time obtained by calling timer_global_get_elapsed_ms at which a slot needs processing, threadpool_timer_thread_func shall move the timers of the higher level slots starting at that tick to the lower levels and dispatch the timers in the level 0 slot of that tick by calling threadpool_timer_dispatch. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_075: [ threadpool_timer_thread_func shall arm the timer fd for the next expiration by calling threadpool_timer_wheel_arm. ]*/
+TEST_FUNCTION(threadpool_timer_thread_func_does_not_dispatch_a_timer_that_did_not_expire)
 {
     // arrange
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
-    THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool);
-    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
-    THANDLE(THREADPOOL_TIMER) timer_instance_2 = test_create_threadpool_and_start_timer(42, 2000, (void*)0x4244, &threadpool);
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // state set to CALLING_CALLBACK
-    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
-    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, IGNORED_ARG));  // state set to ARMED
+    THANDLE(THREADPOOL) threadpool = NULL;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 0, (void*)0x4243, &threadpool);
 
-    sigval_t timer_data = {0};
-    timer_data.sival_ptr = g_sigevent.sigev_value.sival_ptr;
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(41);
+    threadpool_timer_wheel_arm_expectations();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_thread_stop_expectations();
 
     // act
-    g_sigevent.sigev_notify_function(timer_data);
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance_2, NULL);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* threadpool_create_work_item */
-
-/* Tests_SRS_THREADPOOL_LINUX_05_001: [ If threadpool is NULL, threadpool_create_work_item shall fail and return a NULL value. ]*/
-TEST_FUNCTION(threadpool_create_work_item_with_NULL_threadpool_fails)
+/* Tests_SRS_THREADPOOL_LINUX_12_073: [ For each tick up to the current time obtained by calling timer_global_get_elapsed_ms at which a slot needs processing, threadpool_timer_thread_func shall move the timers of the higher level slots starting at that tick to the lower levels and dispatch the timers in the level 0 slot of that tick by calling threadpool_timer_dispatch. ]*/
+TEST_FUNCTION(threadpool_timer_thread_func_dispatches_a_timer_moved_from_a_higher_level_of_the_timer_wheel)
 {
-    //arrange
+    // arrange
+    THANDLE(THREADPOOL) threadpool = NULL;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(100000, 0, (void*)0x4243, &threadpool);
+
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(100000);
+    threadpool_timer_dispatch_expectations();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_thread_stop_expectations();
 
     // act
-    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_create_work_item(NULL, test_work_function, (void*)0x4243);
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NULL(threadpool_work_item);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_05_002: [ If work_function is NULL, threadpool_create_work_item shall fail and return a NULL value. ] */
-TEST_FUNCTION(threadpool_create_work_item_with_NULL_work_function_fails)
+/* Tests_SRS_THREADPOOL_LINUX_12_074: [ threadpool_timer_thread_func shall insert periodic timers back in the timer wheel one period after their expiration, or one period after the current time if that is already in the past. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_076: [ If the callback of the timer is still queued or executing, threadpool_timer_dispatch shall skip this expiration. ]*/
+TEST_FUNCTION(threadpool_timer_thread_func_skips_the_expiration_of_a_periodic_timer_whose_callback_is_still_queued)
 {
     // arrange
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL) threadpool = NULL;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 10, (void*)0x4243, &threadpool);
+
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(42);
+    threadpool_timer_dispatch_expectations();
+    threadpool_timer_wheel_arm_expectations(); // next expiration at 52
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(52);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0)); // dispatch_pending is still set
+    threadpool_timer_wheel_arm_expectations(); // next expiration at 62
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+
+    threadpool_timer_thread_stop_expectations();
 
     // act
-    THANDLE(THREADPOOL_WORK_ITEM)  threadpool_work_item = threadpool_create_work_item(threadpool, NULL, (void*)0x4243);
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NULL(threadpool_work_item);
 
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_05_005: [ threadpool_create_work_item shall allocate memory for threadpool_work_item of type THANDLE(THREADPOOL_WORK_ITEM). ]*/
-/* Tests_SRS_THREADPOOL_LINUX_05_007: [ threadpool_create_work_item shall copy the work_function and work_function_context into the threadpool work item. ]*/
-TEST_FUNCTION(threadpool_create_work_item_succeeds)
+/* Tests_SRS_THREADPOOL_LINUX_12_070: [ If read fails, threadpool_timer_thread_func shall log the error and continue. ]*/
+TEST_FUNCTION(threadpool_timer_thread_func_continues_when_read_fails)
 {
     // arrange
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
-    threadpool_create_work_item_success_expectations();
+    THANDLE(THREADPOOL) threadpool = NULL;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 0, (void*)0x4243, &threadpool);
+
+    STRICT_EXPECTED_CALL(mocked_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // timer_thread_stop
+    threadpool_timer_wheel_expire_begin_expectations(0);
+    threadpool_timer_wheel_arm_expectations();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_thread_stop_expectations();
 
     // act
-    THANDLE(THREADPOOL_WORK_ITEM)  threadpool_work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4243);
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(threadpool_work_item);
 
     // cleanup
-    THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_05_005: [ threadpool_create_work_item shall allocate memory for threadpool_work_item of type THANDLE(THREADPOOL_WORK_ITEM). ] */
-/* Tests_SRS_THREADPOOL_LINUX_05_007: [ threadpool_create_work_item shall copy the work_function and work_function_context into the threadpool work item. ]*/
-TEST_FUNCTION(threadpool_create_work_item_succeeds_with_NULL_work_function_context)
+/* Tests_SRS_THREADPOOL_LINUX_12_078: [ If threadpool_push_task fails, threadpool_timer_dispatch shall clear the dispatch pending flag and release the reference to the timer data. ]*/
+TEST_FUNCTION(threadpool_timer_thread_func_releases_the_timer_when_pushing_its_work_item_fails)
 {
     // arrange
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
-    threadpool_create_work_item_success_expectations();
+    THANDLE(THREADPOOL) threadpool = NULL;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_create_threadpool_and_start_timer(42, 0, (void*)0x4243, &threadpool);
+
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(42);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0)); // dispatch_pending
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // epoch_number
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // ref_count
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL))
+        .SetReturn(TQUEUE_PUSH_ERROR);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // dispatch_pending
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // ref_count
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_thread_stop_expectations();
 
     // act
-    THANDLE(THREADPOOL_WORK_ITEM)  threadpool_work_item = threadpool_create_work_item(threadpool, test_work_function, NULL);
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(threadpool_work_item);
 
     // cleanup
-    THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
+/* on_timer_callback */
 
-/* Tests_SRS_THREADPOOL_LINUX_05_006: [ If during the initialization of threadpool_work_item, malloc fails then threadpool_create_work_item shall fail and return a NULL value. ]*/
-TEST_FUNCTION(when_underlying_calls_fail_threadpool_create_work_item_fails)
-{
-    // arrange
-    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+/* Tests_SRS_THREADPOOL_LINUX_01_008: [ If the timer is in the state ARMED: ]*/
+    /* Tests_SRS_THREADPOOL_LINUX_01_007: [ on_timer_callback shall transition it to CALLING_CALLBACK. ]*/
+    /* Tests_SRS_THREADPOOL_LINUX_12_079: [ If the timer epoch number is the same as the epoch number recorded when the callback was dispatched, on_timer_callback shall call the timer's work_function with work_function_ctx. ]*/
+    /* Tests_SRS_THREADPOOL_LINUX_01_009: [ on_timer_callback shall transition it to ARMED. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_080: [ on_timer_callback shall clear the dispatch pending flag of the timer and release its reference to the timer data. ]*/
+TEST_FUNCTION(on_timer_callback_calls_work_function)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREAD_START_FUNC worker_thread_func = g_saved_worker_thread_func;
+    void* worker_thread_func_context = g_saved_worker_thread_func_context;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_start_timer(threadpool, 42, 0, (void*)0x4243);
+
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(42);
+    threadpool_timer_dispatch_expectations();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_thread_stop_expectations();
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    umock_c_reset_all_calls();
+
+    threadpool_work_func_pop_timer_task_expectations();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // state set to CALLING_CALLBACK
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // epoch_number
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, IGNORED_ARG));  // state set to ARMED
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // dispatch_pending
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // ref_count
+    threadpool_task_executed_expectations();
+    threadpool_work_func_no_more_work_expectations();
+
+    // act
+    worker_thread_func(worker_thread_func_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_065: [ threadpool_timer_cancel shall remove the timer from the timer wheel and increment the timer epoch number while holding the timer lock, so that an already dispatched callback does not call work_function. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_079: [ If the timer epoch number is the same as the epoch number recorded when the callback was dispatched, on_timer_callback shall call the timer's work_function with work_function_ctx. ]*/
+TEST_FUNCTION(on_timer_callback_for_a_cancelled_timer_does_not_call_work_function)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREAD_START_FUNC worker_thread_func = g_saved_worker_thread_func;
+    void* worker_thread_func_context = g_saved_worker_thread_func_context;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_start_timer(threadpool, 42, 0, (void*)0x4243);
+
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(42);
+    threadpool_timer_dispatch_expectations();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_thread_stop_expectations();
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    threadpool_timer_cancel(timer_instance);
+    umock_c_reset_all_calls();
+
+    threadpool_work_func_pop_timer_task_expectations();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // state set to CALLING_CALLBACK
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // epoch_number changed
+    STRICT_EXPECTED_CALL(InterlockedHL_SetAndWake(IGNORED_ARG, IGNORED_ARG));  // state set to ARMED
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // dispatch_pending
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // ref_count
+    threadpool_task_executed_expectations();
+    threadpool_work_func_no_more_work_expectations();
+
+    // act
+    worker_thread_func(worker_thread_func_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_008: [ If the timer is in the state ARMED: ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_080: [ on_timer_callback shall clear the dispatch pending flag of the timer and release its reference to the timer data. ]*/
+TEST_FUNCTION(on_timer_callback_after_dispose_frees_the_timer_data)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREAD_START_FUNC worker_thread_func = g_saved_worker_thread_func;
+    void* worker_thread_func_context = g_saved_worker_thread_func_context;
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_start_timer(threadpool, 42, 0, (void*)0x4243);
+
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(42);
+    threadpool_timer_dispatch_expectations();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_thread_stop_expectations();
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+    umock_c_reset_all_calls();
+
+    threadpool_work_func_pop_timer_task_expectations();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));  // attempt to set state to CALLING_CALLBACK
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // dispatch_pending
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // ref_count
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // timer data
+    threadpool_task_executed_expectations();
+    threadpool_work_func_no_more_work_expectations();
+
+    // act
+    worker_thread_func(worker_thread_func_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_150: [ threadpool_dispose shall pop the tasks left in the local queues of all the thread slots by calling threadpool_task_deque_pop and in the global task queues of all the lanes by calling TQUEUE_POP(THREADPOOL_TASK), and for each timer task (whose work function is on_timer_callback) it shall clear the dispatch pending flag of the timer and release the reference of the task to the timer data. ]*/
+TEST_FUNCTION(threadpool_dispose_releases_the_timer_data_of_a_queued_timer_task)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_TIMER) timer_instance = test_start_timer(threadpool, 42, 0, (void*)0x4243);
+
+    threadpool_timer_thread_read_expectations();
+    threadpool_timer_wheel_expire_begin_expectations(42);
+    threadpool_timer_dispatch_expectations();
+    STRICT_EXPECTED_CALL(srw_lock_ll_release_exclusive(IGNORED_ARG));
+    threadpool_timer_thread_stop_expectations();
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&timer_instance, NULL);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    threadpool_stop_timer_thread_expectations();
+    threadpool_stop_threads_expectations();
+    for (size_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        if (i < MIN_THREAD_COUNT)
+        {
+            STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_ARG, IGNORED_ARG));
+        }
+    }
+    for (uint32_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    }
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // timer task
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0)); // dispatch_pending
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // ref_count
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); // timer data
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // normal priority lane is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane is empty
+    threadpool_free_local_queues_expectations(MAX_THREAD_COUNT);
+    threadpool_free_lane_queues_expectations();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* threadpool_create_work_item */
+
+/* Tests_SRS_THREADPOOL_LINUX_05_001: [ If threadpool is NULL, threadpool_create_work_item shall fail and return a NULL value. ]*/
+TEST_FUNCTION(threadpool_create_work_item_with_NULL_threadpool_fails)
+{
+    //arrange
+
+    // act
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_create_work_item(NULL, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(threadpool_work_item);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_05_002: [ If work_function is NULL, threadpool_create_work_item shall fail and return a NULL value. ] */
+TEST_FUNCTION(threadpool_create_work_item_with_NULL_work_function_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    THANDLE(THREADPOOL_WORK_ITEM)  threadpool_work_item = threadpool_create_work_item(threadpool, NULL, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(threadpool_work_item);
+
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_05_005: [ threadpool_create_work_item shall allocate memory for threadpool_work_item of type THANDLE(THREADPOOL_WORK_ITEM). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_05_007: [ threadpool_create_work_item shall copy the work_function and work_function_context into the threadpool work item. ]*/
+TEST_FUNCTION(threadpool_create_work_item_succeeds)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    threadpool_create_work_item_success_expectations();
+
+    // act
+    THANDLE(THREADPOOL_WORK_ITEM)  threadpool_work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(threadpool_work_item);
+
+    // cleanup
+    THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_05_005: [ threadpool_create_work_item shall allocate memory for threadpool_work_item of type THANDLE(THREADPOOL_WORK_ITEM). ] */
+/* Tests_SRS_THREADPOOL_LINUX_05_007: [ threadpool_create_work_item shall copy the work_function and work_function_context into the threadpool work item. ]*/
+TEST_FUNCTION(threadpool_create_work_item_succeeds_with_NULL_work_function_context)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    threadpool_create_work_item_success_expectations();
+
+    // act
+    THANDLE(THREADPOOL_WORK_ITEM)  threadpool_work_item = threadpool_create_work_item(threadpool, test_work_function, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(threadpool_work_item);
+
+    // cleanup
+    THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+
+/* Tests_SRS_THREADPOOL_LINUX_05_006: [ If during the initialization of threadpool_work_item, malloc fails then threadpool_create_work_item shall fail and return a NULL value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_create_work_item_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
 
     umock_c_negative_tests_snapshot();
     for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
@@ -1303,8 +2160,8 @@ TEST_FUNCTION(threadpool_schedule_work_item_with_NULL_work_function_fails)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_05_025: [ threadpool_schedule_work_item shall unblock the threadpool semaphore by calling sem_post. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall TQUEUE_PUSH the threadpool_work_item into the task queue. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_035: [ threadpool_schedule_work_item shall signal that work is available by calling threadpool_signal_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall push a task with the work_function and work_function_context of threadpool_work_item in a task queue of the priority lane of threadpool_work_item by calling threadpool_push_task. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_05_026: [ threadpool_schedule_work_item shall succeed and return 0. ]*/
 TEST_FUNCTION(threadpool_schedule_work_item_succeeds)
 {
@@ -1318,9 +2175,10 @@ TEST_FUNCTION(threadpool_schedule_work_item_succeeds)
 
     int result;
 
-    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_post(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
 
     // act
     result = threadpool_schedule_work_item(threadpool, threadpool_work_item);
@@ -1334,8 +2192,8 @@ TEST_FUNCTION(threadpool_schedule_work_item_succeeds)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_05_025: [ threadpool_schedule_work_item shall unblock the threadpool semaphore by calling sem_post. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall TQUEUE_PUSH the threadpool_work_item into the task queue. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_035: [ threadpool_schedule_work_item shall signal that work is available by calling threadpool_signal_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall push a task with the work_function and work_function_context of threadpool_work_item in a task queue of the priority lane of threadpool_work_item by calling threadpool_push_task. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_05_026: [ threadpool_schedule_work_item shall succeed and return 0. ]*/
 TEST_FUNCTION(threadpool_schedule_work_item_twice_same_item_succeeds)
 {
@@ -1350,13 +2208,15 @@ TEST_FUNCTION(threadpool_schedule_work_item_twice_same_item_succeeds)
     int result_1;
     int result_2;
 
-    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_post(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
 
-    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_post(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
 
     // act
     result_1 = threadpool_schedule_work_item(threadpool, threadpool_work_item);
@@ -1372,8 +2232,8 @@ TEST_FUNCTION(threadpool_schedule_work_item_twice_same_item_succeeds)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
-/* Tests_SRS_THREADPOOL_LINUX_05_025: [ threadpool_schedule_work_item shall unblock the threadpool semaphore by calling sem_post. ]*/
-/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall TQUEUE_PUSH the threadpool_work_item into the task queue. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_035: [ threadpool_schedule_work_item shall signal that work is available by calling threadpool_signal_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall push a task with the work_function and work_function_context of threadpool_work_item in a task queue of the priority lane of threadpool_work_item by calling threadpool_push_task. ]*/
 /* Tests_SRS_THREADPOOL_LINUX_05_026: [ threadpool_schedule_work_item shall succeed and return 0. ]*/
 TEST_FUNCTION(threadpool_schedule_work_2_items_succeeds)
 {
@@ -1392,13 +2252,15 @@ TEST_FUNCTION(threadpool_schedule_work_2_items_succeeds)
     int result_1;
     int result_2;
 
-    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_post(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
 
-    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL));
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mocked_sem_post(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
 
     // act
     result_1 = threadpool_schedule_work_item(threadpool, threadpool_work_item_1);
@@ -1426,10 +2288,12 @@ TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_item_fails)
     ASSERT_IS_NOT_NULL(threadpool_work_item);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THANDLE(THREADPOOL_WORK_ITEM))(IGNORED_ARG, IGNORED_ARG, NULL))
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL))
         .SetFailReturn(TQUEUE_PUSH_ERROR);
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)).CallCannotFail();
-    STRICT_EXPECTED_CALL(mocked_sem_post(IGNORED_ARG)).CallCannotFail();
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
 
     umock_c_negative_tests_snapshot();
     for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
@@ -1452,4 +2316,1884 @@ TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_item_fails)
     THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
 }
 
+/* threadpool_create with max_thread_count 0 */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_001: [ If max_thread_count is 0, the threadpool shall not grow beyond min_thread_count threads. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_002: [ threadpool_create shall allocate memory for an array of thread slots of size max_thread_count (or min_thread_count if max_thread_count is 0). ]*/
+TEST_FUNCTION(threadpool_create_with_max_thread_count_0_allocates_min_thread_count_slots)
+{
+    // arrange
+    execution_engine.max_thread_count = 0;
+    threadpool_create_with_thread_array_size_succeed_expectations(MIN_THREAD_COUNT);
+
+    // act
+    THANDLE(THREADPOOL) threadpool = threadpool_create(test_execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+    execution_engine.max_thread_count = MAX_THREAD_COUNT;
+}
+
+/* threadpool_add_thread_if_needed */
+
+// the slots [0, running_thread_count) are RUNNING, the local queue of the last one (the worker under test) holds local_queue_depth tasks
+static void threadpool_add_thread_with_local_queue_depth_expectations(int64_t queue_depth, uint32_t running_thread_count, int64_t local_queue_depth)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // active_thread_count
+        .SetReturn(MIN_THREAD_COUNT);
+    STRICT_EXPECTED_CALL(TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(IGNORED_ARG)); // high priority lane
+    STRICT_EXPECTED_CALL(TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(IGNORED_ARG)) // normal priority lane
+        .SetReturn(queue_depth);
+    STRICT_EXPECTED_CALL(TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(IGNORED_ARG)); // low priority lane
+    for (uint32_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state
+        if (i < running_thread_count)
+        {
+            STRICT_EXPECTED_CALL(threadpool_task_deque_get_volatile_count(IGNORED_ARG)) // local queue of a RUNNING slot
+                .SetReturn((i == running_thread_count - 1) ? local_queue_depth : 0);
+        }
+    }
+}
+
+static void threadpool_add_thread_expectations(int64_t queue_depth)
+{
+    threadpool_add_thread_with_local_queue_depth_expectations(queue_depth, MIN_THREAD_COUNT, 0);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_005: [ threadpool_schedule_work shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_017: [ If the number of tasks in the global task queues of all the lanes obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK) plus the number of tasks in the local queues of the thread slots in the RUNNING state obtained by calling threadpool_task_deque_get_volatile_count is greater than THREADPOOL_GROW_QUEUE_DEPTH_THRESHOLD or if the queues are not empty and no item was dequeued in the last THREADPOOL_GROW_DEQUEUE_STALL_MS milliseconds, a new thread shall be added: ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_018: [ The number of live threads shall be incremented. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_019: [ A thread slot in state NOT_USED or EXITED shall be found in the thread array and marked as STARTING. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_021: [ The new thread shall be started by calling ThreadAPI_CreateEx with the same options as the worker threads started by threadpool_create and the slot shall be marked as RUNNING. ]*/
+TEST_FUNCTION(threadpool_schedule_work_adds_a_thread_when_all_threads_are_busy_and_the_queue_depth_is_over_the_threshold)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_add_thread_expectations(65);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, MIN_THREAD_COUNT + 1, MIN_THREAD_COUNT));
+    for (uint32_t i = 0; i < MIN_THREAD_COUNT + 1; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // NOT_USED -> STARTING
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG)); // RUNNING
+
+    // act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT + 1, threadpool_linux_get_thread_count(threadpool));
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_017: [ If the number of tasks in the global task queues of all the lanes obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK) plus the number of tasks in the local queues of the thread slots in the RUNNING state obtained by calling threadpool_task_deque_get_volatile_count is greater than THREADPOOL_GROW_QUEUE_DEPTH_THRESHOLD or if the queues are not empty and no item was dequeued in the last THREADPOOL_GROW_DEQUEUE_STALL_MS milliseconds, a new thread shall be added: ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_037: [ If priority is THREADPOOL_PRIORITY_NORMAL and the current thread is a worker thread of threadpool, threadpool_push_task shall push the task at the bottom of the local queue of the thread by calling threadpool_task_deque_push. ]*/
+TEST_FUNCTION(threadpool_work_func_adds_a_thread_when_a_busy_worker_backs_up_its_local_queue)
+{
+    //arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_schedule_work_from_work_item, (void*)&threadpool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_dequeue_expectations();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(threadpool_task_deque_push(IGNORED_ARG, IGNORED_ARG)); // pushed in the local queue
+    threadpool_signal_work_expectations();
+    // all threads are busy, the global queues are empty and the local queue of the worker is backing up
+    threadpool_add_thread_with_local_queue_depth_expectations(0, MIN_THREAD_COUNT, 65);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, MIN_THREAD_COUNT + 1, MIN_THREAD_COUNT));
+    for (uint32_t i = 0; i < MIN_THREAD_COUNT + 1; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // NOT_USED -> STARTING
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG)); // RUNNING
+    threadpool_task_executed_expectations();
+
+    // the item scheduled from the work item is in the local queue
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue
+    threadpool_next_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    threadpool_task_executed_expectations();
+
+    // the new thread is RUNNING in slot MIN_THREAD_COUNT, so it is a steal victim too
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // global queue
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state is RUNNING
+    STRICT_EXPECTED_CALL(threadpool_task_deque_steal(IGNORED_ARG, IGNORED_ARG));
+    for (uint32_t i = MIN_THREAD_COUNT + 1; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state is NOT_USED
+    }
+    for (uint32_t i = 0; i < MIN_THREAD_COUNT - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state is RUNNING
+        STRICT_EXPECTED_CALL(threadpool_task_deque_steal(IGNORED_ARG, IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT + 1, threadpool_linux_get_thread_count(threadpool));
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_006: [ threadpool_schedule_work_item shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_017: [ If the number of tasks in the global task queues of all the lanes obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK) plus the number of tasks in the local queues of the thread slots in the RUNNING state obtained by calling threadpool_task_deque_get_volatile_count is greater than THREADPOOL_GROW_QUEUE_DEPTH_THRESHOLD or if the queues are not empty and no item was dequeued in the last THREADPOOL_GROW_DEQUEUE_STALL_MS milliseconds, a new thread shall be added: ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_adds_a_thread_when_all_threads_are_busy_and_no_item_was_dequeued_recently)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4243);
+    ASSERT_IS_NOT_NULL(threadpool_work_item);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_add_thread_expectations(1);
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // last_dequeue_time_ms is 0
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, MIN_THREAD_COUNT + 1, MIN_THREAD_COUNT));
+    for (uint32_t i = 0; i < MIN_THREAD_COUNT + 1; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // NOT_USED -> STARTING
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG)); // RUNNING
+
+    // act
+    int result = threadpool_schedule_work_item(threadpool, threadpool_work_item);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT + 1, threadpool_linux_get_thread_count(threadpool));
+
+    // cleanup
+    THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_017: [ If the number of tasks in the global task queues of all the lanes obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK) plus the number of tasks in the local queues of the thread slots in the RUNNING state obtained by calling threadpool_task_deque_get_volatile_count is greater than THREADPOOL_GROW_QUEUE_DEPTH_THRESHOLD or if the queues are not empty and no item was dequeued in the last THREADPOOL_GROW_DEQUEUE_STALL_MS milliseconds, a new thread shall be added: ]*/
+TEST_FUNCTION(threadpool_schedule_work_does_not_add_a_thread_when_items_are_dequeued_and_the_queue_depth_is_under_the_threshold)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_add_thread_expectations(2);
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms())
+        .SetReturn(50.0);
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    // act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT, threadpool_linux_get_thread_count(threadpool));
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_015: [ If the number of live threads is already equal to the size of the thread array, no thread shall be added. ]*/
+TEST_FUNCTION(threadpool_schedule_work_does_not_add_a_thread_when_max_thread_count_is_reached)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(MAX_THREAD_COUNT);
+
+    // act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_022: [ If no thread slot is available or starting the thread fails, the number of live threads shall be decremented. ]*/
+TEST_FUNCTION(threadpool_schedule_work_does_not_grow_when_ThreadAPI_CreateEx_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_add_thread_expectations(65);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, MIN_THREAD_COUNT + 1, MIN_THREAD_COUNT));
+    for (uint32_t i = 0; i < MIN_THREAD_COUNT + 1; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // NOT_USED -> STARTING
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(THREADAPI_ERROR);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG)); // NOT_USED
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // thread_count
+
+    // act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT, threadpool_linux_get_thread_count(threadpool));
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_work_func idle threads */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_027: [ If the number of live threads is greater than min_thread_count, threadpool_work_func shall use THREADPOOL_IDLE_THREAD_TIMEOUT_MS as wait timeout, otherwise it shall wait without a timeout (UINT32_MAX). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_011: [ If wait_on_address returns WAIT_ON_ADDRESS_TIMEOUT: ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_013: [ Otherwise threadpool_work_func shall decrement the number of live threads. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_014: [ threadpool_work_func shall set the state of its thread slot to EXITED and return. ]*/
+TEST_FUNCTION(threadpool_work_func_exits_when_idle_and_above_min_thread_count)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // stop_thread
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(MIN_THREAD_COUNT + 1);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // waiting_thread_count
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 10000))
+        .SetReturn(WAIT_ON_ADDRESS_TIMEOUT);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // waiting_thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(MIN_THREAD_COUNT + 1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, MIN_THREAD_COUNT, MIN_THREAD_COUNT + 1))
+        .SetReturn(MIN_THREAD_COUNT + 1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // RUNNING -> EXITED
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_012: [ If the number of live threads is not greater than min_thread_count, the thread shall keep waiting for work. ]*/
+TEST_FUNCTION(threadpool_work_func_keeps_waiting_when_idle_and_at_min_thread_count)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // stop_thread
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // thread_count is MIN_THREAD_COUNT
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // waiting_thread_count
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, UINT32_MAX))
+        .SetReturn(WAIT_ON_ADDRESS_TIMEOUT);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // waiting_thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // thread_count is MIN_THREAD_COUNT
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT, threadpool_linux_get_thread_count(threadpool));
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_019: [ A thread slot in state NOT_USED or EXITED shall be found in the thread array and marked as STARTING. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_020: [ If the slot was in state EXITED, the handle of the thread that previously used it shall be kept in the slot so that the new thread joins it. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_147: [ If the thread slot holds the handle of the thread that previously used the slot, threadpool_work_func shall join it by calling ThreadAPI_Join and clear it from the slot. ]*/
+TEST_FUNCTION(threadpool_schedule_work_reuses_an_exited_slot_without_joining_and_the_new_thread_joins_the_exited_thread)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // retire the thread of the last slot
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // stop_thread
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(MIN_THREAD_COUNT + 1);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // waiting_thread_count
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 10000))
+        .SetReturn(WAIT_ON_ADDRESS_TIMEOUT);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // waiting_thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(MIN_THREAD_COUNT + 1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, MIN_THREAD_COUNT, MIN_THREAD_COUNT + 1))
+        .SetReturn(MIN_THREAD_COUNT + 1);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // RUNNING -> EXITED
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL));
+    threadpool_signal_work_expectations();
+    threadpool_add_thread_with_local_queue_depth_expectations(65, MIN_THREAD_COUNT - 1, 0); // the last slot is EXITED
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, MIN_THREAD_COUNT + 1, MIN_THREAD_COUNT));
+    for (uint32_t i = 0; i < MIN_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // slot state
+    }
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); // EXITED -> STARTING
+    STRICT_EXPECTED_CALL(ThreadAPI_CreateEx(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG)); // RUNNING
+
+    // act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(test_thread_handle, IGNORED_ARG));
+    threadpool_work_func_empty_queue_expectations();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    // act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_linux_get_thread_count */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_024: [ If threadpool is NULL, threadpool_linux_get_thread_count shall fail and return 0. ]*/
+TEST_FUNCTION(threadpool_linux_get_thread_count_with_NULL_threadpool_returns_0)
+{
+    // arrange
+
+    // act
+    uint32_t result = threadpool_linux_get_thread_count(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_025: [ Otherwise threadpool_linux_get_thread_count shall return the number of live threads in the threadpool. ]*/
+TEST_FUNCTION(threadpool_linux_get_thread_count_returns_min_thread_count_after_create)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    // act
+    uint32_t result = threadpool_linux_get_thread_count(threadpool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, MIN_THREAD_COUNT, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_linux_schedule_work_batch */
+
+#define TEST_WORK_BATCH_COUNT 3
+
+static const THREADPOOL_WORK_BATCH_ENTRY test_work_batch[TEST_WORK_BATCH_COUNT] =
+{
+    { test_work_function, (void*)0x4242 },
+    { test_work_function, (void*)0x4243 },
+    { test_work_function, NULL }
+};
+
+static void threadpool_push_task_batch_expectations(uint32_t task_count)
+{
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, task_count, NULL, IGNORED_ARG))
+        .SetFailReturn(TQUEUE_PUSH_ERROR);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_083: [ If threadpool is NULL, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_with_NULL_threadpool_fails)
+{
+    // arrange
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(NULL, test_work_batch, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_084: [ If work_batch is NULL, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_with_NULL_work_batch_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, NULL, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_085: [ If work_batch_count is 0, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_with_0_work_batch_count_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, test_work_batch, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_086: [ If the work_function of any of the entries in work_batch is NULL, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_with_a_NULL_work_function_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_WORK_BATCH_ENTRY work_batch[TEST_WORK_BATCH_COUNT] =
+    {
+        { test_work_function, (void*)0x4242 },
+        { NULL, (void*)0x4243 },
+        { test_work_function, (void*)0x4244 }
+    };
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, work_batch, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_087: [ threadpool_linux_schedule_work_batch shall push tasks with the work_function and work_function_context of the entries in work_batch in the global task queue of the normal priority lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the entries are pushed. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_089: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_090: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_092: [ threadpool_linux_schedule_work_batch shall succeed and return 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_114: [ threadpool_linux_schedule_work_batch shall obtain the enqueue time of the tasks by calling timer_global_get_elapsed_us once for the whole batch. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_succeeds)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_push_task_batch_expectations(TEST_WORK_BATCH_COUNT);
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, test_work_batch, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_089: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_082: [ If work_item_count is greater than 1 and not less than the number of waiting threads, threadpool_signal_work shall wake all the waiting threads by calling wake_by_address_all. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_wakes_all_waiting_threads_when_there_are_not_more_waiting_threads_than_work_items)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_push_task_batch_expectations(TEST_WORK_BATCH_COUNT);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // waiting_thread_count
+        .SetReturn(TEST_WORK_BATCH_COUNT - 1);
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, test_work_batch, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_089: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_031: [ Otherwise, if there are threads waiting for work, threadpool_signal_work shall wake one of them for each of the work_item_count work items by calling wake_by_address_single. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_wakes_one_waiting_thread_for_each_work_item)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_push_task_batch_expectations(TEST_WORK_BATCH_COUNT);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // waiting_thread_count
+        .SetReturn(TEST_WORK_BATCH_COUNT + 1);
+    for (uint32_t i = 0; i < TEST_WORK_BATCH_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    }
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, test_work_batch, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_087: [ threadpool_linux_schedule_work_batch shall push tasks with the work_function and work_function_context of the entries in work_batch in the global task queue of the normal priority lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the entries are pushed. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_pushes_the_tasks_left_when_not_all_tasks_were_pushed_at_once)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    uint32_t pushed_task_count = 1;
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT, NULL, IGNORED_ARG))
+        .CopyOutArgumentBuffer_pushed_item_count(&pushed_task_count, sizeof(pushed_task_count))
+        .SetReturn(TQUEUE_PUSH_OK);
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT - 1, NULL, IGNORED_ARG));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, test_work_batch, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_087: [ threadpool_linux_schedule_work_batch shall push tasks with the work_function and work_function_context of the entries in work_batch in the global task queue of the normal priority lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the entries are pushed. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_089: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_batch_with_65_entries_pushes_the_tasks_in_2_chunks)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_WORK_BATCH_ENTRY work_batch[65];
+    for (uint32_t i = 0; i < 65; i++)
+    {
+        work_batch[i].work_function = test_work_function;
+        work_batch[i].work_function_context = (void*)0x4242;
+    }
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 64, NULL, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 1, NULL, IGNORED_ARG));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, work_batch, 65);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_088: [ If pushing tasks fails, threadpool_linux_schedule_work_batch shall not push the remaining entries. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_089: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_090: [ If at least one task was pushed, threadpool_linux_schedule_work_batch shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_091: [ If any of the entries could not be pushed, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_pushing_a_task_fails_threadpool_linux_schedule_work_batch_signals_the_pushed_tasks_and_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    uint32_t pushed_task_count = 1;
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT, NULL, IGNORED_ARG))
+        .CopyOutArgumentBuffer_pushed_item_count(&pushed_task_count, sizeof(pushed_task_count))
+        .SetReturn(TQUEUE_PUSH_OK);
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT - 1, NULL, IGNORED_ARG))
+        .SetReturn(TQUEUE_PUSH_ERROR);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // waiting_thread_count
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_batch(threadpool, test_work_batch, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_088: [ If pushing tasks fails, threadpool_linux_schedule_work_batch shall not push the remaining entries. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_091: [ If any of the entries could not be pushed, threadpool_linux_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_linux_schedule_work_batch_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_push_task_batch_expectations(TEST_WORK_BATCH_COUNT);
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+
+    umock_c_negative_tests_snapshot();
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            int result = threadpool_linux_schedule_work_batch(threadpool, test_work_batch, TEST_WORK_BATCH_COUNT);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_linux_schedule_work_item_batch */
+
+static void test_create_work_items(THANDLE(THREADPOOL) threadpool, THANDLE(THREADPOOL_WORK_ITEM)* threadpool_work_items, uint32_t work_item_count)
+{
+    for (uint32_t i = 0; i < work_item_count; i++)
+    {
+        THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4243);
+        ASSERT_IS_NOT_NULL(threadpool_work_item);
+        THANDLE_INITIALIZE_MOVE(real_THREADPOOL_WORK_ITEM)(&threadpool_work_items[i], &threadpool_work_item);
+    }
+    umock_c_reset_all_calls();
+}
+
+static void test_create_work_items_with_priorities(THANDLE(THREADPOOL) threadpool, THANDLE(THREADPOOL_WORK_ITEM)* threadpool_work_items, const THREADPOOL_PRIORITY* priorities, uint32_t work_item_count)
+{
+    for (uint32_t i = 0; i < work_item_count; i++)
+    {
+        THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_linux_create_work_item_with_priority(threadpool, priorities[i], test_work_function, (void*)0x4243);
+        ASSERT_IS_NOT_NULL(threadpool_work_item);
+        THANDLE_INITIALIZE_MOVE(real_THREADPOOL_WORK_ITEM)(&threadpool_work_items[i], &threadpool_work_item);
+    }
+    umock_c_reset_all_calls();
+}
+
+static void test_destroy_work_items(THANDLE(THREADPOOL_WORK_ITEM)* threadpool_work_items, uint32_t work_item_count)
+{
+    for (uint32_t i = 0; i < work_item_count; i++)
+    {
+        THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_items[i], NULL);
+    }
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_093: [ If threadpool is NULL, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_item_batch_with_NULL_threadpool_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[TEST_WORK_BATCH_COUNT];
+    test_create_work_items(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(NULL, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, TEST_WORK_BATCH_COUNT);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_094: [ If threadpool_work_items is NULL, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_item_batch_with_NULL_threadpool_work_items_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, NULL, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_095: [ If work_item_count is 0, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_item_batch_with_0_work_item_count_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[TEST_WORK_BATCH_COUNT];
+    test_create_work_items(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, TEST_WORK_BATCH_COUNT);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_096: [ If any of the work items in threadpool_work_items is NULL, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_item_batch_with_a_NULL_work_item_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[TEST_WORK_BATCH_COUNT];
+    test_create_work_items(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT - 1);
+    THANDLE_INITIALIZE(real_THREADPOOL_WORK_ITEM)(&threadpool_work_items[TEST_WORK_BATCH_COUNT - 1], NULL);
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, TEST_WORK_BATCH_COUNT - 1);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_152: [ For each priority lane, threadpool_linux_schedule_work_item_batch shall push tasks with the work_function and work_function_context of the work items of that priority in the global task queue of the lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the work items of that priority are pushed. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_100: [ If at least one task was pushed, threadpool_linux_schedule_work_item_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_101: [ If at least one task was pushed, threadpool_linux_schedule_work_item_batch shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_099: [ threadpool_linux_schedule_work_item_batch shall succeed and return 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_115: [ threadpool_linux_schedule_work_item_batch shall obtain the enqueue time of the tasks by calling timer_global_get_elapsed_us once for the whole batch. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_item_batch_succeeds)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[TEST_WORK_BATCH_COUNT];
+    test_create_work_items(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    threadpool_push_task_batch_expectations(TEST_WORK_BATCH_COUNT);
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, TEST_WORK_BATCH_COUNT);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_152: [ For each priority lane, threadpool_linux_schedule_work_item_batch shall push tasks with the work_function and work_function_context of the work items of that priority in the global task queue of the lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the work items of that priority are pushed. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_100: [ If at least one task was pushed, threadpool_linux_schedule_work_item_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_item_batch_pushes_the_work_items_of_each_priority_with_one_batch_push_and_signals_once)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    static const THREADPOOL_PRIORITY priorities[] = { THREADPOOL_PRIORITY_LOW, THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL, THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_LOW, THREADPOOL_PRIORITY_HIGH };
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[MU_COUNT_ARRAY_ITEMS(priorities)];
+    test_create_work_items_with_priorities(threadpool, threadpool_work_items, priorities, MU_COUNT_ARRAY_ITEMS(priorities));
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 3, NULL, IGNORED_ARG)); // high priority lane
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 1, NULL, IGNORED_ARG)); // normal priority lane
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 2, NULL, IGNORED_ARG)); // low priority lane
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // waiting_thread_count
+        .SetReturn(MU_COUNT_ARRAY_ITEMS(priorities));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, MU_COUNT_ARRAY_ITEMS(priorities));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, MU_COUNT_ARRAY_ITEMS(priorities));
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_152: [ For each priority lane, threadpool_linux_schedule_work_item_batch shall push tasks with the work_function and work_function_context of the work items of that priority in the global task queue of the lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the work items of that priority are pushed. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_item_batch_pushes_the_tasks_left_when_not_all_tasks_were_pushed_at_once)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[TEST_WORK_BATCH_COUNT];
+    test_create_work_items(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    uint32_t pushed_task_count = 1;
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT, NULL, IGNORED_ARG))
+        .CopyOutArgumentBuffer_pushed_item_count(&pushed_task_count, sizeof(pushed_task_count))
+        .SetReturn(TQUEUE_PUSH_OK);
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT - 1, NULL, IGNORED_ARG));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, TEST_WORK_BATCH_COUNT);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_152: [ For each priority lane, threadpool_linux_schedule_work_item_batch shall push tasks with the work_function and work_function_context of the work items of that priority in the global task queue of the lane by calling TQUEUE_PUSH_BATCH(THREADPOOL_TASK) with at most 64 tasks at a time, until all the work items of that priority are pushed. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_item_batch_with_65_work_items_pushes_the_tasks_in_2_chunks)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[65];
+    test_create_work_items(threadpool, threadpool_work_items, 65);
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 64, NULL, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 1, NULL, IGNORED_ARG));
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, 65);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, 65);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_098: [ If pushing a task fails, threadpool_linux_schedule_work_item_batch shall not push the remaining work items. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_100: [ If at least one task was pushed, threadpool_linux_schedule_work_item_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_102: [ If any of the work items could not be pushed, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_pushing_the_tasks_of_a_lane_fails_threadpool_linux_schedule_work_item_batch_does_not_push_the_next_lanes_and_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    static const THREADPOOL_PRIORITY priorities[] = { THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL, THREADPOOL_PRIORITY_LOW };
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[MU_COUNT_ARRAY_ITEMS(priorities)];
+    test_create_work_items_with_priorities(threadpool, threadpool_work_items, priorities, MU_COUNT_ARRAY_ITEMS(priorities));
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 1, NULL, IGNORED_ARG)); // high priority lane
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, 1, NULL, IGNORED_ARG)) // normal priority lane
+        .SetReturn(TQUEUE_PUSH_ERROR);
+    threadpool_signal_work_expectations();
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, MU_COUNT_ARRAY_ITEMS(priorities));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, MU_COUNT_ARRAY_ITEMS(priorities));
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_098: [ If pushing a task fails, threadpool_linux_schedule_work_item_batch shall not push the remaining work items. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_100: [ If at least one task was pushed, threadpool_linux_schedule_work_item_batch shall call threadpool_signal_work once with the number of pushed tasks. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_101: [ If at least one task was pushed, threadpool_linux_schedule_work_item_batch shall add a new thread if all live threads are busy and the task queue is backing up. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_102: [ If any of the work items could not be pushed, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_pushing_a_task_fails_threadpool_linux_schedule_work_item_batch_signals_the_pushed_tasks_and_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[TEST_WORK_BATCH_COUNT];
+    test_create_work_items(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    uint32_t pushed_task_count = 1;
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT, NULL, IGNORED_ARG))
+        .CopyOutArgumentBuffer_pushed_item_count(&pushed_task_count, sizeof(pushed_task_count))
+        .SetReturn(TQUEUE_PUSH_OK);
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT - 1, NULL, IGNORED_ARG))
+        .SetReturn(TQUEUE_PUSH_ERROR);
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // waiting_thread_count
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    threadpool_no_thread_added_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, TEST_WORK_BATCH_COUNT);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_098: [ If pushing a task fails, threadpool_linux_schedule_work_item_batch shall not push the remaining work items. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_102: [ If any of the work items could not be pushed, threadpool_linux_schedule_work_item_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_pushing_the_first_task_fails_threadpool_linux_schedule_work_item_batch_fails_without_signalling)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_items[TEST_WORK_BATCH_COUNT];
+    test_create_work_items(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH_BATCH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, TEST_WORK_BATCH_COUNT, NULL, IGNORED_ARG))
+        .SetReturn(TQUEUE_PUSH_ERROR);
+
+    // act
+    int result = threadpool_linux_schedule_work_item_batch(threadpool, threadpool_work_items, TEST_WORK_BATCH_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    test_destroy_work_items(threadpool_work_items, TEST_WORK_BATCH_COUNT);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_linux_create_work_item_with_priority */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_116: [ If threadpool is NULL, threadpool_linux_create_work_item_with_priority shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_linux_create_work_item_with_priority_with_NULL_threadpool_fails)
+{
+    // arrange
+
+    // act
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_linux_create_work_item_with_priority(NULL, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(threadpool_work_item);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_117: [ If priority is not a valid THREADPOOL_PRIORITY value, threadpool_linux_create_work_item_with_priority shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_linux_create_work_item_with_priority_with_invalid_priority_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_linux_create_work_item_with_priority(threadpool, (THREADPOOL_PRIORITY)THREADPOOL_PRIORITY_COUNT, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(threadpool_work_item);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_118: [ If work_function is NULL, threadpool_linux_create_work_item_with_priority shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_linux_create_work_item_with_priority_with_NULL_work_function_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_linux_create_work_item_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, NULL, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(threadpool_work_item);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_119: [ threadpool_linux_create_work_item_with_priority shall allocate memory for a work item of type THANDLE(THREADPOOL_WORK_ITEM). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_121: [ threadpool_linux_create_work_item_with_priority shall copy the work_function, work_function_context and priority into the work item and return it. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_schedule_work_item shall push a task with the work_function and work_function_context of threadpool_work_item in a task queue of the priority lane of threadpool_work_item by calling threadpool_push_task. ]*/
+TEST_FUNCTION(threadpool_linux_create_work_item_with_priority_succeeds_and_the_work_item_is_scheduled_in_its_lane)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    threadpool_create_work_item_success_expectations();
+
+    // act
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_linux_create_work_item_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(threadpool_work_item);
+
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, threadpool_work_item));
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_LOW, &lane_statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, lane_statistics.queue_depth);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_NORMAL, &lane_statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, lane_statistics.queue_depth);
+
+    // cleanup
+    THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_120: [ If allocating the memory fails, threadpool_linux_create_work_item_with_priority shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_linux_create_work_item_with_priority_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    threadpool_create_work_item_success_expectations();
+
+    umock_c_negative_tests_snapshot();
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_linux_create_work_item_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243);
+
+            // assert
+            ASSERT_IS_NULL(threadpool_work_item, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_113: [ threadpool_create_work_item shall set the priority of the threadpool work item to THREADPOOL_PRIORITY_NORMAL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_creates_a_normal_priority_work_item)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THANDLE(THREADPOOL_WORK_ITEM) threadpool_work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4243);
+    ASSERT_IS_NOT_NULL(threadpool_work_item);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = threadpool_schedule_work_item(threadpool, threadpool_work_item);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_NORMAL, &lane_statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, lane_statistics.queue_depth);
+
+    // cleanup
+    THANDLE_ASSIGN(real_THREADPOOL_WORK_ITEM)(&threadpool_work_item, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_linux_schedule_work_with_priority */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_122: [ If threadpool is NULL, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_with_priority_with_NULL_threadpool_fails)
+{
+    // arrange
+
+    // act
+    int result = threadpool_linux_schedule_work_with_priority(NULL, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_123: [ If priority is not a valid THREADPOOL_PRIORITY value, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_with_priority_with_invalid_priority_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    int result = threadpool_linux_schedule_work_with_priority(threadpool, (THREADPOOL_PRIORITY)THREADPOOL_PRIORITY_COUNT, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_124: [ If work_function is NULL, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_with_priority_with_NULL_work_function_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    int result = threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, NULL, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_106: [ threadpool_push_task shall set the enqueue time of the task by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_125: [ threadpool_linux_schedule_work_with_priority shall push a task with work_function and work_function_context in a task queue of the priority lane by calling threadpool_push_task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_127: [ threadpool_linux_schedule_work_with_priority shall signal that work is available by calling threadpool_signal_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_128: [ threadpool_linux_schedule_work_with_priority shall add a new thread if all live threads are busy and the task queues are backing up. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_129: [ threadpool_linux_schedule_work_with_priority shall succeed and return 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_038: [ Otherwise, or if the local queue is full, threadpool_push_task shall push the task in the global task queue of the priority lane by calling TQUEUE_PUSH(THREADPOOL_TASK). ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_with_priority_succeeds_for_high_priority)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_schedule_work_success_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_HIGH, &lane_statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, lane_statistics.queue_depth);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_125: [ threadpool_linux_schedule_work_with_priority shall push a task with work_function and work_function_context in a task queue of the priority lane by calling threadpool_push_task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_129: [ threadpool_linux_schedule_work_with_priority shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_with_priority_succeeds_for_low_priority)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_schedule_work_success_expectations();
+
+    // act
+    int result = threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_LOW, &lane_statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, lane_statistics.queue_depth);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+static void test_schedule_high_priority_work_from_work_item(void* context)
+{
+    THANDLE(THREADPOOL)* threadpool = context;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(*threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243));
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_037: [ If priority is THREADPOOL_PRIORITY_NORMAL and the current thread is a worker thread of threadpool, threadpool_push_task shall push the task at the bottom of the local queue of the thread by calling threadpool_task_deque_push. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_038: [ Otherwise, or if the local queue is full, threadpool_push_task shall push the task in the global task queue of the priority lane by calling TQUEUE_PUSH(THREADPOOL_TASK). ]*/
+TEST_FUNCTION(threadpool_linux_schedule_work_with_priority_from_a_worker_thread_does_not_use_the_local_queue_for_high_priority)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_schedule_high_priority_work_from_work_item, (void*)&threadpool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_dequeue_expectations();
+    threadpool_schedule_work_success_expectations(); // pushed in the global queue of the high priority lane
+    threadpool_task_executed_expectations();
+
+    // the item scheduled from the work item is in the high priority lane
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_next_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    threadpool_task_executed_expectations();
+
+    threadpool_pop_no_item_expectations();
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)).SetReturn(1);
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_126: [ If threadpool_push_task fails, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_pushing_the_task_fails_threadpool_linux_schedule_work_with_priority_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(TQUEUE_PUSH(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL))
+        .SetReturn(TQUEUE_PUSH_ERROR);
+
+    // act
+    int result = threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_126: [ If threadpool_push_task fails, threadpool_linux_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_linux_schedule_work_with_priority_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    threadpool_schedule_work_success_expectations();
+
+    umock_c_negative_tests_snapshot();
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            int result = threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4243);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_pop_task with priority lanes */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_107: [ For the high and low priority lanes, threadpool_pop_task shall pop a task from the global task queue of the lane by calling TQUEUE_POP(THREADPOOL_TASK). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_109: [ threadpool_pop_task shall pop a task from the lanes in priority order (high, normal, low), stopping at the first lane that has a task. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_110: [ If a task was popped, threadpool_pop_task shall increment the number of tasks popped by the thread and return the priority of the lane the task was popped from. ]*/
+TEST_FUNCTION(threadpool_work_func_executes_high_priority_work_before_normal_priority_work)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_work_function, (void*)0x4242));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane
+    threadpool_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    threadpool_task_executed_expectations();
+
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_next_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
+    threadpool_task_executed_expectations();
+
+    threadpool_work_func_no_more_work_expectations();
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_107: [ For the high and low priority lanes, threadpool_pop_task shall pop a task from the global task queue of the lane by calling TQUEUE_POP(THREADPOOL_TASK). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_109: [ threadpool_pop_task shall pop a task from the lanes in priority order (high, normal, low), stopping at the first lane that has a task. ]*/
+TEST_FUNCTION(threadpool_work_func_executes_low_priority_work_when_the_other_lanes_are_empty)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4244));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    threadpool_pop_normal_lane_no_item_expectations();
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane
+    threadpool_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    threadpool_task_executed_expectations();
+
+    threadpool_work_func_no_more_work_expectations();
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+static void threadpool_pop_high_priority_task_expectations(bool first_task_of_drain)
+{
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane
+    if (first_task_of_drain)
+    {
+        threadpool_dequeue_expectations();
+    }
+    else
+    {
+        threadpool_next_dequeue_expectations();
+    }
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    threadpool_task_executed_expectations();
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_108: [ Every THREADPOOL_LANE_STARVATION_QUOTA-th pop of the thread, threadpool_pop_task shall first try one of the lanes below THREADPOOL_PRIORITY_HIGH, the lower lanes taking turns. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_110: [ If a task was popped, threadpool_pop_task shall increment the number of tasks popped by the thread and return the priority of the lane the task was popped from. ]*/
+TEST_FUNCTION(threadpool_work_func_executes_normal_priority_work_on_the_starvation_quota_turn_even_if_there_is_high_priority_work)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_work_function, (void*)0x4242));
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243));
+    }
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    for (uint32_t i = 0; i < 7; i++)
+    {
+        threadpool_pop_high_priority_task_expectations(i == 0);
+    }
+
+    // 8th pop starts with the normal priority lane
+    STRICT_EXPECTED_CALL(threadpool_task_deque_pop(IGNORED_ARG, IGNORED_ARG)); // local queue is empty
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL));
+    threadpool_next_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4242));
+    threadpool_task_executed_expectations();
+
+    threadpool_pop_high_priority_task_expectations(false);
+
+    threadpool_work_func_no_more_work_expectations();
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_108: [ Every THREADPOOL_LANE_STARVATION_QUOTA-th pop of the thread, threadpool_pop_task shall first try one of the lanes below THREADPOOL_PRIORITY_HIGH, the lower lanes taking turns. ]*/
+TEST_FUNCTION(threadpool_work_func_alternates_the_lower_lanes_on_the_starvation_quota_turns)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4244));
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243));
+    }
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    for (uint32_t i = 0; i < 7; i++)
+    {
+        threadpool_pop_high_priority_task_expectations(i == 0);
+    }
+
+    // 8th pop starts with the normal priority lane, which is empty
+    threadpool_pop_normal_lane_no_item_expectations();
+    threadpool_pop_high_priority_task_expectations(false);
+
+    for (uint32_t i = 0; i < 7; i++)
+    {
+        threadpool_pop_high_priority_task_expectations(false);
+    }
+
+    // 16th pop starts with the low priority lane
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane
+    threadpool_next_dequeue_expectations();
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    threadpool_task_executed_expectations();
+
+    threadpool_pop_high_priority_task_expectations(false);
+
+    threadpool_work_func_no_more_work_expectations();
+
+    //act
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_linux_get_lane_statistics */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_130: [ If threadpool is NULL, threadpool_linux_get_lane_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_get_lane_statistics_with_NULL_threadpool_fails)
+{
+    // arrange
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+
+    // act
+    int result = threadpool_linux_get_lane_statistics(NULL, THREADPOOL_PRIORITY_HIGH, &lane_statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_131: [ If priority is not a valid THREADPOOL_PRIORITY value, threadpool_linux_get_lane_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_get_lane_statistics_with_invalid_priority_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+
+    // act
+    int result = threadpool_linux_get_lane_statistics(threadpool, (THREADPOOL_PRIORITY)THREADPOOL_PRIORITY_COUNT, &lane_statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_132: [ If lane_statistics is NULL, threadpool_linux_get_lane_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_get_lane_statistics_with_NULL_lane_statistics_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    int result = threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_HIGH, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_112: [ threadpool_create shall initialize the private and the published statistics counters of all thread slots to 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_133: [ threadpool_linux_get_lane_statistics shall set the queue depth to the number of tasks in the global task queue of the lane obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_135: [ threadpool_linux_get_lane_statistics shall set the executed count and the total wait time to the sum of the values accumulated for the lane in the counters of all the thread slots. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_136: [ threadpool_linux_get_lane_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_linux_get_lane_statistics_succeeds_for_high_priority)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+
+    STRICT_EXPECTED_CALL(TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(IGNORED_ARG))
+        .SetReturn(3);
+    for (uint32_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // executed_count
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // total_wait_time_us
+    }
+
+    // act
+    int result = threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_HIGH, &lane_statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 3, lane_statistics.queue_depth);
+    ASSERT_ARE_EQUAL(uint64_t, 0, lane_statistics.executed_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, lane_statistics.total_wait_time_us);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_133: [ threadpool_linux_get_lane_statistics shall set the queue depth to the number of tasks in the global task queue of the lane obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_134: [ For the normal priority lane, threadpool_linux_get_lane_statistics shall add to the queue depth the number of tasks in the local queues of all the thread slots obtained by calling threadpool_task_deque_get_volatile_count. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_136: [ threadpool_linux_get_lane_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_linux_get_lane_statistics_adds_the_local_queues_for_normal_priority)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+
+    STRICT_EXPECTED_CALL(TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(IGNORED_ARG)) // global queue
+        .SetReturn(3);
+    for (uint32_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(threadpool_task_deque_get_volatile_count(IGNORED_ARG)) // local queue
+            .SetReturn(2);
+    }
+    for (uint32_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // executed_count
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); // total_wait_time_us
+    }
+
+    // act
+    int result = threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_NORMAL, &lane_statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 3 + 2 * MAX_THREAD_COUNT, lane_statistics.queue_depth);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_009: [ For the first task of a drain threadpool_work_func shall record the time of the dequeue by calling timer_global_get_elapsed_us, for the other tasks it shall use the time at which the previous task finished executing. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_106: [ threadpool_push_task shall set the enqueue time of the task by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_111: [ threadpool_work_func shall increment the executed count of the lane of the task and add the time the task waited in the queue to the total wait time of the lane in the private counters of its thread slot and store the new values in the published counters of the slot by calling interlocked_exchange_64. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_135: [ threadpool_linux_get_lane_statistics shall set the executed count and the total wait time to the sum of the values accumulated for the lane in the counters of all the thread slots. ]*/
+TEST_FUNCTION(threadpool_linux_get_lane_statistics_returns_the_executed_count_and_the_wait_time_of_the_lane)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_LANE_STATISTICS lane_statistics;
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(700.0);
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1010.0);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4244));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4244));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    threadpool_pop_normal_lane_no_item_expectations();
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1500.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // last_dequeue_time_ms
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // executed_count
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 800)); // total_wait_time_us
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // wait_time_buckets
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1510.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // execution_time_buckets
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 10)); // total_execution_time_us
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    threadpool_pop_normal_lane_no_item_expectations();
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane
+    // dequeued at 1510 us, when the previous task finished
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 2)); // executed_count
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1300)); // total_wait_time_us
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // wait_time_buckets
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1540.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // execution_time_buckets
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 40)); // total_execution_time_us
+    threadpool_work_func_no_more_work_expectations();
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    // act
+    int result = threadpool_linux_get_lane_statistics(threadpool, THREADPOOL_PRIORITY_LOW, &lane_statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 0, lane_statistics.queue_depth);
+    ASSERT_ARE_EQUAL(uint64_t, 2, lane_statistics.executed_count);
+    ASSERT_ARE_EQUAL(uint64_t, 1300, lane_statistics.total_wait_time_us);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* threadpool_linux_get_statistics */
+
+/* Tests_SRS_THREADPOOL_LINUX_12_139: [ If threadpool is NULL, threadpool_linux_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_get_statistics_with_NULL_threadpool_fails)
+{
+    // arrange
+    THREADPOOL_STATISTICS statistics;
+
+    // act
+    int result = threadpool_linux_get_statistics(NULL, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_140: [ If statistics is NULL, threadpool_linux_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_linux_get_statistics_with_NULL_statistics_fails)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+
+    // act
+    int result = threadpool_linux_get_statistics(threadpool, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_141: [ threadpool_linux_get_statistics shall set the queue depth to the number of tasks in the global task queues of all the lanes obtained by calling TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK) and in the local queues of all the thread slots obtained by calling threadpool_task_deque_get_volatile_count. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_142: [ threadpool_linux_get_statistics shall set the number of live threads, the number of active threads and the number of idle threads (the threads waiting for work). ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_143: [ threadpool_linux_get_statistics shall set the executed count, the wait time histogram and the execution time histogram to the sum of the counters of all the thread slots. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_144: [ threadpool_linux_get_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_linux_get_statistics_succeeds)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_STATISTICS statistics;
+
+    for (uint32_t i = 0; i < THREADPOOL_PRIORITY_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(TQUEUE_GET_VOLATILE_COUNT(THREADPOOL_TASK)(IGNORED_ARG)) // global queue of the lane
+            .SetReturn(3);
+    }
+    for (uint32_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(threadpool_task_deque_get_volatile_count(IGNORED_ARG)) // local queue
+            .SetReturn(2);
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // thread_count
+        .SetReturn(5);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // active_thread_count
+        .SetReturn(3);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)) // waiting_thread_count
+        .SetReturn(2);
+    for (uint32_t i = 0; i < MAX_THREAD_COUNT; i++)
+    {
+        for (uint32_t j = 0; j < THREADPOOL_PRIORITY_COUNT; j++)
+        {
+            STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // executed_count
+                .SetReturn(1);
+            STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // total_wait_time_us
+                .SetReturn(100);
+        }
+        for (uint32_t j = 0; j < THREADPOOL_LATENCY_BUCKET_COUNT; j++)
+        {
+            STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // wait_time_buckets
+                .SetReturn((j == 7) ? THREADPOOL_PRIORITY_COUNT : 0);
+            STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // execution_time_buckets
+                .SetReturn((j == 4) ? THREADPOOL_PRIORITY_COUNT : 0);
+        }
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)) // total_execution_time_us
+            .SetReturn(30);
+    }
+
+    // act
+    int result = threadpool_linux_get_statistics(threadpool, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 3 * THREADPOOL_PRIORITY_COUNT + 2 * MAX_THREAD_COUNT, statistics.queue_depth);
+    ASSERT_ARE_EQUAL(uint32_t, 5, statistics.thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 3, statistics.active_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.idle_thread_count);
+    ASSERT_ARE_EQUAL(uint64_t, THREADPOOL_PRIORITY_COUNT * MAX_THREAD_COUNT, statistics.executed_count);
+    ASSERT_ARE_EQUAL(uint64_t, 100 * THREADPOOL_PRIORITY_COUNT * MAX_THREAD_COUNT, statistics.wait_time.total_latency_us);
+    ASSERT_ARE_EQUAL(uint64_t, 30 * MAX_THREAD_COUNT, statistics.execution_time.total_latency_us);
+    for (uint32_t j = 0; j < THREADPOOL_LATENCY_BUCKET_COUNT; j++)
+    {
+        ASSERT_ARE_EQUAL(uint64_t, (j == 7) ? THREADPOOL_PRIORITY_COUNT * MAX_THREAD_COUNT : 0, statistics.wait_time.buckets[j]);
+        ASSERT_ARE_EQUAL(uint64_t, (j == 4) ? THREADPOOL_PRIORITY_COUNT * MAX_THREAD_COUNT : 0, statistics.execution_time.buckets[j]);
+    }
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_12_137: [ threadpool_work_func shall count the time the task waited in the queue in the wait time histogram of the private counters of its thread slot and store the new value of the bucket in the published counters of the slot by calling interlocked_exchange_64. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_138: [ After the work_function returns, threadpool_work_func shall obtain the execution time of the task by calling timer_global_get_elapsed_us, count it in the execution time histogram and add it to the total execution time of the private counters of its thread slot and store the new values in the published counters of the slot by calling interlocked_exchange_64. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_12_143: [ threadpool_linux_get_statistics shall set the executed count, the wait time histogram and the execution time histogram to the sum of the counters of all the thread slots. ]*/
+TEST_FUNCTION(threadpool_linux_get_statistics_returns_the_wait_time_and_the_execution_time_histograms)
+{
+    // arrange
+    THANDLE(THREADPOOL) threadpool = test_create_threadpool();
+    THREADPOOL_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(700.0);
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1010.0);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4244));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_linux_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4244));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0)); // work_sequence
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); // active_thread_count
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    threadpool_pop_normal_lane_no_item_expectations();
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1500.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // last_dequeue_time_ms
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // executed_count
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 800)); // total_wait_time_us
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // wait_time_buckets
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1510.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // execution_time_buckets
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 10)); // total_execution_time_us
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // high priority lane is empty
+    threadpool_pop_normal_lane_no_item_expectations();
+    STRICT_EXPECTED_CALL(TQUEUE_POP(THREADPOOL_TASK)(IGNORED_ARG, IGNORED_ARG, NULL, NULL, NULL)); // low priority lane
+    // dequeued at 1510 us, when the previous task finished
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 2)); // executed_count
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1300)); // total_wait_time_us
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // wait_time_buckets
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1540.0);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1)); // execution_time_buckets
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 40)); // total_execution_time_us
+    threadpool_work_func_no_more_work_expectations();
+    g_saved_worker_thread_func(g_saved_worker_thread_func_context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    // act
+    int result = threadpool_linux_get_statistics(threadpool, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.executed_count);
+    ASSERT_ARE_EQUAL(uint64_t, 1300, statistics.wait_time.total_latency_us);
+    ASSERT_ARE_EQUAL(uint64_t, 40, statistics.execution_time.total_latency_us);
+    for (uint32_t j = 0; j < THREADPOOL_LATENCY_BUCKET_COUNT; j++)
+    {
+        // 800 us falls in [512, 1023] and 500 us falls in [256, 511]
+        ASSERT_ARE_EQUAL(uint64_t, ((j == 9) || (j == 10)) ? 1 : 0, statistics.wait_time.buckets[j]);
+        // 10 us falls in [8, 15] and 30 us falls in [16, 31]
+        ASSERT_ARE_EQUAL(uint64_t, ((j == 4) || (j == 5)) ? 1 : 0, statistics.execution_time.buckets[j]);
+    }
+
+    // cleanup
+    THANDLE_ASSIGN(THREADPOOL)(&threadpool, NULL);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -6,12 +6,11 @@
 #define THREADPOOL_LINUX_UT_PCH_H
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
-#include <semaphore.h>
 #include <time.h>
-#include <bits/types/sigevent_t.h>         // for sigevent, sigev_notify_fun...
-#include <bits/types/sigval_t.h>           // for sigval_t
-#include <bits/types/timer_t.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
 
 #include "macro_utils/macro_utils.h" // IWYU pragma: keep
 
@@ -32,11 +31,14 @@
 #include "c_pal/interlocked.h"
 #include "c_pal/interlocked_hl.h"
 #include "c_pal/lazy_init.h"
+#include "c_pal/srw_lock_ll.h"
 #include "c_pal/sync.h"
 #include "c_pal/execution_engine.h"
 #include "c_pal/execution_engine_linux.h"
+#include "c_pal/timer.h"
 
-#include "c_pal/tqueue_threadpool_work_item.h"
+#include "c_pal/tqueue_threadpool_task.h"
+#include "c_pal/threadpool_task_deque.h"
 
 #include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
 
@@ -45,16 +47,18 @@
 
 #include "real_interlocked.h"
 #include "real_gballoc_hl.h"
-#include "real_tqueue_threadpool_work_item.h"
+#include "real_tqueue_threadpool_task.h"
+#include "real_threadpool_task_deque.h"
 #include "real_lazy_init.h"
 #include "real_interlocked_hl.h"
+#include "real_srw_lock_ll.h"
 
 #include "c_pal/threadpool.h"
+#include "c_pal/threadpool_linux.h"
 
 #define DEFAULT_TASK_ARRAY_SIZE 2048
 #define MIN_THREAD_COUNT 5
 #define MAX_THREAD_COUNT 10
-#define MAX_THREADPOOL_TIMER_COUNT 64
-#define MAX_TIMERS 1024
+#define TEST_TIMER_FD 4242
 
 #endif // THREADPOOL_LINUX_UT_PCH_H
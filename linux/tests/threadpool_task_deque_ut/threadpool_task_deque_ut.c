@@ -0,0 +1,610 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include "threadpool_task_deque_ut_pch.h"
+
+#define TEST_CAPACITY 4
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_RESULT_VALUES);
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static void test_work_function(void* context)
+{
+    (void)context;
+}
+
+static THREADPOOL_TASK test_make_task(uintptr_t id)
+{
+    THREADPOOL_TASK task = { test_work_function, (void*)id, (int64_t)id };
+    return task;
+}
+
+static void test_init_deque(THREADPOOL_TASK_DEQUE* deque, uint32_t capacity)
+{
+    ASSERT_ARE_EQUAL(int, 0, threadpool_task_deque_init(deque, capacity));
+    umock_c_reset_all_calls();
+}
+
+static void test_push_tasks(THREADPOOL_TASK_DEQUE* deque, uintptr_t first_id, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        THREADPOOL_TASK task = test_make_task(first_id + i);
+        ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, threadpool_task_deque_push(deque, &task));
+    }
+    umock_c_reset_all_calls();
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+/* threadpool_task_deque_init */
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_001: [ If deque is NULL, threadpool_task_deque_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_task_deque_init_with_NULL_deque_fails)
+{
+    // arrange
+
+    // act
+    int result = threadpool_task_deque_init(NULL, TEST_CAPACITY);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_002: [ If capacity is 0 or is not a power of 2, threadpool_task_deque_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_task_deque_init_with_0_capacity_fails)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+
+    // act
+    int result = threadpool_task_deque_init(&deque, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_002: [ If capacity is 0 or is not a power of 2, threadpool_task_deque_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_task_deque_init_with_capacity_not_a_power_of_2_fails)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+
+    // act
+    int result = threadpool_task_deque_init(&deque, 6);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_003: [ threadpool_task_deque_init shall allocate the array of capacity tasks by calling malloc_2. ]*/
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_005: [ threadpool_task_deque_init shall initialize top and bottom to 0 and return 0. ]*/
+TEST_FUNCTION(threadpool_task_deque_init_succeeds)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+
+    STRICT_EXPECTED_CALL(malloc_2(TEST_CAPACITY, sizeof(THREADPOOL_TASK)));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, 0));
+
+    // act
+    int result = threadpool_task_deque_init(&deque, TEST_CAPACITY);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 0, threadpool_task_deque_get_volatile_count(&deque));
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_004: [ If malloc_2 fails, threadpool_task_deque_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_task_deque_init_fails_when_malloc_2_fails)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+
+    STRICT_EXPECTED_CALL(malloc_2(TEST_CAPACITY, sizeof(THREADPOOL_TASK)))
+        .SetReturn(NULL);
+
+    // act
+    int result = threadpool_task_deque_init(&deque, TEST_CAPACITY);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* threadpool_task_deque_deinit */
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_006: [ If deque is NULL, threadpool_task_deque_deinit shall return. ]*/
+TEST_FUNCTION(threadpool_task_deque_deinit_with_NULL_deque_returns)
+{
+    // arrange
+
+    // act
+    threadpool_task_deque_deinit(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_007: [ Otherwise, threadpool_task_deque_deinit shall free the array of tasks. ]*/
+TEST_FUNCTION(threadpool_task_deque_deinit_frees_the_tasks)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, 2);
+
+    STRICT_EXPECTED_CALL(free(deque.tasks));
+
+    // act
+    threadpool_task_deque_deinit(&deque);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* threadpool_task_deque_push */
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_008: [ If deque is NULL or task is NULL, threadpool_task_deque_push shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+TEST_FUNCTION(threadpool_task_deque_push_with_NULL_deque_fails)
+{
+    // arrange
+    THREADPOOL_TASK task = test_make_task(1);
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_push(NULL, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_008: [ If deque is NULL or task is NULL, threadpool_task_deque_push shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+TEST_FUNCTION(threadpool_task_deque_push_with_NULL_task_fails)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_push(&deque, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_010: [ Otherwise, threadpool_task_deque_push shall copy the task at index bottom, publish it by setting bottom to bottom + 1 with interlocked_exchange_64 and return THREADPOOL_TASK_DEQUE_OK. ]*/
+TEST_FUNCTION(threadpool_task_deque_push_succeeds)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    THREADPOOL_TASK task = test_make_task(1);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, 1));
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_push(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 1, threadpool_task_deque_get_volatile_count(&deque));
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_009: [ If the deque already holds capacity tasks, threadpool_task_deque_push shall return THREADPOOL_TASK_DEQUE_FULL. ]*/
+TEST_FUNCTION(threadpool_task_deque_push_when_full_returns_FULL)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, TEST_CAPACITY);
+    THREADPOOL_TASK task = test_make_task(42);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_push(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_FULL, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, TEST_CAPACITY, threadpool_task_deque_get_volatile_count(&deque));
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_010: [ Otherwise, threadpool_task_deque_push shall copy the task at index bottom, publish it by setting bottom to bottom + 1 with interlocked_exchange_64 and return THREADPOOL_TASK_DEQUE_OK. ]*/
+TEST_FUNCTION(threadpool_task_deque_push_reuses_the_slots_freed_by_steals)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, TEST_CAPACITY);
+    THREADPOOL_TASK stolen_task;
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, threadpool_task_deque_steal(&deque, &stolen_task));
+    THREADPOOL_TASK task = test_make_task(42);
+    umock_c_reset_all_calls();
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_push(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, result);
+    ASSERT_ARE_EQUAL(int64_t, TEST_CAPACITY, threadpool_task_deque_get_volatile_count(&deque));
+    THREADPOOL_TASK popped_task;
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, threadpool_task_deque_pop(&deque, &popped_task));
+    ASSERT_ARE_EQUAL(void_ptr, (void*)42, popped_task.work_function_ctx);
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* threadpool_task_deque_pop */
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_011: [ If deque is NULL or task is NULL, threadpool_task_deque_pop shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+TEST_FUNCTION(threadpool_task_deque_pop_with_NULL_deque_fails)
+{
+    // arrange
+    THREADPOOL_TASK task;
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_pop(NULL, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_011: [ If deque is NULL or task is NULL, threadpool_task_deque_pop shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+TEST_FUNCTION(threadpool_task_deque_pop_with_NULL_task_fails)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_pop(&deque, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_012: [ threadpool_task_deque_pop shall claim the task at index bottom - 1 by setting bottom to bottom - 1 with interlocked_exchange_64 before reading top. ]*/
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_013: [ If the deque is empty, threadpool_task_deque_pop shall restore bottom and return THREADPOOL_TASK_DEQUE_EMPTY. ]*/
+TEST_FUNCTION(threadpool_task_deque_pop_on_empty_deque_returns_EMPTY)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    THREADPOOL_TASK task;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, -1));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, 0));
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_pop(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 0, threadpool_task_deque_get_volatile_count(&deque));
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_012: [ threadpool_task_deque_pop shall claim the task at index bottom - 1 by setting bottom to bottom - 1 with interlocked_exchange_64 before reading top. ]*/
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_014: [ If the claimed task is not the last task in the deque, threadpool_task_deque_pop shall copy it to task and return THREADPOOL_TASK_DEQUE_OK. ]*/
+TEST_FUNCTION(threadpool_task_deque_pop_returns_the_newest_task)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, 3);
+    THREADPOOL_TASK task;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, 2));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_pop(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, (void*)test_work_function, (void*)task.work_function);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)3, task.work_function_ctx);
+    ASSERT_ARE_EQUAL(int64_t, 3, task.enqueue_time_us);
+    ASSERT_ARE_EQUAL(int64_t, 2, threadpool_task_deque_get_volatile_count(&deque));
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_015: [ If the claimed task is the last task in the deque, threadpool_task_deque_pop shall race the thieves for it by incrementing top with interlocked_compare_exchange_64 and shall then restore bottom. ]*/
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_017: [ Otherwise threadpool_task_deque_pop shall copy the task to task and return THREADPOOL_TASK_DEQUE_OK. ]*/
+TEST_FUNCTION(threadpool_task_deque_pop_of_the_last_task_claims_it_from_the_thieves)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, 1);
+    THREADPOOL_TASK task;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&deque.top, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, 1));
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_pop(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, (void*)1, task.work_function_ctx);
+    ASSERT_ARE_EQUAL(int64_t, 0, threadpool_task_deque_get_volatile_count(&deque));
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_016: [ If incrementing top fails, threadpool_task_deque_pop shall return THREADPOOL_TASK_DEQUE_EMPTY. ]*/
+TEST_FUNCTION(threadpool_task_deque_pop_of_the_last_task_returns_EMPTY_when_a_thief_took_it)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, 1);
+    THREADPOOL_TASK task;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&deque.top, 1, 0))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&deque.bottom, 1));
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_pop(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* threadpool_task_deque_steal */
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_018: [ If deque is NULL or task is NULL, threadpool_task_deque_steal shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+TEST_FUNCTION(threadpool_task_deque_steal_with_NULL_deque_fails)
+{
+    // arrange
+    THREADPOOL_TASK task;
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_steal(NULL, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_018: [ If deque is NULL or task is NULL, threadpool_task_deque_steal shall fail and return THREADPOOL_TASK_DEQUE_INVALID_ARGS. ]*/
+TEST_FUNCTION(threadpool_task_deque_steal_with_NULL_task_fails)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_steal(&deque, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_019: [ threadpool_task_deque_steal shall read top and then bottom and if top is not less than bottom it shall return THREADPOOL_TASK_DEQUE_EMPTY. ]*/
+TEST_FUNCTION(threadpool_task_deque_steal_on_empty_deque_returns_EMPTY)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    THREADPOOL_TASK task;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_steal(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_EMPTY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_020: [ Otherwise threadpool_task_deque_steal shall copy the task at index top and claim it by incrementing top with interlocked_compare_exchange_64. ]*/
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_022: [ Otherwise threadpool_task_deque_steal shall copy the task to task and return THREADPOOL_TASK_DEQUE_OK. ]*/
+TEST_FUNCTION(threadpool_task_deque_steal_returns_the_oldest_task)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, 3);
+    THREADPOOL_TASK task;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&deque.top, 1, 0));
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_steal(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, (void*)test_work_function, (void*)task.work_function);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)1, task.work_function_ctx);
+    ASSERT_ARE_EQUAL(int64_t, 1, task.enqueue_time_us);
+    ASSERT_ARE_EQUAL(int64_t, 2, threadpool_task_deque_get_volatile_count(&deque));
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_021: [ If incrementing top fails, threadpool_task_deque_steal shall return THREADPOOL_TASK_DEQUE_ABORT. ]*/
+TEST_FUNCTION(threadpool_task_deque_steal_returns_ABORT_when_another_thread_took_the_task)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, 3);
+    THREADPOOL_TASK task;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&deque.top, 1, 0))
+        .SetReturn(1);
+
+    // act
+    THREADPOOL_TASK_DEQUE_RESULT result = threadpool_task_deque_steal(&deque, &task);
+
+    // assert
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_ABORT, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* threadpool_task_deque_get_volatile_count */
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_023: [ If deque is NULL, threadpool_task_deque_get_volatile_count shall return 0. ]*/
+TEST_FUNCTION(threadpool_task_deque_get_volatile_count_with_NULL_deque_returns_0)
+{
+    // arrange
+
+    // act
+    int64_t result = threadpool_task_deque_get_volatile_count(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_024: [ Otherwise threadpool_task_deque_get_volatile_count shall return bottom - top read with interlocked_add_64, or 0 if the difference is negative. ]*/
+TEST_FUNCTION(threadpool_task_deque_get_volatile_count_returns_the_number_of_tasks)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+    test_push_tasks(&deque, 1, 3);
+    THREADPOOL_TASK task;
+    ASSERT_ARE_EQUAL(THREADPOOL_TASK_DEQUE_RESULT, THREADPOOL_TASK_DEQUE_OK, threadpool_task_deque_steal(&deque, &task));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0));
+
+    // act
+    int64_t result = threadpool_task_deque_get_volatile_count(&deque);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 2, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+/* Tests_SRS_THREADPOOL_TASK_DEQUE_12_024: [ Otherwise threadpool_task_deque_get_volatile_count shall return bottom - top read with interlocked_add_64, or 0 if the difference is negative. ]*/
+TEST_FUNCTION(threadpool_task_deque_get_volatile_count_returns_0_while_the_owner_claims_from_an_empty_deque)
+{
+    // arrange
+    THREADPOOL_TASK_DEQUE deque;
+    test_init_deque(&deque, TEST_CAPACITY);
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.top, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&deque.bottom, 0))
+        .SetReturn(-1);
+
+    // act
+    int64_t result = threadpool_task_deque_get_volatile_count(&deque);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_task_deque_deinit(&deque);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
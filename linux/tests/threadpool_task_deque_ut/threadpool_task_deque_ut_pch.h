@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+// Precompiled header for threadpool_task_deque_ut
+
+#ifndef THREADPOOL_TASK_DEQUE_UT_PCH_H
+#define THREADPOOL_TASK_DEQUE_UT_PCH_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umocktypes.h"
+
+#include "umock_c/umock_c_ENABLE_MOCKS.h" // ============================== ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+
+#include "c_pal/tqueue_threadpool_task.h"
+#include "c_pal/threadpool_task_deque.h"
+
+#endif // THREADPOOL_TASK_DEQUE_UT_PCH_H